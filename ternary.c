@@ -14,28 +14,192 @@
 
 
 #include"ternary.h"
+#include"ternary_cpu.h"
 
-uint64_t ZERO_64 = 0; /**< Defines a global variable for 0 that is an @c unint64_t */
-uint64_t ONE_64 = 1; /**< Defines a global variable for 1 that is an @c unint64_t */
-uint64_t TWO_64 = 2; /**< Defines a global variable for 2 that is an @c unint64_t */
-uint64_t BAL_64 = 3; /**< Defines a global variable to represent -1 that is an @c unint64_t */
+static const trit8_t ZERO_trit8 = 0; /**< Defines a constant for 0 that is a @c trit8_t */
+static const trit8_t ONE_trit8 = 1; /**< Defines a constant for 1 that is a @c trit8_t */
+static const trit8_t TWO_trit8 = 2; /**< Defines a constant for 2 that is a @c trit8_t */
+static const trit8_t BAL_trit8 = 3; /**< Defines a constant to represent -1 that is a @c trit8_t */
 
-trit8_t ZERO_trit8 = 0; /**< Defines a global variable for 0 that is a @c trit8_t */
-trit8_t ONE_trit8 = 1; /**< Defines a global variable for 1 that is a @c trit8_t */
-trit8_t TWO_trit8 = 2; /**< Defines a global variable for 2 that is a @c trit8_t */
-trit8_t BAL_trit8 = 3; /**< Defines a global variable to represent -1 that is a @c trit8_t */
+static const trit16_t ZERO_trit16 = 0; /**< Defines a constant for 0 that is a @c trit16_t */
+static const trit16_t ONE_trit16 = 1; /**< Defines a constant for 1 that is a @c trit16_t */
+static const trit16_t TWO_trit16 = 2; /**< Defines a constant for 2 that is a @c trit16_t */
+static const trit16_t BAL_trit16 = 3; /**< Defines a constant to represent -1 that is a @c trit16_t */
 
-trit16_t ZERO_trit16 = 0; /**< Defines a global variable for 0 that is a @c trit16_t */
-trit16_t ONE_trit16 = 1; /**< Defines a global variable for 1 that is a @c trit16_t */
-trit16_t TWO_trit16 = 2; /**< Defines a global variable for 2 that is a @c trit16_t */
-trit16_t BAL_trit16 = 3; /**< Defines a global variable to represent -1 that is a @c trit16_t */
+static const trit32_t ZERO_trit32 = 0; /**< Defines a constant for 0 that is a @c trit32_t */
+static const trit32_t ONE_trit32 = 1; /**< Defines a constant for 1 that is a @c trit32_t */
+static const trit32_t TWO_trit32 = 2; /**< Defines a constant for 2 that is a @c trit32_t */
+static const trit32_t BAL_trit32 = 3; /**< Defines a constant to represent -1 that is a @c trit32_t */
 
-trit32_t ZERO_trit32 = 0; /**< Defines a global variable for 0 that is a @c trit32_t */
-trit32_t ONE_trit32 = 1; /**< Defines a global variable for 1 that is a @c trit32_t */
-trit32_t TWO_trit32 = 2; /**< Defines a global variable for 2 that is a @c trit32_t */
-trit32_t BAL_trit32 = 3; /**< Defines a global variable to represent -1 that is a @c trit32_t */
+static const uint64_t LOW_BITS_64 = 0x5555555555555555ULL; /**< Mask of the low bit of every trit in a @c trit32_t */
+static const uint64_t POW3_32 = 1853020188851841ULL; /**< 3^32, the number of values a @c trit32_t holds */
 
 
+/**
+ * @brief Value of the 4 balanced ternary trits in each byte, the unbalanced code 0b10 counts as 0.
+ */
+static const int8_t BYTE_VALUES[256] = {
+
+    0, 1, 0, -1, 3, 4, 3, 2, 0, 1, 0, -1, -3, -2, -3, -4,
+    9, 10, 9, 8, 12, 13, 12, 11, 9, 10, 9, 8, 6, 7, 6, 5,
+    0, 1, 0, -1, 3, 4, 3, 2, 0, 1, 0, -1, -3, -2, -3, -4,
+    -9, -8, -9, -10, -6, -5, -6, -7, -9, -8, -9, -10, -12, -11, -12, -13,
+    27, 28, 27, 26, 30, 31, 30, 29, 27, 28, 27, 26, 24, 25, 24, 23,
+    36, 37, 36, 35, 39, 40, 39, 38, 36, 37, 36, 35, 33, 34, 33, 32,
+    27, 28, 27, 26, 30, 31, 30, 29, 27, 28, 27, 26, 24, 25, 24, 23,
+    18, 19, 18, 17, 21, 22, 21, 20, 18, 19, 18, 17, 15, 16, 15, 14,
+    0, 1, 0, -1, 3, 4, 3, 2, 0, 1, 0, -1, -3, -2, -3, -4,
+    9, 10, 9, 8, 12, 13, 12, 11, 9, 10, 9, 8, 6, 7, 6, 5,
+    0, 1, 0, -1, 3, 4, 3, 2, 0, 1, 0, -1, -3, -2, -3, -4,
+    -9, -8, -9, -10, -6, -5, -6, -7, -9, -8, -9, -10, -12, -11, -12, -13,
+    -27, -26, -27, -28, -24, -23, -24, -25, -27, -26, -27, -28, -30, -29, -30, -31,
+    -18, -17, -18, -19, -15, -14, -15, -16, -18, -17, -18, -19, -21, -20, -21, -22,
+    -27, -26, -27, -28, -24, -23, -24, -25, -27, -26, -27, -28, -30, -29, -30, -31,
+    -36, -35, -36, -37, -33, -32, -33, -34, -36, -35, -36, -37, -39, -38, -39, -40
+};
+
+/**
+ * @brief The 4 balanced ternary trits of every value from -40 to 40, indexed by value + 40.
+ */
+static const uint8_t DIGIT_TRITS[81] = {
+
+    0xFF, 0xFC, 0xFD, 0xF3, 0xF0, 0xF1, 0xF7, 0xF4, 0xF5, 0xCF, 0xCC, 0xCD,
+    0xC3, 0xC0, 0xC1, 0xC7, 0xC4, 0xC5, 0xDF, 0xDC, 0xDD, 0xD3, 0xD0, 0xD1,
+    0xD7, 0xD4, 0xD5, 0x3F, 0x3C, 0x3D, 0x33, 0x30, 0x31, 0x37, 0x34, 0x35,
+    0x0F, 0x0C, 0x0D, 0x03, 0x00, 0x01, 0x07, 0x04, 0x05, 0x1F, 0x1C, 0x1D,
+    0x13, 0x10, 0x11, 0x17, 0x14, 0x15, 0x7F, 0x7C, 0x7D, 0x73, 0x70, 0x71,
+    0x77, 0x74, 0x75, 0x4F, 0x4C, 0x4D, 0x43, 0x40, 0x41, 0x47, 0x44, 0x45,
+    0x5F, 0x5C, 0x5D, 0x53, 0x50, 0x51, 0x57, 0x54, 0x55
+};
+
+/**
+ * @brief Returns the balanced remainder of @p value divided by @p radix.
+ *
+ * @param[in] value The dividend.
+ *
+ * @param[in] radix An odd divisor.
+ *
+ * @return The remainder between -(radix - 1) / 2 and (radix - 1) / 2
+ */
+__attribute__((always_inline))
+static inline int64_t balanced_digit(int64_t value, int64_t radix){
+
+    int64_t digit = value % radix;
+
+    if(digit > radix / 2){
+
+        digit -= radix;
+    }
+    else if(digit < -(radix / 2)){
+
+        digit += radix;
+    }
+
+    return digit;
+}
+
+/**
+ * @brief Powers of 81 from 81^0 to 81^8, 81^k is the number of values k bytes of trits hold.
+ */
+static const uint64_t POW81[9] = {
+
+    1ULL, 81ULL, 6561ULL, 531441ULL, 43046721ULL, 3486784401ULL,
+    282429536481ULL, 22876792454961ULL, 1853020188851841ULL
+};
+
+/**
+ * @brief Converts @p bytes bytes of balanced ternary to binary.
+ *
+ * Reads the number 4 trits at a time from @c BYTE_VALUES, the
+ * low and high 16 trits as two independent chains.
+ *
+ * @warning This method asserts that @p num is in balanced ternary.
+ *
+ * @param[in] num The trits.
+ *
+ * @param[in] bytes The width of @p num in bytes, at most 8.
+ *
+ * @return The value of @p num
+ */
+__attribute__((always_inline))
+static inline int64_t trits_value(uint64_t num, int bytes){
+
+    int64_t low = 0;
+    int64_t high = 0;
+    int index = 0;
+
+    assert(((num >> 1) & ~num & LOW_BITS_64) == 0 && "Value passed in is unbalanced\n");
+
+    for(index = (bytes < 4 ? bytes : 4) - 1; index >= 0; index--){
+
+        low = low * 81 + BYTE_VALUES[(num >> (8 * index)) & 0xFF];
+    }
+    for(index = bytes - 1; index >= 4; index--){
+
+        high = high * 81 + BYTE_VALUES[(num >> (8 * index)) & 0xFF];
+    }
+
+    return high * (int64_t)POW81[4] + low;
+}
+
+/**
+ * @brief Writes the unbalanced base 81 digits of @p digits as balanced trits.
+ *
+ * Each digit D is looked up as the 4 balanced trits of D - 40.
+ *
+ * @param[in] digits The number, below 81^bytes.
+ *
+ * @param[in] bytes The number of digits, at most 4.
+ *
+ * @return The trits
+ */
+__attribute__((always_inline))
+static inline uint64_t digits_trits(uint32_t digits, int bytes){
+
+    uint64_t result = 0;
+    int index = 0;
+
+    for(index = 0; index < bytes; index++){
+
+        result |= (uint64_t)DIGIT_TRITS[digits % 81] << (8 * index);
+        digits /= 81;
+    }
+
+    return result;
+}
+
+/**
+ * @brief Converts binary to @p bytes bytes of balanced ternary.
+ *
+ * Adding (81^bytes - 1) / 2, the number with every trit 1, turns
+ * the balanced digits into unbalanced ones without any carries,
+ * so the digits come from unsigned divisions by 81. The low and
+ * high 16 trits are split off first and written independently.
+ *
+ * @warning This method asserts that @p value fits in @p bytes bytes.
+ *
+ * @param[in] value The binary number.
+ *
+ * @param[in] bytes The width of the result in bytes, at most 8.
+ *
+ * @return The trits of @p value
+ */
+__attribute__((always_inline))
+static inline uint64_t value_trits(int64_t value, int bytes){
+
+    uint64_t biased = (uint64_t)value + POW81[bytes] / 2;
+
+    assert(biased < POW81[bytes] && "Number too big for ternary");
+
+    if(bytes <= 4){
+
+        return digits_trits((uint32_t)biased, bytes);
+    }
+
+    return digits_trits((uint32_t)(biased % POW81[4]), 4)
+        | (digits_trits((uint32_t)(biased / POW81[4]), bytes - 4) << 32);
+}
+
 /**
  * @brief Finds what @p base raised to @p exponent
  * 
@@ -255,77 +419,8 @@ trit32_t binary_to_unbalanced_ternary_trit32_t( uint64_t num ){
  * number to balanced ternary.
  */
 trit8_t binary_to_balanced_ternary_trit8_t(uint16_t num){
-    
-    int index = 0;
-    int carry = 0;
-    bool overflow = false; 
-    int array[8] = {};
-        
-    trit8_t result = 0;
-    
-    while(num > 0 && index < 8){
-    
-        array[index] = num % 3;
-        num /=3;
-        index++;
-    }
-            
-    assert(num <= 0 && "Passed in num is too big");
-            
-    for(index = 0; index < 8; index ++){
-    
-        if(array[index] == 3){
-        
-            carry = 1;
-            array[index] = 0;
-        }
-        else if(array[index] == 2){
-        
-            carry = 1;
-            array[index] = -1;
-        }
-        else{
-        
-            carry = 0;
-        }
-                    
-        if(index + 1 < 8){
-        
-            array[index + 1] += carry;
-            carry = 0;
-        }
-        
-        else if(carry == 1){
-        
-            overflow = true;
-        }
-                
-    }
-            
-    assert(overflow == false && "Number too big for ternary");
-                
-    for(index = 7; index >= 0; index--){
-    
-        if(array[index] == -1){
-        
-            result = result | BAL_trit8;
-        }
-        else if(array[index] == 1){
-        
-            result = result | ONE_trit8;
-        }
-        else{
-        
-            result = result | ZERO_trit8;
-        }
-    
-        if(index != 0){   
-        
-            result = result << 2;
-        }
-    }
 
-    return result;
+    return (trit8_t)value_trits(num, 2);
 }
 
 /**
@@ -344,77 +439,8 @@ trit8_t binary_to_balanced_ternary_trit8_t(uint16_t num){
  * number to balanced ternary.
  */
 trit16_t binary_to_balanced_ternary_trit16_t(uint32_t num){
-    
-    int index = 0;
-    int carry = 0;
-    bool overflow = false; 
-    int array[16] = {};
-        
-    trit16_t result = 0;
-    
-    while(num > 0 && index < 16){
-    
-        array[index] = num % 3;
-        num /=3;
-        index++;
-    }
-            
-    assert(num <= 0 && "Passed in num is too big");
-            
-    for(index = 0; index < 16; index ++){
-    
-        if(array[index] == 3){
-        
-            carry = 1;
-            array[index] = 0;
-        }
-        else if(array[index] == 2){
-        
-            carry = 1;
-            array[index] = -1;
-        }
-        else{
-        
-            carry = 0;
-        }
-                    
-        if(index + 1 < 16){
-        
-            array[index + 1] += carry;
-            carry = 0;
-        }
-        
-        else if(carry == 1){
-        
-            overflow = true;
-        }
-                
-    }
-            
-    assert(overflow == false && "Number too big for ternary");
-                
-    for(index = 15; index >= 0; index--){
-    
-        if(array[index] == -1){
-        
-            result = result | BAL_trit16;
-        }
-        else if(array[index] == 1){
-        
-            result = result | ONE_trit16;
-        }
-        else{
-        
-            result = result | ZERO_trit16;
-        }
-    
-        if(index != 0){   
-        
-            result = result << 2;
-        }
-    }
 
-    return result;
+    return (trit16_t)value_trits(num, 4);
 }
 
 /**
@@ -434,168 +460,247 @@ trit16_t binary_to_balanced_ternary_trit16_t(uint32_t num){
  */
 trit32_t binary_to_balanced_ternary_trit32_t( uint64_t num ){
 
-    int index = 0;
-    int carry = 0;
-    bool overflow = false; 
-    int array[32] = {};
-        
-    trit32_t result = 0;
-    
-    while(num > 0 && index < 32){
-    
-        array[index] = num % 3;
-        num /=3;
-        index++;
-    }
-            
-    assert(num <= 0 && "Passed in num is too big");
-            
-    for(index = 0; index < 32; index ++){
-    
-        if(array[index] == 3){
-        
-            carry = 1;
-            array[index] = 0;
-        }
-        else if(array[index] == 2){
-        
-            carry = 1;
-            array[index] = -1;
-        }
-        else{
-        
-            carry = 0;
-        }
-                    
-        if(index + 1 < 32){
-        
-            array[index + 1] += carry;
-            carry = 0;
-        }
-        
-        else if(carry == 1){
-        
-            overflow = true;
-        }
-                
+    assert(num <= POW3_32 / 2 && "Number too big for ternary");
+
+    return (trit32_t)value_trits((int64_t)num, 8);
+}
+
+/**
+ * @brief Returns the low bit of every trit of a @p trits trit number.
+ *
+ * @param[in] trits The width of the number, 8, 16 or 32.
+ *
+ * @return The mask of the low bit of the lowest @p trits trits
+ */
+static uint64_t trit_width(int trits){
+
+    return trits == 32 ? LOW_BITS_64 : LOW_BITS_64 & ((1ULL << (2 * trits)) - 1);
+}
+
+/**
+ * @brief Finds the carry into every trit of a trit-wise add.
+ *
+ * Every trit either generates a carry, propagates an incoming
+ * carry or kills it. Placing the generate and propagate bits
+ * in a binary add (with the unused high bits set so a carry
+ * passes over them) lets the adder's carry chain do the
+ * parallel-prefix work in one instruction.
+ *
+ * @param[in] generate Low bit set for every trit which
+ * carries out on its own.
+ *
+ * @param[in] propagate Low bit set for every trit which
+ * carries out only if a carry comes in.
+ *
+ * @param[in] carry_in The carry into trit 0.
+ *
+ * @param[in] trits The width of the number, 8, 16 or 32.
+ *
+ * @param[out] carry_out Set to true if the top trit carries out.
+ *
+ * @return The low bit of every trit set if a carry comes in
+ */
+__attribute__((always_inline))
+static inline uint64_t carry_chain(uint64_t generate, uint64_t propagate, bool carry_in, int trits, bool *carry_out){
+
+    uint64_t chain = generate | propagate | (LOW_BITS_64 << 1);
+    uint64_t sum = chain + generate;
+    uint64_t total = sum + carry_in;
+    uint64_t carry = (total ^ chain ^ generate) & LOW_BITS_64;
+
+    if(trits == 32){
+
+        *carry_out = sum < chain || total < sum;
     }
-            
-    assert(overflow == false && "Number too big for ternary");
-                
-    for(index = 31; index >= 0; index--){
-    
-        if(array[index] == -1){
-        
-            result = result | BAL_trit32;
-        }
-        else if(array[index] == 1){
-        
-            result = result | ONE_trit32;
-        }
-        else{
-        
-            result = result | ZERO_trit32;
-        }
-    
-        if(index != 0){   
-        
-            result = result << 2;
-        }
+    else{
+
+        *carry_out = (carry >> (2 * trits)) & 1;
     }
 
-    return result;
-  
+    return carry & trit_width(trits);
 }
 
 /**
- * @brief Converts unbalanced ternary to balanced ternary for @c trit8_t.
- * 
- * Takes a @c trit8_t number and converts to @c trit8_t with an 
- * balaned ternary encoding.
+ * @brief Converts unbalanced ternary to balanced ternary for @p trits trits.
  *
- * @warning This method asserts that the passed in  
- * number will fit into 8 trits.
+ * Works trit-wise, a digit of 2 becomes -1 and carries, a
+ * digit of 1 becomes -1 and carries only when a carry comes in.
+ * The carries come from @c carry_chain so there is no loop
+ * over the trits.
  *
- * @warning This method asserts that the passed in
- * number is encoded in unbalanced ternary.
+ * @warning This method asserts that @p num is encoded
+ * in unbalanced ternary.
  *
- * @param[in] num The unbalanced ternary number to 
- * be turned into balanced ternary.
+ * @param[in] num The unbalanced ternary number.
  *
- * @return The final result of turning the unbalanced
- * ternary number to balanced ternary.
+ * @param[in] trits The width of @p num, 8, 16 or 32.
+ *
+ * @param[in] carry_in The carry into trit 0, used to chain words.
+ *
+ * @param[out] carry_out Set to true if the result does not
+ * fit in @p trits trits.
+ *
+ * @return The balanced ternary encoding of @p num
  */
-trit8_t unbalanced_ternary_to_balanced_ternary_trit8_t(trit8_t num){
-    
-    trit8_t result = 0;
-    uint8_t grab = 0;
-    int array[8] = {};
-    int index = 0;
-    int carry = 0;
-    bool overflow = false;
-        
-    for(index = 0; index < 8; index++){
-    
-        grab = num & 0b11;
-                
-        assert(grab != 0b11 && "Number already balanced");
-                
-        array[index] = grab;
-                
-        num = num >> 2;
-    }
-         
-    for(index = 0; index < 8; index ++){
-    
-        if(array[index] == 3){
-        
-            carry = 1;
-            array[index] = 0;
-        }
-        else if(array[index] == 2){
-        
-            carry = 1;
-            array[index] = -1;
-        }
-        else{
-        
-            carry = 0;
-        }
-                    
-        if(index + 1 < 8){
-        
-            array[index + 1] += carry;
-        }
-        
-        else if(carry == 1){
-        
-            overflow = true;
-        }
-                
-    }
-            
-    assert(overflow == false && "Number too big for ternary");
-            
-    for(index = 7; index >= 0; index--){
-    
-        if(array[index] == -1){
-        
-            result = result | BAL_trit8;
-        }
-        else if(array[index] == 1){
-    
-            result = result | ONE_trit8;
-        }
-        else{
-    
-            result = result | ZERO_trit8;
-        }
+static uint64_t unbalanced_to_balanced(uint64_t num, int trits, bool carry_in, bool *carry_out){
 
-        if(index != 0){
-           
-            result = result << 2;
-        }
-    }
+    uint64_t width = trit_width(trits);
+    uint64_t one = num & width;
+    uint64_t two = (num >> 1) & width;
+    uint64_t carry = 0;
+    uint64_t pos = 0;
+    uint64_t neg = 0;
+
+    assert((one & two) == 0 && "Number already balanced");
+
+    carry = carry_chain(two, one, carry_in, trits, carry_out);
+
+    pos = (one & ~carry) | (~one & ~two & carry);
+    neg = (two & ~carry) | (one & carry);
+
+    return pos | neg | (neg << 1);
+}
+
+/**
+ * @brief Converts balanced ternary to unbalanced ternary for @p trits trits.
+ *
+ * Subtracts trit-wise with a borrow, a digit of -1 becomes 2
+ * and borrows, a digit of 0 becomes 2 and borrows only when a
+ * borrow comes in. The borrows come from @c carry_chain so
+ * there is no loop over the trits.
+ *
+ * @warning This method asserts that @p num is encoded
+ * in balanced ternary.
+ *
+ * @param[in] num The balanced ternary number.
+ *
+ * @param[in] trits The width of @p num, 8, 16 or 32.
+ *
+ * @param[in] borrow_in The borrow from trit 0, used to chain words.
+ *
+ * @param[out] borrow_out Set to true if the result is negative.
+ *
+ * @return The unbalanced ternary encoding of @p num
+ */
+static uint64_t balanced_to_unbalanced(uint64_t num, int trits, bool borrow_in, bool *borrow_out){
+
+    uint64_t width = trit_width(trits);
+    uint64_t mag = num & width;
+    uint64_t neg = (num >> 1) & width;
+    uint64_t pos = mag & ~neg;
+    uint64_t zero = width & ~mag;
+    uint64_t borrow = 0;
+    uint64_t one = 0;
+    uint64_t two = 0;
+
+    assert((neg & ~mag) == 0 && "Value passed in is unbalanced\n");
+
+    borrow = carry_chain(neg, zero, borrow_in, trits, borrow_out);
+
+    one = (pos & ~borrow) | (neg & borrow);
+    two = (zero & borrow) | (neg & ~borrow);
+
+    return one | (two << 1);
+}
+
+/**
+ * @brief Adds two balanced ternary numbers of @p trits trits.
+ *
+ * Both numbers are offset by +1 per trit, which turns them
+ * into unbalanced digits without any carries, and added with
+ * one @c carry_chain. A second @c carry_chain takes the offset
+ * off again. Only mask operations are used so the cost does
+ * not depend on the number of trits.
+ *
+ * @warning This method asserts that @p a and
+ * @p b are in balanced ternary.
+ *
+ * @param[in] a The first balanced ternary number.
+ *
+ * @param[in] b The second balanced ternary number.
+ *
+ * @param[in] trits The width of @p a and @p b, 8, 16 or 32.
+ *
+ * @param[in] carry_in The carry into trit 0, -1, 0 or 1.
+ *
+ * @param[out] carry_out The carry out of the top trit, -1, 0 or 1.
+ *
+ * @return The low @p trits trits of @p a + @p b + @p carry_in
+ */
+__attribute__((always_inline))
+static inline uint64_t add_trits(uint64_t a, uint64_t b, int trits, int carry_in, int *carry_out){
+
+    uint64_t width = trit_width(trits);
+    uint64_t a_mag = a & width;
+    uint64_t a_neg = (a >> 1) & width;
+    uint64_t b_mag = b & width;
+    uint64_t b_neg = (b >> 1) & width;
+    uint64_t x0 = 0, x1 = 0, x2 = 0;
+    uint64_t y0 = 0, y1 = 0, y2 = 0;
+    uint64_t generate = 0, propagate = 0, rest1 = 0, rest0 = 0;
+    uint64_t carry = 0, borrow = 0;
+    uint64_t r0 = 0, r1 = 0, r2 = 0;
+    uint64_t pos = 0, neg = 0;
+    bool carry_add = false;
+    bool borrow_sub = false;
+
+    assert((a_neg & ~a_mag) == 0 && (b_neg & ~b_mag) == 0);
+
+    // -1 -> 0, 0 -> 1, 1 -> 2
+    x0 = a_neg;
+    x1 = width & ~a_mag;
+    x2 = a_mag & ~a_neg;
+    y0 = b_neg;
+    y1 = width & ~b_mag;
+    y2 = b_mag & ~b_neg;
+
+    // digit sums of 3 or 4 carry, a sum of 2 carries if a carry comes in
+    generate = (x2 & (y1 | y2)) | (x1 & y2);
+    propagate = (x1 & y1) | (x2 & y0) | (x0 & y2);
+    rest1 = (x1 & y0) | (x0 & y1) | (x2 & y2);
+    rest0 = width & ~(rest1 | propagate);
+
+    carry = carry_chain(generate, propagate, carry_in > 0, trits, &carry_add);
+
+    r1 = (rest1 & ~carry) | (rest0 & carry);
+    r2 = (propagate & ~carry) | (rest1 & carry);
+    r0 = width & ~(r1 | r2);
+
+    // take 1 back off every trit, a 0 digit borrows
+    borrow = carry_chain(r0, r1, carry_in < 0, trits, &borrow_sub);
+
+    pos = (r1 & borrow) | (r0 & ~borrow);
+    neg = (r2 & borrow) | (r1 & ~borrow);
+
+    *carry_out = (int)carry_add - (int)borrow_sub;
+
+    return pos | neg | (neg << 1);
+}
+
+/**
+ * @brief Converts unbalanced ternary to balanced ternary for @c trit8_t.
+ * 
+ * Takes a @c trit8_t number and converts to @c trit8_t with an 
+ * balaned ternary encoding.
+ *
+ * @warning This method asserts that the passed in  
+ * number will fit into 8 trits.
+ *
+ * @warning This method asserts that the passed in
+ * number is encoded in unbalanced ternary.
+ *
+ * @param[in] num The unbalanced ternary number to 
+ * be turned into balanced ternary.
+ *
+ * @return The final result of turning the unbalanced
+ * ternary number to balanced ternary.
+ */
+trit8_t unbalanced_ternary_to_balanced_ternary_trit8_t(trit8_t num){
+
+    bool overflow = false;
+    trit8_t result = (trit8_t)unbalanced_to_balanced(num, 8, false, &overflow);
+
+    assert(overflow == false && "Number too big for ternary");
 
     return result;
 }
@@ -619,76 +724,11 @@ trit8_t unbalanced_ternary_to_balanced_ternary_trit8_t(trit8_t num){
  * ternary number to balanced ternary.
  */
 trit16_t unbalanced_ternary_to_balanced_ternary_trit16_t(trit16_t num){
-    
-    trit16_t result = 0;
-    uint8_t grab = 0;
-    int array[16] = {};
-    int index = 0;
-    int carry = 0;
+
     bool overflow = false;
-        
-    for(index = 0; index < 16; index++){
-    
-        grab = num & 0b11;
-                
-        assert(grab != 0b11 && "Number already balanced");
-                
-        array[index] = grab;
-                
-        num = num >> 2;
-    }
-         
-    for(index = 0; index < 16; index ++){
-    
-        if(array[index] == 3){
-        
-            carry = 1;
-            array[index] = 0;
-        }
-        else if(array[index] == 2){
-        
-            carry = 1;
-            array[index] = -1;
-        }
-        else{
-        
-            carry = 0;
-        }
-                    
-        if(index + 1 < 16){
-        
-            array[index + 1] += carry;
-        }
-        
-        else if(carry == 1){
-        
-            overflow = true;
-        }
-                
-    }
-            
-    assert(overflow == false && "Number too big for ternary");
-            
-    for(index = 15; index >= 0; index--){
-    
-        if(array[index] == -1){
-        
-            result = result | BAL_trit16;
-        }
-        else if(array[index] == 1){
-    
-            result = result | ONE_trit16;
-        }
-        else{
-    
-            result = result | ZERO_trit16;
-        }
+    trit16_t result = (trit16_t)unbalanced_to_balanced(num, 16, false, &overflow);
 
-        if(index != 0){
-           
-            result = result << 2;
-        }
-    }
+    assert(overflow == false && "Number too big for ternary");
 
     return result;
 }
@@ -713,75 +753,10 @@ trit16_t unbalanced_ternary_to_balanced_ternary_trit16_t(trit16_t num){
  */  
 trit32_t unbalanced_ternary_to_balanced_ternary_trit32_t( trit32_t num ){
 
-    trit32_t result = 0;
-    uint8_t grab = 0;
-    int array[32] = {};
-    int index = 0;
-    int carry = 0;
     bool overflow = false;
-        
-    for(index = 0; index < 32; index++){
-    
-        grab = num & 0b11;
-                
-        assert(grab != 0b11 && "Number already balanced");
-                
-        array[index] = grab;
-                
-        num = num >> 2;
-    }
-         
-    for(index = 0; index < 32; index ++){
-    
-        if(array[index] == 3){
-        
-            carry = 1;
-            array[index] = 0;
-        }
-        else if(array[index] == 2){
-        
-            carry = 1;
-            array[index] = -1;
-        }
-        else{
-        
-            carry = 0;
-        }
-                    
-        if(index + 1 < 32){
-        
-            array[index + 1] += carry;
-        }
-        
-        else if(carry == 1){
-        
-            overflow = true;
-        }
-                
-    }
-            
-    assert(overflow == false && "Number too big for ternary");
-            
-    for(index = 31; index >= 0; index--){
-    
-        if(array[index] == -1){
-        
-            result = result | BAL_trit32;
-        }
-        else if(array[index] == 1){
-    
-            result = result | ONE_trit32;
-        }
-        else{
-    
-            result = result | ZERO_trit32;
-        }
+    trit32_t result = (trit32_t)unbalanced_to_balanced(num, 32, false, &overflow);
 
-        if(index != 0){
-           
-            result = result << 2;
-        }
-    }
+    assert(overflow == false && "Number too big for ternary");
 
     return result;
 }
@@ -897,8 +872,8 @@ uint64_t unbalanced_ternary_to_binary_uint64_t(trit32_t num){
  * Takes a @c trit8_t number and converts to @c trit8_t with an 
  * unbalaned ternary encoding.
  *
- * @see balanced_ternary_to_binary_int16_t
- * @see binary_to_unbalanced_ternary_trit8_t
+ * @warning This method asserts that the passed in
+ * number is not negative.
  *
  * @param[in] num The balanced ternary number to 
  * be turned into unbalanced ternary.
@@ -907,9 +882,13 @@ uint64_t unbalanced_ternary_to_binary_uint64_t(trit32_t num){
  * ternary number to unbalanced ternary.
  */ 
 trit8_t balanced_ternary_to_unbalanced_ternary_trit8_t(trit8_t num){
-    
-    uint16_t binary_result = balanced_ternary_to_binary_int16_t(num);
-    return binary_to_unbalanced_ternary_trit8_t(binary_result);
+
+    bool negative = false;
+    trit8_t result = (trit8_t)balanced_to_unbalanced(num, 8, false, &negative);
+
+    assert(negative == false && "Number is negative");
+
+    return result;
 }
 
 /**
@@ -918,8 +897,8 @@ trit8_t balanced_ternary_to_unbalanced_ternary_trit8_t(trit8_t num){
  * Takes a @c trit16_t number and converts to @c trit16_t with an 
  * unbalaned ternary encoding.
  *
- * @see balanced_ternary_to_binary_int32_t
- * @see binary_to_unbalanced_ternary_trit16_t
+ * @warning This method asserts that the passed in
+ * number is not negative.
  *
  * @param[in] num The balanced ternary number to 
  * be turned into unbalanced ternary.
@@ -928,9 +907,13 @@ trit8_t balanced_ternary_to_unbalanced_ternary_trit8_t(trit8_t num){
  * ternary number to unbalanced ternary.
  */ 
 trit16_t balanced_ternary_to_unbalanced_ternary_trit16_t(trit16_t num){
-    
-    uint32_t binary_result = balanced_ternary_to_binary_int32_t(num);
-    return binary_to_unbalanced_ternary_trit16_t(binary_result);
+
+    bool negative = false;
+    trit16_t result = (trit16_t)balanced_to_unbalanced(num, 16, false, &negative);
+
+    assert(negative == false && "Number is negative");
+
+    return result;
 } 
 
 /**
@@ -939,8 +922,8 @@ trit16_t balanced_ternary_to_unbalanced_ternary_trit16_t(trit16_t num){
  * Takes a @c trit32_t number and converts to @c trit32_t with an 
  * unbalaned ternary encoding.
  *
- * @see balanced_ternary_to_binary_int64_t
- * @see binary_to_unbalanced_ternary_trit32_t
+ * @warning This method asserts that the passed in
+ * number is not negative.
  *
  * @param[in] num The balanced ternary number to 
  * be turned into unbalanced ternary.
@@ -950,8 +933,12 @@ trit16_t balanced_ternary_to_unbalanced_ternary_trit16_t(trit16_t num){
  */    
 trit32_t balanced_ternary_to_unbalanced_ternary_trit32_t(trit32_t num){
 
-    uint64_t binary_result = balanced_ternary_to_binary_int64_t(num);
-    return binary_to_unbalanced_ternary_trit32_t(binary_result);
+    bool negative = false;
+    trit32_t result = (trit32_t)balanced_to_unbalanced(num, 32, false, &negative);
+
+    assert(negative == false && "Number is negative");
+
+    return result;
 }
 
 /**
@@ -970,39 +957,9 @@ trit32_t balanced_ternary_to_unbalanced_ternary_trit32_t(trit32_t num){
  * ternary number to binary.
  */
 int16_t balanced_ternary_to_binary_int16_t(trit8_t num){
-    
-    int16_t result = 0;
-    uint8_t grab = 0;
-    uint16_t index = 0;
-    int multi = 0;
-    
-    for(index = 0; index < 8; index++){
-    
-        grab = num & 0b11;
-        
-        assert(grab != 0b10 && "Value passed in is unbalanced\n");
-        
-        if(grab == BAL_trit8){
-        
-            multi = -1;
-        }
-        else if(grab == ONE_trit8){
-        
-            multi = 1;
-        }
-        else{
-        
-            multi = 0;
-        }
-            
-        result += multi * raised_to(3, index);
-        
-        num = num >> 2;
-    }
-        
-    
-    return result;
-} 
+
+    return (int16_t)trits_value(num, 2);
+}
 
 /**
  * @brief Converts balanced ternary to binary for @c int32_t.
@@ -1020,39 +977,9 @@ int16_t balanced_ternary_to_binary_int16_t(trit8_t num){
  * ternary number to binary.
  */ 
 int32_t balanced_ternary_to_binary_int32_t(trit16_t num){
-    
-    int32_t result = 0;
-    uint8_t grab = 0;
-    uint32_t index = 0;
-    int multi = 0;
-    
-    for(index = 0; index < 16; index++){
-    
-        grab = num & 0b11;
-        
-        assert(grab != 0b10 && "Value passed in is unbalanced\n");
-        
-        if(grab == BAL_trit8){
-        
-            multi = -1;
-        }
-        else if(grab == ONE_trit8){
-        
-            multi = 1;
-        }
-        else{
-        
-            multi = 0;
-        }
-            
-        result += multi * raised_to(3, index);
-        
-        num = num >> 2;
-    }
-        
-    
-    return result;
-} 
+
+    return (int32_t)trits_value(num, 4);
+}
 
 /**
  * @brief Converts balanced ternary to binary for @c int64_t.
@@ -1071,37 +998,7 @@ int32_t balanced_ternary_to_binary_int32_t(trit16_t num){
  */
 int64_t balanced_ternary_to_binary_int64_t( trit32_t num ){
 
-    int64_t result = 0;
-    uint8_t grab = 0;
-    uint64_t index = 0;
-    int multi = 0;
-    
-    for(index = 0; index < 32; index++){
-    
-        grab = num & 0b11;
-        
-        assert(grab != 0b10 && "Value passed in is unbalanced\n");
-        
-        if(grab == BAL_trit8){
-        
-            multi = -1;
-        }
-        else if(grab == ONE_trit8){
-        
-            multi = 1;
-        }
-        else{
-        
-            multi = 0;
-        }
-            
-        result += multi * raised_to(3, index);
-        
-        num = num >> 2;
-    }
-        
-    
-    return result;
+    return trits_value(num, 8);
 }
     
 
@@ -1111,10 +1008,42 @@ int64_t balanced_ternary_to_binary_int64_t( trit32_t num ){
  *
  * This method adds together @p a and @p b 
  * to create a @c trit8_t balanced ternary number.
+ * Overflow is reported through @p overflow only,
+ * so the method has no side effects.
  *
  * @warning This method asserts that @p a and 
  * @p b are in balanced ternary.
  *
+ * @param[in] a The first 8 trit balanced 
+ * ternary value to be added
+ *
+ * @param[in] b The second 8 trit balanced 
+ * ternary value to be added
+ *
+ * @param[out] overflow Set to true if the sum
+ * does not fit in 8 trits, false otherwise
+ *
+ * @return An 8 trit balanced ternary number 
+ * resulting of adding together @p a and @p b
+ */
+trit8_t trit_add_checked_trit8_t(trit8_t a, trit8_t b, bool *overflow){
+
+    int carry = 0;
+    trit8_t result = (trit8_t)add_trits(a, b, 8, 0, &carry);
+
+    *overflow = carry != 0;
+
+    return result;
+}
+
+/** 
+ * @brief Adds together two @c trit8_t numbers.
+ *
+ * This method adds together @p a and @p b 
+ * to create a @c trit8_t balanced ternary number.
+ *
+ * @see trit_add_checked_trit8_t
+ *
  * @note If an overflow error occurs errno variable
  * is set to EOVERFLOW
  *
@@ -1129,153 +1058,11 @@ int64_t balanced_ternary_to_binary_int64_t( trit32_t num ){
  */
 trit8_t trit_add_trit8_t(trit8_t a, trit8_t b){
 
-    trit8_t add_result = 0;
-    trit8_t result = 0;
-    trit8_t grab_a = 0;
-    trit8_t grab_b = 0;
-    int index = 0;
-    int carry = 0;
-    int counter_n1 = 0;
-    int counter_p1= 0;
-    int counter_0 = 0;
-    int prev_carry = 0;
-    
-    for(index = 0; index < 8; index++){
-        
-        grab_a = a & 0b11;
-        grab_b = b & 0b11;
-        
-        a = a >> 2;
-        b = b >> 2;
-        
-        assert(grab_a != TWO_trit8 && grab_b != TWO_trit8);
-        
-        carry = 0;
-        add_result = 0;
-        
-        // all cases adding results in 1
-        if( (grab_a == BAL_trit8 && grab_b == BAL_trit8) 
-            || (grab_a == ZERO_trit8 && grab_b == ONE_trit8) 
-            || (grab_a == ONE_trit8 && grab_b == ZERO_trit8)){
-        
-            add_result = ONE_trit8;
-        }
-        // all cases adding results in 0
-        else if( (grab_a == ZERO_trit8 && grab_b == ZERO_trit8) 
-                || (grab_a == ONE_trit8 && grab_b == BAL_trit8) 
-                || (grab_a == BAL_trit8 && grab_b == ONE_trit8)){
-        
-            add_result = ZERO_trit8;
-        }
-        // rest of the cases results in -1
-        else{
-            
-            add_result = BAL_trit8;
-        }
-        
-        // add in carry and start counting
-        if(prev_carry == 1){
-            
-            counter_p1++;
-            // 1 -> -1
-            if(add_result == ONE_trit8){
-            
-                add_result = BAL_trit8;
-            }
-            // 0 -> 1
-            else if(add_result == ZERO_trit8){
-            
-                add_result = ONE_trit8;
-            }
-            // -1 -> 0
-            else{
-            
-                add_result = ZERO_trit8;
-            }
-        }
-        else if(prev_carry == -1){
-        
-            counter_n1++;
-            // 1 -> 0
-            if(add_result == ONE_trit8){
-            
-                add_result = ZERO_trit8;
-            }
-            // 0 -> -1
-            else if(add_result == ZERO_trit8){
-            
-                add_result = BAL_trit8;
-            }
-            // -1 -> 1
-            else{
-            
-                add_result = ONE_trit8;
-            }
-        }
-        else{
-        
-            counter_0++;
-        }
-        
-        // counting 
-        if(grab_a == ONE_trit8){
-            
-            counter_p1++;   
-        }
-        else if(grab_a == ZERO_trit8){
-        
-            counter_0++;
-        }
-        else{
-        
-            counter_n1++;
-        }
-        
-        if(grab_b == ONE_trit8){
-            
-            counter_p1++;   
-        }
-        else if(grab_b == ZERO_trit8){
-        
-            counter_0++;
-        }
-        else{
-        
-            counter_n1++;
-        }
-        
-        // Assigning what the carry is through the counter
-        if(counter_p1 > 1 && counter_n1 == 0){
-        
-            carry = 1;
-        }
-        else if(counter_0 > 1){
-        
-            carry = 0;
-        }
-        else if(counter_p1 >= 1){
-        
-            carry = 0;
-        }
-        else{
-        
-            carry = -1;
-        }
-        
-        // reset for the next iteration
-        prev_carry = carry;
-        counter_p1 = 0;
-        counter_n1 = 0;
-        counter_0 = 0;
-        
-        // add in the new result
-        add_result = add_result << (index * 2);
-        result = result | add_result;
-        
-    }
-    
-    if(prev_carry != 0){
-    
+    bool overflow = false;
+    trit8_t result = trit_add_checked_trit8_t(a, b, &overflow);
+
+    if(overflow){
+
         errno = EOVERFLOW;
     }
 
@@ -1287,10 +1074,42 @@ trit8_t trit_add_trit8_t(trit8_t a, trit8_t b){
  *
  * This method adds together @p a and @p b 
  * to create a @c trit16_t balanced ternary number.
+ * Overflow is reported through @p overflow only,
+ * so the method has no side effects.
  *
  * @warning This method asserts that @p a and 
  * @p b are in balanced ternary.
  *
+ * @param[in] a The first 16 trit balanced 
+ * ternary value to be added
+ *
+ * @param[in] b The second 16 trit balanced 
+ * ternary value to be added
+ *
+ * @param[out] overflow Set to true if the sum
+ * does not fit in 16 trits, false otherwise
+ *
+ * @return A 16 trit balanced ternary number 
+ * resulting of adding together @p a and @p b
+ */
+trit16_t trit_add_checked_trit16_t(trit16_t a, trit16_t b, bool *overflow){
+
+    int carry = 0;
+    trit16_t result = (trit16_t)add_trits(a, b, 16, 0, &carry);
+
+    *overflow = carry != 0;
+
+    return result;
+}
+
+/** 
+ * @brief Adds together two @c trit16_t numbers.
+ *
+ * This method adds together @p a and @p b 
+ * to create a @c trit16_t balanced ternary number.
+ *
+ * @see trit_add_checked_trit16_t
+ *
  * @note If an overflow error occurs errno variable
  * is set to EOVERFLOW
  *
@@ -1305,153 +1124,11 @@ trit8_t trit_add_trit8_t(trit8_t a, trit8_t b){
  */
 trit16_t trit_add_trit16_t(trit16_t a, trit16_t b){
 
-    trit16_t add_result = 0;
-    trit16_t result = 0;
-    trit8_t grab_a = 0;
-    trit8_t grab_b = 0;
-    int index = 0;
-    int carry = 0;
-    int counter_n1 = 0;
-    int counter_p1= 0;
-    int counter_0 = 0;
-    int prev_carry = 0;
-    
-    for(index = 0; index < 16; index++){
-        
-        grab_a = a & 0b11;
-        grab_b = b & 0b11;
-        
-        a = a >> 2;
-        b = b >> 2;
-        
-        assert(grab_a != TWO_trit8 && grab_b != TWO_trit8);
-        
-        carry = 0;
-        add_result = 0;
-        
-        // all cases adding results in 1
-        if( (grab_a == BAL_trit8 && grab_b == BAL_trit8) 
-            || (grab_a == ZERO_trit8 && grab_b == ONE_trit8) 
-            || (grab_a == ONE_trit8 && grab_b == ZERO_trit8)){
-        
-            add_result = ONE_trit16;
-        }
-        // all cases adding results in 0
-        else if( (grab_a == ZERO_trit8 && grab_b == ZERO_trit8) 
-                || (grab_a == ONE_trit8 && grab_b == BAL_trit8) 
-                || (grab_a == BAL_trit8 && grab_b == ONE_trit8)){
-        
-            add_result = ZERO_trit16;
-        }
-        // rest of the cases results in -1
-        else{
-            
-            add_result = BAL_trit16;
-        }
-        
-        // add in carry and start counting
-        if(prev_carry == 1){
-            
-            counter_p1++;
-            // 1 -> -1
-            if(add_result == ONE_trit16){
-            
-                add_result = BAL_trit16;
-            }
-            // 0 -> 1
-            else if(add_result == ZERO_trit16){
-            
-                add_result = ONE_trit16;
-            }
-            // -1 -> 0
-            else{
-            
-                add_result = ZERO_trit16;
-            }
-        }
-        else if(prev_carry == -1){
-        
-            counter_n1++;
-            // 1 -> 0
-            if(add_result == ONE_trit16){
-            
-                add_result = ZERO_trit16;
-            }
-            // 0 -> -1
-            else if(add_result == ZERO_trit16){
-            
-                add_result = BAL_trit16;
-            }
-            // -1 -> 1
-            else{
-            
-                add_result = ONE_trit16;
-            }
-        }
-        else{
-        
-            counter_0++;
-        }
-        
-        // counting 
-        if(grab_a == ONE_trit8){
-            
-            counter_p1++;   
-        }
-        else if(grab_a == ZERO_trit8){
-        
-            counter_0++;
-        }
-        else{
-        
-            counter_n1++;
-        }
-        
-        if(grab_b == ONE_trit8){
-            
-            counter_p1++;   
-        }
-        else if(grab_b == ZERO_trit8){
-        
-            counter_0++;
-        }
-        else{
-        
-            counter_n1++;
-        }
-        
-        // Assigning what the carry is through the counter
-        if(counter_p1 > 1 && counter_n1 == 0){
-        
-            carry = 1;
-        }
-        else if(counter_0 > 1){
-        
-            carry = 0;
-        }
-        else if(counter_p1 >= 1){
-        
-            carry = 0;
-        }
-        else{
-        
-            carry = -1;
-        }
-        
-        // reset for the next iteration
-        prev_carry = carry;
-        counter_p1 = 0;
-        counter_n1 = 0;
-        counter_0 = 0;
-        
-        // add in the new result
-        add_result = add_result << (index * 2);
-        result = result | add_result;
-        
-        }
-    
-    if(prev_carry != 0){
-    
+    bool overflow = false;
+    trit16_t result = trit_add_checked_trit16_t(a, b, &overflow);
+
+    if(overflow){
+
         errno = EOVERFLOW;
     }
 
@@ -1463,10 +1140,42 @@ trit16_t trit_add_trit16_t(trit16_t a, trit16_t b){
  *
  * This method adds together @p a and @p b 
  * to create a @c trit32_t balanced ternary number.
+ * Overflow is reported through @p overflow only,
+ * so the method has no side effects.
  *
  * @warning This method asserts that @p a and 
  * @p b are in balanced ternary.
  *
+ * @param[in] a The first 32 trit balanced 
+ * ternary value to be added
+ *
+ * @param[in] b The second 32 trit balanced 
+ * ternary value to be added
+ *
+ * @param[out] overflow Set to true if the sum
+ * does not fit in 32 trits, false otherwise
+ *
+ * @return A 32 trit balanced ternary number 
+ * resulting of adding together @p a and @p b
+ */
+trit32_t trit_add_checked_trit32_t(trit32_t a, trit32_t b, bool *overflow){
+
+    int carry = 0;
+    trit32_t result = (trit32_t)add_trits(a, b, 32, 0, &carry);
+
+    *overflow = carry != 0;
+
+    return result;
+}
+
+/** 
+ * @brief Adds together two @c trit32_t numbers.
+ *
+ * This method adds together @p a and @p b 
+ * to create a @c trit32_t balanced ternary number.
+ *
+ * @see trit_add_checked_trit32_t
+ *
  * @note If an overflow error occurs errno variable
  * is set to EOVERFLOW
  *
@@ -1481,153 +1190,11 @@ trit16_t trit_add_trit16_t(trit16_t a, trit16_t b){
  */
 trit32_t trit_add_trit32_t(trit32_t a, trit32_t b){
 
-    trit32_t add_result = 0;
-    trit32_t result = 0;
-    trit8_t grab_a = 0;
-    trit8_t grab_b = 0;
-    int index = 0;
-    int carry = 0;
-    int counter_n1 = 0;
-    int counter_p1= 0;
-    int counter_0 = 0;
-    int prev_carry = 0;
-    
-    for(index = 0; index < 32; index++){
-        
-        grab_a = a & 0b11;
-        grab_b = b & 0b11;
-        
-        a = a >> 2;
-        b = b >> 2;
-        
-        assert(grab_a != TWO_trit8 && grab_b != TWO_trit8);
-        
-        carry = 0;
-        add_result = 0;
-        
-        // all cases adding results in 1
-        if( (grab_a == BAL_trit8 && grab_b == BAL_trit8) 
-            || (grab_a == ZERO_trit8 && grab_b == ONE_trit8) 
-            || (grab_a == ONE_trit8 && grab_b == ZERO_trit8)){
-        
-            add_result = ONE_trit32;
-        }
-        // all cases adding results in 0
-        else if( (grab_a == ZERO_trit8 && grab_b == ZERO_trit8) 
-                || (grab_a == ONE_trit8 && grab_b == BAL_trit8) 
-                || (grab_a == BAL_trit8 && grab_b == ONE_trit8)){
-        
-            add_result = ZERO_trit32;
-        }
-        // rest of the cases results in -1
-        else{
-            
-            add_result = BAL_trit32;
-        }
-        
-        // add in carry and start counting
-        if(prev_carry == 1){
-            
-            counter_p1++;
-            // 1 -> -1
-            if(add_result == ONE_trit32){
-            
-                add_result = BAL_trit32;
-            }
-            // 0 -> 1
-            else if(add_result == ZERO_trit32){
-            
-                add_result = ONE_trit32;
-            }
-            // -1 -> 0
-            else{
-            
-                add_result = ZERO_trit32;
-            }
-        }
-        else if(prev_carry == -1){
-        
-            counter_n1++;
-            // 1 -> 0
-            if(add_result == ONE_trit32){
-            
-                add_result = ZERO_trit32;
-            }
-            // 0 -> -1
-            else if(add_result == ZERO_trit32){
-            
-                add_result = BAL_trit32;
-            }
-            // -1 -> 1
-            else{
-            
-                add_result = ONE_trit32;
-            }
-        }
-        else{
-        
-            counter_0++;
-        }
-        
-        // counting 
-        if(grab_a == ONE_trit8){
-            
-            counter_p1++;   
-        }
-        else if(grab_a == ZERO_trit8){
-        
-            counter_0++;
-        }
-        else{
-        
-            counter_n1++;
-        }
-        
-        if(grab_b == ONE_trit8){
-            
-            counter_p1++;   
-        }
-        else if(grab_b == ZERO_trit8){
-        
-            counter_0++;
-        }
-        else{
-        
-            counter_n1++;
-        }
-        
-        // Assigning what the carry is through the counter
-        if(counter_p1 > 1 && counter_n1 == 0){
-        
-            carry = 1;
-        }
-        else if(counter_0 > 1){
-        
-            carry = 0;
-        }
-        else if(counter_p1 >= 1){
-        
-            carry = 0;
-        }
-        else{
-        
-            carry = -1;
-        }
-        
-        // reset for the next iteration
-        prev_carry = carry;
-        counter_p1 = 0;
-        counter_n1 = 0;
-        counter_0 = 0;
-        
-        // add in the new result
-        add_result = add_result << (index * 2);
-        result = result | add_result;
-        
-        }
-    
-    if(prev_carry != 0){
-    
+    bool overflow = false;
+    trit32_t result = trit_add_checked_trit32_t(a, b, &overflow);
+
+    if(overflow){
+
         errno = EOVERFLOW;
     }
 
@@ -1659,6 +1226,36 @@ trit8_t trit_sub_trit8_t(trit8_t a, trit8_t b){
   return trit_add_trit8_t(a, not_b);
 }
 
+/** 
+ * @brief Subtracts two @c trit8_t numbers.
+ *
+ * This method subtracts @p a and @p b 
+ * to create a @c trit8_t balanced ternary number.
+ * Overflow is reported through @p overflow only,
+ * so the method has no side effects.
+ *
+ * @see trit_not_trit8_t
+ * @see trit_add_checked_trit8_t
+ *
+ * @param[in] a The 8 trit balanced 
+ * ternary value to be subtracted from
+ *
+ * @param[in] b The 8 trit balanced 
+ * ternary value to be subtracted
+ *
+ * @param[out] overflow Set to true if the difference
+ * does not fit in 8 trits, false otherwise
+ *
+ * @return An 8 trit balanced ternary number 
+ * resulting of subtracting @p a and @p b
+ */
+trit8_t trit_sub_checked_trit8_t(trit8_t a, trit8_t b, bool *overflow){
+
+  trit8_t not_b = trit_not_trit8_t(b);
+  
+  return trit_add_checked_trit8_t(a, not_b, overflow);
+}
+
 /** 
  * @brief Subtracts two @c trit16_t numbers.
  *
@@ -1684,6 +1281,36 @@ trit16_t trit_sub_trit16_t(trit16_t a, trit16_t b){
   return trit_add_trit16_t(a, not_b);
 }
 
+/** 
+ * @brief Subtracts two @c trit16_t numbers.
+ *
+ * This method subtracts @p a and @p b 
+ * to create a @c trit16_t balanced ternary number.
+ * Overflow is reported through @p overflow only,
+ * so the method has no side effects.
+ *
+ * @see trit_not_trit16_t
+ * @see trit_add_checked_trit16_t
+ *
+ * @param[in] a The 16 trit balanced 
+ * ternary value to be subtracted from
+ *
+ * @param[in] b The 16 trit balanced 
+ * ternary value to be subtracted
+ *
+ * @param[out] overflow Set to true if the difference
+ * does not fit in 16 trits, false otherwise
+ *
+ * @return A 16 trit balanced ternary number 
+ * resulting of subtracting @p a and @p b
+ */
+trit16_t trit_sub_checked_trit16_t(trit16_t a, trit16_t b, bool *overflow){
+
+  trit16_t not_b = trit_not_trit16_t(b);
+  
+  return trit_add_checked_trit16_t(a, not_b, overflow);
+}
+
 /** 
  * @brief Subtracts two @c trit32_t numbers.
  *
@@ -1709,6 +1336,36 @@ trit32_t trit_sub_trit32_t(trit32_t a, trit32_t b){
   return trit_add_trit32_t(a, not_b);
 }
 
+/** 
+ * @brief Subtracts two @c trit32_t numbers.
+ *
+ * This method subtracts @p a and @p b 
+ * to create a @c trit32_t balanced ternary number.
+ * Overflow is reported through @p overflow only,
+ * so the method has no side effects.
+ *
+ * @see trit_not_trit32_t
+ * @see trit_add_checked_trit32_t
+ *
+ * @param[in] a The 32 trit balanced 
+ * ternary value to be subtracted from
+ *
+ * @param[in] b The 32 trit balanced 
+ * ternary value to be subtracted
+ *
+ * @param[out] overflow Set to true if the difference
+ * does not fit in 32 trits, false otherwise
+ *
+ * @return An 32 trit balanced ternary number 
+ * resulting of subtracting @p a and @p b
+ */
+trit32_t trit_sub_checked_trit32_t(trit32_t a, trit32_t b, bool *overflow){
+
+  trit32_t not_b = trit_not_trit32_t(b);
+  
+  return trit_add_checked_trit32_t(a, not_b, overflow);
+}
+
 /** 
  * This method OR's together @p a and @p b 
  *
@@ -2397,39 +2054,10 @@ trit32_t trit_sr_trit32_t(trit32_t a, uint8_t b){
  * of the negation of @p num
  */
 trit8_t trit_not_trit8_t(trit8_t num){
-    
-    trit8_t result = 0;
-    trit8_t temp = 0;
-    trit8_t grab = 0;
-    int index = 0;
-
-    for(index = 14; index >= 0; index -= 2){
-    
-        temp = num >> index;
-        grab = temp & 0b11;
-        
-        assert(grab != TWO_trit8);
-
-        if(grab == ONE_trit8){
-        
-            result = result | BAL_trit8;
-        }
-        else if(grab == BAL_trit8){
-        
-            result = result | ONE_trit8;
-        }
-        else{
-        
-            result = result | ZERO_trit8;
-        }
 
-        if(index != 0){
-        
-            result = result << 2;
-        }
-    }
+    assert(((num >> 1) & ~num & (trit8_t)LOW_BITS_64) == 0);
 
-    return result;
+    return (trit8_t)(num ^ ((num & (trit8_t)LOW_BITS_64) << 1));
 }
 
 /**
@@ -2449,38 +2077,9 @@ trit8_t trit_not_trit8_t(trit8_t num){
  */
 trit16_t trit_not_trit16_t(trit16_t num){
 
-    trit16_t result = 0;
-    trit16_t temp = 0;
-    trit8_t grab = 0;
-    int index = 0;
-
-    for(index = 30; index >= 0; index -= 2){
-    
-        temp = num >> index;
-        grab = temp & 0b11;
-        
-        assert(grab != TWO_trit8);
-
-        if(grab== ONE_trit8){
-        
-            result = result | BAL_trit16;
-        }
-        else if(grab == BAL_trit8){
-        
-            result = result | ONE_trit16;
-        }
-        else{
-        
-            result = result | ZERO_trit16;
-        }
-
-        if(index != 0){
-        
-            result = result << 2;
-        }
-    }
+    assert(((num >> 1) & ~num & (trit16_t)LOW_BITS_64) == 0);
 
-    return result;
+    return (trit16_t)(num ^ ((num & (trit16_t)LOW_BITS_64) << 1));
 }
 
 /**
@@ -2500,39 +2099,3547 @@ trit16_t trit_not_trit16_t(trit16_t num){
  */
 trit32_t trit_not_trit32_t(trit32_t num){
 
-    trit32_t result = 0;
-    trit32_t temp = 0;
-    trit8_t grab = 0;
-    int index = 0;
+    assert(((num >> 1) & ~num & LOW_BITS_64) == 0);
 
-    for(index = 62; index >= 0; index -= 2){
-    
-        temp = num >> index;
-        grab = temp & 0b11;
-        
-        assert(grab != TWO_trit8);
+    return num ^ ((num & LOW_BITS_64) << 1);
+}
 
-        if(grab== ONE_trit8){
-        
-            result = result | BAL_trit32;
-        }
-        else if(grab == BAL_trit8){
-        
-            result = result | ONE_trit32;
-        }
-        else{
-        
-            result = result | ZERO_trit32;
-        }
+#ifdef TERNARY_X86_64
+/**
+ * @brief Gathers every other bit of @p num with pext.
+ *
+ * @param[in] num The interleaved bits, starting at bit 0.
+ *
+ * @return The even bits of @p num packed into the low 32 bits
+ */
+__attribute__((target("bmi2")))
+static uint32_t gather_bits_bmi2(uint64_t num){
 
-        if(index != 0){
-        
-            result = result << 2;
-        }
-    }
+    return (uint32_t)_pext_u64(num, LOW_BITS_64);
+}
+
+/**
+ * @brief Spreads the bits of @p num to every other bit with pdep.
+ *
+ * @param[in] num The 32 bits to be spread.
+ *
+ * @return @p num with bit i moved to bit 2 * i
+ */
+__attribute__((target("bmi2")))
+static uint64_t spread_bits_bmi2(uint32_t num){
+
+    return _pdep_u64(num, LOW_BITS_64);
+}
+#endif
+
+/**
+ * @brief Gathers every other bit of @p num with shifts and masks.
+ *
+ * @param[in] num The interleaved bits, starting at bit 0.
+ *
+ * @return The even bits of @p num packed into the low 32 bits
+ */
+static uint32_t gather_bits_portable(uint64_t num){
+
+    num = num & LOW_BITS_64;
+    num = (num | (num >> 1)) & 0x3333333333333333ULL;
+    num = (num | (num >> 2)) & 0x0F0F0F0F0F0F0F0FULL;
+    num = (num | (num >> 4)) & 0x00FF00FF00FF00FFULL;
+    num = (num | (num >> 8)) & 0x0000FFFF0000FFFFULL;
+    num = (num | (num >> 16)) & 0x00000000FFFFFFFFULL;
+
+    return (uint32_t)num;
+}
+
+/**
+ * @brief Spreads the bits of @p num to every other bit with shifts and masks.
+ *
+ * @param[in] num The 32 bits to be spread.
+ *
+ * @return @p num with bit i moved to bit 2 * i
+ */
+static uint64_t spread_bits_portable(uint32_t num){
+
+    uint64_t result = num;
+
+    result = (result | (result << 16)) & 0x0000FFFF0000FFFFULL;
+    result = (result | (result << 8)) & 0x00FF00FF00FF00FFULL;
+    result = (result | (result << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    result = (result | (result << 2)) & 0x3333333333333333ULL;
+    result = (result | (result << 1)) & LOW_BITS_64;
 
     return result;
 }
 
+/**
+ * @brief Gathers every other bit of @p num.
+ *
+ * @see trit_cpu_fast_bmi2
+ *
+ * @param[in] num The interleaved bits, starting at bit 0.
+ *
+ * @return The even bits of @p num packed into the low 32 bits
+ */
+static uint32_t gather_bits(uint64_t num){
+
+#ifdef TERNARY_X86_64
+    if(trit_cpu_fast_bmi2()){
+
+        return gather_bits_bmi2(num);
+    }
+#endif
+    return gather_bits_portable(num);
+}
+
+/**
+ * @brief Spreads the bits of @p num to every other bit.
+ *
+ * @see trit_cpu_fast_bmi2
+ *
+ * @param[in] num The 32 bits to be spread.
+ *
+ * @return @p num with bit i moved to bit 2 * i
+ */
+static uint64_t spread_bits(uint32_t num){
+
+#ifdef TERNARY_X86_64
+    if(trit_cpu_fast_bmi2()){
+
+        return spread_bits_bmi2(num);
+    }
+#endif
+    return spread_bits_portable(num);
+}
+
+/**
+ * @brief Splits a @c trit8_t into magnitude and sign bitmasks.
+ *
+ * Bit i of @p mag is the low bit of trit i and bit i of
+ * @p sign is the high bit of trit i. For balanced ternary
+ * @p mag marks the non-zero trits and @p sign marks the -1 trits.
+ *
+ * @param[in] num The 8 trit number to be split.
+ *
+ * @param[out] mag The low bit of every trit.
+ *
+ * @param[out] sign The high bit of every trit.
+ */
+void trit_unpack_trit8_t(trit8_t num, uint8_t *mag, uint8_t *sign){
+
+    *mag = (uint8_t)gather_bits(num);
+    *sign = (uint8_t)gather_bits(num >> 1);
+}
+
+/**
+ * @brief Splits a @c trit16_t into magnitude and sign bitmasks.
+ *
+ * Bit i of @p mag is the low bit of trit i and bit i of
+ * @p sign is the high bit of trit i. For balanced ternary
+ * @p mag marks the non-zero trits and @p sign marks the -1 trits.
+ *
+ * @param[in] num The 16 trit number to be split.
+ *
+ * @param[out] mag The low bit of every trit.
+ *
+ * @param[out] sign The high bit of every trit.
+ */
+void trit_unpack_trit16_t(trit16_t num, uint16_t *mag, uint16_t *sign){
 
+    *mag = (uint16_t)gather_bits(num);
+    *sign = (uint16_t)gather_bits(num >> 1);
+}
 
+/**
+ * @brief Splits a @c trit32_t into magnitude and sign bitmasks.
+ *
+ * Bit i of @p mag is the low bit of trit i and bit i of
+ * @p sign is the high bit of trit i. For balanced ternary
+ * @p mag marks the non-zero trits and @p sign marks the -1 trits.
+ *
+ * @param[in] num The 32 trit number to be split.
+ *
+ * @param[out] mag The low bit of every trit.
+ *
+ * @param[out] sign The high bit of every trit.
+ */
+void trit_unpack_trit32_t(trit32_t num, uint32_t *mag, uint32_t *sign){
+
+    *mag = gather_bits(num);
+    *sign = gather_bits(num >> 1);
+}
+
+/**
+ * @brief Merges magnitude and sign bitmasks into a @c trit8_t.
+ *
+ * This is the inverse of @c trit_unpack_trit8_t. A balanced
+ * ternary result requires every bit of @p sign to also be set
+ * in @p mag.
+ *
+ * @param[in] mag The low bit of every trit.
+ *
+ * @param[in] sign The high bit of every trit.
+ *
+ * @return The 8 trit number made from @p mag and @p sign
+ */
+trit8_t trit_pack_trit8_t(uint8_t mag, uint8_t sign){
+
+    return (trit8_t)(spread_bits(mag) | (spread_bits(sign) << 1));
+}
+
+/**
+ * @brief Merges magnitude and sign bitmasks into a @c trit16_t.
+ *
+ * This is the inverse of @c trit_unpack_trit16_t. A balanced
+ * ternary result requires every bit of @p sign to also be set
+ * in @p mag.
+ *
+ * @param[in] mag The low bit of every trit.
+ *
+ * @param[in] sign The high bit of every trit.
+ *
+ * @return The 16 trit number made from @p mag and @p sign
+ */
+trit16_t trit_pack_trit16_t(uint16_t mag, uint16_t sign){
+
+    return (trit16_t)(spread_bits(mag) | (spread_bits(sign) << 1));
+}
+
+/**
+ * @brief Merges magnitude and sign bitmasks into a @c trit32_t.
+ *
+ * This is the inverse of @c trit_unpack_trit32_t. A balanced
+ * ternary result requires every bit of @p sign to also be set
+ * in @p mag.
+ *
+ * @param[in] mag The low bit of every trit.
+ *
+ * @param[in] sign The high bit of every trit.
+ *
+ * @return The 32 trit number made from @p mag and @p sign
+ */
+trit32_t trit_pack_trit32_t(uint32_t mag, uint32_t sign){
+
+    return spread_bits(mag) | (spread_bits(sign) << 1);
+}
+
+/**
+ * @brief Counts the trits of @p num equal to @p digit.
+ *
+ * @param[in] num The balanced ternary number.
+ *
+ * @param[in] digit The trit value to be counted, -1, 0 or 1.
+ *
+ * @param[in] low_bits The low bit of every trit of the width of @p num.
+ *
+ * @return The number of trits of @p num equal to @p digit
+ */
+__attribute__((always_inline))
+static inline uint8_t count_trits(uint64_t num, int8_t digit, uint64_t low_bits){
+
+    uint64_t mag = num & low_bits;
+    uint64_t sign = (num >> 1) & low_bits;
+
+    if(digit == 1){
+
+        return (uint8_t)__builtin_popcountll(mag & ~sign);
+    }
+    else if(digit == -1){
+
+        return (uint8_t)__builtin_popcountll(mag & sign);
+    }
+
+    return (uint8_t)__builtin_popcountll(~mag & low_bits);
+}
+
+/**
+ * @brief Counts the trits that differ between @p a and @p b.
+ *
+ * @param[in] a The first balanced ternary number.
+ *
+ * @param[in] b The second balanced ternary number.
+ *
+ * @param[in] low_bits The low bit of every trit of the width of @p a.
+ *
+ * @return The trit-wise Hamming distance of @p a and @p b
+ */
+__attribute__((always_inline))
+static inline uint8_t differing_trits(uint64_t a, uint64_t b, uint64_t low_bits){
+
+    uint64_t diff = a ^ b;
+
+    return (uint8_t)__builtin_popcountll((diff | (diff >> 1)) & low_bits);
+}
+
+/**
+ * @brief Sums the trit-wise products of @p a and @p b.
+ *
+ * @param[in] a The first balanced ternary number.
+ *
+ * @param[in] b The second balanced ternary number.
+ *
+ * @param[in] low_bits The low bit of every trit of the width of @p a.
+ *
+ * @return The sum of the products of the trits of @p a and @p b
+ */
+__attribute__((always_inline))
+static inline int8_t trit_products(uint64_t a, uint64_t b, uint64_t low_bits){
+
+    uint64_t both = a & b & low_bits;
+    uint64_t flip = ((a ^ b) >> 1) & both;
+
+    return (int8_t)(__builtin_popcountll(both & ~flip) - __builtin_popcountll(flip));
+}
+
+#ifdef TERNARY_X86_64
+/**
+ * @brief Counts the trits of @p num equal to @p digit with popcnt.
+ *
+ * @see count_trits
+ */
+__attribute__((target("popcnt")))
+static uint8_t count_word_popcnt(uint64_t num, int8_t digit, uint64_t low_bits){
+
+    return count_trits(num, digit, low_bits);
+}
+
+/**
+ * @brief Counts the trits that differ between @p a and @p b with popcnt.
+ *
+ * @see differing_trits
+ */
+__attribute__((target("popcnt")))
+static uint8_t hamming_word_popcnt(uint64_t a, uint64_t b, uint64_t low_bits){
+
+    return differing_trits(a, b, low_bits);
+}
+
+/**
+ * @brief Sums the trit-wise products of @p a and @p b with popcnt.
+ *
+ * @see trit_products
+ */
+__attribute__((target("popcnt")))
+static int8_t similarity_word_popcnt(uint64_t a, uint64_t b, uint64_t low_bits){
+
+    return trit_products(a, b, low_bits);
+}
+#endif
+
+/**
+ * @brief Counts the trits of @p num equal to @p digit.
+ *
+ * @see trit_cpu_popcnt
+ *
+ * @param[in] num The balanced ternary number.
+ *
+ * @param[in] digit The trit value to be counted.
+ *
+ * @param[in] low_bits The low bit of every trit of the width of @p num.
+ *
+ * @return The number of trits of @p num equal to @p digit
+ */
+static uint8_t count_word(uint64_t num, int8_t digit, uint64_t low_bits){
+
+    assert(digit >= -1 && digit <= 1);
+
+#ifdef TERNARY_X86_64
+    if(trit_cpu_popcnt()){
+
+        return count_word_popcnt(num, digit, low_bits);
+    }
+#endif
+    return count_trits(num, digit, low_bits);
+}
+
+/**
+ * @brief Counts the trits that differ between @p a and @p b.
+ *
+ * @see trit_cpu_popcnt
+ *
+ * @param[in] a The first balanced ternary number.
+ *
+ * @param[in] b The second balanced ternary number.
+ *
+ * @param[in] low_bits The low bit of every trit of the width of @p a.
+ *
+ * @return The trit-wise Hamming distance of @p a and @p b
+ */
+static uint8_t hamming_word(uint64_t a, uint64_t b, uint64_t low_bits){
+
+#ifdef TERNARY_X86_64
+    if(trit_cpu_popcnt()){
+
+        return hamming_word_popcnt(a, b, low_bits);
+    }
+#endif
+    return differing_trits(a, b, low_bits);
+}
+
+/**
+ * @brief Sums the trit-wise products of @p a and @p b.
+ *
+ * @see trit_cpu_popcnt
+ *
+ * @param[in] a The first balanced ternary number.
+ *
+ * @param[in] b The second balanced ternary number.
+ *
+ * @param[in] low_bits The low bit of every trit of the width of @p a.
+ *
+ * @return The sum of the products of the trits of @p a and @p b
+ */
+static int8_t similarity_word(uint64_t a, uint64_t b, uint64_t low_bits){
+
+#ifdef TERNARY_X86_64
+    if(trit_cpu_popcnt()){
+
+        return similarity_word_popcnt(a, b, low_bits);
+    }
+#endif
+    return trit_products(a, b, low_bits);
+}
+
+/**
+ * @brief Counts the trits of @p num equal to @p digit.
+ *
+ * The trits are counted a whole word at a time by masking
+ * the low and high bit of every trit and using popcount.
+ *
+ * @warning This method asserts that @p digit
+ * is -1, 0 or 1.
+ *
+ * @param[in] num The 8 trit balanced ternary number.
+ *
+ * @param[in] digit The trit value to be counted.
+ *
+ * @return The number of trits of @p num equal to @p digit
+ */
+uint8_t trit_count_trit8_t(trit8_t num, int8_t digit){
+
+    return count_word(num, digit, (trit8_t)LOW_BITS_64);
+}
+
+/**
+ * @brief Counts the trits of @p num equal to @p digit.
+ *
+ * The trits are counted a whole word at a time by masking
+ * the low and high bit of every trit and using popcount.
+ *
+ * @warning This method asserts that @p digit
+ * is -1, 0 or 1.
+ *
+ * @param[in] num The 16 trit balanced ternary number.
+ *
+ * @param[in] digit The trit value to be counted.
+ *
+ * @return The number of trits of @p num equal to @p digit
+ */
+uint8_t trit_count_trit16_t(trit16_t num, int8_t digit){
+
+    return count_word(num, digit, (trit16_t)LOW_BITS_64);
+}
+
+/**
+ * @brief Counts the trits of @p num equal to @p digit.
+ *
+ * The trits are counted a whole word at a time by masking
+ * the low and high bit of every trit and using popcount.
+ *
+ * @warning This method asserts that @p digit
+ * is -1, 0 or 1.
+ *
+ * @param[in] num The 32 trit balanced ternary number.
+ *
+ * @param[in] digit The trit value to be counted.
+ *
+ * @return The number of trits of @p num equal to @p digit
+ */
+uint8_t trit_count_trit32_t(trit32_t num, int8_t digit){
+
+    return count_word(num, digit, LOW_BITS_64);
+}
+
+/**
+ * @brief Counts the trits that differ between @p a and @p b.
+ *
+ * A trit differs if either of its two bits differ, the
+ * differences are folded onto the low bits and counted
+ * with popcount.
+ *
+ * @param[in] a The first 8 trit balanced ternary number.
+ *
+ * @param[in] b The second 8 trit balanced ternary number.
+ *
+ * @return The trit-wise Hamming distance of @p a and @p b
+ */
+uint8_t trit_hamming_trit8_t(trit8_t a, trit8_t b){
+
+    return hamming_word(a, b, (trit8_t)LOW_BITS_64);
+}
+
+/**
+ * @brief Counts the trits that differ between @p a and @p b.
+ *
+ * A trit differs if either of its two bits differ, the
+ * differences are folded onto the low bits and counted
+ * with popcount.
+ *
+ * @param[in] a The first 16 trit balanced ternary number.
+ *
+ * @param[in] b The second 16 trit balanced ternary number.
+ *
+ * @return The trit-wise Hamming distance of @p a and @p b
+ */
+uint8_t trit_hamming_trit16_t(trit16_t a, trit16_t b){
+
+    return hamming_word(a, b, (trit16_t)LOW_BITS_64);
+}
+
+/**
+ * @brief Counts the trits that differ between @p a and @p b.
+ *
+ * A trit differs if either of its two bits differ, the
+ * differences are folded onto the low bits and counted
+ * with popcount.
+ *
+ * @param[in] a The first 32 trit balanced ternary number.
+ *
+ * @param[in] b The second 32 trit balanced ternary number.
+ *
+ * @return The trit-wise Hamming distance of @p a and @p b
+ */
+uint8_t trit_hamming_trit32_t(trit32_t a, trit32_t b){
+
+    return hamming_word(a, b, LOW_BITS_64);
+}
+
+/**
+ * @brief Ternary inner product of @p a and @p b.
+ *
+ * Sums the trit-wise products of @p a and @p b. A product is
+ * non-zero where both trits are and negative where the signs
+ * differ, so it is two popcounts.
+ *
+ * @warning This method expects @p a and
+ * @p b to be in balanced ternary.
+ *
+ * @param[in] a The first 8 trit balanced ternary number.
+ *
+ * @param[in] b The second 8 trit balanced ternary number.
+ *
+ * @return The sum of the products of the trits of @p a and @p b
+ */
+int8_t trit_similarity_trit8_t(trit8_t a, trit8_t b){
+
+    return similarity_word(a, b, (trit8_t)LOW_BITS_64);
+}
+
+/**
+ * @brief Ternary inner product of @p a and @p b.
+ *
+ * Sums the trit-wise products of @p a and @p b. A product is
+ * non-zero where both trits are and negative where the signs
+ * differ, so it is two popcounts.
+ *
+ * @warning This method expects @p a and
+ * @p b to be in balanced ternary.
+ *
+ * @param[in] a The first 16 trit balanced ternary number.
+ *
+ * @param[in] b The second 16 trit balanced ternary number.
+ *
+ * @return The sum of the products of the trits of @p a and @p b
+ */
+int8_t trit_similarity_trit16_t(trit16_t a, trit16_t b){
+
+    return similarity_word(a, b, (trit16_t)LOW_BITS_64);
+}
+
+/**
+ * @brief Ternary inner product of @p a and @p b.
+ *
+ * Sums the trit-wise products of @p a and @p b. A product is
+ * non-zero where both trits are and negative where the signs
+ * differ, so it is two popcounts.
+ *
+ * @warning This method expects @p a and
+ * @p b to be in balanced ternary.
+ *
+ * @param[in] a The first 32 trit balanced ternary number.
+ *
+ * @param[in] b The second 32 trit balanced ternary number.
+ *
+ * @return The sum of the products of the trits of @p a and @p b
+ */
+int8_t trit_similarity_trit32_t(trit32_t a, trit32_t b){
+
+    return similarity_word(a, b, LOW_BITS_64);
+}
+
+/**
+ * @brief Widens a @c trit8_t to a @c trit16_t.
+ *
+ * A zero trit is encoded as 00 in both balanced and
+ * unbalanced ternary so widening is a zero-extension
+ * of the 2-bit encoding and keeps the value.
+ *
+ * @param[in] num The 8 trit number.
+ *
+ * @return @p num as a 16 trit number
+ */
+trit16_t trit_widen_trit8_t_to_trit16_t(trit8_t num){
+
+    return (trit16_t)num;
+}
+
+/**
+ * @brief Widens a @c trit8_t to a @c trit32_t.
+ *
+ * A zero trit is encoded as 00 in both balanced and
+ * unbalanced ternary so widening is a zero-extension
+ * of the 2-bit encoding and keeps the value.
+ *
+ * @param[in] num The 8 trit number.
+ *
+ * @return @p num as a 32 trit number
+ */
+trit32_t trit_widen_trit8_t_to_trit32_t(trit8_t num){
+
+    return (trit32_t)num;
+}
+
+/**
+ * @brief Widens a @c trit16_t to a @c trit32_t.
+ *
+ * A zero trit is encoded as 00 in both balanced and
+ * unbalanced ternary so widening is a zero-extension
+ * of the 2-bit encoding and keeps the value.
+ *
+ * @param[in] num The 16 trit number.
+ *
+ * @return @p num as a 32 trit number
+ */
+trit32_t trit_widen_trit16_t_to_trit32_t(trit16_t num){
+
+    return (trit32_t)num;
+}
+
+/**
+ * @brief Narrows a @c trit16_t to a @c trit8_t and reports overflow.
+ *
+ * The top 8 trits are dropped, @p overflow is set if any
+ * of them is not zero.
+ *
+ * @param[in] num The 16 trit number.
+ *
+ * @param[out] overflow Set to true if @p num does not
+ * fit in 8 trits, false otherwise.
+ *
+ * @return The low 8 trits of @p num
+ *
+ * @see trit_narrow_wrap_trit16_t_to_trit8_t
+ */
+trit8_t trit_narrow_checked_trit16_t_to_trit8_t(trit16_t num, bool *overflow){
+
+    *overflow = (num >> 16) != 0;
+
+    return (trit8_t)num;
+}
+
+/**
+ * @brief Narrows a @c trit32_t to a @c trit8_t and reports overflow.
+ *
+ * The top 24 trits are dropped, @p overflow is set if any
+ * of them is not zero.
+ *
+ * @param[in] num The 32 trit number.
+ *
+ * @param[out] overflow Set to true if @p num does not
+ * fit in 8 trits, false otherwise.
+ *
+ * @return The low 8 trits of @p num
+ *
+ * @see trit_narrow_wrap_trit32_t_to_trit8_t
+ */
+trit8_t trit_narrow_checked_trit32_t_to_trit8_t(trit32_t num, bool *overflow){
+
+    *overflow = (num >> 16) != 0;
+
+    return (trit8_t)num;
+}
+
+/**
+ * @brief Narrows a @c trit32_t to a @c trit16_t and reports overflow.
+ *
+ * The top 16 trits are dropped, @p overflow is set if any
+ * of them is not zero.
+ *
+ * @param[in] num The 32 trit number.
+ *
+ * @param[out] overflow Set to true if @p num does not
+ * fit in 16 trits, false otherwise.
+ *
+ * @return The low 16 trits of @p num
+ *
+ * @see trit_narrow_wrap_trit32_t_to_trit16_t
+ */
+trit16_t trit_narrow_checked_trit32_t_to_trit16_t(trit32_t num, bool *overflow){
+
+    *overflow = (num >> 32) != 0;
+
+    return (trit16_t)num;
+}
+
+/**
+ * @brief Narrows a @c trit16_t to a @c trit8_t modulo 3^8.
+ *
+ * Dropping the top 8 trits keeps the value modulo 3^8,
+ * in the balanced range for balanced ternary and in the
+ * unsigned range for unbalanced ternary.
+ *
+ * @param[in] num The 16 trit number.
+ *
+ * @return The low 8 trits of @p num
+ *
+ * @see trit_narrow_checked_trit16_t_to_trit8_t
+ */
+trit8_t trit_narrow_wrap_trit16_t_to_trit8_t(trit16_t num){
+
+    return (trit8_t)num;
+}
+
+/**
+ * @brief Narrows a @c trit32_t to a @c trit8_t modulo 3^8.
+ *
+ * Dropping the top 24 trits keeps the value modulo 3^8,
+ * in the balanced range for balanced ternary and in the
+ * unsigned range for unbalanced ternary.
+ *
+ * @param[in] num The 32 trit number.
+ *
+ * @return The low 8 trits of @p num
+ *
+ * @see trit_narrow_checked_trit32_t_to_trit8_t
+ */
+trit8_t trit_narrow_wrap_trit32_t_to_trit8_t(trit32_t num){
+
+    return (trit8_t)num;
+}
+
+/**
+ * @brief Narrows a @c trit32_t to a @c trit16_t modulo 3^16.
+ *
+ * Dropping the top 16 trits keeps the value modulo 3^16,
+ * in the balanced range for balanced ternary and in the
+ * unsigned range for unbalanced ternary.
+ *
+ * @param[in] num The 32 trit number.
+ *
+ * @return The low 16 trits of @p num
+ *
+ * @see trit_narrow_checked_trit32_t_to_trit16_t
+ */
+trit16_t trit_narrow_wrap_trit32_t_to_trit16_t(trit32_t num){
+
+    return (trit16_t)num;
+}
+
+/**
+ * @brief Packs an array of @c trit8_t densely into @c trit32_t words.
+ *
+ * Element @c i lands in trits 8*(i%4) to 8*(i%4)+7 of
+ * word @c i/4, so 4 values share one word. A partly filled
+ * last word has its unused trits set to zero.
+ *
+ * @param[in] src The array of 8 trit numbers.
+ *
+ * @param[in] count The number of elements in @p src.
+ *
+ * @param[out] dst The packed words, (count+3)/4 of them.
+ *
+ * @see trit_repack_trit32_t_to_trit8_t
+ */
+void trit_repack_trit8_t_to_trit32_t(const trit8_t *src, size_t count, trit32_t *dst){
+
+    size_t index = 0;
+
+    for(index = 0; index < count; index++){
+
+        if(index % 4 == 0){
+
+            dst[index / 4] = 0;
+        }
+
+        dst[index / 4] |= (trit32_t)src[index] << (16 * (index % 4));
+    }
+}
+
+/**
+ * @brief Unpacks @c trit32_t words made by @c trit_repack_trit8_t_to_trit32_t.
+ *
+ * @param[in] src The packed words, (count+3)/4 of them.
+ *
+ * @param[in] count The number of 8 trit numbers to unpack.
+ *
+ * @param[out] dst The array of 8 trit numbers.
+ *
+ * @see trit_repack_trit8_t_to_trit32_t
+ */
+void trit_repack_trit32_t_to_trit8_t(const trit32_t *src, size_t count, trit8_t *dst){
+
+    size_t index = 0;
+
+    for(index = 0; index < count; index++){
+
+        dst[index] = (trit8_t)(src[index / 4] >> (16 * (index % 4)));
+    }
+}
+
+/**
+ * @brief Packs an array of @c trit16_t densely into @c trit32_t words.
+ *
+ * Element @c i lands in trits 16*(i%2) to 16*(i%2)+15 of
+ * word @c i/2, so 2 values share one word. A partly filled
+ * last word has its unused trits set to zero.
+ *
+ * @param[in] src The array of 16 trit numbers.
+ *
+ * @param[in] count The number of elements in @p src.
+ *
+ * @param[out] dst The packed words, (count+1)/2 of them.
+ *
+ * @see trit_repack_trit32_t_to_trit16_t
+ */
+void trit_repack_trit16_t_to_trit32_t(const trit16_t *src, size_t count, trit32_t *dst){
+
+    size_t index = 0;
+
+    for(index = 0; index < count; index++){
+
+        if(index % 2 == 0){
+
+            dst[index / 2] = 0;
+        }
+
+        dst[index / 2] |= (trit32_t)src[index] << (32 * (index % 2));
+    }
+}
+
+/**
+ * @brief Unpacks @c trit32_t words made by @c trit_repack_trit16_t_to_trit32_t.
+ *
+ * @param[in] src The packed words, (count+1)/2 of them.
+ *
+ * @param[in] count The number of 16 trit numbers to unpack.
+ *
+ * @param[out] dst The array of 16 trit numbers.
+ *
+ * @see trit_repack_trit16_t_to_trit32_t
+ */
+void trit_repack_trit32_t_to_trit16_t(const trit32_t *src, size_t count, trit16_t *dst){
+
+    size_t index = 0;
+
+    for(index = 0; index < count; index++){
+
+        dst[index] = (trit16_t)(src[index / 2] >> (32 * (index % 2)));
+    }
+}
+
+/**
+ * @brief Splits a @c trit64_t into two 32 trit words.
+ *
+ * @param[in] num The 64 trit number.
+ *
+ * @param[out] words Trits 0 to 31 then trits 32 to 63.
+ */
+static void split_trit64_t(trit64_t num, uint64_t *words){
+
+    words[0] = (uint64_t)num;
+    words[1] = (uint64_t)(num >> 64);
+}
+
+/**
+ * @brief Joins two 32 trit words into a @c trit64_t.
+ *
+ * @param[in] words Trits 0 to 31 then trits 32 to 63.
+ *
+ * @return The 64 trit number
+ */
+static trit64_t join_trit64_t(const uint64_t *words){
+
+    return ((trit64_t)words[1] << 64) | words[0];
+}
+
+/**
+ * @brief Splits a @c trit128_t into four 32 trit words.
+ *
+ * @param[in] num The 128 trit number.
+ *
+ * @param[out] words The words from the lowest trits up.
+ */
+static void split_trit128_t(trit128_t num, uint64_t *words){
+
+    split_trit64_t(num.low, words);
+    split_trit64_t(num.high, words + 2);
+}
+
+/**
+ * @brief Joins four 32 trit words into a @c trit128_t.
+ *
+ * @param[in] words The words from the lowest trits up.
+ *
+ * @return The 128 trit number
+ */
+static trit128_t join_trit128_t(const uint64_t *words){
+
+    trit128_t result;
+
+    result.low = join_trit64_t(words);
+    result.high = join_trit64_t(words + 2);
+
+    return result;
+}
+
+/**
+ * @brief Negates a 32 trit word by flipping the sign of every non-zero trit.
+ *
+ * @warning This method asserts that @p num is in balanced ternary.
+ *
+ * @param[in] num The balanced ternary word.
+ *
+ * @return The negation of @p num
+ */
+static uint64_t not_word(uint64_t num){
+
+    assert(((num >> 1) & ~num & LOW_BITS_64) == 0);
+
+    return num ^ ((num & LOW_BITS_64) << 1);
+}
+
+/**
+ * @brief The mask form of @c trit_or_trit32_t.
+ *
+ * @warning This method asserts that @p a and @p b are in balanced ternary.
+ *
+ * @param[in] a The first balanced ternary word.
+ *
+ * @param[in] b The second balanced ternary word.
+ *
+ * @return 0 where both trits are 0, 1 where either is 1, otherwise -1
+ */
+static uint64_t or_word(uint64_t a, uint64_t b){
+
+    uint64_t a_mag = a & LOW_BITS_64;
+    uint64_t a_neg = (a >> 1) & LOW_BITS_64;
+    uint64_t b_mag = b & LOW_BITS_64;
+    uint64_t b_neg = (b >> 1) & LOW_BITS_64;
+    uint64_t pos = (a_mag & ~a_neg) | (b_mag & ~b_neg);
+    uint64_t neg = (a_mag | b_mag) & ~pos;
+
+    assert((a_neg & ~a_mag) == 0 && (b_neg & ~b_mag) == 0);
+
+    return pos | neg | (neg << 1);
+}
+
+/**
+ * @brief The mask form of @c trit_xor_trit32_t.
+ *
+ * @warning This method asserts that @p a and @p b are in balanced ternary.
+ *
+ * @param[in] a The first balanced ternary word.
+ *
+ * @param[in] b The second balanced ternary word.
+ *
+ * @return -1 where the trits are equal, 1 where they are
+ * 1 and -1, otherwise 0
+ */
+static uint64_t xor_word(uint64_t a, uint64_t b){
+
+    uint64_t a_mag = a & LOW_BITS_64;
+    uint64_t a_neg = (a >> 1) & LOW_BITS_64;
+    uint64_t b_mag = b & LOW_BITS_64;
+    uint64_t b_neg = (b >> 1) & LOW_BITS_64;
+    uint64_t diff = a ^ b;
+    uint64_t neg = LOW_BITS_64 & ~(diff | (diff >> 1));
+    uint64_t pos = (a_mag & ~a_neg & b_neg) | (a_neg & b_mag & ~b_neg);
+
+    assert((a_neg & ~a_mag) == 0 && (b_neg & ~b_mag) == 0);
+
+    return pos | neg | (neg << 1);
+}
+
+/**
+ * @brief The mask form of @c trit_and_trit32_t.
+ *
+ * @warning This method asserts that @p a and @p b are in balanced ternary.
+ *
+ * @param[in] a The first balanced ternary word.
+ *
+ * @param[in] b The second balanced ternary word.
+ *
+ * @return 1 where both trits are 1, -1 where either is -1, otherwise 0
+ */
+static uint64_t and_word(uint64_t a, uint64_t b){
+
+    uint64_t a_mag = a & LOW_BITS_64;
+    uint64_t a_neg = (a >> 1) & LOW_BITS_64;
+    uint64_t b_mag = b & LOW_BITS_64;
+    uint64_t b_neg = (b >> 1) & LOW_BITS_64;
+    uint64_t neg = a_neg | b_neg;
+    uint64_t pos = a_mag & ~a_neg & b_mag & ~b_neg;
+
+    assert((a_neg & ~a_mag) == 0 && (b_neg & ~b_mag) == 0);
+
+    return pos | neg | (neg << 1);
+}
+
+/**
+ * @brief Adds two @c trit64_t numbers and a carry.
+ *
+ * Adds the low word and then the high word with the carry,
+ * keeping both halves in registers rather than splitting
+ * them into word arrays.
+ *
+ * @param[in] a The first 64 trit balanced ternary number.
+ *
+ * @param[in] b The second 64 trit balanced ternary number.
+ *
+ * @param[in] carry_in The carry into trit 0, -1, 0 or 1.
+ *
+ * @param[out] carry_out The carry out of trit 63, -1, 0 or 1.
+ *
+ * @return The low 64 trits of @p a + @p b + @p carry_in
+ */
+__attribute__((always_inline))
+static inline trit64_t add_trit64(trit64_t a, trit64_t b, int carry_in, int *carry_out){
+
+    int carry = carry_in;
+    uint64_t low = add_trits((uint64_t)a, (uint64_t)b, 32, carry, &carry);
+    uint64_t high = add_trits((uint64_t)(a >> 64), (uint64_t)(b >> 64), 32, carry, &carry);
+
+    *carry_out = carry;
+
+    return ((trit64_t)high << 64) | low;
+}
+
+/**
+ * @brief Converts binary to unbalanced ternary 32 trits per word.
+ *
+ * @warning This method asserts that @p num fits in @p count words.
+ *
+ * @param[in] num The binary number.
+ *
+ * @param[out] words The unbalanced ternary words, lowest first.
+ *
+ * @param[in] count The number of words.
+ */
+static void binary_to_unbalanced_words(__uint128_t num, uint64_t *words, int count){
+
+    int index = 0;
+
+    for(index = 0; index < count; index++){
+
+        words[index] = binary_to_unbalanced_ternary_trit32_t((uint64_t)(num % POW3_32));
+        num /= POW3_32;
+    }
+
+    assert(num == 0 && "Passed in num is too big");
+}
+
+/**
+ * @brief Converts binary to balanced ternary 32 trits per word.
+ *
+ * The magnitude is converted to unbalanced ternary, rebalanced
+ * word by word with the carry passed up and negated if
+ * @p num is negative.
+ *
+ * @warning This method asserts that @p num fits in @p count words.
+ *
+ * @param[in] num The binary number.
+ *
+ * @param[out] words The balanced ternary words, lowest first.
+ *
+ * @param[in] count The number of words.
+ */
+static void binary_to_balanced_words(__int128 num, uint64_t *words, int count){
+
+    __uint128_t magnitude = num < 0 ? -(__uint128_t)num : (__uint128_t)num;
+    bool carry = false;
+    int index = 0;
+
+    binary_to_unbalanced_words(magnitude, words, count);
+
+    for(index = 0; index < count; index++){
+
+        words[index] = unbalanced_to_balanced(words[index], 32, carry, &carry);
+
+        if(num < 0){
+
+            words[index] = not_word(words[index]);
+        }
+    }
+
+    assert(carry == false && "Number too big for ternary");
+}
+
+/**
+ * @brief Converts unbalanced ternary words to binary.
+ *
+ * @param[in] words The unbalanced ternary words, lowest first.
+ *
+ * @param[in] count The number of words.
+ *
+ * @param[out] overflow Set to true if the value does not
+ * fit in 128 bits, false otherwise.
+ *
+ * @return The value modulo 2^128
+ */
+static __uint128_t unbalanced_words_to_binary(const uint64_t *words, int count, bool *overflow){
+
+    __uint128_t result = 0;
+    int index = 0;
+
+    *overflow = false;
+
+    for(index = count - 1; index >= 0; index--){
+
+        __uint128_t digit = unbalanced_ternary_to_binary_uint64_t(words[index]);
+
+        *overflow |= __builtin_mul_overflow(result, (__uint128_t)POW3_32, &result);
+        *overflow |= __builtin_add_overflow(result, digit, &result);
+    }
+
+    return result;
+}
+
+/**
+ * @brief Converts balanced ternary words to binary.
+ *
+ * @param[in] words The balanced ternary words, lowest first.
+ *
+ * @param[in] count The number of words.
+ *
+ * @param[out] overflow Set to true if the value does not
+ * fit in an @c __int128, false otherwise.
+ *
+ * @return The value modulo 2^128
+ */
+static __int128 balanced_words_to_binary(const uint64_t *words, int count, bool *overflow){
+
+    __int128 result = 0;
+    int index = 0;
+
+    *overflow = false;
+
+    for(index = count - 1; index >= 0; index--){
+
+        __int128 digit = balanced_ternary_to_binary_int64_t(words[index]);
+
+        *overflow |= __builtin_mul_overflow(result, (__int128)POW3_32, &result);
+        *overflow |= __builtin_add_overflow(result, digit, &result);
+    }
+
+    return result;
+}
+
+/**
+ * @brief Converts binary to unbalanced ternary for @c trit64_t.
+ *
+ * The number is split into base 3^32 digits, each of which
+ * is converted into one 32 trit word.
+ *
+ * @warning This method asserts that the passed in binary
+ * number will fit into 64 trits.
+ *
+ * @param[in] num The binary number to
+ * be turned into unbalanced ternary.
+ *
+ * @return The final result of turning the binary
+ * number to unbalanced ternary.
+ */
+trit64_t binary_to_unbalanced_ternary_trit64_t(__uint128_t num){
+
+    uint64_t words[2];
+
+    binary_to_unbalanced_words(num, words, 2);
+
+    return join_trit64_t(words);
+}
+
+/**
+ * @brief Converts binary to balanced ternary for @c trit64_t.
+ *
+ * Unlike the narrower types negative numbers are accepted.
+ *
+ * @warning This method asserts that the passed in binary
+ * number will fit into 64 trits.
+ *
+ * @param[in] num The binary number to
+ * be turned into balanced ternary.
+ *
+ * @return The final result of turning the binary
+ * number to balanced ternary.
+ */
+trit64_t binary_to_balanced_ternary_trit64_t(__int128 num){
+
+    uint64_t words[2];
+
+    binary_to_balanced_words(num, words, 2);
+
+    return join_trit64_t(words);
+}
+
+/**
+ * @brief Converts unbalanced ternary to balanced ternary for @c trit64_t.
+ *
+ * Each 32 trit word is converted with the carry of the
+ * word below it.
+ *
+ * @warning This method asserts that the passed in
+ * number will fit into 64 trits.
+ *
+ * @warning This method asserts that the passed in
+ * number is encoded in unbalanced ternary.
+ *
+ * @param[in] num The unbalanced ternary number to
+ * be turned into balanced ternary.
+ *
+ * @return The final result of turning the unbalanced
+ * ternary number to balanced ternary.
+ */
+trit64_t unbalanced_ternary_to_balanced_ternary_trit64_t(trit64_t num){
+
+    uint64_t words[2];
+    bool carry = false;
+    int index = 0;
+
+    split_trit64_t(num, words);
+
+    for(index = 0; index < 2; index++){
+
+        words[index] = unbalanced_to_balanced(words[index], 32, carry, &carry);
+    }
+
+    assert(carry == false && "Number too big for ternary");
+
+    return join_trit64_t(words);
+}
+
+/**
+ * @brief Converts balanced ternary to unbalanced ternary for @c trit64_t.
+ *
+ * Each 32 trit word is converted with the borrow of the
+ * word below it.
+ *
+ * @warning This method asserts that the passed in
+ * number is not negative.
+ *
+ * @param[in] num The balanced ternary number to
+ * be turned into unbalanced ternary.
+ *
+ * @return The final result of turning the balanced
+ * ternary number to unbalanced ternary.
+ */
+trit64_t balanced_ternary_to_unbalanced_ternary_trit64_t(trit64_t num){
+
+    uint64_t words[2];
+    bool borrow = false;
+    int index = 0;
+
+    split_trit64_t(num, words);
+
+    for(index = 0; index < 2; index++){
+
+        words[index] = balanced_to_unbalanced(words[index], 32, borrow, &borrow);
+    }
+
+    assert(borrow == false && "Number is negative");
+
+    return join_trit64_t(words);
+}
+
+/**
+ * @brief Adds together two @c trit64_t numbers.
+ *
+ * This method adds together @p a and @p b 32 trits at a
+ * time, passing the carry from word to word.
+ * Overflow is reported through @p overflow only,
+ * so the method has no side effects.
+ *
+ * @warning This method asserts that @p a and
+ * @p b are in balanced ternary.
+ *
+ * @param[in] a The first 64 trit balanced
+ * ternary value to be added
+ *
+ * @param[in] b The second 64 trit balanced
+ * ternary value to be added
+ *
+ * @param[out] overflow Set to true if the sum
+ * does not fit in 64 trits, false otherwise
+ *
+ * @return A 64 trit balanced ternary number
+ * resulting of adding together @p a and @p b
+ */
+trit64_t trit_add_checked_trit64_t(trit64_t a, trit64_t b, bool *overflow){
+
+    int carry = 0;
+    trit64_t sum = add_trit64(a, b, 0, &carry);
+
+    *overflow = carry != 0;
+
+    return sum;
+}
+
+/**
+ * @brief Adds together two @c trit64_t numbers.
+ *
+ * This method adds together @p a and @p b
+ * to create a @c trit64_t balanced ternary number.
+ *
+ * @see trit_add_checked_trit64_t
+ *
+ * @note If an overflow error occurs errno variable
+ * is set to EOVERFLOW
+ *
+ * @param[in] a The first 64 trit balanced
+ * ternary value to be added
+ *
+ * @param[in] b The second 64 trit balanced
+ * ternary value to be added
+ *
+ * @return A 64 trit balanced ternary number
+ * resulting of adding together @p a and @p b
+ */
+trit64_t trit_add_trit64_t(trit64_t a, trit64_t b){
+
+    bool overflow = false;
+    trit64_t result = trit_add_checked_trit64_t(a, b, &overflow);
+
+    if(overflow){
+
+        errno = EOVERFLOW;
+    }
+
+    return result;
+}
+
+/**
+ * @brief Subtracts two @c trit64_t numbers.
+ *
+ * This method subtracts @p b from @p a and reports
+ * overflow through @p overflow only.
+ *
+ * @see trit_not_trit64_t
+ * @see trit_add_checked_trit64_t
+ *
+ * @param[in] a The 64 trit balanced
+ * ternary value to be subtracted from
+ *
+ * @param[in] b The 64 trit balanced
+ * ternary value to be subtracted
+ *
+ * @param[out] overflow Set to true if the difference
+ * does not fit in 64 trits, false otherwise
+ *
+ * @return A 64 trit balanced ternary number
+ * resulting of subtracting @p b from @p a
+ */
+trit64_t trit_sub_checked_trit64_t(trit64_t a, trit64_t b, bool *overflow){
+
+    return trit_add_checked_trit64_t(a, trit_not_trit64_t(b), overflow);
+}
+
+/**
+ * @brief Subtracts two @c trit64_t numbers.
+ *
+ * @see trit_sub_checked_trit64_t
+ *
+ * @note If an overflow error occurs errno variable
+ * is set to EOVERFLOW
+ *
+ * @param[in] a The 64 trit balanced
+ * ternary value to be subtracted from
+ *
+ * @param[in] b The 64 trit balanced
+ * ternary value to be subtracted
+ *
+ * @return A 64 trit balanced ternary number
+ * resulting of subtracting @p b from @p a
+ */
+trit64_t trit_sub_trit64_t(trit64_t a, trit64_t b){
+
+    return trit_add_trit64_t(a, trit_not_trit64_t(b));
+}
+
+/**
+ * This method OR's together @p a and @p b
+ *
+ * @warning This method asserts that @p a
+ * and @p b are in balanced ternary.
+ *
+ * @param[in] a The first 64 trit balanced
+ * ternary number
+ *
+ * @param[in] b The second 64 trit balanced
+ * ternary number
+ *
+ * @return A 64 trit balanced ternary number
+ * resulting from the OR of @p a and @p b
+ */
+trit64_t trit_or_trit64_t(trit64_t a, trit64_t b){
+
+    uint64_t words_a[2];
+    uint64_t words_b[2];
+    int index = 0;
+
+    split_trit64_t(a, words_a);
+    split_trit64_t(b, words_b);
+
+    for(index = 0; index < 2; index++){
+
+        words_a[index] = or_word(words_a[index], words_b[index]);
+    }
+
+    return join_trit64_t(words_a);
+}
+
+/**
+ * This method XOR's together @p a and @p b
+ *
+ * @warning This method asserts that @p a
+ * and @p b are in balanced ternary.
+ *
+ * @param[in] a The first 64 trit balanced
+ * ternary number
+ *
+ * @param[in] b The second 64 trit balanced
+ * ternary number
+ *
+ * @return A 64 trit balanced ternary number
+ * resulting from the XOR of @p a and @p b
+ */
+trit64_t trit_xor_trit64_t(trit64_t a, trit64_t b){
+
+    uint64_t words_a[2];
+    uint64_t words_b[2];
+    int index = 0;
+
+    split_trit64_t(a, words_a);
+    split_trit64_t(b, words_b);
+
+    for(index = 0; index < 2; index++){
+
+        words_a[index] = xor_word(words_a[index], words_b[index]);
+    }
+
+    return join_trit64_t(words_a);
+}
+
+/**
+ * This method AND's together @p a and @p b
+ *
+ * @warning This method asserts that @p a
+ * and @p b are in balanced ternary.
+ *
+ * @param[in] a The first 64 trit balanced
+ * ternary number
+ *
+ * @param[in] b The second 64 trit balanced
+ * ternary number
+ *
+ * @return A 64 trit balanced ternary number
+ * resulting from the AND of @p a and @p b
+ */
+trit64_t trit_and_trit64_t(trit64_t a, trit64_t b){
+
+    uint64_t words_a[2];
+    uint64_t words_b[2];
+    int index = 0;
+
+    split_trit64_t(a, words_a);
+    split_trit64_t(b, words_b);
+
+    for(index = 0; index < 2; index++){
+
+        words_a[index] = and_word(words_a[index], words_b[index]);
+    }
+
+    return join_trit64_t(words_a);
+}
+
+/**
+ * @brief Returns the negation of @p num
+ *
+ * This method takes in a @c trit64_t balanced
+ * ternary number and returns the negation.
+ *
+ * @warning This method asserts that @p num
+ * is in balanced ternary.
+ *
+ * @param[in] num The 64 trit balanced ternary
+ * number to be negated.
+ *
+ * @return A 64 trit balanced ternary number
+ * of the negation of @p num
+ */
+trit64_t trit_not_trit64_t(trit64_t num){
+
+    uint64_t words[2];
+    int index = 0;
+
+    split_trit64_t(num, words);
+
+    for(index = 0; index < 2; index++){
+
+        words[index] = not_word(words[index]);
+    }
+
+    return join_trit64_t(words);
+}
+
+/**
+ * @brief Counts the trits of @p num equal to @p digit.
+ *
+ * @warning This method asserts that @p digit
+ * is -1, 0 or 1.
+ *
+ * @param[in] num The 64 trit balanced ternary number.
+ *
+ * @param[in] digit The trit value to be counted.
+ *
+ * @return The number of trits of @p num equal to @p digit
+ */
+uint8_t trit_count_trit64_t(trit64_t num, int8_t digit){
+
+    uint64_t words[2];
+    uint8_t result = 0;
+    int index = 0;
+
+    split_trit64_t(num, words);
+
+    for(index = 0; index < 2; index++){
+
+        result += trit_count_trit32_t(words[index], digit);
+    }
+
+    return result;
+}
+
+/**
+ * @brief Counts the trits that differ between @p a and @p b.
+ *
+ * @param[in] a The first 64 trit number.
+ *
+ * @param[in] b The second 64 trit number.
+ *
+ * @return The number of trit positions where @p a and @p b differ
+ */
+uint8_t trit_hamming_trit64_t(trit64_t a, trit64_t b){
+
+    uint64_t words_a[2];
+    uint64_t words_b[2];
+    uint8_t result = 0;
+    int index = 0;
+
+    split_trit64_t(a, words_a);
+    split_trit64_t(b, words_b);
+
+    for(index = 0; index < 2; index++){
+
+        result += trit_hamming_trit32_t(words_a[index], words_b[index]);
+    }
+
+    return result;
+}
+
+/**
+ * @brief Ternary inner product of @p a and @p b.
+ *
+ * @see trit_similarity_trit32_t
+ *
+ * @warning This method expects @p a and @p b
+ * to be in balanced ternary.
+ *
+ * @param[in] a The first 64 trit balanced ternary number.
+ *
+ * @param[in] b The second 64 trit balanced ternary number.
+ *
+ * @return The sum of the trit-wise products, -64 to 64
+ */
+int8_t trit_similarity_trit64_t(trit64_t a, trit64_t b){
+
+    uint64_t words_a[2];
+    uint64_t words_b[2];
+    int8_t result = 0;
+    int index = 0;
+
+    split_trit64_t(a, words_a);
+    split_trit64_t(b, words_b);
+
+    for(index = 0; index < 2; index++){
+
+        result += trit_similarity_trit32_t(words_a[index], words_b[index]);
+    }
+
+    return result;
+}
+
+/**
+ * @brief Converts binary to unbalanced ternary for @c trit128_t.
+ *
+ * The number is split into base 3^32 digits, each of which
+ * is converted into one 32 trit word.
+ *
+ * @warning This method asserts that the passed in binary
+ * number will fit into 128 trits.
+ *
+ * @param[in] num The binary number to
+ * be turned into unbalanced ternary.
+ *
+ * @return The final result of turning the binary
+ * number to unbalanced ternary.
+ */
+trit128_t binary_to_unbalanced_ternary_trit128_t(__uint128_t num){
+
+    uint64_t words[4];
+
+    binary_to_unbalanced_words(num, words, 4);
+
+    return join_trit128_t(words);
+}
+
+/**
+ * @brief Converts binary to balanced ternary for @c trit128_t.
+ *
+ * Unlike the narrower types negative numbers are accepted.
+ *
+ * @warning This method asserts that the passed in binary
+ * number will fit into 128 trits.
+ *
+ * @param[in] num The binary number to
+ * be turned into balanced ternary.
+ *
+ * @return The final result of turning the binary
+ * number to balanced ternary.
+ */
+trit128_t binary_to_balanced_ternary_trit128_t(__int128 num){
+
+    uint64_t words[4];
+
+    binary_to_balanced_words(num, words, 4);
+
+    return join_trit128_t(words);
+}
+
+/**
+ * @brief Converts unbalanced ternary to balanced ternary for @c trit128_t.
+ *
+ * Each 32 trit word is converted with the carry of the
+ * word below it.
+ *
+ * @warning This method asserts that the passed in
+ * number will fit into 128 trits.
+ *
+ * @warning This method asserts that the passed in
+ * number is encoded in unbalanced ternary.
+ *
+ * @param[in] num The unbalanced ternary number to
+ * be turned into balanced ternary.
+ *
+ * @return The final result of turning the unbalanced
+ * ternary number to balanced ternary.
+ */
+trit128_t unbalanced_ternary_to_balanced_ternary_trit128_t(trit128_t num){
+
+    uint64_t words[4];
+    bool carry = false;
+    int index = 0;
+
+    split_trit128_t(num, words);
+
+    for(index = 0; index < 4; index++){
+
+        words[index] = unbalanced_to_balanced(words[index], 32, carry, &carry);
+    }
+
+    assert(carry == false && "Number too big for ternary");
+
+    return join_trit128_t(words);
+}
+
+/**
+ * @brief Converts balanced ternary to unbalanced ternary for @c trit128_t.
+ *
+ * Each 32 trit word is converted with the borrow of the
+ * word below it.
+ *
+ * @warning This method asserts that the passed in
+ * number is not negative.
+ *
+ * @param[in] num The balanced ternary number to
+ * be turned into unbalanced ternary.
+ *
+ * @return The final result of turning the balanced
+ * ternary number to unbalanced ternary.
+ */
+trit128_t balanced_ternary_to_unbalanced_ternary_trit128_t(trit128_t num){
+
+    uint64_t words[4];
+    bool borrow = false;
+    int index = 0;
+
+    split_trit128_t(num, words);
+
+    for(index = 0; index < 4; index++){
+
+        words[index] = balanced_to_unbalanced(words[index], 32, borrow, &borrow);
+    }
+
+    assert(borrow == false && "Number is negative");
+
+    return join_trit128_t(words);
+}
+
+/**
+ * @brief Adds together two @c trit128_t numbers.
+ *
+ * This method adds together @p a and @p b 32 trits at a
+ * time, passing the carry from word to word.
+ * Overflow is reported through @p overflow only,
+ * so the method has no side effects.
+ *
+ * @warning This method asserts that @p a and
+ * @p b are in balanced ternary.
+ *
+ * @param[in] a The first 128 trit balanced
+ * ternary value to be added
+ *
+ * @param[in] b The second 128 trit balanced
+ * ternary value to be added
+ *
+ * @param[out] overflow Set to true if the sum
+ * does not fit in 128 trits, false otherwise
+ *
+ * @return A 128 trit balanced ternary number
+ * resulting of adding together @p a and @p b
+ */
+trit128_t trit_add_checked_trit128_t(trit128_t a, trit128_t b, bool *overflow){
+
+    trit128_t result;
+    int carry = 0;
+
+    result.low = add_trit64(a.low, b.low, 0, &carry);
+    result.high = add_trit64(a.high, b.high, carry, &carry);
+    *overflow = carry != 0;
+
+    return result;
+}
+
+/**
+ * @brief Adds together two @c trit128_t numbers.
+ *
+ * This method adds together @p a and @p b
+ * to create a @c trit128_t balanced ternary number.
+ *
+ * @see trit_add_checked_trit128_t
+ *
+ * @note If an overflow error occurs errno variable
+ * is set to EOVERFLOW
+ *
+ * @param[in] a The first 128 trit balanced
+ * ternary value to be added
+ *
+ * @param[in] b The second 128 trit balanced
+ * ternary value to be added
+ *
+ * @return A 128 trit balanced ternary number
+ * resulting of adding together @p a and @p b
+ */
+trit128_t trit_add_trit128_t(trit128_t a, trit128_t b){
+
+    bool overflow = false;
+    trit128_t result = trit_add_checked_trit128_t(a, b, &overflow);
+
+    if(overflow){
+
+        errno = EOVERFLOW;
+    }
+
+    return result;
+}
+
+/**
+ * @brief Subtracts two @c trit128_t numbers.
+ *
+ * This method subtracts @p b from @p a and reports
+ * overflow through @p overflow only.
+ *
+ * @see trit_not_trit128_t
+ * @see trit_add_checked_trit128_t
+ *
+ * @param[in] a The 128 trit balanced
+ * ternary value to be subtracted from
+ *
+ * @param[in] b The 128 trit balanced
+ * ternary value to be subtracted
+ *
+ * @param[out] overflow Set to true if the difference
+ * does not fit in 128 trits, false otherwise
+ *
+ * @return A 128 trit balanced ternary number
+ * resulting of subtracting @p b from @p a
+ */
+trit128_t trit_sub_checked_trit128_t(trit128_t a, trit128_t b, bool *overflow){
+
+    return trit_add_checked_trit128_t(a, trit_not_trit128_t(b), overflow);
+}
+
+/**
+ * @brief Subtracts two @c trit128_t numbers.
+ *
+ * @see trit_sub_checked_trit128_t
+ *
+ * @note If an overflow error occurs errno variable
+ * is set to EOVERFLOW
+ *
+ * @param[in] a The 128 trit balanced
+ * ternary value to be subtracted from
+ *
+ * @param[in] b The 128 trit balanced
+ * ternary value to be subtracted
+ *
+ * @return A 128 trit balanced ternary number
+ * resulting of subtracting @p b from @p a
+ */
+trit128_t trit_sub_trit128_t(trit128_t a, trit128_t b){
+
+    return trit_add_trit128_t(a, trit_not_trit128_t(b));
+}
+
+/**
+ * This method OR's together @p a and @p b
+ *
+ * @warning This method asserts that @p a
+ * and @p b are in balanced ternary.
+ *
+ * @param[in] a The first 128 trit balanced
+ * ternary number
+ *
+ * @param[in] b The second 128 trit balanced
+ * ternary number
+ *
+ * @return A 128 trit balanced ternary number
+ * resulting from the OR of @p a and @p b
+ */
+trit128_t trit_or_trit128_t(trit128_t a, trit128_t b){
+
+    uint64_t words_a[4];
+    uint64_t words_b[4];
+    int index = 0;
+
+    split_trit128_t(a, words_a);
+    split_trit128_t(b, words_b);
+
+    for(index = 0; index < 4; index++){
+
+        words_a[index] = or_word(words_a[index], words_b[index]);
+    }
+
+    return join_trit128_t(words_a);
+}
+
+/**
+ * This method XOR's together @p a and @p b
+ *
+ * @warning This method asserts that @p a
+ * and @p b are in balanced ternary.
+ *
+ * @param[in] a The first 128 trit balanced
+ * ternary number
+ *
+ * @param[in] b The second 128 trit balanced
+ * ternary number
+ *
+ * @return A 128 trit balanced ternary number
+ * resulting from the XOR of @p a and @p b
+ */
+trit128_t trit_xor_trit128_t(trit128_t a, trit128_t b){
+
+    uint64_t words_a[4];
+    uint64_t words_b[4];
+    int index = 0;
+
+    split_trit128_t(a, words_a);
+    split_trit128_t(b, words_b);
+
+    for(index = 0; index < 4; index++){
+
+        words_a[index] = xor_word(words_a[index], words_b[index]);
+    }
+
+    return join_trit128_t(words_a);
+}
+
+/**
+ * This method AND's together @p a and @p b
+ *
+ * @warning This method asserts that @p a
+ * and @p b are in balanced ternary.
+ *
+ * @param[in] a The first 128 trit balanced
+ * ternary number
+ *
+ * @param[in] b The second 128 trit balanced
+ * ternary number
+ *
+ * @return A 128 trit balanced ternary number
+ * resulting from the AND of @p a and @p b
+ */
+trit128_t trit_and_trit128_t(trit128_t a, trit128_t b){
+
+    uint64_t words_a[4];
+    uint64_t words_b[4];
+    int index = 0;
+
+    split_trit128_t(a, words_a);
+    split_trit128_t(b, words_b);
+
+    for(index = 0; index < 4; index++){
+
+        words_a[index] = and_word(words_a[index], words_b[index]);
+    }
+
+    return join_trit128_t(words_a);
+}
+
+/**
+ * @brief Returns the negation of @p num
+ *
+ * This method takes in a @c trit128_t balanced
+ * ternary number and returns the negation.
+ *
+ * @warning This method asserts that @p num
+ * is in balanced ternary.
+ *
+ * @param[in] num The 128 trit balanced ternary
+ * number to be negated.
+ *
+ * @return A 128 trit balanced ternary number
+ * of the negation of @p num
+ */
+trit128_t trit_not_trit128_t(trit128_t num){
+
+    uint64_t words[4];
+    int index = 0;
+
+    split_trit128_t(num, words);
+
+    for(index = 0; index < 4; index++){
+
+        words[index] = not_word(words[index]);
+    }
+
+    return join_trit128_t(words);
+}
+
+/**
+ * @brief Counts the trits of @p num equal to @p digit.
+ *
+ * @warning This method asserts that @p digit
+ * is -1, 0 or 1.
+ *
+ * @param[in] num The 128 trit balanced ternary number.
+ *
+ * @param[in] digit The trit value to be counted.
+ *
+ * @return The number of trits of @p num equal to @p digit
+ */
+uint8_t trit_count_trit128_t(trit128_t num, int8_t digit){
+
+    uint64_t words[4];
+    uint8_t result = 0;
+    int index = 0;
+
+    split_trit128_t(num, words);
+
+    for(index = 0; index < 4; index++){
+
+        result += trit_count_trit32_t(words[index], digit);
+    }
+
+    return result;
+}
+
+/**
+ * @brief Counts the trits that differ between @p a and @p b.
+ *
+ * @param[in] a The first 128 trit number.
+ *
+ * @param[in] b The second 128 trit number.
+ *
+ * @return The number of trit positions where @p a and @p b differ
+ */
+uint8_t trit_hamming_trit128_t(trit128_t a, trit128_t b){
+
+    uint64_t words_a[4];
+    uint64_t words_b[4];
+    uint8_t result = 0;
+    int index = 0;
+
+    split_trit128_t(a, words_a);
+    split_trit128_t(b, words_b);
+
+    for(index = 0; index < 4; index++){
+
+        result += trit_hamming_trit32_t(words_a[index], words_b[index]);
+    }
+
+    return result;
+}
+
+/**
+ * @brief Ternary inner product of @p a and @p b.
+ *
+ * @see trit_similarity_trit32_t
+ *
+ * @warning This method expects @p a and @p b
+ * to be in balanced ternary.
+ *
+ * @param[in] a The first 128 trit balanced ternary number.
+ *
+ * @param[in] b The second 128 trit balanced ternary number.
+ *
+ * @return The sum of the trit-wise products, -128 to 128
+ */
+int16_t trit_similarity_trit128_t(trit128_t a, trit128_t b){
+
+    uint64_t words_a[4];
+    uint64_t words_b[4];
+    int16_t result = 0;
+    int index = 0;
+
+    split_trit128_t(a, words_a);
+    split_trit128_t(b, words_b);
+
+    for(index = 0; index < 4; index++){
+
+        result += trit_similarity_trit32_t(words_a[index], words_b[index]);
+    }
+
+    return result;
+}
+
+/**
+ * @brief Converts unbalanced ternary to binary for @c __uint128_t.
+ *
+ * Takes a @c trit64_t number with a unbalanced ternary
+ * encoding and converts to @c __uint128_t number.
+ *
+ * @warning This method asserts that the passed in
+ * number is encoded in unbalanced ternary.
+ *
+ * @param[in] num The unbalanced ternary number to
+ * be turned into binary.
+ *
+ * @return The final result of turning the unbalanced
+ * ternary number to binary.
+ */
+__uint128_t unbalanced_ternary_to_binary_uint128_t(trit64_t num){
+
+    uint64_t words[2];
+    bool overflow = false;
+
+    split_trit64_t(num, words);
+
+    return unbalanced_words_to_binary(words, 2, &overflow);
+}
+
+/**
+ * @brief Converts balanced ternary to binary for @c __int128.
+ *
+ * Takes a @c trit64_t number with a balanced ternary
+ * encoding and converts to @c __int128 number.
+ *
+ * @warning This method asserts that the passed in
+ * number is encoded in balanced ternary.
+ *
+ * @param[in] num The balanced ternary number to
+ * be turned into binary.
+ *
+ * @return The final result of turning the balanced
+ * ternary number to binary.
+ */
+__int128 balanced_ternary_to_binary_int128_t(trit64_t num){
+
+    uint64_t words[2];
+    bool overflow = false;
+
+    split_trit64_t(num, words);
+
+    return balanced_words_to_binary(words, 2, &overflow);
+}
+
+/**
+ * @brief Converts unbalanced ternary to binary for @c __uint128_t.
+ *
+ * A @c trit128_t holds numbers up to 3^128 - 1 which
+ * is more than 128 bits can hold, so overflow is reported.
+ *
+ * @warning This method asserts that the passed in
+ * number is encoded in unbalanced ternary.
+ *
+ * @param[in] num The unbalanced ternary number to
+ * be turned into binary.
+ *
+ * @param[out] overflow Set to true if @p num does not
+ * fit in a @c __uint128_t, false otherwise.
+ *
+ * @return @p num modulo 2^128
+ */
+__uint128_t unbalanced_ternary_to_binary_checked_uint128_t(trit128_t num, bool *overflow){
+
+    uint64_t words[4];
+
+    split_trit128_t(num, words);
+
+    return unbalanced_words_to_binary(words, 4, overflow);
+}
+
+/**
+ * @brief Converts balanced ternary to binary for @c __int128.
+ *
+ * A @c trit128_t holds numbers up to (3^128 - 1) / 2 which
+ * is more than 128 bits can hold, so overflow is reported.
+ *
+ * @warning This method asserts that the passed in
+ * number is encoded in balanced ternary.
+ *
+ * @param[in] num The balanced ternary number to
+ * be turned into binary.
+ *
+ * @param[out] overflow Set to true if @p num does not
+ * fit in an @c __int128, false otherwise.
+ *
+ * @return @p num modulo 2^128
+ */
+__int128 balanced_ternary_to_binary_checked_int128_t(trit128_t num, bool *overflow){
+
+    uint64_t words[4];
+
+    split_trit128_t(num, words);
+
+    return balanced_words_to_binary(words, 4, overflow);
+}
+
+/**
+ * @brief Shifts the trits of @p a to the left.
+ *
+ * @param[in] a Some 64 trit number to be shifted.
+ *
+ * @param[in] b How many trits @p a should be shifted
+ *
+ * @return The result of shifting @p a some
+ * number of trits resulting in an @c trit64_t number.
+ */
+trit64_t trit_sl_trit64_t(trit64_t a, uint8_t b){
+
+    if(b >= 64){
+
+        return 0;
+    }
+
+    return a << (2 * b);
+}
+
+/**
+ * @brief Shifts the trits of @p a to the right.
+ *
+ * @param[in] a Some 64 trit number to be shifted.
+ *
+ * @param[in] b How many trits @p a should be shifted
+ *
+ * @return The result of shifting @p a some
+ * number of trits resulting in an @c trit64_t number.
+ */
+trit64_t trit_sr_trit64_t(trit64_t a, uint8_t b){
+
+    if(b >= 64){
+
+        return 0;
+    }
+
+    return a >> (2 * b);
+}
+
+/**
+ * @brief Shifts the trits of @p a to the left.
+ *
+ * @param[in] a Some 128 trit number to be shifted.
+ *
+ * @param[in] b How many trits @p a should be shifted
+ *
+ * @return The result of shifting @p a some
+ * number of trits resulting in an @c trit128_t number.
+ */
+trit128_t trit_sl_trit128_t(trit128_t a, uint8_t b){
+
+    trit128_t result;
+
+    if(b >= 64){
+
+        result.high = trit_sl_trit64_t(a.low, b - 64);
+        result.low = 0;
+    }
+    else if(b > 0){
+
+        result.high = (a.high << (2 * b)) | (a.low >> (128 - 2 * b));
+        result.low = a.low << (2 * b);
+    }
+    else{
+
+        result = a;
+    }
+
+    return result;
+}
+
+/**
+ * @brief Shifts the trits of @p a to the right.
+ *
+ * @param[in] a Some 128 trit number to be shifted.
+ *
+ * @param[in] b How many trits @p a should be shifted
+ *
+ * @return The result of shifting @p a some
+ * number of trits resulting in an @c trit128_t number.
+ */
+trit128_t trit_sr_trit128_t(trit128_t a, uint8_t b){
+
+    trit128_t result;
+
+    if(b >= 64){
+
+        result.low = trit_sr_trit64_t(a.high, b - 64);
+        result.high = 0;
+    }
+    else if(b > 0){
+
+        result.low = (a.low >> (2 * b)) | (a.high << (128 - 2 * b));
+        result.high = a.high >> (2 * b);
+    }
+    else{
+
+        result = a;
+    }
+
+    return result;
+}
+
+/**
+ * @brief Splits a @c trit64_t into magnitude and sign bitmasks.
+ *
+ * @see trit_unpack_trit32_t
+ *
+ * @param[in] num The 64 trit number to be split.
+ *
+ * @param[out] mag The low bit of every trit.
+ *
+ * @param[out] sign The high bit of every trit.
+ */
+void trit_unpack_trit64_t(trit64_t num, uint64_t *mag, uint64_t *sign){
+
+    uint32_t mag_low = 0, mag_high = 0;
+    uint32_t sign_low = 0, sign_high = 0;
+
+    trit_unpack_trit32_t((uint64_t)num, &mag_low, &sign_low);
+    trit_unpack_trit32_t((uint64_t)(num >> 64), &mag_high, &sign_high);
+
+    *mag = ((uint64_t)mag_high << 32) | mag_low;
+    *sign = ((uint64_t)sign_high << 32) | sign_low;
+}
+
+/**
+ * @brief Splits a @c trit128_t into magnitude and sign bitmasks.
+ *
+ * @see trit_unpack_trit32_t
+ *
+ * @param[in] num The 128 trit number to be split.
+ *
+ * @param[out] mag The low bit of every trit.
+ *
+ * @param[out] sign The high bit of every trit.
+ */
+void trit_unpack_trit128_t(trit128_t num, __uint128_t *mag, __uint128_t *sign){
+
+    uint64_t mag_low = 0, mag_high = 0;
+    uint64_t sign_low = 0, sign_high = 0;
+
+    trit_unpack_trit64_t(num.low, &mag_low, &sign_low);
+    trit_unpack_trit64_t(num.high, &mag_high, &sign_high);
+
+    *mag = ((__uint128_t)mag_high << 64) | mag_low;
+    *sign = ((__uint128_t)sign_high << 64) | sign_low;
+}
+
+/**
+ * @brief Merges magnitude and sign bitmasks into a @c trit64_t.
+ *
+ * @see trit_pack_trit32_t
+ *
+ * @param[in] mag The low bit of every trit.
+ *
+ * @param[in] sign The high bit of every trit.
+ *
+ * @return The 64 trit number made from @p mag and @p sign
+ */
+trit64_t trit_pack_trit64_t(uint64_t mag, uint64_t sign){
+
+    trit32_t low = trit_pack_trit32_t((uint32_t)mag, (uint32_t)sign);
+    trit32_t high = trit_pack_trit32_t((uint32_t)(mag >> 32), (uint32_t)(sign >> 32));
+
+    return ((trit64_t)high << 64) | low;
+}
+
+/**
+ * @brief Merges magnitude and sign bitmasks into a @c trit128_t.
+ *
+ * @see trit_pack_trit32_t
+ *
+ * @param[in] mag The low bit of every trit.
+ *
+ * @param[in] sign The high bit of every trit.
+ *
+ * @return The 128 trit number made from @p mag and @p sign
+ */
+trit128_t trit_pack_trit128_t(__uint128_t mag, __uint128_t sign){
+
+    trit128_t result;
+
+    result.low = trit_pack_trit64_t((uint64_t)mag, (uint64_t)sign);
+    result.high = trit_pack_trit64_t((uint64_t)(mag >> 64), (uint64_t)(sign >> 64));
+
+    return result;
+}
+
+/**
+ * @brief Widens a @c trit32_t to a @c trit64_t.
+ *
+ * @see trit_widen_trit8_t_to_trit16_t
+ *
+ * @param[in] num The 32 trit number.
+ *
+ * @return @p num as a 64 trit number
+ */
+trit64_t trit_widen_trit32_t_to_trit64_t(trit32_t num){
+
+    return (trit64_t)num;
+}
+
+/**
+ * @brief Widens a @c trit64_t to a @c trit128_t.
+ *
+ * @see trit_widen_trit8_t_to_trit16_t
+ *
+ * @param[in] num The 64 trit number.
+ *
+ * @return @p num as a 128 trit number
+ */
+trit128_t trit_widen_trit64_t_to_trit128_t(trit64_t num){
+
+    trit128_t result;
+
+    result.low = num;
+    result.high = 0;
+
+    return result;
+}
+
+/**
+ * @brief Narrows a @c trit64_t to a @c trit32_t and reports overflow.
+ *
+ * @param[in] num The 64 trit number.
+ *
+ * @param[out] overflow Set to true if @p num does not
+ * fit in 32 trits, false otherwise.
+ *
+ * @return The low 32 trits of @p num
+ *
+ * @see trit_narrow_wrap_trit64_t_to_trit32_t
+ */
+trit32_t trit_narrow_checked_trit64_t_to_trit32_t(trit64_t num, bool *overflow){
+
+    *overflow = (num >> 64) != 0;
+
+    return (trit32_t)num;
+}
+
+/**
+ * @brief Narrows a @c trit128_t to a @c trit64_t and reports overflow.
+ *
+ * @param[in] num The 128 trit number.
+ *
+ * @param[out] overflow Set to true if @p num does not
+ * fit in 64 trits, false otherwise.
+ *
+ * @return The low 64 trits of @p num
+ *
+ * @see trit_narrow_wrap_trit128_t_to_trit64_t
+ */
+trit64_t trit_narrow_checked_trit128_t_to_trit64_t(trit128_t num, bool *overflow){
+
+    *overflow = num.high != 0;
+
+    return num.low;
+}
+
+/**
+ * @brief Narrows a @c trit64_t to a @c trit32_t modulo 3^32.
+ *
+ * @param[in] num The 64 trit number.
+ *
+ * @return The low 32 trits of @p num
+ *
+ * @see trit_narrow_checked_trit64_t_to_trit32_t
+ */
+trit32_t trit_narrow_wrap_trit64_t_to_trit32_t(trit64_t num){
+
+    return (trit32_t)num;
+}
+
+/**
+ * @brief Narrows a @c trit128_t to a @c trit64_t modulo 3^64.
+ *
+ * @param[in] num The 128 trit number.
+ *
+ * @return The low 64 trits of @p num
+ *
+ * @see trit_narrow_checked_trit128_t_to_trit64_t
+ */
+trit64_t trit_narrow_wrap_trit128_t_to_trit64_t(trit128_t num){
+
+    return num.low;
+}
+
+/**
+ * @brief Multiplies two @c trit8_t numbers into a @c trit16_t.
+ *
+ * The product of two 8 trit numbers always fits in 16 trits.
+ *
+ * @warning This method asserts that @p a and
+ * @p b are in balanced ternary.
+ *
+ * @param[in] a The first 8 trit balanced ternary factor.
+ *
+ * @param[in] b The second 8 trit balanced ternary factor.
+ *
+ * @return The 16 trit product of @p a and @p b
+ */
+trit16_t trit_mul_wide_trit8_t(trit8_t a, trit8_t b){
+
+    return (trit16_t)value_trits(trits_value(a, 2) * trits_value(b, 2), 4);
+}
+
+/**
+ * @brief Multiplies two @c trit16_t numbers into a @c trit32_t.
+ *
+ * The product of two 16 trit numbers always fits in 32 trits.
+ *
+ * @warning This method asserts that @p a and
+ * @p b are in balanced ternary.
+ *
+ * @param[in] a The first 16 trit balanced ternary factor.
+ *
+ * @param[in] b The second 16 trit balanced ternary factor.
+ *
+ * @return The 32 trit product of @p a and @p b
+ */
+trit32_t trit_mul_wide_trit16_t(trit16_t a, trit16_t b){
+
+    return (trit32_t)value_trits(trits_value(a, 4) * trits_value(b, 4), 8);
+}
+
+/**
+ * @brief Multiplies two @c trit32_t numbers into a @c trit64_t.
+ *
+ * Both factors are split into 16 trit halves, the partial
+ * products are summed in binary per 16 trit limb and the limbs
+ * are written back with their balanced carries passed up.
+ *
+ * @warning This method asserts that @p a and
+ * @p b are in balanced ternary.
+ *
+ * @param[in] a The first 32 trit balanced ternary factor.
+ *
+ * @param[in] b The second 32 trit balanced ternary factor.
+ *
+ * @return The 64 trit product of @p a and @p b
+ */
+trit64_t trit_mul_wide_trit32_t(trit32_t a, trit32_t b){
+
+    const int64_t radix = 43046721; // 3^16
+    int64_t a_low = trits_value(a & 0xFFFFFFFFULL, 4);
+    int64_t a_high = trits_value(a >> 32, 4);
+    int64_t b_low = trits_value(b & 0xFFFFFFFFULL, 4);
+    int64_t b_high = trits_value(b >> 32, 4);
+    int64_t limbs[3] = {a_low * b_low, a_low * b_high + a_high * b_low, a_high * b_high};
+    uint64_t parts[4];
+    uint64_t words[2];
+    int64_t carry = 0;
+    int64_t digit = 0;
+    int index = 0;
+
+    for(index = 0; index < 3; index++){
+
+        limbs[index] += carry;
+        digit = balanced_digit(limbs[index], radix);
+        carry = (limbs[index] - digit) / radix;
+        parts[index] = value_trits(digit, 4);
+    }
+
+    parts[3] = value_trits(carry, 4);
+    words[0] = parts[0] | (parts[1] << 32);
+    words[1] = parts[2] | (parts[3] << 32);
+
+    return join_trit64_t(words);
+}
+
+/**
+ * @brief Multiplies two @c trit64_t numbers into a @c trit128_t.
+ *
+ * Works like @c trit_mul_wide_trit32_t with four 16 trit limbs
+ * per factor, the column sums of the partial products stay well
+ * inside 64 bits.
+ *
+ * @warning This method asserts that @p a and
+ * @p b are in balanced ternary.
+ *
+ * @param[in] a The first 64 trit balanced ternary factor.
+ *
+ * @param[in] b The second 64 trit balanced ternary factor.
+ *
+ * @return The 128 trit product of @p a and @p b
+ */
+trit128_t trit_mul_wide_trit64_t(trit64_t a, trit64_t b){
+
+    const int64_t radix = 43046721; // 3^16
+    int64_t a_limbs[4];
+    int64_t b_limbs[4];
+    int64_t limbs[7] = {0};
+    uint64_t parts[8];
+    uint64_t words[4];
+    int64_t carry = 0;
+    int64_t digit = 0;
+    int index = 0;
+    int other = 0;
+
+    for(index = 0; index < 4; index++){
+
+        a_limbs[index] = trits_value((uint64_t)(a >> (32 * index)) & 0xFFFFFFFFULL, 4);
+        b_limbs[index] = trits_value((uint64_t)(b >> (32 * index)) & 0xFFFFFFFFULL, 4);
+    }
+
+    for(index = 0; index < 4; index++){
+
+        for(other = 0; other < 4; other++){
+
+            limbs[index + other] += a_limbs[index] * b_limbs[other];
+        }
+    }
+
+    for(index = 0; index < 7; index++){
+
+        limbs[index] += carry;
+        digit = balanced_digit(limbs[index], radix);
+        carry = (limbs[index] - digit) / radix;
+        parts[index] = value_trits(digit, 4);
+    }
+
+    parts[7] = value_trits(carry, 4);
+
+    for(index = 0; index < 4; index++){
+
+        words[index] = parts[2 * index] | (parts[2 * index + 1] << 32);
+    }
+
+    return join_trit128_t(words);
+}
+
+/**
+ * @brief Multiplies two @c trit8_t numbers.
+ *
+ * Overflow is reported through @p overflow only,
+ * so the method has no side effects.
+ *
+ * @warning This method asserts that @p a and
+ * @p b are in balanced ternary.
+ *
+ * @param[in] a The first 8 trit balanced ternary factor.
+ *
+ * @param[in] b The second 8 trit balanced ternary factor.
+ *
+ * @param[out] overflow Set to true if the product
+ * does not fit in 8 trits, false otherwise
+ *
+ * @return The low 8 trits of the product of @p a and @p b
+ */
+trit8_t trit_mul_checked_trit8_t(trit8_t a, trit8_t b, bool *overflow){
+
+    return trit_narrow_checked_trit16_t_to_trit8_t(trit_mul_wide_trit8_t(a, b), overflow);
+}
+
+/**
+ * @brief Multiplies two @c trit8_t numbers.
+ *
+ * @see trit_mul_checked_trit8_t
+ *
+ * @note If an overflow error occurs errno variable
+ * is set to EOVERFLOW
+ *
+ * @param[in] a The first 8 trit balanced ternary factor.
+ *
+ * @param[in] b The second 8 trit balanced ternary factor.
+ *
+ * @return The low 8 trits of the product of @p a and @p b
+ */
+trit8_t trit_mul_trit8_t(trit8_t a, trit8_t b){
+
+    bool overflow = false;
+    trit8_t result = trit_mul_checked_trit8_t(a, b, &overflow);
+
+    if(overflow){
+
+        errno = EOVERFLOW;
+    }
+
+    return result;
+}
+
+/**
+ * @brief Multiplies two @c trit16_t numbers.
+ *
+ * Overflow is reported through @p overflow only,
+ * so the method has no side effects.
+ *
+ * @warning This method asserts that @p a and
+ * @p b are in balanced ternary.
+ *
+ * @param[in] a The first 16 trit balanced ternary factor.
+ *
+ * @param[in] b The second 16 trit balanced ternary factor.
+ *
+ * @param[out] overflow Set to true if the product
+ * does not fit in 16 trits, false otherwise
+ *
+ * @return The low 16 trits of the product of @p a and @p b
+ */
+trit16_t trit_mul_checked_trit16_t(trit16_t a, trit16_t b, bool *overflow){
+
+    return trit_narrow_checked_trit32_t_to_trit16_t(trit_mul_wide_trit16_t(a, b), overflow);
+}
+
+/**
+ * @brief Multiplies two @c trit16_t numbers.
+ *
+ * @see trit_mul_checked_trit16_t
+ *
+ * @note If an overflow error occurs errno variable
+ * is set to EOVERFLOW
+ *
+ * @param[in] a The first 16 trit balanced ternary factor.
+ *
+ * @param[in] b The second 16 trit balanced ternary factor.
+ *
+ * @return The low 16 trits of the product of @p a and @p b
+ */
+trit16_t trit_mul_trit16_t(trit16_t a, trit16_t b){
+
+    bool overflow = false;
+    trit16_t result = trit_mul_checked_trit16_t(a, b, &overflow);
+
+    if(overflow){
+
+        errno = EOVERFLOW;
+    }
+
+    return result;
+}
+
+/**
+ * @brief Multiplies two @c trit32_t numbers.
+ *
+ * Overflow is reported through @p overflow only,
+ * so the method has no side effects.
+ *
+ * @warning This method asserts that @p a and
+ * @p b are in balanced ternary.
+ *
+ * @param[in] a The first 32 trit balanced ternary factor.
+ *
+ * @param[in] b The second 32 trit balanced ternary factor.
+ *
+ * @param[out] overflow Set to true if the product
+ * does not fit in 32 trits, false otherwise
+ *
+ * @return The low 32 trits of the product of @p a and @p b
+ */
+trit32_t trit_mul_checked_trit32_t(trit32_t a, trit32_t b, bool *overflow){
+
+    return trit_narrow_checked_trit64_t_to_trit32_t(trit_mul_wide_trit32_t(a, b), overflow);
+}
+
+/**
+ * @brief Multiplies two @c trit32_t numbers.
+ *
+ * @see trit_mul_checked_trit32_t
+ *
+ * @note If an overflow error occurs errno variable
+ * is set to EOVERFLOW
+ *
+ * @param[in] a The first 32 trit balanced ternary factor.
+ *
+ * @param[in] b The second 32 trit balanced ternary factor.
+ *
+ * @return The low 32 trits of the product of @p a and @p b
+ */
+trit32_t trit_mul_trit32_t(trit32_t a, trit32_t b){
+
+    bool overflow = false;
+    trit32_t result = trit_mul_checked_trit32_t(a, b, &overflow);
+
+    if(overflow){
+
+        errno = EOVERFLOW;
+    }
+
+    return result;
+}
+
+/**
+ * @brief Multiplies two numbers given as 16 trit limbs, keeping the low limbs.
+ *
+ * Only the columns of the product below @p count limbs are
+ * summed, their balanced carries are passed up and the carry
+ * out of the top column is dropped.
+ *
+ * @param[in] a The limb values of the first factor, lowest first.
+ *
+ * @param[in] b The limb values of the second factor, lowest first.
+ *
+ * @param[in] count The number of limbs, even and at most 8.
+ *
+ * @param[out] words The low @p count limbs of the product as
+ * 32 trit words, lowest first.
+ */
+static void mul_low_limbs(const int64_t *a, const int64_t *b, int count, uint64_t *words){
+
+    const int64_t radix = 43046721; // 3^16
+    uint64_t parts[8];
+    int64_t column = 0;
+    int64_t carry = 0;
+    int64_t digit = 0;
+    int index = 0;
+    int other = 0;
+
+    for(index = 0; index < count; index++){
+
+        column = carry;
+
+        for(other = 0; other <= index; other++){
+
+            column += a[other] * b[index - other];
+        }
+
+        digit = balanced_digit(column, radix);
+        carry = (column - digit) / radix;
+        parts[index] = value_trits(digit, 4);
+    }
+
+    for(index = 0; index < count / 2; index++){
+
+        words[index] = parts[2 * index] | (parts[2 * index + 1] << 32);
+    }
+}
+
+/**
+ * @brief Splits 32 trit words into their 16 trit limb values.
+ *
+ * @param[in] words The balanced ternary words, lowest first.
+ *
+ * @param[in] count The number of words.
+ *
+ * @param[out] limbs The binary value of every 16 trit half,
+ * 2 * @p count of them.
+ */
+static void word_limbs(const uint64_t *words, int count, int64_t *limbs){
+
+    int index = 0;
+
+    for(index = 0; index < count; index++){
+
+        limbs[2 * index] = trits_value(words[index] & 0xFFFFFFFFULL, 4);
+        limbs[2 * index + 1] = trits_value(words[index] >> 32, 4);
+    }
+}
+
+/**
+ * @brief Adds two @c trit8_t numbers mod 3^8.
+ *
+ * The carry out of the top trit is dropped without
+ * being checked and errno is never set.
+ *
+ * @warning This method asserts that @p a and
+ * @p b are in balanced ternary.
+ *
+ * @param[in] a The first 8 trit balanced ternary value.
+ *
+ * @param[in] b The second 8 trit balanced ternary value.
+ *
+ * @return The low 8 trits of @p a + @p b
+ */
+trit8_t trit_add_wrap_trit8_t(trit8_t a, trit8_t b){
+
+    int carry = 0;
+
+    return (trit8_t)add_trits(a, b, 8, 0, &carry);
+}
+
+/**
+ * @brief Adds two @c trit16_t numbers mod 3^16.
+ *
+ * @see trit_add_wrap_trit8_t
+ *
+ * @param[in] a The first 16 trit balanced ternary value.
+ *
+ * @param[in] b The second 16 trit balanced ternary value.
+ *
+ * @return The low 16 trits of @p a + @p b
+ */
+trit16_t trit_add_wrap_trit16_t(trit16_t a, trit16_t b){
+
+    int carry = 0;
+
+    return (trit16_t)add_trits(a, b, 16, 0, &carry);
+}
+
+/**
+ * @brief Adds two @c trit32_t numbers mod 3^32.
+ *
+ * @see trit_add_wrap_trit8_t
+ *
+ * @param[in] a The first 32 trit balanced ternary value.
+ *
+ * @param[in] b The second 32 trit balanced ternary value.
+ *
+ * @return The low 32 trits of @p a + @p b
+ */
+trit32_t trit_add_wrap_trit32_t(trit32_t a, trit32_t b){
+
+    int carry = 0;
+
+    return add_trits(a, b, 32, 0, &carry);
+}
+
+/**
+ * @brief Adds two @c trit64_t numbers mod 3^64.
+ *
+ * @see trit_add_wrap_trit8_t
+ *
+ * @param[in] a The first 64 trit balanced ternary value.
+ *
+ * @param[in] b The second 64 trit balanced ternary value.
+ *
+ * @return The low 64 trits of @p a + @p b
+ */
+trit64_t trit_add_wrap_trit64_t(trit64_t a, trit64_t b){
+
+    int carry = 0;
+
+    return add_trit64(a, b, 0, &carry);
+}
+
+/**
+ * @brief Adds two @c trit128_t numbers mod 3^128.
+ *
+ * @see trit_add_wrap_trit8_t
+ *
+ * @param[in] a The first 128 trit balanced ternary value.
+ *
+ * @param[in] b The second 128 trit balanced ternary value.
+ *
+ * @return The low 128 trits of @p a + @p b
+ */
+trit128_t trit_add_wrap_trit128_t(trit128_t a, trit128_t b){
+
+    trit128_t result;
+    int carry = 0;
+
+    result.low = add_trit64(a.low, b.low, 0, &carry);
+    result.high = add_trit64(a.high, b.high, carry, &carry);
+
+    return result;
+}
+
+/**
+ * @brief Subtracts two @c trit8_t numbers mod 3^8.
+ *
+ * @see trit_add_wrap_trit8_t
+ *
+ * @param[in] a The 8 trit value to subtract from.
+ *
+ * @param[in] b The 8 trit value to subtract.
+ *
+ * @return The low 8 trits of @p a - @p b
+ */
+trit8_t trit_sub_wrap_trit8_t(trit8_t a, trit8_t b){
+
+    return trit_add_wrap_trit8_t(a, trit_not_trit8_t(b));
+}
+
+/**
+ * @brief Subtracts two @c trit16_t numbers mod 3^16.
+ *
+ * @see trit_add_wrap_trit8_t
+ *
+ * @param[in] a The 16 trit value to subtract from.
+ *
+ * @param[in] b The 16 trit value to subtract.
+ *
+ * @return The low 16 trits of @p a - @p b
+ */
+trit16_t trit_sub_wrap_trit16_t(trit16_t a, trit16_t b){
+
+    return trit_add_wrap_trit16_t(a, trit_not_trit16_t(b));
+}
+
+/**
+ * @brief Subtracts two @c trit32_t numbers mod 3^32.
+ *
+ * @see trit_add_wrap_trit8_t
+ *
+ * @param[in] a The 32 trit value to subtract from.
+ *
+ * @param[in] b The 32 trit value to subtract.
+ *
+ * @return The low 32 trits of @p a - @p b
+ */
+trit32_t trit_sub_wrap_trit32_t(trit32_t a, trit32_t b){
+
+    return trit_add_wrap_trit32_t(a, trit_not_trit32_t(b));
+}
+
+/**
+ * @brief Subtracts two @c trit64_t numbers mod 3^64.
+ *
+ * @see trit_add_wrap_trit8_t
+ *
+ * @param[in] a The 64 trit value to subtract from.
+ *
+ * @param[in] b The 64 trit value to subtract.
+ *
+ * @return The low 64 trits of @p a - @p b
+ */
+trit64_t trit_sub_wrap_trit64_t(trit64_t a, trit64_t b){
+
+    return trit_add_wrap_trit64_t(a, trit_not_trit64_t(b));
+}
+
+/**
+ * @brief Subtracts two @c trit128_t numbers mod 3^128.
+ *
+ * @see trit_add_wrap_trit8_t
+ *
+ * @param[in] a The 128 trit value to subtract from.
+ *
+ * @param[in] b The 128 trit value to subtract.
+ *
+ * @return The low 128 trits of @p a - @p b
+ */
+trit128_t trit_sub_wrap_trit128_t(trit128_t a, trit128_t b){
+
+    return trit_add_wrap_trit128_t(a, trit_not_trit128_t(b));
+}
+
+/**
+ * @brief Multiplies two @c trit8_t numbers mod 3^8.
+ *
+ * The high trits of the product are dropped without
+ * being checked and errno is never set.
+ *
+ * @warning This method asserts that @p a and
+ * @p b are in balanced ternary.
+ *
+ * @param[in] a The first 8 trit balanced ternary factor.
+ *
+ * @param[in] b The second 8 trit balanced ternary factor.
+ *
+ * @return The low 8 trits of the product of @p a and @p b
+ */
+trit8_t trit_mul_wrap_trit8_t(trit8_t a, trit8_t b){
+
+    return (trit8_t)trit_mul_wide_trit8_t(a, b);
+}
+
+/**
+ * @brief Multiplies two @c trit16_t numbers mod 3^16.
+ *
+ * @see trit_mul_wrap_trit8_t
+ *
+ * @param[in] a The first 16 trit balanced ternary factor.
+ *
+ * @param[in] b The second 16 trit balanced ternary factor.
+ *
+ * @return The low 16 trits of the product of @p a and @p b
+ */
+trit16_t trit_mul_wrap_trit16_t(trit16_t a, trit16_t b){
+
+    return (trit16_t)trit_mul_wide_trit16_t(a, b);
+}
+
+/**
+ * @brief Multiplies two @c trit32_t numbers mod 3^32.
+ *
+ * Only the low two 16 trit limbs of the product are formed,
+ * which skips the high partial product and half of the
+ * conversions back to trits.
+ *
+ * @see trit_mul_wrap_trit8_t
+ *
+ * @param[in] a The first 32 trit balanced ternary factor.
+ *
+ * @param[in] b The second 32 trit balanced ternary factor.
+ *
+ * @return The low 32 trits of the product of @p a and @p b
+ */
+trit32_t trit_mul_wrap_trit32_t(trit32_t a, trit32_t b){
+
+    int64_t a_limbs[2];
+    int64_t b_limbs[2];
+    uint64_t result = 0;
+
+    word_limbs(&a, 1, a_limbs);
+    word_limbs(&b, 1, b_limbs);
+    mul_low_limbs(a_limbs, b_limbs, 2, &result);
+
+    return result;
+}
+
+/**
+ * @brief Multiplies two @c trit64_t numbers mod 3^64.
+ *
+ * @see trit_mul_wrap_trit32_t
+ *
+ * @param[in] a The first 64 trit balanced ternary factor.
+ *
+ * @param[in] b The second 64 trit balanced ternary factor.
+ *
+ * @return The low 64 trits of the product of @p a and @p b
+ */
+trit64_t trit_mul_wrap_trit64_t(trit64_t a, trit64_t b){
+
+    uint64_t words_a[2];
+    uint64_t words_b[2];
+    int64_t a_limbs[4];
+    int64_t b_limbs[4];
+
+    split_trit64_t(a, words_a);
+    split_trit64_t(b, words_b);
+    word_limbs(words_a, 2, a_limbs);
+    word_limbs(words_b, 2, b_limbs);
+    mul_low_limbs(a_limbs, b_limbs, 4, words_a);
+
+    return join_trit64_t(words_a);
+}
+
+/**
+ * @brief Multiplies two @c trit128_t numbers mod 3^128.
+ *
+ * @see trit_mul_wrap_trit32_t
+ *
+ * @param[in] a The first 128 trit balanced ternary factor.
+ *
+ * @param[in] b The second 128 trit balanced ternary factor.
+ *
+ * @return The low 128 trits of the product of @p a and @p b
+ */
+trit128_t trit_mul_wrap_trit128_t(trit128_t a, trit128_t b){
+
+    uint64_t words_a[4];
+    uint64_t words_b[4];
+    int64_t a_limbs[8];
+    int64_t b_limbs[8];
+
+    split_trit128_t(a, words_a);
+    split_trit128_t(b, words_b);
+    word_limbs(words_a, 4, a_limbs);
+    word_limbs(words_b, 4, b_limbs);
+    mul_low_limbs(a_limbs, b_limbs, 8, words_a);
+
+    return join_trit128_t(words_a);
+}
+
+/**
+ * @brief Clamps a sum to the range of @p trits trits from its final carry.
+ *
+ * A carry of +1 selects the all-(+1) word and a carry of -1
+ * the all-(-1) word, the masks come from the carry so there is
+ * no branch.
+ *
+ * @param[in] result The low @p trits trits of the sum.
+ *
+ * @param[in] carry The carry out of the top trit, -1, 0 or 1.
+ *
+ * @param[in] trits The width of the sum, 8, 16 or 32.
+ *
+ * @return The saturated sum
+ */
+static uint64_t saturate_carry(uint64_t result, int carry, int trits){
+
+    uint64_t width = trit_width(trits);
+    uint64_t over = 0 - (uint64_t)(carry > 0);
+    uint64_t under = 0 - (uint64_t)(carry < 0);
+
+    return (result & ~(over | under)) | (width & over) | ((width | (width << 1)) & under);
+}
+
+/**
+ * @brief Clamps a double width product to the range of @p trits trits.
+ *
+ * The product fits when its high trits are all 0, otherwise
+ * its sign is the sign of the highest nonzero trit, whose code
+ * has its high bit set only for -1.
+ *
+ * @param[in] low The low @p trits trits of the product.
+ *
+ * @param[in] high The high @p trits trits of the product.
+ *
+ * @param[in] trits The width of the result, 8, 16 or 32.
+ *
+ * @return The saturated product
+ */
+static uint64_t saturate_wide(uint64_t low, uint64_t high, int trits){
+
+    uint64_t width = trit_width(trits);
+    uint64_t outside = 0 - (uint64_t)(high != 0);
+    uint64_t negative = 0 - (uint64_t)((63 - __builtin_clzll(high | 1)) & 1);
+
+    return (low & ~outside) | (width & outside & ~negative) | ((width | (width << 1)) & outside & negative);
+}
+
+/**
+ * @brief Adds two @c trit8_t numbers, clamping to the @c trit8_t range.
+ *
+ * A sum above (3^8 - 1) / 2 gives every trit +1 and a sum
+ * below -(3^8 - 1) / 2 gives every trit -1, errno is never set.
+ *
+ * @warning This method asserts that @p a and
+ * @p b are in balanced ternary.
+ *
+ * @param[in] a The first 8 trit balanced ternary value.
+ *
+ * @param[in] b The second 8 trit balanced ternary value.
+ *
+ * @return @p a + @p b clamped to 8 trits
+ */
+trit8_t trit_add_sat_trit8_t(trit8_t a, trit8_t b){
+
+    int carry = 0;
+    uint64_t result = add_trits(a, b, 8, 0, &carry);
+
+    return (trit8_t)saturate_carry(result, carry, 8);
+}
+
+/**
+ * @brief Adds two @c trit16_t numbers, clamping to the @c trit16_t range.
+ *
+ * @see trit_add_sat_trit8_t
+ *
+ * @param[in] a The first 16 trit balanced ternary value.
+ *
+ * @param[in] b The second 16 trit balanced ternary value.
+ *
+ * @return @p a + @p b clamped to 16 trits
+ */
+trit16_t trit_add_sat_trit16_t(trit16_t a, trit16_t b){
+
+    int carry = 0;
+    uint64_t result = add_trits(a, b, 16, 0, &carry);
+
+    return (trit16_t)saturate_carry(result, carry, 16);
+}
+
+/**
+ * @brief Adds two @c trit32_t numbers, clamping to the @c trit32_t range.
+ *
+ * @see trit_add_sat_trit8_t
+ *
+ * @param[in] a The first 32 trit balanced ternary value.
+ *
+ * @param[in] b The second 32 trit balanced ternary value.
+ *
+ * @return @p a + @p b clamped to 32 trits
+ */
+trit32_t trit_add_sat_trit32_t(trit32_t a, trit32_t b){
+
+    int carry = 0;
+    uint64_t result = add_trits(a, b, 32, 0, &carry);
+
+    return saturate_carry(result, carry, 32);
+}
+
+/**
+ * @brief Subtracts two @c trit8_t numbers, clamping to the @c trit8_t range.
+ *
+ * @see trit_add_sat_trit8_t
+ *
+ * @param[in] a The 8 trit value to subtract from.
+ *
+ * @param[in] b The 8 trit value to subtract.
+ *
+ * @return @p a - @p b clamped to 8 trits
+ */
+trit8_t trit_sub_sat_trit8_t(trit8_t a, trit8_t b){
+
+    return trit_add_sat_trit8_t(a, trit_not_trit8_t(b));
+}
+
+/**
+ * @brief Subtracts two @c trit16_t numbers, clamping to the @c trit16_t range.
+ *
+ * @see trit_add_sat_trit8_t
+ *
+ * @param[in] a The 16 trit value to subtract from.
+ *
+ * @param[in] b The 16 trit value to subtract.
+ *
+ * @return @p a - @p b clamped to 16 trits
+ */
+trit16_t trit_sub_sat_trit16_t(trit16_t a, trit16_t b){
+
+    return trit_add_sat_trit16_t(a, trit_not_trit16_t(b));
+}
+
+/**
+ * @brief Subtracts two @c trit32_t numbers, clamping to the @c trit32_t range.
+ *
+ * @see trit_add_sat_trit8_t
+ *
+ * @param[in] a The 32 trit value to subtract from.
+ *
+ * @param[in] b The 32 trit value to subtract.
+ *
+ * @return @p a - @p b clamped to 32 trits
+ */
+trit32_t trit_sub_sat_trit32_t(trit32_t a, trit32_t b){
+
+    return trit_add_sat_trit32_t(a, trit_not_trit32_t(b));
+}
+
+/**
+ * @brief Multiplies two @c trit8_t numbers, clamping to the @c trit8_t range.
+ *
+ * @see trit_add_sat_trit8_t
+ *
+ * @param[in] a The first 8 trit balanced ternary factor.
+ *
+ * @param[in] b The second 8 trit balanced ternary factor.
+ *
+ * @return The product of @p a and @p b clamped to 8 trits
+ */
+trit8_t trit_mul_sat_trit8_t(trit8_t a, trit8_t b){
+
+    trit16_t product = trit_mul_wide_trit8_t(a, b);
+
+    return (trit8_t)saturate_wide(product & 0xFFFF, product >> 16, 8);
+}
+
+/**
+ * @brief Multiplies two @c trit16_t numbers, clamping to the @c trit16_t range.
+ *
+ * @see trit_add_sat_trit8_t
+ *
+ * @param[in] a The first 16 trit balanced ternary factor.
+ *
+ * @param[in] b The second 16 trit balanced ternary factor.
+ *
+ * @return The product of @p a and @p b clamped to 16 trits
+ */
+trit16_t trit_mul_sat_trit16_t(trit16_t a, trit16_t b){
+
+    trit32_t product = trit_mul_wide_trit16_t(a, b);
+
+    return (trit16_t)saturate_wide(product & 0xFFFFFFFFULL, product >> 32, 16);
+}
+
+/**
+ * @brief Multiplies two @c trit32_t numbers, clamping to the @c trit32_t range.
+ *
+ * @see trit_add_sat_trit8_t
+ *
+ * @param[in] a The first 32 trit balanced ternary factor.
+ *
+ * @param[in] b The second 32 trit balanced ternary factor.
+ *
+ * @return The product of @p a and @p b clamped to 32 trits
+ */
+trit32_t trit_mul_sat_trit32_t(trit32_t a, trit32_t b){
+
+    trit64_t product = trit_mul_wide_trit32_t(a, b);
+
+    return saturate_wide((uint64_t)product, (uint64_t)(product >> 64), 32);
+}
+
+/**
+ * @brief Adds two @c trit8_t numbers and a carry.
+ *
+ * The carry out is returned rather than reported as an error,
+ * so words can be chained into wider numbers, the carry out
+ * of one word is the carry into the next. Every carry is -1,
+ * 0 or 1 and a + b + carry_in equals the result plus
+ * carry_out times 3^8.
+ *
+ * @warning This method asserts that @p a and @p b are in
+ * balanced ternary and that @p carry_in is -1, 0 or 1.
+ *
+ * @param[in] a The first 8 trit balanced ternary value.
+ *
+ * @param[in] b The second 8 trit balanced ternary value.
+ *
+ * @param[in] carry_in The carry into trit 0.
+ *
+ * @param[out] carry_out The carry out of trit 7.
+ *
+ * @return The low 8 trits of @p a + @p b + @p carry_in
+ */
+trit8_t trit_adc_trit8_t(trit8_t a, trit8_t b, int carry_in, int *carry_out){
+
+    assert(carry_in >= -1 && carry_in <= 1);
+
+    return (trit8_t)add_trits(a, b, 8, carry_in, carry_out);
+}
+
+/**
+ * @brief Adds two @c trit16_t numbers and a carry.
+ *
+ * @see trit_adc_trit8_t
+ *
+ * @param[in] a The first 16 trit balanced ternary value.
+ *
+ * @param[in] b The second 16 trit balanced ternary value.
+ *
+ * @param[in] carry_in The carry into trit 0, -1, 0 or 1.
+ *
+ * @param[out] carry_out The carry out of trit 15, -1, 0 or 1.
+ *
+ * @return The low 16 trits of @p a + @p b + @p carry_in
+ */
+trit16_t trit_adc_trit16_t(trit16_t a, trit16_t b, int carry_in, int *carry_out){
+
+    assert(carry_in >= -1 && carry_in <= 1);
+
+    return (trit16_t)add_trits(a, b, 16, carry_in, carry_out);
+}
+
+/**
+ * @brief Adds two @c trit32_t numbers and a carry.
+ *
+ * @see trit_adc_trit8_t
+ *
+ * @param[in] a The first 32 trit balanced ternary value.
+ *
+ * @param[in] b The second 32 trit balanced ternary value.
+ *
+ * @param[in] carry_in The carry into trit 0, -1, 0 or 1.
+ *
+ * @param[out] carry_out The carry out of trit 31, -1, 0 or 1.
+ *
+ * @return The low 32 trits of @p a + @p b + @p carry_in
+ */
+trit32_t trit_adc_trit32_t(trit32_t a, trit32_t b, int carry_in, int *carry_out){
+
+    assert(carry_in >= -1 && carry_in <= 1);
+
+    return add_trits(a, b, 32, carry_in, carry_out);
+}
+
+/**
+ * @brief Adds two @c trit64_t numbers and a carry.
+ *
+ * @see trit_adc_trit8_t
+ *
+ * @param[in] a The first 64 trit balanced ternary value.
+ *
+ * @param[in] b The second 64 trit balanced ternary value.
+ *
+ * @param[in] carry_in The carry into trit 0, -1, 0 or 1.
+ *
+ * @param[out] carry_out The carry out of trit 63, -1, 0 or 1.
+ *
+ * @return The low 64 trits of @p a + @p b + @p carry_in
+ */
+trit64_t trit_adc_trit64_t(trit64_t a, trit64_t b, int carry_in, int *carry_out){
+
+    assert(carry_in >= -1 && carry_in <= 1);
+
+    return add_trit64(a, b, carry_in, carry_out);
+}
+
+/**
+ * @brief Adds two @c trit128_t numbers and a carry.
+ *
+ * @see trit_adc_trit8_t
+ *
+ * @param[in] a The first 128 trit balanced ternary value.
+ *
+ * @param[in] b The second 128 trit balanced ternary value.
+ *
+ * @param[in] carry_in The carry into trit 0, -1, 0 or 1.
+ *
+ * @param[out] carry_out The carry out of trit 127, -1, 0 or 1.
+ *
+ * @return The low 128 trits of @p a + @p b + @p carry_in
+ */
+trit128_t trit_adc_trit128_t(trit128_t a, trit128_t b, int carry_in, int *carry_out){
+
+    trit128_t result;
+    int carry = 0;
+
+    assert(carry_in >= -1 && carry_in <= 1);
+
+    result.low = add_trit64(a.low, b.low, carry_in, &carry);
+    result.high = add_trit64(a.high, b.high, carry, carry_out);
+
+    return result;
+}
+
+/**
+ * @brief Subtracts a @c trit8_t number and a borrow from another.
+ *
+ * The borrow is the carry of @c trit_adc_trit8_t negated, so
+ * a - b - borrow_in equals the result minus borrow_out times
+ * 3^8. Chaining words feeds the borrow out of one word into
+ * the next.
+ *
+ * @warning This method asserts that @p a and @p b are in
+ * balanced ternary and that @p borrow_in is -1, 0 or 1.
+ *
+ * @param[in] a The 8 trit value to subtract from.
+ *
+ * @param[in] b The 8 trit value to subtract.
+ *
+ * @param[in] borrow_in The borrow from trit 0.
+ *
+ * @param[out] borrow_out The borrow from the trit above trit 7.
+ *
+ * @return The low 8 trits of @p a - @p b - @p borrow_in
+ */
+trit8_t trit_sbb_trit8_t(trit8_t a, trit8_t b, int borrow_in, int *borrow_out){
+
+    int carry = 0;
+    trit8_t result = trit_adc_trit8_t(a, trit_not_trit8_t(b), -borrow_in, &carry);
+
+    *borrow_out = -carry;
+
+    return result;
+}
+
+/**
+ * @brief Subtracts a @c trit16_t number and a borrow from another.
+ *
+ * @see trit_sbb_trit8_t
+ *
+ * @param[in] a The 16 trit value to subtract from.
+ *
+ * @param[in] b The 16 trit value to subtract.
+ *
+ * @param[in] borrow_in The borrow from trit 0, -1, 0 or 1.
+ *
+ * @param[out] borrow_out The borrow from the trit above trit 15, -1, 0 or 1.
+ *
+ * @return The low 16 trits of @p a - @p b - @p borrow_in
+ */
+trit16_t trit_sbb_trit16_t(trit16_t a, trit16_t b, int borrow_in, int *borrow_out){
+
+    int carry = 0;
+    trit16_t result = trit_adc_trit16_t(a, trit_not_trit16_t(b), -borrow_in, &carry);
+
+    *borrow_out = -carry;
+
+    return result;
+}
+
+/**
+ * @brief Subtracts a @c trit32_t number and a borrow from another.
+ *
+ * @see trit_sbb_trit8_t
+ *
+ * @param[in] a The 32 trit value to subtract from.
+ *
+ * @param[in] b The 32 trit value to subtract.
+ *
+ * @param[in] borrow_in The borrow from trit 0, -1, 0 or 1.
+ *
+ * @param[out] borrow_out The borrow from the trit above trit 31, -1, 0 or 1.
+ *
+ * @return The low 32 trits of @p a - @p b - @p borrow_in
+ */
+trit32_t trit_sbb_trit32_t(trit32_t a, trit32_t b, int borrow_in, int *borrow_out){
+
+    int carry = 0;
+    trit32_t result = trit_adc_trit32_t(a, trit_not_trit32_t(b), -borrow_in, &carry);
+
+    *borrow_out = -carry;
+
+    return result;
+}
+
+/**
+ * @brief Subtracts a @c trit64_t number and a borrow from another.
+ *
+ * @see trit_sbb_trit8_t
+ *
+ * @param[in] a The 64 trit value to subtract from.
+ *
+ * @param[in] b The 64 trit value to subtract.
+ *
+ * @param[in] borrow_in The borrow from trit 0, -1, 0 or 1.
+ *
+ * @param[out] borrow_out The borrow from the trit above trit 63, -1, 0 or 1.
+ *
+ * @return The low 64 trits of @p a - @p b - @p borrow_in
+ */
+trit64_t trit_sbb_trit64_t(trit64_t a, trit64_t b, int borrow_in, int *borrow_out){
+
+    int carry = 0;
+    trit64_t result = trit_adc_trit64_t(a, trit_not_trit64_t(b), -borrow_in, &carry);
+
+    *borrow_out = -carry;
+
+    return result;
+}
+
+/**
+ * @brief Subtracts a @c trit128_t number and a borrow from another.
+ *
+ * @see trit_sbb_trit8_t
+ *
+ * @param[in] a The 128 trit value to subtract from.
+ *
+ * @param[in] b The 128 trit value to subtract.
+ *
+ * @param[in] borrow_in The borrow from trit 0, -1, 0 or 1.
+ *
+ * @param[out] borrow_out The borrow from the trit above trit 127, -1, 0 or 1.
+ *
+ * @return The low 128 trits of @p a - @p b - @p borrow_in
+ */
+trit128_t trit_sbb_trit128_t(trit128_t a, trit128_t b, int borrow_in, int *borrow_out){
+
+    int carry = 0;
+    trit128_t result = trit_adc_trit128_t(a, trit_not_trit128_t(b), -borrow_in, &carry);
+
+    *borrow_out = -carry;
+
+    return result;
+}
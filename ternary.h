@@ -1,6 +1,7 @@
 #ifndef __ternary_h__
 #define __ternary_h__
 
+#include<stddef.h>
 #include<stdint.h>
 #include<stdio.h>
 #include<stdbool.h>
@@ -11,6 +12,16 @@
 #define trit8_t uint16_t
 #define trit16_t uint32_t
 #define trit32_t uint64_t
+#define trit64_t __uint128_t
+
+/**
+ * @brief A 128 trit number, trit 0 is the low trit of @c low.
+ */
+typedef struct {
+
+    trit64_t low;  /**< Trits 0 to 63 */
+    trit64_t high; /**< Trits 64 to 127 */
+} trit128_t;
 
 
 //UTILITY
@@ -22,70 +33,221 @@ uint64_t raised_to(uint64_t base, uint64_t exponent);
 trit8_t binary_to_unbalanced_ternary_trit8_t(uint16_t num);
 trit16_t binary_to_unbalanced_ternary_trit16_t(uint32_t num);
 trit32_t binary_to_unbalanced_ternary_trit32_t(uint64_t num);
+trit64_t binary_to_unbalanced_ternary_trit64_t(__uint128_t num);
+trit128_t binary_to_unbalanced_ternary_trit128_t(__uint128_t num);
 
 // BINARY TO BALANCED TERNARY
 trit8_t binary_to_balanced_ternary_trit8_t(uint16_t num);
 trit16_t binary_to_balanced_ternary_trit16_t(uint32_t num);
 trit32_t binary_to_balanced_ternary_trit32_t(uint64_t num);
+trit64_t binary_to_balanced_ternary_trit64_t(__int128 num);
+trit128_t binary_to_balanced_ternary_trit128_t(__int128 num);
 
 // UNBALANCED TERNARY TO BALANCED TERNARY
 trit8_t unbalanced_ternary_to_balanced_ternary_trit8_t(trit8_t num);
 trit16_t unbalanced_ternary_to_balanced_ternary_trit16_t(trit16_t num);
 trit32_t unbalanced_ternary_to_balanced_ternary_trit32_t(trit32_t num);
+trit64_t unbalanced_ternary_to_balanced_ternary_trit64_t(trit64_t num);
+trit128_t unbalanced_ternary_to_balanced_ternary_trit128_t(trit128_t num);
 
 // UNBALANCED TERNARY TO BINARY
 uint16_t unbalanced_ternary_to_binary_uint16_t(trit8_t num);
 uint32_t unbalanced_ternary_to_binary_uint32_t(trit16_t num);
 uint64_t unbalanced_ternary_to_binary_uint64_t(trit32_t num);
+__uint128_t unbalanced_ternary_to_binary_uint128_t(trit64_t num);
+__uint128_t unbalanced_ternary_to_binary_checked_uint128_t(trit128_t num, bool *overflow);
 
 // BALANCED TERNARY TO UNBALANCED TERNARY
 trit8_t balanced_ternary_to_unbalanced_ternary_trit8_t(trit8_t num);
 trit16_t balanced_ternary_to_unbalanced_ternary_trit16_t(trit16_t num);
 trit32_t balanced_ternary_to_unbalanced_ternary_trit32_t(trit32_t num);
+trit64_t balanced_ternary_to_unbalanced_ternary_trit64_t(trit64_t num);
+trit128_t balanced_ternary_to_unbalanced_ternary_trit128_t(trit128_t num);
 
 // BALANCED TERNARY TO BINARY
 int16_t balanced_ternary_to_binary_int16_t(trit8_t num);
 int32_t balanced_ternary_to_binary_int32_t(trit16_t num);
 int64_t balanced_ternary_to_binary_int64_t(trit32_t num);
+__int128 balanced_ternary_to_binary_int128_t(trit64_t num);
+__int128 balanced_ternary_to_binary_checked_int128_t(trit128_t num, bool *overflow);
 
 // ADDING FUNCTIONS
 trit8_t trit_add_trit8_t(trit8_t a, trit8_t b);
 trit16_t trit_add_trit16_t(trit16_t a, trit16_t b);
 trit32_t trit_add_trit32_t(trit32_t a, trit32_t b);
+trit8_t trit_add_checked_trit8_t(trit8_t a, trit8_t b, bool *overflow);
+trit16_t trit_add_checked_trit16_t(trit16_t a, trit16_t b, bool *overflow);
+trit32_t trit_add_checked_trit32_t(trit32_t a, trit32_t b, bool *overflow);
+trit64_t trit_add_trit64_t(trit64_t a, trit64_t b);
+trit128_t trit_add_trit128_t(trit128_t a, trit128_t b);
+trit64_t trit_add_checked_trit64_t(trit64_t a, trit64_t b, bool *overflow);
+trit128_t trit_add_checked_trit128_t(trit128_t a, trit128_t b, bool *overflow);
 
 // SUBTRACTING FUNCTIONS
 trit8_t trit_sub_trit8_t(trit8_t a, trit8_t b);
 trit16_t trit_sub_trit16_t(trit16_t a, trit16_t b);
 trit32_t trit_sub_trit32_t(trit32_t a, trit32_t b);
+trit8_t trit_sub_checked_trit8_t(trit8_t a, trit8_t b, bool *overflow);
+trit16_t trit_sub_checked_trit16_t(trit16_t a, trit16_t b, bool *overflow);
+trit32_t trit_sub_checked_trit32_t(trit32_t a, trit32_t b, bool *overflow);
+trit64_t trit_sub_trit64_t(trit64_t a, trit64_t b);
+trit128_t trit_sub_trit128_t(trit128_t a, trit128_t b);
+trit64_t trit_sub_checked_trit64_t(trit64_t a, trit64_t b, bool *overflow);
+trit128_t trit_sub_checked_trit128_t(trit128_t a, trit128_t b, bool *overflow);
+
+// MULTIPLYING FUNCTIONS
+trit8_t trit_mul_trit8_t(trit8_t a, trit8_t b);
+trit16_t trit_mul_trit16_t(trit16_t a, trit16_t b);
+trit32_t trit_mul_trit32_t(trit32_t a, trit32_t b);
+trit8_t trit_mul_checked_trit8_t(trit8_t a, trit8_t b, bool *overflow);
+trit16_t trit_mul_checked_trit16_t(trit16_t a, trit16_t b, bool *overflow);
+trit32_t trit_mul_checked_trit32_t(trit32_t a, trit32_t b, bool *overflow);
+trit16_t trit_mul_wide_trit8_t(trit8_t a, trit8_t b);
+trit32_t trit_mul_wide_trit16_t(trit16_t a, trit16_t b);
+trit64_t trit_mul_wide_trit32_t(trit32_t a, trit32_t b);
+trit128_t trit_mul_wide_trit64_t(trit64_t a, trit64_t b);
+
+// WRAPPING FUNCTIONS
+trit8_t trit_add_wrap_trit8_t(trit8_t a, trit8_t b);
+trit16_t trit_add_wrap_trit16_t(trit16_t a, trit16_t b);
+trit32_t trit_add_wrap_trit32_t(trit32_t a, trit32_t b);
+trit64_t trit_add_wrap_trit64_t(trit64_t a, trit64_t b);
+trit128_t trit_add_wrap_trit128_t(trit128_t a, trit128_t b);
+trit8_t trit_sub_wrap_trit8_t(trit8_t a, trit8_t b);
+trit16_t trit_sub_wrap_trit16_t(trit16_t a, trit16_t b);
+trit32_t trit_sub_wrap_trit32_t(trit32_t a, trit32_t b);
+trit64_t trit_sub_wrap_trit64_t(trit64_t a, trit64_t b);
+trit128_t trit_sub_wrap_trit128_t(trit128_t a, trit128_t b);
+trit8_t trit_mul_wrap_trit8_t(trit8_t a, trit8_t b);
+trit16_t trit_mul_wrap_trit16_t(trit16_t a, trit16_t b);
+trit32_t trit_mul_wrap_trit32_t(trit32_t a, trit32_t b);
+trit64_t trit_mul_wrap_trit64_t(trit64_t a, trit64_t b);
+trit128_t trit_mul_wrap_trit128_t(trit128_t a, trit128_t b);
+
+// SATURATING FUNCTIONS
+trit8_t trit_add_sat_trit8_t(trit8_t a, trit8_t b);
+trit16_t trit_add_sat_trit16_t(trit16_t a, trit16_t b);
+trit32_t trit_add_sat_trit32_t(trit32_t a, trit32_t b);
+trit8_t trit_sub_sat_trit8_t(trit8_t a, trit8_t b);
+trit16_t trit_sub_sat_trit16_t(trit16_t a, trit16_t b);
+trit32_t trit_sub_sat_trit32_t(trit32_t a, trit32_t b);
+trit8_t trit_mul_sat_trit8_t(trit8_t a, trit8_t b);
+trit16_t trit_mul_sat_trit16_t(trit16_t a, trit16_t b);
+trit32_t trit_mul_sat_trit32_t(trit32_t a, trit32_t b);
+
+// CARRYING FUNCTIONS
+trit8_t trit_adc_trit8_t(trit8_t a, trit8_t b, int carry_in, int *carry_out);
+trit16_t trit_adc_trit16_t(trit16_t a, trit16_t b, int carry_in, int *carry_out);
+trit32_t trit_adc_trit32_t(trit32_t a, trit32_t b, int carry_in, int *carry_out);
+trit64_t trit_adc_trit64_t(trit64_t a, trit64_t b, int carry_in, int *carry_out);
+trit128_t trit_adc_trit128_t(trit128_t a, trit128_t b, int carry_in, int *carry_out);
+
+trit8_t trit_sbb_trit8_t(trit8_t a, trit8_t b, int borrow_in, int *borrow_out);
+trit16_t trit_sbb_trit16_t(trit16_t a, trit16_t b, int borrow_in, int *borrow_out);
+trit32_t trit_sbb_trit32_t(trit32_t a, trit32_t b, int borrow_in, int *borrow_out);
+trit64_t trit_sbb_trit64_t(trit64_t a, trit64_t b, int borrow_in, int *borrow_out);
+trit128_t trit_sbb_trit128_t(trit128_t a, trit128_t b, int borrow_in, int *borrow_out);
 
 // OR FUNCTIONS
 trit8_t trit_or_trit8_t(trit8_t a, trit8_t b);
 trit16_t trit_or_trit16_t(trit16_t a, trit16_t b);
 trit32_t trit_or_trit32_t(trit32_t a, trit32_t b);
+trit64_t trit_or_trit64_t(trit64_t a, trit64_t b);
+trit128_t trit_or_trit128_t(trit128_t a, trit128_t b);
 
 // XOR FUNCTIONS
 trit8_t trit_xor_trit8_t(trit8_t a, trit8_t b);
 trit16_t trit_xor_trit16_t(trit16_t a, trit16_t b);
 trit32_t trit_xor_trit32_t(trit32_t a, trit32_t b);
+trit64_t trit_xor_trit64_t(trit64_t a, trit64_t b);
+trit128_t trit_xor_trit128_t(trit128_t a, trit128_t b);
 
 // AND FUNCTIONS
 trit8_t trit_and_trit8_t(trit8_t a, trit8_t b);
 trit16_t trit_and_trit16_t(trit16_t a, trit16_t b);
 trit32_t trit_and_trit32_t(trit32_t a, trit32_t b);
+trit64_t trit_and_trit64_t(trit64_t a, trit64_t b);
+trit128_t trit_and_trit128_t(trit128_t a, trit128_t b);
 
 // SHIFT LEFT FUNCTIONS
 trit8_t trit_sl_trit8_t(trit8_t a, uint8_t b);
 trit16_t trit_sl_trit16_t(trit16_t a, uint8_t b);
 trit32_t trit_sl_trit32_t(trit32_t a, uint8_t b);
+trit64_t trit_sl_trit64_t(trit64_t a, uint8_t b);
+trit128_t trit_sl_trit128_t(trit128_t a, uint8_t b);
 
 // SHIFT RIGHT FUNCTIONS
 trit8_t trit_sr_trit8_t(trit8_t a, uint8_t b);
 trit16_t trit_sr_trit16_t(trit16_t a, uint8_t b);
 trit32_t trit_sr_trit32_t(trit32_t a, uint8_t b);
+trit64_t trit_sr_trit64_t(trit64_t a, uint8_t b);
+trit128_t trit_sr_trit128_t(trit128_t a, uint8_t b);
 
 // NOT FUNCTIONS
 trit8_t trit_not_trit8_t(trit8_t num);
 trit16_t trit_not_trit16_t(trit16_t num);
 trit32_t trit_not_trit32_t(trit32_t num);
+trit64_t trit_not_trit64_t(trit64_t num);
+trit128_t trit_not_trit128_t(trit128_t num);
+
+// UNPACK FUNCTIONS
+void trit_unpack_trit8_t(trit8_t num, uint8_t *mag, uint8_t *sign);
+void trit_unpack_trit16_t(trit16_t num, uint16_t *mag, uint16_t *sign);
+void trit_unpack_trit32_t(trit32_t num, uint32_t *mag, uint32_t *sign);
+void trit_unpack_trit64_t(trit64_t num, uint64_t *mag, uint64_t *sign);
+void trit_unpack_trit128_t(trit128_t num, __uint128_t *mag, __uint128_t *sign);
+
+// PACK FUNCTIONS
+trit8_t trit_pack_trit8_t(uint8_t mag, uint8_t sign);
+trit16_t trit_pack_trit16_t(uint16_t mag, uint16_t sign);
+trit32_t trit_pack_trit32_t(uint32_t mag, uint32_t sign);
+trit64_t trit_pack_trit64_t(uint64_t mag, uint64_t sign);
+trit128_t trit_pack_trit128_t(__uint128_t mag, __uint128_t sign);
+
+// COUNT FUNCTIONS
+uint8_t trit_count_trit8_t(trit8_t num, int8_t digit);
+uint8_t trit_count_trit16_t(trit16_t num, int8_t digit);
+uint8_t trit_count_trit32_t(trit32_t num, int8_t digit);
+uint8_t trit_count_trit64_t(trit64_t num, int8_t digit);
+uint8_t trit_count_trit128_t(trit128_t num, int8_t digit);
+
+// HAMMING DISTANCE FUNCTIONS
+uint8_t trit_hamming_trit8_t(trit8_t a, trit8_t b);
+uint8_t trit_hamming_trit16_t(trit16_t a, trit16_t b);
+uint8_t trit_hamming_trit32_t(trit32_t a, trit32_t b);
+uint8_t trit_hamming_trit64_t(trit64_t a, trit64_t b);
+uint8_t trit_hamming_trit128_t(trit128_t a, trit128_t b);
+
+// SIMILARITY FUNCTIONS
+int8_t trit_similarity_trit8_t(trit8_t a, trit8_t b);
+int8_t trit_similarity_trit16_t(trit16_t a, trit16_t b);
+int8_t trit_similarity_trit32_t(trit32_t a, trit32_t b);
+int8_t trit_similarity_trit64_t(trit64_t a, trit64_t b);
+int16_t trit_similarity_trit128_t(trit128_t a, trit128_t b);
+
+// WIDEN FUNCTIONS
+trit16_t trit_widen_trit8_t_to_trit16_t(trit8_t num);
+trit32_t trit_widen_trit8_t_to_trit32_t(trit8_t num);
+trit32_t trit_widen_trit16_t_to_trit32_t(trit16_t num);
+trit64_t trit_widen_trit32_t_to_trit64_t(trit32_t num);
+trit128_t trit_widen_trit64_t_to_trit128_t(trit64_t num);
+
+// NARROW FUNCTIONS
+trit8_t trit_narrow_checked_trit16_t_to_trit8_t(trit16_t num, bool *overflow);
+trit8_t trit_narrow_checked_trit32_t_to_trit8_t(trit32_t num, bool *overflow);
+trit16_t trit_narrow_checked_trit32_t_to_trit16_t(trit32_t num, bool *overflow);
+trit32_t trit_narrow_checked_trit64_t_to_trit32_t(trit64_t num, bool *overflow);
+trit64_t trit_narrow_checked_trit128_t_to_trit64_t(trit128_t num, bool *overflow);
+trit8_t trit_narrow_wrap_trit16_t_to_trit8_t(trit16_t num);
+trit8_t trit_narrow_wrap_trit32_t_to_trit8_t(trit32_t num);
+trit16_t trit_narrow_wrap_trit32_t_to_trit16_t(trit32_t num);
+trit32_t trit_narrow_wrap_trit64_t_to_trit32_t(trit64_t num);
+trit64_t trit_narrow_wrap_trit128_t_to_trit64_t(trit128_t num);
+
+// REPACK FUNCTIONS
+void trit_repack_trit8_t_to_trit32_t(const trit8_t *src, size_t count, trit32_t *dst);
+void trit_repack_trit16_t_to_trit32_t(const trit16_t *src, size_t count, trit32_t *dst);
+void trit_repack_trit32_t_to_trit8_t(const trit32_t *src, size_t count, trit8_t *dst);
+void trit_repack_trit32_t_to_trit16_t(const trit32_t *src, size_t count, trit16_t *dst);
 
 #endif // __ternary_h__
\ No newline at end of file
@@ -0,0 +1,1690 @@
+#include "ternary.h"
+#include "ternary_circuit.h"
+#include "ternary_codec.h"
+#include "ternary_dot.h"
+#include "ternary_fixed.h"
+#include "ternary_float.h"
+#include "ternary_gemm.h"
+#include "ternary_hash.h"
+#include "ternary_kleene.h"
+#include "ternary_lut.h"
+#include "ternary_metric.h"
+#include "ternary_mod.h"
+#include "ternary_quant.h"
+#include "ternary_sat.h"
+#include "ternary_sparse.h"
+#include "ternary_scan.h"
+#include "ternary_sum.h"
+#include "ternary_tcam.h"
+#include "ternary_thread.h"
+#include "ternary_vm.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <unordered_map>
+#include <vector>
+#include <x86intrin.h>
+#include <zlib.h>
+
+// random balanced ternary word
+static trit32_t random_trit32(){
+
+  trit32_t result = 0;
+
+  for(int index = 0; index < 32; index++){
+
+    int grab = rand() % 3;
+    result = (result << 2) | (grab == 2 ? 0b11 : grab);
+  }
+
+  return result;
+}
+
+#define BENCH_DOT(name, kernel, act)                                         \
+  do {                                                                       \
+    volatile double sink = 0;                                                \
+    uint64_t start = __rdtsc();                                              \
+    for(int rep = 0; rep < reps; rep++){                                     \
+      sink = sink + kernel(weights.data(), act.data(), n);                   \
+    }                                                                        \
+    uint64_t cycles = __rdtsc() - start;                                     \
+    printf("%-24s %8.2f trits/cycle\n", name, (double)n * reps / cycles);   \
+  } while(0)
+
+static void bench_dot(){
+
+  const size_t n = 1 << 16;
+  const int reps = 2000;
+
+  std::vector<trit32_t> weights(n / 32);
+  std::vector<int8_t> act8(n);
+  std::vector<int16_t> act16(n);
+  std::vector<float> actf(n);
+
+  for(size_t index = 0; index < weights.size(); index++){
+
+    weights[index] = random_trit32();
+  }
+  for(size_t index = 0; index < n; index++){
+
+    act8[index] = (int8_t)rand();
+    act16[index] = (int16_t)rand();
+    actf[index] = (float)rand() / RAND_MAX;
+  }
+
+  printf("trit_dot, %zu trits\n", n);
+
+  BENCH_DOT("scalar int8", trit_dot_scalar_int8_t, act8);
+  BENCH_DOT("scalar int16", trit_dot_scalar_int16_t, act16);
+  BENCH_DOT("scalar float", trit_dot_scalar_float, actf);
+
+  if(__builtin_cpu_supports("avx2")){
+
+    BENCH_DOT("avx2 int8", trit_dot_avx2_int8_t, act8);
+    BENCH_DOT("avx2 int16", trit_dot_avx2_int16_t, act16);
+    BENCH_DOT("avx2 float", trit_dot_avx2_float, actf);
+  }
+  if(__builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("bmi2")){
+
+    BENCH_DOT("avx512 int8", trit_dot_avx512_int8_t, act8);
+    BENCH_DOT("avx512 int16", trit_dot_avx512_int16_t, act16);
+    BENCH_DOT("avx512 float", trit_dot_avx512_float, actf);
+  }
+}
+
+// seconds since start
+static double seconds_since(std::chrono::steady_clock::time_point start){
+
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// plain float matrix-vector multiply of the same shape for comparison
+static void float_gemv(const float *weights, size_t rows, size_t cols, const float *x, float *y){
+
+  for(size_t row = 0; row < rows; row++){
+
+    float sum = 0;
+
+    for(size_t col = 0; col < cols; col++){
+
+      sum += weights[row * cols + col] * x[col];
+    }
+
+    y[row] = sum;
+  }
+}
+
+static void bench_gemv(){
+
+  const size_t rows = 4096;
+  const size_t cols = 4096;
+  const int reps = 50;
+
+  std::vector<trit32_t> weights(rows * TRIT_ROW_WORDS(cols));
+  std::vector<float> float_weights(rows * cols);
+  std::vector<float> x(cols * 8);
+  std::vector<float> y(rows * 8);
+
+  for(size_t index = 0; index < weights.size(); index++){
+
+    weights[index] = random_trit32();
+  }
+  for(size_t index = 0; index < float_weights.size(); index++){
+
+    float_weights[index] = (float)(rand() % 3 - 1);
+  }
+  for(size_t index = 0; index < x.size(); index++){
+
+    x[index] = (float)rand() / RAND_MAX;
+  }
+
+  printf("gemv, %zu x %zu\n", rows, cols);
+
+  auto start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    float_gemv(float_weights.data(), rows, cols, x.data(), y.data());
+  }
+  double float_time = seconds_since(start) / reps;
+  printf("%-24s %8.3f ms\n", "float gemv", float_time * 1e3);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    trit_gemv_float(weights.data(), rows, cols, x.data(), y.data(), 1);
+  }
+  double trit_time = seconds_since(start) / reps;
+  printf("%-24s %8.3f ms (%.1fx)\n", "trit gemv 1 thread", trit_time * 1e3, float_time / trit_time);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    trit_gemv_float(weights.data(), rows, cols, x.data(), y.data(), 0);
+  }
+  trit_time = seconds_since(start) / reps;
+  printf("%-24s %8.3f ms (%.1fx)\n", "trit gemv all threads", trit_time * 1e3, float_time / trit_time);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    trit_gemm_float(weights.data(), rows, cols, x.data(), 8, y.data(), 1);
+  }
+  trit_time = seconds_since(start) / reps / 8;
+  printf("%-24s %8.3f ms per vector\n", "trit gemm batch 8", trit_time * 1e3);
+}
+
+static void bench_metric(){
+
+  const size_t count = 1 << 20;
+  const size_t words = 4;
+  const int reps = 10;
+
+  std::vector<trit32_t> base(count * words);
+  std::vector<trit32_t> query(words);
+  std::vector<uint32_t> distances(count);
+
+  for(size_t index = 0; index < base.size(); index++){
+
+    base[index] = random_trit32();
+  }
+  for(size_t index = 0; index < words; index++){
+
+    query[index] = random_trit32();
+  }
+
+  printf("hamming scan, %zu fingerprints of %zu trits\n", count, words * 32);
+
+  auto start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    trit_hamming_batch(query.data(), base.data(), count, words, distances.data(), 1);
+  }
+  double time = seconds_since(start) / reps;
+  printf("%-24s %8.1f M fingerprints/s\n", "1 thread", count / time / 1e6);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    trit_hamming_batch(query.data(), base.data(), count, words, distances.data(), 0);
+  }
+  time = seconds_since(start) / reps;
+  printf("%-24s %8.1f M fingerprints/s\n", "all threads", count / time / 1e6);
+}
+
+static void bench_convert(){
+
+  const size_t count = 4096;
+  const int reps = 500;
+
+  std::vector<uint64_t> values(count);
+  std::vector<trit32_t> words(count);
+
+  for(size_t index = 0; index < count; index++){
+
+    values[index] = (((uint64_t)rand() << 31) | rand()) % 926510094425921ULL;
+    words[index] = random_trit32();
+  }
+
+  printf("trit <-> binary, %zu values\n", count);
+
+  volatile uint64_t sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    for(size_t index = 0; index < count; index++){
+
+      sink = sink + binary_to_balanced_ternary_trit32_t(values[index]);
+    }
+  }
+  double time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns\n", "to 32 trits", time * 1e9);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    for(size_t index = 0; index < count; index++){
+
+      sink = sink + balanced_ternary_to_binary_int64_t(words[index]);
+    }
+  }
+  time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns\n", "from 32 trits", time * 1e9);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    for(size_t index = 0; index < count; index++){
+
+      sink = sink + binary_to_balanced_ternary_trit8_t((uint16_t)(values[index] % 3281));
+    }
+  }
+  time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns\n", "to 8 trits", time * 1e9);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    for(size_t index = 0; index < count; index++){
+
+      sink = sink + balanced_ternary_to_binary_int16_t((trit8_t)words[index]);
+    }
+  }
+  time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns\n", "from 8 trits", time * 1e9);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    for(size_t index = 0; index < count; index++){
+
+      sink = sink + trit_not_trit32_t(words[index]);
+    }
+  }
+  time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns\n", "not 32 trits", time * 1e9);
+}
+
+static void bench_add(){
+
+  const size_t count = 1024;
+  const int reps = 2000;
+
+  std::vector<trit32_t> a32(count);
+  std::vector<trit64_t> a64(count);
+  std::vector<trit128_t> a128(count);
+  bool overflow = false;
+
+  for(size_t index = 0; index < count; index++){
+
+    // keep the top trits clear so the sums do not overflow
+    a32[index] = random_trit32() >> 2;
+    a64[index] = ((trit64_t)(random_trit32() >> 2) << 64) | random_trit32();
+    a128[index].low = ((trit64_t)random_trit32() << 64) | random_trit32();
+    a128[index].high = ((trit64_t)(random_trit32() >> 2) << 64) | random_trit32();
+  }
+
+  printf("trit add, %zu sums\n", count);
+
+  volatile uint64_t sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    for(size_t index = 0; index < count; index++){
+
+      sink = sink + trit_add_checked_trit32_t(a32[index], a32[count - 1 - index], &overflow);
+    }
+  }
+  double time32 = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns\n", "32 trits", time32 * 1e9);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    for(size_t index = 0; index < count; index++){
+
+      sink = sink + (uint64_t)trit_add_checked_trit64_t(a64[index], a64[count - 1 - index], &overflow);
+    }
+  }
+  double time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns (%.1fx)\n", "64 trits", time * 1e9, time / time32);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    for(size_t index = 0; index < count; index++){
+
+      sink = sink + (uint64_t)trit_add_checked_trit128_t(a128[index], a128[count - 1 - index], &overflow).low;
+    }
+  }
+  time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns (%.1fx)\n", "128 trits", time * 1e9, time / time32);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    for(size_t index = 0; index < count; index++){
+
+      const trit128_t &x = a128[index];
+      const trit128_t &y = a128[count - 1 - index];
+      int carry = 0;
+
+      sink = sink + trit_adc_trit32_t((trit32_t)x.low, (trit32_t)y.low, 0, &carry);
+      sink = sink + trit_adc_trit32_t((trit32_t)(x.low >> 64), (trit32_t)(y.low >> 64), carry, &carry);
+      sink = sink + trit_adc_trit32_t((trit32_t)x.high, (trit32_t)y.high, carry, &carry);
+      sink = sink + trit_adc_trit32_t((trit32_t)(x.high >> 64), (trit32_t)(y.high >> 64), carry, &carry) + carry;
+    }
+  }
+  time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns (%.1fx)\n", "128 trits, 4 x adc", time * 1e9, time / time32);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    for(size_t index = 0; index < count; index++){
+
+      sink = sink + trit_add_trit32_t(a32[index], a32[count - 1 - index]);
+    }
+  }
+  time32 = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns\n", "32 trits, errno", time32 * 1e9);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    for(size_t index = 0; index < count; index++){
+
+      sink = sink + trit_add_wrap_trit32_t(a32[index], a32[count - 1 - index]);
+    }
+  }
+  time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns (%.2fx)\n", "32 trits, wrap", time * 1e9, time / time32);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    for(size_t index = 0; index < count; index++){
+
+      sink = sink + (uint64_t)trit_mul_wide_trit32_t(a32[index], a32[count - 1 - index]);
+    }
+  }
+  time32 = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns\n", "mul 32 trits, wide", time32 * 1e9);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    for(size_t index = 0; index < count; index++){
+
+      sink = sink + trit_mul_wrap_trit32_t(a32[index], a32[count - 1 - index]);
+    }
+  }
+  time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns (%.2fx)\n", "mul 32 trits, wrap", time * 1e9, time / time32);
+}
+
+static void bench_sum(){
+
+  const size_t count = 1 << 24;
+  const int reps = 5;
+
+  std::vector<trit32_t> values(count);
+  bool overflow = false;
+
+  for(size_t index = 0; index < count; index++){
+
+    values[index] = random_trit32();
+  }
+
+  printf("trit sum, %zu values\n", count);
+
+  volatile uint64_t sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    trit64_t total = 0;
+
+    for(size_t index = 0; index < count; index++){
+
+      total = trit_add_checked_trit64_t(total, values[index], &overflow);
+    }
+
+    sink = sink + (uint64_t)total;
+  }
+  double serial_time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns/value\n", "serial trit64 add", serial_time * 1e9);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    sink = sink + (uint64_t)trit_sum_array(values.data(), count, &overflow);
+  }
+  double time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns/value (%.1fx)\n", "trit_sum_array", time * 1e9, serial_time / time);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    sink = sink + (uint64_t)trit_sum_reduce(values.data(), count, 0, &overflow);
+  }
+  time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns/value (%.1fx)\n", "trit_sum_reduce", time * 1e9, serial_time / time);
+}
+
+static void bench_scan(){
+
+  const size_t count = 1 << 24;
+  const int reps = 3;
+
+  std::vector<trit32_t> values(count);
+  std::vector<trit32_t> totals(count);
+  bool *flags = new bool[(count + TRIT_SCAN_BLOCK - 1) / TRIT_SCAN_BLOCK];
+  bool overflow = false;
+
+  for(size_t index = 0; index < count; index++){
+
+    // small values so the totals stay in range
+    values[index] = random_trit32() >> 40;
+  }
+
+  printf("trit scan, %zu values\n", count);
+
+  auto start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    trit32_t total = 0;
+
+    for(size_t index = 0; index < count; index++){
+
+      total = trit_add_checked_trit32_t(total, values[index], &overflow);
+      totals[index] = total;
+    }
+  }
+  double serial_time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns/value\n", "serial trit32 add", serial_time * 1e9);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    trit_scan_inclusive(values.data(), totals.data(), count, 1, flags);
+  }
+  double time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns/value\n", "scan 1 thread", time * 1e9);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    trit_scan_inclusive(values.data(), totals.data(), count, 0, flags);
+  }
+  double threads_time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns/value (%.1fx)\n", "scan all threads", threads_time * 1e9, time / threads_time);
+
+  delete[] flags;
+}
+
+static void bench_hash(){
+
+  const size_t words = 1 << 22;
+  const size_t count = 1 << 20;
+  const int reps = 10;
+
+  std::vector<trit32_t> vector(words);
+  std::vector<trit32_t> keys(count);
+  std::vector<trit32_t> misses(count);
+
+  for(size_t index = 0; index < words; index++){
+
+    vector[index] = random_trit32();
+  }
+  for(size_t index = 0; index < count; index++){
+
+    keys[index] = random_trit32();
+    misses[index] = random_trit32();
+  }
+
+  printf("trit hash, %zu words and %zu keys\n", words, count);
+
+  volatile uint64_t sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    sink = sink + trit_hash_array(vector.data(), words, rep);
+  }
+  double time = seconds_since(start) / reps;
+  printf("%-24s %8.2f GB/s\n", "trit_hash_array", words * sizeof(trit32_t) / time / 1e9);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    for(size_t index = 0; index < count; index++){
+
+      sink = sink + trit_hash_trit32_t(keys[index]);
+    }
+  }
+  time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns\n", "trit_hash_trit32_t", time * 1e9);
+
+  std::unordered_map<uint64_t, uint64_t> standard;
+  start = std::chrono::steady_clock::now();
+  for(size_t index = 0; index < count; index++){
+
+    standard[keys[index]] = index;
+  }
+  double standard_insert = seconds_since(start) / count;
+
+  start = std::chrono::steady_clock::now();
+  for(size_t index = 0; index < count; index++){
+
+    auto hit = standard.find(keys[index]);
+    auto miss = standard.find(misses[index]);
+    sink = sink + (hit == standard.end() ? 0 : hit->second) + (miss == standard.end() ? 0 : miss->second);
+  }
+  double standard_find = seconds_since(start) / count / 2;
+
+  trit_map_t map;
+  uint64_t value = 0;
+  if(!trit_map_init(&map, 0)){
+
+    return;
+  }
+
+  start = std::chrono::steady_clock::now();
+  for(size_t index = 0; index < count; index++){
+
+    trit_map_put(&map, keys[index], index);
+  }
+  double map_insert = seconds_since(start) / count;
+
+  start = std::chrono::steady_clock::now();
+  for(size_t index = 0; index < count; index++){
+
+    sink = sink + (trit_map_get(&map, keys[index], &value) ? value : 0);
+    sink = sink + (trit_map_get(&map, misses[index], &value) ? value : 0);
+  }
+  double map_find = seconds_since(start) / count / 2;
+
+  printf("%-24s %8.2f ns insert %8.2f ns find\n", "std::unordered_map", standard_insert * 1e9, standard_find * 1e9);
+  printf("%-24s %8.2f ns insert %8.2f ns find (%.1fx)\n", "trit_map_t", map_insert * 1e9, map_find * 1e9, standard_find / map_find);
+
+  trit_map_free(&map);
+}
+
+static void bench_fixed(){
+
+  const size_t count = 1 << 20;
+  const int reps = 10;
+  const int frac = 16;
+
+  std::vector<trit32_t> a(count);
+  std::vector<trit32_t> b(count);
+  std::vector<trit32_t> out(count);
+  std::vector<double> values(count);
+  bool overflow = false;
+
+  for(size_t index = 0; index < count; index++){
+
+    // 24 trit values so the products fit
+    a[index] = random_trit32() >> 16;
+    b[index] = random_trit32() >> 16;
+  }
+
+  printf("trit fixed-point, %zu values with %d fraction trits\n", count, frac);
+
+  volatile uint64_t sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    for(size_t index = 0; index < count; index++){
+
+      sink = sink + (uint64_t)trit_mul_wide_trit32_t(a[index], b[index]);
+    }
+  }
+  double time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns/value\n", "trit_mul_wide_trit32_t", time * 1e9);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    trit_fix_mul_array(a.data(), b.data(), out.data(), count, frac, &overflow);
+  }
+  time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns/value\n", "trit_fix_mul_array", time * 1e9);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    trit_fix_to_double_scalar(a.data(), values.data(), count, frac);
+  }
+  double scalar_time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns/value\n", "to double scalar", scalar_time * 1e9);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    trit_fix_to_double_array(a.data(), values.data(), count, frac);
+  }
+  time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns/value (%.1fx)\n", "to double", time * 1e9, scalar_time / time);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    trit_fix_from_double_scalar(values.data(), out.data(), count, frac, &overflow);
+  }
+  scalar_time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns/value\n", "from double scalar", scalar_time * 1e9);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    trit_fix_from_double_array(values.data(), out.data(), count, frac, &overflow);
+  }
+  time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns/value (%.1fx)\n", "from double", time * 1e9, scalar_time / time);
+}
+
+static void bench_float(){
+
+  const size_t count = 1 << 18;
+  const int reps = 10;
+
+  std::vector<double> values(count);
+  std::vector<double> back(count);
+  std::vector<trit_float_t> a(count);
+  std::vector<trit_float_t> b(count);
+  std::vector<trit_float_t> out(count);
+  int status = 0;
+
+  for(size_t index = 0; index < count; index++){
+
+    values[index] = (double)(int64_t)random_trit32() / (1 << 20);
+  }
+
+  trit_float_from_double_array(values.data(), a.data(), count, 0, &status);
+  std::reverse(values.begin(), values.end());
+  trit_float_from_double_array(values.data(), b.data(), count, 0, &status);
+
+  printf("trit floating-point, %zu values\n", count);
+
+  auto start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    for(size_t index = 0; index < count; index++){
+
+      a[index] = trit_float_from_double(values[index]);
+    }
+  }
+  double time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns/value %8.1f Mop/s\n", "from double", time * 1e9, 1e-6 / time);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    for(size_t index = 0; index < count; index++){
+
+      back[index] = trit_float_to_double(a[index]);
+    }
+  }
+  time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns/value %8.1f Mop/s\n", "to double", time * 1e9, 1e-6 / time);
+
+  const char *names[4] = {"add", "mul", "div", "sqrt"};
+
+  for(int op = 0; op < 4; op++){
+
+    start = std::chrono::steady_clock::now();
+    for(int rep = 0; rep < reps; rep++){
+
+      for(size_t index = 0; index < count; index++){
+
+        switch(op){
+
+          case 0: out[index] = trit_float_add(a[index], b[index]); break;
+          case 1: out[index] = trit_float_mul(a[index], b[index]); break;
+          case 2: out[index] = trit_float_div(a[index], b[index]); break;
+          default: out[index] = trit_float_sqrt(a[index]); break;
+        }
+      }
+    }
+    time = seconds_since(start) / reps / count;
+    printf("%-24s %8.2f ns/value %8.1f Mop/s\n", names[op], time * 1e9, 1e-6 / time);
+  }
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    trit_float_mul_array(a.data(), b.data(), out.data(), count, 0, &status);
+  }
+  time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns/value %8.1f Mop/s\n", "mul array, all threads", time * 1e9, 1e-6 / time);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    for(size_t index = 0; index < count; index++){
+
+      back[index] = values[index] * back[index];
+    }
+  }
+  time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns/value %8.1f Mop/s\n", "double mul", time * 1e9, 1e-6 / time);
+}
+
+static void bench_mod(){
+
+  const size_t count = 1 << 12;
+  const int reps = 10;
+
+  // 3^31 + 1 and 3^63 + 1 style moduli, not multiples of 3
+  trit32_t modulus32 = binary_to_balanced_ternary_trit32_t(617673396283948ULL);
+  trit64_t modulus64 = binary_to_balanced_ternary_trit64_t((__int128)617673396283947ULL * 617673396283947ULL * 3 + 1);
+  trit_mont32_t mont32;
+  trit_mont64_t mont64;
+  std::vector<trit32_t> a32(count);
+  std::vector<trit64_t> a64(count);
+  std::vector<uint64_t> binary(count);
+
+  trit_mont_init_trit32_t(&mont32, modulus32);
+  trit_mont_init_trit64_t(&mont64, modulus64);
+
+  for(size_t index = 0; index < count; index++){
+
+    binary[index] = (random_trit32() >> 1) % 617673396283948ULL;
+    a32[index] = trit_mont_in_trit32_t(&mont32, binary_to_balanced_ternary_trit32_t(binary[index]));
+    a64[index] = trit_mont_in_trit64_t(&mont64, binary_to_balanced_ternary_trit64_t((__int128)binary[index] * binary[index]));
+  }
+
+  printf("trit modular arithmetic, %zu values\n", count);
+
+  trit32_t acc32 = mont32.one;
+  auto start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    for(size_t index = 0; index < count; index++){
+
+      acc32 = trit_mont_mul_trit32_t(&mont32, acc32, a32[index]);
+    }
+  }
+  double time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns/value\n", "montgomery mul 32", time * 1e9);
+
+  trit64_t acc64 = mont64.one;
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    for(size_t index = 0; index < count; index++){
+
+      acc64 = trit_mont_mul_trit64_t(&mont64, acc64, a64[index]);
+    }
+  }
+  time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns/value\n", "montgomery mul 64", time * 1e9);
+
+  // read back so the compiler cannot turn the division into a multiply
+  volatile uint64_t binary_modulus = 617673396283948ULL;
+  uint64_t divisor = binary_modulus;
+  uint64_t acc = 1;
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    for(size_t index = 0; index < count; index++){
+
+      acc = (uint64_t)((unsigned __int128)acc * binary[index] % divisor);
+    }
+  }
+  time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns/value\n", "binary mulmod 64 bit", time * 1e9);
+
+  const size_t powers = 256;
+  start = std::chrono::steady_clock::now();
+  for(size_t index = 0; index < powers; index++){
+
+    acc32 = trit_mont_pow_trit32_t(&mont32, a32[index], binary_to_balanced_ternary_trit32_t(binary[index + 1]));
+  }
+  time = seconds_since(start) / powers;
+  printf("%-24s %8.2f us/value\n", "montgomery pow 32", time * 1e6);
+
+  start = std::chrono::steady_clock::now();
+  for(size_t index = 0; index < powers; index++){
+
+    acc64 = trit_mont_pow_trit64_t(&mont64, a64[index], binary_to_balanced_ternary_trit64_t((__int128)binary[index + 1] * binary[index + 1]));
+  }
+  time = seconds_since(start) / powers;
+  printf("%-24s %8.2f us/value\n", "montgomery pow 64", time * 1e6);
+
+  if(acc32 == 1 && acc64 == 1 && acc == 0){
+
+    printf("\n");
+  }
+}
+
+static void bench_sat(){
+
+  const size_t count = 1 << 16;
+  const int reps = 200;
+
+  std::vector<trit8_t> a8(count), b8(count), out8(count);
+  std::vector<trit16_t> a16(count), b16(count), out16(count);
+  std::vector<trit32_t> a32(count), b32(count), out32(count);
+
+  for(size_t index = 0; index < count; index++){
+
+    // full width values so about a quarter of the sums clamp
+    a32[index] = random_trit32();
+    b32[index] = random_trit32();
+    a16[index] = (trit16_t)a32[index];
+    b16[index] = (trit16_t)b32[index];
+    a8[index] = (trit8_t)a32[index];
+    b8[index] = (trit8_t)b32[index];
+  }
+
+  printf("trit saturating add, %zu values\n", count);
+
+  auto start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    trit_add_sat_scalar_trit8_t(a8.data(), b8.data(), out8.data(), count);
+  }
+  double scalar_time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns/value\n", "8 trits scalar", scalar_time * 1e9);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    trit_add_sat_array_trit8_t(a8.data(), b8.data(), out8.data(), count);
+  }
+  double time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns/value (%.1fx)\n", "8 trits", time * 1e9, scalar_time / time);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    trit_add_sat_scalar_trit16_t(a16.data(), b16.data(), out16.data(), count);
+  }
+  scalar_time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns/value\n", "16 trits scalar", scalar_time * 1e9);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    trit_add_sat_array_trit16_t(a16.data(), b16.data(), out16.data(), count);
+  }
+  time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns/value (%.1fx)\n", "16 trits", time * 1e9, scalar_time / time);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    trit_add_sat_scalar_trit32_t(a32.data(), b32.data(), out32.data(), count);
+  }
+  scalar_time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns/value\n", "32 trits scalar", scalar_time * 1e9);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    trit_add_sat_array_trit32_t(a32.data(), b32.data(), out32.data(), count);
+  }
+  time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns/value (%.1fx)\n", "32 trits", time * 1e9, scalar_time / time);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    trit_mul_sat_array_trit32_t(a32.data(), b32.data(), out32.data(), count);
+  }
+  time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns/value\n\n", "mul 32 trits", time * 1e9);
+}
+
+static void bench_lut(){
+
+  const size_t count = 1 << 16;
+  const int reps = 200;
+  const int8_t and_table[9] = {-1, -1, -1, -1, 0, 0, -1, 0, 1};
+  const int8_t odd_table[9] = {1, -1, 0, 0, 1, -1, -1, 0, 1};
+
+  std::vector<trit32_t> a(count);
+  std::vector<trit32_t> b(count);
+  std::vector<trit32_t> out(count);
+  trit_lut2_t lut_and;
+  trit_lut2_t lut_odd;
+
+  trit_lut2_compile(&lut_and, and_table);
+  trit_lut2_compile(&lut_odd, odd_table);
+
+  for(size_t index = 0; index < count; index++){
+
+    a[index] = random_trit32();
+    b[index] = random_trit32();
+  }
+
+  printf("trit lut2, %zu words of 32 trits\n", count);
+
+  volatile uint64_t sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps / 20; rep++){
+
+    for(size_t index = 0; index < count; index++){
+
+      sink = sink + trit_and_trit32_t(a[index], b[index]);
+    }
+  }
+  double time = seconds_since(start) / (reps / 20) / count;
+  printf("%-24s %8.2f ns/word\n", "trit_and_trit32_t", time * 1e9);
+
+  // the mask AND, two words per call
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    for(size_t index = 0; index + 1 < count; index += 2){
+
+      trit64_t x = ((trit64_t)a[index + 1] << 64) | a[index];
+      trit64_t y = ((trit64_t)b[index + 1] << 64) | b[index];
+
+      sink = sink + (uint64_t)trit_and_trit64_t(x, y);
+    }
+  }
+  double and_time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns/word\n", "trit_and_trit64_t", and_time * 1e9);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    for(size_t index = 0; index + 1 < count; index += 2){
+
+      trit64_t x = ((trit64_t)a[index + 1] << 64) | a[index];
+      trit64_t y = ((trit64_t)b[index + 1] << 64) | b[index];
+
+      sink = sink + (uint64_t)trit_lut2_trit64_t(&lut_and, x, y);
+    }
+  }
+  time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns/word (%.2fx)\n", "trit_lut2_trit64_t", time * 1e9, time / and_time);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    trit_lut2_scalar(&lut_odd, a.data(), b.data(), out.data(), count);
+  }
+  time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns/word (%.2fx)\n", "lut2 scalar", time * 1e9, time / and_time);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    trit_lut2_array(&lut_odd, a.data(), b.data(), out.data(), count);
+  }
+  time = seconds_since(start) / reps / count;
+  printf("%-24s %8.2f ns/word (%.2fx)\n\n", "lut2 array", time * 1e9, time / and_time);
+}
+
+static void bench_kleene(){
+
+  const size_t rows = 1 << 22;
+  const size_t words = rows / 32;
+  const int reps = 20;
+
+  std::vector<trit32_t> a(words);
+  std::vector<trit32_t> b(words);
+  std::vector<trit32_t> c(words);
+  std::vector<trit32_t> sparse(words);
+  std::vector<trit32_t> out(words);
+  std::vector<uint64_t> selection(rows / 64);
+  std::vector<int8_t> rows_a(rows);
+  std::vector<int8_t> rows_b(rows);
+  std::vector<int8_t> rows_c(rows);
+
+  for(size_t index = 0; index < words; index++){
+
+    a[index] = random_trit32();
+    b[index] = random_trit32();
+    c[index] = random_trit32();
+    // FALSE except for one block in 16, like a selective predicate
+    sparse[index] = (index / 64) % 16 == 0 ? a[index] : 0xFFFFFFFFFFFFFFFFULL;
+  }
+
+  for(size_t row = 0; row < rows; row++){
+
+    int shift = 2 * (row % 32);
+    int code_a = (int)((a[row / 32] >> shift) & 3);
+    int code_b = (int)((b[row / 32] >> shift) & 3);
+    int code_c = (int)((c[row / 32] >> shift) & 3);
+
+    rows_a[row] = (int8_t)(code_a == 3 ? -1 : code_a);
+    rows_b[row] = (int8_t)(code_b == 3 ? -1 : code_b);
+    rows_c[row] = (int8_t)(code_c == 3 ? -1 : code_c);
+  }
+
+  // (a AND b) OR (c IS UNKNOWN)
+  trit_kleene_node_t nodes[5] = {{TRIT_KLEENE_COLUMN, 0, 0}, {TRIT_KLEENE_COLUMN, 1, 0},
+                                 {TRIT_KLEENE_AND, 0, 1}, {TRIT_KLEENE_IS_UNKNOWN, 2, 0}, {TRIT_KLEENE_OR, 2, 3}};
+  // a AND (b OR (c IS UNKNOWN)), which skips b and c where a is FALSE
+  trit_kleene_node_t guarded[6] = {{TRIT_KLEENE_COLUMN, 0, 0}, {TRIT_KLEENE_COLUMN, 1, 0}, {TRIT_KLEENE_COLUMN, 2, 0},
+                                   {TRIT_KLEENE_IS_UNKNOWN, 2, 0}, {TRIT_KLEENE_OR, 1, 3}, {TRIT_KLEENE_AND, 0, 4}};
+  const trit32_t *columns[3] = {a.data(), b.data(), c.data()};
+  const trit32_t *sparse_columns[3] = {sparse.data(), b.data(), c.data()};
+
+  printf("trit kleene, %zu rows, (a AND b) OR (c IS UNKNOWN)\n", rows);
+
+  volatile size_t sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    size_t count = 0;
+
+    for(size_t row = 0; row < rows; row++){
+
+      int result = rows_a[row] < rows_b[row] ? rows_a[row] : rows_b[row];
+
+      result = rows_c[row] == 0 ? 1 : result;
+      count += result == 1;
+    }
+    sink = sink + count;
+  }
+  double row_time = seconds_since(start) / reps / rows;
+  printf("%-24s %8.3f ns/row\n", "one byte per row", row_time * 1e9);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    sink = sink + trit_kleene_eval(nodes, 4, columns, rows, NULL, selection.data());
+  }
+  double time = seconds_since(start) / reps / rows;
+  printf("%-24s %8.3f ns/row (%.1fx)\n", "trit_kleene_eval", time * 1e9, row_time / time);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    sink = sink + trit_kleene_eval(guarded, 5, columns, rows, NULL, selection.data());
+  }
+  double dense_time = seconds_since(start) / reps / rows;
+  printf("%-24s %8.3f ns/row\n", "a AND (b OR c IS UNK)", dense_time * 1e9);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    sink = sink + trit_kleene_eval(guarded, 5, sparse_columns, rows, NULL, selection.data());
+  }
+  time = seconds_since(start) / reps / rows;
+  printf("%-24s %8.3f ns/row (%.1fx)\n", "a FALSE in 15/16 blocks", time * 1e9, dense_time / time);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    trit_kleene_apply_scalar(TRIT_KLEENE_AND, a.data(), b.data(), out.data(), words);
+  }
+  double scalar_time = seconds_since(start) / reps / rows;
+  printf("%-24s %8.3f ns/row\n", "AND scalar", scalar_time * 1e9);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    trit_kleene_apply(TRIT_KLEENE_AND, a.data(), b.data(), out.data(), words);
+  }
+  time = seconds_since(start) / reps / rows;
+  printf("%-24s %8.3f ns/row (%.1fx)\n", "AND", time * 1e9, scalar_time / time);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    sink = sink + trit_kleene_select_scalar(a.data(), rows, selection.data());
+  }
+  scalar_time = seconds_since(start) / reps / rows;
+  printf("%-24s %8.3f ns/row\n", "select scalar", scalar_time * 1e9);
+
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    sink = sink + trit_kleene_select(a.data(), rows, selection.data());
+  }
+  time = seconds_since(start) / reps / rows;
+  printf("%-24s %8.3f ns/row (%.1fx)\n\n", "select", time * 1e9, scalar_time / time);
+}
+
+static void bench_tcam(){
+
+  const size_t lookups = 1 << 14;
+
+  printf("trit tcam, 32 bit keys, half of them built to hit a rule\n");
+
+  for(size_t rules = 1000; rules <= 100000; rules *= 10){
+
+    std::vector<uint64_t> care(rules);
+    std::vector<uint64_t> value(rules);
+    std::vector<int32_t> priority(rules);
+    std::vector<uint64_t> keys(lookups);
+    std::vector<size_t> ids(lookups);
+    trit_tcam_t tcam;
+
+    trit_tcam_init(&tcam, 32, rules);
+
+    for(size_t index = 0; index < rules; index++){
+
+      // clearing the trits nonzero in two other words leaves about 10 of 27 bits that matter
+      trit32_t rule = random_trit32();
+      trit32_t clear = random_trit32() & random_trit32() & 0x5555555555555555ULL;
+
+      rule = rule & ~(clear | (clear << 1));
+      care[index] = 0;
+      value[index] = 0;
+      for(int bit = 0; bit < 32; bit++){
+
+        uint64_t code = (rule >> (2 * bit)) & 3;
+
+        care[index] |= (uint64_t)(code != 0) << bit;
+        value[index] |= (uint64_t)(code == 1) << bit;
+      }
+      priority[index] = rand() % 1000;
+      trit_tcam_insert_trit32_t(&tcam, rule, priority[index]);
+    }
+
+    for(size_t index = 0; index < lookups; index++){
+
+      size_t target = (size_t)rand() % rules;
+      uint64_t noise = (uint64_t)rand() ^ ((uint64_t)rand() << 31);
+
+      keys[index] = index % 2 == 0 ? (value[target] | (noise & ~care[target])) & 0xFFFFFFFF : noise & 0xFFFFFFFF;
+    }
+
+    volatile size_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for(size_t index = 0; index < lookups / 16; index++){
+
+      size_t best = TRIT_TCAM_NONE;
+
+      for(size_t rule = 0; rule < rules; rule++){
+
+        if(((keys[index] ^ value[rule]) & care[rule]) == 0 && (best == TRIT_TCAM_NONE || priority[rule] > priority[best])){
+
+          best = rule;
+        }
+      }
+      sink = sink + best;
+    }
+    double linear_time = seconds_since(start) / (lookups / 16);
+
+    start = std::chrono::steady_clock::now();
+    trit_tcam_lookup_scalar(&tcam, keys.data(), ids.data(), lookups);
+    double scalar_time = seconds_since(start) / lookups;
+
+    start = std::chrono::steady_clock::now();
+    trit_tcam_lookup_array(&tcam, keys.data(), ids.data(), lookups);
+    double time = seconds_since(start) / lookups;
+
+    printf("%6zu rules  linear %10.0f/s  scalar %10.0f/s  tcam %10.0f/s (%.1fx)\n",
+           rules, 1 / linear_time, 1 / scalar_time, 1 / time, linear_time / time);
+
+    trit_tcam_free(&tcam);
+  }
+  printf("\n");
+}
+
+static void bench_circuit(){
+
+  const size_t inputs = 32;
+  const size_t outputs = 16;
+  const size_t count = 1000;
+  const size_t batches = 1 << 14;
+  const size_t wires = inputs + count;
+  std::vector<trit_gate_t> gates(count);
+  std::vector<uint32_t> input_wires(inputs);
+  std::vector<uint32_t> output_wires(outputs);
+  std::vector<trit_slice_t> in(batches * inputs);
+  std::vector<trit_slice_t> out(batches * outputs);
+  std::vector<uint64_t> toggles(wires);
+  trit_circuit_t circuit;
+
+  // every gate reads two wires written before it, mostly recent ones
+  for(size_t index = 0; index < count; index++){
+
+    size_t defined = inputs + index;
+
+    gates[index].op = (trit_gate_op_t)(rand() % 4);
+    gates[index].a = (uint32_t)(defined - 1 - (size_t)rand() % std::min<size_t>(defined, 64));
+    gates[index].b = (uint32_t)((size_t)rand() % defined);
+    gates[index].out = (uint32_t)defined;
+  }
+  for(size_t index = 0; index < inputs; index++){
+
+    input_wires[index] = (uint32_t)index;
+  }
+  for(size_t index = 0; index < outputs; index++){
+
+    output_wires[index] = (uint32_t)(wires - 1 - index);
+  }
+  for(size_t index = 0; index < in.size(); index++){
+
+    uint64_t pos = random_trit32();
+    uint64_t neg = random_trit32();
+
+    in[index].pos = pos & ~neg;
+    in[index].neg = neg & ~pos;
+  }
+  trit_circuit_compile(&circuit, gates.data(), count, wires, input_wires.data(), inputs, output_wires.data(), outputs);
+
+  printf("trit circuit, %zu gates in %zu levels, %zu vectors\n", count, circuit.levels, batches * 64);
+
+  // one vector at a time on trit values
+  const size_t samples = batches;
+  std::vector<int8_t> values(wires);
+  volatile int sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  for(size_t vector = 0; vector < samples; vector++){
+
+    for(size_t index = 0; index < inputs; index++){
+
+      values[index] = (int8_t)trit_slice_get(&in[vector * inputs + index], (int)(vector % 64));
+    }
+    for(size_t index = 0; index < count; index++){
+
+      int a = values[gates[index].a];
+      int b = values[gates[index].b];
+      int result = 0;
+
+      switch(gates[index].op){
+
+        case TRIT_GATE_AND: result = std::min(a, b); break;
+        case TRIT_GATE_OR: result = a == 1 || b == 1 ? 1 : (a == 0 && b == 0 ? 0 : -1); break;
+        case TRIT_GATE_XOR: result = a == b ? -1 : (a + b == 0 ? 1 : 0); break;
+        default: result = -a;
+      }
+      values[gates[index].out] = (int8_t)result;
+    }
+    sink = sink + values[wires - 1];
+  }
+  double vector_time = seconds_since(start) / samples;
+  printf("%-24s %8.2f M vectors/s\n", "one vector at a time", 1e-6 / vector_time);
+
+  start = std::chrono::steady_clock::now();
+  trit_circuit_eval_scalar(&circuit, in.data(), out.data(), batches, NULL);
+  double time = seconds_since(start) / (batches * 64);
+  printf("%-24s %8.2f M vectors/s (%.1fx)\n", "scalar, 1 thread", 1e-6 / time, vector_time / time);
+
+  start = std::chrono::steady_clock::now();
+  trit_circuit_eval(&circuit, in.data(), out.data(), batches, NULL, 1);
+  time = seconds_since(start) / (batches * 64);
+  printf("%-24s %8.2f M vectors/s (%.1fx)\n", "eval, 1 thread", 1e-6 / time, vector_time / time);
+
+  start = std::chrono::steady_clock::now();
+  trit_circuit_eval(&circuit, in.data(), out.data(), batches, NULL, 0);
+  time = seconds_since(start) / (batches * 64);
+  printf("%-24s %8.2f M vectors/s (%.1fx)\n", "eval, all threads", 1e-6 / time, vector_time / time);
+
+  start = std::chrono::steady_clock::now();
+  trit_circuit_eval(&circuit, in.data(), out.data(), batches, toggles.data(), 0);
+  time = seconds_since(start) / (batches * 64);
+  printf("%-24s %8.2f M vectors/s (%.1fx)\n\n", "toggles, all threads", 1e-6 / time, vector_time / time);
+
+  trit_circuit_free(&circuit);
+}
+
+static void bench_vm(){
+
+  const int64_t loops = 20000000;
+  trit_vm_t vm;
+
+  // a loop of adds, trit logic, a load and a store, 8 instructions per pass
+  trit32_t code[11] = {trit_vm_encode(TRIT_VM_LDI, 1, 0, 0, loops),
+                       trit_vm_encode(TRIT_VM_LDI, 2, 0, 0, 0),
+                       trit_vm_encode(TRIT_VM_LDI, 5, 0, 0, 7),
+                       trit_vm_encode(TRIT_VM_ADD, 2, 2, 1, 0),
+                       trit_vm_encode(TRIT_VM_XOR, 3, 2, 5, 0),
+                       trit_vm_encode(TRIT_VM_AND, 4, 3, 1, 0),
+                       trit_vm_encode(TRIT_VM_ST, 4, 0, 0, 200),
+                       trit_vm_encode(TRIT_VM_LD, 6, 0, 0, 200),
+                       trit_vm_encode(TRIT_VM_OR, 5, 5, 6, 0),
+                       trit_vm_encode(TRIT_VM_ADDI, 1, 1, 0, -1),
+                       trit_vm_encode(TRIT_VM_JP, 0, 1, 0, 12)};
+
+  trit_vm_init(&vm, 256);
+  trit_vm_load(&vm, 0, code, 11);
+
+  printf("trit vm, %lld passes of an 8 instruction loop\n", (long long)loops);
+
+  // decode every instruction as it runs and call the ternary.c functions
+  const int64_t naive_loops = loops / 20;
+  trit32_t regs[TRIT_VM_REGISTERS] = {0};
+  uint64_t naive_steps = 0;
+  size_t pc = 0;
+  regs[1] = binary_to_balanced_ternary_trit32_t(naive_loops);
+  pc = 12;
+  auto start = std::chrono::steady_clock::now();
+  for(;;){
+
+    trit32_t word = 0;
+
+    if(!trit_vm_read(&vm, pc, &word) || word == 0){
+
+      break;
+    }
+    int op = (int)balanced_ternary_to_binary_int64_t(word & 0xFF);
+    int rd = (int)balanced_ternary_to_binary_int64_t((word >> 8) & 0xF) + 4;
+    int ra = (int)balanced_ternary_to_binary_int64_t((word >> 12) & 0xF) + 4;
+    int rb = (int)balanced_ternary_to_binary_int64_t((word >> 16) & 0xF) + 4;
+    int64_t imm = balanced_ternary_to_binary_int64_t(word >> 20);
+
+    naive_steps++;
+    pc += 4;
+    switch(op){
+
+      case TRIT_VM_ADD: regs[rd] = trit_add_wrap_trit32_t(regs[ra], regs[rb]); break;
+      case TRIT_VM_ADDI: regs[rd] = trit_add_wrap_trit32_t(regs[ra], word >> 20); break;
+      case TRIT_VM_XOR: regs[rd] = trit_xor_trit32_t(regs[ra], regs[rb]); break;
+      case TRIT_VM_AND: regs[rd] = trit_and_trit32_t(regs[ra], regs[rb]); break;
+      case TRIT_VM_OR: regs[rd] = trit_or_trit32_t(regs[ra], regs[rb]); break;
+      case TRIT_VM_ST: trit_vm_write(&vm, (size_t)imm, regs[rd]); break;
+      case TRIT_VM_LD: trit_vm_read(&vm, (size_t)imm, &regs[rd]); break;
+      case TRIT_VM_JP: pc = balanced_ternary_to_binary_int64_t(regs[ra]) > 0 ? (size_t)imm : pc; break;
+      default: break;
+    }
+  }
+  double naive_time = seconds_since(start) / naive_steps;
+  printf("%-24s %8.1f M instructions/s\n", "decode every time", 1e-6 / naive_time);
+
+  vm.pc = 0;
+  start = std::chrono::steady_clock::now();
+  trit_vm_run(&vm, 0);
+  double time = seconds_since(start) / vm.steps;
+  printf("%-24s %8.1f M instructions/s (%.1fx)\n\n", "trit vm", 1e-6 / time, naive_time / time);
+
+  trit_vm_free(&vm);
+}
+
+#define BENCH_QUANT(name, call, bytes)                                       \
+  do {                                                                       \
+    auto start = std::chrono::steady_clock::now();                           \
+    for(int rep = 0; rep < reps; rep++){                                     \
+      call;                                                                  \
+    }                                                                        \
+    double time = seconds_since(start) / reps;                               \
+    printf("%-24s %8.2f GB/s (%.1fx)\n", name, (bytes) / time / 1e9,        \
+           baseline / time);                                                 \
+  } while(0)
+
+static void bench_quant(){
+
+  const size_t n = 1 << 24;
+  const int reps = 10;
+  const float threshold = 0.35f;
+
+  std::vector<float> values(n);
+  std::vector<uint16_t> halves(n);
+  std::vector<float> restored(n);
+  std::vector<trit32_t> trits(n / 32);
+
+  for(size_t index = 0; index < n; index++){
+
+    uint32_t bits = 0;
+
+    values[index] = (float)rand() / RAND_MAX - 0.5f;
+    memcpy(&bits, &values[index], sizeof(bits));
+    halves[index] = bits >> 16;
+  }
+
+  printf("trit quantize, %zu values, GB/s of floats or bfloat16 read or floats written\n", n);
+
+  // one value at a time, setting its trit in place
+  auto start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    std::fill(trits.begin(), trits.end(), 0);
+    for(size_t index = 0; index < n; index++){
+
+      if(values[index] > threshold){
+
+        trits[index / 32] |= (trit32_t)1 << (2 * (index % 32));
+      }
+      else if(values[index] < -threshold){
+
+        trits[index / 32] |= (trit32_t)3 << (2 * (index % 32));
+      }
+    }
+  }
+  double baseline = seconds_since(start) / reps;
+  printf("%-24s %8.2f GB/s\n", "one at a time float", n * sizeof(float) / baseline / 1e9);
+
+  BENCH_QUANT("scalar float", trit_quantize_scalar_float(values.data(), n, threshold, trits.data()), n * sizeof(float));
+  if(__builtin_cpu_supports("avx2")){
+
+    BENCH_QUANT("avx2 float", trit_quantize_avx2_float(values.data(), n, threshold, trits.data()), n * sizeof(float));
+    BENCH_QUANT("avx2 bf16", trit_quantize_avx2_bf16(halves.data(), n, threshold, trits.data()), n * sizeof(uint16_t));
+  }
+  if(__builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("bmi2")){
+
+    BENCH_QUANT("avx512 float", trit_quantize_avx512_float(values.data(), n, threshold, trits.data()), n * sizeof(float));
+    BENCH_QUANT("avx512 bf16", trit_quantize_avx512_bf16(halves.data(), n, threshold, trits.data()), n * sizeof(uint16_t));
+  }
+  BENCH_QUANT("threads float", trit_quantize_float(values.data(), n, threshold, trits.data(), 0), n * sizeof(float));
+  BENCH_QUANT("threads bf16", trit_quantize_bf16(halves.data(), n, threshold, trits.data(), 0), n * sizeof(uint16_t));
+
+  // one trit at a time back to floats
+  start = std::chrono::steady_clock::now();
+  for(int rep = 0; rep < reps; rep++){
+
+    for(size_t index = 0; index < n; index++){
+
+      trit32_t trit = (trits[index / 32] >> (2 * (index % 32))) & 3;
+
+      restored[index] = trit == 1 ? 1.0f : (trit == 3 ? -1.0f : 0.0f);
+    }
+  }
+  baseline = seconds_since(start) / reps;
+  printf("%-24s %8.2f GB/s\n", "one at a time dequant", n * sizeof(float) / baseline / 1e9);
+
+  BENCH_QUANT("scalar dequant", trit_dequantize_scalar_float(trits.data(), n, 1.0f, restored.data()), n * sizeof(float));
+  if(__builtin_cpu_supports("avx2")){
+
+    BENCH_QUANT("avx2 dequant", trit_dequantize_avx2_float(trits.data(), n, 1.0f, restored.data()), n * sizeof(float));
+  }
+  if(__builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("bmi2")){
+
+    BENCH_QUANT("avx512 dequant", trit_dequantize_avx512_float(trits.data(), n, 1.0f, restored.data()), n * sizeof(float));
+  }
+  BENCH_QUANT("threads dequant", trit_dequantize_float(trits.data(), n, 1.0f, restored.data(), 0), n * sizeof(float));
+  printf("\n");
+}
+
+// random packed trits with about one in every period nonzero
+static void random_sparse(std::vector<trit32_t> &trits, int period){
+
+  std::fill(trits.begin(), trits.end(), 0);
+  for(size_t index = 0; index < trits.size() * 32; index++){
+
+    int grab = rand() % (2 * period);
+
+    if(grab < 2){
+
+      trits[index / 32] |= (trit32_t)(grab == 0 ? 1 : 3) << (2 * (index % 32));
+    }
+  }
+}
+
+static void bench_sparse(){
+
+  const size_t n = 1 << 20;
+  const int reps = 50;
+  const int periods[8] = {2000, 200, 100, 50, 20, 10, 4, 2};
+  static const int8_t add_table[9] = {-1, -1, 0, -1, 0, 1, 0, 1, 1};
+
+  std::vector<trit32_t> a(n / 32);
+  std::vector<trit32_t> b(n / 32);
+  std::vector<trit32_t> out(n / 32);
+  std::vector<float> act(n);
+  trit_lut2_t add;
+
+  trit_lut2_compile(&add, add_table);
+  for(size_t index = 0; index < n; index++){
+
+    act[index] = (float)rand() / RAND_MAX;
+  }
+
+  printf("trit sparse, %zu trits, times in us, packed / sparse\n", n);
+  printf("%-9s %6s %16s %16s %16s %8s\n", "nonzero", "form", "dot float", "dot trits", "saturating add", "convert");
+
+  for(int period : periods){
+
+    trit_sparse_t sa, sb, sum;
+    trit_vector_t vector;
+    volatile double sink = 0;
+
+    random_sparse(a, period);
+    random_sparse(b, period);
+
+    auto start = std::chrono::steady_clock::now();
+    for(int rep = 0; rep < reps; rep++){
+
+      trit_sparse_from_packed(&sa, a.data(), n);
+      if(rep + 1 < reps){
+
+        trit_sparse_free(&sa);
+      }
+    }
+    double convert = seconds_since(start) / reps;
+    trit_sparse_from_packed(&sb, b.data(), n);
+    trit_vector_from_packed(&vector, a.data(), n);
+
+    start = std::chrono::steady_clock::now();
+    for(int rep = 0; rep < reps; rep++){
+
+      sink = sink + trit_dot_float(a.data(), act.data(), n);
+    }
+    double dense_float = seconds_since(start) / reps;
+    start = std::chrono::steady_clock::now();
+    for(int rep = 0; rep < reps; rep++){
+
+      sink = sink + trit_sparse_dot_float(&sa, act.data());
+    }
+    double sparse_float = seconds_since(start) / reps;
+
+    start = std::chrono::steady_clock::now();
+    for(int rep = 0; rep < reps; rep++){
+
+      sink = sink + trit_similarity_array(a.data(), b.data(), n / 32);
+    }
+    double dense_dot = seconds_since(start) / reps;
+    start = std::chrono::steady_clock::now();
+    for(int rep = 0; rep < reps; rep++){
+
+      sink = sink + trit_sparse_dot(&sa, &sb);
+    }
+    double sparse_dot = seconds_since(start) / reps;
+
+    start = std::chrono::steady_clock::now();
+    for(int rep = 0; rep < reps; rep++){
+
+      trit_lut2_array(&add, a.data(), b.data(), out.data(), n / 32);
+    }
+    double dense_add = seconds_since(start) / reps;
+    start = std::chrono::steady_clock::now();
+    for(int rep = 0; rep < reps; rep++){
+
+      trit_sparse_add(&sa, &sb, &sum);
+      trit_sparse_free(&sum);
+    }
+    double sparse_add = seconds_since(start) / reps;
+
+    char density[16];
+    snprintf(density, sizeof(density), "%.1f%%", 100.0 * trit_sparse_count(&sa) / n);
+    printf("%-9s %6s %7.1f /%7.1f %7.1f /%7.1f %7.1f /%7.1f %8.1f\n", density, vector.is_sparse ? "sparse" : "packed",
+           dense_float * 1e6, sparse_float * 1e6, dense_dot * 1e6, sparse_dot * 1e6,
+           dense_add * 1e6, sparse_add * 1e6, convert * 1e6);
+
+    trit_vector_free(&vector);
+    trit_sparse_free(&sa);
+    trit_sparse_free(&sb);
+  }
+  printf("\n");
+}
+
+// packed trits, each 0 with probability zeros and otherwise +1 or -1
+static void random_skewed(std::vector<trit32_t> &trits, double zeros){
+
+  for(size_t word = 0; word < trits.size(); word++){
+
+    trit32_t result = 0;
+
+    for(int index = 0; index < 32; index++){
+
+      double grab = (double)rand() / RAND_MAX;
+      result = (result << 2) | (grab < zeros ? 0 : (grab < (1 + zeros) / 2 ? 0b01 : 0b11));
+    }
+    trits[word] = result;
+  }
+}
+
+static void bench_codec(){
+
+  const size_t n = 1 << 24;
+  const int reps = 5;
+  const double zeros[4] = {1.0 / 3, 0.6, 0.9, 0.99};
+
+  std::vector<trit32_t> trits(n / 32);
+  std::vector<trit32_t> decoded(n / 32);
+  std::vector<uint8_t> encoded(trit_codec_bound(n));
+  std::vector<uint8_t> deflated(compressBound(n / 4));
+
+  printf("trit codec, %zu trits, sizes in bits/trit, speeds in MB/s of packed trits\n", n);
+  printf("%-7s %7s %7s %7s %7s %7s %7s %9s %9s %9s\n", "zeros", "entropy", "codec", "encode", "decode",
+         "threads", "zlib -1", "zlib enc", "zlib dec", "zlib -9");
+
+  for(double zero : zeros){
+
+    double entropy = -zero * log2(zero) - (1 - zero) * log2((1 - zero) / 2);
+    size_t size = 0;
+    uLongf deflated_size = deflated.size();
+    uLongf inflated_size = n / 4;
+    volatile bool sink = true;
+
+    random_skewed(trits, zero);
+
+    auto start = std::chrono::steady_clock::now();
+    for(int rep = 0; rep < reps; rep++){
+
+      size = trit_codec_encode(trits.data(), n, encoded.data(), encoded.size(), 1);
+    }
+    double encode = seconds_since(start) / reps;
+    start = std::chrono::steady_clock::now();
+    for(int rep = 0; rep < reps; rep++){
+
+      sink = sink && trit_codec_decode(encoded.data(), size, decoded.data(), n, 1);
+    }
+    double decode = seconds_since(start) / reps;
+    start = std::chrono::steady_clock::now();
+    for(int rep = 0; rep < reps; rep++){
+
+      sink = sink && trit_codec_decode(encoded.data(), size, decoded.data(), n, 0);
+    }
+    double threaded = seconds_since(start) / reps;
+    sink = sink && memcmp(trits.data(), decoded.data(), n / 4) == 0;
+
+    // the general purpose baseline on the same packed bytes
+    start = std::chrono::steady_clock::now();
+    compress2(deflated.data(), &deflated_size, (const Bytef *)trits.data(), n / 4, 1);
+    double deflate = seconds_since(start);
+    start = std::chrono::steady_clock::now();
+    for(int rep = 0; rep < reps; rep++){
+
+      inflated_size = n / 4;
+      uncompress((Bytef *)decoded.data(), &inflated_size, deflated.data(), deflated_size);
+    }
+    double inflate = seconds_since(start) / reps;
+    double fast_bits = 8.0 * deflated_size / n;
+    deflated_size = deflated.size();
+    compress2(deflated.data(), &deflated_size, (const Bytef *)trits.data(), n / 4, 9);
+
+    char label[16];
+    snprintf(label, sizeof(label), "%.0f%%%s", 100 * zero, sink ? "" : " BAD");
+    printf("%-7s %7.3f %7.3f %7.0f %7.0f %7.0f %7.3f %9.0f %9.0f %9.3f\n", label, entropy, 8.0 * size / n,
+           n / 4 / encode / 1e6, n / 4 / decode / 1e6, n / 4 / threaded / 1e6,
+           fast_bits, n / 4 / deflate / 1e6, n / 4 / inflate / 1e6, 8.0 * deflated_size / n);
+  }
+  printf("plain packing is 2 bits/trit, base 3 alone 1.6, %d threads\n\n", trit_thread_count(0));
+}
+
+int main(){
+
+  bench_dot();
+  bench_gemv();
+  bench_metric();
+  bench_convert();
+  bench_add();
+  bench_sum();
+  bench_scan();
+  bench_hash();
+  bench_fixed();
+  bench_float();
+  bench_mod();
+  bench_sat();
+  bench_lut();
+  bench_kleene();
+  bench_tcam();
+  bench_circuit();
+  bench_vm();
+  bench_quant();
+  bench_sparse();
+  bench_codec();
+
+  return 0;
+}
@@ -0,0 +1,903 @@
+/**
+ * @file ternary_circuit.c
+ *
+ * @brief File contains a bit-sliced simulator for circuits of
+ * ternary gates.
+ *
+ * A trit_slice_t holds one wire across 64 test vectors as two
+ * bit planes, so one gate is evaluated for 64 vectors with a
+ * few logic instructions. The AVX2 kernel takes 4 slices, 256
+ * vectors, per instruction.
+ *
+ * A netlist is compiled once. The gates are levelized, every
+ * gate gets a level one above its deepest input, and are laid
+ * out by level as a flat array of instructions that read and
+ * write slots of a scratch array instead of wire ids. The
+ * inputs take the first slots and every gate output the next
+ * one in order, so a gate mostly reads slots written shortly
+ * before it. Stuck-at faults become extra instructions right
+ * after the one writing the faulty wire.
+ *
+ * Toggles are counted between neighbouring vectors of a slice,
+ * lane j against lane j + 1, so every slice is read as its own
+ * run of 64 vectors and the counts do not depend on how the
+ * slices are split between threads.
+ */
+
+
+#include<stdlib.h>
+#include<string.h>
+
+#include"ternary_circuit.h"
+#include"ternary_thread.h"
+#include"ternary_cpu.h"
+
+#define NO_DRIVER UINT32_MAX /**< The driver of a wire not driven yet */
+#define INPUT_DRIVER (UINT32_MAX - 1) /**< The driver of a circuit input */
+#define TOGGLE_LANES 0x7FFFFFFFFFFFFFFFULL /**< The lanes with a next lane in the same slice */
+#define BLOCK_BATCHES 64 /**< The smallest number of slices one thread evaluates at a time */
+#define MAX_BLOCKS 256 /**< The most blocks, bounds the toggle counts kept per block */
+
+/**
+ * @brief Evaluates one gate on 64 vectors.
+ *
+ * @param[in] op The gate, not TRIT_GATE_FORCE.
+ *
+ * @param[in] a The first input.
+ *
+ * @param[in] b The second input.
+ *
+ * @return The output of the gate
+ */
+static trit_slice_t gate_slice(trit_gate_op_t op, trit_slice_t a, trit_slice_t b){
+
+    trit_slice_t result = {0, 0};
+
+    switch(op){
+
+        case TRIT_GATE_AND:
+            result.pos = a.pos & b.pos;
+            result.neg = a.neg | b.neg;
+            break;
+        case TRIT_GATE_OR:
+            result.pos = a.pos | b.pos;
+            result.neg = (a.neg | b.neg) & ~result.pos;
+            break;
+        case TRIT_GATE_XOR:
+            result.pos = (a.pos & b.neg) | (a.neg & b.pos);
+            result.neg = (a.pos & b.pos) | (a.neg & b.neg) | ~(a.pos | a.neg | b.pos | b.neg);
+            break;
+        default:
+            result.pos = a.neg;
+            result.neg = a.pos;
+    }
+
+    return result;
+}
+
+/**
+ * @brief Reads one vector of a slice.
+ *
+ * @param[in] slice The slice.
+ *
+ * @param[in] lane The vector, 0 to 63.
+ *
+ * @return The trit of the wire in vector @p lane, -1, 0 or 1
+ */
+int trit_slice_get(const trit_slice_t *slice, int lane){
+
+    return (int)((slice->pos >> lane) & 1) - (int)((slice->neg >> lane) & 1);
+}
+
+/**
+ * @brief Writes one vector of a slice.
+ *
+ * @param[in,out] slice The slice.
+ *
+ * @param[in] lane The vector, 0 to 63.
+ *
+ * @param[in] value The trit, -1, 0 or 1.
+ */
+void trit_slice_set(trit_slice_t *slice, int lane, int value){
+
+    uint64_t bit = 1ULL << lane;
+
+    slice->pos = value > 0 ? slice->pos | bit : slice->pos & ~bit;
+    slice->neg = value < 0 ? slice->neg | bit : slice->neg & ~bit;
+}
+
+/**
+ * @brief Lays the schedule and the faults out as one program.
+ *
+ * The faults on an input come first, the faults on a gate
+ * output right after the gate, each in the order added.
+ *
+ * @param[in,out] circuit The circuit, @c program must have room
+ * for @c gates + @c fault_count instructions.
+ */
+static void build_program(trit_circuit_t *circuit){
+
+    size_t count = 0;
+    size_t index = 0;
+    size_t fault = 0;
+    uint32_t slot = 0;
+
+    for(index = 0; index <= circuit->gates; index++){
+
+        if(index != 0){
+
+            circuit->program[count++] = circuit->schedule[index - 1];
+        }
+
+        for(fault = 0; fault < circuit->fault_count; fault++){
+
+            slot = circuit->wire_slots[circuit->faults[fault].wire];
+
+            if(index == 0 ? slot < circuit->inputs : slot == circuit->schedule[index - 1].out){
+
+                circuit->program[count].op = TRIT_GATE_FORCE;
+                circuit->program[count].a = (uint32_t)fault;
+                circuit->program[count].b = 0;
+                circuit->program[count].out = slot;
+                count++;
+            }
+        }
+    }
+
+    circuit->instructions = count;
+}
+
+/**
+ * @brief Finds the driver of every wire.
+ *
+ * @param[in] gates The gates, on wire ids.
+ *
+ * @param[in] count The number of gates.
+ *
+ * @param[in] wires The number of wires.
+ *
+ * @param[in] inputs The wires of the circuit inputs.
+ *
+ * @param[in] input_count The number of inputs.
+ *
+ * @param[out] drivers The gate driving every wire, or
+ * INPUT_DRIVER for a circuit input.
+ *
+ * @return false if a wire id is out of range or a wire has no
+ * driver or more than one
+ */
+static bool find_drivers(const trit_gate_t *gates, size_t count, size_t wires,
+                         const uint32_t *inputs, size_t input_count, uint32_t *drivers){
+
+    size_t index = 0;
+
+    for(index = 0; index < wires; index++){
+
+        drivers[index] = NO_DRIVER;
+    }
+
+    for(index = 0; index < input_count; index++){
+
+        if(inputs[index] >= wires || drivers[inputs[index]] != NO_DRIVER){
+
+            return false;
+        }
+
+        drivers[inputs[index]] = INPUT_DRIVER;
+    }
+
+    for(index = 0; index < count; index++){
+
+        if(gates[index].op > TRIT_GATE_NOT || gates[index].out >= wires || gates[index].a >= wires ||
+           (gates[index].op != TRIT_GATE_NOT && gates[index].b >= wires) || drivers[gates[index].out] != NO_DRIVER){
+
+            return false;
+        }
+
+        drivers[gates[index].out] = (uint32_t)index;
+    }
+
+    for(index = 0; index < wires; index++){
+
+        if(drivers[index] == NO_DRIVER){
+
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Sorts the gates by level.
+ *
+ * A gate is ready once every gate driving one of its inputs is
+ * scheduled, the gates made ready by one level form the next.
+ *
+ * @param[in] gates The gates, on wire ids.
+ *
+ * @param[in] count The number of gates.
+ *
+ * @param[in] wires The number of wires.
+ *
+ * @param[in] drivers The driver of every wire, see @c find_drivers.
+ *
+ * @param[out] order The gates level by level.
+ *
+ * @param[out] levels The number of levels.
+ *
+ * @return false if the gates form a loop or the memory could
+ * not be allocated
+ */
+static bool levelize(const trit_gate_t *gates, size_t count, size_t wires, const uint32_t *drivers,
+                     uint32_t *order, size_t *levels){
+
+    uint32_t *waiting = (uint32_t *)calloc(count + 1, sizeof(uint32_t));
+    uint32_t *users = (uint32_t *)malloc((2 * count + 1) * sizeof(uint32_t));
+    uint32_t *user_start = (uint32_t *)calloc(wires + 2, sizeof(uint32_t));
+    size_t ready = 0;
+    size_t level_start = 0;
+    size_t level_end = 0;
+    size_t index = 0;
+    size_t operand = 0;
+    uint32_t wire = 0;
+    uint32_t gate = 0;
+
+    *levels = 0;
+
+    if(waiting == NULL || users == NULL || user_start == NULL){
+
+        free(waiting);
+        free(users);
+        free(user_start);
+        return false;
+    }
+
+    // count the inputs driven by gates and list the users of every wire
+    for(index = 0; index < count; index++){
+
+        for(operand = 0; operand < (gates[index].op == TRIT_GATE_NOT ? 1u : 2u); operand++){
+
+            wire = operand == 0 ? gates[index].a : gates[index].b;
+            user_start[wire + 1]++;
+            waiting[index] += drivers[wire] != INPUT_DRIVER;
+        }
+    }
+
+    for(index = 0; index < wires; index++){
+
+        user_start[index + 1] += user_start[index];
+    }
+
+    for(index = 0; index < count; index++){
+
+        for(operand = 0; operand < (gates[index].op == TRIT_GATE_NOT ? 1u : 2u); operand++){
+
+            wire = operand == 0 ? gates[index].a : gates[index].b;
+            users[user_start[wire]++] = (uint32_t)index;
+        }
+    }
+
+    for(index = wires; index > 0; index--){
+
+        user_start[index] = user_start[index - 1];
+    }
+    user_start[0] = 0;
+
+    for(index = 0; index < count; index++){
+
+        if(waiting[index] == 0){
+
+            order[ready++] = (uint32_t)index;
+        }
+    }
+
+    while(level_start < ready){
+
+        level_end = ready;
+        (*levels)++;
+
+        for(index = level_start; index < level_end; index++){
+
+            wire = gates[order[index]].out;
+
+            for(operand = user_start[wire]; operand < user_start[wire + 1]; operand++){
+
+                gate = users[operand];
+
+                if(--waiting[gate] == 0){
+
+                    order[ready++] = gate;
+                }
+            }
+        }
+
+        level_start = level_end;
+    }
+
+    free(waiting);
+    free(users);
+    free(user_start);
+
+    return ready == count;
+}
+
+/**
+ * @brief Compiles a netlist for bit-sliced evaluation.
+ *
+ * Every wire must be driven by exactly one circuit input or
+ * gate output, and the gates may not form a loop.
+ *
+ * @param[out] circuit The compiled circuit, free it with
+ * @c trit_circuit_free.
+ *
+ * @param[in] gates The gates, on wire ids.
+ *
+ * @param[in] count The number of gates.
+ *
+ * @param[in] wires The number of wires, the ids are 0 to
+ * @p wires - 1.
+ *
+ * @param[in] inputs The wires of the circuit inputs.
+ *
+ * @param[in] input_count The number of inputs.
+ *
+ * @param[in] outputs The wires of the circuit outputs.
+ *
+ * @param[in] output_count The number of outputs.
+ *
+ * @return false if a wire id is out of range, a wire has no
+ * driver or more than one, the gates form a loop or the
+ * circuit could not be allocated
+ */
+bool trit_circuit_compile(trit_circuit_t *circuit, const trit_gate_t *gates, size_t count, size_t wires,
+                          const uint32_t *inputs, size_t input_count, const uint32_t *outputs, size_t output_count){
+
+    uint32_t *drivers = NULL;
+    uint32_t *order = NULL;
+    size_t index = 0;
+    uint32_t wire = 0;
+    bool ok = false;
+
+    memset(circuit, 0, sizeof(*circuit));
+
+    if(wires >= INPUT_DRIVER || count >= INPUT_DRIVER){
+
+        return false;
+    }
+
+    drivers = (uint32_t *)malloc((wires + 1) * sizeof(uint32_t));
+    order = (uint32_t *)malloc((count + 1) * sizeof(uint32_t));
+    circuit->schedule = (trit_gate_t *)malloc((count + 1) * sizeof(trit_gate_t));
+    circuit->program = (trit_gate_t *)malloc((count + 1) * sizeof(trit_gate_t));
+    circuit->slot_wires = (uint32_t *)malloc((wires + 1) * sizeof(uint32_t));
+    circuit->wire_slots = (uint32_t *)malloc((wires + 1) * sizeof(uint32_t));
+    circuit->output_slots = (uint32_t *)malloc((output_count + 1) * sizeof(uint32_t));
+
+    ok = drivers != NULL && order != NULL && circuit->schedule != NULL && circuit->program != NULL &&
+         circuit->slot_wires != NULL && circuit->wire_slots != NULL && circuit->output_slots != NULL &&
+         find_drivers(gates, count, wires, inputs, input_count, drivers) &&
+         levelize(gates, count, wires, drivers, order, &circuit->levels);
+
+    for(index = 0; ok && index < output_count; index++){
+
+        ok = outputs[index] < wires;
+    }
+
+    if(!ok){
+
+        free(drivers);
+        free(order);
+        trit_circuit_free(circuit);
+        return false;
+    }
+
+    // the inputs take the first slots, then the gate outputs in schedule order
+    for(index = 0; index < input_count; index++){
+
+        circuit->wire_slots[inputs[index]] = (uint32_t)index;
+        circuit->slot_wires[index] = inputs[index];
+    }
+
+    for(index = 0; index < count; index++){
+
+        wire = gates[order[index]].out;
+        circuit->wire_slots[wire] = (uint32_t)(input_count + index);
+        circuit->slot_wires[input_count + index] = wire;
+    }
+
+    for(index = 0; index < count; index++){
+
+        circuit->schedule[index].op = gates[order[index]].op;
+        circuit->schedule[index].a = circuit->wire_slots[gates[order[index]].a];
+        circuit->schedule[index].b = gates[order[index]].op == TRIT_GATE_NOT ? circuit->schedule[index].a :
+                                     circuit->wire_slots[gates[order[index]].b];
+        circuit->schedule[index].out = circuit->wire_slots[gates[order[index]].out];
+    }
+
+    for(index = 0; index < output_count; index++){
+
+        circuit->output_slots[index] = circuit->wire_slots[outputs[index]];
+    }
+
+    circuit->gates = count;
+    circuit->wires = wires;
+    circuit->inputs = input_count;
+    circuit->outputs = output_count;
+    build_program(circuit);
+
+    free(drivers);
+    free(order);
+
+    return true;
+}
+
+/**
+ * @brief Frees the memory of a circuit.
+ *
+ * @param[in,out] circuit The circuit, left empty.
+ */
+void trit_circuit_free(trit_circuit_t *circuit){
+
+    free(circuit->schedule);
+    free(circuit->program);
+    free(circuit->faults);
+    free(circuit->slot_wires);
+    free(circuit->wire_slots);
+    free(circuit->output_slots);
+    memset(circuit, 0, sizeof(*circuit));
+}
+
+/**
+ * @brief Adds a stuck-at fault.
+ *
+ * The wire reads @p value in the vectors of @p lanes, for every
+ * gate it feeds and as a circuit output. Different lanes can
+ * carry different faults, which simulates up to 64 faulty
+ * copies of the circuit in one pass. A later fault on the same
+ * wire and lane wins.
+ *
+ * @param[in,out] circuit The circuit.
+ *
+ * @param[in] wire The faulty wire.
+ *
+ * @param[in] value The value it is stuck at, -1, 0 or 1.
+ *
+ * @param[in] lanes The vectors of every slice the fault
+ * applies to.
+ *
+ * @return false if @p wire is out of range or the memory could
+ * not be allocated, the circuit is unchanged then
+ */
+bool trit_circuit_fault(trit_circuit_t *circuit, uint32_t wire, int value, uint64_t lanes){
+
+    trit_fault_t *faults = NULL;
+    trit_gate_t *program = NULL;
+
+    if(wire >= circuit->wires){
+
+        return false;
+    }
+
+    faults = (trit_fault_t *)realloc(circuit->faults, (circuit->fault_count + 1) * sizeof(trit_fault_t));
+    if(faults == NULL){
+
+        return false;
+    }
+    circuit->faults = faults;
+
+    program = (trit_gate_t *)realloc(circuit->program, (circuit->gates + circuit->fault_count + 1) * sizeof(trit_gate_t));
+    if(program == NULL){
+
+        return false;
+    }
+    circuit->program = program;
+
+    faults[circuit->fault_count].wire = wire;
+    faults[circuit->fault_count].lanes = lanes;
+    faults[circuit->fault_count].pos = value > 0 ? lanes : 0;
+    faults[circuit->fault_count].neg = value < 0 ? lanes : 0;
+    circuit->fault_count++;
+    build_program(circuit);
+
+    return true;
+}
+
+/**
+ * @brief Removes every fault.
+ *
+ * @param[in,out] circuit The circuit.
+ */
+void trit_circuit_clear_faults(trit_circuit_t *circuit){
+
+    circuit->fault_count = 0;
+    build_program(circuit);
+}
+
+// SCALAR CIRCUIT KERNELS
+
+/**
+ * @brief Evaluates a circuit one slice at a time.
+ *
+ * @param[in] circuit The compiled circuit.
+ *
+ * @param[in] inputs @c circuit->inputs slices per batch of 64
+ * vectors, batch by batch.
+ *
+ * @param[out] outputs @c circuit->outputs slices per batch,
+ * batch by batch.
+ *
+ * @param[in] batches The number of batches.
+ *
+ * @param[in,out] toggles NULL, or one count per wire that the
+ * toggles of the wire are added to.
+ *
+ * @return false if the scratch memory could not be allocated
+ */
+bool trit_circuit_eval_scalar(const trit_circuit_t *circuit, const trit_slice_t *inputs, trit_slice_t *outputs,
+                              size_t batches, uint64_t *toggles){
+
+    trit_slice_t *slots = (trit_slice_t *)malloc((circuit->wires + 1) * sizeof(trit_slice_t));
+    const trit_gate_t *program = circuit->program;
+    const trit_fault_t *fault = NULL;
+    uint64_t diff = 0;
+    size_t batch = 0;
+    size_t index = 0;
+
+    if(slots == NULL){
+
+        return false;
+    }
+
+    for(batch = 0; batch < batches; batch++){
+
+        memcpy(slots, inputs + batch * circuit->inputs, circuit->inputs * sizeof(trit_slice_t));
+
+        for(index = 0; index < circuit->instructions; index++){
+
+            if(program[index].op == TRIT_GATE_FORCE){
+
+                fault = &circuit->faults[program[index].a];
+                slots[program[index].out].pos = (slots[program[index].out].pos & ~fault->lanes) | fault->pos;
+                slots[program[index].out].neg = (slots[program[index].out].neg & ~fault->lanes) | fault->neg;
+            }
+            else{
+
+                slots[program[index].out] = gate_slice(program[index].op, slots[program[index].a], slots[program[index].b]);
+            }
+        }
+
+        for(index = 0; index < circuit->outputs; index++){
+
+            outputs[batch * circuit->outputs + index] = slots[circuit->output_slots[index]];
+        }
+
+        if(toggles != NULL){
+
+            for(index = 0; index < circuit->wires; index++){
+
+                diff = (slots[index].pos ^ (slots[index].pos >> 1)) | (slots[index].neg ^ (slots[index].neg >> 1));
+                toggles[circuit->slot_wires[index]] += (uint64_t)__builtin_popcountll(diff & TOGGLE_LANES);
+            }
+        }
+    }
+
+    free(slots);
+
+    return true;
+}
+
+#ifdef TERNARY_X86_64
+// AVX2 CIRCUIT KERNELS
+
+/**
+ * @brief Counts the set bits of every byte.
+ *
+ * @param[in] x The vector.
+ *
+ * @return The count of every 64 bit lane of @p x, in that lane
+ */
+__attribute__((target("avx2"), always_inline))
+static inline __m256i popcount_lanes(__m256i x){
+
+    const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                           0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    __m256i low = _mm256_shuffle_epi8(table, _mm256_and_si256(x, nibble));
+    __m256i high = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(x, 4), nibble));
+
+    return _mm256_sad_epu8(_mm256_add_epi8(low, high), _mm256_setzero_si256());
+}
+
+/**
+ * @brief Evaluates a circuit 4 slices at a time with AVX2.
+ *
+ * Every slot holds the same wire of 4 batches in one vector per
+ * bit plane, so one pass over the program evaluates 256
+ * vectors. Leftover batches go to the scalar kernel.
+ *
+ * @param[in] circuit The compiled circuit.
+ *
+ * @param[in] inputs @c circuit->inputs slices per batch of 64
+ * vectors, batch by batch.
+ *
+ * @param[out] outputs @c circuit->outputs slices per batch,
+ * batch by batch.
+ *
+ * @param[in] batches The number of batches.
+ *
+ * @param[in,out] toggles NULL, or one count per wire that the
+ * toggles of the wire are added to.
+ *
+ * @return false if the scratch memory could not be allocated
+ */
+__attribute__((target("avx2")))
+bool trit_circuit_eval_avx2(const trit_circuit_t *circuit, const trit_slice_t *inputs, trit_slice_t *outputs,
+                            size_t batches, uint64_t *toggles){
+
+    const __m256i ones = _mm256_set1_epi64x(-1);
+    const __m256i lanes_mask = _mm256_set1_epi64x((long long)TOGGLE_LANES);
+    uint64_t *pos = (uint64_t *)malloc((circuit->wires + 1) * 4 * sizeof(uint64_t));
+    uint64_t *neg = (uint64_t *)malloc((circuit->wires + 1) * 4 * sizeof(uint64_t));
+    uint64_t *counts = toggles != NULL ? (uint64_t *)calloc((circuit->wires + 1) * 4, sizeof(uint64_t)) : NULL;
+    const trit_gate_t *program = circuit->program;
+    const trit_slice_t *in = NULL;
+    size_t in_count = circuit->inputs;
+    size_t out_count = circuit->outputs;
+    size_t batch = 0;
+    size_t index = 0;
+    uint64_t lanes[4];
+    bool ok = false;
+
+    if(pos == NULL || neg == NULL || (toggles != NULL && counts == NULL)){
+
+        goto done;
+    }
+
+    for(batch = 0; batch + 4 <= batches; batch += 4){
+
+        in = inputs + batch * in_count;
+
+        for(index = 0; index < in_count; index++){
+
+            _mm256_storeu_si256((__m256i *)(pos + 4 * index),
+                                _mm256_setr_epi64x((long long)in[index].pos, (long long)in[in_count + index].pos,
+                                                   (long long)in[2 * in_count + index].pos, (long long)in[3 * in_count + index].pos));
+            _mm256_storeu_si256((__m256i *)(neg + 4 * index),
+                                _mm256_setr_epi64x((long long)in[index].neg, (long long)in[in_count + index].neg,
+                                                   (long long)in[2 * in_count + index].neg, (long long)in[3 * in_count + index].neg));
+        }
+
+        for(index = 0; index < circuit->instructions; index++){
+
+            uint64_t *out_pos = pos + 4 * (size_t)program[index].out;
+            uint64_t *out_neg = neg + 4 * (size_t)program[index].out;
+            const trit_fault_t *fault = NULL;
+            __m256i a_pos = _mm256_setzero_si256();
+            __m256i a_neg = _mm256_setzero_si256();
+            __m256i b_pos = _mm256_setzero_si256();
+            __m256i b_neg = _mm256_setzero_si256();
+            __m256i keep = _mm256_setzero_si256();
+            __m256i result_pos = _mm256_setzero_si256();
+            __m256i result_neg = _mm256_setzero_si256();
+
+            if(program[index].op == TRIT_GATE_FORCE){
+
+                fault = &circuit->faults[program[index].a];
+                keep = _mm256_set1_epi64x((long long)~fault->lanes);
+                result_pos = _mm256_and_si256(_mm256_loadu_si256((const __m256i *)out_pos), keep);
+                result_neg = _mm256_and_si256(_mm256_loadu_si256((const __m256i *)out_neg), keep);
+                _mm256_storeu_si256((__m256i *)out_pos, _mm256_or_si256(result_pos, _mm256_set1_epi64x((long long)fault->pos)));
+                _mm256_storeu_si256((__m256i *)out_neg, _mm256_or_si256(result_neg, _mm256_set1_epi64x((long long)fault->neg)));
+                continue;
+            }
+
+            a_pos = _mm256_loadu_si256((const __m256i *)(pos + 4 * (size_t)program[index].a));
+            a_neg = _mm256_loadu_si256((const __m256i *)(neg + 4 * (size_t)program[index].a));
+            b_pos = _mm256_loadu_si256((const __m256i *)(pos + 4 * (size_t)program[index].b));
+            b_neg = _mm256_loadu_si256((const __m256i *)(neg + 4 * (size_t)program[index].b));
+
+            switch(program[index].op){
+
+                case TRIT_GATE_AND:
+                    result_pos = _mm256_and_si256(a_pos, b_pos);
+                    result_neg = _mm256_or_si256(a_neg, b_neg);
+                    break;
+                case TRIT_GATE_OR:
+                    result_pos = _mm256_or_si256(a_pos, b_pos);
+                    result_neg = _mm256_andnot_si256(result_pos, _mm256_or_si256(a_neg, b_neg));
+                    break;
+                case TRIT_GATE_XOR:
+                    result_pos = _mm256_or_si256(_mm256_and_si256(a_pos, b_neg), _mm256_and_si256(a_neg, b_pos));
+                    result_neg = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(a_pos, b_pos), _mm256_and_si256(a_neg, b_neg)),
+                                                 _mm256_xor_si256(_mm256_or_si256(_mm256_or_si256(a_pos, a_neg), _mm256_or_si256(b_pos, b_neg)), ones));
+                    break;
+                default:
+                    result_pos = a_neg;
+                    result_neg = a_pos;
+            }
+
+            _mm256_storeu_si256((__m256i *)out_pos, result_pos);
+            _mm256_storeu_si256((__m256i *)out_neg, result_neg);
+        }
+
+        for(index = 0; index < out_count; index++){
+
+            _mm256_storeu_si256((__m256i *)lanes, _mm256_loadu_si256((const __m256i *)(pos + 4 * (size_t)circuit->output_slots[index])));
+            outputs[batch * out_count + index].pos = lanes[0];
+            outputs[(batch + 1) * out_count + index].pos = lanes[1];
+            outputs[(batch + 2) * out_count + index].pos = lanes[2];
+            outputs[(batch + 3) * out_count + index].pos = lanes[3];
+            _mm256_storeu_si256((__m256i *)lanes, _mm256_loadu_si256((const __m256i *)(neg + 4 * (size_t)circuit->output_slots[index])));
+            outputs[batch * out_count + index].neg = lanes[0];
+            outputs[(batch + 1) * out_count + index].neg = lanes[1];
+            outputs[(batch + 2) * out_count + index].neg = lanes[2];
+            outputs[(batch + 3) * out_count + index].neg = lanes[3];
+        }
+
+        if(counts != NULL){
+
+            for(index = 0; index < circuit->wires; index++){
+
+                __m256i p = _mm256_loadu_si256((const __m256i *)(pos + 4 * index));
+                __m256i n = _mm256_loadu_si256((const __m256i *)(neg + 4 * index));
+                __m256i diff = _mm256_or_si256(_mm256_xor_si256(p, _mm256_srli_epi64(p, 1)), _mm256_xor_si256(n, _mm256_srli_epi64(n, 1)));
+                __m256i total = _mm256_loadu_si256((const __m256i *)(counts + 4 * index));
+
+                total = _mm256_add_epi64(total, popcount_lanes(_mm256_and_si256(diff, lanes_mask)));
+                _mm256_storeu_si256((__m256i *)(counts + 4 * index), total);
+            }
+        }
+    }
+
+    if(counts != NULL){
+
+        for(index = 0; index < circuit->wires; index++){
+
+            toggles[circuit->slot_wires[index]] += counts[4 * index] + counts[4 * index + 1] + counts[4 * index + 2] + counts[4 * index + 3];
+        }
+    }
+
+    ok = trit_circuit_eval_scalar(circuit, inputs + batch * in_count, outputs + batch * out_count, batches - batch, toggles);
+
+done:
+    free(pos);
+    free(neg);
+    free(counts);
+
+    return ok;
+}
+#endif
+
+// BATCH CIRCUIT FUNCTIONS
+
+/**
+ * @brief Arguments of @c eval_range.
+ */
+typedef struct{
+
+    const trit_circuit_t *circuit; /**< The circuit */
+    const trit_slice_t *inputs;    /**< The input slices */
+    trit_slice_t *outputs;         /**< The output slices */
+    uint64_t *toggles;             /**< NULL, or @c circuit->wires counts per block */
+    bool *ok;                      /**< Whether every block was evaluated */
+    size_t batches;                /**< The number of batches */
+    size_t block;                  /**< The batches in one block */
+} eval_args;
+
+/**
+ * @brief Evaluates the blocks [start, end) of @c trit_circuit_eval.
+ *
+ * @param[in] arg The @c eval_args.
+ *
+ * @param[in] start The first block.
+ *
+ * @param[in] end One past the last block.
+ */
+static void eval_range(void *arg, size_t start, size_t end){
+
+    eval_args *args = (eval_args *)arg;
+    const trit_circuit_t *circuit = args->circuit;
+    uint64_t *toggles = NULL;
+    size_t first = 0;
+    size_t length = 0;
+    size_t block = 0;
+
+    for(block = start; block < end; block++){
+
+        first = block * args->block;
+        length = args->batches - first < args->block ? args->batches - first : args->block;
+        toggles = args->toggles != NULL ? args->toggles + block * circuit->wires : NULL;
+
+#ifdef TERNARY_X86_64
+        if(trit_cpu_avx2()){
+
+            args->ok[block] = trit_circuit_eval_avx2(circuit, args->inputs + first * circuit->inputs,
+                                                     args->outputs + first * circuit->outputs, length, toggles);
+            continue;
+        }
+#endif
+        args->ok[block] = trit_circuit_eval_scalar(circuit, args->inputs + first * circuit->inputs,
+                                                   args->outputs + first * circuit->outputs, length, toggles);
+    }
+}
+
+/**
+ * @brief Evaluates a circuit on batches of 64 test vectors using
+ * threads.
+ *
+ * The batches are cut into blocks evaluated on the threads, and
+ * with @p toggles every block counts into its own array, added
+ * up in order at the end.
+ *
+ * @param[in] circuit The compiled circuit.
+ *
+ * @param[in] inputs @c circuit->inputs slices per batch, in
+ * the order of the inputs given to @c trit_circuit_compile,
+ * batch by batch.
+ *
+ * @param[out] outputs @c circuit->outputs slices per batch,
+ * batch by batch.
+ *
+ * @param[in] batches The number of batches.
+ *
+ * @param[out] toggles NULL, or one count per wire id set to the
+ * number of times the wire changes between lane j and j + 1 of
+ * a batch, over all batches.
+ *
+ * @param[in] threads The number of threads,
+ * see @c trit_thread_count.
+ *
+ * @return false if the memory could not be allocated
+ */
+bool trit_circuit_eval(const trit_circuit_t *circuit, const trit_slice_t *inputs, trit_slice_t *outputs,
+                       size_t batches, uint64_t *toggles, int threads){
+
+    eval_args args;
+    size_t blocks = 0;
+    size_t block = 0;
+    size_t wire = 0;
+    bool ok = true;
+
+    args.circuit = circuit;
+    args.inputs = inputs;
+    args.outputs = outputs;
+    args.batches = batches;
+    args.block = (batches + MAX_BLOCKS - 1) / MAX_BLOCKS;
+    args.block = args.block < BLOCK_BATCHES ? BLOCK_BATCHES : (args.block + 3) / 4 * 4;
+    blocks = (batches + args.block - 1) / args.block;
+    args.ok = (bool *)malloc((blocks + 1) * sizeof(bool));
+    args.toggles = toggles != NULL ? (uint64_t *)calloc(blocks * circuit->wires + 1, sizeof(uint64_t)) : NULL;
+
+    if(args.ok == NULL || (toggles != NULL && args.toggles == NULL)){
+
+        free(args.ok);
+        free(args.toggles);
+        return false;
+    }
+
+    trit_parallel_for(blocks, 1, threads, eval_range, &args);
+
+    for(block = 0; block < blocks; block++){
+
+        ok &= args.ok[block];
+    }
+
+    if(toggles != NULL){
+
+        memset(toggles, 0, circuit->wires * sizeof(uint64_t));
+
+        for(block = 0; block < blocks; block++){
+
+            for(wire = 0; wire < circuit->wires; wire++){
+
+                toggles[wire] += args.toggles[block * circuit->wires + wire];
+            }
+        }
+    }
+
+    free(args.ok);
+    free(args.toggles);
+
+    return ok;
+}
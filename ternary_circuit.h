@@ -0,0 +1,112 @@
+#ifndef __ternary_circuit_h__
+#define __ternary_circuit_h__
+
+#include<stddef.h>
+#include<stdint.h>
+#include"ternary.h"
+
+#define TRIT_CIRCUIT_LANES 64 /**< Test vectors in one trit_slice_t */
+
+/**
+ * @brief One wire across 64 test vectors.
+ *
+ * Bit j of @c pos is set if the wire is +1 in vector j and bit j
+ * of @c neg if it is -1, a lane with neither bit set is 0. The
+ * two bits are never both set.
+ */
+typedef struct{
+
+    uint64_t pos; /**< The lanes where the wire is +1 */
+    uint64_t neg; /**< The lanes where the wire is -1 */
+} trit_slice_t;
+
+/**
+ * @brief The gates of a circuit, with the meaning of the trit
+ * functions in ternary.h.
+ */
+typedef enum{
+
+    TRIT_GATE_AND,  /**< @c trit_and_trit32_t, 1 where both are 1, -1 where either is -1 */
+    TRIT_GATE_OR,   /**< @c trit_or_trit32_t, 1 where either is 1, 0 where both are 0, otherwise -1 */
+    TRIT_GATE_XOR,  /**< @c trit_xor_trit32_t, -1 where equal, 1 for 1 and -1, otherwise 0 */
+    TRIT_GATE_NOT,  /**< @c trit_not_trit32_t, the negation of the first input */
+    TRIT_GATE_FORCE /**< Internal, applies fault @c a to slot @c out */
+} trit_gate_op_t;
+
+/**
+ * @brief One gate of a netlist, or one instruction of a compiled
+ * circuit.
+ *
+ * In a netlist @c a, @c b and @c out are wire ids, in a compiled
+ * circuit they are slots. @c b is not read by TRIT_GATE_NOT.
+ */
+typedef struct{
+
+    trit_gate_op_t op; /**< The gate */
+    uint32_t a;        /**< The first input */
+    uint32_t b;        /**< The second input */
+    uint32_t out;      /**< The output */
+} trit_gate_t;
+
+/**
+ * @brief A stuck-at fault on one wire.
+ */
+typedef struct{
+
+    uint32_t wire; /**< The faulty wire */
+    uint64_t lanes; /**< The vectors the fault applies to */
+    uint64_t pos;   /**< The lanes forced to +1 */
+    uint64_t neg;   /**< The lanes forced to -1 */
+} trit_fault_t;
+
+/**
+ * @brief A netlist compiled for bit-sliced evaluation.
+ *
+ * Every wire gets a slot, the inputs first and then the gate
+ * outputs in evaluation order. The gates are levelized, a gate
+ * comes after every gate driving one of its inputs, and they
+ * are stored as a flat array of instructions on slots with
+ * the faults placed right after the instruction writing the
+ * faulty wire.
+ */
+typedef struct{
+
+    trit_gate_t *schedule;  /**< The gates on slots in evaluation order */
+    trit_gate_t *program;   /**< The schedule with the faults added */
+    trit_fault_t *faults;   /**< The faults, in the order they were added */
+    uint32_t *slot_wires;   /**< The wire of every slot */
+    uint32_t *wire_slots;   /**< The slot of every wire */
+    uint32_t *output_slots; /**< The slot of every output */
+    size_t gates;           /**< The number of gates */
+    size_t instructions;    /**< The number of instructions in @c program */
+    size_t fault_count;     /**< The number of faults */
+    size_t wires;           /**< The number of wires and slots */
+    size_t inputs;          /**< The number of inputs */
+    size_t outputs;         /**< The number of outputs */
+    size_t levels;          /**< The depth of the circuit in gates */
+} trit_circuit_t;
+
+// CIRCUIT FUNCTIONS
+bool trit_circuit_compile(trit_circuit_t *circuit, const trit_gate_t *gates, size_t count, size_t wires,
+                          const uint32_t *inputs, size_t input_count, const uint32_t *outputs, size_t output_count);
+void trit_circuit_free(trit_circuit_t *circuit);
+bool trit_circuit_fault(trit_circuit_t *circuit, uint32_t wire, int value, uint64_t lanes);
+void trit_circuit_clear_faults(trit_circuit_t *circuit);
+int trit_slice_get(const trit_slice_t *slice, int lane);
+void trit_slice_set(trit_slice_t *slice, int lane, int value);
+
+// BATCH CIRCUIT FUNCTIONS
+bool trit_circuit_eval(const trit_circuit_t *circuit, const trit_slice_t *inputs, trit_slice_t *outputs,
+                       size_t batches, uint64_t *toggles, int threads);
+
+// SCALAR CIRCUIT KERNELS
+bool trit_circuit_eval_scalar(const trit_circuit_t *circuit, const trit_slice_t *inputs, trit_slice_t *outputs,
+                              size_t batches, uint64_t *toggles);
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+// AVX2 CIRCUIT KERNELS
+bool trit_circuit_eval_avx2(const trit_circuit_t *circuit, const trit_slice_t *inputs, trit_slice_t *outputs,
+                            size_t batches, uint64_t *toggles);
+#endif
+
+#endif // __ternary_circuit_h__
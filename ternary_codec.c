@@ -0,0 +1,1470 @@
+/**
+ * @file ternary_codec.c
+ *
+ * @brief File contains an entropy coder for packed trit streams.
+ *
+ * Trits are first packed 5 to a byte in base 3, 243 of the 256
+ * byte values, which is 1.6 bits a trit against the 2 of the
+ * @c trit32_t layout. The bytes are then coded with an order-0
+ * rANS coder, so trit streams that are mostly zeros, or skewed
+ * towards one sign, take close to their entropy.
+ *
+ * A stream is the magic number "TRZ1" followed by blocks of
+ * TRIT_CODEC_BLOCK_TRITS trits, the last one shorter, and an end
+ * marker. Every block has a 9 byte header, the number of trits,
+ * the number of payload bytes and the mode, and is coded on its
+ * own with the frequencies of its own bytes, so the model adapts
+ * from block to block and blocks are encoded and decoded in
+ * parallel. A block whose rANS payload would not be smaller than
+ * its base-3 bytes is stored as those bytes.
+ *
+ * The rANS payload is a bitmap of the byte values present, their
+ * frequencies out of 2048, the final states of 8 interleaved
+ * coders, the lengths of their streams of 16 bit renormalization
+ * words and the streams. Separate streams keep the coders
+ * independent, so the decoder takes words without branches and
+ * without chaining the coders through one read pointer. It
+ * looks every state up in a table of 2048 slots, which gives the
+ * packed trits of the symbol directly, and joins them into
+ * words, 32 symbols into 5 words at a time. All integers are
+ * little endian.
+ */
+
+
+#include<stdlib.h>
+#include<string.h>
+
+#include"ternary_codec.h"
+#include"ternary_gemm.h"
+#include"ternary_thread.h"
+
+#define TRITS_PER_WORD 32 /**< Number of trits packed in a @c trit32_t */
+#define TRITS_PER_BYTE 5 /**< Number of trits packed in a base-3 byte */
+#define GROUP_WORDS 5 /**< Words of a group, 160 trits */
+#define GROUP_BYTES 32 /**< Base-3 bytes of a group */
+#define BLOCK_BYTES (TRIT_CODEC_BLOCK_TRITS / TRITS_PER_BYTE) /**< Base-3 bytes of a full block */
+#define BLOCK_WORDS (TRIT_CODEC_BLOCK_TRITS / TRITS_PER_WORD) /**< Words of a full block */
+#define MAGIC_BYTES 4 /**< Bytes of the magic number */
+#define HEADER_BYTES 9 /**< Bytes of a block header */
+#define SYMBOLS 243 /**< Number of base-3 byte values */
+#define ZERO_SYMBOL 121 /**< The base-3 byte of 5 zero trits */
+#define BITMAP_BYTES 31 /**< Bytes of the bitmap of present symbols */
+#define STATES 8 /**< Number of interleaved rANS coders, each with its own word stream */
+#define PROB_BITS 11 /**< Bits of the frequencies, 2 of them and a 10 bit trit code fill a table slot */
+#define PROB_SCALE (1U << PROB_BITS) /**< The sum of the frequencies */
+#define PROB_MASK (PROB_SCALE - 1) /**< Mask of a slot of the decode table */
+#define RANS_LOW (1U << 16) /**< The lowest normalized rANS state */
+#define STREAM_BYTES (2 * BLOCK_BYTES / STATES) /**< Room for the renormalization words of one coder */
+#define SCRATCH_BYTES (BLOCK_BYTES + STATES * STREAM_BYTES) /**< Working memory of the block encoder */
+#define MODE_RAW 0 /**< The payload is the base-3 bytes */
+#define MODE_RANS 1 /**< The payload is rANS coded */
+
+/**
+ * @brief The magic number a stream starts with.
+ */
+static const uint8_t MAGIC[MAGIC_BYTES] = {'T', 'R', 'Z', '1'};
+
+/**
+ * @brief The base-3 value of the 4 trits of a byte of packed
+ * trits, each trit plus 1 as a digit, the code 0b10 read as 0.
+ */
+static const uint8_t BASE3_OF_BYTE[256] = {
+
+    40, 41, 40, 39, 43, 44, 43, 42, 40, 41, 40, 39, 37, 38, 37, 36,
+    49, 50, 49, 48, 52, 53, 52, 51, 49, 50, 49, 48, 46, 47, 46, 45,
+    40, 41, 40, 39, 43, 44, 43, 42, 40, 41, 40, 39, 37, 38, 37, 36,
+    31, 32, 31, 30, 34, 35, 34, 33, 31, 32, 31, 30, 28, 29, 28, 27,
+    67, 68, 67, 66, 70, 71, 70, 69, 67, 68, 67, 66, 64, 65, 64, 63,
+    76, 77, 76, 75, 79, 80, 79, 78, 76, 77, 76, 75, 73, 74, 73, 72,
+    67, 68, 67, 66, 70, 71, 70, 69, 67, 68, 67, 66, 64, 65, 64, 63,
+    58, 59, 58, 57, 61, 62, 61, 60, 58, 59, 58, 57, 55, 56, 55, 54,
+    40, 41, 40, 39, 43, 44, 43, 42, 40, 41, 40, 39, 37, 38, 37, 36,
+    49, 50, 49, 48, 52, 53, 52, 51, 49, 50, 49, 48, 46, 47, 46, 45,
+    40, 41, 40, 39, 43, 44, 43, 42, 40, 41, 40, 39, 37, 38, 37, 36,
+    31, 32, 31, 30, 34, 35, 34, 33, 31, 32, 31, 30, 28, 29, 28, 27,
+    13, 14, 13, 12, 16, 17, 16, 15, 13, 14, 13, 12, 10, 11, 10, 9,
+    22, 23, 22, 21, 25, 26, 25, 24, 22, 23, 22, 21, 19, 20, 19, 18,
+    13, 14, 13, 12, 16, 17, 16, 15, 13, 14, 13, 12, 10, 11, 10, 9,
+    4, 5, 4, 3, 7, 8, 7, 6, 4, 5, 4, 3, 1, 2, 1, 0
+};
+
+/**
+ * @brief The base-3 digit of a trit code.
+ */
+static const uint8_t BASE3_OF_TRIT[4] = {1, 2, 1, 0};
+
+/**
+ * @brief The 5 packed trits, 10 bits, of every base-3 byte.
+ */
+static const uint16_t TRITS_OF_BASE3[SYMBOLS] = {
+
+    0x3FF, 0x3FC, 0x3FD, 0x3F3, 0x3F0, 0x3F1, 0x3F7, 0x3F4, 0x3F5, 0x3CF, 0x3CC, 0x3CD,
+    0x3C3, 0x3C0, 0x3C1, 0x3C7, 0x3C4, 0x3C5, 0x3DF, 0x3DC, 0x3DD, 0x3D3, 0x3D0, 0x3D1,
+    0x3D7, 0x3D4, 0x3D5, 0x33F, 0x33C, 0x33D, 0x333, 0x330, 0x331, 0x337, 0x334, 0x335,
+    0x30F, 0x30C, 0x30D, 0x303, 0x300, 0x301, 0x307, 0x304, 0x305, 0x31F, 0x31C, 0x31D,
+    0x313, 0x310, 0x311, 0x317, 0x314, 0x315, 0x37F, 0x37C, 0x37D, 0x373, 0x370, 0x371,
+    0x377, 0x374, 0x375, 0x34F, 0x34C, 0x34D, 0x343, 0x340, 0x341, 0x347, 0x344, 0x345,
+    0x35F, 0x35C, 0x35D, 0x353, 0x350, 0x351, 0x357, 0x354, 0x355, 0x0FF, 0x0FC, 0x0FD,
+    0x0F3, 0x0F0, 0x0F1, 0x0F7, 0x0F4, 0x0F5, 0x0CF, 0x0CC, 0x0CD, 0x0C3, 0x0C0, 0x0C1,
+    0x0C7, 0x0C4, 0x0C5, 0x0DF, 0x0DC, 0x0DD, 0x0D3, 0x0D0, 0x0D1, 0x0D7, 0x0D4, 0x0D5,
+    0x03F, 0x03C, 0x03D, 0x033, 0x030, 0x031, 0x037, 0x034, 0x035, 0x00F, 0x00C, 0x00D,
+    0x003, 0x000, 0x001, 0x007, 0x004, 0x005, 0x01F, 0x01C, 0x01D, 0x013, 0x010, 0x011,
+    0x017, 0x014, 0x015, 0x07F, 0x07C, 0x07D, 0x073, 0x070, 0x071, 0x077, 0x074, 0x075,
+    0x04F, 0x04C, 0x04D, 0x043, 0x040, 0x041, 0x047, 0x044, 0x045, 0x05F, 0x05C, 0x05D,
+    0x053, 0x050, 0x051, 0x057, 0x054, 0x055, 0x1FF, 0x1FC, 0x1FD, 0x1F3, 0x1F0, 0x1F1,
+    0x1F7, 0x1F4, 0x1F5, 0x1CF, 0x1CC, 0x1CD, 0x1C3, 0x1C0, 0x1C1, 0x1C7, 0x1C4, 0x1C5,
+    0x1DF, 0x1DC, 0x1DD, 0x1D3, 0x1D0, 0x1D1, 0x1D7, 0x1D4, 0x1D5, 0x13F, 0x13C, 0x13D,
+    0x133, 0x130, 0x131, 0x137, 0x134, 0x135, 0x10F, 0x10C, 0x10D, 0x103, 0x100, 0x101,
+    0x107, 0x104, 0x105, 0x11F, 0x11C, 0x11D, 0x113, 0x110, 0x111, 0x117, 0x114, 0x115,
+    0x17F, 0x17C, 0x17D, 0x173, 0x170, 0x171, 0x177, 0x174, 0x175, 0x14F, 0x14C, 0x14D,
+    0x143, 0x140, 0x141, 0x147, 0x144, 0x145, 0x15F, 0x15C, 0x15D, 0x153, 0x150, 0x151,
+    0x157, 0x154, 0x155
+};
+
+/**
+ * @brief Writes a 32 bit little endian integer.
+ *
+ * @param[out] out The 4 bytes.
+ *
+ * @param[in] value The integer.
+ */
+static inline void put32(uint8_t *out, uint32_t value){
+
+    out[0] = (uint8_t)value;
+    out[1] = (uint8_t)(value >> 8);
+    out[2] = (uint8_t)(value >> 16);
+    out[3] = (uint8_t)(value >> 24);
+}
+
+/**
+ * @brief Reads a 32 bit little endian integer.
+ *
+ * @param[in] in The 4 bytes.
+ *
+ * @return The integer
+ */
+static inline uint32_t get32(const uint8_t *in){
+
+    return (uint32_t)in[0] | (uint32_t)in[1] << 8 | (uint32_t)in[2] << 16 | (uint32_t)in[3] << 24;
+}
+
+/**
+ * @brief Writes a block header.
+ *
+ * @param[out] out The HEADER_BYTES bytes.
+ *
+ * @param[in] trits The trits of the block, 0 for the end marker.
+ *
+ * @param[in] payload The bytes after the header.
+ *
+ * @param[in] mode MODE_RAW or MODE_RANS.
+ */
+static inline void put_header(uint8_t *out, size_t trits, size_t payload, int mode){
+
+    put32(out, (uint32_t)trits);
+    put32(out + 4, (uint32_t)payload);
+    out[8] = (uint8_t)mode;
+}
+
+/**
+ * @brief Checks a block header.
+ *
+ * @param[in] trits The trits of the block, 0 for the end marker.
+ *
+ * @param[in] payload The bytes after the header.
+ *
+ * @param[in] mode The mode.
+ *
+ * @return true if the header is one the encoder writes
+ */
+static bool check_header(size_t trits, size_t payload, int mode){
+
+    size_t bytes = (trits + TRITS_PER_BYTE - 1) / TRITS_PER_BYTE;
+
+    if(trits == 0){
+
+        return payload == 0 && mode == MODE_RAW;
+    }
+    if(trits > TRIT_CODEC_BLOCK_TRITS){
+
+        return false;
+    }
+    if(mode == MODE_RAW){
+
+        return payload == bytes;
+    }
+
+    return mode == MODE_RANS && payload >= BITMAP_BYTES + 8 * STATES && payload < bytes;
+}
+
+// BASE-3 FUNCTIONS
+
+/**
+ * @brief Packs the trits of consecutive 10 bit fields into base-3
+ * bytes.
+ *
+ * @param[in] bits The fields, field k from bit 10 k.
+ *
+ * @param[in] count The number of fields, at most 6.
+ *
+ * @param[out] out The @p count bytes.
+ */
+__attribute__((always_inline))
+static inline void pack_fields(uint64_t bits, size_t count, uint8_t *out){
+
+    size_t index = 0;
+
+    for(index = 0; index < count; index++, bits >>= 10){
+
+        out[index] = (uint8_t)(BASE3_OF_BYTE[bits & 0xFF] + 81 * BASE3_OF_TRIT[(bits >> 8) & 3]);
+    }
+}
+
+/**
+ * @brief Unpacks base-3 bytes into consecutive 10 bit fields.
+ *
+ * @param[in] bytes The @p count bytes, all below SYMBOLS.
+ *
+ * @param[in] count The number of bytes, at most 6.
+ *
+ * @return The fields, field k from bit 10 k
+ */
+__attribute__((always_inline))
+static inline uint64_t unpack_fields(const uint8_t *bytes, size_t count){
+
+    uint64_t bits = 0;
+    size_t index = 0;
+
+    for(index = count; index-- > 0;){
+
+        bits = bits << 10 | TRITS_OF_BASE3[bytes[index]];
+    }
+
+    return bits;
+}
+
+/**
+ * @brief Joins 10 bit trit codes into consecutive fields.
+ *
+ * @param[in] codes The @p count codes.
+ *
+ * @param[in] count The number of codes, at most 6.
+ *
+ * @return The fields, field k from bit 10 k
+ */
+__attribute__((always_inline))
+static inline uint64_t join_fields(const uint16_t *codes, size_t count){
+
+    uint64_t bits = 0;
+    size_t index = 0;
+
+    for(index = count; index-- > 0;){
+
+        bits = bits << 10 | codes[index];
+    }
+
+    return bits;
+}
+
+/**
+ * @brief Packs 160 trits into 32 base-3 bytes.
+ *
+ * Byte k holds the 10 bits from bit 10 k. Bytes 6, 12, 19 and 25
+ * cross a word boundary and are put together from both words,
+ * the others are runs of whole fields within one word.
+ *
+ * @param[in] words The 5 words of trits.
+ *
+ * @param[out] out The 32 bytes.
+ */
+static inline void pack_group(const trit32_t *words, uint8_t *out){
+
+    pack_fields(words[0], 6, out);
+    pack_fields(words[0] >> 60 | words[1] << 4, 1, out + 6);
+    pack_fields(words[1] >> 6, 5, out + 7);
+    pack_fields(words[1] >> 56 | words[2] << 8, 1, out + 12);
+    pack_fields(words[2] >> 2, 6, out + 13);
+    pack_fields(words[2] >> 62 | words[3] << 2, 1, out + 19);
+    pack_fields(words[3] >> 8, 5, out + 20);
+    pack_fields(words[3] >> 58 | words[4] << 6, 1, out + 25);
+    pack_fields(words[4] >> 4, 6, out + 26);
+}
+
+/**
+ * @brief Joins the 10 bit codes of 32 base-3 bytes into 160
+ * trits.
+ *
+ * @see unpack_group
+ *
+ * @param[in] codes The 32 codes.
+ *
+ * @param[out] words The 5 words of trits.
+ */
+static inline void join_group(const uint16_t *codes, trit32_t *words){
+
+    uint64_t cross6 = codes[6];
+    uint64_t cross12 = codes[12];
+    uint64_t cross19 = codes[19];
+    uint64_t cross25 = codes[25];
+
+    words[0] = join_fields(codes, 6) | cross6 << 60;
+    words[1] = cross6 >> 4 | join_fields(codes + 7, 5) << 6 | cross12 << 56;
+    words[2] = cross12 >> 8 | join_fields(codes + 13, 6) << 2 | cross19 << 62;
+    words[3] = cross19 >> 2 | join_fields(codes + 20, 5) << 8 | cross25 << 58;
+    words[4] = cross25 >> 6 | join_fields(codes + 26, 6) << 4;
+}
+
+/**
+ * @brief Unpacks 32 base-3 bytes into 160 trits.
+ *
+ * @see pack_group
+ *
+ * @param[in] bytes The 32 bytes, all below SYMBOLS.
+ *
+ * @param[out] words The 5 words of trits.
+ */
+static inline void unpack_group(const uint8_t *bytes, trit32_t *words){
+
+    uint64_t cross6 = TRITS_OF_BASE3[bytes[6]];
+    uint64_t cross12 = TRITS_OF_BASE3[bytes[12]];
+    uint64_t cross19 = TRITS_OF_BASE3[bytes[19]];
+    uint64_t cross25 = TRITS_OF_BASE3[bytes[25]];
+
+    words[0] = unpack_fields(bytes, 6) | cross6 << 60;
+    words[1] = cross6 >> 4 | unpack_fields(bytes + 7, 5) << 6 | cross12 << 56;
+    words[2] = cross12 >> 8 | unpack_fields(bytes + 13, 6) << 2 | cross19 << 62;
+    words[3] = cross19 >> 2 | unpack_fields(bytes + 20, 5) << 8 | cross25 << 58;
+    words[4] = cross25 >> 6 | unpack_fields(bytes + 26, 6) << 4;
+}
+
+/**
+ * @brief Packs trits 5 to a byte in base 3.
+ *
+ * The byte of trits t0 to t4 is the sum of (t_k + 1) 3^k, from 0
+ * to 242. The unbalanced code 0b10 is read as 0 and the trits
+ * past @p n in the last byte are 0.
+ *
+ * @param[in] trits The packed trits, @p n rounded up to whole
+ * words.
+ *
+ * @param[in] n The number of trits.
+ *
+ * @param[out] out The (@p n + 4) / 5 bytes.
+ */
+void trit_pack_base3(const trit32_t *trits, size_t n, uint8_t *out){
+
+    size_t groups = n / (GROUP_WORDS * TRITS_PER_WORD);
+    size_t group = 0;
+    size_t left = n - groups * GROUP_WORDS * TRITS_PER_WORD;
+    size_t word = 0;
+    trit32_t words[GROUP_WORDS] = {0};
+    uint8_t bytes[GROUP_BYTES];
+
+    for(group = 0; group < groups; group++){
+
+        pack_group(trits + group * GROUP_WORDS, out + group * GROUP_BYTES);
+    }
+    if(left == 0){
+
+        return;
+    }
+
+    trits += groups * GROUP_WORDS;
+    for(word = 0; word * TRITS_PER_WORD < left; word++){
+
+        words[word] = trits[word];
+    }
+    if(left % TRITS_PER_WORD != 0){
+
+        words[left / TRITS_PER_WORD] &= (1ULL << (2 * (left % TRITS_PER_WORD))) - 1;
+    }
+    pack_group(words, bytes);
+    memcpy(out + groups * GROUP_BYTES, bytes, (left + TRITS_PER_BYTE - 1) / TRITS_PER_BYTE);
+}
+
+/**
+ * @brief Unpacks trits packed 5 to a byte in base 3.
+ *
+ * @see trit_pack_base3
+ *
+ * @param[in] bytes The (@p n + 4) / 5 bytes.
+ *
+ * @param[in] n The number of trits.
+ *
+ * @param[out] out The packed trits, @p n rounded up to whole
+ * words, the trits past @p n are 0.
+ *
+ * @return false if a byte is above 242
+ */
+bool trit_unpack_base3(const uint8_t *bytes, size_t n, trit32_t *out){
+
+    size_t count = (n + TRITS_PER_BYTE - 1) / TRITS_PER_BYTE;
+    size_t groups = n / (GROUP_WORDS * TRITS_PER_WORD);
+    size_t group = 0;
+    size_t left = n - groups * GROUP_WORDS * TRITS_PER_WORD;
+    size_t index = 0;
+    trit32_t words[GROUP_WORDS];
+    uint8_t tail[GROUP_BYTES];
+    bool bad = false;
+
+    for(index = 0; index < count; index++){
+
+        bad |= bytes[index] >= SYMBOLS;
+    }
+    if(bad){
+
+        return false;
+    }
+
+    for(group = 0; group < groups; group++){
+
+        unpack_group(bytes + group * GROUP_BYTES, out + group * GROUP_WORDS);
+    }
+    if(left == 0){
+
+        return true;
+    }
+
+    memset(tail, ZERO_SYMBOL, sizeof(tail));
+    memcpy(tail, bytes + groups * GROUP_BYTES, count - groups * GROUP_BYTES);
+    unpack_group(tail, words);
+    if(left % TRITS_PER_WORD != 0){
+
+        words[left / TRITS_PER_WORD] &= (1ULL << (2 * (left % TRITS_PER_WORD))) - 1;
+    }
+    memcpy(out + groups * GROUP_WORDS, words, TRIT_ROW_WORDS(left) * sizeof(trit32_t));
+
+    return true;
+}
+
+// BLOCK FUNCTIONS
+
+/**
+ * @brief Scales symbol counts to frequencies summing to
+ * PROB_SCALE.
+ *
+ * Every present symbol keeps a frequency of at least 1. The
+ * rounding error goes to the most frequent symbol, where it
+ * costs the least.
+ *
+ * @param[in] counts The count of every symbol.
+ *
+ * @param[in] total The sum of @p counts, at least 1.
+ *
+ * @param[out] freqs The frequency of every symbol.
+ */
+static void normalize_counts(const uint32_t *counts, size_t total, uint32_t *freqs){
+
+    size_t symbol = 0;
+    size_t top = 0;
+    uint32_t sum = 0;
+
+    for(symbol = 0; symbol < SYMBOLS; symbol++){
+
+        freqs[symbol] = (uint32_t)((uint64_t)counts[symbol] * PROB_SCALE / total);
+        if(counts[symbol] != 0 && freqs[symbol] == 0){
+
+            freqs[symbol] = 1;
+        }
+        if(counts[symbol] > counts[top]){
+
+            top = symbol;
+        }
+        sum += freqs[symbol];
+    }
+    if(sum < PROB_SCALE){
+
+        freqs[top] += PROB_SCALE - sum;
+    }
+
+    // raising rare symbols to 1 can overshoot, take it back from the largest frequencies
+    while(sum > PROB_SCALE){
+
+        for(symbol = 0, top = 0; symbol < SYMBOLS; symbol++){
+
+            if(freqs[symbol] > freqs[top]){
+
+                top = symbol;
+            }
+        }
+        freqs[top]--;
+        sum--;
+    }
+}
+
+/**
+ * @brief Encodes one block.
+ *
+ * @param[in] trits The packed trits of the block.
+ *
+ * @param[in] n The number of trits, 1 to TRIT_CODEC_BLOCK_TRITS.
+ *
+ * @param[out] out The header and payload, at most HEADER_BYTES
+ * plus (@p n + 4) / 5 bytes.
+ *
+ * @param[out] scratch SCRATCH_BYTES bytes of working memory.
+ *
+ * @return The bytes written
+ */
+static size_t encode_block(const trit32_t *trits, size_t n, uint8_t *out, uint8_t *scratch){
+
+    size_t count = (n + TRITS_PER_BYTE - 1) / TRITS_PER_BYTE;
+    uint8_t *symbols = scratch;
+    uint8_t *streams[STATES];
+    uint8_t *payload = out + HEADER_BYTES;
+    uint32_t counts[SYMBOLS] = {0};
+    uint32_t freqs[SYMBOLS];
+    uint32_t starts[SYMBOLS];
+    uint32_t states[STATES];
+    size_t lengths[STATES];
+    uint32_t sum = 0;
+    uint32_t freq = 0;
+    uint32_t *state = NULL;
+    uint8_t **stream = NULL;
+    size_t symbol = 0;
+    size_t index = 0;
+    size_t size = BITMAP_BYTES + 8 * STATES;
+
+    trit_pack_base3(trits, n, symbols);
+    for(index = 0; index < count; index++){
+
+        counts[symbols[index]]++;
+    }
+    normalize_counts(counts, count, freqs);
+    for(symbol = 0; symbol < SYMBOLS; symbol++){
+
+        starts[symbol] = sum;
+        sum += freqs[symbol];
+        size += freqs[symbol] != 0 ? 2 : 0;
+    }
+    for(index = 0; index < STATES; index++){
+
+        states[index] = RANS_LOW;
+        streams[index] = scratch + BLOCK_BYTES + (index + 1) * STREAM_BYTES;
+    }
+
+    // the decoder reads forwards, so encode backwards, symbol i by coder i % STATES
+    for(index = count; index-- > 0;){
+
+        state = &states[index % STATES];
+        stream = &streams[index % STATES];
+        freq = freqs[symbols[index]];
+        if(*state >= (uint64_t)freq << (32 - PROB_BITS)){
+
+            *--*stream = (uint8_t)(*state >> 8);
+            *--*stream = (uint8_t)*state;
+            *state >>= 16;
+        }
+        *state = ((*state / freq) << PROB_BITS) + *state % freq + starts[symbols[index]];
+    }
+    for(index = 0; index < STATES; index++){
+
+        lengths[index] = (size_t)(scratch + BLOCK_BYTES + (index + 1) * STREAM_BYTES - streams[index]);
+        size += lengths[index];
+    }
+
+    if(size >= count){
+
+        put_header(out, n, count, MODE_RAW);
+        memcpy(payload, symbols, count);
+
+        return HEADER_BYTES + count;
+    }
+
+    put_header(out, n, size, MODE_RANS);
+    memset(payload, 0, BITMAP_BYTES);
+    for(symbol = 0; symbol < SYMBOLS; symbol++){
+
+        if(freqs[symbol] != 0){
+
+            payload[symbol / 8] |= (uint8_t)(1 << (symbol % 8));
+        }
+    }
+    payload += BITMAP_BYTES;
+    for(symbol = 0; symbol < SYMBOLS; symbol++){
+
+        if(freqs[symbol] != 0){
+
+            payload[0] = (uint8_t)freqs[symbol];
+            payload[1] = (uint8_t)(freqs[symbol] >> 8);
+            payload += 2;
+        }
+    }
+    for(index = 0; index < STATES; index++){
+
+        put32(payload + 4 * index, states[index]);
+        put32(payload + 4 * (STATES + index), (uint32_t)lengths[index]);
+    }
+    payload += 8 * STATES;
+    for(index = 0; index < STATES; index++){
+
+        memcpy(payload, streams[index], lengths[index]);
+        payload += lengths[index];
+    }
+
+    return HEADER_BYTES + size;
+}
+
+/**
+ * @brief Decodes one symbol and renormalizes its coder.
+ *
+ * A slot of the decode table holds the frequency minus 1 in bits
+ * 0 to 10, the start in bits 11 to 21 and the 5 trits of the
+ * symbol from bit 22, so the trits need no second lookup.
+ * Past the end of its stream a state is left low, which the
+ * final check catches.
+ *
+ * @param[in] table The decode table.
+ *
+ * @param[in,out] state The state of the coder.
+ *
+ * @param[in,out] in The next word of the stream of the coder.
+ *
+ * @param[in] end The end of the stream.
+ *
+ * @return The trits of the symbol
+ */
+__attribute__((always_inline))
+static inline uint16_t decode_symbol(const uint32_t *table, uint32_t *state, const uint8_t **in, const uint8_t *end){
+
+    uint32_t slot = table[*state & PROB_MASK];
+
+    *state = ((slot & PROB_MASK) + 1) * (*state >> PROB_BITS) + (*state & PROB_MASK) - ((slot >> PROB_BITS) & PROB_MASK);
+    if(*state < RANS_LOW && end - *in >= 2){
+
+        *state = *state << 16 | (uint32_t)(*in)[0] | (uint32_t)(*in)[1] << 8;
+        *in += 2;
+    }
+
+    return (uint16_t)(slot >> (2 * PROB_BITS));
+}
+
+/**
+ * @brief Decodes one symbol and renormalizes its coder, with at
+ * least 2 bytes left in its stream.
+ *
+ * Whether a coder takes a word is close to random, so the word is
+ * always read and taken with masks and shifts instead of a
+ * branch. Every coder has its own stream, so the conditional
+ * pointer updates do not chain the coders together.
+ *
+ * @see decode_symbol
+ *
+ * @param[in] table The decode table.
+ *
+ * @param[in,out] state The state of the coder.
+ *
+ * @param[in,out] in The next word of the stream of the coder.
+ *
+ * @return The trits of the symbol
+ */
+__attribute__((always_inline))
+static inline uint16_t decode_symbol_fast(const uint32_t *table, uint32_t *state, const uint8_t **in){
+
+    uint32_t slot = table[*state & PROB_MASK];
+    uint32_t word = (uint32_t)(*in)[0] | (uint32_t)(*in)[1] << 8;
+    uint32_t low = 0;
+
+    *state = ((slot & PROB_MASK) + 1) * (*state >> PROB_BITS) + (*state & PROB_MASK) - ((slot >> PROB_BITS) & PROB_MASK);
+    low = *state < RANS_LOW;
+    *state = *state << (16 * low) | (word & (0U - low));
+    *in += 2 * low;
+
+    return (uint16_t)(slot >> (2 * PROB_BITS));
+}
+
+/**
+ * @brief Finds the fewest bytes left in any coder stream.
+ *
+ * @param[in] in The next word of every stream.
+ *
+ * @param[in] ends The end of every stream.
+ *
+ * @return The bytes left in the shortest stream
+ */
+static inline size_t stream_left(const uint8_t *const *in, const uint8_t *const *ends){
+
+    size_t least = (size_t)(ends[0] - in[0]);
+    size_t index = 0;
+
+    for(index = 1; index < STATES; index++){
+
+        least = (size_t)(ends[index] - in[index]) < least ? (size_t)(ends[index] - in[index]) : least;
+    }
+
+    return least;
+}
+
+/**
+ * @brief Decodes the groups of a rANS block from the first one
+ * while every coder stream has room for a group.
+ *
+ * A group takes at most 2 bytes a symbol from every stream, so
+ * away from the ends the bounds checks can go.
+ *
+ * @param[in] table The decode table.
+ *
+ * @param[in,out] states The states of the coders.
+ *
+ * @param[in,out] streams The next word of every stream.
+ *
+ * @param[in] ends The end of every stream.
+ *
+ * @param[in] groups The number of whole groups of the block.
+ *
+ * @param[out] out The packed trits of the block.
+ *
+ * @return The number of groups decoded
+ */
+static size_t decode_groups_fast(const uint32_t *table, uint32_t *states, const uint8_t **streams,
+                                 const uint8_t *const *ends, size_t groups, trit32_t *out){
+
+    uint16_t codes[GROUP_BYTES];
+    size_t group = 0;
+    size_t index = 0;
+    size_t state = 0;
+
+    for(group = 0; group < groups && stream_left(streams, ends) >= 2 * GROUP_BYTES / STATES; group++){
+
+        for(index = 0; index < GROUP_BYTES; index += STATES){
+
+            for(state = 0; state < STATES; state++){
+
+                codes[index + state] = decode_symbol_fast(table, &states[state], &streams[state]);
+            }
+        }
+        join_group(codes, out + group * GROUP_WORDS);
+    }
+
+    return group;
+}
+
+/**
+ * @brief Decodes the payload of a rANS block.
+ *
+ * @param[in] payload The payload.
+ *
+ * @param[in] size The bytes of @p payload.
+ *
+ * @param[in] n The number of trits of the block.
+ *
+ * @param[out] out The packed trits, @p n rounded up to whole
+ * words.
+ *
+ * @return false if the payload is corrupt
+ */
+static bool decode_rans(const uint8_t *payload, size_t size, size_t n, trit32_t *out){
+
+    size_t count = (n + TRITS_PER_BYTE - 1) / TRITS_PER_BYTE;
+    size_t groups = count / GROUP_BYTES;
+    size_t group = 0;
+    size_t symbol = 0;
+    size_t index = 0;
+    size_t slot = 0;
+    size_t bytes_left = 0;
+    const uint8_t *in = payload + BITMAP_BYTES;
+    const uint8_t *end = payload + size;
+    const uint8_t *streams[STATES];
+    const uint8_t *ends[STATES];
+    uint32_t table[PROB_SCALE];
+    uint32_t states[STATES];
+    uint32_t freq = 0;
+    uint32_t sum = 0;
+    uint16_t codes[GROUP_BYTES];
+    trit32_t words[GROUP_WORDS];
+    bool ok = true;
+
+    for(symbol = 0; symbol < SYMBOLS; symbol++){
+
+        if((payload[symbol / 8] >> (symbol % 8) & 1) == 0){
+
+            continue;
+        }
+        if(end - in < 2){
+
+            return false;
+        }
+        freq = (uint32_t)in[0] | (uint32_t)in[1] << 8;
+        in += 2;
+        if(freq == 0 || freq > PROB_SCALE - sum){
+
+            return false;
+        }
+        for(slot = sum; slot < sum + freq; slot++){
+
+            table[slot] = (freq - 1) | sum << PROB_BITS | (uint32_t)TRITS_OF_BASE3[symbol] << (2 * PROB_BITS);
+        }
+        sum += freq;
+    }
+    if(sum != PROB_SCALE || end - in < 8 * STATES){
+
+        return false;
+    }
+    bytes_left = (size_t)(end - in) - 8 * STATES;
+    for(index = 0; index < STATES; index++){
+
+        states[index] = get32(in + 4 * index);
+        if(get32(in + 4 * STATES + 4 * index) > bytes_left){
+
+            return false;
+        }
+        bytes_left -= get32(in + 4 * STATES + 4 * index);
+    }
+    for(index = 0; index < STATES; index++){
+
+        streams[index] = index == 0 ? in + 8 * STATES : ends[index - 1];
+        ends[index] = streams[index] + get32(in + 4 * STATES + 4 * index);
+    }
+    if(bytes_left != 0){
+
+        return false;
+    }
+
+    group = decode_groups_fast(table, states, streams, ends, groups, out);
+    for(; group < groups; group++){
+
+        for(index = 0; index < GROUP_BYTES; index++){
+
+            codes[index] = decode_symbol(table, &states[index % STATES], &streams[index % STATES], ends[index % STATES]);
+        }
+        join_group(codes, out + group * GROUP_WORDS);
+    }
+    if(count > groups * GROUP_BYTES){
+
+        memset(codes, 0, sizeof(codes));
+        for(index = 0; index < count - groups * GROUP_BYTES; index++){
+
+            codes[index] = decode_symbol(table, &states[index % STATES], &streams[index % STATES], ends[index % STATES]);
+        }
+        join_group(codes, words);
+        memcpy(out + groups * GROUP_WORDS, words, (TRIT_ROW_WORDS(n) - groups * GROUP_WORDS) * sizeof(trit32_t));
+    }
+    if(n % TRITS_PER_WORD != 0){
+
+        out[n / TRITS_PER_WORD] &= (1ULL << (2 * (n % TRITS_PER_WORD))) - 1;
+    }
+
+    for(index = 0; index < STATES; index++){
+
+        ok &= streams[index] == ends[index] && states[index] == RANS_LOW;
+    }
+
+    return ok;
+}
+
+/**
+ * @brief Decodes the payload of one block.
+ *
+ * @param[in] payload The payload.
+ *
+ * @param[in] size The bytes of @p payload.
+ *
+ * @param[in] mode The mode, checked with @c check_header.
+ *
+ * @param[in] n The number of trits of the block.
+ *
+ * @param[out] out The packed trits, @p n rounded up to whole
+ * words.
+ *
+ * @return false if the payload is corrupt
+ */
+static bool decode_block(const uint8_t *payload, size_t size, int mode, size_t n, trit32_t *out){
+
+    if(mode == MODE_RAW){
+
+        return trit_unpack_base3(payload, n, out);
+    }
+
+    return decode_rans(payload, size, n, out);
+}
+
+/**
+ * @brief Walks the block headers of a stream.
+ *
+ * @param[in] data The stream.
+ *
+ * @param[in] size The bytes of @p data.
+ *
+ * @param[out] offsets The offset of the header of every block,
+ * or NULL.
+ *
+ * @param[out] blocks The number of blocks.
+ *
+ * @param[out] n The number of trits.
+ *
+ * @return false if the stream is corrupt
+ */
+static bool scan_blocks(const uint8_t *data, size_t size, size_t *offsets, size_t *blocks, size_t *n){
+
+    size_t offset = MAGIC_BYTES;
+    size_t trits = 0;
+    size_t payload = 0;
+    int mode = 0;
+
+    *blocks = 0;
+    *n = 0;
+    if(size < MAGIC_BYTES || memcmp(data, MAGIC, MAGIC_BYTES) != 0){
+
+        return false;
+    }
+
+    for(;;){
+
+        if(size - offset < HEADER_BYTES){
+
+            return false;
+        }
+        trits = get32(data + offset);
+        payload = get32(data + offset + 4);
+        mode = data[offset + 8];
+        if(!check_header(trits, payload, mode) || size - offset - HEADER_BYTES < payload){
+
+            return false;
+        }
+        if(trits == 0){
+
+            return offset + HEADER_BYTES == size;
+        }
+        // only the last block may be short
+        if(*n % TRIT_CODEC_BLOCK_TRITS != 0){
+
+            return false;
+        }
+        if(offsets != NULL){
+
+            offsets[*blocks] = offset;
+        }
+        offset += HEADER_BYTES + payload;
+        *n += trits;
+        (*blocks)++;
+    }
+}
+
+// CODEC FUNCTIONS
+
+/**
+ * @brief Finds the most bytes an encoded stream can take.
+ *
+ * @param[in] n The number of trits.
+ *
+ * @return The capacity @c trit_codec_encode needs for @p n trits
+ */
+size_t trit_codec_bound(size_t n){
+
+    size_t blocks = (n + TRIT_CODEC_BLOCK_TRITS - 1) / TRIT_CODEC_BLOCK_TRITS;
+
+    return MAGIC_BYTES + HEADER_BYTES * (blocks + 1) + (n + TRITS_PER_BYTE - 1) / TRITS_PER_BYTE;
+}
+
+/**
+ * @brief Arguments of the range functions of this file.
+ */
+typedef struct{
+
+    const trit32_t *trits; /**< The trits to encode */
+    trit32_t *out;         /**< The decoded trits */
+    const uint8_t *data;   /**< The stream to decode */
+    uint8_t *encoded;      /**< The stream being encoded */
+    const size_t *offsets; /**< The offset of every block of @c data */
+    size_t *sizes;         /**< The encoded bytes of every block, 0 if it failed */
+    size_t n;              /**< The number of trits */
+} codec_args;
+
+/**
+ * @brief Encodes the blocks [start, end) of a stream, block b at
+ * the offset it would have if all blocks were stored raw.
+ *
+ * @param[in] arg The @c codec_args, with @c trits, @c encoded,
+ * @c sizes and @c n set.
+ *
+ * @param[in] start The first block.
+ *
+ * @param[in] end One past the last block.
+ */
+static void encode_range(void *arg, size_t start, size_t end){
+
+    codec_args *args = (codec_args *)arg;
+    uint8_t *scratch = (uint8_t *)malloc(SCRATCH_BYTES);
+    size_t block = 0;
+    size_t trits = 0;
+
+    for(block = start; block < end; block++){
+
+        trits = args->n - block * TRIT_CODEC_BLOCK_TRITS;
+        trits = trits < TRIT_CODEC_BLOCK_TRITS ? trits : TRIT_CODEC_BLOCK_TRITS;
+        args->sizes[block] = scratch == NULL ? 0
+            : encode_block(args->trits + block * BLOCK_WORDS, trits,
+                           args->encoded + MAGIC_BYTES + block * (HEADER_BYTES + BLOCK_BYTES), scratch);
+    }
+    free(scratch);
+}
+
+/**
+ * @brief Compresses packed trits using threads.
+ *
+ * The blocks are encoded in parallel into the places they would
+ * take if stored raw, which fit in the bound, then moved down
+ * next to each other.
+ *
+ * @param[in] trits The packed trits, @p n rounded up to whole
+ * words. The unbalanced code 0b10 is read as 0.
+ *
+ * @param[in] n The number of trits.
+ *
+ * @param[out] out The stream.
+ *
+ * @param[in] capacity The bytes of @p out, at least
+ * @c trit_codec_bound(n).
+ *
+ * @param[in] threads The number of threads, 0 for all cores.
+ *
+ * @return The bytes of the stream, or 0 if @p capacity is too
+ * small or memory could not be allocated
+ */
+size_t trit_codec_encode(const trit32_t *trits, size_t n, uint8_t *out, size_t capacity, int threads){
+
+    size_t blocks = (n + TRIT_CODEC_BLOCK_TRITS - 1) / TRIT_CODEC_BLOCK_TRITS;
+    size_t block = 0;
+    size_t size = MAGIC_BYTES;
+    codec_args args;
+
+    if(capacity < trit_codec_bound(n)){
+
+        return 0;
+    }
+
+    memset(&args, 0, sizeof(args));
+    args.sizes = (size_t *)malloc((blocks + 1) * sizeof(size_t));
+    if(args.sizes == NULL){
+
+        return 0;
+    }
+    args.trits = trits;
+    args.encoded = out;
+    args.n = n;
+    trit_parallel_for(blocks, 1, threads, encode_range, &args);
+
+    memcpy(out, MAGIC, MAGIC_BYTES);
+    for(block = 0; block < blocks; block++){
+
+        if(args.sizes[block] == 0){
+
+            free(args.sizes);
+
+            return 0;
+        }
+        memmove(out + size, out + MAGIC_BYTES + block * (HEADER_BYTES + BLOCK_BYTES), args.sizes[block]);
+        size += args.sizes[block];
+    }
+    put_header(out + size, 0, 0, MODE_RAW);
+    free(args.sizes);
+
+    return size + HEADER_BYTES;
+}
+
+/**
+ * @brief Finds the number of trits of a stream.
+ *
+ * @param[in] data The stream.
+ *
+ * @param[in] size The bytes of @p data.
+ *
+ * @param[out] n The number of trits.
+ *
+ * @return false if the headers of the stream are corrupt
+ */
+bool trit_codec_trits(const uint8_t *data, size_t size, size_t *n){
+
+    size_t blocks = 0;
+
+    return scan_blocks(data, size, NULL, &blocks, n);
+}
+
+/**
+ * @brief Decodes the blocks [start, end) of a stream.
+ *
+ * @param[in] arg The @c codec_args, with @c data, @c offsets,
+ * @c out, @c sizes and @c n set. @c sizes[b] is set to 1 if
+ * block b decoded and 0 if not.
+ *
+ * @param[in] start The first block.
+ *
+ * @param[in] end One past the last block.
+ */
+static void decode_range(void *arg, size_t start, size_t end){
+
+    codec_args *args = (codec_args *)arg;
+    const uint8_t *header = NULL;
+    size_t block = 0;
+
+    for(block = start; block < end; block++){
+
+        header = args->data + args->offsets[block];
+        args->sizes[block] = decode_block(header + HEADER_BYTES, get32(header + 4), header[8], get32(header),
+                                          args->out + block * BLOCK_WORDS);
+    }
+}
+
+/**
+ * @brief Decompresses a stream using threads.
+ *
+ * @param[in] data The stream.
+ *
+ * @param[in] size The bytes of @p data.
+ *
+ * @param[out] out The packed trits, @p n rounded up to whole
+ * words, the trits past @p n are 0.
+ *
+ * @param[in] n The number of trits, as found by
+ * @c trit_codec_trits.
+ *
+ * @param[in] threads The number of threads, 0 for all cores.
+ *
+ * @return false if the stream is corrupt, does not hold @p n
+ * trits or memory could not be allocated
+ */
+bool trit_codec_decode(const uint8_t *data, size_t size, trit32_t *out, size_t n, int threads){
+
+    size_t blocks = 0;
+    size_t total = 0;
+    size_t block = 0;
+    bool ok = true;
+    codec_args args;
+
+    if(!scan_blocks(data, size, NULL, &blocks, &total) || total != n){
+
+        return false;
+    }
+
+    memset(&args, 0, sizeof(args));
+    args.offsets = (const size_t *)malloc((blocks + 1) * sizeof(size_t));
+    args.sizes = (size_t *)malloc((blocks + 1) * sizeof(size_t));
+    if(args.offsets == NULL || args.sizes == NULL){
+
+        free((void *)args.offsets);
+        free(args.sizes);
+
+        return false;
+    }
+    scan_blocks(data, size, (size_t *)args.offsets, &blocks, &total);
+    args.data = data;
+    args.out = out;
+    args.n = n;
+    trit_parallel_for(blocks, 1, threads, decode_range, &args);
+
+    for(block = 0; block < blocks; block++){
+
+        ok &= args.sizes[block] != 0;
+    }
+    free((void *)args.offsets);
+    free(args.sizes);
+
+    return ok;
+}
+
+// STREAMING CODEC FUNCTIONS
+
+/**
+ * @brief Copies trits between arbitrary trit positions.
+ *
+ * Every step fills the rest of one destination word, and the
+ * trits of the destination word past the copy are cleared.
+ *
+ * @param[in,out] dst The destination.
+ *
+ * @param[in] at The first trit written.
+ *
+ * @param[in] src The source.
+ *
+ * @param[in] from The first trit read.
+ *
+ * @param[in] n The number of trits.
+ */
+static void copy_trits(trit32_t *dst, size_t at, const trit32_t *src, size_t from, size_t n){
+
+    size_t done = 0;
+    size_t take = 0;
+    size_t to = 0;
+    size_t read = 0;
+    uint64_t value = 0;
+
+    while(done < n){
+
+        to = (at + done) % TRITS_PER_WORD;
+        read = (from + done) % TRITS_PER_WORD;
+        take = n - done < TRITS_PER_WORD - to ? n - done : TRITS_PER_WORD - to;
+        value = src[(from + done) / TRITS_PER_WORD] >> (2 * read);
+        if(read + take > TRITS_PER_WORD){
+
+            value |= src[(from + done) / TRITS_PER_WORD + 1] << (2 * (TRITS_PER_WORD - read));
+        }
+        if(take < TRITS_PER_WORD){
+
+            value &= (1ULL << (2 * take)) - 1;
+        }
+        dst[(at + done) / TRITS_PER_WORD] = (dst[(at + done) / TRITS_PER_WORD] & ((1ULL << (2 * to)) - 1)) | value << (2 * to);
+        done += take;
+    }
+}
+
+/**
+ * @brief Starts a streaming encoder and writes the magic number
+ * to the sink.
+ *
+ * @param[out] encoder The encoder, free it with
+ * @c trit_codec_encoder_free.
+ *
+ * @param[in] sink Receives the stream.
+ *
+ * @param[in] context Passed to @p sink.
+ *
+ * @return false if memory could not be allocated or @p sink
+ * failed
+ */
+bool trit_codec_encoder_init(trit_codec_encoder_t *encoder, trit_codec_bytes_fn sink, void *context){
+
+    memset(encoder, 0, sizeof(*encoder));
+    encoder->block = (trit32_t *)malloc(BLOCK_WORDS * sizeof(trit32_t));
+    encoder->buffer = (uint8_t *)malloc(HEADER_BYTES + BLOCK_BYTES);
+    encoder->scratch = (uint8_t *)malloc(SCRATCH_BYTES);
+    encoder->sink = sink;
+    encoder->context = context;
+    if(encoder->block == NULL || encoder->buffer == NULL || encoder->scratch == NULL || !sink(context, MAGIC, MAGIC_BYTES)){
+
+        trit_codec_encoder_free(encoder);
+
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Encodes the filled part of the block of an encoder and
+ * passes it to the sink.
+ *
+ * @param[in,out] encoder The encoder, with at least one trit.
+ */
+static void flush_block(trit_codec_encoder_t *encoder){
+
+    size_t size = encode_block(encoder->block, encoder->trits, encoder->buffer, encoder->scratch);
+
+    encoder->failed |= !encoder->sink(encoder->context, encoder->buffer, size);
+    encoder->trits = 0;
+}
+
+/**
+ * @brief Adds trits to a stream, encoding every block that
+ * fills up.
+ *
+ * @param[in,out] encoder The encoder.
+ *
+ * @param[in] trits The packed trits, @p n rounded up to whole
+ * words.
+ *
+ * @param[in] n The number of trits, any number.
+ *
+ * @return false if the sink failed, now or before
+ */
+bool trit_codec_encoder_write(trit_codec_encoder_t *encoder, const trit32_t *trits, size_t n){
+
+    size_t done = 0;
+    size_t take = 0;
+
+    while(done < n && !encoder->failed){
+
+        take = TRIT_CODEC_BLOCK_TRITS - encoder->trits;
+        take = n - done < take ? n - done : take;
+        copy_trits(encoder->block, encoder->trits, trits, done, take);
+        encoder->trits += take;
+        done += take;
+        if(encoder->trits == TRIT_CODEC_BLOCK_TRITS){
+
+            flush_block(encoder);
+        }
+    }
+
+    return !encoder->failed;
+}
+
+/**
+ * @brief Encodes the last block of a stream and the end marker.
+ *
+ * @param[in,out] encoder The encoder, which takes no more trits.
+ *
+ * @return false if the sink failed, now or before
+ */
+bool trit_codec_encoder_finish(trit_codec_encoder_t *encoder){
+
+    uint8_t marker[HEADER_BYTES];
+
+    if(encoder->failed){
+
+        return false;
+    }
+    if(encoder->trits != 0){
+
+        flush_block(encoder);
+    }
+    put_header(marker, 0, 0, MODE_RAW);
+    encoder->failed |= !encoder->failed && !encoder->sink(encoder->context, marker, HEADER_BYTES);
+
+    return !encoder->failed;
+}
+
+/**
+ * @brief Frees the memory of a streaming encoder.
+ *
+ * @param[in,out] encoder The encoder, left empty.
+ */
+void trit_codec_encoder_free(trit_codec_encoder_t *encoder){
+
+    free(encoder->block);
+    free(encoder->buffer);
+    free(encoder->scratch);
+    memset(encoder, 0, sizeof(*encoder));
+}
+
+/**
+ * @brief Starts a streaming decoder.
+ *
+ * @param[out] decoder The decoder, free it with
+ * @c trit_codec_decoder_free.
+ *
+ * @param[in] sink Receives the trits of every block.
+ *
+ * @param[in] context Passed to @p sink.
+ *
+ * @return false if memory could not be allocated
+ */
+bool trit_codec_decoder_init(trit_codec_decoder_t *decoder, trit_codec_trits_fn sink, void *context){
+
+    memset(decoder, 0, sizeof(*decoder));
+    decoder->buffer = (uint8_t *)malloc(HEADER_BYTES + BLOCK_BYTES);
+    decoder->block = (trit32_t *)malloc(BLOCK_WORDS * sizeof(trit32_t));
+    decoder->sink = sink;
+    decoder->context = context;
+    if(decoder->buffer == NULL || decoder->block == NULL){
+
+        trit_codec_decoder_free(decoder);
+
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Takes bytes into the buffer of a decoder until it holds
+ * @p want bytes.
+ *
+ * @param[in,out] decoder The decoder.
+ *
+ * @param[in,out] data The bytes, advanced past those taken.
+ *
+ * @param[in,out] size The bytes left in @p data.
+ *
+ * @param[in] want The bytes the buffer should hold.
+ *
+ * @return true if the buffer holds @p want bytes
+ */
+static bool fill_buffer(trit_codec_decoder_t *decoder, const uint8_t **data, size_t *size, size_t want){
+
+    size_t take = want - decoder->size < *size ? want - decoder->size : *size;
+
+    memcpy(decoder->buffer + decoder->size, *data, take);
+    decoder->size += take;
+    *data += take;
+    *size -= take;
+
+    return decoder->size == want;
+}
+
+/**
+ * @brief Adds bytes of a stream, decoding every block that is
+ * complete and passing its trits to the sink.
+ *
+ * @param[in,out] decoder The decoder.
+ *
+ * @param[in] data The bytes, split anywhere.
+ *
+ * @param[in] size The bytes of @p data.
+ *
+ * @return false if the stream is corrupt or the sink failed, now
+ * or before
+ */
+bool trit_codec_decoder_write(trit_codec_decoder_t *decoder, const uint8_t *data, size_t size){
+
+    size_t trits = 0;
+    size_t payload = 0;
+    int mode = 0;
+
+    while(size > 0 && !decoder->failed){
+
+        if(decoder->done){
+
+            decoder->failed = true;
+        }
+        else if(!decoder->started){
+
+            if(fill_buffer(decoder, &data, &size, MAGIC_BYTES)){
+
+                decoder->failed = memcmp(decoder->buffer, MAGIC, MAGIC_BYTES) != 0;
+                decoder->started = true;
+                decoder->size = 0;
+            }
+        }
+        else if(decoder->size < HEADER_BYTES){
+
+            if(fill_buffer(decoder, &data, &size, HEADER_BYTES)){
+
+                trits = get32(decoder->buffer);
+                payload = get32(decoder->buffer + 4);
+                mode = decoder->buffer[8];
+                decoder->failed = !check_header(trits, payload, mode) || (decoder->last && trits != 0);
+                decoder->done = trits == 0;
+                decoder->size = trits == 0 ? 0 : decoder->size;
+            }
+        }
+        else{
+
+            trits = get32(decoder->buffer);
+            payload = get32(decoder->buffer + 4);
+            mode = decoder->buffer[8];
+            if(fill_buffer(decoder, &data, &size, HEADER_BYTES + payload)){
+
+                decoder->failed = !decode_block(decoder->buffer + HEADER_BYTES, payload, mode, trits, decoder->block)
+                    || !decoder->sink(decoder->context, decoder->block, trits);
+                decoder->last = trits < TRIT_CODEC_BLOCK_TRITS;
+                decoder->size = 0;
+            }
+        }
+    }
+
+    return !decoder->failed;
+}
+
+/**
+ * @brief Checks that a stream ended where it should.
+ *
+ * @param[in] decoder The decoder.
+ *
+ * @return true if the whole stream was written, up to and
+ * including the end marker, and decoded
+ */
+bool trit_codec_decoder_finish(const trit_codec_decoder_t *decoder){
+
+    return decoder->done && !decoder->failed;
+}
+
+/**
+ * @brief Frees the memory of a streaming decoder.
+ *
+ * @param[in,out] decoder The decoder, left empty.
+ */
+void trit_codec_decoder_free(trit_codec_decoder_t *decoder){
+
+    free(decoder->buffer);
+    free(decoder->block);
+    memset(decoder, 0, sizeof(*decoder));
+}
@@ -0,0 +1,78 @@
+#ifndef __ternary_codec_h__
+#define __ternary_codec_h__
+
+#include<stddef.h>
+#include<stdint.h>
+#include"ternary.h"
+
+#define TRIT_CODEC_BLOCK_TRITS 327680 /**< Trits per block, 65536 base-3 bytes and 10240 words */
+
+/**
+ * @brief Receives compressed bytes from a streaming encoder.
+ *
+ * @return false to stop the encoder
+ */
+typedef bool (*trit_codec_bytes_fn)(void *context, const uint8_t *data, size_t size);
+
+/**
+ * @brief Receives decoded trits from a streaming decoder, one
+ * block at a time.
+ *
+ * @return false to stop the decoder
+ */
+typedef bool (*trit_codec_trits_fn)(void *context, const trit32_t *trits, size_t n);
+
+/**
+ * @brief A streaming encoder, which compresses a block each time
+ * TRIT_CODEC_BLOCK_TRITS trits have been written.
+ */
+typedef struct{
+
+    trit32_t *block;          /**< The trits of the block being filled */
+    uint8_t *buffer;          /**< The compressed block */
+    uint8_t *scratch;         /**< Working memory of the block encoder */
+    size_t trits;             /**< The trits in @c block */
+    trit_codec_bytes_fn sink; /**< Where the compressed bytes go */
+    void *context;            /**< Passed to @c sink */
+    bool failed;              /**< A sink call returned false */
+} trit_codec_encoder_t;
+
+/**
+ * @brief A streaming decoder, which decodes a block each time
+ * all of its bytes have been written.
+ */
+typedef struct{
+
+    uint8_t *buffer;          /**< The bytes of the block being read */
+    trit32_t *block;          /**< The decoded block */
+    size_t size;              /**< The bytes in @c buffer */
+    trit_codec_trits_fn sink; /**< Where the decoded trits go */
+    void *context;            /**< Passed to @c sink */
+    bool started;             /**< The magic number was read */
+    bool last;                /**< A short block was read, only the end marker may follow */
+    bool done;                /**< The end marker was read */
+    bool failed;              /**< The data is corrupt or a sink call returned false */
+} trit_codec_decoder_t;
+
+// BASE-3 FUNCTIONS
+void trit_pack_base3(const trit32_t *trits, size_t n, uint8_t *out);
+bool trit_unpack_base3(const uint8_t *bytes, size_t n, trit32_t *out);
+
+// CODEC FUNCTIONS
+size_t trit_codec_bound(size_t n);
+size_t trit_codec_encode(const trit32_t *trits, size_t n, uint8_t *out, size_t capacity, int threads);
+bool trit_codec_trits(const uint8_t *data, size_t size, size_t *n);
+bool trit_codec_decode(const uint8_t *data, size_t size, trit32_t *out, size_t n, int threads);
+
+// STREAMING CODEC FUNCTIONS
+bool trit_codec_encoder_init(trit_codec_encoder_t *encoder, trit_codec_bytes_fn sink, void *context);
+bool trit_codec_encoder_write(trit_codec_encoder_t *encoder, const trit32_t *trits, size_t n);
+bool trit_codec_encoder_finish(trit_codec_encoder_t *encoder);
+void trit_codec_encoder_free(trit_codec_encoder_t *encoder);
+
+bool trit_codec_decoder_init(trit_codec_decoder_t *decoder, trit_codec_trits_fn sink, void *context);
+bool trit_codec_decoder_write(trit_codec_decoder_t *decoder, const uint8_t *data, size_t size);
+bool trit_codec_decoder_finish(const trit_codec_decoder_t *decoder);
+void trit_codec_decoder_free(trit_codec_decoder_t *decoder);
+
+#endif // __ternary_codec_h__
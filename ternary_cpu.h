@@ -0,0 +1,75 @@
+#ifndef __ternary_cpu_h__
+#define __ternary_cpu_h__
+
+#include<stdbool.h>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include<immintrin.h>
+#define TERNARY_X86_64 1
+#endif
+
+/**
+ * @brief Checks if the pdep/pext instructions should be used.
+ *
+ * BMI2 is required, and AMD family 17h (Zen1/Zen2) is skipped
+ * because pdep/pext are microcoded there and slower than
+ * the portable shifts.
+ *
+ * @return True if the BMI2 helpers should be called
+ */
+static inline bool trit_cpu_fast_bmi2(void){
+
+#ifdef TERNARY_X86_64
+    return __builtin_cpu_supports("bmi2") && !__builtin_cpu_is("amdfam17h");
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Checks if the popcnt instruction can be used.
+ *
+ * @return True if the CPU supports popcnt
+ */
+static inline bool trit_cpu_popcnt(void){
+
+#ifdef TERNARY_X86_64
+    return __builtin_cpu_supports("popcnt");
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Checks if the AVX2 kernels can be used.
+ *
+ * @return True if the CPU supports AVX2
+ */
+static inline bool trit_cpu_avx2(void){
+
+#ifdef TERNARY_X86_64
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Checks if the AVX-512 kernels can be used.
+ *
+ * The kernels need AVX-512BW for byte and word masks
+ * as well as BMI2 to build the masks.
+ *
+ * @return True if the CPU supports AVX-512F, AVX-512BW and BMI2
+ */
+static inline bool trit_cpu_avx512(void){
+
+#ifdef TERNARY_X86_64
+    return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")
+        && __builtin_cpu_supports("bmi2");
+#else
+    return false;
+#endif
+}
+
+#endif // __ternary_cpu_h__
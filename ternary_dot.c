@@ -0,0 +1,599 @@
+/**
+ * @file ternary_dot.c
+ *
+ * @brief File contains balanced ternary dot product methods.
+ *
+ * This file contains methods which multiply a vector of
+ * packed balanced ternary weights with a vector of binary
+ * activations. Every weight is -1, 0 or 1 so the products
+ * are done with masking and add/subtract instead of
+ * converting the weights to binary first. There are scalar,
+ * AVX2 and AVX-512 kernels, the dispatching functions
+ * pick the widest one the CPU supports.
+ */
+
+
+#include"ternary_dot.h"
+#include"ternary_cpu.h"
+
+#define TRITS_PER_WORD 32 /**< Number of trits packed in a @c trit32_t */
+#define FLUSH_WORDS 4096 /**< Words summed in 32 bit lanes before widening to 64 bits */
+
+
+/**
+ * @brief Dot product of packed trits and @c int8_t activations.
+ *
+ * Computes the sum of weight i times @p act[i] for the first
+ * @p n trits of @p weights, without any branches.
+ *
+ * @warning Weights must be in balanced ternary,
+ * the unbalanced code 0b10 counts as 0.
+ *
+ * @param[in] weights The packed weights, @p n trits
+ * rounded up to whole @c trit32_t words.
+ *
+ * @param[in] act The @p n activations.
+ *
+ * @param[in] n The number of trits and activations.
+ *
+ * @return The dot product of @p weights and @p act
+ */
+int64_t trit_dot_scalar_int8_t(const trit32_t *weights, const int8_t *act, size_t n){
+
+    int64_t result = 0;
+    int64_t mag = 0;
+    int64_t sign = 0;
+    trit32_t grab = 0;
+    size_t index = 0;
+
+    for(index = 0; index < n; index++){
+
+        grab = weights[index / TRITS_PER_WORD] >> ((index % TRITS_PER_WORD) * 2);
+
+        mag = -(int64_t)(grab & 0b01);
+        sign = -(int64_t)((grab >> 1) & 0b01);
+
+        result += ((act[index] ^ sign) - sign) & mag;
+    }
+
+    return result;
+}
+
+/**
+ * @brief Dot product of packed trits and @c int16_t activations.
+ *
+ * Computes the sum of weight i times @p act[i] for the first
+ * @p n trits of @p weights, without any branches.
+ *
+ * @warning Weights must be in balanced ternary,
+ * the unbalanced code 0b10 counts as 0.
+ *
+ * @param[in] weights The packed weights, @p n trits
+ * rounded up to whole @c trit32_t words.
+ *
+ * @param[in] act The @p n activations.
+ *
+ * @param[in] n The number of trits and activations.
+ *
+ * @return The dot product of @p weights and @p act
+ */
+int64_t trit_dot_scalar_int16_t(const trit32_t *weights, const int16_t *act, size_t n){
+
+    int64_t result = 0;
+    int64_t mag = 0;
+    int64_t sign = 0;
+    trit32_t grab = 0;
+    size_t index = 0;
+
+    for(index = 0; index < n; index++){
+
+        grab = weights[index / TRITS_PER_WORD] >> ((index % TRITS_PER_WORD) * 2);
+
+        mag = -(int64_t)(grab & 0b01);
+        sign = -(int64_t)((grab >> 1) & 0b01);
+
+        result += ((act[index] ^ sign) - sign) & mag;
+    }
+
+    return result;
+}
+
+/**
+ * @brief Dot product of packed trits and @c float activations.
+ *
+ * Computes the sum of weight i times @p act[i] for the first
+ * @p n trits of @p weights. The product is made by clearing
+ * or flipping the sign bit of the activation.
+ *
+ * @warning Weights must be in balanced ternary,
+ * the unbalanced code 0b10 counts as 0.
+ *
+ * @param[in] weights The packed weights, @p n trits
+ * rounded up to whole @c trit32_t words.
+ *
+ * @param[in] act The @p n activations.
+ *
+ * @param[in] n The number of trits and activations.
+ *
+ * @return The dot product of @p weights and @p act
+ */
+float trit_dot_scalar_float(const trit32_t *weights, const float *act, size_t n){
+
+    float result = 0;
+    union { float f; uint32_t u; } value;
+    uint32_t mag = 0;
+    uint32_t sign = 0;
+    trit32_t grab = 0;
+    size_t index = 0;
+
+    for(index = 0; index < n; index++){
+
+        grab = weights[index / TRITS_PER_WORD] >> ((index % TRITS_PER_WORD) * 2);
+
+        mag = -(uint32_t)(grab & 0b01);
+        sign = (uint32_t)((grab >> 1) & 0b01) << 31;
+
+        value.f = act[index];
+        value.u = (value.u ^ sign) & mag;
+
+        result += value.f;
+    }
+
+    return result;
+}
+
+#ifdef TERNARY_X86_64
+/**
+ * @brief Dot product of packed trits and @c int8_t activations with AVX2.
+ *
+ * Each weight word is broadcast and shuffled so every byte lane
+ * sees its own trit, then compared into +1 and -1 byte masks.
+ * The masked activations are biased to unsigned and summed with
+ * @c vpsadbw, the bias cancels between the +1 and -1 sums.
+ *
+ * @warning The CPU must support AVX2.
+ *
+ * @see trit_dot_scalar_int8_t
+ *
+ * @param[in] weights The packed weights, @p n trits
+ * rounded up to whole @c trit32_t words.
+ *
+ * @param[in] act The @p n activations.
+ *
+ * @param[in] n The number of trits and activations.
+ *
+ * @return The dot product of @p weights and @p act
+ */
+__attribute__((target("avx2")))
+int64_t trit_dot_avx2_int8_t(const trit32_t *weights, const int8_t *act, size_t n){
+
+    const __m256i spread = _mm256_setr_epi8(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3,
+                                            4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7);
+    const __m256i mag_bits = _mm256_set1_epi32(0x40100401);
+    const __m256i sign_bits = _mm256_set1_epi32((int)0x80200802);
+    const __m256i bias = _mm256_set1_epi8((char)0x80);
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i acc = _mm256_setzero_si256();
+    __m256i bytes, mag, sign, x, pos, neg;
+    size_t words = n / TRITS_PER_WORD;
+    size_t index = 0;
+    int64_t lanes[4];
+
+    for(index = 0; index < words; index++){
+
+        bytes = _mm256_shuffle_epi8(_mm256_set1_epi64x((long long)weights[index]), spread);
+        mag = _mm256_cmpeq_epi8(_mm256_and_si256(bytes, mag_bits), mag_bits);
+        sign = _mm256_cmpeq_epi8(_mm256_and_si256(bytes, sign_bits), sign_bits);
+
+        x = _mm256_loadu_si256((const __m256i *)(act + index * TRITS_PER_WORD));
+        pos = _mm256_xor_si256(_mm256_and_si256(_mm256_andnot_si256(sign, mag), x), bias);
+        neg = _mm256_xor_si256(_mm256_and_si256(_mm256_and_si256(sign, mag), x), bias);
+
+        acc = _mm256_add_epi64(acc, _mm256_sub_epi64(_mm256_sad_epu8(pos, zero),
+                                                     _mm256_sad_epu8(neg, zero)));
+    }
+
+    _mm256_storeu_si256((__m256i *)lanes, acc);
+
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3]
+        + trit_dot_scalar_int8_t(weights + words, act + words * TRITS_PER_WORD,
+                                 n - words * TRITS_PER_WORD);
+}
+
+/**
+ * @brief Dot product of packed trits and @c int16_t activations with AVX2.
+ *
+ * Each weight word is expanded into two vectors of 16 bit
+ * weights of -1, 0 or 1 which are multiplied and pairwise
+ * summed with the activations by @c vpmaddwd.
+ *
+ * @warning The CPU must support AVX2.
+ *
+ * @see trit_dot_scalar_int16_t
+ *
+ * @param[in] weights The packed weights, @p n trits
+ * rounded up to whole @c trit32_t words.
+ *
+ * @param[in] act The @p n activations.
+ *
+ * @param[in] n The number of trits and activations.
+ *
+ * @return The dot product of @p weights and @p act
+ */
+__attribute__((target("avx2")))
+int64_t trit_dot_avx2_int16_t(const trit32_t *weights, const int16_t *act, size_t n){
+
+    const __m256i spread_low = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+                                                2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+    const __m256i spread_high = _mm256_setr_epi8(4, 4, 4, 4, 4, 4, 4, 4, 5, 5, 5, 5, 5, 5, 5, 5,
+                                                 6, 6, 6, 6, 6, 6, 6, 6, 7, 7, 7, 7, 7, 7, 7, 7);
+    const __m256i mag_bits = _mm256_set1_epi64x(0x0040001000040001LL);
+    const __m256i sign_bits = _mm256_set1_epi64x(0x0080002000080002LL);
+    const __m256i one = _mm256_set1_epi16(1);
+    __m256i acc = _mm256_setzero_si256();
+    __m256i acc32 = _mm256_setzero_si256();
+    __m256i word, lanes, mag, sign, w_low, w_high, x_low, x_high;
+    size_t words = n / TRITS_PER_WORD;
+    size_t index = 0;
+    int64_t sums[4];
+
+    for(index = 0; index < words; index++){
+
+        word = _mm256_set1_epi64x((long long)weights[index]);
+
+        lanes = _mm256_shuffle_epi8(word, spread_low);
+        mag = _mm256_cmpeq_epi16(_mm256_and_si256(lanes, mag_bits), mag_bits);
+        sign = _mm256_and_si256(_mm256_cmpeq_epi16(_mm256_and_si256(lanes, sign_bits), sign_bits), mag);
+        w_low = _mm256_or_si256(_mm256_and_si256(mag, one), sign);
+
+        lanes = _mm256_shuffle_epi8(word, spread_high);
+        mag = _mm256_cmpeq_epi16(_mm256_and_si256(lanes, mag_bits), mag_bits);
+        sign = _mm256_and_si256(_mm256_cmpeq_epi16(_mm256_and_si256(lanes, sign_bits), sign_bits), mag);
+        w_high = _mm256_or_si256(_mm256_and_si256(mag, one), sign);
+
+        x_low = _mm256_loadu_si256((const __m256i *)(act + index * TRITS_PER_WORD));
+        x_high = _mm256_loadu_si256((const __m256i *)(act + index * TRITS_PER_WORD + 16));
+
+        acc32 = _mm256_add_epi32(acc32, _mm256_add_epi32(_mm256_madd_epi16(x_low, w_low),
+                                                         _mm256_madd_epi16(x_high, w_high)));
+
+        // widen before the 32 bit lanes can overflow
+        if((index + 1) % FLUSH_WORDS == 0 || index + 1 == words){
+
+            acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(acc32)));
+            acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(acc32, 1)));
+            acc32 = _mm256_setzero_si256();
+        }
+    }
+
+    _mm256_storeu_si256((__m256i *)sums, acc);
+
+    return sums[0] + sums[1] + sums[2] + sums[3]
+        + trit_dot_scalar_int16_t(weights + words, act + words * TRITS_PER_WORD,
+                                  n - words * TRITS_PER_WORD);
+}
+
+/**
+ * @brief Dot product of packed trits and @c float activations with AVX2.
+ *
+ * Each group of 8 trits is broadcast and compared into lane
+ * masks which clear or flip the sign bit of the activations.
+ *
+ * @warning The CPU must support AVX2.
+ *
+ * @see trit_dot_scalar_float
+ *
+ * @param[in] weights The packed weights, @p n trits
+ * rounded up to whole @c trit32_t words.
+ *
+ * @param[in] act The @p n activations.
+ *
+ * @param[in] n The number of trits and activations.
+ *
+ * @return The dot product of @p weights and @p act
+ */
+__attribute__((target("avx2")))
+float trit_dot_avx2_float(const trit32_t *weights, const float *act, size_t n){
+
+    const __m256i mag_bits = _mm256_setr_epi32(0x0001, 0x0004, 0x0010, 0x0040,
+                                               0x0100, 0x0400, 0x1000, 0x4000);
+    const __m256i sign_bits = _mm256_slli_epi32(mag_bits, 1);
+    const __m256i sign_flip = _mm256_set1_epi32((int)0x80000000);
+    __m256 acc[4] = {_mm256_setzero_ps(), _mm256_setzero_ps(), _mm256_setzero_ps(), _mm256_setzero_ps()};
+    __m256i group, mag, sign;
+    __m256 x;
+    size_t words = n / TRITS_PER_WORD;
+    size_t index = 0;
+    int part = 0;
+    float sums[8];
+    float result = 0;
+
+    for(index = 0; index < words; index++){
+
+        for(part = 0; part < 4; part++){
+
+            group = _mm256_set1_epi32((int)((weights[index] >> (part * 16)) & 0xFFFF));
+            mag = _mm256_cmpeq_epi32(_mm256_and_si256(group, mag_bits), mag_bits);
+            sign = _mm256_and_si256(_mm256_cmpeq_epi32(_mm256_and_si256(group, sign_bits), sign_bits),
+                                    sign_flip);
+
+            x = _mm256_loadu_ps(act + index * TRITS_PER_WORD + part * 8);
+            x = _mm256_and_ps(_mm256_xor_ps(x, _mm256_castsi256_ps(sign)), _mm256_castsi256_ps(mag));
+
+            acc[part] = _mm256_add_ps(acc[part], x);
+        }
+    }
+
+    _mm256_storeu_ps(sums, _mm256_add_ps(_mm256_add_ps(acc[0], acc[1]), _mm256_add_ps(acc[2], acc[3])));
+
+    for(part = 0; part < 8; part++){
+
+        result += sums[part];
+    }
+
+    return result + trit_dot_scalar_float(weights + words, act + words * TRITS_PER_WORD,
+                                          n - words * TRITS_PER_WORD);
+}
+
+/**
+ * @brief Dot product of packed trits and @c int8_t activations with AVX-512.
+ *
+ * Two weight words are split with pext into 64 bit +1 and -1
+ * masks which select the activations directly as mask registers.
+ *
+ * @warning The CPU must support AVX-512BW and BMI2.
+ *
+ * @see trit_dot_avx2_int8_t
+ *
+ * @param[in] weights The packed weights, @p n trits
+ * rounded up to whole @c trit32_t words.
+ *
+ * @param[in] act The @p n activations.
+ *
+ * @param[in] n The number of trits and activations.
+ *
+ * @return The dot product of @p weights and @p act
+ */
+__attribute__((target("avx512f,avx512bw,bmi2")))
+int64_t trit_dot_avx512_int8_t(const trit32_t *weights, const int8_t *act, size_t n){
+
+    const uint64_t low_bits = 0x5555555555555555ULL;
+    const __m512i bias = _mm512_set1_epi8((char)0x80);
+    const __m512i zero = _mm512_setzero_si512();
+    __m512i acc = _mm512_setzero_si512();
+    __m512i x, pos, neg;
+    uint64_t mag = 0;
+    uint64_t sign = 0;
+    size_t pairs = n / (2 * TRITS_PER_WORD);
+    size_t index = 0;
+
+    for(index = 0; index < pairs; index++){
+
+        mag = _pext_u64(weights[2 * index], low_bits)
+            | (_pext_u64(weights[2 * index + 1], low_bits) << 32);
+        sign = _pext_u64(weights[2 * index] >> 1, low_bits)
+            | (_pext_u64(weights[2 * index + 1] >> 1, low_bits) << 32);
+
+        x = _mm512_xor_si512(_mm512_loadu_si512(act + index * 2 * TRITS_PER_WORD), bias);
+        pos = _mm512_mask_mov_epi8(bias, mag & ~sign, x);
+        neg = _mm512_mask_mov_epi8(bias, mag & sign, x);
+
+        acc = _mm512_add_epi64(acc, _mm512_sub_epi64(_mm512_sad_epu8(pos, zero),
+                                                     _mm512_sad_epu8(neg, zero)));
+    }
+
+    return _mm512_reduce_add_epi64(acc)
+        + trit_dot_scalar_int8_t(weights + 2 * pairs, act + pairs * 2 * TRITS_PER_WORD,
+                                 n - pairs * 2 * TRITS_PER_WORD);
+}
+
+/**
+ * @brief Dot product of packed trits and @c int16_t activations with AVX-512.
+ *
+ * Each weight word is split with pext into 32 bit masks which
+ * build a vector of 16 bit weights of -1, 0 or 1 for @c vpmaddwd.
+ *
+ * @warning The CPU must support AVX-512BW and BMI2.
+ *
+ * @see trit_dot_avx2_int16_t
+ *
+ * @param[in] weights The packed weights, @p n trits
+ * rounded up to whole @c trit32_t words.
+ *
+ * @param[in] act The @p n activations.
+ *
+ * @param[in] n The number of trits and activations.
+ *
+ * @return The dot product of @p weights and @p act
+ */
+__attribute__((target("avx512f,avx512bw,bmi2")))
+int64_t trit_dot_avx512_int16_t(const trit32_t *weights, const int16_t *act, size_t n){
+
+    const uint64_t low_bits = 0x5555555555555555ULL;
+    const __m512i minus_one = _mm512_set1_epi16(-1);
+    __m512i acc = _mm512_setzero_si512();
+    __m512i acc32 = _mm512_setzero_si512();
+    __m512i w, x;
+    uint32_t mag = 0;
+    uint32_t sign = 0;
+    size_t words = n / TRITS_PER_WORD;
+    size_t index = 0;
+
+    for(index = 0; index < words; index++){
+
+        mag = (uint32_t)_pext_u64(weights[index], low_bits);
+        sign = (uint32_t)_pext_u64(weights[index] >> 1, low_bits) & mag;
+
+        w = _mm512_mask_blend_epi16(sign, _mm512_maskz_set1_epi16(mag, 1), minus_one);
+        x = _mm512_loadu_si512(act + index * TRITS_PER_WORD);
+
+        acc32 = _mm512_add_epi32(acc32, _mm512_madd_epi16(x, w));
+
+        // widen before the 32 bit lanes can overflow
+        if((index + 1) % FLUSH_WORDS == 0 || index + 1 == words){
+
+            acc = _mm512_add_epi64(acc, _mm512_cvtepi32_epi64(_mm512_castsi512_si256(acc32)));
+            acc = _mm512_add_epi64(acc, _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(acc32, 1)));
+            acc32 = _mm512_setzero_si512();
+        }
+    }
+
+    return _mm512_reduce_add_epi64(acc)
+        + trit_dot_scalar_int16_t(weights + words, act + words * TRITS_PER_WORD,
+                                  n - words * TRITS_PER_WORD);
+}
+
+/**
+ * @brief Dot product of packed trits and @c float activations with AVX-512.
+ *
+ * Each weight word is split with pext into 32 bit masks, the
+ * zero weights are skipped by a masked load and the -1 weights
+ * flip the sign bit with a masked xor.
+ *
+ * @warning The CPU must support AVX-512F and BMI2.
+ *
+ * @see trit_dot_avx2_float
+ *
+ * @param[in] weights The packed weights, @p n trits
+ * rounded up to whole @c trit32_t words.
+ *
+ * @param[in] act The @p n activations.
+ *
+ * @param[in] n The number of trits and activations.
+ *
+ * @return The dot product of @p weights and @p act
+ */
+__attribute__((target("avx512f,avx512bw,bmi2")))
+float trit_dot_avx512_float(const trit32_t *weights, const float *act, size_t n){
+
+    const uint64_t low_bits = 0x5555555555555555ULL;
+    const __m512i sign_flip = _mm512_set1_epi32((int)0x80000000);
+    __m512 acc_low = _mm512_setzero_ps();
+    __m512 acc_high = _mm512_setzero_ps();
+    __m512i x;
+    uint32_t mag = 0;
+    uint32_t sign = 0;
+    size_t words = n / TRITS_PER_WORD;
+    size_t index = 0;
+
+    for(index = 0; index < words; index++){
+
+        mag = (uint32_t)_pext_u64(weights[index], low_bits);
+        sign = (uint32_t)_pext_u64(weights[index] >> 1, low_bits);
+
+        x = _mm512_castps_si512(_mm512_maskz_loadu_ps((__mmask16)mag, act + index * TRITS_PER_WORD));
+        x = _mm512_mask_xor_epi32(x, (__mmask16)sign, x, sign_flip);
+        acc_low = _mm512_add_ps(acc_low, _mm512_castsi512_ps(x));
+
+        x = _mm512_castps_si512(_mm512_maskz_loadu_ps((__mmask16)(mag >> 16),
+                                                      act + index * TRITS_PER_WORD + 16));
+        x = _mm512_mask_xor_epi32(x, (__mmask16)(sign >> 16), x, sign_flip);
+        acc_high = _mm512_add_ps(acc_high, _mm512_castsi512_ps(x));
+    }
+
+    return _mm512_reduce_add_ps(_mm512_add_ps(acc_low, acc_high))
+        + trit_dot_scalar_float(weights + words, act + words * TRITS_PER_WORD,
+                                n - words * TRITS_PER_WORD);
+}
+#endif
+
+/**
+ * @brief Dot product of packed trits and @c int8_t activations.
+ *
+ * Picks the AVX-512, AVX2 or scalar kernel at run time.
+ *
+ * @warning Weights must be in balanced ternary.
+ *
+ * @see trit_dot_scalar_int8_t
+ *
+ * @param[in] weights The packed weights, @p n trits
+ * rounded up to whole @c trit32_t words.
+ *
+ * @param[in] act The @p n activations.
+ *
+ * @param[in] n The number of trits and activations.
+ *
+ * @return The dot product of @p weights and @p act
+ */
+int64_t trit_dot_int8_t(const trit32_t *weights, const int8_t *act, size_t n){
+
+#ifdef TERNARY_X86_64
+    if(trit_cpu_avx512()){
+
+        return trit_dot_avx512_int8_t(weights, act, n);
+    }
+    if(trit_cpu_avx2()){
+
+        return trit_dot_avx2_int8_t(weights, act, n);
+    }
+#endif
+    return trit_dot_scalar_int8_t(weights, act, n);
+}
+
+/**
+ * @brief Dot product of packed trits and @c int16_t activations.
+ *
+ * Picks the AVX-512, AVX2 or scalar kernel at run time.
+ *
+ * @warning Weights must be in balanced ternary.
+ *
+ * @see trit_dot_scalar_int16_t
+ *
+ * @param[in] weights The packed weights, @p n trits
+ * rounded up to whole @c trit32_t words.
+ *
+ * @param[in] act The @p n activations.
+ *
+ * @param[in] n The number of trits and activations.
+ *
+ * @return The dot product of @p weights and @p act
+ */
+int64_t trit_dot_int16_t(const trit32_t *weights, const int16_t *act, size_t n){
+
+#ifdef TERNARY_X86_64
+    if(trit_cpu_avx512()){
+
+        return trit_dot_avx512_int16_t(weights, act, n);
+    }
+    if(trit_cpu_avx2()){
+
+        return trit_dot_avx2_int16_t(weights, act, n);
+    }
+#endif
+    return trit_dot_scalar_int16_t(weights, act, n);
+}
+
+/**
+ * @brief Dot product of packed trits and @c float activations.
+ *
+ * Picks the AVX-512, AVX2 or scalar kernel at run time. The
+ * kernels sum in different orders so the results can differ
+ * in the last bits.
+ *
+ * @warning Weights must be in balanced ternary.
+ *
+ * @see trit_dot_scalar_float
+ *
+ * @param[in] weights The packed weights, @p n trits
+ * rounded up to whole @c trit32_t words.
+ *
+ * @param[in] act The @p n activations.
+ *
+ * @param[in] n The number of trits and activations.
+ *
+ * @return The dot product of @p weights and @p act
+ */
+float trit_dot_float(const trit32_t *weights, const float *act, size_t n){
+
+#ifdef TERNARY_X86_64
+    if(trit_cpu_avx512()){
+
+        return trit_dot_avx512_float(weights, act, n);
+    }
+    if(trit_cpu_avx2()){
+
+        return trit_dot_avx2_float(weights, act, n);
+    }
+#endif
+    return trit_dot_scalar_float(weights, act, n);
+}
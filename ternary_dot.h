@@ -0,0 +1,29 @@
+#ifndef __ternary_dot_h__
+#define __ternary_dot_h__
+
+#include<stddef.h>
+#include"ternary.h"
+
+// DOT PRODUCT FUNCTIONS
+int64_t trit_dot_int8_t(const trit32_t *weights, const int8_t *act, size_t n);
+int64_t trit_dot_int16_t(const trit32_t *weights, const int16_t *act, size_t n);
+float trit_dot_float(const trit32_t *weights, const float *act, size_t n);
+
+// SCALAR DOT PRODUCT KERNELS
+int64_t trit_dot_scalar_int8_t(const trit32_t *weights, const int8_t *act, size_t n);
+int64_t trit_dot_scalar_int16_t(const trit32_t *weights, const int16_t *act, size_t n);
+float trit_dot_scalar_float(const trit32_t *weights, const float *act, size_t n);
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+// AVX2 DOT PRODUCT KERNELS
+int64_t trit_dot_avx2_int8_t(const trit32_t *weights, const int8_t *act, size_t n);
+int64_t trit_dot_avx2_int16_t(const trit32_t *weights, const int16_t *act, size_t n);
+float trit_dot_avx2_float(const trit32_t *weights, const float *act, size_t n);
+
+// AVX-512 DOT PRODUCT KERNELS
+int64_t trit_dot_avx512_int8_t(const trit32_t *weights, const int8_t *act, size_t n);
+int64_t trit_dot_avx512_int16_t(const trit32_t *weights, const int16_t *act, size_t n);
+float trit_dot_avx512_float(const trit32_t *weights, const float *act, size_t n);
+#endif
+
+#endif // __ternary_dot_h__
@@ -0,0 +1,547 @@
+/**
+ * @file ternary_fixed.c
+ *
+ * @brief File contains balanced ternary fixed-point methods.
+ *
+ * A fixed-point number with @c frac fraction trits is stored as
+ * the @c trit32_t integer value times 3^frac. Dropping the low
+ * trits of a balanced ternary number rounds it to the nearest
+ * value, so products and rescales need no separate rounding step,
+ * a right shift by @c frac trits is already round to nearest.
+ * The array conversions to and from @c double have scalar and
+ * AVX2 kernels, the dispatching functions pick one at run time.
+ */
+
+
+#include<math.h>
+
+#include"ternary_fixed.h"
+#include"ternary_cpu.h"
+
+#define MAX_VALUE 926510094425920LL /**< (3^32 - 1) / 2, the largest value a @c trit32_t holds */
+#define ALL_ONES 0x5555555555555555ULL /**< A @c trit32_t with every trit +1 */
+#define ALL_BALS 0xFFFFFFFFFFFFFFFFULL /**< A @c trit32_t with every trit -1 */
+
+/**
+ * @brief Powers of three from 3^0 to 3^32, all exact as @c double.
+ */
+static const double POW3[TRIT_FIX_MAX_FRAC + 1] = {
+
+    1.0, 3.0, 9.0, 27.0, 81.0, 243.0, 729.0, 2187.0, 6561.0, 19683.0, 59049.0,
+    177147.0, 531441.0, 1594323.0, 4782969.0, 14348907.0, 43046721.0, 129140163.0,
+    387420489.0, 1162261467.0, 3486784401.0, 10460353203.0, 31381059609.0,
+    94143178827.0, 282429536481.0, 847288609443.0, 2541865828329.0, 7625597484987.0,
+    22876792454961.0, 68630377364883.0, 205891132094649.0, 617673396283947.0,
+    1853020188851841.0
+};
+
+/**
+ * @brief Converts a whole binary number to balanced ternary.
+ *
+ * @param[in] value A whole number from -MAX_VALUE to MAX_VALUE.
+ *
+ * @return The 32 trits of @p value
+ */
+static trit32_t whole_to_trits(int64_t value){
+
+    trit32_t result = binary_to_balanced_ternary_trit32_t((uint64_t)(value < 0 ? -value : value));
+
+    return value < 0 ? trit_not_trit32_t(result) : result;
+}
+
+/**
+ * @brief Converts a @c double to fixed-point.
+ *
+ * Rounds @p value times 3^frac to the nearest whole number. A
+ * value that does not fit is clamped to the largest or smallest
+ * @c trit32_t, NaN becomes 0.
+ *
+ * @param[in] value The number to convert.
+ *
+ * @param[in] frac The number of fraction trits, 0 to 32.
+ *
+ * @param[out] overflow Set to true if @p value did not fit
+ * or is NaN, false otherwise.
+ *
+ * @return The fixed-point trits of @p value
+ */
+trit32_t trit_fix_from_double(double value, int frac, bool *overflow){
+
+    double scaled = 0;
+
+    assert(frac >= 0 && frac <= TRIT_FIX_MAX_FRAC);
+
+    scaled = rint(value * POW3[frac]);
+    *overflow = !(fabs(scaled) <= (double)MAX_VALUE);
+
+    if(scaled != scaled){
+
+        return 0;
+    }
+    if(*overflow){
+
+        return scaled < 0 ? ALL_BALS : ALL_ONES;
+    }
+
+    return whole_to_trits((int64_t)scaled);
+}
+
+/**
+ * @brief Converts fixed-point to a @c double.
+ *
+ * @warning This method asserts that @p num is in balanced ternary.
+ *
+ * @param[in] num The fixed-point trits.
+ *
+ * @param[in] frac The number of fraction trits, 0 to 32.
+ *
+ * @return The value of @p num rounded to the nearest @c double
+ */
+double trit_fix_to_double(trit32_t num, int frac){
+
+    assert(frac >= 0 && frac <= TRIT_FIX_MAX_FRAC);
+
+    return (double)balanced_ternary_to_binary_int64_t(num) / POW3[frac];
+}
+
+/**
+ * @brief Multiplies two fixed-point numbers.
+ *
+ * The full 64 trit product is shifted right by @p frac trits,
+ * which rounds it to the nearest fixed-point value.
+ *
+ * @warning This method asserts that @p a and
+ * @p b are in balanced ternary.
+ *
+ * @param[in] a The first factor.
+ *
+ * @param[in] b The second factor.
+ *
+ * @param[in] frac The number of fraction trits of @p a,
+ * @p b and the result, 0 to 32.
+ *
+ * @param[out] overflow Set to true if the product
+ * does not fit in 32 trits, false otherwise.
+ *
+ * @return The low 32 trits of the rounded product
+ */
+trit32_t trit_fix_mul(trit32_t a, trit32_t b, int frac, bool *overflow){
+
+    assert(frac >= 0 && frac <= TRIT_FIX_MAX_FRAC);
+
+    return trit_narrow_checked_trit64_t_to_trit32_t(trit_sr_trit64_t(trit_mul_wide_trit32_t(a, b), (uint8_t)frac), overflow);
+}
+
+/**
+ * @brief Divides two fixed-point numbers.
+ *
+ * The quotient is rounded to the nearest fixed-point value,
+ * halfway cases away from zero. Dividing by zero gives the
+ * largest value with the sign of @p a, or 0 for 0 / 0, and
+ * sets @p overflow.
+ *
+ * @warning This method asserts that @p a and
+ * @p b are in balanced ternary.
+ *
+ * @param[in] a The dividend.
+ *
+ * @param[in] b The divisor.
+ *
+ * @param[in] frac The number of fraction trits of @p a,
+ * @p b and the result, 0 to 32.
+ *
+ * @param[out] overflow Set to true if the quotient does not fit
+ * in 32 trits or @p b is 0, false otherwise.
+ *
+ * @return The rounded quotient, clamped if it does not fit
+ */
+trit32_t trit_fix_div(trit32_t a, trit32_t b, int frac, bool *overflow){
+
+    int64_t dividend = balanced_ternary_to_binary_int64_t(a);
+    int64_t divisor = balanced_ternary_to_binary_int64_t(b);
+    __int128 scaled = 0;
+    __int128 quotient = 0;
+    __int128 remainder = 0;
+
+    assert(frac >= 0 && frac <= TRIT_FIX_MAX_FRAC);
+
+    if(divisor == 0){
+
+        *overflow = true;
+        return dividend == 0 ? 0 : dividend < 0 ? ALL_BALS : ALL_ONES;
+    }
+
+    scaled = (__int128)dividend * (int64_t)POW3[frac];
+    quotient = scaled / divisor;
+    remainder = scaled % divisor;
+
+    if(2 * (remainder < 0 ? -remainder : remainder) >= (divisor < 0 ? -divisor : divisor)){
+
+        quotient += (scaled < 0) == (divisor < 0) ? 1 : -1;
+    }
+
+    *overflow = quotient > MAX_VALUE || quotient < -MAX_VALUE;
+    if(*overflow){
+
+        return quotient < 0 ? ALL_BALS : ALL_ONES;
+    }
+
+    return whole_to_trits((int64_t)quotient);
+}
+
+/**
+ * @brief Changes the number of fraction trits of a fixed-point number.
+ *
+ * Adding fraction trits shifts left and is exact, dropping them
+ * shifts right and rounds to the nearest value.
+ *
+ * @param[in] num The fixed-point trits.
+ *
+ * @param[in] from_frac The fraction trits of @p num, 0 to 32.
+ *
+ * @param[in] to_frac The fraction trits of the result, 0 to 32.
+ *
+ * @param[out] overflow Set to true if the result does not
+ * fit in 32 trits, false otherwise.
+ *
+ * @return The low 32 trits of @p num with @p to_frac fraction trits
+ */
+trit32_t trit_fix_rescale(trit32_t num, int from_frac, int to_frac, bool *overflow){
+
+    int shift = to_frac - from_frac;
+
+    assert(from_frac >= 0 && from_frac <= TRIT_FIX_MAX_FRAC);
+    assert(to_frac >= 0 && to_frac <= TRIT_FIX_MAX_FRAC);
+
+    if(shift <= 0){
+
+        *overflow = false;
+        return trit_sr_trit32_t(num, (uint8_t)-shift);
+    }
+
+    *overflow = shift >= 32 ? num != 0 : (num >> (64 - 2 * shift)) != 0;
+
+    return trit_sl_trit32_t(num, (uint8_t)shift);
+}
+
+/**
+ * @brief Converts an array of @c double to fixed-point.
+ *
+ * @see trit_fix_from_double
+ *
+ * @param[in] values The numbers to convert.
+ *
+ * @param[out] out The @p count fixed-point results.
+ *
+ * @param[in] count The number of values.
+ *
+ * @param[in] frac The number of fraction trits, 0 to 32.
+ *
+ * @param[out] overflow Set to true if any value did not
+ * fit or is NaN, false otherwise.
+ */
+void trit_fix_from_double_scalar(const double *values, trit32_t *out, size_t count, int frac, bool *overflow){
+
+    bool flag = false;
+    size_t index = 0;
+
+    *overflow = false;
+
+    for(index = 0; index < count; index++){
+
+        out[index] = trit_fix_from_double(values[index], frac, &flag);
+        *overflow |= flag;
+    }
+}
+
+/**
+ * @brief Converts an array of fixed-point numbers to @c double.
+ *
+ * @see trit_fix_to_double
+ *
+ * @param[in] nums The fixed-point trits.
+ *
+ * @param[out] out The @p count results.
+ *
+ * @param[in] count The number of values.
+ *
+ * @param[in] frac The number of fraction trits, 0 to 32.
+ */
+void trit_fix_to_double_scalar(const trit32_t *nums, double *out, size_t count, int frac){
+
+    size_t index = 0;
+
+    for(index = 0; index < count; index++){
+
+        out[index] = trit_fix_to_double(nums[index], frac);
+    }
+}
+
+#ifdef TERNARY_X86_64
+/**
+ * @brief Splits balanced 16 trit values into balanced 8 trit quarters.
+ *
+ * @param[in] half Whole numbers from -(3^16 - 1) / 2 to (3^16 - 1) / 2.
+ *
+ * @param[out] low The low 8 trits of every value as a whole number.
+ *
+ * @return The high 8 trits of every value as a whole number
+ */
+__attribute__((target("avx2")))
+static inline __m128i split_half(__m256d half, __m128i *low){
+
+    const __m256d radix = _mm256_set1_pd(6561.0);
+    const __m256d inverse = _mm256_set1_pd(1.0 / 6561.0);
+    __m256d high = _mm256_round_pd(_mm256_mul_pd(half, inverse), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+
+    *low = _mm256_cvtpd_epi32(_mm256_sub_pd(half, _mm256_mul_pd(high, radix)));
+
+    return _mm256_cvtpd_epi32(high);
+}
+
+/**
+ * @brief Converts an array of @c double to fixed-point with AVX2.
+ *
+ * Four values are rounded at once and split with @c double
+ * arithmetic into balanced 8 trit quarters, which are packed
+ * into the 16 bit lanes of one vector in the order the trits
+ * of the results are stored. Adding 3280, the quarter with
+ * every trit 1, makes the digits unbalanced without carries,
+ * so each trit is the remainder of an unsigned division by 3
+ * done with @c vpmulhuw, and digit 0, 1 or 2 is the code of
+ * -1, 0 or 1.
+ *
+ * @warning The CPU must support AVX2.
+ *
+ * @see trit_fix_from_double_scalar
+ *
+ * @param[in] values The numbers to convert.
+ *
+ * @param[out] out The @p count fixed-point results.
+ *
+ * @param[in] count The number of values.
+ *
+ * @param[in] frac The number of fraction trits, 0 to 32.
+ *
+ * @param[out] overflow Set to true if any value did not
+ * fit or is NaN, false otherwise.
+ */
+__attribute__((target("avx2")))
+void trit_fix_from_double_avx2(const double *values, trit32_t *out, size_t count, int frac, bool *overflow){
+
+    const __m256d scale = _mm256_set1_pd(POW3[frac]);
+    const __m256d max = _mm256_set1_pd((double)MAX_VALUE);
+    const __m256d min = _mm256_set1_pd(-(double)MAX_VALUE);
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    const __m256d radix = _mm256_set1_pd(POW3[16]);
+    const __m256d inverse = _mm256_set1_pd(1.0 / POW3[16]);
+    const __m256d half_radix = _mm256_set1_pd((POW3[16] - 1) / 2);
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256i bias = _mm256_set1_epi16(3280);
+    const __m256i third = _mm256_set1_epi16(21846);
+    const __m256i trit_bits = _mm256_set1_epi16(3);
+    __m256d flags = _mm256_setzero_pd();
+    __m256d value, nan, low, high, carry;
+    __m128i quarters[4];
+    __m128i firsts, seconds, lows, highs;
+    __m256i digits, quotient, trits;
+    size_t index = 0;
+    bool tail = false;
+    int trit = 0;
+
+    assert(frac >= 0 && frac <= TRIT_FIX_MAX_FRAC);
+
+    for(index = 0; index + 4 <= count; index += 4){
+
+        value = _mm256_round_pd(_mm256_mul_pd(_mm256_loadu_pd(values + index), scale),
+                                _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        nan = _mm256_cmp_pd(value, value, _CMP_UNORD_Q);
+        flags = _mm256_or_pd(flags, _mm256_or_pd(nan, _mm256_cmp_pd(_mm256_andnot_pd(sign, value), max, _CMP_GT_OQ)));
+        value = _mm256_andnot_pd(nan, _mm256_min_pd(_mm256_max_pd(value, min), max));
+
+        // split into balanced 16 trit halves, fixing the quotient if the inverse rounded it off by one
+        high = _mm256_round_pd(_mm256_mul_pd(value, inverse), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        low = _mm256_sub_pd(value, _mm256_mul_pd(high, radix));
+        carry = _mm256_cmp_pd(low, half_radix, _CMP_GT_OQ);
+        high = _mm256_add_pd(high, _mm256_and_pd(carry, one));
+        low = _mm256_sub_pd(low, _mm256_and_pd(carry, radix));
+        carry = _mm256_cmp_pd(low, _mm256_xor_pd(half_radix, sign), _CMP_LT_OQ);
+        high = _mm256_sub_pd(high, _mm256_and_pd(carry, one));
+        low = _mm256_add_pd(low, _mm256_and_pd(carry, radix));
+
+        quarters[1] = split_half(low, &quarters[0]);
+        quarters[3] = split_half(high, &quarters[2]);
+
+        // order the quarters of every value from low to high
+        firsts = _mm_packs_epi32(quarters[0], quarters[2]);
+        seconds = _mm_packs_epi32(quarters[1], quarters[3]);
+        lows = _mm_unpacklo_epi16(firsts, seconds);
+        highs = _mm_unpackhi_epi16(firsts, seconds);
+        digits = _mm256_add_epi16(_mm256_set_m128i(_mm_unpackhi_epi32(lows, highs), _mm_unpacklo_epi32(lows, highs)), bias);
+        trits = _mm256_setzero_si256();
+
+        for(trit = 0; trit < 8; trit++){
+
+            quotient = _mm256_mulhi_epu16(digits, third);
+            digits = _mm256_sub_epi16(digits, _mm256_add_epi16(quotient, _mm256_add_epi16(quotient, quotient)));
+            trits = _mm256_or_si256(trits, _mm256_sll_epi16(_mm256_and_si256(_mm256_add_epi16(digits, trit_bits), trit_bits),
+                                                            _mm_cvtsi32_si128(2 * trit)));
+            digits = quotient;
+        }
+
+        _mm256_storeu_si256((__m256i *)(out + index), trits);
+    }
+
+    trit_fix_from_double_scalar(values + index, out + index, count - index, frac, &tail);
+
+    *overflow = tail || _mm256_movemask_pd(flags) != 0;
+}
+
+/**
+ * @brief Converts an array of fixed-point numbers to @c double with AVX2.
+ *
+ * Four words are converted at once. A nibble lookup with
+ * @c vpshufb gives the value of every 4 trit byte, @c vpmaddubsw,
+ * @c vpmaddwd and @c vpmuldq combine them by powers of 81, 6561
+ * and 3^16, and the 64-bit sums are turned into @c double by
+ * adding them to the bits of 1.5 * 2^52.
+ *
+ * @warning The CPU must support AVX2. Values must be in balanced
+ * ternary, the unbalanced code 0b10 counts as 0.
+ *
+ * @see trit_fix_to_double_scalar
+ *
+ * @param[in] nums The fixed-point trits.
+ *
+ * @param[out] out The @p count results.
+ *
+ * @param[in] count The number of values.
+ *
+ * @param[in] frac The number of fraction trits, 0 to 32.
+ */
+__attribute__((target("avx2")))
+void trit_fix_to_double_avx2(const trit32_t *nums, double *out, size_t count, int frac){
+
+    const __m256i low_values = _mm256_setr_epi8(0, 1, 0, -1, 3, 4, 3, 2, 0, 1, 0, -1, -3, -2, -3, -4,
+                                                0, 1, 0, -1, 3, 4, 3, 2, 0, 1, 0, -1, -3, -2, -3, -4);
+    const __m256i high_values = _mm256_setr_epi8(0, 9, 0, -9, 27, 36, 27, 18, 0, 9, 0, -9, -27, -18, -27, -36,
+                                                 0, 9, 0, -9, 27, 36, 27, 18, 0, 9, 0, -9, -27, -18, -27, -36);
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    const __m256i byte_weights = _mm256_set1_epi16(81 << 8 | 1);
+    const __m256i word_weights = _mm256_set1_epi32(6561 << 16 | 1);
+    const __m256i one = _mm256_set1_epi64x(1);
+    const __m256i half_weight = _mm256_set1_epi64x(43046721);
+    const __m256i magic_bits = _mm256_set1_epi64x(0x4338000000000000LL);
+    const __m256d magic = _mm256_set1_pd(6755399441055744.0);
+    const __m256d scale = _mm256_set1_pd(POW3[frac]);
+    __m256i words, bytes, pairs, whole;
+    size_t index = 0;
+
+    assert(frac >= 0 && frac <= TRIT_FIX_MAX_FRAC);
+
+    for(index = 0; index + 4 <= count; index += 4){
+
+        words = _mm256_loadu_si256((const __m256i *)(nums + index));
+        bytes = _mm256_add_epi8(_mm256_shuffle_epi8(low_values, _mm256_and_si256(words, nibble)),
+                                _mm256_shuffle_epi8(high_values, _mm256_and_si256(_mm256_srli_epi16(words, 4), nibble)));
+        pairs = _mm256_madd_epi16(_mm256_maddubs_epi16(byte_weights, bytes), word_weights);
+        whole = _mm256_add_epi64(_mm256_mul_epi32(pairs, one),
+                                 _mm256_mul_epi32(_mm256_srli_epi64(pairs, 32), half_weight));
+
+        _mm256_storeu_pd(out + index, _mm256_div_pd(_mm256_sub_pd(_mm256_castsi256_pd(_mm256_add_epi64(whole, magic_bits)), magic), scale));
+    }
+
+    trit_fix_to_double_scalar(nums + index, out + index, count - index, frac);
+}
+#endif
+
+/**
+ * @brief Converts an array of @c double to fixed-point.
+ *
+ * Picks the AVX2 or scalar kernel at run time.
+ *
+ * @see trit_fix_from_double_scalar
+ *
+ * @param[in] values The numbers to convert.
+ *
+ * @param[out] out The @p count fixed-point results.
+ *
+ * @param[in] count The number of values.
+ *
+ * @param[in] frac The number of fraction trits, 0 to 32.
+ *
+ * @param[out] overflow Set to true if any value did not
+ * fit or is NaN, false otherwise.
+ */
+void trit_fix_from_double_array(const double *values, trit32_t *out, size_t count, int frac, bool *overflow){
+
+#ifdef TERNARY_X86_64
+    if(trit_cpu_avx2()){
+
+        trit_fix_from_double_avx2(values, out, count, frac, overflow);
+        return;
+    }
+#endif
+    trit_fix_from_double_scalar(values, out, count, frac, overflow);
+}
+
+/**
+ * @brief Converts an array of fixed-point numbers to @c double.
+ *
+ * Picks the AVX2 or scalar kernel at run time.
+ *
+ * @warning Values must be in balanced ternary.
+ *
+ * @see trit_fix_to_double_scalar
+ *
+ * @param[in] nums The fixed-point trits.
+ *
+ * @param[out] out The @p count results.
+ *
+ * @param[in] count The number of values.
+ *
+ * @param[in] frac The number of fraction trits, 0 to 32.
+ */
+void trit_fix_to_double_array(const trit32_t *nums, double *out, size_t count, int frac){
+
+#ifdef TERNARY_X86_64
+    if(trit_cpu_avx2()){
+
+        trit_fix_to_double_avx2(nums, out, count, frac);
+        return;
+    }
+#endif
+    trit_fix_to_double_scalar(nums, out, count, frac);
+}
+
+/**
+ * @brief Multiplies two arrays of fixed-point numbers element by element.
+ *
+ * @see trit_fix_mul
+ *
+ * @param[in] a The first factors.
+ *
+ * @param[in] b The second factors.
+ *
+ * @param[out] out The @p count rounded products.
+ *
+ * @param[in] count The number of products.
+ *
+ * @param[in] frac The number of fraction trits, 0 to 32.
+ *
+ * @param[out] overflow Set to true if any product did
+ * not fit in 32 trits, false otherwise.
+ */
+void trit_fix_mul_array(const trit32_t *a, const trit32_t *b, trit32_t *out, size_t count, int frac, bool *overflow){
+
+    bool flag = false;
+    size_t index = 0;
+
+    *overflow = false;
+
+    for(index = 0; index < count; index++){
+
+        out[index] = trit_fix_mul(a[index], b[index], frac, &flag);
+        *overflow |= flag;
+    }
+}
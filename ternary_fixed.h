@@ -0,0 +1,31 @@
+#ifndef __ternary_fixed_h__
+#define __ternary_fixed_h__
+
+#include<stddef.h>
+#include"ternary.h"
+
+#define TRIT_FIX_MAX_FRAC 32 /**< The most fraction trits a fixed-point @c trit32_t can have */
+
+// FIXED-POINT FUNCTIONS
+trit32_t trit_fix_from_double(double value, int frac, bool *overflow);
+double trit_fix_to_double(trit32_t num, int frac);
+trit32_t trit_fix_mul(trit32_t a, trit32_t b, int frac, bool *overflow);
+trit32_t trit_fix_div(trit32_t a, trit32_t b, int frac, bool *overflow);
+trit32_t trit_fix_rescale(trit32_t num, int from_frac, int to_frac, bool *overflow);
+
+// BATCH FIXED-POINT FUNCTIONS
+void trit_fix_from_double_array(const double *values, trit32_t *out, size_t count, int frac, bool *overflow);
+void trit_fix_to_double_array(const trit32_t *nums, double *out, size_t count, int frac);
+void trit_fix_mul_array(const trit32_t *a, const trit32_t *b, trit32_t *out, size_t count, int frac, bool *overflow);
+
+// SCALAR FIXED-POINT KERNELS
+void trit_fix_from_double_scalar(const double *values, trit32_t *out, size_t count, int frac, bool *overflow);
+void trit_fix_to_double_scalar(const trit32_t *nums, double *out, size_t count, int frac);
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+// AVX2 FIXED-POINT KERNELS
+void trit_fix_from_double_avx2(const double *values, trit32_t *out, size_t count, int frac, bool *overflow);
+void trit_fix_to_double_avx2(const trit32_t *nums, double *out, size_t count, int frac);
+#endif
+
+#endif // __ternary_fixed_h__
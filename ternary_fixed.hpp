@@ -0,0 +1,360 @@
+#ifndef __ternary_fixed_hpp__
+#define __ternary_fixed_hpp__
+
+#include"ternary_fixed.h"
+
+/**
+ * @brief Balanced ternary fixed-point number.
+ *
+ * Holds a value with @p IntTrits whole trits and @p FracTrits
+ * fraction trits in one @c trit32_t, the value times 3^FracTrits
+ * stored as a balanced ternary integer. Products, quotients and
+ * shifts round to the nearest value. A result that does not fit
+ * keeps its low IntTrits + FracTrits trits. The checked_ members
+ * report that through a bool out-parameter and touch no other
+ * state. Like @c trit_add_trit32_t the constructor and operators
+ * are wrappers that set errno to EOVERFLOW instead.
+ *
+ * @tparam IntTrits The number of whole trits.
+ *
+ * @tparam FracTrits The number of fraction trits.
+ */
+template<int IntTrits, int FracTrits>
+class tritfix {
+
+    static_assert(IntTrits >= 0 && FracTrits >= 0 && IntTrits + FracTrits >= 1 && IntTrits + FracTrits <= 32,
+                  "a tritfix holds 1 to 32 trits");
+
+public:
+
+    static const int int_trits = IntTrits; /**< The number of whole trits */
+    static const int frac_trits = FracTrits; /**< The number of fraction trits */
+    static const int trits = IntTrits + FracTrits; /**< The number of trits */
+
+    trit32_t raw; /**< The value times 3^FracTrits in balanced ternary */
+
+    tritfix() : raw(0) {}
+
+    /**
+     * @brief Rounds @p value to the nearest fixed-point value.
+     *
+     * @param[in] value The number to convert.
+     */
+    explicit tritfix(double value){
+
+        bool overflow = false;
+
+        raw = checked_from_double(value, &overflow).raw;
+        report(overflow);
+    }
+
+    /**
+     * @brief Rounds @p value to the nearest fixed-point value.
+     *
+     * @param[in] value The number to convert.
+     *
+     * @param[out] overflow Set if @p value does not fit.
+     *
+     * @return The number
+     */
+    static tritfix checked_from_double(double value, bool *overflow){
+
+        trit32_t trits = trit_fix_from_double(value, FracTrits, overflow);
+
+        return from_raw(fit(trits, overflow));
+    }
+
+    /**
+     * @brief Makes a number from its stored trits.
+     *
+     * @param[in] trits The value times 3^FracTrits in balanced ternary.
+     *
+     * @return The number
+     */
+    static tritfix from_raw(trit32_t trits){
+
+        tritfix result;
+
+        result.raw = trits;
+
+        return result;
+    }
+
+    /**
+     * @brief Converts the number to the nearest @c double.
+     *
+     * @return The value
+     */
+    double to_double() const {
+
+        return trit_fix_to_double(raw, FracTrits);
+    }
+
+    explicit operator double() const {
+
+        return to_double();
+    }
+
+    /**
+     * @brief Adds @p other.
+     *
+     * @param[in] other The number to add.
+     *
+     * @param[out] overflow Set if the sum does not fit.
+     *
+     * @return The sum, wrapped to the width of the type
+     */
+    tritfix checked_add(tritfix other, bool *overflow) const {
+
+        trit32_t sum = trit_add_checked_trit32_t(raw, other.raw, overflow);
+
+        return from_raw(fit(sum, overflow));
+    }
+
+    /**
+     * @brief Subtracts @p other.
+     *
+     * @param[in] other The number to subtract.
+     *
+     * @param[out] overflow Set if the difference does not fit.
+     *
+     * @return The difference, wrapped to the width of the type
+     */
+    tritfix checked_sub(tritfix other, bool *overflow) const {
+
+        trit32_t difference = trit_sub_checked_trit32_t(raw, other.raw, overflow);
+
+        return from_raw(fit(difference, overflow));
+    }
+
+    /**
+     * @brief Multiplies by @p other, rounding to nearest.
+     *
+     * @param[in] other The number to multiply by.
+     *
+     * @param[out] overflow Set if the product does not fit.
+     *
+     * @return The product, wrapped to the width of the type
+     */
+    tritfix checked_mul(tritfix other, bool *overflow) const {
+
+        trit32_t product = trit_fix_mul(raw, other.raw, FracTrits, overflow);
+
+        return from_raw(fit(product, overflow));
+    }
+
+    /**
+     * @brief Divides by @p other, rounding to nearest.
+     *
+     * @param[in] other The divisor.
+     *
+     * @param[out] overflow Set if the quotient does not fit.
+     *
+     * @return The quotient, wrapped to the width of the type
+     */
+    tritfix checked_div(tritfix other, bool *overflow) const {
+
+        trit32_t quotient = trit_fix_div(raw, other.raw, FracTrits, overflow);
+
+        return from_raw(fit(quotient, overflow));
+    }
+
+    tritfix operator+(tritfix other) const {
+
+        bool overflow = false;
+        tritfix sum = checked_add(other, &overflow);
+
+        report(overflow);
+
+        return sum;
+    }
+
+    tritfix operator-(tritfix other) const {
+
+        bool overflow = false;
+        tritfix difference = checked_sub(other, &overflow);
+
+        report(overflow);
+
+        return difference;
+    }
+
+    tritfix operator-() const {
+
+        return from_raw(trit_not_trit32_t(raw));
+    }
+
+    tritfix operator*(tritfix other) const {
+
+        bool overflow = false;
+        tritfix product = checked_mul(other, &overflow);
+
+        report(overflow);
+
+        return product;
+    }
+
+    tritfix operator/(tritfix other) const {
+
+        bool overflow = false;
+        tritfix quotient = checked_div(other, &overflow);
+
+        report(overflow);
+
+        return quotient;
+    }
+
+    tritfix &operator+=(tritfix other){ return *this = *this + other; }
+    tritfix &operator-=(tritfix other){ return *this = *this - other; }
+    tritfix &operator*=(tritfix other){ return *this = *this * other; }
+    tritfix &operator/=(tritfix other){ return *this = *this / other; }
+
+    /**
+     * @brief Multiplies the number by 3^count, rounding to nearest.
+     *
+     * @param[in] count The power of three, negative to divide.
+     *
+     * @param[out] overflow Set if the shifted number does not fit.
+     *
+     * @return The shifted number
+     */
+    tritfix checked_shift(int count, bool *overflow) const {
+
+        *overflow = false;
+
+        if(count <= 0){
+
+            return from_raw(trit_sr_trit32_t(raw, (uint8_t)(count < -32 ? 32 : -count)));
+        }
+
+        *overflow = count >= 32 ? raw != 0 : (raw >> (64 - 2 * count)) != 0;
+
+        return from_raw(fit(trit_sl_trit32_t(raw, (uint8_t)(count > 32 ? 32 : count)), overflow));
+    }
+
+    /**
+     * @brief Multiplies the number by 3^count, rounding to nearest.
+     *
+     * @see checked_shift
+     *
+     * @param[in] count The power of three, negative to divide.
+     *
+     * @return The shifted number, errno is set to EOVERFLOW if it
+     * did not fit
+     */
+    tritfix shift(int count) const {
+
+        bool overflow = false;
+        tritfix result = checked_shift(count, &overflow);
+
+        report(overflow);
+
+        return result;
+    }
+
+    /**
+     * @brief Converts to another fixed-point format.
+     *
+     * Dropped fraction trits round to the nearest value.
+     *
+     * @param[out] overflow Set if the number does not fit the new
+     * format.
+     *
+     * @return The number in the new format
+     */
+    template<int ToInt, int ToFrac>
+    tritfix<ToInt, ToFrac> checked_rescale(bool *overflow) const {
+
+        trit32_t trits = trit_fix_rescale(raw, FracTrits, ToFrac, overflow);
+
+        return tritfix<ToInt, ToFrac>::from_raw(tritfix<ToInt, ToFrac>::fit(trits, overflow));
+    }
+
+    /**
+     * @brief Converts to another fixed-point format.
+     *
+     * @see checked_rescale
+     *
+     * @return The number in the new format, errno is set to
+     * EOVERFLOW if it did not fit
+     */
+    template<int ToInt, int ToFrac>
+    tritfix<ToInt, ToFrac> rescale() const {
+
+        bool overflow = false;
+        tritfix<ToInt, ToFrac> result = checked_rescale<ToInt, ToFrac>(&overflow);
+
+        report(overflow);
+
+        return result;
+    }
+
+    bool operator==(tritfix other) const { return raw == other.raw; }
+    bool operator!=(tritfix other) const { return raw != other.raw; }
+    bool operator<(tritfix other) const { return compare(other) < 0; }
+    bool operator>(tritfix other) const { return compare(other) > 0; }
+    bool operator<=(tritfix other) const { return compare(other) <= 0; }
+    bool operator>=(tritfix other) const { return compare(other) >= 0; }
+
+    /**
+     * @brief Keeps the low @c trits trits of a result.
+     *
+     * @param[in] trits The 32 trit result.
+     *
+     * @param[in,out] overflow Whether the result already overflowed
+     * 32 trits, also set if @p trits does not fit the type.
+     *
+     * @return @p trits wrapped to the width of the type
+     */
+    static trit32_t fit(trit32_t trits, bool *overflow){
+
+        const trit32_t mask = IntTrits + FracTrits == 32 ? ~0ULL : (1ULL << (2 * (IntTrits + FracTrits))) - 1;
+
+        if((trits & ~mask) != 0){
+
+            *overflow = true;
+        }
+
+        return trits & mask;
+    }
+
+private:
+
+    /**
+     * @brief Sets errno to EOVERFLOW for the unchecked wrappers.
+     *
+     * @param[in] overflow Whether the result did not fit.
+     */
+    static void report(bool overflow){
+
+        if(overflow){
+
+            errno = EOVERFLOW;
+        }
+    }
+
+    /**
+     * @brief Compares with @p other by the sign of the difference.
+     *
+     * Balanced ternary compares like a signed integer from the top
+     * trit down, so the first differing trit decides.
+     *
+     * @return -1, 0 or 1
+     */
+    int compare(tritfix other) const {
+
+        trit32_t differ = raw ^ other.raw;
+        int top = 0;
+
+        if(differ == 0){
+
+            return 0;
+        }
+
+        top = (63 - __builtin_clzll(differ)) & ~1;
+
+        return (int)((raw >> top) & 3) == 1 || (int)((other.raw >> top) & 3) == 3 ? 1 : -1;
+    }
+};
+
+#endif // __ternary_fixed_hpp__
@@ -0,0 +1,1081 @@
+/**
+ * @file ternary_float.c
+ *
+ * @brief File contains balanced ternary floating-point methods.
+ *
+ * A @c trit_float_t keeps a normalised 32 trit significand and a
+ * balanced 8 trit exponent. Sums are formed exactly in a 64 trit
+ * window with the add and shift methods in ternary.c, dropping
+ * the low trits of a balanced ternary number rounds it to the
+ * nearest value so the final right shift is already round to
+ * nearest. Products, quotients and square roots are found exactly
+ * with binary integers and scaled so they land on 32 trits.
+ *
+ * A result too large for the exponent is clamped to the largest
+ * number of its sign and a nonzero result too small for it
+ * becomes 0, both report @c TRIT_FLOAT_RANGE. There is no
+ * infinity or NaN, an invalid operation gives 0 and reports
+ * @c TRIT_FLOAT_DOMAIN. The _checked methods and the batches
+ * return the status, the plain methods set errno to ERANGE or
+ * EDOM instead.
+ */
+
+
+#include<errno.h>
+#include<math.h>
+#include<stdlib.h>
+
+#include"ternary_float.h"
+#include"ternary_thread.h"
+
+#define LOW_BITS 0x5555555555555555ULL /**< The low bit of every trit */
+#define ALL_BALS 0xFFFFFFFFFFFFFFFFULL /**< A @c trit32_t with every trit -1 */
+#define HALF_POW3_31 308836698141973LL /**< (3^31 - 1) / 2, the largest 31 trit value */
+#define QUARTER_POW3_32 463255047212960LL /**< 3^32 / 4 rounded down */
+#define FLOAT_GRAIN 4096 /**< Values per chunk of a threaded batch, each chunk gets one status */
+
+/**
+ * @brief Powers of three from 3^0 to 3^32.
+ */
+static const uint64_t POW3[TRIT_FLOAT_SIG_TRITS + 1] = {
+
+    1ULL, 3ULL, 9ULL, 27ULL, 81ULL, 243ULL, 729ULL, 2187ULL, 6561ULL, 19683ULL, 59049ULL,
+    177147ULL, 531441ULL, 1594323ULL, 4782969ULL, 14348907ULL, 43046721ULL, 129140163ULL,
+    387420489ULL, 1162261467ULL, 3486784401ULL, 10460353203ULL, 31381059609ULL,
+    94143178827ULL, 282429536481ULL, 847288609443ULL, 2541865828329ULL, 7625597484987ULL,
+    22876792454961ULL, 68630377364883ULL, 205891132094649ULL, 617673396283947ULL,
+    1853020188851841ULL
+};
+
+/**
+ * @brief The operation run by a threaded batch.
+ */
+typedef enum {
+    FLOAT_FROM_DOUBLE,
+    FLOAT_TO_DOUBLE,
+    FLOAT_ADD,
+    FLOAT_MUL,
+    FLOAT_DIV
+} float_op;
+
+/**
+ * @brief Arguments of one threaded batch shared by all threads.
+ */
+typedef struct {
+    float_op op; /**< The operation to run */
+    const trit_float_t *a; /**< The first operands */
+    const trit_float_t *b; /**< The second operands */
+    const double *values; /**< The doubles to convert */
+    trit_float_t *out; /**< The results of an arithmetic batch */
+    double *doubles; /**< The results of a conversion to double */
+    size_t count; /**< The number of values */
+    int *statuses; /**< The status of every chunk */
+} float_args;
+
+/**
+ * @brief Converts a whole binary number to balanced ternary.
+ *
+ * @param[in] value A whole number that fits 32 trits.
+ *
+ * @return The 32 trits of @p value
+ */
+static trit32_t whole_to_trits(int64_t value){
+
+    trit32_t result = binary_to_balanced_ternary_trit32_t((uint64_t)(value < 0 ? -value : value));
+
+    return value < 0 ? trit_not_trit32_t(result) : result;
+}
+
+/**
+ * @brief Converts a binary exponent to balanced ternary.
+ *
+ * @param[in] value An exponent from TRIT_FLOAT_EXP_MIN to TRIT_FLOAT_EXP_MAX.
+ *
+ * @return The 8 trits of @p value
+ */
+static trit8_t exponent_trits(int value){
+
+    trit8_t result = binary_to_balanced_ternary_trit8_t((uint16_t)(value < 0 ? -value : value));
+
+    return value < 0 ? trit_not_trit8_t(result) : result;
+}
+
+/**
+ * @brief Finds the highest nonzero trit.
+ *
+ * @param[in] num The trits to search.
+ *
+ * @return The position of the highest nonzero trit, -1 if @p num is 0
+ */
+static int top_trit(trit64_t num){
+
+    uint64_t high = (uint64_t)(num >> 64);
+    uint64_t low = (uint64_t)num;
+
+    if(high){
+
+        return 32 + (63 - __builtin_clzll(high)) / 2;
+    }
+
+    if(low){
+
+        return (63 - __builtin_clzll(low)) / 2;
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Gives the number of largest magnitude with the given sign.
+ *
+ * @param[in] negative True for the most negative number.
+ *
+ * @return The clamped number
+ */
+static trit_float_t largest(bool negative){
+
+    trit_float_t result;
+
+    result.significand = negative ? ALL_BALS : LOW_BITS;
+    result.exponent = exponent_trits(TRIT_FLOAT_EXP_MAX);
+
+    return result;
+}
+
+/**
+ * @brief Gives the number 0.
+ *
+ * @return A @c trit_float_t with every trit 0
+ */
+static trit_float_t zero(void){
+
+    trit_float_t result;
+
+    result.significand = 0;
+    result.exponent = 0;
+
+    return result;
+}
+
+/**
+ * @brief Rounds and normalises the number @p trits times 3^scale.
+ *
+ * Shifts the highest nonzero trit of @p trits to trit 31. A right
+ * shift drops trits and so rounds to nearest, a left shift is
+ * exact.
+ *
+ * @param[in] trits The balanced ternary digits of the number.
+ *
+ * @param[in] scale The power of three @p trits is multiplied by.
+ *
+ * @param[in,out] status Gets @c TRIT_FLOAT_RANGE if the exponent
+ * does not fit.
+ *
+ * @return The nearest @c trit_float_t
+ */
+static trit_float_t normalise(trit64_t trits, int64_t scale, int *status){
+
+    trit_float_t result;
+    int top = top_trit(trits);
+    int64_t exponent = 0;
+
+    if(top < 0){
+
+        return zero();
+    }
+
+    if(top > TRIT_FLOAT_SIG_TRITS - 1){
+
+        trits = trit_sr_trit64_t(trits, (uint8_t)(top - (TRIT_FLOAT_SIG_TRITS - 1)));
+    }
+    else{
+
+        trits = trit_sl_trit64_t(trits, (uint8_t)(TRIT_FLOAT_SIG_TRITS - 1 - top));
+    }
+
+    exponent = scale + top;
+
+    if(exponent > TRIT_FLOAT_EXP_MAX){
+
+        *status |= TRIT_FLOAT_RANGE;
+
+        return largest((trits >> 62) == 3);
+    }
+
+    if(exponent < TRIT_FLOAT_EXP_MIN){
+
+        *status |= TRIT_FLOAT_RANGE;
+
+        return zero();
+    }
+
+    result.significand = (trit32_t)trits;
+    result.exponent = exponent_trits((int)exponent);
+
+    return result;
+}
+
+/**
+ * @brief Rounds a quotient of binary integers to the nearest whole number.
+ *
+ * Starts from a @c double estimate of the quotient and corrects it
+ * with the exact remainder, which takes no 128 bit division.
+ *
+ * @param[in] num The dividend.
+ *
+ * @param[in] den The divisor, above 0.
+ *
+ * @param[in] estimate @p num / @p den to within a few units.
+ *
+ * @return @p num / @p den rounded to nearest, halves away from 0
+ */
+static int64_t round_div(__int128 num, int64_t den, double estimate){
+
+    int64_t quotient = (int64_t)estimate;
+    __int128 remainder = num - (__int128)quotient * den;
+
+    while(2 * remainder > den || (2 * remainder == den && num > 0)){
+
+        quotient++;
+        remainder -= den;
+    }
+
+    while(2 * remainder < -(__int128)den || (2 * remainder == -(__int128)den && num < 0)){
+
+        quotient--;
+        remainder += den;
+    }
+
+    return quotient;
+}
+
+/**
+ * @brief Finds the square root of a binary integer rounded to nearest.
+ *
+ * @param[in] num The number, below 2^104.
+ *
+ * @return The whole number nearest to the square root of @p num
+ */
+static uint64_t round_sqrt(unsigned __int128 num){
+
+    unsigned __int128 root = (unsigned __int128)sqrtl((long double)num);
+
+    while(root * root > num){
+
+        root--;
+    }
+
+    while((root + 1) * (root + 1) <= num){
+
+        root++;
+    }
+
+    // num is whole, so it is never exactly (root + 1/2)^2
+    if(num - root * root > root){
+
+        root++;
+    }
+
+    return (uint64_t)root;
+}
+
+/**
+ * @brief Multiplies by a whole power of three in extended precision.
+ *
+ * Powers up to 3^40 fit the 64 bit x87 significand, so within that
+ * range the scaling is a single correctly rounded multiply or
+ * divide. Larger powers are built by squaring.
+ *
+ * @param[in] value The number to scale.
+ *
+ * @param[in] power The power, negative powers divide.
+ *
+ * @return @p value times 3^power
+ */
+static long double scale3l(long double value, int power){
+
+    long double factor = 1;
+    long double base = 3;
+    unsigned int bits = (unsigned int)(power < 0 ? -power : power);
+
+    if(bits <= 40){
+
+        factor = (long double)POW3[bits / 2] * (long double)POW3[bits - bits / 2];
+    }
+    else{
+
+        while(bits){
+
+            if(bits & 1){
+
+                factor *= base;
+            }
+
+            base *= base;
+            bits >>= 1;
+        }
+    }
+
+    return power < 0 ? value / factor : value * factor;
+}
+
+/**
+ * @brief Reports a status through errno for the plain methods.
+ *
+ * @param[in] status The status of the operation.
+ */
+static void set_errno(int status){
+
+    if(status & TRIT_FLOAT_DOMAIN){
+
+        errno = EDOM;
+    }
+    else if(status & TRIT_FLOAT_RANGE){
+
+        errno = ERANGE;
+    }
+}
+
+/**
+ * @brief Gives the exponent of a floating-point number.
+ *
+ * @param[in] num The number.
+ *
+ * @return The exponent as a binary integer
+ */
+int trit_float_exponent(trit_float_t num){
+
+    return balanced_ternary_to_binary_int16_t(num.exponent);
+}
+
+/**
+ * @brief Converts a @c double to ternary floating-point.
+ *
+ * The scaling is done in x87 extended precision, so the result is
+ * the nearest @c trit_float_t unless @p value lies within a few
+ * parts in 2^64 of a halfway point. Infinities are clamped to the
+ * largest number and report @c TRIT_FLOAT_RANGE, NaN gives 0 and
+ * reports @c TRIT_FLOAT_DOMAIN.
+ *
+ * @param[in] value The number to convert.
+ *
+ * @param[out] status Set to 0, @c TRIT_FLOAT_RANGE or
+ * @c TRIT_FLOAT_DOMAIN.
+ *
+ * @return The nearest @c trit_float_t
+ */
+trit_float_t trit_float_from_double_checked(double value, int *status){
+
+    long double scaled = 0;
+    int binary = 0;
+    int exponent = 0;
+    int step = 0;
+
+    *status = 0;
+
+    if(value == 0){
+
+        return zero();
+    }
+
+    if(value != value){
+
+        *status = TRIT_FLOAT_DOMAIN;
+
+        return zero();
+    }
+
+    if(isinf(value)){
+
+        *status = TRIT_FLOAT_RANGE;
+
+        return largest(value < 0);
+    }
+
+    frexp(value, &binary);
+    exponent = (int)lrint(binary * 0.6309297535714575); // log3(2)
+
+    for(step = 0; step < 4; step++){
+
+        scaled = scale3l(value, TRIT_FLOAT_SIG_TRITS - 1 - exponent);
+
+        if(fabsl(scaled) > (long double)(POW3[TRIT_FLOAT_SIG_TRITS] / 2)){
+
+            exponent++;
+        }
+        else if(fabsl(scaled) <= (long double)HALF_POW3_31){
+
+            exponent--;
+        }
+        else{
+
+            break;
+        }
+    }
+
+    return normalise(trit_widen_trit32_t_to_trit64_t(whole_to_trits((int64_t)rintl(scaled))), exponent - (TRIT_FLOAT_SIG_TRITS - 1), status);
+}
+
+/**
+ * @brief Converts a @c double to ternary floating-point.
+ *
+ * @note Errors set errno to ERANGE or EDOM.
+ *
+ * @see trit_float_from_double_checked
+ *
+ * @param[in] value The number to convert.
+ *
+ * @return The nearest @c trit_float_t
+ */
+trit_float_t trit_float_from_double(double value){
+
+    int status = 0;
+    trit_float_t result = trit_float_from_double_checked(value, &status);
+
+    set_errno(status);
+
+    return result;
+}
+
+/**
+ * @brief Converts a ternary floating-point number to @c double.
+ *
+ * @param[in] num The number to convert.
+ *
+ * @return The nearest @c double, to within the extended precision
+ * scaling
+ */
+double trit_float_to_double(trit_float_t num){
+
+    int64_t significand = balanced_ternary_to_binary_int64_t(num.significand);
+
+    if(significand == 0){
+
+        return 0.0;
+    }
+
+    return (double)scale3l((long double)significand, trit_float_exponent(num) - (TRIT_FLOAT_SIG_TRITS - 1));
+}
+
+/**
+ * @brief Negates a ternary floating-point number.
+ *
+ * @param[in] num The number to negate.
+ *
+ * @return -@p num
+ */
+trit_float_t trit_float_neg(trit_float_t num){
+
+    num.significand = trit_not_trit32_t(num.significand);
+
+    return num;
+}
+
+/**
+ * @brief Adds two ternary floating-point numbers.
+ *
+ * The significand of the larger exponent is placed at trit 62 of
+ * a 64 trit window and the other one is shifted to line up. When
+ * it has to shift right it is rounded at trit 0 of the window,
+ * which lies 30 or more trits below the last kept trit, so the
+ * sum is still rounded correctly.
+ *
+ * @param[in] a The first number.
+ *
+ * @param[in] b The second number.
+ *
+ * @param[out] status Set to 0 or @c TRIT_FLOAT_RANGE.
+ *
+ * @return @p a + @p b rounded to nearest
+ */
+trit_float_t trit_float_add_checked(trit_float_t a, trit_float_t b, int *status){
+
+    trit_float_t swap;
+    trit64_t high = 0;
+    trit64_t low = 0;
+    bool overflow = false;
+    int distance = 0;
+
+    *status = 0;
+
+    if(a.significand == 0){
+
+        return b;
+    }
+
+    if(b.significand == 0){
+
+        return a;
+    }
+
+    distance = trit_float_exponent(a) - trit_float_exponent(b);
+
+    if(distance < 0){
+
+        swap = a;
+        a = b;
+        b = swap;
+        distance = -distance;
+    }
+
+    high = trit_sl_trit64_t(trit_widen_trit32_t_to_trit64_t(a.significand), TRIT_FLOAT_SIG_TRITS - 1);
+    low = trit_widen_trit32_t_to_trit64_t(b.significand);
+
+    if(distance <= TRIT_FLOAT_SIG_TRITS - 1){
+
+        low = trit_sl_trit64_t(low, (uint8_t)(TRIT_FLOAT_SIG_TRITS - 1 - distance));
+    }
+    else{
+
+        low = trit_sr_trit64_t(low, (uint8_t)(distance < 95 ? distance - (TRIT_FLOAT_SIG_TRITS - 1) : 64));
+    }
+
+    // both terms are below 3^63 / 2, so the sum fits 64 trits
+    high = trit_add_checked_trit64_t(high, low, &overflow);
+
+    return normalise(high, trit_float_exponent(a) - 2 * (TRIT_FLOAT_SIG_TRITS - 1), status);
+}
+
+/**
+ * @brief Adds two ternary floating-point numbers.
+ *
+ * @note Errors set errno to ERANGE.
+ *
+ * @see trit_float_add_checked
+ *
+ * @param[in] a The first number.
+ *
+ * @param[in] b The second number.
+ *
+ * @return @p a + @p b rounded to nearest
+ */
+trit_float_t trit_float_add(trit_float_t a, trit_float_t b){
+
+    int status = 0;
+    trit_float_t result = trit_float_add_checked(a, b, &status);
+
+    set_errno(status);
+
+    return result;
+}
+
+/**
+ * @brief Subtracts two ternary floating-point numbers.
+ *
+ * @param[in] a The number to subtract from.
+ *
+ * @param[in] b The number to subtract.
+ *
+ * @param[out] status Set to 0 or @c TRIT_FLOAT_RANGE.
+ *
+ * @return @p a - @p b rounded to nearest
+ */
+trit_float_t trit_float_sub_checked(trit_float_t a, trit_float_t b, int *status){
+
+    return trit_float_add_checked(a, trit_float_neg(b), status);
+}
+
+/**
+ * @brief Subtracts two ternary floating-point numbers.
+ *
+ * @note Errors set errno to ERANGE.
+ *
+ * @see trit_float_sub_checked
+ *
+ * @param[in] a The number to subtract from.
+ *
+ * @param[in] b The number to subtract.
+ *
+ * @return @p a - @p b rounded to nearest
+ */
+trit_float_t trit_float_sub(trit_float_t a, trit_float_t b){
+
+    return trit_float_add(a, trit_float_neg(b));
+}
+
+/**
+ * @brief Multiplies two ternary floating-point numbers.
+ *
+ * The exact product of the significands is divided by 3^30, 3^31
+ * or 3^32 so the rounded quotient has exactly 32 trits.
+ *
+ * @param[in] a The first number.
+ *
+ * @param[in] b The second number.
+ *
+ * @param[out] status Set to 0 or @c TRIT_FLOAT_RANGE.
+ *
+ * @return @p a * @p b rounded to nearest
+ */
+trit_float_t trit_float_mul_checked(trit_float_t a, trit_float_t b, int *status){
+
+    int64_t left = balanced_ternary_to_binary_int64_t(a.significand);
+    int64_t right = balanced_ternary_to_binary_int64_t(b.significand);
+    __int128 product = (__int128)left * right;
+    __int128 magnitude = product < 0 ? -product : product;
+    int scale = TRIT_FLOAT_SIG_TRITS - 1;
+
+    *status = 0;
+
+    if(product == 0){
+
+        return zero();
+    }
+
+    // the product of two normalised significands lies in [3^62 / 4, 3^64 / 4)
+    if(magnitude < (__int128)HALF_POW3_31 * POW3[TRIT_FLOAT_SIG_TRITS - 1]){
+
+        scale--;
+    }
+    else if(magnitude >= (__int128)(POW3[TRIT_FLOAT_SIG_TRITS] / 2) * POW3[TRIT_FLOAT_SIG_TRITS - 1]){
+
+        scale++;
+    }
+
+    return normalise(trit_widen_trit32_t_to_trit64_t(whole_to_trits(round_div(product, (int64_t)POW3[scale], (double)left * (double)right / (double)POW3[scale]))),
+                     trit_float_exponent(a) + trit_float_exponent(b) - 2 * (TRIT_FLOAT_SIG_TRITS - 1) + scale, status);
+}
+
+/**
+ * @brief Multiplies two ternary floating-point numbers.
+ *
+ * @note Errors set errno to ERANGE.
+ *
+ * @see trit_float_mul_checked
+ *
+ * @param[in] a The first number.
+ *
+ * @param[in] b The second number.
+ *
+ * @return @p a * @p b rounded to nearest
+ */
+trit_float_t trit_float_mul(trit_float_t a, trit_float_t b){
+
+    int status = 0;
+    trit_float_t result = trit_float_mul_checked(a, b, &status);
+
+    set_errno(status);
+
+    return result;
+}
+
+/**
+ * @brief Divides two ternary floating-point numbers.
+ *
+ * The dividend is scaled by 3^30, 3^31 or 3^32 so the rounded
+ * quotient of the significands has exactly 32 trits. Dividing a
+ * nonzero number by 0 clamps to the largest number and reports
+ * @c TRIT_FLOAT_RANGE, 0 / 0 gives 0 and reports
+ * @c TRIT_FLOAT_DOMAIN.
+ *
+ * @param[in] a The dividend.
+ *
+ * @param[in] b The divisor.
+ *
+ * @param[out] status Set to 0, @c TRIT_FLOAT_RANGE or
+ * @c TRIT_FLOAT_DOMAIN.
+ *
+ * @return @p a / @p b rounded to nearest, halves away from 0
+ */
+trit_float_t trit_float_div_checked(trit_float_t a, trit_float_t b, int *status){
+
+    int64_t dividend = balanced_ternary_to_binary_int64_t(a.significand);
+    int64_t divisor = balanced_ternary_to_binary_int64_t(b.significand);
+    int64_t top = llabs(dividend);
+    int64_t bottom = llabs(divisor);
+    int scale = TRIT_FLOAT_SIG_TRITS - 1;
+
+    *status = 0;
+
+    if(divisor == 0){
+
+        *status = dividend == 0 ? TRIT_FLOAT_DOMAIN : TRIT_FLOAT_RANGE;
+
+        return dividend == 0 ? zero() : largest(dividend < 0);
+    }
+
+    if(dividend == 0){
+
+        return zero();
+    }
+
+    // the ratio of two normalised significands lies in (1/3, 3)
+    if(2 * top < bottom){
+
+        scale++;
+    }
+    else if(2 * top >= 3 * bottom){
+
+        scale--;
+    }
+
+    // the divisor's sign moves to the dividend so round_div sees a positive divisor
+    dividend = divisor < 0 ? -dividend : dividend;
+
+    return normalise(trit_widen_trit32_t_to_trit64_t(whole_to_trits(round_div((__int128)dividend * POW3[scale], bottom, (double)dividend * (double)POW3[scale] / (double)bottom))),
+                     trit_float_exponent(a) - trit_float_exponent(b) - scale, status);
+}
+
+/**
+ * @brief Divides two ternary floating-point numbers.
+ *
+ * @note Errors set errno to ERANGE or EDOM.
+ *
+ * @see trit_float_div_checked
+ *
+ * @param[in] a The dividend.
+ *
+ * @param[in] b The divisor.
+ *
+ * @return @p a / @p b rounded to nearest, halves away from 0
+ */
+trit_float_t trit_float_div(trit_float_t a, trit_float_t b){
+
+    int status = 0;
+    trit_float_t result = trit_float_div_checked(a, b, &status);
+
+    set_errno(status);
+
+    return result;
+}
+
+/**
+ * @brief Finds the square root of a ternary floating-point number.
+ *
+ * The significand is scaled by 3^30, 3^31 or 3^32 so the exponent
+ * left over is even and the rounded root has exactly 32 trits.
+ * A negative number gives 0 and reports @c TRIT_FLOAT_DOMAIN.
+ *
+ * @param[in] num The number.
+ *
+ * @param[out] status Set to 0 or @c TRIT_FLOAT_DOMAIN.
+ *
+ * @return The square root of @p num rounded to nearest
+ */
+trit_float_t trit_float_sqrt_checked(trit_float_t num, int *status){
+
+    int64_t significand = balanced_ternary_to_binary_int64_t(num.significand);
+    int exponent = trit_float_exponent(num) - (TRIT_FLOAT_SIG_TRITS - 1);
+    int scale = TRIT_FLOAT_SIG_TRITS - 1;
+
+    *status = 0;
+
+    if(significand <= 0){
+
+        if(significand < 0){
+
+            *status = TRIT_FLOAT_DOMAIN;
+        }
+
+        return zero();
+    }
+
+    if(!(exponent & 1)){
+
+        scale = significand <= QUARTER_POW3_32 ? TRIT_FLOAT_SIG_TRITS : TRIT_FLOAT_SIG_TRITS - 2;
+    }
+
+    return normalise(trit_widen_trit32_t_to_trit64_t(whole_to_trits((int64_t)round_sqrt((unsigned __int128)significand * POW3[scale]))),
+                     (exponent - scale) / 2, status);
+}
+
+/**
+ * @brief Finds the square root of a ternary floating-point number.
+ *
+ * @note Errors set errno to EDOM.
+ *
+ * @see trit_float_sqrt_checked
+ *
+ * @param[in] num The number.
+ *
+ * @return The square root of @p num rounded to nearest
+ */
+trit_float_t trit_float_sqrt(trit_float_t num){
+
+    int status = 0;
+    trit_float_t result = trit_float_sqrt_checked(num, &status);
+
+    set_errno(status);
+
+    return result;
+}
+
+/**
+ * @brief Compares two ternary floating-point numbers.
+ *
+ * @param[in] a The first number.
+ *
+ * @param[in] b The second number.
+ *
+ * @return -1, 0 or 1 as @p a is less than, equal to or greater than @p b
+ */
+int trit_float_compare(trit_float_t a, trit_float_t b){
+
+    int64_t left = balanced_ternary_to_binary_int64_t(a.significand);
+    int64_t right = balanced_ternary_to_binary_int64_t(b.significand);
+    int sign = left < 0 ? -1 : 1;
+    int left_exponent = trit_float_exponent(a);
+    int right_exponent = trit_float_exponent(b);
+
+    if((left < 0) != (right < 0) || left == 0 || right == 0){
+
+        return (left > right) - (left < right);
+    }
+
+    if(left_exponent != right_exponent){
+
+        return left_exponent > right_exponent ? sign : -sign;
+    }
+
+    return (left > right) - (left < right);
+}
+
+/**
+ * @brief Runs the values [@p start, @p end) of a batch.
+ *
+ * @param[in] args The batch.
+ *
+ * @param[in] start The first index.
+ *
+ * @param[in] end One past the last index.
+ *
+ * @return The status of every value ORed together
+ */
+static int float_values(const float_args *args, size_t start, size_t end){
+
+    size_t index = 0;
+    int status = 0;
+    int result = 0;
+
+    switch(args->op){
+
+        case FLOAT_FROM_DOUBLE:
+            for(index = start; index < end; index++){
+
+                args->out[index] = trit_float_from_double_checked(args->values[index], &status);
+                result |= status;
+            }
+            break;
+
+        case FLOAT_TO_DOUBLE:
+            for(index = start; index < end; index++){
+
+                args->doubles[index] = trit_float_to_double(args->a[index]);
+            }
+            break;
+
+        case FLOAT_ADD:
+            for(index = start; index < end; index++){
+
+                args->out[index] = trit_float_add_checked(args->a[index], args->b[index], &status);
+                result |= status;
+            }
+            break;
+
+        case FLOAT_MUL:
+            for(index = start; index < end; index++){
+
+                args->out[index] = trit_float_mul_checked(args->a[index], args->b[index], &status);
+                result |= status;
+            }
+            break;
+
+        case FLOAT_DIV:
+            for(index = start; index < end; index++){
+
+                args->out[index] = trit_float_div_checked(args->a[index], args->b[index], &status);
+                result |= status;
+            }
+            break;
+    }
+
+    return result;
+}
+
+/**
+ * @brief Runs the chunks [@p start, @p end) of a threaded batch.
+ *
+ * @param[in] arg The shared @c float_args.
+ *
+ * @param[in] start The first chunk.
+ *
+ * @param[in] end One past the last chunk.
+ */
+static void float_range(void *arg, size_t start, size_t end){
+
+    const float_args *args = (const float_args *)arg;
+    size_t chunk = 0;
+    size_t last = 0;
+
+    for(chunk = start; chunk < end; chunk++){
+
+        last = args->count - chunk * FLOAT_GRAIN < FLOAT_GRAIN ? args->count : (chunk + 1) * FLOAT_GRAIN;
+
+        args->statuses[chunk] = float_values(args, chunk * FLOAT_GRAIN, last);
+    }
+}
+
+/**
+ * @brief Runs a batch over @p count values on up to @p threads threads.
+ *
+ * Every chunk keeps its own status and they are ORed together
+ * once the threads are done, so the result does not depend on
+ * @p threads.
+ *
+ * @param[in,out] args The batch to run.
+ *
+ * @param[in] count The number of values.
+ *
+ * @param[in] threads The number of threads, 0 or less means one per CPU.
+ *
+ * @return The status of every value ORed together
+ */
+static int float_batch(float_args *args, size_t count, int threads){
+
+    size_t chunks = (count + FLOAT_GRAIN - 1) / FLOAT_GRAIN;
+    size_t chunk = 0;
+    int status = 0;
+
+    args->count = count;
+    args->statuses = NULL;
+
+    if(chunks > 1){
+
+        args->statuses = (int *)malloc(chunks * sizeof(int));
+    }
+
+    if(args->statuses == NULL){
+
+        // one chunk, or no memory for the statuses
+        return float_values(args, 0, count);
+    }
+
+    trit_parallel_for(chunks, 1, threads, float_range, args);
+
+    for(chunk = 0; chunk < chunks; chunk++){
+
+        status |= args->statuses[chunk];
+    }
+
+    free(args->statuses);
+
+    return status;
+}
+
+/**
+ * @brief Converts an array of @c double to ternary floating-point.
+ *
+ * @param[in] values The numbers to convert.
+ *
+ * @param[out] out The converted numbers, @p count of them.
+ *
+ * @param[in] count The number of values.
+ *
+ * @param[in] threads The number of threads, 0 or less means one per CPU.
+ *
+ * @param[out] status Set to the status of every conversion ORed
+ * together, 0 if none failed.
+ *
+ * @see trit_float_from_double_checked
+ */
+void trit_float_from_double_array(const double *values, trit_float_t *out, size_t count, int threads, int *status){
+
+    float_args args = {FLOAT_FROM_DOUBLE, NULL, NULL, values, out, NULL, 0, NULL};
+
+    *status = float_batch(&args, count, threads);
+}
+
+/**
+ * @brief Converts an array of ternary floating-point numbers to @c double.
+ *
+ * @param[in] nums The numbers to convert.
+ *
+ * @param[out] out The converted numbers, @p count of them.
+ *
+ * @param[in] count The number of values.
+ *
+ * @param[in] threads The number of threads, 0 or less means one per CPU.
+ *
+ * @see trit_float_to_double
+ */
+void trit_float_to_double_array(const trit_float_t *nums, double *out, size_t count, int threads){
+
+    float_args args = {FLOAT_TO_DOUBLE, nums, NULL, NULL, NULL, out, 0, NULL};
+
+    float_batch(&args, count, threads);
+}
+
+/**
+ * @brief Adds two arrays of ternary floating-point numbers.
+ *
+ * @param[in] a The first operands.
+ *
+ * @param[in] b The second operands.
+ *
+ * @param[out] out The sums, @p count of them.
+ *
+ * @param[in] count The number of values.
+ *
+ * @param[in] threads The number of threads, 0 or less means one per CPU.
+ *
+ * @param[out] status Set to the status of every sum ORed
+ * together, 0 if none was out of range.
+ *
+ * @see trit_float_add_checked
+ */
+void trit_float_add_array(const trit_float_t *a, const trit_float_t *b, trit_float_t *out, size_t count, int threads, int *status){
+
+    float_args args = {FLOAT_ADD, a, b, NULL, out, NULL, 0, NULL};
+
+    *status = float_batch(&args, count, threads);
+}
+
+/**
+ * @brief Multiplies two arrays of ternary floating-point numbers.
+ *
+ * @param[in] a The first operands.
+ *
+ * @param[in] b The second operands.
+ *
+ * @param[out] out The products, @p count of them.
+ *
+ * @param[in] count The number of values.
+ *
+ * @param[in] threads The number of threads, 0 or less means one per CPU.
+ *
+ * @param[out] status Set to the status of every product ORed
+ * together, 0 if none was out of range.
+ *
+ * @see trit_float_mul_checked
+ */
+void trit_float_mul_array(const trit_float_t *a, const trit_float_t *b, trit_float_t *out, size_t count, int threads, int *status){
+
+    float_args args = {FLOAT_MUL, a, b, NULL, out, NULL, 0, NULL};
+
+    *status = float_batch(&args, count, threads);
+}
+
+/**
+ * @brief Divides two arrays of ternary floating-point numbers.
+ *
+ * @param[in] a The dividends.
+ *
+ * @param[in] b The divisors.
+ *
+ * @param[out] out The quotients, @p count of them.
+ *
+ * @param[in] count The number of values.
+ *
+ * @param[in] threads The number of threads, 0 or less means one per CPU.
+ *
+ * @param[out] status Set to the status of every quotient ORed
+ * together, 0 if none failed.
+ *
+ * @see trit_float_div_checked
+ */
+void trit_float_div_array(const trit_float_t *a, const trit_float_t *b, trit_float_t *out, size_t count, int threads, int *status){
+
+    float_args args = {FLOAT_DIV, a, b, NULL, out, NULL, 0, NULL};
+
+    *status = float_batch(&args, count, threads);
+}
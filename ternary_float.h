@@ -0,0 +1,53 @@
+#ifndef __ternary_float_h__
+#define __ternary_float_h__
+
+#include<stddef.h>
+#include"ternary.h"
+
+#define TRIT_FLOAT_SIG_TRITS 32 /**< The number of significand trits */
+#define TRIT_FLOAT_EXP_MAX 3280 /**< The largest exponent, (3^8 - 1) / 2 */
+#define TRIT_FLOAT_EXP_MIN -3280 /**< The smallest exponent of a nonzero number */
+#define TRIT_FLOAT_RANGE 1 /**< Status of a result clamped to the largest number or flushed to 0 */
+#define TRIT_FLOAT_DOMAIN 2 /**< Status of an operation with no result, which gives 0 */
+
+/**
+ * @brief A balanced ternary floating-point number.
+ *
+ * The value is significand times 3^(exponent - 31), so the
+ * significand reads as one whole trit followed by 31 fraction
+ * trits. A nonzero number is normalised, its trit 31 is +1 or
+ * -1 and its magnitude lies in [0.5, 1.5) times 3^exponent.
+ * Zero has every trit of both fields 0.
+ */
+typedef struct{
+
+    trit32_t significand; /**< Balanced significand, trit 31 nonzero unless the number is 0 */
+    trit8_t exponent;     /**< Balanced exponent, TRIT_FLOAT_EXP_MIN to TRIT_FLOAT_EXP_MAX */
+} trit_float_t;
+
+// FLOATING-POINT FUNCTIONS
+trit_float_t trit_float_from_double_checked(double value, int *status);
+trit_float_t trit_float_add_checked(trit_float_t a, trit_float_t b, int *status);
+trit_float_t trit_float_sub_checked(trit_float_t a, trit_float_t b, int *status);
+trit_float_t trit_float_mul_checked(trit_float_t a, trit_float_t b, int *status);
+trit_float_t trit_float_div_checked(trit_float_t a, trit_float_t b, int *status);
+trit_float_t trit_float_sqrt_checked(trit_float_t num, int *status);
+trit_float_t trit_float_from_double(double value);
+double trit_float_to_double(trit_float_t num);
+int trit_float_exponent(trit_float_t num);
+trit_float_t trit_float_neg(trit_float_t num);
+trit_float_t trit_float_add(trit_float_t a, trit_float_t b);
+trit_float_t trit_float_sub(trit_float_t a, trit_float_t b);
+trit_float_t trit_float_mul(trit_float_t a, trit_float_t b);
+trit_float_t trit_float_div(trit_float_t a, trit_float_t b);
+trit_float_t trit_float_sqrt(trit_float_t num);
+int trit_float_compare(trit_float_t a, trit_float_t b);
+
+// BATCH FLOATING-POINT FUNCTIONS
+void trit_float_from_double_array(const double *values, trit_float_t *out, size_t count, int threads, int *status);
+void trit_float_to_double_array(const trit_float_t *nums, double *out, size_t count, int threads);
+void trit_float_add_array(const trit_float_t *a, const trit_float_t *b, trit_float_t *out, size_t count, int threads, int *status);
+void trit_float_mul_array(const trit_float_t *a, const trit_float_t *b, trit_float_t *out, size_t count, int threads, int *status);
+void trit_float_div_array(const trit_float_t *a, const trit_float_t *b, trit_float_t *out, size_t count, int threads, int *status);
+
+#endif // __ternary_float_h__
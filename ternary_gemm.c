@@ -0,0 +1,450 @@
+/**
+ * @file ternary_gemm.c
+ *
+ * @brief File contains ternary weight matrix multiply methods.
+ *
+ * This file contains matrix-vector and matrix-matrix multiply
+ * where the weight matrix is balanced ternary packed in
+ * @c trit32_t words, one row after the other with every row
+ * padded to whole words. The activations and results are
+ * @c float. The work is cut into blocks of columns that fit in
+ * cache and register tiles of rows times activation vectors,
+ * and the rows are split between threads.
+ */
+
+
+#include<string.h>
+
+#include"ternary_gemm.h"
+#include"ternary_dot.h"
+#include"ternary_cpu.h"
+#include"ternary_thread.h"
+
+#define TRITS_PER_WORD 32 /**< Number of trits packed in a @c trit32_t */
+#define TILE_ROWS 4 /**< Weight rows in one register tile */
+#define TILE_VECTORS 4 /**< Activation vectors in one register tile */
+#define BLOCK_WORDS 64 /**< Weight words per row in one cache block */
+
+/**
+ * @brief Multiplies one register tile over a block of columns.
+ *
+ * Adds the product of @p nr weight rows and @p nb activation
+ * vectors, over the words [@p k0, @p k1) of each row, to @p y.
+ *
+ * @param[in] weights The first row of the tile.
+ *
+ * @param[in] row_words Words per weight row.
+ *
+ * @param[in] nr The number of rows, at most @c TILE_ROWS.
+ *
+ * @param[in] x The first activation vector of the tile.
+ *
+ * @param[in] cols The number of activations per vector.
+ *
+ * @param[in] nb The number of vectors, at most @c TILE_VECTORS.
+ *
+ * @param[in] k0 The first word of the block.
+ *
+ * @param[in] k1 One past the last word of the block.
+ *
+ * @param[out] y The result of the first row and vector of the tile.
+ *
+ * @param[in] rows The number of results per vector.
+ */
+typedef void (*gemm_tile_fn)(const trit32_t *weights, size_t row_words, size_t nr,
+                             const float *x, size_t cols, size_t nb,
+                             size_t k0, size_t k1, float *y, size_t rows);
+
+/**
+ * @brief Arguments of one matrix multiply shared by all threads.
+ */
+typedef struct {
+    const trit32_t *weights; /**< The packed weight matrix */
+    size_t rows; /**< Rows of the weight matrix */
+    size_t cols; /**< Columns of the weight matrix */
+    const float *x; /**< The @c batch activation vectors of @c cols values */
+    size_t batch; /**< Number of activation vectors */
+    float *y; /**< The @c batch result vectors of @c rows values */
+    gemm_tile_fn tile; /**< The tile kernel picked for this CPU */
+} gemm_args;
+
+/**
+ * @brief Scalar tile kernel.
+ *
+ * @see gemm_tile_fn
+ * @see trit_dot_scalar_float
+ */
+static void gemm_tile_scalar(const trit32_t *weights, size_t row_words, size_t nr,
+                             const float *x, size_t cols, size_t nb,
+                             size_t k0, size_t k1, float *y, size_t rows){
+
+    size_t row = 0;
+    size_t vector = 0;
+
+    for(row = 0; row < nr; row++){
+
+        for(vector = 0; vector < nb; vector++){
+
+            y[vector * rows + row] += trit_dot_scalar_float(weights + row * row_words + k0,
+                                                            x + vector * cols + k0 * TRITS_PER_WORD,
+                                                            (k1 - k0) * TRITS_PER_WORD);
+        }
+    }
+}
+
+#ifdef TERNARY_X86_64
+/**
+ * @brief AVX2 tile kernel for two rows.
+ *
+ * For every group of 8 trits the lane masks of both rows are
+ * built once and applied to all vectors of the tile.
+ *
+ * @see gemm_tile_fn
+ * @see trit_dot_avx2_float
+ */
+__attribute__((target("avx2"), always_inline))
+static inline void gemm_pair_avx2(const trit32_t *weights, size_t row_words, size_t nr,
+                                  const float *x, size_t cols, size_t nb,
+                                  size_t k0, size_t k1, float *y, size_t rows){
+
+    const __m256i mag_bits = _mm256_setr_epi32(0x0001, 0x0004, 0x0010, 0x0040,
+                                               0x0100, 0x0400, 0x1000, 0x4000);
+    const __m256i sign_bits = _mm256_slli_epi32(mag_bits, 1);
+    const __m256i sign_flip = _mm256_set1_epi32((int)0x80000000);
+    __m256 acc[2][TILE_VECTORS];
+    __m256 mag[2];
+    __m256 sign[2];
+    __m256i group;
+    __m256 in;
+    float sums[8];
+    size_t word = 0;
+    size_t row = 0;
+    size_t vector = 0;
+    int part = 0;
+    int lane = 0;
+
+    for(row = 0; row < 2; row++){
+
+        for(vector = 0; vector < TILE_VECTORS; vector++){
+
+            acc[row][vector] = _mm256_setzero_ps();
+        }
+    }
+
+    for(word = k0; word < k1; word++){
+
+        for(part = 0; part < 4; part++){
+
+            for(row = 0; row < 2; row++){
+
+                group = _mm256_set1_epi32((int)((weights[(row < nr ? row : 0) * row_words + word]
+                                                 >> (part * 16)) & 0xFFFF));
+                mag[row] = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(group, mag_bits),
+                                                                  mag_bits));
+                sign[row] = _mm256_castsi256_ps(_mm256_and_si256(
+                    _mm256_cmpeq_epi32(_mm256_and_si256(group, sign_bits), sign_bits), sign_flip));
+            }
+
+            for(vector = 0; vector < TILE_VECTORS; vector++){
+
+                if(vector < nb){
+
+                    in = _mm256_loadu_ps(x + vector * cols + word * TRITS_PER_WORD + part * 8);
+
+                    for(row = 0; row < 2; row++){
+
+                        acc[row][vector] = _mm256_add_ps(acc[row][vector],
+                            _mm256_and_ps(_mm256_xor_ps(in, sign[row]), mag[row]));
+                    }
+                }
+            }
+        }
+    }
+
+    for(row = 0; row < nr; row++){
+
+        for(vector = 0; vector < nb; vector++){
+
+            _mm256_storeu_ps(sums, acc[row][vector]);
+
+            for(lane = 0; lane < 8; lane++){
+
+                y[vector * rows + row] += sums[lane];
+            }
+        }
+    }
+}
+
+/**
+ * @brief AVX2 tile kernel.
+ *
+ * Runs @c gemm_pair_avx2 on each pair of rows so the
+ * accumulators and masks fit in the 16 ymm registers.
+ *
+ * @see gemm_tile_fn
+ */
+__attribute__((target("avx2")))
+static void gemm_tile_avx2(const trit32_t *weights, size_t row_words, size_t nr,
+                           const float *x, size_t cols, size_t nb,
+                           size_t k0, size_t k1, float *y, size_t rows){
+
+    size_t row = 0;
+
+    for(row = 0; row < nr; row += 2){
+
+        if(nb == 1){
+
+            gemm_pair_avx2(weights + row * row_words, row_words, nr - row < 2 ? nr - row : 2,
+                           x, cols, 1, k0, k1, y + row, rows);
+        }
+        else{
+
+            gemm_pair_avx2(weights + row * row_words, row_words, nr - row < 2 ? nr - row : 2,
+                           x, cols, nb, k0, k1, y + row, rows);
+        }
+    }
+}
+
+/**
+ * @brief AVX-512 tile kernel body.
+ *
+ * Every weight word is split with pext into +1 and -1 masks
+ * once per row, then each pair of activation loads is added
+ * or subtracted into all row accumulators with masked adds.
+ *
+ * @see gemm_tile_fn
+ * @see trit_dot_avx512_float
+ */
+__attribute__((target("avx512f,avx512bw,bmi2"), always_inline))
+static inline void gemm_body_avx512(const trit32_t *weights, size_t row_words, size_t nr,
+                                    const float *x, size_t cols, size_t nb,
+                                    size_t k0, size_t k1, float *y, size_t rows){
+
+    const uint64_t low_bits = 0x5555555555555555ULL;
+    __m512 acc[TILE_ROWS][TILE_VECTORS];
+    uint32_t pos[TILE_ROWS];
+    uint32_t neg[TILE_ROWS];
+    uint32_t mag = 0;
+    uint32_t sign = 0;
+    trit32_t grab = 0;
+    __m512 low, high;
+    size_t word = 0;
+    size_t row = 0;
+    size_t vector = 0;
+
+    for(row = 0; row < TILE_ROWS; row++){
+
+        for(vector = 0; vector < TILE_VECTORS; vector++){
+
+            acc[row][vector] = _mm512_setzero_ps();
+        }
+    }
+
+    for(word = k0; word < k1; word++){
+
+        for(row = 0; row < TILE_ROWS; row++){
+
+            grab = row < nr ? weights[row * row_words + word] : 0;
+            mag = (uint32_t)_pext_u64(grab, low_bits);
+            sign = (uint32_t)_pext_u64(grab >> 1, low_bits);
+
+            pos[row] = mag & ~sign;
+            neg[row] = mag & sign;
+        }
+
+        for(vector = 0; vector < TILE_VECTORS; vector++){
+
+            if(vector < nb){
+
+                low = _mm512_loadu_ps(x + vector * cols + word * TRITS_PER_WORD);
+                high = _mm512_loadu_ps(x + vector * cols + word * TRITS_PER_WORD + 16);
+
+                for(row = 0; row < TILE_ROWS; row++){
+
+                    acc[row][vector] = _mm512_mask_add_ps(acc[row][vector], (__mmask16)pos[row],
+                                                          acc[row][vector], low);
+                    acc[row][vector] = _mm512_mask_sub_ps(acc[row][vector], (__mmask16)neg[row],
+                                                          acc[row][vector], low);
+                    acc[row][vector] = _mm512_mask_add_ps(acc[row][vector], (__mmask16)(pos[row] >> 16),
+                                                          acc[row][vector], high);
+                    acc[row][vector] = _mm512_mask_sub_ps(acc[row][vector], (__mmask16)(neg[row] >> 16),
+                                                          acc[row][vector], high);
+                }
+            }
+        }
+    }
+
+    for(row = 0; row < nr; row++){
+
+        for(vector = 0; vector < nb; vector++){
+
+            y[vector * rows + row] += _mm512_reduce_add_ps(acc[row][vector]);
+        }
+    }
+}
+
+/**
+ * @brief AVX-512 tile kernel.
+ *
+ * Specializes @c gemm_body_avx512 for a single vector
+ * so matrix-vector multiply keeps everything in registers.
+ *
+ * @see gemm_tile_fn
+ */
+__attribute__((target("avx512f,avx512bw,bmi2")))
+static void gemm_tile_avx512(const trit32_t *weights, size_t row_words, size_t nr,
+                             const float *x, size_t cols, size_t nb,
+                             size_t k0, size_t k1, float *y, size_t rows){
+
+    if(nb == 1){
+
+        gemm_body_avx512(weights, row_words, nr, x, cols, 1, k0, k1, y, rows);
+    }
+    else{
+
+        gemm_body_avx512(weights, row_words, nr, x, cols, nb, k0, k1, y, rows);
+    }
+}
+#endif
+
+/**
+ * @brief Multiplies the rows [@p start, @p end) of the weight matrix.
+ *
+ * Walks blocks of @c BLOCK_WORDS columns so the activations of one
+ * tile of vectors stay in cache while all rows of the range pass
+ * over them. The trits of a partial last word are done one by one.
+ *
+ * @param[in] arg The @c gemm_args of the multiply.
+ *
+ * @param[in] start The first row.
+ *
+ * @param[in] end One past the last row.
+ */
+static void gemm_rows(void *arg, size_t start, size_t end){
+
+    const gemm_args *args = (const gemm_args *)arg;
+    size_t row_words = TRIT_ROW_WORDS(args->cols);
+    size_t full_words = args->cols / TRITS_PER_WORD;
+    size_t tail = args->cols % TRITS_PER_WORD;
+    size_t k0 = 0;
+    size_t k1 = 0;
+    size_t vector = 0;
+    size_t row = 0;
+    size_t nb = 0;
+    size_t nr = 0;
+
+    for(vector = 0; vector < args->batch; vector++){
+
+        memset(args->y + vector * args->rows + start, 0, (end - start) * sizeof(float));
+    }
+
+    for(k0 = 0; k0 < full_words; k0 = k1){
+
+        k1 = k0 + BLOCK_WORDS < full_words ? k0 + BLOCK_WORDS : full_words;
+
+        for(vector = 0; vector < args->batch; vector += TILE_VECTORS){
+
+            nb = args->batch - vector < TILE_VECTORS ? args->batch - vector : TILE_VECTORS;
+
+            for(row = start; row < end; row += TILE_ROWS){
+
+                nr = end - row < TILE_ROWS ? end - row : TILE_ROWS;
+
+                args->tile(args->weights + row * row_words, row_words, nr,
+                           args->x + vector * args->cols, args->cols, nb,
+                           k0, k1, args->y + vector * args->rows + row, args->rows);
+            }
+        }
+    }
+
+    if(tail != 0){
+
+        for(vector = 0; vector < args->batch; vector++){
+
+            for(row = start; row < end; row++){
+
+                args->y[vector * args->rows + row] +=
+                    trit_dot_scalar_float(args->weights + row * row_words + full_words,
+                                          args->x + vector * args->cols + full_words * TRITS_PER_WORD,
+                                          tail);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Multiplies a ternary weight matrix with a batch of vectors.
+ *
+ * Computes y[b][r] = sum over c of weights[r][c] * x[b][c] for
+ * every row r and vector b. Row r of @p weights starts at word
+ * r * @c TRIT_ROW_WORDS(@p cols) with trit c in word c / 32.
+ *
+ * @warning Weights must be in balanced ternary.
+ *
+ * @param[in] weights The @p rows by @p cols packed weight matrix.
+ *
+ * @param[in] rows The number of weight rows.
+ *
+ * @param[in] cols The number of weight columns.
+ *
+ * @param[in] x The @p batch activation vectors of @p cols values,
+ * one after the other.
+ *
+ * @param[in] batch The number of activation vectors.
+ *
+ * @param[out] y The @p batch result vectors of @p rows values,
+ * one after the other.
+ *
+ * @param[in] threads The number of threads,
+ * see @c trit_thread_count.
+ */
+void trit_gemm_float(const trit32_t *weights, size_t rows, size_t cols,
+                     const float *x, size_t batch, float *y, int threads){
+
+    gemm_args args;
+
+    args.weights = weights;
+    args.rows = rows;
+    args.cols = cols;
+    args.x = x;
+    args.batch = batch;
+    args.y = y;
+    args.tile = gemm_tile_scalar;
+
+#ifdef TERNARY_X86_64
+    if(trit_cpu_avx512()){
+
+        args.tile = gemm_tile_avx512;
+    }
+    else if(trit_cpu_avx2()){
+
+        args.tile = gemm_tile_avx2;
+    }
+#endif
+
+    trit_parallel_for(rows, TILE_ROWS, threads, gemm_rows, &args);
+}
+
+/**
+ * @brief Multiplies a ternary weight matrix with a vector.
+ *
+ * @see trit_gemm_float
+ *
+ * @param[in] weights The @p rows by @p cols packed weight matrix.
+ *
+ * @param[in] rows The number of weight rows.
+ *
+ * @param[in] cols The number of weight columns.
+ *
+ * @param[in] x The @p cols activations.
+ *
+ * @param[out] y The @p rows results.
+ *
+ * @param[in] threads The number of threads,
+ * see @c trit_thread_count.
+ */
+void trit_gemv_float(const trit32_t *weights, size_t rows, size_t cols,
+                     const float *x, float *y, int threads){
+
+    trit_gemm_float(weights, rows, cols, x, 1, y, threads);
+}
@@ -0,0 +1,18 @@
+#ifndef __ternary_gemm_h__
+#define __ternary_gemm_h__
+
+#include<stddef.h>
+#include"ternary.h"
+
+// number of trit32_t words holding one row of cols trits
+#define TRIT_ROW_WORDS(cols) (((cols) + 31) / 32)
+
+// GEMV FUNCTIONS
+void trit_gemv_float(const trit32_t *weights, size_t rows, size_t cols,
+                     const float *x, float *y, int threads);
+
+// GEMM FUNCTIONS
+void trit_gemm_float(const trit32_t *weights, size_t rows, size_t cols,
+                     const float *x, size_t batch, float *y, int threads);
+
+#endif // __ternary_gemm_h__
@@ -0,0 +1,536 @@
+/**
+ * @file ternary_hash.c
+ *
+ * @brief File contains hash functions and a hash map for trit keys.
+ *
+ * Only three of the four codes of a 2-bit pair occur in a balanced
+ * ternary word, so the raw word is a poor hash: with an identity
+ * hash and a power of two of buckets every bucket index that has
+ * a 0b10 pair is never used. The hashes here first fold a value
+ * to its canonical form and then run a full-avalanche mixer over
+ * it, so every bucket index is equally likely.
+ */
+
+
+#include<stdint.h>
+#include<stdlib.h>
+
+#include"ternary_hash.h"
+
+#define LOW_BITS 0x5555555555555555ULL /**< Mask of the low bit of every trit in a @c trit32_t */
+#define MAP_MIN_CAPACITY 16 /**< The smallest number of slots of a map */
+
+static const uint64_t HASH_KEYS[8] = {
+
+    0xa0761d6478bd642fULL, 0xe7037ed1a0b428dbULL, 0x8ebc6af09c88c6e3ULL, 0x589965cc75374cc3ULL,
+    0x1d8e4e27c47d124fULL, 0x9e3779b97f4a7c15ULL, 0xbf58476d1ce4e5b9ULL, 0x94d049bb133111ebULL
+};
+
+/**
+ * @brief Multiplies two words and folds the 128-bit product.
+ *
+ * @param[in] a First factor.
+ *
+ * @param[in] b Second factor.
+ *
+ * @return The high half of the product xor the low half
+ */
+__attribute__((always_inline))
+static inline uint64_t fold_multiply(uint64_t a, uint64_t b){
+
+    __uint128_t product = (__uint128_t)a * b;
+
+    return (uint64_t)(product >> 64) ^ (uint64_t)product;
+}
+
+/**
+ * @brief Mixes every bit of @p x into every bit of the result.
+ *
+ * @param[in] x The word to mix.
+ *
+ * @return The mixed word
+ */
+__attribute__((always_inline))
+static inline uint64_t mix(uint64_t x){
+
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+
+    return x;
+}
+
+/**
+ * @brief Folds a word of trits to its canonical form and mixes it.
+ *
+ * Clears the unused 0b10 codes so they hash like a 0 trit. The
+ * mixer is a bijection in which every input bit flips every output
+ * bit with even odds, so the missing code leaves no pattern in
+ * the low bits used as bucket index.
+ *
+ * @param[in] num The trits.
+ *
+ * @return The hash of @p num
+ */
+__attribute__((always_inline))
+static inline uint64_t hash_trits(trit32_t num){
+
+    return mix(num & ~((num & ~(num << 1)) & (LOW_BITS << 1)));
+}
+
+/**
+ * @brief Hashes 8 trits.
+ *
+ * Equal values hash equal, the unused 0b10 code hashes like a
+ * 0 trit. Widening a value does not change its hash.
+ *
+ * @param[in] num The trits.
+ *
+ * @return A 64-bit hash of @p num
+ */
+uint64_t trit_hash_trit8_t(trit8_t num){
+
+    return hash_trits(num);
+}
+
+/**
+ * @brief Hashes 16 trits.
+ *
+ * Equal values hash equal, the unused 0b10 code hashes like a
+ * 0 trit. Widening a value does not change its hash.
+ *
+ * @param[in] num The trits.
+ *
+ * @return A 64-bit hash of @p num
+ */
+uint64_t trit_hash_trit16_t(trit16_t num){
+
+    return hash_trits(num);
+}
+
+/**
+ * @brief Hashes 32 trits.
+ *
+ * Equal values hash equal, the unused 0b10 code hashes like a
+ * 0 trit.
+ *
+ * @param[in] num The trits.
+ *
+ * @return A 64-bit hash of @p num
+ */
+uint64_t trit_hash_trit32_t(trit32_t num){
+
+    return hash_trits(num);
+}
+
+/**
+ * @brief Feeds one stripe of 8 words to the hash lanes.
+ *
+ * Every lane multiplies two of the words, with the lane state
+ * folded into one of them, so the four lanes run independent
+ * multiply chains.
+ *
+ * @param[in,out] lanes The four lanes.
+ *
+ * @param[in] words The 8 words.
+ */
+__attribute__((always_inline))
+static inline void hash_stripe(uint64_t *lanes, const trit32_t *words){
+
+    int lane = 0;
+
+    for(lane = 0; lane < 4; lane++){
+
+        lanes[lane] = fold_multiply(words[2 * lane] ^ lanes[lane], words[2 * lane + 1] ^ HASH_KEYS[lane + 4]);
+    }
+}
+
+/**
+ * @brief Starts a streaming hash.
+ *
+ * Feed the words with @c trit_hash_update and read the hash with
+ * @c trit_hash_final. The hash only depends on the words, not on
+ * how they were split between calls. Unlike @c trit_hash_trit32_t
+ * the words are hashed as they are, so vectors must only use the
+ * 0b00, 0b01 and 0b11 codes to hash equal.
+ *
+ * @param[out] state The hash state.
+ *
+ * @param[in] seed Selects one of a family of hash functions.
+ */
+void trit_hash_init(trit_hash_state_t *state, uint64_t seed){
+
+    int lane = 0;
+
+    for(lane = 0; lane < 4; lane++){
+
+        state->lanes[lane] = mix(seed ^ HASH_KEYS[lane]);
+    }
+
+    state->buffered = 0;
+    state->length = 0;
+    state->seed = seed;
+}
+
+/**
+ * @brief Adds words to a streaming hash.
+ *
+ * @param[in,out] state The hash state.
+ *
+ * @param[in] words The words to hash.
+ *
+ * @param[in] count The number of words.
+ *
+ * @see trit_hash_init
+ */
+void trit_hash_update(trit_hash_state_t *state, const trit32_t *words, size_t count){
+
+    uint64_t lanes[4] = {0};
+    size_t index = 0;
+
+    state->length += count;
+
+    // top up a partial stripe first
+    if(state->buffered > 0){
+
+        while(state->buffered < 8 && index < count){
+
+            state->buffer[state->buffered++] = words[index++];
+        }
+        if(state->buffered < 8){
+
+            return;
+        }
+
+        hash_stripe(state->lanes, state->buffer);
+        state->buffered = 0;
+    }
+
+    lanes[0] = state->lanes[0];
+    lanes[1] = state->lanes[1];
+    lanes[2] = state->lanes[2];
+    lanes[3] = state->lanes[3];
+
+    for(; index + 8 <= count; index += 8){
+
+        hash_stripe(lanes, words + index);
+    }
+
+    state->lanes[0] = lanes[0];
+    state->lanes[1] = lanes[1];
+    state->lanes[2] = lanes[2];
+    state->lanes[3] = lanes[3];
+
+    while(index < count){
+
+        state->buffer[state->buffered++] = words[index++];
+    }
+}
+
+/**
+ * @brief Reads the hash of the words fed so far.
+ *
+ * The state is not changed, more words can be added after.
+ *
+ * @param[in] state The hash state.
+ *
+ * @return The 64-bit hash
+ *
+ * @see trit_hash_init
+ */
+uint64_t trit_hash_final(const trit_hash_state_t *state){
+
+    uint64_t result = 0;
+    size_t index = 0;
+
+    result = fold_multiply(state->lanes[0] ^ HASH_KEYS[0], state->lanes[1] ^ HASH_KEYS[1]);
+    result ^= fold_multiply(state->lanes[2] ^ HASH_KEYS[2], state->lanes[3] ^ HASH_KEYS[3]);
+
+    // the tail is chained so its order counts
+    for(index = 0; index < state->buffered; index++){
+
+        result = fold_multiply(result ^ state->buffer[index], HASH_KEYS[4 + (index & 3)]);
+    }
+
+    return mix(result ^ state->length ^ state->seed);
+}
+
+/**
+ * @brief Hashes an array of trit words.
+ *
+ * The same hash as feeding the words to @c trit_hash_update in
+ * one call.
+ *
+ * @param[in] words The words to hash.
+ *
+ * @param[in] count The number of words.
+ *
+ * @param[in] seed Selects one of a family of hash functions.
+ *
+ * @return The 64-bit hash
+ *
+ * @see trit_hash_init
+ */
+uint64_t trit_hash_array(const trit32_t *words, size_t count, uint64_t seed){
+
+    trit_hash_state_t state;
+
+    trit_hash_init(&state, seed);
+    trit_hash_update(&state, words, count);
+
+    return trit_hash_final(&state);
+}
+
+/**
+ * @brief Finds the slot of @p key or the free slot it would go in.
+ *
+ * @param[in] map The map.
+ *
+ * @param[in] key The key.
+ *
+ * @return The slot index
+ */
+static size_t map_find(const trit_map_t *map, trit32_t key){
+
+    size_t mask = map->capacity - 1;
+    size_t slot = hash_trits(key) & mask;
+
+    while(map->entries[slot].key != key && map->entries[slot].key != TRIT_MAP_EMPTY){
+
+        slot = (slot + 1) & mask;
+    }
+
+    return slot;
+}
+
+/**
+ * @brief Moves the entries of @p map to a table of @p capacity slots.
+ *
+ * @param[in,out] map The map.
+ *
+ * @param[in] capacity The new number of slots, a power of two.
+ *
+ * @return false if the table could not be allocated
+ */
+static bool map_resize(trit_map_t *map, size_t capacity){
+
+    trit_map_entry_t *old_entries = map->entries;
+    size_t old_capacity = map->capacity;
+    size_t index = 0;
+    size_t slot = 0;
+
+    if(capacity == 0 || capacity > SIZE_MAX / sizeof(trit_map_entry_t)){
+
+        return false;
+    }
+
+    map->entries = (trit_map_entry_t *)malloc(capacity * sizeof(trit_map_entry_t));
+    if(map->entries == NULL){
+
+        map->entries = old_entries;
+        return false;
+    }
+
+    map->capacity = capacity;
+    for(index = 0; index < capacity; index++){
+
+        map->entries[index].key = TRIT_MAP_EMPTY;
+        map->entries[index].value = 0;
+    }
+
+    for(index = 0; index < old_capacity; index++){
+
+        if(old_entries[index].key != TRIT_MAP_EMPTY){
+
+            slot = map_find(map, old_entries[index].key);
+            map->entries[slot] = old_entries[index];
+        }
+    }
+
+    free(old_entries);
+
+    return true;
+}
+
+/**
+ * @brief Creates an empty map.
+ *
+ * The map uses linear probing over one flat array of slots. A free
+ * slot holds the key @c TRIT_MAP_EMPTY, which has only 0b10 codes
+ * and is never a balanced ternary value, so the map needs no
+ * separate occupancy flags and keys must be balanced ternary.
+ *
+ * @param[out] map The map.
+ *
+ * @param[in] capacity The number of keys to make room for, the map
+ * grows past it as needed.
+ *
+ * @return false if the map could not be allocated or @p capacity
+ * is more than SIZE_MAX / 2
+ */
+bool trit_map_init(trit_map_t *map, size_t capacity){
+
+    size_t slots = MAP_MIN_CAPACITY;
+
+    map->entries = NULL;
+    map->capacity = 0;
+    map->count = 0;
+
+    if(capacity > SIZE_MAX / 2){
+
+        return false;
+    }
+
+    // keep the load at or under one half
+    while(slots < 2 * capacity && slots <= SIZE_MAX / 2){
+
+        slots <<= 1;
+    }
+
+    return map_resize(map, slots);
+}
+
+/**
+ * @brief Frees the slots of a map.
+ *
+ * @param[in,out] map The map.
+ */
+void trit_map_free(trit_map_t *map){
+
+    free(map->entries);
+
+    map->entries = NULL;
+    map->capacity = 0;
+    map->count = 0;
+}
+
+/**
+ * @brief Sets the value of a key, adding the key if it is new.
+ *
+ * @warning @p key must be balanced ternary.
+ *
+ * @param[in,out] map The map.
+ *
+ * @param[in] key The key.
+ *
+ * @param[in] value The value.
+ *
+ * @return false if the map had to grow and could not, or has
+ * been freed
+ */
+bool trit_map_put(trit_map_t *map, trit32_t key, uint64_t value){
+
+    size_t slot = 0;
+
+    assert(key != TRIT_MAP_EMPTY);
+
+    if(map->capacity == 0){
+
+        return false;
+    }
+
+    if(2 * (map->count + 1) > map->capacity &&
+       (map->capacity > SIZE_MAX / 2 || !map_resize(map, 2 * map->capacity))){
+
+        return false;
+    }
+
+    slot = map_find(map, key);
+    if(map->entries[slot].key == TRIT_MAP_EMPTY){
+
+        map->entries[slot].key = key;
+        map->count++;
+    }
+
+    map->entries[slot].value = value;
+
+    return true;
+}
+
+/**
+ * @brief Looks up the value of a key.
+ *
+ * @param[in] map The map.
+ *
+ * @param[in] key The key.
+ *
+ * @param[out] value Set to the value of @p key if it is in the map.
+ *
+ * @return true if @p key is in the map
+ */
+bool trit_map_get(const trit_map_t *map, trit32_t key, uint64_t *value){
+
+    size_t slot = 0;
+
+    if(map->capacity == 0){
+
+        return false;
+    }
+
+    slot = map_find(map, key);
+    if(map->entries[slot].key == TRIT_MAP_EMPTY){
+
+        return false;
+    }
+
+    *value = map->entries[slot].value;
+
+    return true;
+}
+
+/**
+ * @brief Removes a key from the map.
+ *
+ * The entries after the freed slot are shifted back into it where
+ * their probe allows, so lookups never need tombstones.
+ *
+ * @param[in,out] map The map.
+ *
+ * @param[in] key The key.
+ *
+ * @return true if @p key was in the map
+ */
+bool trit_map_remove(trit_map_t *map, trit32_t key){
+
+    size_t mask = map->capacity - 1;
+    size_t hole = 0;
+    size_t slot = 0;
+    size_t home = 0;
+
+    if(map->capacity == 0){
+
+        return false;
+    }
+
+    hole = map_find(map, key);
+    slot = hole;
+    if(map->entries[hole].key == TRIT_MAP_EMPTY){
+
+        return false;
+    }
+
+    for(;;){
+
+        slot = (slot + 1) & mask;
+        if(map->entries[slot].key == TRIT_MAP_EMPTY){
+
+            break;
+        }
+
+        // the entry can fill the hole if its home is not between the hole and the slot
+        home = hash_trits(map->entries[slot].key) & mask;
+        if(((slot - home) & mask) >= ((slot - hole) & mask)){
+
+            map->entries[hole] = map->entries[slot];
+            hole = slot;
+        }
+    }
+
+    map->entries[hole].key = TRIT_MAP_EMPTY;
+    map->entries[hole].value = 0;
+    map->count--;
+
+    return true;
+}
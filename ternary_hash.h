@@ -0,0 +1,58 @@
+#ifndef __ternary_hash_h__
+#define __ternary_hash_h__
+
+#include<stddef.h>
+#include"ternary.h"
+
+/**
+ * @brief State of a streaming hash over trit words.
+ */
+typedef struct {
+
+    uint64_t lanes[4]; /**< Four independent accumulators */
+    trit32_t buffer[8]; /**< Words waiting for a full stripe */
+    size_t buffered; /**< Words in @c buffer */
+    uint64_t length; /**< Words hashed so far */
+    uint64_t seed; /**< The seed passed to @c trit_hash_init */
+} trit_hash_state_t;
+
+/**
+ * @brief One slot of a @c trit_map_t.
+ */
+typedef struct {
+
+    trit32_t key; /**< The key, @c TRIT_MAP_EMPTY if the slot is free */
+    uint64_t value; /**< The value stored with @c key */
+} trit_map_entry_t;
+
+/**
+ * @brief Open-addressing hash map from balanced ternary keys to values.
+ */
+typedef struct {
+
+    trit_map_entry_t *entries; /**< The slots, a power of two of them */
+    size_t capacity; /**< The number of slots */
+    size_t count; /**< The number of keys stored */
+} trit_map_t;
+
+#define TRIT_MAP_EMPTY 0xAAAAAAAAAAAAAAAAULL /**< Every trit 0b10, which is never a balanced ternary key */
+
+// HASH FUNCTIONS
+uint64_t trit_hash_trit8_t(trit8_t num);
+uint64_t trit_hash_trit16_t(trit16_t num);
+uint64_t trit_hash_trit32_t(trit32_t num);
+
+// STREAMING HASH FUNCTIONS
+void trit_hash_init(trit_hash_state_t *state, uint64_t seed);
+void trit_hash_update(trit_hash_state_t *state, const trit32_t *words, size_t count);
+uint64_t trit_hash_final(const trit_hash_state_t *state);
+uint64_t trit_hash_array(const trit32_t *words, size_t count, uint64_t seed);
+
+// HASH MAP FUNCTIONS
+bool trit_map_init(trit_map_t *map, size_t capacity);
+void trit_map_free(trit_map_t *map);
+bool trit_map_put(trit_map_t *map, trit32_t key, uint64_t value);
+bool trit_map_get(const trit_map_t *map, trit32_t key, uint64_t *value);
+bool trit_map_remove(trit_map_t *map, trit32_t key);
+
+#endif // __ternary_hash_h__
@@ -0,0 +1,543 @@
+/**
+ * @file ternary_kleene.c
+ *
+ * @brief File contains a columnar Kleene logic engine.
+ *
+ * A column holds one trit per row, 32 rows to a @c trit32_t
+ * word, with -1 for FALSE, 0 for UNKNOWN (SQL NULL) and 1 for
+ * TRUE. AND is the minimum and OR the maximum of two trits,
+ * which in the two bit code is an OR and an AND of the sign
+ * bits plus the matching mask for the TRUE trits, so a word
+ * of 32 rows takes a handful of mask operations.
+ *
+ * An expression tree is evaluated a block of rows at a time,
+ * so the intermediate columns stay in cache. An AND whose left
+ * side is FALSE for the whole block, or an OR whose left side
+ * is TRUE, skips its right side. The selection bitmap has one
+ * bit per row, set where the result is TRUE.
+ */
+
+
+#include"ternary_kleene.h"
+#include"ternary_cpu.h"
+
+#define LOW_BITS 0x5555555555555555ULL /**< The low bit of every trit, a word of TRUE */
+#define ALL_FALSE 0xFFFFFFFFFFFFFFFFULL /**< A word of FALSE */
+#define BLOCK_WORDS 64 /**< The words of each column evaluated at once, 2048 rows */
+
+/**
+ * @brief The columns and size of one evaluation.
+ */
+typedef struct{
+
+    const trit_kleene_node_t *nodes; /**< The expression tree */
+    const trit32_t *const *columns;  /**< The input columns */
+    size_t words;                    /**< The words in every column */
+    uint64_t tail;                   /**< The bits of the rows in use in the last word */
+} kleene_args;
+
+/**
+ * @brief Applies one operator to a word of 32 rows.
+ *
+ * @param[in] op The operator, not @c TRIT_KLEENE_COLUMN.
+ *
+ * @param[in] a The left operand.
+ *
+ * @param[in] b The right operand, ignored by the one input operators.
+ *
+ * @return The 32 results
+ */
+__attribute__((always_inline))
+static inline uint64_t kleene_word(trit_kleene_op_t op, uint64_t a, uint64_t b){
+
+    uint64_t a_mag = a & LOW_BITS;
+    uint64_t a_neg = (a >> 1) & LOW_BITS;
+    uint64_t b_mag = b & LOW_BITS;
+    uint64_t b_neg = (b >> 1) & LOW_BITS;
+    uint64_t pos = 0;
+    uint64_t neg = 0;
+
+    switch(op){
+
+        case TRIT_KLEENE_AND:
+            pos = a_mag & ~a_neg & b_mag & ~b_neg;
+            neg = a_neg | b_neg;
+            break;
+        case TRIT_KLEENE_OR:
+            pos = (a_mag & ~a_neg) | (b_mag & ~b_neg);
+            neg = a_neg & b_neg;
+            break;
+        case TRIT_KLEENE_NOT:
+            return a ^ (a_mag << 1);
+        case TRIT_KLEENE_IS_TRUE:
+            pos = a_mag & ~a_neg;
+            neg = LOW_BITS & ~pos;
+            break;
+        case TRIT_KLEENE_IS_UNKNOWN:
+            pos = LOW_BITS & ~a_mag;
+            neg = a_mag;
+            break;
+        default:
+            assert(0 && "Not an operator");
+    }
+
+    return pos | neg | (neg << 1);
+}
+
+/**
+ * @brief Gathers the TRUE rows of a word into 32 bits.
+ *
+ * @param[in] word 32 rows.
+ *
+ * @return Bit i set if row i is TRUE
+ */
+static uint32_t true_bits(uint64_t word){
+
+    uint64_t bits = word & ~(word >> 1) & LOW_BITS;
+
+    bits = (bits | (bits >> 1)) & 0x3333333333333333ULL;
+    bits = (bits | (bits >> 2)) & 0x0F0F0F0F0F0F0F0FULL;
+    bits = (bits | (bits >> 4)) & 0x00FF00FF00FF00FFULL;
+    bits = (bits | (bits >> 8)) & 0x0000FFFF0000FFFFULL;
+
+    return (uint32_t)(bits | (bits >> 16));
+}
+
+/**
+ * @brief The bits of the rows in use in the last word of a column.
+ *
+ * @param[in] rows The number of rows.
+ *
+ * @return Both bits of every row in use
+ */
+static uint64_t tail_bits(size_t rows){
+
+    return rows % 32 == 0 ? ALL_FALSE : (1ULL << (2 * (rows % 32))) - 1;
+}
+
+/**
+ * @brief Applies one operator to @p words words.
+ *
+ * Inlined with a constant @p op, so the switch in
+ * @c kleene_word is resolved outside the loop.
+ *
+ * @param[in] op The operator, not @c TRIT_KLEENE_COLUMN.
+ *
+ * @param[in] a The left operand.
+ *
+ * @param[in] b The right operand.
+ *
+ * @param[out] out The @p words results.
+ *
+ * @param[in] words The number of words.
+ */
+__attribute__((always_inline))
+static inline void kleene_words(trit_kleene_op_t op, const trit32_t *a, const trit32_t *b, trit32_t *out, size_t words){
+
+    size_t index = 0;
+
+    for(index = 0; index < words; index++){
+
+        out[index] = kleene_word(op, a[index], b[index]);
+    }
+}
+
+// SCALAR KLEENE KERNELS
+
+/**
+ * @brief Applies one operator to columns of rows.
+ *
+ * @warning This method asserts that the words are in balanced ternary.
+ *
+ * @param[in] op The operator, not @c TRIT_KLEENE_COLUMN.
+ *
+ * @param[in] a The left operand.
+ *
+ * @param[in] b The right operand, NULL for NOT, IS TRUE and IS UNKNOWN.
+ *
+ * @param[out] out The @p words results, may be @p a or @p b.
+ *
+ * @param[in] words The number of words, 32 rows each.
+ */
+void trit_kleene_apply_scalar(trit_kleene_op_t op, const trit32_t *a, const trit32_t *b, trit32_t *out, size_t words){
+
+    // the one input operators read @p a twice rather than a NULL @p b
+    const trit32_t *right = b != NULL ? b : a;
+
+    switch(op){
+
+        case TRIT_KLEENE_AND:
+            kleene_words(TRIT_KLEENE_AND, a, right, out, words);
+            break;
+        case TRIT_KLEENE_OR:
+            kleene_words(TRIT_KLEENE_OR, a, right, out, words);
+            break;
+        case TRIT_KLEENE_NOT:
+            kleene_words(TRIT_KLEENE_NOT, a, right, out, words);
+            break;
+        case TRIT_KLEENE_IS_TRUE:
+            kleene_words(TRIT_KLEENE_IS_TRUE, a, right, out, words);
+            break;
+        case TRIT_KLEENE_IS_UNKNOWN:
+            kleene_words(TRIT_KLEENE_IS_UNKNOWN, a, right, out, words);
+            break;
+        default:
+            kleene_words(op, a, right, out, words);
+    }
+}
+
+/**
+ * @brief Builds the selection bitmap of a column.
+ *
+ * @param[in] column The rows, 32 to a word.
+ *
+ * @param[in] rows The number of rows.
+ *
+ * @param[out] selection (rows + 63) / 64 words, bit r % 64 of
+ * word r / 64 set if row r is TRUE. Bits past @p rows are 0.
+ *
+ * @return The number of TRUE rows
+ */
+size_t trit_kleene_select_scalar(const trit32_t *column, size_t rows, uint64_t *selection){
+
+    size_t words = (rows + 31) / 32;
+    size_t count = 0;
+    size_t index = 0;
+
+    for(index = 0; index < words; index += 2){
+
+        uint64_t low = true_bits(column[index] & (index + 1 == words ? tail_bits(rows) : ALL_FALSE));
+        uint64_t high = index + 1 < words ? true_bits(column[index + 1] & (index + 2 == words ? tail_bits(rows) : ALL_FALSE)) : 0;
+
+        selection[index / 2] = low | (high << 32);
+        count += (size_t)__builtin_popcountll(selection[index / 2]);
+    }
+
+    return count;
+}
+
+#ifdef TERNARY_X86_64
+/**
+ * @brief Applies one operator to columns of rows with AVX2.
+ *
+ * Four words, 128 rows, at a time, the tail uses the scalar kernel.
+ *
+ * @warning The CPU must support AVX2.
+ *
+ * @see trit_kleene_apply_scalar
+ *
+ * @param[in] op The operator, not @c TRIT_KLEENE_COLUMN.
+ *
+ * @param[in] a The left operand.
+ *
+ * @param[in] b The right operand, NULL for NOT, IS TRUE and IS UNKNOWN.
+ *
+ * @param[out] out The @p words results, may be @p a or @p b.
+ *
+ * @param[in] words The number of words, 32 rows each.
+ */
+__attribute__((target("avx2")))
+void trit_kleene_apply_avx2(trit_kleene_op_t op, const trit32_t *a, const trit32_t *b, trit32_t *out, size_t words){
+
+    const __m256i low = _mm256_set1_epi64x((long long)LOW_BITS);
+    const trit32_t *right = b != NULL ? b : a;
+    size_t index = 0;
+
+    for(; index + 4 <= words; index += 4){
+
+        __m256i x = _mm256_loadu_si256((const __m256i *)(a + index));
+        __m256i y = _mm256_loadu_si256((const __m256i *)(right + index));
+        __m256i x_mag = _mm256_and_si256(x, low);
+        __m256i x_neg = _mm256_and_si256(_mm256_srli_epi64(x, 1), low);
+        __m256i y_mag = _mm256_and_si256(y, low);
+        __m256i y_neg = _mm256_and_si256(_mm256_srli_epi64(y, 1), low);
+        __m256i x_pos = _mm256_andnot_si256(x_neg, x_mag);
+        __m256i y_pos = _mm256_andnot_si256(y_neg, y_mag);
+        __m256i pos = _mm256_setzero_si256();
+        __m256i neg = _mm256_setzero_si256();
+
+        switch(op){
+
+            case TRIT_KLEENE_AND:
+                pos = _mm256_and_si256(x_pos, y_pos);
+                neg = _mm256_or_si256(x_neg, y_neg);
+                break;
+            case TRIT_KLEENE_OR:
+                pos = _mm256_or_si256(x_pos, y_pos);
+                neg = _mm256_and_si256(x_neg, y_neg);
+                break;
+            case TRIT_KLEENE_NOT:
+                pos = _mm256_and_si256(x_mag, x_neg);
+                neg = x_pos;
+                break;
+            case TRIT_KLEENE_IS_TRUE:
+                pos = x_pos;
+                neg = _mm256_andnot_si256(x_pos, low);
+                break;
+            default:
+                pos = _mm256_andnot_si256(x_mag, low);
+                neg = x_mag;
+        }
+
+        _mm256_storeu_si256((__m256i *)(out + index), _mm256_or_si256(_mm256_or_si256(pos, neg), _mm256_slli_epi64(neg, 1)));
+    }
+
+    trit_kleene_apply_scalar(op, a + index, b != NULL ? b + index : NULL, out + index, words - index);
+}
+
+/**
+ * @brief Builds the selection bitmap of a column with AVX2.
+ *
+ * Gathers the TRUE bits of four words in their 64 bit lanes,
+ * then packs the low halves of the lanes into 128 bits of the
+ * bitmap. The last words use the scalar kernel.
+ *
+ * @warning The CPU must support AVX2.
+ *
+ * @see trit_kleene_select_scalar
+ *
+ * @param[in] column The rows, 32 to a word.
+ *
+ * @param[in] rows The number of rows.
+ *
+ * @param[out] selection (rows + 63) / 64 words, bit r % 64 of
+ * word r / 64 set if row r is TRUE. Bits past @p rows are 0.
+ *
+ * @return The number of TRUE rows
+ */
+__attribute__((target("avx2")))
+size_t trit_kleene_select_avx2(const trit32_t *column, size_t rows, uint64_t *selection){
+
+    const __m256i low = _mm256_set1_epi64x((long long)LOW_BITS);
+    const __m256i pairs = _mm256_set1_epi64x(0x3333333333333333LL);
+    const __m256i nibbles = _mm256_set1_epi64x(0x0F0F0F0F0F0F0F0FLL);
+    const __m256i bytes = _mm256_set1_epi64x(0x00FF00FF00FF00FFLL);
+    const __m256i halves = _mm256_set1_epi64x(0x0000FFFF0000FFFFLL);
+    const __m256i order = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    size_t full = rows / 32;
+    size_t count = 0;
+    size_t index = 0;
+
+    for(; index + 4 <= full; index += 4){
+
+        __m256i x = _mm256_loadu_si256((const __m256i *)(column + index));
+        __m256i bits = _mm256_andnot_si256(_mm256_srli_epi64(x, 1), _mm256_and_si256(x, low));
+
+        bits = _mm256_and_si256(_mm256_or_si256(bits, _mm256_srli_epi64(bits, 1)), pairs);
+        bits = _mm256_and_si256(_mm256_or_si256(bits, _mm256_srli_epi64(bits, 2)), nibbles);
+        bits = _mm256_and_si256(_mm256_or_si256(bits, _mm256_srli_epi64(bits, 4)), bytes);
+        bits = _mm256_and_si256(_mm256_or_si256(bits, _mm256_srli_epi64(bits, 8)), halves);
+        bits = _mm256_or_si256(bits, _mm256_srli_epi64(bits, 16));
+        bits = _mm256_permutevar8x32_epi32(bits, order);
+
+        __m128i packed = _mm256_castsi256_si128(bits);
+
+        _mm_storeu_si128((__m128i *)(selection + index / 2), packed);
+        count += (size_t)__builtin_popcountll((uint64_t)_mm_cvtsi128_si64(packed));
+        count += (size_t)__builtin_popcountll((uint64_t)_mm_extract_epi64(packed, 1));
+    }
+
+    return count + trit_kleene_select_scalar(column + index, rows - 32 * index, selection + index / 2);
+}
+#endif
+
+// BATCH KLEENE FUNCTIONS
+
+/**
+ * @brief Applies one operator to columns of rows.
+ *
+ * Picks the AVX2 or scalar kernel at run time.
+ *
+ * @see trit_kleene_apply_scalar
+ *
+ * @param[in] op The operator, not @c TRIT_KLEENE_COLUMN.
+ *
+ * @param[in] a The left operand.
+ *
+ * @param[in] b The right operand, NULL for NOT, IS TRUE and IS UNKNOWN.
+ *
+ * @param[out] out The @p words results, may be @p a or @p b.
+ *
+ * @param[in] words The number of words, 32 rows each.
+ */
+void trit_kleene_apply(trit_kleene_op_t op, const trit32_t *a, const trit32_t *b, trit32_t *out, size_t words){
+
+    assert(op != TRIT_KLEENE_COLUMN);
+
+#ifdef TERNARY_X86_64
+    if(trit_cpu_avx2()){
+
+        trit_kleene_apply_avx2(op, a, b, out, words);
+        return;
+    }
+#endif
+    trit_kleene_apply_scalar(op, a, b, out, words);
+}
+
+/**
+ * @brief Builds the selection bitmap of a column.
+ *
+ * Picks the AVX2 or scalar kernel at run time.
+ *
+ * @see trit_kleene_select_scalar
+ *
+ * @param[in] column The rows, 32 to a word.
+ *
+ * @param[in] rows The number of rows.
+ *
+ * @param[out] selection (rows + 63) / 64 words, bit r % 64 of
+ * word r / 64 set if row r is TRUE. Bits past @p rows are 0.
+ *
+ * @return The number of TRUE rows
+ */
+size_t trit_kleene_select(const trit32_t *column, size_t rows, uint64_t *selection){
+
+#ifdef TERNARY_X86_64
+    if(trit_cpu_avx2()){
+
+        return trit_kleene_select_avx2(column, rows, selection);
+    }
+#endif
+    return trit_kleene_select_scalar(column, rows, selection);
+}
+
+// KLEENE FUNCTIONS
+
+/**
+ * @brief Checks if every row in use of a block has one value.
+ *
+ * @param[in] args The evaluation.
+ *
+ * @param[in] block The words of the block.
+ *
+ * @param[in] first The index of the block's first word.
+ *
+ * @param[in] words The words in the block.
+ *
+ * @param[in] value A word of TRUE or of FALSE.
+ *
+ * @return True if every row is @p value
+ */
+static bool block_is(const kleene_args *args, const trit32_t *block, size_t first, size_t words, uint64_t value){
+
+    uint64_t diff = 0;
+    size_t index = 0;
+
+    for(index = 0; index + 1 < words; index++){
+
+        diff |= block[index] ^ value;
+    }
+
+    diff |= (block[words - 1] ^ value) & (first + words == args->words ? args->tail : ALL_FALSE);
+
+    return diff == 0;
+}
+
+/**
+ * @brief Evaluates one node of the tree for a block of rows.
+ *
+ * @param[in] args The evaluation.
+ *
+ * @param[in] node The index of the node.
+ *
+ * @param[in] first The index of the block's first word.
+ *
+ * @param[in] words The words in the block, at most BLOCK_WORDS.
+ *
+ * @param[in] buffer Room for the result of the node.
+ *
+ * @param[in] depth The depth of the node in the tree.
+ *
+ * @return The results, in @p buffer or in an input column
+ */
+static const trit32_t *eval_block(const kleene_args *args, int node, size_t first, size_t words, trit32_t *buffer, int depth){
+
+    const trit_kleene_node_t *current = args->nodes + node;
+    const trit32_t *left = NULL;
+    const trit32_t *right = NULL;
+    trit32_t scratch[BLOCK_WORDS];
+
+    assert(depth < TRIT_KLEENE_MAX_DEPTH && "Expression too deep");
+
+    if(current->op == TRIT_KLEENE_COLUMN){
+
+        return args->columns[current->left] + first;
+    }
+
+    left = eval_block(args, current->left, first, words, buffer, depth + 1);
+
+    if(current->op != TRIT_KLEENE_AND && current->op != TRIT_KLEENE_OR){
+
+        trit_kleene_apply(current->op, left, NULL, buffer, words);
+        return buffer;
+    }
+
+    // FALSE AND x and TRUE OR x do not depend on x
+    if(block_is(args, left, first, words, current->op == TRIT_KLEENE_AND ? ALL_FALSE : LOW_BITS)){
+
+        return left;
+    }
+
+    right = eval_block(args, current->right, first, words, scratch, depth + 1);
+    trit_kleene_apply(current->op, left, right, buffer, words);
+
+    return buffer;
+}
+
+/**
+ * @brief Evaluates a Kleene logic expression over whole columns.
+ *
+ * Every column has @p rows rows packed 32 to a word. The rows
+ * are evaluated a block at a time, and an AND or OR whose left
+ * side already decides the block skips its right side, so the
+ * cheap or selective predicate should be the left child.
+ *
+ * @warning This method asserts that the tree is at most
+ * TRIT_KLEENE_MAX_DEPTH deep and the columns are balanced ternary.
+ *
+ * @param[in] nodes The expression tree.
+ *
+ * @param[in] root The index of the root node.
+ *
+ * @param[in] columns The input columns, indexed by the leaves.
+ *
+ * @param[in] rows The number of rows.
+ *
+ * @param[out] out (rows + 31) / 32 words for the result of
+ * every row, or NULL. Trits past @p rows are unspecified.
+ *
+ * @param[out] selection (rows + 63) / 64 words for the
+ * selection bitmap, or NULL. Bit r % 64 of word r / 64 is set
+ * if row r is TRUE.
+ *
+ * @return The number of TRUE rows
+ */
+size_t trit_kleene_eval(const trit_kleene_node_t *nodes, int root, const trit32_t *const *columns, size_t rows,
+                        trit32_t *out, uint64_t *selection){
+
+    kleene_args args = {nodes, columns, (rows + 31) / 32, tail_bits(rows)};
+    trit32_t buffer[BLOCK_WORDS];
+    uint64_t bitmap[BLOCK_WORDS / 2];
+    size_t count = 0;
+    size_t first = 0;
+    size_t index = 0;
+
+    for(first = 0; first < args.words; first += BLOCK_WORDS){
+
+        size_t words = args.words - first < BLOCK_WORDS ? args.words - first : BLOCK_WORDS;
+        size_t block_rows = first + words == args.words ? rows - 32 * first : 32 * words;
+        const trit32_t *result = eval_block(&args, root, first, words, buffer, 0);
+
+        if(out != NULL){
+
+            for(index = 0; index < words; index++){
+
+                out[first + index] = result[index];
+            }
+        }
+
+        count += trit_kleene_select(result, block_rows, selection != NULL ? selection + first / 2 : bitmap);
+    }
+
+    return count;
+}
@@ -0,0 +1,56 @@
+#ifndef __ternary_kleene_h__
+#define __ternary_kleene_h__
+
+#include<stddef.h>
+#include<stdint.h>
+#include"ternary.h"
+
+#define TRIT_KLEENE_MAX_DEPTH 64 /**< The deepest expression tree @c trit_kleene_eval takes */
+
+/**
+ * @brief The operators of a Kleene logic expression.
+ *
+ * Trits are -1 for FALSE, 0 for UNKNOWN and 1 for TRUE.
+ */
+typedef enum{
+
+    TRIT_KLEENE_COLUMN,    /**< A leaf, reads the column numbered @c left */
+    TRIT_KLEENE_AND,       /**< The minimum of the two children */
+    TRIT_KLEENE_OR,        /**< The maximum of the two children */
+    TRIT_KLEENE_NOT,       /**< The negation of the left child */
+    TRIT_KLEENE_IS_TRUE,   /**< TRUE where the left child is TRUE, FALSE otherwise */
+    TRIT_KLEENE_IS_UNKNOWN /**< TRUE where the left child is UNKNOWN, FALSE otherwise */
+} trit_kleene_op_t;
+
+/**
+ * @brief One node of a Kleene logic expression tree.
+ *
+ * A tree is an array of nodes whose children are indexes
+ * into the same array.
+ */
+typedef struct{
+
+    trit_kleene_op_t op; /**< The operator */
+    int left;            /**< The first child, or the column of a leaf */
+    int right;           /**< The second child of AND and OR */
+} trit_kleene_node_t;
+
+// KLEENE FUNCTIONS
+size_t trit_kleene_eval(const trit_kleene_node_t *nodes, int root, const trit32_t *const *columns, size_t rows,
+                        trit32_t *out, uint64_t *selection);
+
+// BATCH KLEENE FUNCTIONS
+void trit_kleene_apply(trit_kleene_op_t op, const trit32_t *a, const trit32_t *b, trit32_t *out, size_t words);
+size_t trit_kleene_select(const trit32_t *column, size_t rows, uint64_t *selection);
+
+// SCALAR KLEENE KERNELS
+void trit_kleene_apply_scalar(trit_kleene_op_t op, const trit32_t *a, const trit32_t *b, trit32_t *out, size_t words);
+size_t trit_kleene_select_scalar(const trit32_t *column, size_t rows, uint64_t *selection);
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+// AVX2 KLEENE KERNELS
+void trit_kleene_apply_avx2(trit_kleene_op_t op, const trit32_t *a, const trit32_t *b, trit32_t *out, size_t words);
+size_t trit_kleene_select_avx2(const trit32_t *column, size_t rows, uint64_t *selection);
+#endif
+
+#endif // __ternary_kleene_h__
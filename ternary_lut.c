@@ -0,0 +1,418 @@
+/**
+ * @file ternary_lut.c
+ *
+ * @brief File contains compiled two-input trit functions.
+ *
+ * A trit code has a magnitude bit m and a sign bit n, and the
+ * three codes 00, 01 and 11 are three points of which every
+ * 0/1 valued function is affine, c0 ^ c1 m ^ c2 n. Over two
+ * trits the products of those terms are a basis, so each bit
+ * of the output code is
+ *
+ *     c ^ c_am am ^ c_an an ^ bm (c_bm ^ c_mm am ^ c_nm an)
+ *       ^ bn (c_bn ^ c_mn am ^ c_nn an)
+ *
+ * for 9 coefficients read off the truth table once. The kernels
+ * copy each input bit into both bits of its trit and keep one
+ * coefficient mask per term, with the magnitude coefficient in
+ * the even bits and the sign coefficient in the odd bits, so
+ * every one of the 3^9 functions is the same 16 mask operations.
+ */
+
+
+#include"ternary_lut.h"
+#include"ternary_cpu.h"
+
+#define LOW_BITS 0x5555555555555555ULL /**< The low bit of every trit */
+
+/**
+ * @brief Finds the coefficients of one function on the three trit codes.
+ *
+ * @param[in] zero The value at code 00.
+ *
+ * @param[in] one The value at code 01.
+ *
+ * @param[in] bal The value at code 11.
+ *
+ * @param[out] coef The coefficients of 1, m and n.
+ */
+static void affine(int zero, int one, int bal, int *coef){
+
+    coef[0] = zero;
+    coef[1] = zero ^ one;
+    coef[2] = one ^ bal;
+}
+
+/**
+ * @brief Spreads a coefficient to every trit of one output bit.
+ *
+ * @param[in] coef The coefficient, 0 or 1.
+ *
+ * @param[in] bit 0 for the magnitude bit, 1 for the sign bit.
+ *
+ * @return The mask with @p coef in that bit of every trit
+ */
+static uint64_t spread(int coef, int bit){
+
+    return coef ? LOW_BITS << bit : 0;
+}
+
+/**
+ * @brief Compiles a truth table into a trit function.
+ *
+ * The table is indexed by 3 * (a + 1) + (b + 1), so entry 0 is
+ * the result for a = -1 and b = -1 and entry 8 the result for
+ * a = 1 and b = 1. The AND of ternary.c is
+ * {-1, -1, -1, -1, 0, 0, -1, 0, 1}.
+ *
+ * @param[out] lut The compiled function.
+ *
+ * @param[in] table The 9 results, each -1, 0 or 1.
+ *
+ * @return false if an entry is not -1, 0 or 1
+ */
+bool trit_lut2_compile(trit_lut2_t *lut, const int8_t table[9]){
+
+    uint64_t terms[9] = {0};
+    int rows[3][3] = {{0}};
+    int coef[3] = {0};
+    int bit = 0;
+    int row = 0;
+    int col = 0;
+    int term = 0;
+
+    for(row = 0; row < 9; row++){
+
+        if(table[row] < -1 || table[row] > 1){
+
+            return false;
+        }
+    }
+
+    for(bit = 0; bit < 2; bit++){
+
+        // each row holds b's coefficients for one value of a
+        for(row = 0; row < 3; row++){
+
+            int value[3] = {0};
+
+            for(col = 0; col < 3; col++){
+
+                int result = table[3 * row + col];
+
+                value[col] = bit == 0 ? result != 0 : result < 0;
+            }
+
+            affine(value[1], value[2], value[0], rows[row]);
+        }
+
+        // then the rows become a's coefficients for each term of b
+        for(col = 0; col < 3; col++){
+
+            affine(rows[1][col], rows[2][col], rows[0][col], coef);
+
+            for(term = 0; term < 3; term++){
+
+                terms[3 * col + term] |= spread(coef[term], bit);
+            }
+        }
+    }
+
+    lut->constant = terms[0];
+    lut->a_mag = terms[1];
+    lut->a_neg = terms[2];
+    lut->b_mag = terms[3];
+    lut->mag_mag = terms[4];
+    lut->neg_mag = terms[5];
+    lut->b_neg = terms[6];
+    lut->mag_neg = terms[7];
+    lut->neg_neg = terms[8];
+
+    return true;
+}
+
+/**
+ * @brief Applies a compiled function to every trit of a word.
+ *
+ * @warning This method asserts that @p a and @p b are in
+ * balanced ternary.
+ *
+ * @param[in] lut The compiled function.
+ *
+ * @param[in] a The first balanced ternary word.
+ *
+ * @param[in] b The second balanced ternary word.
+ *
+ * @return The function of each pair of trits
+ */
+__attribute__((always_inline))
+static inline uint64_t lut2_word(const trit_lut2_t *lut, uint64_t a, uint64_t b){
+
+    uint64_t a_mag = a & LOW_BITS;
+    uint64_t a_neg = (a >> 1) & LOW_BITS;
+    uint64_t b_mag = b & LOW_BITS;
+    uint64_t b_neg = (b >> 1) & LOW_BITS;
+
+    assert((a_neg & ~a_mag) == 0 && (b_neg & ~b_mag) == 0);
+
+    // times 3 copies each bit into both bits of its trit
+    a_mag *= 3;
+    a_neg *= 3;
+    b_mag *= 3;
+    b_neg *= 3;
+
+    return lut->constant ^ (a_mag & lut->a_mag) ^ (a_neg & lut->a_neg)
+           ^ (b_mag & (lut->b_mag ^ (a_mag & lut->mag_mag) ^ (a_neg & lut->neg_mag)))
+           ^ (b_neg & (lut->b_neg ^ (a_mag & lut->mag_neg) ^ (a_neg & lut->neg_neg)));
+}
+
+/**
+ * @brief Applies a compiled function to one pair of trits.
+ *
+ * @param[in] lut The compiled function.
+ *
+ * @param[in] a The first trit, -1, 0 or 1.
+ *
+ * @param[in] b The second trit, -1, 0 or 1.
+ *
+ * @return The table entry for @p a and @p b
+ */
+int trit_lut2_eval(const trit_lut2_t *lut, int a, int b){
+
+    static const uint64_t CODES[3] = {3, 0, 1};
+    uint64_t result = 0;
+
+    assert(a >= -1 && a <= 1 && b >= -1 && b <= 1);
+
+    result = lut2_word(lut, CODES[a + 1], CODES[b + 1]) & 3;
+
+    return result == 3 ? -1 : (int)result;
+}
+
+/**
+ * @brief Applies a compiled function to each trit of two @c trit8_t numbers.
+ *
+ * @warning This method asserts that @p a and
+ * @p b are in balanced ternary.
+ *
+ * @param[in] lut The compiled function.
+ *
+ * @param[in] a The first 8 trit balanced ternary value.
+ *
+ * @param[in] b The second 8 trit balanced ternary value.
+ *
+ * @return Trit i of the result is the function of trit i
+ * of @p a and trit i of @p b
+ */
+trit8_t trit_lut2_trit8_t(const trit_lut2_t *lut, trit8_t a, trit8_t b){
+
+    return (trit8_t)lut2_word(lut, a, b);
+}
+
+/**
+ * @brief Applies a compiled function to each trit of two @c trit16_t numbers.
+ *
+ * @see trit_lut2_trit8_t
+ *
+ * @param[in] lut The compiled function.
+ *
+ * @param[in] a The first 16 trit balanced ternary value.
+ *
+ * @param[in] b The second 16 trit balanced ternary value.
+ *
+ * @return The function of each pair of trits
+ */
+trit16_t trit_lut2_trit16_t(const trit_lut2_t *lut, trit16_t a, trit16_t b){
+
+    return (trit16_t)lut2_word(lut, a, b);
+}
+
+/**
+ * @brief Applies a compiled function to each trit of two @c trit32_t numbers.
+ *
+ * @see trit_lut2_trit8_t
+ *
+ * @param[in] lut The compiled function.
+ *
+ * @param[in] a The first 32 trit balanced ternary value.
+ *
+ * @param[in] b The second 32 trit balanced ternary value.
+ *
+ * @return The function of each pair of trits
+ */
+trit32_t trit_lut2_trit32_t(const trit_lut2_t *lut, trit32_t a, trit32_t b){
+
+    return lut2_word(lut, a, b);
+}
+
+/**
+ * @brief Applies a compiled function to each trit of two @c trit64_t numbers.
+ *
+ * @see trit_lut2_trit8_t
+ *
+ * @param[in] lut The compiled function.
+ *
+ * @param[in] a The first 64 trit balanced ternary value.
+ *
+ * @param[in] b The second 64 trit balanced ternary value.
+ *
+ * @return The function of each pair of trits
+ */
+trit64_t trit_lut2_trit64_t(const trit_lut2_t *lut, trit64_t a, trit64_t b){
+
+    uint64_t low = lut2_word(lut, (uint64_t)a, (uint64_t)b);
+    uint64_t high = lut2_word(lut, (uint64_t)(a >> 64), (uint64_t)(b >> 64));
+
+    return ((trit64_t)high << 64) | low;
+}
+
+/**
+ * @brief Applies a compiled function to each trit of two @c trit128_t numbers.
+ *
+ * @see trit_lut2_trit8_t
+ *
+ * @param[in] lut The compiled function.
+ *
+ * @param[in] a The first 128 trit balanced ternary value.
+ *
+ * @param[in] b The second 128 trit balanced ternary value.
+ *
+ * @return The function of each pair of trits
+ */
+trit128_t trit_lut2_trit128_t(const trit_lut2_t *lut, trit128_t a, trit128_t b){
+
+    trit128_t result;
+
+    result.low = trit_lut2_trit64_t(lut, a.low, b.low);
+    result.high = trit_lut2_trit64_t(lut, a.high, b.high);
+
+    return result;
+}
+
+// SCALAR LUT2 KERNELS
+
+/**
+ * @brief Applies a compiled function to two arrays of @c trit32_t words.
+ *
+ * @see trit_lut2_trit32_t
+ *
+ * @param[in] lut The compiled function.
+ *
+ * @param[in] a The first operands.
+ *
+ * @param[in] b The second operands.
+ *
+ * @param[out] out The @p count results.
+ *
+ * @param[in] count The number of words.
+ */
+void trit_lut2_scalar(const trit_lut2_t *lut, const trit32_t *a, const trit32_t *b, trit32_t *out, size_t count){
+
+    // a local copy, so stores to out cannot force the masks to be reloaded
+    trit_lut2_t local = *lut;
+    size_t index = 0;
+
+    for(index = 0; index < count; index++){
+
+        out[index] = lut2_word(&local, a[index], b[index]);
+    }
+}
+
+#ifdef TERNARY_X86_64
+/**
+ * @brief Applies a compiled function to two arrays of @c trit32_t words with AVX2.
+ *
+ * The same mask operations as @c lut2_word on four words at a
+ * time, the tail uses the scalar kernel.
+ *
+ * @warning The CPU must support AVX2.
+ *
+ * @see trit_lut2_scalar
+ *
+ * @param[in] lut The compiled function.
+ *
+ * @param[in] a The first operands.
+ *
+ * @param[in] b The second operands.
+ *
+ * @param[out] out The @p count results.
+ *
+ * @param[in] count The number of words.
+ */
+__attribute__((target("avx2")))
+void trit_lut2_avx2(const trit_lut2_t *lut, const trit32_t *a, const trit32_t *b, trit32_t *out, size_t count){
+
+    const __m256i low = _mm256_set1_epi64x((long long)LOW_BITS);
+    const __m256i constant = _mm256_set1_epi64x((long long)lut->constant);
+    const __m256i a_mag_coef = _mm256_set1_epi64x((long long)lut->a_mag);
+    const __m256i a_neg_coef = _mm256_set1_epi64x((long long)lut->a_neg);
+    const __m256i b_mag_coef = _mm256_set1_epi64x((long long)lut->b_mag);
+    const __m256i b_neg_coef = _mm256_set1_epi64x((long long)lut->b_neg);
+    const __m256i mag_mag = _mm256_set1_epi64x((long long)lut->mag_mag);
+    const __m256i neg_mag = _mm256_set1_epi64x((long long)lut->neg_mag);
+    const __m256i mag_neg = _mm256_set1_epi64x((long long)lut->mag_neg);
+    const __m256i neg_neg = _mm256_set1_epi64x((long long)lut->neg_neg);
+    size_t index = 0;
+
+    for(; index + 4 <= count; index += 4){
+
+        __m256i x = _mm256_loadu_si256((const __m256i *)(a + index));
+        __m256i y = _mm256_loadu_si256((const __m256i *)(b + index));
+        __m256i a_mag = _mm256_and_si256(x, low);
+        __m256i a_neg = _mm256_and_si256(_mm256_srli_epi64(x, 1), low);
+        __m256i b_mag = _mm256_and_si256(y, low);
+        __m256i b_neg = _mm256_and_si256(_mm256_srli_epi64(y, 1), low);
+        __m256i result = constant;
+        __m256i term = b_mag_coef;
+
+        a_mag = _mm256_or_si256(a_mag, _mm256_slli_epi64(a_mag, 1));
+        a_neg = _mm256_or_si256(a_neg, _mm256_slli_epi64(a_neg, 1));
+        b_mag = _mm256_or_si256(b_mag, _mm256_slli_epi64(b_mag, 1));
+        b_neg = _mm256_or_si256(b_neg, _mm256_slli_epi64(b_neg, 1));
+
+        result = _mm256_xor_si256(result, _mm256_and_si256(a_mag, a_mag_coef));
+        result = _mm256_xor_si256(result, _mm256_and_si256(a_neg, a_neg_coef));
+        term = _mm256_xor_si256(term, _mm256_and_si256(a_mag, mag_mag));
+        term = _mm256_xor_si256(term, _mm256_and_si256(a_neg, neg_mag));
+        result = _mm256_xor_si256(result, _mm256_and_si256(b_mag, term));
+        term = _mm256_xor_si256(b_neg_coef, _mm256_and_si256(a_mag, mag_neg));
+        term = _mm256_xor_si256(term, _mm256_and_si256(a_neg, neg_neg));
+        result = _mm256_xor_si256(result, _mm256_and_si256(b_neg, term));
+
+        _mm256_storeu_si256((__m256i *)(out + index), result);
+    }
+
+    trit_lut2_scalar(lut, a + index, b + index, out + index, count - index);
+}
+#endif
+
+// BATCH LUT2 FUNCTIONS
+
+/**
+ * @brief Applies a compiled function to two arrays of @c trit32_t words.
+ *
+ * Picks the AVX2 or scalar kernel at run time.
+ *
+ * @see trit_lut2_trit32_t
+ *
+ * @param[in] lut The compiled function.
+ *
+ * @param[in] a The first operands.
+ *
+ * @param[in] b The second operands.
+ *
+ * @param[out] out The @p count results.
+ *
+ * @param[in] count The number of words.
+ */
+void trit_lut2_array(const trit_lut2_t *lut, const trit32_t *a, const trit32_t *b, trit32_t *out, size_t count){
+
+#ifdef TERNARY_X86_64
+    if(trit_cpu_avx2()){
+
+        trit_lut2_avx2(lut, a, b, out, count);
+        return;
+    }
+#endif
+    trit_lut2_scalar(lut, a, b, out, count);
+}
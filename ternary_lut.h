@@ -0,0 +1,51 @@
+#ifndef __ternary_lut_h__
+#define __ternary_lut_h__
+
+#include<stddef.h>
+#include<stdint.h>
+#include"ternary.h"
+
+/**
+ * @brief A compiled two-input trit function.
+ *
+ * Each output bit of a trit (the magnitude bit and the sign bit
+ * of its code) is an XOR of products of the input code bits, with
+ * one coefficient mask per product. Even bits of a mask hold the
+ * coefficient for the magnitude bit and odd bits the one for the
+ * sign bit, so one pass of mask operations gives both.
+ */
+typedef struct{
+
+    uint64_t constant; /**< Coefficient of 1 */
+    uint64_t a_mag;    /**< Coefficient of the magnitude bit of a */
+    uint64_t a_neg;    /**< Coefficient of the sign bit of a */
+    uint64_t b_mag;    /**< Coefficient of the magnitude bit of b */
+    uint64_t b_neg;    /**< Coefficient of the sign bit of b */
+    uint64_t mag_mag;  /**< Coefficient of a_mag * b_mag */
+    uint64_t neg_mag;  /**< Coefficient of a_neg * b_mag */
+    uint64_t mag_neg;  /**< Coefficient of a_mag * b_neg */
+    uint64_t neg_neg;  /**< Coefficient of a_neg * b_neg */
+} trit_lut2_t;
+
+// LUT2 FUNCTIONS
+bool trit_lut2_compile(trit_lut2_t *lut, const int8_t table[9]);
+int trit_lut2_eval(const trit_lut2_t *lut, int a, int b);
+
+trit8_t trit_lut2_trit8_t(const trit_lut2_t *lut, trit8_t a, trit8_t b);
+trit16_t trit_lut2_trit16_t(const trit_lut2_t *lut, trit16_t a, trit16_t b);
+trit32_t trit_lut2_trit32_t(const trit_lut2_t *lut, trit32_t a, trit32_t b);
+trit64_t trit_lut2_trit64_t(const trit_lut2_t *lut, trit64_t a, trit64_t b);
+trit128_t trit_lut2_trit128_t(const trit_lut2_t *lut, trit128_t a, trit128_t b);
+
+// BATCH LUT2 FUNCTIONS
+void trit_lut2_array(const trit_lut2_t *lut, const trit32_t *a, const trit32_t *b, trit32_t *out, size_t count);
+
+// SCALAR LUT2 KERNELS
+void trit_lut2_scalar(const trit_lut2_t *lut, const trit32_t *a, const trit32_t *b, trit32_t *out, size_t count);
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+// AVX2 LUT2 KERNELS
+void trit_lut2_avx2(const trit_lut2_t *lut, const trit32_t *a, const trit32_t *b, trit32_t *out, size_t count);
+#endif
+
+#endif // __ternary_lut_h__
@@ -0,0 +1,474 @@
+/**
+ * @file ternary_metric.c
+ *
+ * @brief File contains distance metrics over trit arrays.
+ *
+ * This file contains the trit-wise Hamming distance and the
+ * ternary inner product over arrays of @c trit32_t words, as
+ * well as one-vs-many versions for scanning a base of packed
+ * fingerprints. Every word is handled with masks and popcount,
+ * using the popcnt instruction when the CPU has it.
+ */
+
+
+#include<stdlib.h>
+
+#include"ternary_metric.h"
+#include"ternary_cpu.h"
+#include"ternary_thread.h"
+
+#define LOW_BITS 0x5555555555555555ULL /**< Mask of the low bit of every trit in a @c trit32_t */
+#define SCAN_GRAIN 256 /**< Fingerprints per thread chunk are a multiple of this */
+#define NEAREST_GRAIN 4096 /**< Fingerprints per chunk of a threaded nearest search, each chunk keeps its own best */
+
+/**
+ * @brief Metric between two arrays of @p words words.
+ */
+typedef int64_t (*array_metric_fn)(const trit32_t *a, const trit32_t *b, size_t words);
+
+/**
+ * @brief Arguments of one batch scan shared by all threads.
+ */
+typedef struct {
+    const trit32_t *query; /**< The query fingerprint */
+    const trit32_t *base; /**< The @c count fingerprints to compare with */
+    size_t words; /**< Words per fingerprint */
+    array_metric_fn metric; /**< The metric kernel picked for this CPU */
+    uint32_t *distances; /**< Output of a Hamming scan or NULL */
+    int32_t *similarities; /**< Output of a similarity scan or NULL */
+} batch_args;
+
+/**
+ * @brief Arguments of one threaded nearest search shared by all threads.
+ */
+typedef struct {
+    const trit32_t *query; /**< The query fingerprint */
+    const trit32_t *base; /**< The @c count fingerprints to search */
+    size_t count; /**< The number of fingerprints */
+    size_t words; /**< Words per fingerprint */
+    array_metric_fn metric; /**< The metric kernel picked for this CPU */
+    size_t *best; /**< The closest fingerprint of every chunk */
+    int64_t *distances; /**< The distance of the closest fingerprint of every chunk */
+} nearest_args;
+
+/**
+ * @brief Trit-wise Hamming distance of two arrays.
+ *
+ * Uses four independent sums so consecutive popcounts
+ * do not wait on each other.
+ *
+ * @see trit_hamming_trit32_t
+ */
+__attribute__((always_inline))
+static inline int64_t hamming_words(const trit32_t *a, const trit32_t *b, size_t words){
+
+    uint64_t sums[4] = {0, 0, 0, 0};
+    uint64_t diff = 0;
+    size_t index = 0;
+    int part = 0;
+
+    for(index = 0; index + 4 <= words; index += 4){
+
+        for(part = 0; part < 4; part++){
+
+            diff = a[index + part] ^ b[index + part];
+            sums[part] += __builtin_popcountll((diff | (diff >> 1)) & LOW_BITS);
+        }
+    }
+
+    for(; index < words; index++){
+
+        diff = a[index] ^ b[index];
+        sums[0] += __builtin_popcountll((diff | (diff >> 1)) & LOW_BITS);
+    }
+
+    return (int64_t)(sums[0] + sums[1] + sums[2] + sums[3]);
+}
+
+/**
+ * @brief Ternary inner product of two arrays.
+ *
+ * @see trit_similarity_trit32_t
+ */
+__attribute__((always_inline))
+static inline int64_t similarity_words(const trit32_t *a, const trit32_t *b, size_t words){
+
+    int64_t sums[2] = {0, 0};
+    uint64_t both = 0;
+    uint64_t flip = 0;
+    size_t index = 0;
+
+    for(index = 0; index + 2 <= words; index += 2){
+
+        both = a[index] & b[index] & LOW_BITS;
+        flip = ((a[index] ^ b[index]) >> 1) & both;
+        sums[0] += __builtin_popcountll(both) - 2 * __builtin_popcountll(flip);
+
+        both = a[index + 1] & b[index + 1] & LOW_BITS;
+        flip = ((a[index + 1] ^ b[index + 1]) >> 1) & both;
+        sums[1] += __builtin_popcountll(both) - 2 * __builtin_popcountll(flip);
+    }
+
+    if(index < words){
+
+        both = a[index] & b[index] & LOW_BITS;
+        flip = ((a[index] ^ b[index]) >> 1) & both;
+        sums[0] += __builtin_popcountll(both) - 2 * __builtin_popcountll(flip);
+    }
+
+    return sums[0] + sums[1];
+}
+
+/**
+ * @brief Portable Hamming distance kernel.
+ */
+static int64_t hamming_portable(const trit32_t *a, const trit32_t *b, size_t words){
+
+    return hamming_words(a, b, words);
+}
+
+/**
+ * @brief Portable inner product kernel.
+ */
+static int64_t similarity_portable(const trit32_t *a, const trit32_t *b, size_t words){
+
+    return similarity_words(a, b, words);
+}
+
+#ifdef TERNARY_X86_64
+/**
+ * @brief Hamming distance kernel using the popcnt instruction.
+ */
+__attribute__((target("popcnt")))
+static int64_t hamming_popcnt(const trit32_t *a, const trit32_t *b, size_t words){
+
+    return hamming_words(a, b, words);
+}
+
+/**
+ * @brief Inner product kernel using the popcnt instruction.
+ */
+__attribute__((target("popcnt")))
+static int64_t similarity_popcnt(const trit32_t *a, const trit32_t *b, size_t words){
+
+    return similarity_words(a, b, words);
+}
+#endif
+
+/**
+ * @brief Picks the Hamming distance kernel for this CPU.
+ *
+ * @return The popcnt kernel if supported, else the portable one
+ */
+static array_metric_fn hamming_kernel(void){
+
+#ifdef TERNARY_X86_64
+    if(trit_cpu_popcnt()){
+
+        return hamming_popcnt;
+    }
+#endif
+    return hamming_portable;
+}
+
+/**
+ * @brief Picks the inner product kernel for this CPU.
+ *
+ * @return The popcnt kernel if supported, else the portable one
+ */
+static array_metric_fn similarity_kernel(void){
+
+#ifdef TERNARY_X86_64
+    if(trit_cpu_popcnt()){
+
+        return similarity_popcnt;
+    }
+#endif
+    return similarity_portable;
+}
+
+/**
+ * @brief Trit-wise Hamming distance of two trit arrays.
+ *
+ * @see trit_hamming_trit32_t
+ *
+ * @param[in] a The first array of @p words words.
+ *
+ * @param[in] b The second array of @p words words.
+ *
+ * @param[in] words The length of both arrays.
+ *
+ * @return The number of trits which differ between @p a and @p b
+ */
+uint64_t trit_hamming_array(const trit32_t *a, const trit32_t *b, size_t words){
+
+    return (uint64_t)hamming_kernel()(a, b, words);
+}
+
+/**
+ * @brief Ternary inner product of two trit arrays.
+ *
+ * @warning This method expects @p a and
+ * @p b to be in balanced ternary.
+ *
+ * @see trit_similarity_trit32_t
+ *
+ * @param[in] a The first array of @p words words.
+ *
+ * @param[in] b The second array of @p words words.
+ *
+ * @param[in] words The length of both arrays.
+ *
+ * @return The sum of the products of the trits of @p a and @p b
+ */
+int64_t trit_similarity_array(const trit32_t *a, const trit32_t *b, size_t words){
+
+    return similarity_kernel()(a, b, words);
+}
+
+/**
+ * @brief Compares the query with the fingerprints [@p start, @p end).
+ *
+ * @param[in] arg The @c batch_args of the scan.
+ *
+ * @param[in] start The first fingerprint.
+ *
+ * @param[in] end One past the last fingerprint.
+ */
+static void batch_range(void *arg, size_t start, size_t end){
+
+    const batch_args *args = (const batch_args *)arg;
+    size_t index = 0;
+
+    for(index = start; index < end; index++){
+
+        if(args->distances != NULL){
+
+            args->distances[index] = (uint32_t)args->metric(args->query, args->base + index * args->words,
+                                                            args->words);
+        }
+        else{
+
+            args->similarities[index] = (int32_t)args->metric(args->query, args->base + index * args->words,
+                                                              args->words);
+        }
+    }
+}
+
+/**
+ * @brief Hamming distance of a query to many fingerprints.
+ *
+ * Fingerprint i is the @p words words starting at
+ * @p base + i * @p words.
+ *
+ * @param[in] query The query fingerprint of @p words words.
+ *
+ * @param[in] base The @p count fingerprints.
+ *
+ * @param[in] count The number of fingerprints in @p base.
+ *
+ * @param[in] words Words per fingerprint.
+ *
+ * @param[out] distances The @p count distances.
+ *
+ * @param[in] threads The number of threads,
+ * see @c trit_thread_count.
+ */
+void trit_hamming_batch(const trit32_t *query, const trit32_t *base, size_t count,
+                        size_t words, uint32_t *distances, int threads){
+
+    batch_args args;
+
+    args.query = query;
+    args.base = base;
+    args.words = words;
+    args.metric = hamming_kernel();
+    args.distances = distances;
+    args.similarities = NULL;
+
+    trit_parallel_for(count, SCAN_GRAIN, threads, batch_range, &args);
+}
+
+/**
+ * @brief Ternary inner product of a query with many fingerprints.
+ *
+ * Fingerprint i is the @p words words starting at
+ * @p base + i * @p words.
+ *
+ * @warning This method expects the fingerprints
+ * to be in balanced ternary.
+ *
+ * @param[in] query The query fingerprint of @p words words.
+ *
+ * @param[in] base The @p count fingerprints.
+ *
+ * @param[in] count The number of fingerprints in @p base.
+ *
+ * @param[in] words Words per fingerprint.
+ *
+ * @param[out] similarities The @p count inner products.
+ *
+ * @param[in] threads The number of threads,
+ * see @c trit_thread_count.
+ */
+void trit_similarity_batch(const trit32_t *query, const trit32_t *base, size_t count,
+                           size_t words, int32_t *similarities, int threads){
+
+    batch_args args;
+
+    args.query = query;
+    args.base = base;
+    args.words = words;
+    args.metric = similarity_kernel();
+    args.distances = NULL;
+    args.similarities = similarities;
+
+    trit_parallel_for(count, SCAN_GRAIN, threads, batch_range, &args);
+}
+
+/**
+ * @brief Finds the closest of the fingerprints [@p start, @p end).
+ *
+ * Ties go to the lowest index.
+ *
+ * @param[in] args The search.
+ *
+ * @param[in] start The first fingerprint.
+ *
+ * @param[in] end One past the last fingerprint, greater than @p start.
+ *
+ * @param[out] distance The distance of the closest fingerprint.
+ *
+ * @return The index of the closest fingerprint
+ */
+static size_t nearest_values(const nearest_args *args, size_t start, size_t end, int64_t *distance){
+
+    size_t best = start;
+    int64_t best_distance = args->metric(args->query, args->base + start * args->words, args->words);
+    int64_t current = 0;
+    size_t index = 0;
+
+    for(index = start + 1; index < end; index++){
+
+        current = args->metric(args->query, args->base + index * args->words, args->words);
+
+        if(current < best_distance){
+
+            best = index;
+            best_distance = current;
+        }
+    }
+
+    *distance = best_distance;
+
+    return best;
+}
+
+/**
+ * @brief Searches the chunks [@p start, @p end) of a threaded nearest search.
+ *
+ * @param[in] arg The shared @c nearest_args.
+ *
+ * @param[in] start The first chunk.
+ *
+ * @param[in] end One past the last chunk.
+ */
+static void nearest_range(void *arg, size_t start, size_t end){
+
+    const nearest_args *args = (const nearest_args *)arg;
+    size_t chunk = 0;
+    size_t last = 0;
+
+    for(chunk = start; chunk < end; chunk++){
+
+        last = args->count - chunk * NEAREST_GRAIN < NEAREST_GRAIN ? args->count : (chunk + 1) * NEAREST_GRAIN;
+
+        args->best[chunk] = nearest_values(args, chunk * NEAREST_GRAIN, last, &args->distances[chunk]);
+    }
+}
+
+/**
+ * @brief Finds the fingerprint closest to a query.
+ *
+ * Scans @p base for the smallest trit-wise Hamming distance,
+ * ties go to the lowest index. Every chunk of fingerprints keeps
+ * its own best and they are compared in order once the threads
+ * are done, so the result does not depend on @p threads.
+ *
+ * @param[in] query The query fingerprint of @p words words.
+ *
+ * @param[in] base The @p count fingerprints.
+ *
+ * @param[in] count The number of fingerprints in @p base.
+ *
+ * @param[in] words Words per fingerprint.
+ *
+ * @param[out] distance The distance of the closest fingerprint,
+ * untouched if @p count is 0. May be NULL.
+ *
+ * @param[in] threads The number of threads,
+ * see @c trit_thread_count.
+ *
+ * @return The index of the closest fingerprint, or @p count if
+ * @p base is empty
+ */
+size_t trit_hamming_nearest(const trit32_t *query, const trit32_t *base, size_t count,
+                            size_t words, uint32_t *distance, int threads){
+
+    nearest_args args;
+    size_t chunks = (count + NEAREST_GRAIN - 1) / NEAREST_GRAIN;
+    size_t chunk = 0;
+    size_t best = count;
+    int64_t best_distance = 0;
+
+    if(count == 0){
+
+        return count;
+    }
+
+    args.query = query;
+    args.base = base;
+    args.count = count;
+    args.words = words;
+    args.metric = hamming_kernel();
+    args.best = NULL;
+    args.distances = NULL;
+
+    if(chunks > 1){
+
+        args.best = (size_t *)malloc(chunks * sizeof(size_t));
+        args.distances = (int64_t *)malloc(chunks * sizeof(int64_t));
+    }
+
+    if(args.best == NULL || args.distances == NULL){
+
+        // one chunk, or no memory for the chunk results
+        best = nearest_values(&args, 0, count, &best_distance);
+    }
+    else{
+
+        trit_parallel_for(chunks, 1, threads, nearest_range, &args);
+
+        best = args.best[0];
+        best_distance = args.distances[0];
+
+        for(chunk = 1; chunk < chunks; chunk++){
+
+            if(args.distances[chunk] < best_distance){
+
+                best = args.best[chunk];
+                best_distance = args.distances[chunk];
+            }
+        }
+    }
+
+    free(args.best);
+    free(args.distances);
+
+    if(distance != NULL){
+
+        *distance = (uint32_t)best_distance;
+    }
+
+    return best;
+}
@@ -0,0 +1,19 @@
+#ifndef __ternary_metric_h__
+#define __ternary_metric_h__
+
+#include<stddef.h>
+#include"ternary.h"
+
+// ARRAY METRIC FUNCTIONS
+uint64_t trit_hamming_array(const trit32_t *a, const trit32_t *b, size_t words);
+int64_t trit_similarity_array(const trit32_t *a, const trit32_t *b, size_t words);
+
+// BATCH METRIC FUNCTIONS
+void trit_hamming_batch(const trit32_t *query, const trit32_t *base, size_t count,
+                        size_t words, uint32_t *distances, int threads);
+void trit_similarity_batch(const trit32_t *query, const trit32_t *base, size_t count,
+                           size_t words, int32_t *similarities, int threads);
+size_t trit_hamming_nearest(const trit32_t *query, const trit32_t *base, size_t count,
+                            size_t words, uint32_t *distance, int threads);
+
+#endif // __ternary_metric_h__
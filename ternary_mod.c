@@ -0,0 +1,592 @@
+/**
+ * @file ternary_mod.c
+ *
+ * @brief File contains balanced ternary modular arithmetic.
+ *
+ * Products are reduced with Montgomery's method using R = 3^32
+ * for @c trit32_t and R = 3^64 for @c trit64_t. The radix is 3,
+ * so keeping the low k trits of a product is reduction mod R and
+ * dividing the exact multiple of R by R is a right trit shift,
+ * no intermediate is converted to binary. Montgomery values are
+ * kept in (-m, m), which the reduction maps back into itself
+ * because m is below R / 2, and are only brought into [0, m) on
+ * the way out. The modulus must not be a multiple of 3 since it
+ * needs an inverse mod R.
+ *
+ * Exponentiation reads the exponent in unbalanced ternary and
+ * slides a window of up to WINDOW_TRITS digits over it, each
+ * window ends on a nonzero digit and costs one multiply from a
+ * table of the first 3^WINDOW_TRITS powers of the base.
+ */
+
+
+#include"ternary_mod.h"
+
+#define WINDOW_TRITS 2 /**< The most exponent digits one table multiply covers */
+#define WINDOW_SIZE 9 /**< 3^WINDOW_TRITS, the number of table entries */
+
+static const uint64_t POW3_32 = 1853020188851841ULL; /**< 3^32 */
+
+/**
+ * @brief Tells if a @c trit32_t is below 0.
+ *
+ * The highest nonzero trit decides the sign, its code is 01
+ * for +1 and 11 for -1 so the highest set bit is odd for -1.
+ *
+ * @param[in] num The balanced ternary number.
+ *
+ * @return True if @p num is negative
+ */
+static bool negative_trit32_t(trit32_t num){
+
+    return num != 0 && ((63 - __builtin_clzll(num)) & 1);
+}
+
+/**
+ * @brief Tells if a @c trit64_t is below 0.
+ *
+ * @param[in] num The balanced ternary number.
+ *
+ * @return True if @p num is negative
+ * @see negative_trit32_t
+ */
+static bool negative_trit64_t(trit64_t num){
+
+    uint64_t high = (uint64_t)(num >> 64);
+
+    return high ? negative_trit32_t(high) : negative_trit32_t((uint64_t)num);
+}
+
+/**
+ * @brief Montgomery reduction for a @c trit32_t modulus.
+ *
+ * The low 32 trits of @p num times m^-1, a wrapping multiply,
+ * give the multiple of m that clears the low 32 trits of
+ * @p num, the difference is then shifted down by 32 trits.
+ *
+ * @param[in] mont The Montgomery constants.
+ *
+ * @param[in] num A 64 trit value, below m^2 in magnitude.
+ *
+ * @return @p num / 3^32 mod m, in (-m, m)
+ */
+static trit32_t reduce_trit32_t(const trit_mont32_t *mont, trit64_t num){
+
+    trit32_t factor = trit_mul_wrap_trit32_t((trit32_t)num, mont->inverse);
+    trit64_t exact = trit_sub_wrap_trit64_t(num, trit_mul_wide_trit32_t(factor, mont->modulus));
+
+    return (trit32_t)trit_sr_trit64_t(exact, 32);
+}
+
+/**
+ * @brief Montgomery reduction for a @c trit64_t modulus.
+ *
+ * @param[in] mont The Montgomery constants.
+ *
+ * @param[in] num A 128 trit value, below m^2 in magnitude.
+ *
+ * @return @p num / 3^64 mod m, in (-m, m)
+ * @see reduce_trit32_t
+ */
+static trit64_t reduce_trit64_t(const trit_mont64_t *mont, trit128_t num){
+
+    trit64_t factor = trit_mul_wrap_trit64_t(num.low, mont->inverse);
+    trit128_t exact = trit_sub_wrap_trit128_t(num, trit_mul_wide_trit64_t(factor, mont->modulus));
+
+    return trit_sr_trit128_t(exact, 64).low;
+}
+
+/**
+ * @brief Brings a @c trit32_t from (-m, m) into [0, m).
+ *
+ * @param[in] mont The Montgomery constants.
+ *
+ * @param[in] num A value in (-m, m).
+ *
+ * @return @p num mod m, in [0, m)
+ */
+static trit32_t canonical_trit32_t(const trit_mont32_t *mont, trit32_t num){
+
+    return negative_trit32_t(num) ? trit_add_trit32_t(num, mont->modulus) : num;
+}
+
+/**
+ * @brief Brings a @c trit64_t from (-m, m) into [0, m).
+ *
+ * @param[in] mont The Montgomery constants.
+ *
+ * @param[in] num A value in (-m, m).
+ *
+ * @return @p num mod m, in [0, m)
+ */
+static trit64_t canonical_trit64_t(const trit_mont64_t *mont, trit64_t num){
+
+    return negative_trit64_t(num) ? trit_add_trit64_t(num, mont->modulus) : num;
+}
+
+/**
+ * @brief Sets up Montgomery arithmetic for a @c trit32_t modulus.
+ *
+ * The inverse of m mod 3^32 is found with Newton's iteration
+ * x = x * (2 - m * x), which doubles the number of correct trits
+ * each step starting from the lowest trit of m, its own inverse
+ * mod 3. R mod m and R^2 mod m are found once in binary.
+ *
+ * @param[out] mont The Montgomery constants.
+ *
+ * @param[in] modulus The balanced ternary modulus.
+ *
+ * @return False if @p modulus is not above 0 or is a
+ * multiple of 3, true otherwise
+ */
+bool trit_mont_init_trit32_t(trit_mont32_t *mont, trit32_t modulus){
+
+    int64_t value = balanced_ternary_to_binary_int64_t(modulus);
+    trit32_t two = binary_to_balanced_ternary_trit32_t(2);
+    trit32_t inverse = modulus & 3;
+    uint64_t one = 0;
+    int step = 0;
+
+    if(value <= 0 || value % 3 == 0){
+
+        return false;
+    }
+
+    for(step = 0; step < 5; step++){
+
+        inverse = trit_mul_wrap_trit32_t(inverse, trit_sub_wrap_trit32_t(two, trit_mul_wrap_trit32_t(modulus, inverse)));
+    }
+
+    one = POW3_32 % (uint64_t)value;
+
+    mont->modulus = modulus;
+    mont->inverse = inverse;
+    mont->one = binary_to_balanced_ternary_trit32_t(one);
+    mont->square = binary_to_balanced_ternary_trit32_t((uint64_t)((unsigned __int128)one * one % (uint64_t)value));
+
+    return true;
+}
+
+/**
+ * @brief Sets up Montgomery arithmetic for a @c trit64_t modulus.
+ *
+ * @param[out] mont The Montgomery constants.
+ *
+ * @param[in] modulus The balanced ternary modulus.
+ *
+ * @return False if @p modulus is not above 0 or is a
+ * multiple of 3, true otherwise
+ * @see trit_mont_init_trit32_t
+ */
+bool trit_mont_init_trit64_t(trit_mont64_t *mont, trit64_t modulus){
+
+    __int128 value = balanced_ternary_to_binary_int128_t(modulus);
+    trit64_t two = binary_to_balanced_ternary_trit64_t(2);
+    trit64_t inverse = modulus & 3;
+    unsigned __int128 one = 0;
+    unsigned __int128 square = 0;
+    int step = 0;
+
+    if(value <= 0 || value % 3 == 0){
+
+        return false;
+    }
+
+    for(step = 0; step < 6; step++){
+
+        inverse = trit_mul_wrap_trit64_t(inverse, trit_sub_wrap_trit64_t(two, trit_mul_wrap_trit64_t(modulus, inverse)));
+    }
+
+    // 3^64 fits 128 bits but R^2 does not, so R^2 mod m is R mod m tripled 64 times
+    one = (unsigned __int128)POW3_32 * POW3_32 % (unsigned __int128)value;
+    square = one;
+
+    for(step = 0; step < 64; step++){
+
+        square = square * 3 % (unsigned __int128)value;
+    }
+
+    mont->modulus = modulus;
+    mont->inverse = inverse;
+    mont->one = binary_to_balanced_ternary_trit64_t((__int128)one);
+    mont->square = binary_to_balanced_ternary_trit64_t((__int128)square);
+
+    return true;
+}
+
+/**
+ * @brief Puts a @c trit32_t into Montgomery form.
+ *
+ * @param[in] mont The Montgomery constants.
+ *
+ * @param[in] num A value in (-m, m).
+ *
+ * @return @p num * 3^32 mod m, in (-m, m)
+ */
+trit32_t trit_mont_in_trit32_t(const trit_mont32_t *mont, trit32_t num){
+
+    return reduce_trit32_t(mont, trit_mul_wide_trit32_t(num, mont->square));
+}
+
+/**
+ * @brief Puts a @c trit64_t into Montgomery form.
+ *
+ * @param[in] mont The Montgomery constants.
+ *
+ * @param[in] num A value in (-m, m).
+ *
+ * @return @p num * 3^64 mod m, in (-m, m)
+ */
+trit64_t trit_mont_in_trit64_t(const trit_mont64_t *mont, trit64_t num){
+
+    return reduce_trit64_t(mont, trit_mul_wide_trit64_t(num, mont->square));
+}
+
+/**
+ * @brief Takes a @c trit32_t out of Montgomery form.
+ *
+ * @param[in] mont The Montgomery constants.
+ *
+ * @param[in] num A Montgomery value in (-m, m).
+ *
+ * @return The plain value, in [0, m)
+ */
+trit32_t trit_mont_out_trit32_t(const trit_mont32_t *mont, trit32_t num){
+
+    return canonical_trit32_t(mont, reduce_trit32_t(mont, trit_widen_trit32_t_to_trit64_t(num)));
+}
+
+/**
+ * @brief Takes a @c trit64_t out of Montgomery form.
+ *
+ * @param[in] mont The Montgomery constants.
+ *
+ * @param[in] num A Montgomery value in (-m, m).
+ *
+ * @return The plain value, in [0, m)
+ */
+trit64_t trit_mont_out_trit64_t(const trit_mont64_t *mont, trit64_t num){
+
+    return canonical_trit64_t(mont, reduce_trit64_t(mont, trit_widen_trit64_t_to_trit128_t(num)));
+}
+
+/**
+ * @brief Multiplies two @c trit32_t Montgomery values.
+ *
+ * @param[in] mont The Montgomery constants.
+ *
+ * @param[in] a The first Montgomery value, in (-m, m).
+ *
+ * @param[in] b The second Montgomery value, in (-m, m).
+ *
+ * @return The Montgomery product, in (-m, m)
+ */
+trit32_t trit_mont_mul_trit32_t(const trit_mont32_t *mont, trit32_t a, trit32_t b){
+
+    return reduce_trit32_t(mont, trit_mul_wide_trit32_t(a, b));
+}
+
+/**
+ * @brief Multiplies two @c trit64_t Montgomery values.
+ *
+ * @param[in] mont The Montgomery constants.
+ *
+ * @param[in] a The first Montgomery value, in (-m, m).
+ *
+ * @param[in] b The second Montgomery value, in (-m, m).
+ *
+ * @return The Montgomery product, in (-m, m)
+ */
+trit64_t trit_mont_mul_trit64_t(const trit_mont64_t *mont, trit64_t a, trit64_t b){
+
+    return reduce_trit64_t(mont, trit_mul_wide_trit64_t(a, b));
+}
+
+/**
+ * @brief Raises a @c trit32_t Montgomery value to a power.
+ *
+ * Scans the exponent from its top digit. A zero digit cubes the
+ * result, otherwise a window of up to WINDOW_TRITS digits ending
+ * on a nonzero digit cubes the result once per digit and then
+ * multiplies in the table power the window reads as.
+ *
+ * @warning This method asserts that @p exponent is not negative.
+ *
+ * @param[in] mont The Montgomery constants.
+ *
+ * @param[in] base The Montgomery base, in (-m, m).
+ *
+ * @param[in] exponent The balanced ternary exponent.
+ *
+ * @return The Montgomery power, in (-m, m)
+ */
+trit32_t trit_mont_pow_trit32_t(const trit_mont32_t *mont, trit32_t base, trit32_t exponent){
+
+    trit32_t digits = balanced_ternary_to_unbalanced_ternary_trit32_t(exponent);
+    trit32_t table[WINDOW_SIZE];
+    trit32_t result = mont->one;
+    bool started = false;
+    int top = 0;
+    int low = 0;
+    int index = 0;
+    int window = 0;
+
+    if(digits == 0){
+
+        return mont->one;
+    }
+
+    table[0] = mont->one;
+    table[1] = base;
+
+    for(index = 2; index < WINDOW_SIZE; index++){
+
+        table[index] = trit_mont_mul_trit32_t(mont, table[index - 1], base);
+    }
+
+    for(top = (63 - __builtin_clzll(digits)) / 2; top >= 0; top = low - 1){
+
+        low = top - WINDOW_TRITS + 1 < 0 ? 0 : top - WINDOW_TRITS + 1;
+
+        while(low < top && ((digits >> (2 * low)) & 3) == 0){
+
+            low++;
+        }
+
+        window = 0;
+
+        for(index = top; index >= low; index--){
+
+            window = 3 * window + (int)((digits >> (2 * index)) & 3);
+
+            if(started){
+
+                result = trit_mont_mul_trit32_t(mont, trit_mont_mul_trit32_t(mont, result, result), result);
+            }
+        }
+
+        if(window){
+
+            result = started ? trit_mont_mul_trit32_t(mont, result, table[window]) : table[window];
+            started = true;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief Raises a @c trit64_t Montgomery value to a power.
+ *
+ * @warning This method asserts that @p exponent is not negative.
+ *
+ * @param[in] mont The Montgomery constants.
+ *
+ * @param[in] base The Montgomery base, in (-m, m).
+ *
+ * @param[in] exponent The balanced ternary exponent.
+ *
+ * @return The Montgomery power, in (-m, m)
+ * @see trit_mont_pow_trit32_t
+ */
+trit64_t trit_mont_pow_trit64_t(const trit_mont64_t *mont, trit64_t base, trit64_t exponent){
+
+    trit64_t digits = balanced_ternary_to_unbalanced_ternary_trit64_t(exponent);
+    trit64_t table[WINDOW_SIZE];
+    trit64_t result = mont->one;
+    uint64_t high = (uint64_t)(digits >> 64);
+    bool started = false;
+    int top = 0;
+    int low = 0;
+    int index = 0;
+    int window = 0;
+
+    if(digits == 0){
+
+        return mont->one;
+    }
+
+    table[0] = mont->one;
+    table[1] = base;
+
+    for(index = 2; index < WINDOW_SIZE; index++){
+
+        table[index] = trit_mont_mul_trit64_t(mont, table[index - 1], base);
+    }
+
+    top = high ? 32 + (63 - __builtin_clzll(high)) / 2 : (63 - __builtin_clzll((uint64_t)digits)) / 2;
+
+    for(; top >= 0; top = low - 1){
+
+        low = top - WINDOW_TRITS + 1 < 0 ? 0 : top - WINDOW_TRITS + 1;
+
+        while(low < top && ((digits >> (2 * low)) & 3) == 0){
+
+            low++;
+        }
+
+        window = 0;
+
+        for(index = top; index >= low; index--){
+
+            window = 3 * window + (int)((digits >> (2 * index)) & 3);
+
+            if(started){
+
+                result = trit_mont_mul_trit64_t(mont, trit_mont_mul_trit64_t(mont, result, result), result);
+            }
+        }
+
+        if(window){
+
+            result = started ? trit_mont_mul_trit64_t(mont, result, table[window]) : table[window];
+            started = true;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief Adds two @c trit32_t numbers mod m.
+ *
+ * Any modulus above 0 works, multiples of 3 included.
+ *
+ * @param[in] a The first value, in [0, m).
+ *
+ * @param[in] b The second value, in [0, m).
+ *
+ * @param[in] modulus The modulus m.
+ *
+ * @return @p a + @p b mod m, in [0, m)
+ */
+trit32_t trit_addmod_trit32_t(trit32_t a, trit32_t b, trit32_t modulus){
+
+    trit64_t sum = trit_add_trit64_t(trit_widen_trit32_t_to_trit64_t(a), trit_widen_trit32_t_to_trit64_t(b));
+    trit64_t reduced = trit_sub_trit64_t(sum, trit_widen_trit32_t_to_trit64_t(modulus));
+
+    return (trit32_t)(negative_trit64_t(reduced) ? sum : reduced);
+}
+
+/**
+ * @brief Adds two @c trit64_t numbers mod m.
+ *
+ * @param[in] a The first value, in [0, m).
+ *
+ * @param[in] b The second value, in [0, m).
+ *
+ * @param[in] modulus The modulus m.
+ *
+ * @return @p a + @p b mod m, in [0, m)
+ * @see trit_addmod_trit32_t
+ */
+trit64_t trit_addmod_trit64_t(trit64_t a, trit64_t b, trit64_t modulus){
+
+    trit128_t sum = trit_add_trit128_t(trit_widen_trit64_t_to_trit128_t(a), trit_widen_trit64_t_to_trit128_t(b));
+    trit128_t reduced = trit_sub_trit128_t(sum, trit_widen_trit64_t_to_trit128_t(modulus));
+    bool negative = reduced.high ? negative_trit64_t(reduced.high) : negative_trit64_t(reduced.low);
+
+    return negative ? sum.low : reduced.low;
+}
+
+/**
+ * @brief Multiplies two @c trit32_t numbers mod m.
+ *
+ * One product costs two Montgomery reductions plus the set up,
+ * for many products with the same modulus use the trit_mont
+ * methods directly.
+ *
+ * @warning This method asserts that @p modulus
+ * is above 0 and not a multiple of 3.
+ *
+ * @param[in] a The first value, in (-m, m).
+ *
+ * @param[in] b The second value, in (-m, m).
+ *
+ * @param[in] modulus The modulus m.
+ *
+ * @return @p a * @p b mod m, in [0, m)
+ */
+trit32_t trit_mulmod_trit32_t(trit32_t a, trit32_t b, trit32_t modulus){
+
+    trit_mont32_t mont;
+    bool valid = trit_mont_init_trit32_t(&mont, modulus);
+
+    assert(valid && "Modulus is not above 0 or is a multiple of 3");
+
+    // a * b / R is in (-m, m) and a Montgomery product with R^2 mod m multiplies it back by R
+    return canonical_trit32_t(&mont, trit_mont_mul_trit32_t(&mont, trit_mont_mul_trit32_t(&mont, a, b), mont.square));
+}
+
+/**
+ * @brief Multiplies two @c trit64_t numbers mod m.
+ *
+ * @warning This method asserts that @p modulus
+ * is above 0 and not a multiple of 3.
+ *
+ * @param[in] a The first value, in (-m, m).
+ *
+ * @param[in] b The second value, in (-m, m).
+ *
+ * @param[in] modulus The modulus m.
+ *
+ * @return @p a * @p b mod m, in [0, m)
+ * @see trit_mulmod_trit32_t
+ */
+trit64_t trit_mulmod_trit64_t(trit64_t a, trit64_t b, trit64_t modulus){
+
+    trit_mont64_t mont;
+    bool valid = trit_mont_init_trit64_t(&mont, modulus);
+
+    assert(valid && "Modulus is not above 0 or is a multiple of 3");
+
+    return canonical_trit64_t(&mont, trit_mont_mul_trit64_t(&mont, trit_mont_mul_trit64_t(&mont, a, b), mont.square));
+}
+
+/**
+ * @brief Raises a @c trit32_t number to a power mod m.
+ *
+ * @warning This method asserts that @p modulus is above 0 and
+ * not a multiple of 3, and that @p exponent is not negative.
+ *
+ * @param[in] base The base, in (-m, m).
+ *
+ * @param[in] exponent The exponent.
+ *
+ * @param[in] modulus The modulus m.
+ *
+ * @return @p base ^ @p exponent mod m, in [0, m)
+ */
+trit32_t trit_powmod_trit32_t(trit32_t base, trit32_t exponent, trit32_t modulus){
+
+    trit_mont32_t mont;
+    bool valid = trit_mont_init_trit32_t(&mont, modulus);
+
+    assert(valid && "Modulus is not above 0 or is a multiple of 3");
+
+    return trit_mont_out_trit32_t(&mont, trit_mont_pow_trit32_t(&mont, trit_mont_in_trit32_t(&mont, base), exponent));
+}
+
+/**
+ * @brief Raises a @c trit64_t number to a power mod m.
+ *
+ * @warning This method asserts that @p modulus is above 0 and
+ * not a multiple of 3, and that @p exponent is not negative.
+ *
+ * @param[in] base The base, in (-m, m).
+ *
+ * @param[in] exponent The exponent.
+ *
+ * @param[in] modulus The modulus m.
+ *
+ * @return @p base ^ @p exponent mod m, in [0, m)
+ */
+trit64_t trit_powmod_trit64_t(trit64_t base, trit64_t exponent, trit64_t modulus){
+
+    trit_mont64_t mont;
+    bool valid = trit_mont_init_trit64_t(&mont, modulus);
+
+    assert(valid && "Modulus is not above 0 or is a multiple of 3");
+
+    return trit_mont_out_trit64_t(&mont, trit_mont_pow_trit64_t(&mont, trit_mont_in_trit64_t(&mont, base), exponent));
+}
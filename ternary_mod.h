@@ -0,0 +1,54 @@
+#ifndef __ternary_mod_h__
+#define __ternary_mod_h__
+
+#include"ternary.h"
+
+/**
+ * @brief Montgomery constants for a @c trit32_t modulus, R = 3^32.
+ */
+typedef struct{
+
+    trit32_t modulus; /**< The modulus m, above 0 and not a multiple of 3 */
+    trit32_t inverse; /**< m^-1 mod 3^32 */
+    trit32_t one;     /**< R mod m, the Montgomery form of 1 */
+    trit32_t square;  /**< R^2 mod m, used to enter Montgomery form */
+} trit_mont32_t;
+
+/**
+ * @brief Montgomery constants for a @c trit64_t modulus, R = 3^64.
+ */
+typedef struct{
+
+    trit64_t modulus; /**< The modulus m, above 0 and not a multiple of 3 */
+    trit64_t inverse; /**< m^-1 mod 3^64 */
+    trit64_t one;     /**< R mod m, the Montgomery form of 1 */
+    trit64_t square;  /**< R^2 mod m, used to enter Montgomery form */
+} trit_mont64_t;
+
+// MONTGOMERY FUNCTIONS
+bool trit_mont_init_trit32_t(trit_mont32_t *mont, trit32_t modulus);
+bool trit_mont_init_trit64_t(trit_mont64_t *mont, trit64_t modulus);
+
+trit32_t trit_mont_in_trit32_t(const trit_mont32_t *mont, trit32_t num);
+trit64_t trit_mont_in_trit64_t(const trit_mont64_t *mont, trit64_t num);
+
+trit32_t trit_mont_out_trit32_t(const trit_mont32_t *mont, trit32_t num);
+trit64_t trit_mont_out_trit64_t(const trit_mont64_t *mont, trit64_t num);
+
+trit32_t trit_mont_mul_trit32_t(const trit_mont32_t *mont, trit32_t a, trit32_t b);
+trit64_t trit_mont_mul_trit64_t(const trit_mont64_t *mont, trit64_t a, trit64_t b);
+
+trit32_t trit_mont_pow_trit32_t(const trit_mont32_t *mont, trit32_t base, trit32_t exponent);
+trit64_t trit_mont_pow_trit64_t(const trit_mont64_t *mont, trit64_t base, trit64_t exponent);
+
+// MODULAR FUNCTIONS
+trit32_t trit_addmod_trit32_t(trit32_t a, trit32_t b, trit32_t modulus);
+trit64_t trit_addmod_trit64_t(trit64_t a, trit64_t b, trit64_t modulus);
+
+trit32_t trit_mulmod_trit32_t(trit32_t a, trit32_t b, trit32_t modulus);
+trit64_t trit_mulmod_trit64_t(trit64_t a, trit64_t b, trit64_t modulus);
+
+trit32_t trit_powmod_trit32_t(trit32_t base, trit32_t exponent, trit32_t modulus);
+trit64_t trit_powmod_trit64_t(trit64_t base, trit64_t exponent, trit64_t modulus);
+
+#endif // __ternary_mod_h__
@@ -0,0 +1,1009 @@
+/**
+ * @file ternary_quant.c
+ *
+ * @brief File contains quantizers from float and bfloat16 to
+ * packed balanced ternary and back.
+ *
+ * A value becomes +1 if it is above the threshold, -1 if it is
+ * below minus the threshold and 0 otherwise, written in the
+ * @c trit32_t layout the dot product and GEMM kernels read.
+ * Dequantizing gives plus or minus the scale for a nonzero trit
+ * and 0 for a zero one.
+ *
+ * The kernels build the low (magnitude) and high (sign) bit of
+ * 32 trits as two 32 bit masks, from compare results moved to
+ * general registers, and interleave them into one word. The
+ * per-channel functions treat a tensor as rows of @c length
+ * values, each with its own threshold and scale and each
+ * starting a new word, the row layout of @c trit_gemv_float.
+ */
+
+
+#include<math.h>
+#include<string.h>
+
+#include"ternary_quant.h"
+#include"ternary_gemm.h"
+#include"ternary_thread.h"
+#include"ternary_cpu.h"
+
+#define TRITS_PER_WORD 32 /**< Number of trits packed in a @c trit32_t */
+#define LOW_BITS 0x5555555555555555ULL /**< The low bit of every trit */
+#define GRAIN_WORDS 4096 /**< The smallest number of words one thread converts */
+
+/**
+ * @brief Moves bit i of @p num to bit 2 * i.
+ *
+ * @param[in] num The bits.
+ *
+ * @return @p num with a 0 bit after every bit
+ */
+static inline uint64_t spread_bits(uint32_t num){
+
+    uint64_t result = num;
+
+    result = (result | (result << 16)) & 0x0000FFFF0000FFFFULL;
+    result = (result | (result << 8)) & 0x00FF00FF00FF00FFULL;
+    result = (result | (result << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    result = (result | (result << 2)) & 0x3333333333333333ULL;
+    result = (result | (result << 1)) & LOW_BITS;
+
+    return result;
+}
+
+/**
+ * @brief Widens a bfloat16 to a float.
+ *
+ * @param[in] value The bfloat16 bits, the high half of a float.
+ *
+ * @return The value as a float
+ */
+static inline float bf16_to_float(uint16_t value){
+
+    uint32_t bits = (uint32_t)value << 16;
+    float result = 0;
+
+    memcpy(&result, &bits, sizeof(result));
+
+    return result;
+}
+
+/**
+ * @brief Quantizes one value.
+ *
+ * @param[in] value The value.
+ *
+ * @param[in] threshold The threshold, at least 0.
+ *
+ * @param[out] neg Set to 1 if the trit is -1, otherwise 0.
+ *
+ * @return 1 if the trit is nonzero, otherwise 0
+ */
+static inline uint32_t quantize_value(float value, float threshold, uint32_t *neg){
+
+    uint32_t mag = fabsf(value) > threshold;
+
+    *neg = mag & (value < 0);
+
+    return mag;
+}
+
+// SCALAR QUANTIZE KERNELS
+
+/**
+ * @brief Quantizes floats to packed balanced ternary.
+ *
+ * Value i becomes trit i of the output, +1 above @p threshold,
+ * -1 below -@p threshold and 0 otherwise. NaN becomes 0. The
+ * trits past @p n in the last word are 0.
+ *
+ * @param[in] values The @p n values.
+ *
+ * @param[in] n The number of values.
+ *
+ * @param[in] threshold The threshold, at least 0.
+ *
+ * @param[out] out The trits, @p n rounded up to whole words.
+ */
+void trit_quantize_scalar_float(const float *values, size_t n, float threshold, trit32_t *out){
+
+    uint32_t mag = 0;
+    uint32_t neg = 0;
+    uint32_t bit = 0;
+    size_t words = (n + TRITS_PER_WORD - 1) / TRITS_PER_WORD;
+    size_t word = 0;
+    size_t index = 0;
+
+    for(word = 0; word < words; word++){
+
+        mag = 0;
+        neg = 0;
+
+        for(index = word * TRITS_PER_WORD; index < n && index < (word + 1) * TRITS_PER_WORD; index++){
+
+            mag |= quantize_value(values[index], threshold, &bit) << (index % TRITS_PER_WORD);
+            neg |= bit << (index % TRITS_PER_WORD);
+        }
+
+        out[word] = spread_bits(mag) | (spread_bits(neg) << 1);
+    }
+}
+
+/**
+ * @brief Quantizes bfloat16 values to packed balanced ternary.
+ *
+ * @see trit_quantize_scalar_float
+ *
+ * @param[in] values The @p n values, as the bits of bfloat16.
+ *
+ * @param[in] n The number of values.
+ *
+ * @param[in] threshold The threshold, at least 0.
+ *
+ * @param[out] out The trits, @p n rounded up to whole words.
+ */
+void trit_quantize_scalar_bf16(const uint16_t *values, size_t n, float threshold, trit32_t *out){
+
+    uint32_t mag = 0;
+    uint32_t neg = 0;
+    uint32_t bit = 0;
+    size_t words = (n + TRITS_PER_WORD - 1) / TRITS_PER_WORD;
+    size_t word = 0;
+    size_t index = 0;
+
+    for(word = 0; word < words; word++){
+
+        mag = 0;
+        neg = 0;
+
+        for(index = word * TRITS_PER_WORD; index < n && index < (word + 1) * TRITS_PER_WORD; index++){
+
+            mag |= quantize_value(bf16_to_float(values[index]), threshold, &bit) << (index % TRITS_PER_WORD);
+            neg |= bit << (index % TRITS_PER_WORD);
+        }
+
+        out[word] = spread_bits(mag) | (spread_bits(neg) << 1);
+    }
+}
+
+/**
+ * @brief Dequantizes packed balanced ternary to floats.
+ *
+ * Trit i becomes @p scale times the trit. The unbalanced code
+ * 0b10 counts as 0.
+ *
+ * @param[in] trits The packed trits, @p n trits rounded up to
+ * whole words.
+ *
+ * @param[in] n The number of trits.
+ *
+ * @param[in] scale The value of a +1 trit.
+ *
+ * @param[out] out The @p n values.
+ */
+void trit_dequantize_scalar_float(const trit32_t *trits, size_t n, float scale, float *out){
+
+    const float table[4] = {0.0f, scale, 0.0f, -scale};
+    trit32_t grab = 0;
+    size_t words = (n + TRITS_PER_WORD - 1) / TRITS_PER_WORD;
+    size_t word = 0;
+    size_t index = 0;
+
+    for(word = 0; word < words; word++){
+
+        grab = trits[word];
+        for(index = word * TRITS_PER_WORD; index < n && index < (word + 1) * TRITS_PER_WORD; index++){
+
+            out[index] = table[grab & 3];
+            grab >>= 2;
+        }
+    }
+}
+
+#ifdef TERNARY_X86_64
+// AVX2 QUANTIZE KERNELS
+
+/**
+ * @brief Finds the trit masks of 8 values.
+ *
+ * @param[in] x The values.
+ *
+ * @param[in] threshold The threshold in every lane.
+ *
+ * @param[out] neg The lanes whose trit is -1.
+ *
+ * @return The lanes whose trit is nonzero
+ */
+__attribute__((target("avx2"), always_inline))
+static inline uint32_t quantize_lanes(__m256 x, __m256 threshold, uint32_t *neg){
+
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    __m256 mag = _mm256_cmp_ps(_mm256_andnot_ps(sign, x), threshold, _CMP_GT_OQ);
+
+    *neg = (uint32_t)_mm256_movemask_ps(_mm256_and_ps(mag, x));
+
+    return (uint32_t)_mm256_movemask_ps(mag);
+}
+
+/**
+ * @brief Quantizes floats to packed balanced ternary with AVX2.
+ *
+ * @warning The CPU must support AVX2.
+ *
+ * @see trit_quantize_scalar_float
+ *
+ * @param[in] values The @p n values.
+ *
+ * @param[in] n The number of values.
+ *
+ * @param[in] threshold The threshold, at least 0.
+ *
+ * @param[out] out The trits, @p n rounded up to whole words.
+ */
+__attribute__((target("avx2")))
+void trit_quantize_avx2_float(const float *values, size_t n, float threshold, trit32_t *out){
+
+    const __m256 limit = _mm256_set1_ps(threshold);
+    uint32_t mag = 0;
+    uint32_t neg = 0;
+    uint32_t bits = 0;
+    size_t words = n / TRITS_PER_WORD;
+    size_t word = 0;
+    int part = 0;
+
+    for(word = 0; word < words; word++){
+
+        mag = 0;
+        neg = 0;
+
+        for(part = 0; part < 4; part++){
+
+            mag |= quantize_lanes(_mm256_loadu_ps(values + word * TRITS_PER_WORD + part * 8), limit, &bits) << (part * 8);
+            neg |= bits << (part * 8);
+        }
+
+        out[word] = spread_bits(mag) | (spread_bits(neg) << 1);
+    }
+
+    if(n % TRITS_PER_WORD != 0){
+
+        trit_quantize_scalar_float(values + words * TRITS_PER_WORD, n % TRITS_PER_WORD, threshold, out + words);
+    }
+}
+
+/**
+ * @brief Quantizes bfloat16 values to packed balanced ternary
+ * with AVX2.
+ *
+ * The values are widened to floats by moving them into the
+ * high half of 32 bit lanes.
+ *
+ * @warning The CPU must support AVX2.
+ *
+ * @see trit_quantize_scalar_bf16
+ *
+ * @param[in] values The @p n values, as the bits of bfloat16.
+ *
+ * @param[in] n The number of values.
+ *
+ * @param[in] threshold The threshold, at least 0.
+ *
+ * @param[out] out The trits, @p n rounded up to whole words.
+ */
+__attribute__((target("avx2")))
+void trit_quantize_avx2_bf16(const uint16_t *values, size_t n, float threshold, trit32_t *out){
+
+    const __m256 limit = _mm256_set1_ps(threshold);
+    __m256i wide;
+    uint32_t mag = 0;
+    uint32_t neg = 0;
+    uint32_t bits = 0;
+    size_t words = n / TRITS_PER_WORD;
+    size_t word = 0;
+    int part = 0;
+
+    for(word = 0; word < words; word++){
+
+        mag = 0;
+        neg = 0;
+
+        for(part = 0; part < 4; part++){
+
+            wide = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)(values + word * TRITS_PER_WORD + part * 8)));
+            mag |= quantize_lanes(_mm256_castsi256_ps(_mm256_slli_epi32(wide, 16)), limit, &bits) << (part * 8);
+            neg |= bits << (part * 8);
+        }
+
+        out[word] = spread_bits(mag) | (spread_bits(neg) << 1);
+    }
+
+    if(n % TRITS_PER_WORD != 0){
+
+        trit_quantize_scalar_bf16(values + words * TRITS_PER_WORD, n % TRITS_PER_WORD, threshold, out + words);
+    }
+}
+
+/**
+ * @brief Dequantizes packed balanced ternary to floats with AVX2.
+ *
+ * Each group of 8 trits is broadcast and compared against the
+ * bit of every lane, as in @c trit_dot_avx2_float.
+ *
+ * @warning The CPU must support AVX2.
+ *
+ * @see trit_dequantize_scalar_float
+ *
+ * @param[in] trits The packed trits, @p n trits rounded up to
+ * whole words.
+ *
+ * @param[in] n The number of trits.
+ *
+ * @param[in] scale The value of a +1 trit.
+ *
+ * @param[out] out The @p n values.
+ */
+__attribute__((target("avx2")))
+void trit_dequantize_avx2_float(const trit32_t *trits, size_t n, float scale, float *out){
+
+    const __m256i mag_bits = _mm256_setr_epi32(0x0001, 0x0004, 0x0010, 0x0040,
+                                               0x0100, 0x0400, 0x1000, 0x4000);
+    const __m256i sign_bits = _mm256_slli_epi32(mag_bits, 1);
+    const __m256i sign_flip = _mm256_set1_epi32((int)0x80000000);
+    const __m256 value = _mm256_set1_ps(scale);
+    __m256i group, mag, sign;
+    size_t words = n / TRITS_PER_WORD;
+    size_t word = 0;
+    int part = 0;
+
+    for(word = 0; word < words; word++){
+
+        for(part = 0; part < 4; part++){
+
+            group = _mm256_set1_epi32((int)((trits[word] >> (part * 16)) & 0xFFFF));
+            mag = _mm256_cmpeq_epi32(_mm256_and_si256(group, mag_bits), mag_bits);
+            sign = _mm256_and_si256(_mm256_cmpeq_epi32(_mm256_and_si256(group, sign_bits), sign_bits), sign_flip);
+
+            _mm256_storeu_ps(out + word * TRITS_PER_WORD + part * 8,
+                             _mm256_and_ps(_mm256_xor_ps(value, _mm256_castsi256_ps(sign)), _mm256_castsi256_ps(mag)));
+        }
+    }
+
+    trit_dequantize_scalar_float(trits + words, n - words * TRITS_PER_WORD, scale, out + words * TRITS_PER_WORD);
+}
+
+// AVX-512 QUANTIZE KERNELS
+
+/**
+ * @brief Quantizes floats to packed balanced ternary with AVX-512.
+ *
+ * The compares give mask registers directly and pdep
+ * interleaves the two masks.
+ *
+ * @warning The CPU must support AVX-512BW and BMI2.
+ *
+ * @see trit_quantize_scalar_float
+ *
+ * @param[in] values The @p n values.
+ *
+ * @param[in] n The number of values.
+ *
+ * @param[in] threshold The threshold, at least 0.
+ *
+ * @param[out] out The trits, @p n rounded up to whole words.
+ */
+__attribute__((target("avx512f,avx512bw,bmi2")))
+void trit_quantize_avx512_float(const float *values, size_t n, float threshold, trit32_t *out){
+
+    const __m512 limit = _mm512_set1_ps(threshold);
+    const __m512 zero = _mm512_setzero_ps();
+    __m512 low, high;
+    __mmask16 low_mag, high_mag;
+    uint32_t mag = 0;
+    uint32_t neg = 0;
+    size_t words = n / TRITS_PER_WORD;
+    size_t word = 0;
+
+    for(word = 0; word < words; word++){
+
+        low = _mm512_loadu_ps(values + word * TRITS_PER_WORD);
+        high = _mm512_loadu_ps(values + word * TRITS_PER_WORD + 16);
+        low_mag = _mm512_cmp_ps_mask(_mm512_abs_ps(low), limit, _CMP_GT_OQ);
+        high_mag = _mm512_cmp_ps_mask(_mm512_abs_ps(high), limit, _CMP_GT_OQ);
+        mag = (uint32_t)low_mag | ((uint32_t)high_mag << 16);
+        neg = (uint32_t)_mm512_mask_cmp_ps_mask(low_mag, low, zero, _CMP_LT_OQ)
+            | ((uint32_t)_mm512_mask_cmp_ps_mask(high_mag, high, zero, _CMP_LT_OQ) << 16);
+
+        out[word] = _pdep_u64(mag, LOW_BITS) | (_pdep_u64(neg, LOW_BITS) << 1);
+    }
+
+    if(n % TRITS_PER_WORD != 0){
+
+        trit_quantize_scalar_float(values + words * TRITS_PER_WORD, n % TRITS_PER_WORD, threshold, out + words);
+    }
+}
+
+/**
+ * @brief Quantizes bfloat16 values to packed balanced ternary
+ * with AVX-512.
+ *
+ * @warning The CPU must support AVX-512BW and BMI2.
+ *
+ * @see trit_quantize_avx512_float
+ *
+ * @param[in] values The @p n values, as the bits of bfloat16.
+ *
+ * @param[in] n The number of values.
+ *
+ * @param[in] threshold The threshold, at least 0.
+ *
+ * @param[out] out The trits, @p n rounded up to whole words.
+ */
+__attribute__((target("avx512f,avx512bw,bmi2")))
+void trit_quantize_avx512_bf16(const uint16_t *values, size_t n, float threshold, trit32_t *out){
+
+    const __m512 limit = _mm512_set1_ps(threshold);
+    const __m512 zero = _mm512_setzero_ps();
+    __m512 low, high;
+    __mmask16 low_mag, high_mag;
+    uint32_t mag = 0;
+    uint32_t neg = 0;
+    size_t words = n / TRITS_PER_WORD;
+    size_t word = 0;
+
+    for(word = 0; word < words; word++){
+
+        low = _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_cvtepu16_epi32(
+                  _mm256_loadu_si256((const __m256i *)(values + word * TRITS_PER_WORD))), 16));
+        high = _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_cvtepu16_epi32(
+                   _mm256_loadu_si256((const __m256i *)(values + word * TRITS_PER_WORD + 16))), 16));
+        low_mag = _mm512_cmp_ps_mask(_mm512_abs_ps(low), limit, _CMP_GT_OQ);
+        high_mag = _mm512_cmp_ps_mask(_mm512_abs_ps(high), limit, _CMP_GT_OQ);
+        mag = (uint32_t)low_mag | ((uint32_t)high_mag << 16);
+        neg = (uint32_t)_mm512_mask_cmp_ps_mask(low_mag, low, zero, _CMP_LT_OQ)
+            | ((uint32_t)_mm512_mask_cmp_ps_mask(high_mag, high, zero, _CMP_LT_OQ) << 16);
+
+        out[word] = _pdep_u64(mag, LOW_BITS) | (_pdep_u64(neg, LOW_BITS) << 1);
+    }
+
+    if(n % TRITS_PER_WORD != 0){
+
+        trit_quantize_scalar_bf16(values + words * TRITS_PER_WORD, n % TRITS_PER_WORD, threshold, out + words);
+    }
+}
+
+/**
+ * @brief Dequantizes packed balanced ternary to floats with AVX-512.
+ *
+ * pext splits a word into 32 bit magnitude and sign masks which
+ * pick plus or minus the scale, or 0, for 16 lanes at a time.
+ *
+ * @warning The CPU must support AVX-512BW and BMI2.
+ *
+ * @see trit_dequantize_scalar_float
+ *
+ * @param[in] trits The packed trits, @p n trits rounded up to
+ * whole words.
+ *
+ * @param[in] n The number of trits.
+ *
+ * @param[in] scale The value of a +1 trit.
+ *
+ * @param[out] out The @p n values.
+ */
+__attribute__((target("avx512f,avx512bw,bmi2")))
+void trit_dequantize_avx512_float(const trit32_t *trits, size_t n, float scale, float *out){
+
+    const __m512 pos = _mm512_set1_ps(scale);
+    const __m512 neg = _mm512_set1_ps(-scale);
+    uint32_t mag = 0;
+    uint32_t sign = 0;
+    size_t words = n / TRITS_PER_WORD;
+    size_t word = 0;
+
+    for(word = 0; word < words; word++){
+
+        mag = (uint32_t)_pext_u64(trits[word], LOW_BITS);
+        sign = (uint32_t)_pext_u64(trits[word] >> 1, LOW_BITS);
+
+        _mm512_storeu_ps(out + word * TRITS_PER_WORD,
+                         _mm512_maskz_mov_ps((__mmask16)mag, _mm512_mask_blend_ps((__mmask16)sign, pos, neg)));
+        _mm512_storeu_ps(out + word * TRITS_PER_WORD + 16,
+                         _mm512_maskz_mov_ps((__mmask16)(mag >> 16), _mm512_mask_blend_ps((__mmask16)(sign >> 16), pos, neg)));
+    }
+
+    trit_dequantize_scalar_float(trits + words, n - words * TRITS_PER_WORD, scale, out + words * TRITS_PER_WORD);
+}
+#endif
+
+// QUANTIZE FUNCTIONS
+
+typedef void (*quantize_float_fn)(const float *values, size_t n, float threshold, trit32_t *out);
+typedef void (*quantize_bf16_fn)(const uint16_t *values, size_t n, float threshold, trit32_t *out);
+typedef void (*dequantize_float_fn)(const trit32_t *trits, size_t n, float scale, float *out);
+
+/**
+ * @brief Arguments of the range functions of this file.
+ */
+typedef struct{
+
+    const float *floats;            /**< The float values, or NULL */
+    const uint16_t *halves;         /**< The bfloat16 values, or NULL */
+    const trit32_t *trits;          /**< The trits to dequantize, or NULL */
+    trit32_t *out;                  /**< The quantized trits */
+    float *values;                  /**< The dequantized values */
+    const float *params;            /**< The threshold or scale of every channel, or NULL */
+    float *scales;                  /**< The scales found by @c scales_range */
+    float param;                    /**< The threshold or scale of all values, or the ratio */
+    size_t n;                       /**< The number of values, or of values per channel */
+    quantize_float_fn quantize;     /**< The float kernel */
+    quantize_bf16_fn quantize_bf16; /**< The bfloat16 kernel */
+    dequantize_float_fn dequantize; /**< The dequantize kernel */
+} quant_args;
+
+/**
+ * @brief Picks the float quantize kernel for this CPU.
+ *
+ * @return The widest kernel the CPU supports
+ */
+static quantize_float_fn pick_quantize_float(void){
+
+#ifdef TERNARY_X86_64
+    if(trit_cpu_avx512()){
+
+        return trit_quantize_avx512_float;
+    }
+    if(trit_cpu_avx2()){
+
+        return trit_quantize_avx2_float;
+    }
+#endif
+    return trit_quantize_scalar_float;
+}
+
+/**
+ * @brief Picks the bfloat16 quantize kernel for this CPU.
+ *
+ * @return The widest kernel the CPU supports
+ */
+static quantize_bf16_fn pick_quantize_bf16(void){
+
+#ifdef TERNARY_X86_64
+    if(trit_cpu_avx512()){
+
+        return trit_quantize_avx512_bf16;
+    }
+    if(trit_cpu_avx2()){
+
+        return trit_quantize_avx2_bf16;
+    }
+#endif
+    return trit_quantize_scalar_bf16;
+}
+
+/**
+ * @brief Picks the dequantize kernel for this CPU.
+ *
+ * @return The widest kernel the CPU supports
+ */
+static dequantize_float_fn pick_dequantize_float(void){
+
+#ifdef TERNARY_X86_64
+    if(trit_cpu_avx512()){
+
+        return trit_dequantize_avx512_float;
+    }
+    if(trit_cpu_avx2()){
+
+        return trit_dequantize_avx2_float;
+    }
+#endif
+    return trit_dequantize_scalar_float;
+}
+
+/**
+ * @brief Converts the words [start, end) of one tensor.
+ *
+ * The kernel is the one of @c quantize, @c quantize_bf16 and
+ * @c dequantize that is set, the data pointers may all be NULL
+ * when the tensor is empty.
+ *
+ * @param[in] arg The @c quant_args, with one kernel set.
+ *
+ * @param[in] start The first word.
+ *
+ * @param[in] end One past the last word.
+ */
+static void words_range(void *arg, size_t start, size_t end){
+
+    quant_args *args = (quant_args *)arg;
+    size_t first = start * TRITS_PER_WORD;
+    size_t count = 0;
+
+    if(start >= end){
+
+        return;
+    }
+
+    count = (end * TRITS_PER_WORD < args->n ? end * TRITS_PER_WORD : args->n) - first;
+
+    if(args->quantize != NULL){
+
+        args->quantize(args->floats + first, count, args->param, args->out + start);
+    }
+    else if(args->quantize_bf16 != NULL){
+
+        args->quantize_bf16(args->halves + first, count, args->param, args->out + start);
+    }
+    else{
+
+        args->dequantize(args->trits + start, count, args->param, args->values + first);
+    }
+}
+
+/**
+ * @brief Quantizes floats to packed balanced ternary using threads.
+ *
+ * Value i becomes trit i of the output, +1 above @p threshold,
+ * -1 below -@p threshold and 0 otherwise. NaN becomes 0. The
+ * trits past @p n in the last word are 0.
+ *
+ * @param[in] values The @p n values.
+ *
+ * @param[in] n The number of values.
+ *
+ * @param[in] threshold The threshold, at least 0.
+ *
+ * @param[out] out The trits, @p n rounded up to whole words.
+ *
+ * @param[in] threads The number of threads,
+ * see @c trit_thread_count.
+ */
+void trit_quantize_float(const float *values, size_t n, float threshold, trit32_t *out, int threads){
+
+    quant_args args;
+
+    memset(&args, 0, sizeof(args));
+    args.floats = values;
+    args.out = out;
+    args.param = threshold;
+    args.n = n;
+    args.quantize = pick_quantize_float();
+
+    trit_parallel_for((n + TRITS_PER_WORD - 1) / TRITS_PER_WORD, GRAIN_WORDS, threads, words_range, &args);
+}
+
+/**
+ * @brief Quantizes bfloat16 values to packed balanced ternary
+ * using threads.
+ *
+ * @see trit_quantize_float
+ *
+ * @param[in] values The @p n values, as the bits of bfloat16.
+ *
+ * @param[in] n The number of values.
+ *
+ * @param[in] threshold The threshold, at least 0.
+ *
+ * @param[out] out The trits, @p n rounded up to whole words.
+ *
+ * @param[in] threads The number of threads,
+ * see @c trit_thread_count.
+ */
+void trit_quantize_bf16(const uint16_t *values, size_t n, float threshold, trit32_t *out, int threads){
+
+    quant_args args;
+
+    memset(&args, 0, sizeof(args));
+    args.halves = values;
+    args.out = out;
+    args.param = threshold;
+    args.n = n;
+    args.quantize_bf16 = pick_quantize_bf16();
+
+    trit_parallel_for((n + TRITS_PER_WORD - 1) / TRITS_PER_WORD, GRAIN_WORDS, threads, words_range, &args);
+}
+
+/**
+ * @brief Dequantizes packed balanced ternary to floats using
+ * threads.
+ *
+ * Trit i becomes @p scale times the trit. The unbalanced code
+ * 0b10 counts as 0.
+ *
+ * @param[in] trits The packed trits, @p n trits rounded up to
+ * whole words.
+ *
+ * @param[in] n The number of trits.
+ *
+ * @param[in] scale The value of a +1 trit.
+ *
+ * @param[out] out The @p n values.
+ *
+ * @param[in] threads The number of threads,
+ * see @c trit_thread_count.
+ */
+void trit_dequantize_float(const trit32_t *trits, size_t n, float scale, float *out, int threads){
+
+    quant_args args;
+
+    memset(&args, 0, sizeof(args));
+    args.trits = trits;
+    args.values = out;
+    args.param = scale;
+    args.n = n;
+    args.dequantize = pick_dequantize_float();
+
+    trit_parallel_for((n + TRITS_PER_WORD - 1) / TRITS_PER_WORD, GRAIN_WORDS, threads, words_range, &args);
+}
+
+// BATCH QUANTIZE FUNCTIONS
+
+/**
+ * @brief Converts the channels [start, end) of a tensor.
+ *
+ * @param[in] arg The @c quant_args, with one kernel set and
+ * @c params.
+ *
+ * @param[in] start The first channel.
+ *
+ * @param[in] end One past the last channel.
+ */
+static void channels_range(void *arg, size_t start, size_t end){
+
+    quant_args *args = (quant_args *)arg;
+    size_t words = TRIT_ROW_WORDS(args->n);
+    size_t channel = 0;
+
+    for(channel = start; channel < end; channel++){
+
+        if(args->quantize != NULL){
+
+            args->quantize(args->floats + channel * args->n, args->n, args->params[channel], args->out + channel * words);
+        }
+        else if(args->quantize_bf16 != NULL){
+
+            args->quantize_bf16(args->halves + channel * args->n, args->n, args->params[channel], args->out + channel * words);
+        }
+        else{
+
+            args->dequantize(args->trits + channel * words, args->n, args->params[channel], args->values + channel * args->n);
+        }
+    }
+}
+
+/**
+ * @brief Finds the threshold and scale of the channels
+ * [start, end) of a tensor.
+ *
+ * @param[in] arg The @c quant_args, with @c floats or
+ * @c halves set, the ratio in @c param and the thresholds
+ * written to @c values.
+ *
+ * @param[in] start The first channel.
+ *
+ * @param[in] end One past the last channel.
+ */
+static void scales_range(void *arg, size_t start, size_t end){
+
+    quant_args *args = (quant_args *)arg;
+    size_t channel = 0;
+    size_t index = 0;
+    size_t kept = 0;
+    double total = 0;
+    float threshold = 0;
+    float value = 0;
+
+    for(channel = start; channel < end; channel++){
+
+        total = 0;
+        for(index = 0; index < args->n; index++){
+
+            value = args->floats != NULL ? args->floats[channel * args->n + index] :
+                                           bf16_to_float(args->halves[channel * args->n + index]);
+            total += fabsf(value);
+        }
+        threshold = args->n == 0 ? 0.0f : (float)(args->param * total / (double)args->n);
+
+        total = 0;
+        kept = 0;
+        for(index = 0; index < args->n; index++){
+
+            value = args->floats != NULL ? args->floats[channel * args->n + index] :
+                                           bf16_to_float(args->halves[channel * args->n + index]);
+            if(fabsf(value) > threshold){
+
+                total += fabsf(value);
+                kept++;
+            }
+        }
+
+        args->values[channel] = threshold;
+        args->scales[channel] = kept == 0 ? 0.0f : (float)(total / (double)kept);
+    }
+}
+
+/**
+ * @brief Finds a threshold and scale for every channel of a
+ * float tensor.
+ *
+ * This is the ternary weight network rule: the threshold is
+ * @p ratio times the mean magnitude of the channel, and the
+ * scale is the mean magnitude of the values above it, which
+ * minimises the squared error of the dequantized channel for
+ * that threshold. A @p ratio of 0.7 is the usual choice.
+ *
+ * @param[in] values @p channels rows of @p length values.
+ *
+ * @param[in] channels The number of channels.
+ *
+ * @param[in] length The number of values per channel.
+ *
+ * @param[in] ratio The threshold over the mean magnitude.
+ *
+ * @param[out] thresholds The threshold of every channel.
+ *
+ * @param[out] scales The scale of every channel, 0 if no value
+ * is above the threshold.
+ *
+ * @param[in] threads The number of threads,
+ * see @c trit_thread_count.
+ */
+void trit_quant_scales_float(const float *values, size_t channels, size_t length, float ratio,
+                             float *thresholds, float *scales, int threads){
+
+    quant_args args;
+
+    memset(&args, 0, sizeof(args));
+    args.floats = values;
+    args.values = thresholds;
+    args.scales = scales;
+    args.param = ratio;
+    args.n = length;
+
+    trit_parallel_for(channels, 1, threads, scales_range, &args);
+}
+
+/**
+ * @brief Finds a threshold and scale for every channel of a
+ * bfloat16 tensor.
+ *
+ * @see trit_quant_scales_float
+ *
+ * @param[in] values @p channels rows of @p length values, as
+ * the bits of bfloat16.
+ *
+ * @param[in] channels The number of channels.
+ *
+ * @param[in] length The number of values per channel.
+ *
+ * @param[in] ratio The threshold over the mean magnitude.
+ *
+ * @param[out] thresholds The threshold of every channel.
+ *
+ * @param[out] scales The scale of every channel, 0 if no value
+ * is above the threshold.
+ *
+ * @param[in] threads The number of threads,
+ * see @c trit_thread_count.
+ */
+void trit_quant_scales_bf16(const uint16_t *values, size_t channels, size_t length, float ratio,
+                            float *thresholds, float *scales, int threads){
+
+    quant_args args;
+
+    memset(&args, 0, sizeof(args));
+    args.halves = values;
+    args.values = thresholds;
+    args.scales = scales;
+    args.param = ratio;
+    args.n = length;
+
+    trit_parallel_for(channels, 1, threads, scales_range, &args);
+}
+
+/**
+ * @brief Quantizes every channel of a float tensor with its own
+ * threshold using threads.
+ *
+ * Channel c is written to the words from
+ * c * TRIT_ROW_WORDS(@p length), the weight layout of
+ * @c trit_gemv_float.
+ *
+ * @param[in] values @p channels rows of @p length values.
+ *
+ * @param[in] channels The number of channels.
+ *
+ * @param[in] length The number of values per channel.
+ *
+ * @param[in] thresholds The threshold of every channel.
+ *
+ * @param[out] out The trits, TRIT_ROW_WORDS(@p length) words
+ * per channel.
+ *
+ * @param[in] threads The number of threads,
+ * see @c trit_thread_count.
+ */
+void trit_quantize_channels_float(const float *values, size_t channels, size_t length,
+                                  const float *thresholds, trit32_t *out, int threads){
+
+    quant_args args;
+
+    memset(&args, 0, sizeof(args));
+    args.floats = values;
+    args.out = out;
+    args.params = thresholds;
+    args.n = length;
+    args.quantize = pick_quantize_float();
+
+    trit_parallel_for(channels, 1, threads, channels_range, &args);
+}
+
+/**
+ * @brief Quantizes every channel of a bfloat16 tensor with its
+ * own threshold using threads.
+ *
+ * @see trit_quantize_channels_float
+ *
+ * @param[in] values @p channels rows of @p length values, as
+ * the bits of bfloat16.
+ *
+ * @param[in] channels The number of channels.
+ *
+ * @param[in] length The number of values per channel.
+ *
+ * @param[in] thresholds The threshold of every channel.
+ *
+ * @param[out] out The trits, TRIT_ROW_WORDS(@p length) words
+ * per channel.
+ *
+ * @param[in] threads The number of threads,
+ * see @c trit_thread_count.
+ */
+void trit_quantize_channels_bf16(const uint16_t *values, size_t channels, size_t length,
+                                 const float *thresholds, trit32_t *out, int threads){
+
+    quant_args args;
+
+    memset(&args, 0, sizeof(args));
+    args.halves = values;
+    args.out = out;
+    args.params = thresholds;
+    args.n = length;
+    args.quantize_bf16 = pick_quantize_bf16();
+
+    trit_parallel_for(channels, 1, threads, channels_range, &args);
+}
+
+/**
+ * @brief Dequantizes every channel of a packed tensor with its
+ * own scale using threads.
+ *
+ * @see trit_quantize_channels_float
+ *
+ * @param[in] trits TRIT_ROW_WORDS(@p length) words per channel.
+ *
+ * @param[in] channels The number of channels.
+ *
+ * @param[in] length The number of trits per channel.
+ *
+ * @param[in] scales The scale of every channel.
+ *
+ * @param[out] out @p channels rows of @p length values.
+ *
+ * @param[in] threads The number of threads,
+ * see @c trit_thread_count.
+ */
+void trit_dequantize_channels_float(const trit32_t *trits, size_t channels, size_t length,
+                                    const float *scales, float *out, int threads){
+
+    quant_args args;
+
+    memset(&args, 0, sizeof(args));
+    args.trits = trits;
+    args.values = out;
+    args.params = scales;
+    args.n = length;
+    args.dequantize = pick_dequantize_float();
+
+    trit_parallel_for(channels, 1, threads, channels_range, &args);
+}
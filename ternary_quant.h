@@ -0,0 +1,42 @@
+#ifndef __ternary_quant_h__
+#define __ternary_quant_h__
+
+#include<stddef.h>
+#include<stdint.h>
+#include"ternary.h"
+
+// QUANTIZE FUNCTIONS
+void trit_quantize_float(const float *values, size_t n, float threshold, trit32_t *out, int threads);
+void trit_quantize_bf16(const uint16_t *values, size_t n, float threshold, trit32_t *out, int threads);
+void trit_dequantize_float(const trit32_t *trits, size_t n, float scale, float *out, int threads);
+
+// BATCH QUANTIZE FUNCTIONS
+void trit_quant_scales_float(const float *values, size_t channels, size_t length, float ratio,
+                             float *thresholds, float *scales, int threads);
+void trit_quant_scales_bf16(const uint16_t *values, size_t channels, size_t length, float ratio,
+                            float *thresholds, float *scales, int threads);
+void trit_quantize_channels_float(const float *values, size_t channels, size_t length,
+                                  const float *thresholds, trit32_t *out, int threads);
+void trit_quantize_channels_bf16(const uint16_t *values, size_t channels, size_t length,
+                                 const float *thresholds, trit32_t *out, int threads);
+void trit_dequantize_channels_float(const trit32_t *trits, size_t channels, size_t length,
+                                    const float *scales, float *out, int threads);
+
+// SCALAR QUANTIZE KERNELS
+void trit_quantize_scalar_float(const float *values, size_t n, float threshold, trit32_t *out);
+void trit_quantize_scalar_bf16(const uint16_t *values, size_t n, float threshold, trit32_t *out);
+void trit_dequantize_scalar_float(const trit32_t *trits, size_t n, float scale, float *out);
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+// AVX2 QUANTIZE KERNELS
+void trit_quantize_avx2_float(const float *values, size_t n, float threshold, trit32_t *out);
+void trit_quantize_avx2_bf16(const uint16_t *values, size_t n, float threshold, trit32_t *out);
+void trit_dequantize_avx2_float(const trit32_t *trits, size_t n, float scale, float *out);
+
+// AVX-512 QUANTIZE KERNELS
+void trit_quantize_avx512_float(const float *values, size_t n, float threshold, trit32_t *out);
+void trit_quantize_avx512_bf16(const uint16_t *values, size_t n, float threshold, trit32_t *out);
+void trit_dequantize_avx512_float(const trit32_t *trits, size_t n, float scale, float *out);
+#endif
+
+#endif // __ternary_quant_h__
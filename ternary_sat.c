@@ -0,0 +1,762 @@
+/**
+ * @file ternary_sat.c
+ *
+ * @brief File contains batch saturating balanced ternary arithmetic.
+ *
+ * The array functions clamp every result to the range of its
+ * width like @c trit_add_sat_trit32_t. The AVX2 kernels run the
+ * mask algebra of the scalar add on whole vectors, with one
+ * lane per value so the binary lane add is the carry chain,
+ * and select the all-(+1) or all-(-1) word from the final
+ * carry of each lane. The dispatching functions pick a kernel
+ * at run time.
+ */
+
+
+#include"ternary_sat.h"
+#include"ternary_cpu.h"
+
+#define LOW_BITS 0x5555555555555555ULL /**< The low bit of every trit */
+
+// SCALAR SATURATING KERNELS
+/**
+ * @brief Adds two arrays of @c trit8_t numbers element by element, saturating.
+ *
+ * @see trit_add_sat_trit8_t
+ *
+ * @param[in] a The first operands.
+ *
+ * @param[in] b The second operands.
+ *
+ * @param[out] out The @p count clamped results.
+ *
+ * @param[in] count The number of values.
+ */
+void trit_add_sat_scalar_trit8_t(const trit8_t *a, const trit8_t *b, trit8_t *out, size_t count){
+
+    size_t index = 0;
+
+    for(index = 0; index < count; index++){
+
+        out[index] = trit_add_sat_trit8_t(a[index], b[index]);
+    }
+}
+
+/**
+ * @brief Adds two arrays of @c trit16_t numbers element by element, saturating.
+ *
+ * @see trit_add_sat_trit16_t
+ *
+ * @param[in] a The first operands.
+ *
+ * @param[in] b The second operands.
+ *
+ * @param[out] out The @p count clamped results.
+ *
+ * @param[in] count The number of values.
+ */
+void trit_add_sat_scalar_trit16_t(const trit16_t *a, const trit16_t *b, trit16_t *out, size_t count){
+
+    size_t index = 0;
+
+    for(index = 0; index < count; index++){
+
+        out[index] = trit_add_sat_trit16_t(a[index], b[index]);
+    }
+}
+
+/**
+ * @brief Adds two arrays of @c trit32_t numbers element by element, saturating.
+ *
+ * @see trit_add_sat_trit32_t
+ *
+ * @param[in] a The first operands.
+ *
+ * @param[in] b The second operands.
+ *
+ * @param[out] out The @p count clamped results.
+ *
+ * @param[in] count The number of values.
+ */
+void trit_add_sat_scalar_trit32_t(const trit32_t *a, const trit32_t *b, trit32_t *out, size_t count){
+
+    size_t index = 0;
+
+    for(index = 0; index < count; index++){
+
+        out[index] = trit_add_sat_trit32_t(a[index], b[index]);
+    }
+}
+
+/**
+ * @brief Subtracts two arrays of @c trit8_t numbers element by element, saturating.
+ *
+ * @see trit_sub_sat_trit8_t
+ *
+ * @param[in] a The first operands.
+ *
+ * @param[in] b The second operands.
+ *
+ * @param[out] out The @p count clamped results.
+ *
+ * @param[in] count The number of values.
+ */
+void trit_sub_sat_scalar_trit8_t(const trit8_t *a, const trit8_t *b, trit8_t *out, size_t count){
+
+    size_t index = 0;
+
+    for(index = 0; index < count; index++){
+
+        out[index] = trit_sub_sat_trit8_t(a[index], b[index]);
+    }
+}
+
+/**
+ * @brief Subtracts two arrays of @c trit16_t numbers element by element, saturating.
+ *
+ * @see trit_sub_sat_trit16_t
+ *
+ * @param[in] a The first operands.
+ *
+ * @param[in] b The second operands.
+ *
+ * @param[out] out The @p count clamped results.
+ *
+ * @param[in] count The number of values.
+ */
+void trit_sub_sat_scalar_trit16_t(const trit16_t *a, const trit16_t *b, trit16_t *out, size_t count){
+
+    size_t index = 0;
+
+    for(index = 0; index < count; index++){
+
+        out[index] = trit_sub_sat_trit16_t(a[index], b[index]);
+    }
+}
+
+/**
+ * @brief Subtracts two arrays of @c trit32_t numbers element by element, saturating.
+ *
+ * @see trit_sub_sat_trit32_t
+ *
+ * @param[in] a The first operands.
+ *
+ * @param[in] b The second operands.
+ *
+ * @param[out] out The @p count clamped results.
+ *
+ * @param[in] count The number of values.
+ */
+void trit_sub_sat_scalar_trit32_t(const trit32_t *a, const trit32_t *b, trit32_t *out, size_t count){
+
+    size_t index = 0;
+
+    for(index = 0; index < count; index++){
+
+        out[index] = trit_sub_sat_trit32_t(a[index], b[index]);
+    }
+}
+
+#ifdef TERNARY_X86_64
+/**
+ * @brief Broadcasts the sign bit of every lane of @p bits bits.
+ *
+ * @param[in] x The lanes.
+ *
+ * @param[in] bits The lane width, 16, 32 or 64.
+ *
+ * @return Every lane all ones if its top bit is set, 0 otherwise
+ */
+__attribute__((target("avx2"), always_inline))
+static inline __m256i sign_lanes(__m256i x, int bits){
+
+    switch(bits){
+
+        case 16:
+            return _mm256_srai_epi16(x, 15);
+        case 32:
+            return _mm256_srai_epi32(x, 31);
+        default:
+            return _mm256_cmpgt_epi64(_mm256_setzero_si256(), x);
+    }
+}
+
+/**
+ * @brief Adds lanes of @p bits bits with the binary adder.
+ *
+ * @param[in] a The first lanes.
+ *
+ * @param[in] b The second lanes.
+ *
+ * @param[in] bits The lane width, 16, 32 or 64.
+ *
+ * @return The lane sums
+ */
+__attribute__((target("avx2"), always_inline))
+static inline __m256i add_lanes(__m256i a, __m256i b, int bits){
+
+    switch(bits){
+
+        case 16:
+            return _mm256_add_epi16(a, b);
+        case 32:
+            return _mm256_add_epi32(a, b);
+        default:
+            return _mm256_add_epi64(a, b);
+    }
+}
+
+/**
+ * @brief Finds the carry into every trit of every lane.
+ *
+ * The vector form of @c carry_chain in ternary.c, each lane is
+ * exactly one value so the lane add carries across its trits
+ * and out of the top, never into the next lane.
+ *
+ * @param[in] generate Low bit set for every trit which
+ * carries out on its own.
+ *
+ * @param[in] propagate Low bit set for every trit which
+ * carries out only if a carry comes in.
+ *
+ * @param[in] bits The lane width, 16, 32 or 64.
+ *
+ * @param[out] carry_out Every lane all ones if its top trit
+ * carries out, 0 otherwise.
+ *
+ * @return The low bit of every trit set if a carry comes in
+ */
+__attribute__((target("avx2"), always_inline))
+static inline __m256i carry_lanes(__m256i generate, __m256i propagate, int bits, __m256i *carry_out){
+
+    const __m256i low = _mm256_set1_epi64x((long long)LOW_BITS);
+    __m256i chain = _mm256_or_si256(_mm256_or_si256(generate, propagate), _mm256_slli_epi64(low, 1));
+    __m256i sum = add_lanes(chain, generate, bits);
+
+    // the top bit carries out if both inputs have it, or one has it and the sum lost it
+    *carry_out = sign_lanes(_mm256_or_si256(_mm256_and_si256(chain, generate),
+                                            _mm256_andnot_si256(sum, _mm256_or_si256(chain, generate))), bits);
+
+    return _mm256_and_si256(_mm256_xor_si256(_mm256_xor_si256(sum, chain), generate), low);
+}
+
+/**
+ * @brief Adds two vectors of balanced ternary lanes, saturating.
+ *
+ * Follows @c add_trits in ternary.c step by step. The final
+ * carry of each lane is the carry out of the first chain minus
+ * the borrow out of the second, +1 selects the all-(+1) word
+ * and -1 the all-(-1) word.
+ *
+ * @param[in] a The first lanes.
+ *
+ * @param[in] b The second lanes.
+ *
+ * @param[in] bits The lane width, 16, 32 or 64.
+ *
+ * @return The clamped lane sums
+ */
+__attribute__((target("avx2"), always_inline))
+static inline __m256i add_sat_lanes(__m256i a, __m256i b, int bits){
+
+    const __m256i low = _mm256_set1_epi64x((long long)LOW_BITS);
+    __m256i a_mag = _mm256_and_si256(a, low);
+    __m256i a_neg = _mm256_and_si256(_mm256_srli_epi64(a, 1), low);
+    __m256i b_mag = _mm256_and_si256(b, low);
+    __m256i b_neg = _mm256_and_si256(_mm256_srli_epi64(b, 1), low);
+    __m256i x0 = a_neg;
+    __m256i x1 = _mm256_andnot_si256(a_mag, low);
+    __m256i x2 = _mm256_andnot_si256(a_neg, a_mag);
+    __m256i y0 = b_neg;
+    __m256i y1 = _mm256_andnot_si256(b_mag, low);
+    __m256i y2 = _mm256_andnot_si256(b_neg, b_mag);
+    __m256i generate = _mm256_or_si256(_mm256_and_si256(x2, _mm256_or_si256(y1, y2)), _mm256_and_si256(x1, y2));
+    __m256i propagate = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(x1, y1), _mm256_and_si256(x2, y0)),
+                                        _mm256_and_si256(x0, y2));
+    __m256i rest1 = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(x1, y0), _mm256_and_si256(x0, y1)),
+                                    _mm256_and_si256(x2, y2));
+    __m256i rest0 = _mm256_andnot_si256(_mm256_or_si256(rest1, propagate), low);
+    __m256i carry_add = _mm256_setzero_si256();
+    __m256i borrow_sub = _mm256_setzero_si256();
+    __m256i carry = carry_lanes(generate, propagate, bits, &carry_add);
+    __m256i r1 = _mm256_or_si256(_mm256_andnot_si256(carry, rest1), _mm256_and_si256(rest0, carry));
+    __m256i r2 = _mm256_or_si256(_mm256_andnot_si256(carry, propagate), _mm256_and_si256(rest1, carry));
+    __m256i r0 = _mm256_andnot_si256(_mm256_or_si256(r1, r2), low);
+    __m256i borrow = carry_lanes(r0, r1, bits, &borrow_sub);
+    __m256i pos = _mm256_or_si256(_mm256_and_si256(r1, borrow), _mm256_andnot_si256(borrow, r0));
+    __m256i neg = _mm256_or_si256(_mm256_and_si256(r2, borrow), _mm256_andnot_si256(borrow, r1));
+    __m256i result = _mm256_or_si256(_mm256_or_si256(pos, neg), _mm256_slli_epi64(neg, 1));
+    __m256i over = _mm256_andnot_si256(borrow_sub, carry_add);
+    __m256i under = _mm256_andnot_si256(carry_add, borrow_sub);
+
+    result = _mm256_andnot_si256(_mm256_or_si256(over, under), result);
+
+    return _mm256_or_si256(_mm256_or_si256(result, _mm256_and_si256(over, low)), under);
+}
+
+/**
+ * @brief Negates every balanced ternary lane.
+ *
+ * @param[in] num The lanes.
+ *
+ * @return The lanes with every trit negated
+ */
+__attribute__((target("avx2"), always_inline))
+static inline __m256i not_lanes(__m256i num){
+
+    const __m256i low = _mm256_set1_epi64x((long long)LOW_BITS);
+
+    return _mm256_xor_si256(num, _mm256_slli_epi64(_mm256_and_si256(num, low), 1));
+}
+
+/**
+ * @brief Adds two arrays of @c trit8_t numbers with AVX2, saturating.
+ *
+ * Handles 16 values per vector, the tail uses the scalar
+ * function.
+ *
+ * @warning The CPU must support AVX2.
+ *
+ * @see trit_add_sat_scalar_trit8_t
+ *
+ * @param[in] a The first operands.
+ *
+ * @param[in] b The second operands.
+ *
+ * @param[out] out The @p count clamped results.
+ *
+ * @param[in] count The number of values.
+ */
+__attribute__((target("avx2")))
+void trit_add_sat_avx2_trit8_t(const trit8_t *a, const trit8_t *b, trit8_t *out, size_t count){
+
+    size_t index = 0;
+
+    for(; index + 16 <= count; index += 16){
+
+        __m256i x = _mm256_loadu_si256((const __m256i *)(a + index));
+        __m256i y = _mm256_loadu_si256((const __m256i *)(b + index));
+
+        _mm256_storeu_si256((__m256i *)(out + index), add_sat_lanes(x, y, 16));
+    }
+
+    trit_add_sat_scalar_trit8_t(a + index, b + index, out + index, count - index);
+}
+
+/**
+ * @brief Adds two arrays of @c trit16_t numbers with AVX2, saturating.
+ *
+ * Handles 8 values per vector, the tail uses the scalar
+ * function.
+ *
+ * @warning The CPU must support AVX2.
+ *
+ * @see trit_add_sat_scalar_trit16_t
+ *
+ * @param[in] a The first operands.
+ *
+ * @param[in] b The second operands.
+ *
+ * @param[out] out The @p count clamped results.
+ *
+ * @param[in] count The number of values.
+ */
+__attribute__((target("avx2")))
+void trit_add_sat_avx2_trit16_t(const trit16_t *a, const trit16_t *b, trit16_t *out, size_t count){
+
+    size_t index = 0;
+
+    for(; index + 8 <= count; index += 8){
+
+        __m256i x = _mm256_loadu_si256((const __m256i *)(a + index));
+        __m256i y = _mm256_loadu_si256((const __m256i *)(b + index));
+
+        _mm256_storeu_si256((__m256i *)(out + index), add_sat_lanes(x, y, 32));
+    }
+
+    trit_add_sat_scalar_trit16_t(a + index, b + index, out + index, count - index);
+}
+
+/**
+ * @brief Adds two arrays of @c trit32_t numbers with AVX2, saturating.
+ *
+ * Handles 4 values per vector, the tail uses the scalar
+ * function.
+ *
+ * @warning The CPU must support AVX2.
+ *
+ * @see trit_add_sat_scalar_trit32_t
+ *
+ * @param[in] a The first operands.
+ *
+ * @param[in] b The second operands.
+ *
+ * @param[out] out The @p count clamped results.
+ *
+ * @param[in] count The number of values.
+ */
+__attribute__((target("avx2")))
+void trit_add_sat_avx2_trit32_t(const trit32_t *a, const trit32_t *b, trit32_t *out, size_t count){
+
+    size_t index = 0;
+
+    for(; index + 4 <= count; index += 4){
+
+        __m256i x = _mm256_loadu_si256((const __m256i *)(a + index));
+        __m256i y = _mm256_loadu_si256((const __m256i *)(b + index));
+
+        _mm256_storeu_si256((__m256i *)(out + index), add_sat_lanes(x, y, 64));
+    }
+
+    trit_add_sat_scalar_trit32_t(a + index, b + index, out + index, count - index);
+}
+
+/**
+ * @brief Subtracts two arrays of @c trit8_t numbers with AVX2, saturating.
+ *
+ * Handles 16 values per vector, the tail uses the scalar
+ * function. The second operands are negated first, as in
+ * @c trit_sub_sat_trit8_t.
+ *
+ * @warning The CPU must support AVX2.
+ *
+ * @see trit_sub_sat_scalar_trit8_t
+ *
+ * @param[in] a The first operands.
+ *
+ * @param[in] b The second operands.
+ *
+ * @param[out] out The @p count clamped results.
+ *
+ * @param[in] count The number of values.
+ */
+__attribute__((target("avx2")))
+void trit_sub_sat_avx2_trit8_t(const trit8_t *a, const trit8_t *b, trit8_t *out, size_t count){
+
+    size_t index = 0;
+
+    for(; index + 16 <= count; index += 16){
+
+        __m256i x = _mm256_loadu_si256((const __m256i *)(a + index));
+        __m256i y = not_lanes(_mm256_loadu_si256((const __m256i *)(b + index)));
+
+        _mm256_storeu_si256((__m256i *)(out + index), add_sat_lanes(x, y, 16));
+    }
+
+    trit_sub_sat_scalar_trit8_t(a + index, b + index, out + index, count - index);
+}
+
+/**
+ * @brief Subtracts two arrays of @c trit16_t numbers with AVX2, saturating.
+ *
+ * Handles 8 values per vector, the tail uses the scalar
+ * function. The second operands are negated first, as in
+ * @c trit_sub_sat_trit16_t.
+ *
+ * @warning The CPU must support AVX2.
+ *
+ * @see trit_sub_sat_scalar_trit16_t
+ *
+ * @param[in] a The first operands.
+ *
+ * @param[in] b The second operands.
+ *
+ * @param[out] out The @p count clamped results.
+ *
+ * @param[in] count The number of values.
+ */
+__attribute__((target("avx2")))
+void trit_sub_sat_avx2_trit16_t(const trit16_t *a, const trit16_t *b, trit16_t *out, size_t count){
+
+    size_t index = 0;
+
+    for(; index + 8 <= count; index += 8){
+
+        __m256i x = _mm256_loadu_si256((const __m256i *)(a + index));
+        __m256i y = not_lanes(_mm256_loadu_si256((const __m256i *)(b + index)));
+
+        _mm256_storeu_si256((__m256i *)(out + index), add_sat_lanes(x, y, 32));
+    }
+
+    trit_sub_sat_scalar_trit16_t(a + index, b + index, out + index, count - index);
+}
+
+/**
+ * @brief Subtracts two arrays of @c trit32_t numbers with AVX2, saturating.
+ *
+ * Handles 4 values per vector, the tail uses the scalar
+ * function. The second operands are negated first, as in
+ * @c trit_sub_sat_trit32_t.
+ *
+ * @warning The CPU must support AVX2.
+ *
+ * @see trit_sub_sat_scalar_trit32_t
+ *
+ * @param[in] a The first operands.
+ *
+ * @param[in] b The second operands.
+ *
+ * @param[out] out The @p count clamped results.
+ *
+ * @param[in] count The number of values.
+ */
+__attribute__((target("avx2")))
+void trit_sub_sat_avx2_trit32_t(const trit32_t *a, const trit32_t *b, trit32_t *out, size_t count){
+
+    size_t index = 0;
+
+    for(; index + 4 <= count; index += 4){
+
+        __m256i x = _mm256_loadu_si256((const __m256i *)(a + index));
+        __m256i y = not_lanes(_mm256_loadu_si256((const __m256i *)(b + index)));
+
+        _mm256_storeu_si256((__m256i *)(out + index), add_sat_lanes(x, y, 64));
+    }
+
+    trit_sub_sat_scalar_trit32_t(a + index, b + index, out + index, count - index);
+}
+#endif
+
+// BATCH SATURATING FUNCTIONS
+/**
+ * @brief Adds two arrays of @c trit8_t numbers element by element, saturating.
+ *
+ * Picks the AVX2 or scalar kernel at run time.
+ *
+ * @see trit_add_sat_trit8_t
+ *
+ * @param[in] a The first operands.
+ *
+ * @param[in] b The second operands.
+ *
+ * @param[out] out The @p count clamped results.
+ *
+ * @param[in] count The number of values.
+ */
+void trit_add_sat_array_trit8_t(const trit8_t *a, const trit8_t *b, trit8_t *out, size_t count){
+
+#ifdef TERNARY_X86_64
+    if(trit_cpu_avx2()){
+
+        trit_add_sat_avx2_trit8_t(a, b, out, count);
+        return;
+    }
+#endif
+    trit_add_sat_scalar_trit8_t(a, b, out, count);
+}
+
+/**
+ * @brief Adds two arrays of @c trit16_t numbers element by element, saturating.
+ *
+ * Picks the AVX2 or scalar kernel at run time.
+ *
+ * @see trit_add_sat_trit16_t
+ *
+ * @param[in] a The first operands.
+ *
+ * @param[in] b The second operands.
+ *
+ * @param[out] out The @p count clamped results.
+ *
+ * @param[in] count The number of values.
+ */
+void trit_add_sat_array_trit16_t(const trit16_t *a, const trit16_t *b, trit16_t *out, size_t count){
+
+#ifdef TERNARY_X86_64
+    if(trit_cpu_avx2()){
+
+        trit_add_sat_avx2_trit16_t(a, b, out, count);
+        return;
+    }
+#endif
+    trit_add_sat_scalar_trit16_t(a, b, out, count);
+}
+
+/**
+ * @brief Adds two arrays of @c trit32_t numbers element by element, saturating.
+ *
+ * Picks the AVX2 or scalar kernel at run time.
+ *
+ * @see trit_add_sat_trit32_t
+ *
+ * @param[in] a The first operands.
+ *
+ * @param[in] b The second operands.
+ *
+ * @param[out] out The @p count clamped results.
+ *
+ * @param[in] count The number of values.
+ */
+void trit_add_sat_array_trit32_t(const trit32_t *a, const trit32_t *b, trit32_t *out, size_t count){
+
+#ifdef TERNARY_X86_64
+    if(trit_cpu_avx2()){
+
+        trit_add_sat_avx2_trit32_t(a, b, out, count);
+        return;
+    }
+#endif
+    trit_add_sat_scalar_trit32_t(a, b, out, count);
+}
+
+/**
+ * @brief Subtracts two arrays of @c trit8_t numbers element by element, saturating.
+ *
+ * Picks the AVX2 or scalar kernel at run time.
+ *
+ * @see trit_sub_sat_trit8_t
+ *
+ * @param[in] a The first operands.
+ *
+ * @param[in] b The second operands.
+ *
+ * @param[out] out The @p count clamped results.
+ *
+ * @param[in] count The number of values.
+ */
+void trit_sub_sat_array_trit8_t(const trit8_t *a, const trit8_t *b, trit8_t *out, size_t count){
+
+#ifdef TERNARY_X86_64
+    if(trit_cpu_avx2()){
+
+        trit_sub_sat_avx2_trit8_t(a, b, out, count);
+        return;
+    }
+#endif
+    trit_sub_sat_scalar_trit8_t(a, b, out, count);
+}
+
+/**
+ * @brief Subtracts two arrays of @c trit16_t numbers element by element, saturating.
+ *
+ * Picks the AVX2 or scalar kernel at run time.
+ *
+ * @see trit_sub_sat_trit16_t
+ *
+ * @param[in] a The first operands.
+ *
+ * @param[in] b The second operands.
+ *
+ * @param[out] out The @p count clamped results.
+ *
+ * @param[in] count The number of values.
+ */
+void trit_sub_sat_array_trit16_t(const trit16_t *a, const trit16_t *b, trit16_t *out, size_t count){
+
+#ifdef TERNARY_X86_64
+    if(trit_cpu_avx2()){
+
+        trit_sub_sat_avx2_trit16_t(a, b, out, count);
+        return;
+    }
+#endif
+    trit_sub_sat_scalar_trit16_t(a, b, out, count);
+}
+
+/**
+ * @brief Subtracts two arrays of @c trit32_t numbers element by element, saturating.
+ *
+ * Picks the AVX2 or scalar kernel at run time.
+ *
+ * @see trit_sub_sat_trit32_t
+ *
+ * @param[in] a The first operands.
+ *
+ * @param[in] b The second operands.
+ *
+ * @param[out] out The @p count clamped results.
+ *
+ * @param[in] count The number of values.
+ */
+void trit_sub_sat_array_trit32_t(const trit32_t *a, const trit32_t *b, trit32_t *out, size_t count){
+
+#ifdef TERNARY_X86_64
+    if(trit_cpu_avx2()){
+
+        trit_sub_sat_avx2_trit32_t(a, b, out, count);
+        return;
+    }
+#endif
+    trit_sub_sat_scalar_trit32_t(a, b, out, count);
+}
+
+/**
+ * @brief Multiplies two arrays of @c trit8_t numbers element by element, saturating.
+ *
+ * The product needs the ternary multiplier, so there is no
+ * vector kernel and every element goes through the scalar
+ * function.
+ *
+ * @see trit_mul_sat_trit8_t
+ *
+ * @param[in] a The first factors.
+ *
+ * @param[in] b The second factors.
+ *
+ * @param[out] out The @p count clamped products.
+ *
+ * @param[in] count The number of values.
+ */
+void trit_mul_sat_array_trit8_t(const trit8_t *a, const trit8_t *b, trit8_t *out, size_t count){
+
+    size_t index = 0;
+
+    for(index = 0; index < count; index++){
+
+        out[index] = trit_mul_sat_trit8_t(a[index], b[index]);
+    }
+}
+
+/**
+ * @brief Multiplies two arrays of @c trit16_t numbers element by element, saturating.
+ *
+ * The product needs the ternary multiplier, so there is no
+ * vector kernel and every element goes through the scalar
+ * function.
+ *
+ * @see trit_mul_sat_trit16_t
+ *
+ * @param[in] a The first factors.
+ *
+ * @param[in] b The second factors.
+ *
+ * @param[out] out The @p count clamped products.
+ *
+ * @param[in] count The number of values.
+ */
+void trit_mul_sat_array_trit16_t(const trit16_t *a, const trit16_t *b, trit16_t *out, size_t count){
+
+    size_t index = 0;
+
+    for(index = 0; index < count; index++){
+
+        out[index] = trit_mul_sat_trit16_t(a[index], b[index]);
+    }
+}
+
+/**
+ * @brief Multiplies two arrays of @c trit32_t numbers element by element, saturating.
+ *
+ * The product needs the ternary multiplier, so there is no
+ * vector kernel and every element goes through the scalar
+ * function.
+ *
+ * @see trit_mul_sat_trit32_t
+ *
+ * @param[in] a The first factors.
+ *
+ * @param[in] b The second factors.
+ *
+ * @param[out] out The @p count clamped products.
+ *
+ * @param[in] count The number of values.
+ */
+void trit_mul_sat_array_trit32_t(const trit32_t *a, const trit32_t *b, trit32_t *out, size_t count){
+
+    size_t index = 0;
+
+    for(index = 0; index < count; index++){
+
+        out[index] = trit_mul_sat_trit32_t(a[index], b[index]);
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef __ternary_sat_h__
+#define __ternary_sat_h__
+
+#include<stddef.h>
+#include"ternary.h"
+
+// BATCH SATURATING FUNCTIONS
+void trit_add_sat_array_trit8_t(const trit8_t *a, const trit8_t *b, trit8_t *out, size_t count);
+void trit_add_sat_array_trit16_t(const trit16_t *a, const trit16_t *b, trit16_t *out, size_t count);
+void trit_add_sat_array_trit32_t(const trit32_t *a, const trit32_t *b, trit32_t *out, size_t count);
+
+void trit_sub_sat_array_trit8_t(const trit8_t *a, const trit8_t *b, trit8_t *out, size_t count);
+void trit_sub_sat_array_trit16_t(const trit16_t *a, const trit16_t *b, trit16_t *out, size_t count);
+void trit_sub_sat_array_trit32_t(const trit32_t *a, const trit32_t *b, trit32_t *out, size_t count);
+
+void trit_mul_sat_array_trit8_t(const trit8_t *a, const trit8_t *b, trit8_t *out, size_t count);
+void trit_mul_sat_array_trit16_t(const trit16_t *a, const trit16_t *b, trit16_t *out, size_t count);
+void trit_mul_sat_array_trit32_t(const trit32_t *a, const trit32_t *b, trit32_t *out, size_t count);
+
+// SCALAR SATURATING KERNELS
+void trit_add_sat_scalar_trit8_t(const trit8_t *a, const trit8_t *b, trit8_t *out, size_t count);
+void trit_add_sat_scalar_trit16_t(const trit16_t *a, const trit16_t *b, trit16_t *out, size_t count);
+void trit_add_sat_scalar_trit32_t(const trit32_t *a, const trit32_t *b, trit32_t *out, size_t count);
+
+void trit_sub_sat_scalar_trit8_t(const trit8_t *a, const trit8_t *b, trit8_t *out, size_t count);
+void trit_sub_sat_scalar_trit16_t(const trit16_t *a, const trit16_t *b, trit16_t *out, size_t count);
+void trit_sub_sat_scalar_trit32_t(const trit32_t *a, const trit32_t *b, trit32_t *out, size_t count);
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+// AVX2 SATURATING KERNELS
+void trit_add_sat_avx2_trit8_t(const trit8_t *a, const trit8_t *b, trit8_t *out, size_t count);
+void trit_add_sat_avx2_trit16_t(const trit16_t *a, const trit16_t *b, trit16_t *out, size_t count);
+void trit_add_sat_avx2_trit32_t(const trit32_t *a, const trit32_t *b, trit32_t *out, size_t count);
+
+void trit_sub_sat_avx2_trit8_t(const trit8_t *a, const trit8_t *b, trit8_t *out, size_t count);
+void trit_sub_sat_avx2_trit16_t(const trit16_t *a, const trit16_t *b, trit16_t *out, size_t count);
+void trit_sub_sat_avx2_trit32_t(const trit32_t *a, const trit32_t *b, trit32_t *out, size_t count);
+#endif
+
+#endif // __ternary_sat_h__
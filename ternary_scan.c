@@ -0,0 +1,266 @@
+/**
+ * @file ternary_scan.c
+ *
+ * @brief File contains prefix sums over balanced ternary arrays.
+ *
+ * The array is cut into blocks of @c TRIT_SCAN_BLOCK values.
+ * The up-sweep sums every block with the carry-save
+ * accumulator, the block sums are scanned in order and the
+ * down-sweep then scans every block starting from its offset.
+ * Both sweeps run on threads, each value is added twice.
+ */
+
+
+#include<stdlib.h>
+
+#include"ternary_scan.h"
+#include"ternary_sum.h"
+#include"ternary_thread.h"
+
+#define LOW_BITS 0x5555555555555555ULL /**< Mask of the low bit of every trit in a @c trit32_t */
+
+/**
+ * @brief Arguments of one scan shared by all threads.
+ */
+typedef struct {
+    const trit32_t *values; /**< The values to scan */
+    trit32_t *out; /**< The running totals */
+    size_t count; /**< The number of values */
+    bool inclusive; /**< Whether value i is part of total i */
+    trit64_t *offsets; /**< The sum of every block, then the sum before every block */
+    bool *overflow; /**< The overflow flag of every block or NULL */
+} scan_args;
+
+/**
+ * @brief Returns the sign of a balanced ternary word.
+ *
+ * The sign is the sign of the highest non-zero trit, which
+ * is the larger of the +1 and -1 masks.
+ *
+ * @param[in] num The balanced ternary word.
+ *
+ * @return -1, 0 or 1
+ */
+static int trit_sign(trit32_t num){
+
+    uint64_t neg = (num >> 1) & LOW_BITS;
+    uint64_t pos = num & ~neg & LOW_BITS;
+
+    return (pos > neg) - (neg > pos);
+}
+
+/**
+ * @brief Returns the number of values in a block.
+ *
+ * @param[in] args The scan.
+ *
+ * @param[in] block The block.
+ *
+ * @return The length of @p block
+ */
+static size_t block_length(const scan_args *args, size_t block){
+
+    size_t first = block * TRIT_SCAN_BLOCK;
+
+    return args->count - first < TRIT_SCAN_BLOCK ? args->count - first : TRIT_SCAN_BLOCK;
+}
+
+/**
+ * @brief Up-sweep, sums the blocks [@p start, @p end).
+ *
+ * @param[in] arg The @c scan_args of the scan.
+ *
+ * @param[in] start The first block.
+ *
+ * @param[in] end One past the last block.
+ */
+static void sum_blocks(void *arg, size_t start, size_t end){
+
+    scan_args *args = (scan_args *)arg;
+    bool overflow = false;
+    size_t block = 0;
+
+    for(block = start; block < end; block++){
+
+        args->offsets[block] = trit_sum_array(args->values + block * TRIT_SCAN_BLOCK,
+                                              block_length(args, block), &overflow);
+    }
+}
+
+/**
+ * @brief Down-sweep, scans the blocks [@p start, @p end).
+ *
+ * The running total is kept as a @c trit32_t and the number
+ * of times it wrapped around 3^32, so an exact offset can be
+ * carried in and overflow is known for every value.
+ *
+ * @param[in] arg The @c scan_args of the scan.
+ *
+ * @param[in] start The first block.
+ *
+ * @param[in] end One past the last block.
+ */
+static void scan_blocks(void *arg, size_t start, size_t end){
+
+    scan_args *args = (scan_args *)arg;
+    size_t block = 0;
+    size_t index = 0;
+    size_t length = 0;
+    trit32_t total = 0;
+    trit32_t value = 0;
+    int64_t wraps = 0;
+    bool carry = false;
+    bool overflow = false;
+
+    for(block = start; block < end; block++){
+
+        total = trit_narrow_wrap_trit64_t_to_trit32_t(args->offsets[block]);
+        wraps = balanced_ternary_to_binary_int64_t((trit32_t)(args->offsets[block] >> 64));
+        length = block_length(args, block);
+        overflow = false;
+
+        for(index = block * TRIT_SCAN_BLOCK; index < block * TRIT_SCAN_BLOCK + length; index++){
+
+            value = args->values[index];
+
+            if(!args->inclusive){
+
+                args->out[index] = total;
+                overflow |= wraps != 0;
+            }
+
+            total = trit_add_checked_trit32_t(total, value, &carry);
+
+            if(carry){
+
+                wraps += trit_sign(value);
+            }
+
+            if(args->inclusive){
+
+                args->out[index] = total;
+                overflow |= wraps != 0;
+            }
+        }
+
+        if(args->overflow != NULL){
+
+            args->overflow[block] = overflow;
+        }
+    }
+}
+
+/**
+ * @brief Runs an inclusive or exclusive scan.
+ *
+ * @see trit_scan_inclusive
+ */
+static void scan(const trit32_t *values, trit32_t *out, size_t count, int threads, bool *overflow, bool inclusive){
+
+    size_t blocks = (count + TRIT_SCAN_BLOCK - 1) / TRIT_SCAN_BLOCK;
+    trit64_t total = 0;
+    trit64_t block_sum = 0;
+    bool carry = false;
+    size_t block = 0;
+    scan_args args;
+
+    if(count == 0){
+
+        return;
+    }
+
+    args.values = values;
+    args.out = out;
+    args.count = count;
+    args.inclusive = inclusive;
+    args.offsets = (trit64_t *)malloc(blocks * sizeof(trit64_t));
+    args.overflow = overflow;
+
+    if(args.offsets == NULL){
+
+        // no memory for the offsets, scan one block at a time
+        trit64_t offset = 0;
+
+        args.offsets = &offset;
+
+        for(block = 0; block < blocks; block++){
+
+            args.values = values + block * TRIT_SCAN_BLOCK;
+            args.out = out + block * TRIT_SCAN_BLOCK;
+            args.count = count - block * TRIT_SCAN_BLOCK;
+            args.overflow = overflow == NULL ? NULL : overflow + block;
+
+            block_sum = trit_sum_array(args.values, block_length(&args, 0), &carry);
+            offset = total;
+            scan_blocks(&args, 0, 1);
+            total = trit_add_checked_trit64_t(total, block_sum, &carry);
+        }
+
+        return;
+    }
+
+    trit_parallel_for(blocks, 1, threads, sum_blocks, &args);
+
+    for(block = 0; block < blocks; block++){
+
+        block_sum = args.offsets[block];
+        args.offsets[block] = total;
+        total = trit_add_checked_trit64_t(total, block_sum, &carry);
+    }
+
+    trit_parallel_for(blocks, 1, threads, scan_blocks, &args);
+
+    free(args.offsets);
+}
+
+/**
+ * @brief Inclusive prefix sum of balanced ternary values.
+ *
+ * Total i is the sum of @p values 0 to i. Totals which do
+ * not fit in 32 trits wrap around modulo 3^32 and set the
+ * overflow flag of their block.
+ *
+ * @warning This method asserts that the values are in balanced ternary.
+ *
+ * @param[in] values The values to scan.
+ *
+ * @param[out] out The @p count running totals, may be @p values.
+ *
+ * @param[in] count The number of values.
+ *
+ * @param[in] threads The number of threads,
+ * see @c trit_thread_count.
+ *
+ * @param[out] overflow One flag per block of @c TRIT_SCAN_BLOCK
+ * values, set if a total in the block did not fit. May be NULL.
+ */
+void trit_scan_inclusive(const trit32_t *values, trit32_t *out, size_t count, int threads, bool *overflow){
+
+    scan(values, out, count, threads, overflow, true);
+}
+
+/**
+ * @brief Exclusive prefix sum of balanced ternary values.
+ *
+ * Total i is the sum of @p values 0 to i - 1, so total 0
+ * is zero. Totals which do not fit in 32 trits wrap around
+ * modulo 3^32 and set the overflow flag of their block.
+ *
+ * @warning This method asserts that the values are in balanced ternary.
+ *
+ * @param[in] values The values to scan.
+ *
+ * @param[out] out The @p count running totals, may be @p values.
+ *
+ * @param[in] count The number of values.
+ *
+ * @param[in] threads The number of threads,
+ * see @c trit_thread_count.
+ *
+ * @param[out] overflow One flag per block of @c TRIT_SCAN_BLOCK
+ * values, set if a total in the block did not fit. May be NULL.
+ */
+void trit_scan_exclusive(const trit32_t *values, trit32_t *out, size_t count, int threads, bool *overflow){
+
+    scan(values, out, count, threads, overflow, false);
+}
@@ -0,0 +1,13 @@
+#ifndef __ternary_scan_h__
+#define __ternary_scan_h__
+
+#include<stddef.h>
+#include"ternary.h"
+
+#define TRIT_SCAN_BLOCK 4096 /**< Values per block of a scan, each block gets one overflow flag */
+
+// SCAN FUNCTIONS
+void trit_scan_inclusive(const trit32_t *values, trit32_t *out, size_t count, int threads, bool *overflow);
+void trit_scan_exclusive(const trit32_t *values, trit32_t *out, size_t count, int threads, bool *overflow);
+
+#endif // __ternary_scan_h__
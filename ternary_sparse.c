@@ -0,0 +1,912 @@
+/**
+ * @file ternary_sparse.c
+ *
+ * @brief File contains sparse trit vectors for mostly zero data.
+ *
+ * A sparse vector keeps the ascending positions of its +1 trits
+ * and of its -1 trits. Converting from the packed format walks
+ * the set bits of the +1 and -1 planes of every word. Dot
+ * products and element-wise functions touch only the nonzero
+ * trits: the lists of a block of positions are set in a small
+ * packed scratch block, which is read back or run through a
+ * compiled @c trit_lut2_t, instead of merging sorted lists one
+ * compare at a time.
+ *
+ * The hybrid @c trit_vector_t picks the packed or sparse form
+ * from the number of nonzero trits and calls the matching
+ * kernel, the packed ones from ternary_dot.c and
+ * ternary_metric.c.
+ */
+
+
+#include<stdlib.h>
+#include<string.h>
+
+#include"ternary_sparse.h"
+#include"ternary_dot.h"
+#include"ternary_gemm.h"
+#include"ternary_lut.h"
+#include"ternary_metric.h"
+#include"ternary_cpu.h"
+
+#define TRITS_PER_WORD 32 /**< Number of trits packed in a @c trit32_t */
+#define LOW_BITS 0x5555555555555555ULL /**< The low bit of every trit */
+#define BLOCK_WORDS 512 /**< Words of one packed scratch block, 4 KiB */
+#define BLOCK_TRITS (BLOCK_WORDS * TRITS_PER_WORD) /**< Positions covered by one scratch block */
+
+/**
+ * @brief Splits a word into the planes of its +1 and -1 trits.
+ *
+ * The unbalanced code 0b10 is in neither plane.
+ *
+ * @param[in] word The trits.
+ *
+ * @param[out] neg The low bit of every -1 trit.
+ *
+ * @return The low bit of every +1 trit
+ */
+static inline uint64_t trit_planes(trit32_t word, uint64_t *neg){
+
+    uint64_t mag = word & LOW_BITS;
+
+    *neg = (word >> 1) & mag;
+
+    return mag & ~*neg;
+}
+
+/**
+ * @brief Writes the positions of the set bits of a plane.
+ *
+ * Sparse words hold 0, 1 or 2 nonzero trits, which a loop would
+ * mispredict on, so the first two positions are always written
+ * and only counted if present, and the loop handles the rest.
+ *
+ * @param[in] plane The plane of one word, bit 2 * i for trit i.
+ *
+ * @param[in] base The position of trit 0 of the word.
+ *
+ * @param[out] out The positions, ascending, with room for 2
+ * more than are written.
+ *
+ * @return The number of positions written
+ */
+static inline size_t plane_positions(uint64_t plane, size_t base, uint32_t *out){
+
+    const uint64_t stop = 1ULL << 63;
+    size_t count = 0;
+
+    out[0] = (uint32_t)(base + (size_t)__builtin_ctzll(plane | stop) / 2);
+    count = plane != 0;
+    plane &= plane - 1;
+    out[count] = (uint32_t)(base + (size_t)__builtin_ctzll(plane | stop) / 2);
+    count += plane != 0;
+    plane &= plane - 1;
+
+    while(plane != 0){
+
+        out[count++] = (uint32_t)(base + (size_t)__builtin_ctzll(plane) / 2);
+        plane &= plane - 1;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Finds the trits of a word of a packed vector that are
+ * inside the vector.
+ *
+ * @param[in] word The word number.
+ *
+ * @param[in] n The number of trits of the vector.
+ *
+ * @return A mask of both bits of every trit before @p n
+ */
+static inline uint64_t valid_mask(size_t word, size_t n){
+
+    size_t left = n - word * TRITS_PER_WORD;
+
+    return left >= TRITS_PER_WORD ? ~0ULL : (1ULL << (2 * left)) - 1;
+}
+
+/**
+ * @brief Zeroes the words of a scratch block that were written.
+ *
+ * @param[in,out] words The BLOCK_WORDS words of the block.
+ *
+ * @param[in,out] touched One bit per word of @p words, cleared.
+ */
+static void clear_block(trit32_t *words, uint64_t *touched){
+
+    size_t group = 0;
+    uint64_t bits = 0;
+
+    for(group = 0; group < BLOCK_WORDS / 64; group++){
+
+        for(bits = touched[group]; bits != 0; bits &= bits - 1){
+
+            words[group * 64 + __builtin_ctzll(bits)] = 0;
+        }
+        touched[group] = 0;
+    }
+}
+
+/**
+ * @brief Counts the +1 and -1 trits of packed trits.
+ *
+ * @param[in] trits The packed trits.
+ *
+ * @param[in] n The number of trits, the rest of the last word is
+ * ignored.
+ *
+ * @param[out] neg_count The number of -1 trits.
+ *
+ * @return The number of +1 trits
+ */
+__attribute__((always_inline))
+static inline size_t count_words(const trit32_t *trits, size_t n, size_t *neg_count){
+
+    size_t words = (n + TRITS_PER_WORD - 1) / TRITS_PER_WORD;
+    size_t word = 0;
+    size_t pos_count = 0;
+    uint64_t pos = 0;
+    uint64_t neg = 0;
+
+    *neg_count = 0;
+    for(word = 0; word < words; word++){
+
+        pos = trit_planes(trits[word] & valid_mask(word, n), &neg);
+        pos_count += __builtin_popcountll(pos);
+        *neg_count += __builtin_popcountll(neg);
+    }
+
+    return pos_count;
+}
+
+/**
+ * @brief Portable trit count kernel.
+ */
+static size_t count_portable(const trit32_t *trits, size_t n, size_t *neg_count){
+
+    return count_words(trits, n, neg_count);
+}
+
+#ifdef TERNARY_X86_64
+/**
+ * @brief Trit count kernel using the popcnt instruction.
+ */
+__attribute__((target("popcnt")))
+static size_t count_popcnt(const trit32_t *trits, size_t n, size_t *neg_count){
+
+    return count_words(trits, n, neg_count);
+}
+#endif
+
+/**
+ * @brief Counts the +1 and -1 trits of packed trits with the
+ * best kernel for this CPU.
+ *
+ * @see count_words
+ */
+static size_t count_trits(const trit32_t *trits, size_t n, size_t *neg_count){
+
+#ifdef TERNARY_X86_64
+    if(trit_cpu_popcnt()){
+
+        return count_popcnt(trits, n, neg_count);
+    }
+#endif
+    return count_portable(trits, n, neg_count);
+}
+
+// SPARSE FUNCTIONS
+
+/**
+ * @brief Creates a sparse vector from packed trits.
+ *
+ * The trits past @p n in the last word are ignored and the
+ * unbalanced code 0b10 is read as 0.
+ *
+ * @param[out] sparse The vector, free it with
+ * @c trit_sparse_free.
+ *
+ * @param[in] trits The packed trits, @p n rounded up to whole
+ * words.
+ *
+ * @param[in] n The number of trits, at most 2^32.
+ *
+ * @return false if @p n is too large or the lists could not be
+ * allocated
+ */
+bool trit_sparse_from_packed(trit_sparse_t *sparse, const trit32_t *trits, size_t n){
+
+    size_t words = (n + TRITS_PER_WORD - 1) / TRITS_PER_WORD;
+    size_t word = 0;
+    size_t pos_count = 0;
+    size_t neg_count = 0;
+    size_t written = 0;
+    uint64_t pos = 0;
+    uint64_t neg = 0;
+
+    memset(sparse, 0, sizeof(*sparse));
+    if(n > (size_t)UINT32_MAX + 1){
+
+        return false;
+    }
+
+    pos_count = count_trits(trits, n, &neg_count);
+
+    // room for the 2 positions plane_positions may write past the end
+    sparse->indices = (uint32_t *)malloc((pos_count + neg_count + 2) * sizeof(uint32_t));
+    if(sparse->indices == NULL){
+
+        return false;
+    }
+    sparse->pos = sparse->indices;
+    sparse->neg = sparse->indices + pos_count;
+    sparse->length = n;
+
+    // the +1 positions first, the extra writes past them land where the -1 positions go next
+    for(word = 0; word < words; word++){
+
+        pos = trit_planes(trits[word] & valid_mask(word, n), &neg);
+        written += plane_positions(pos, word * TRITS_PER_WORD, sparse->pos + written);
+    }
+    sparse->pos_count = written;
+    written = 0;
+    for(word = 0; word < words; word++){
+
+        trit_planes(trits[word] & valid_mask(word, n), &neg);
+        written += plane_positions(neg, word * TRITS_PER_WORD, sparse->neg + written);
+    }
+    sparse->neg_count = written;
+
+    return true;
+}
+
+/**
+ * @brief Writes a sparse vector as packed trits.
+ *
+ * @param[in] sparse The vector.
+ *
+ * @param[out] out The packed trits, the length rounded up to
+ * whole words, the trits past the length are 0.
+ */
+void trit_sparse_to_packed(const trit_sparse_t *sparse, trit32_t *out){
+
+    size_t index = 0;
+
+    memset(out, 0, TRIT_ROW_WORDS(sparse->length) * sizeof(trit32_t));
+
+    for(index = 0; index < sparse->pos_count; index++){
+
+        out[sparse->pos[index] / TRITS_PER_WORD] |= (trit32_t)1 << (2 * (sparse->pos[index] % TRITS_PER_WORD));
+    }
+    for(index = 0; index < sparse->neg_count; index++){
+
+        out[sparse->neg[index] / TRITS_PER_WORD] |= (trit32_t)3 << (2 * (sparse->neg[index] % TRITS_PER_WORD));
+    }
+}
+
+/**
+ * @brief Frees the lists of a sparse vector.
+ *
+ * @param[in,out] sparse The vector, left empty.
+ */
+void trit_sparse_free(trit_sparse_t *sparse){
+
+    free(sparse->indices);
+    memset(sparse, 0, sizeof(*sparse));
+}
+
+/**
+ * @brief Checks if a sorted list holds a position.
+ *
+ * @param[in] list The positions, ascending.
+ *
+ * @param[in] count The number of positions.
+ *
+ * @param[in] index The position to look for.
+ *
+ * @return true if @p index is in @p list
+ */
+static bool list_contains(const uint32_t *list, size_t count, size_t index){
+
+    size_t low = 0;
+    size_t high = count;
+    size_t middle = 0;
+
+    while(low < high){
+
+        middle = low + (high - low) / 2;
+        if(list[middle] < index){
+
+            low = middle + 1;
+        }
+        else{
+
+            high = middle;
+        }
+    }
+
+    return low < count && list[low] == index;
+}
+
+/**
+ * @brief Reads one trit of a sparse vector.
+ *
+ * @param[in] sparse The vector.
+ *
+ * @param[in] index The position, below the length.
+ *
+ * @return The trit, -1, 0 or 1
+ */
+int trit_sparse_get(const trit_sparse_t *sparse, size_t index){
+
+    if(list_contains(sparse->pos, sparse->pos_count, index)){
+
+        return 1;
+    }
+
+    return list_contains(sparse->neg, sparse->neg_count, index) ? -1 : 0;
+}
+
+/**
+ * @brief Counts the nonzero trits of a sparse vector.
+ *
+ * @param[in] sparse The vector.
+ *
+ * @return The number of +1 and -1 trits
+ */
+size_t trit_sparse_count(const trit_sparse_t *sparse){
+
+    return sparse->pos_count + sparse->neg_count;
+}
+
+/**
+ * @brief Sets the trits of one block of a sparse list in a
+ * packed scratch block.
+ *
+ * @param[in] list The positions, ascending.
+ *
+ * @param[in] count The number of positions.
+ *
+ * @param[in] next The first position of the list not yet set.
+ *
+ * @param[in] start The position of trit 0 of the block.
+ *
+ * @param[in] code The code to set, 0b01 or 0b11.
+ *
+ * @param[in,out] words The BLOCK_WORDS words of the block.
+ *
+ * @param[in,out] touched One bit per word of @p words, set for
+ * the words written.
+ *
+ * @return The first position of the list past the block
+ */
+static size_t scatter_block(const uint32_t *list, size_t count, size_t next, size_t start, trit32_t code,
+                            trit32_t *words, uint64_t *touched){
+
+    size_t offset = 0;
+
+    while(next < count && list[next] < start + BLOCK_TRITS){
+
+        offset = list[next] - start;
+        words[offset / TRITS_PER_WORD] |= code << (2 * (offset % TRITS_PER_WORD));
+        touched[offset / (TRITS_PER_WORD * 64)] |= 1ULL << ((offset / TRITS_PER_WORD) % 64);
+        next++;
+    }
+
+    return next;
+}
+
+/**
+ * @brief Reads the trits of one block of a sparse list from a
+ * packed scratch block.
+ *
+ * @param[in] list The positions, ascending.
+ *
+ * @param[in] count The number of positions.
+ *
+ * @param[in,out] next The first position of the list not yet
+ * read, moved past the block.
+ *
+ * @param[in] start The position of trit 0 of the block.
+ *
+ * @param[in] words The BLOCK_WORDS words of the block.
+ *
+ * @return The sum of the trits at the positions
+ */
+static int64_t gather_block(const uint32_t *list, size_t count, size_t *next, size_t start, const trit32_t *words){
+
+    int64_t sum = 0;
+    size_t offset = 0;
+    trit32_t grab = 0;
+
+    while(*next < count && list[*next] < start + BLOCK_TRITS){
+
+        offset = list[*next] - start;
+        grab = words[offset / TRITS_PER_WORD] >> (2 * (offset % TRITS_PER_WORD));
+        sum += (int64_t)(grab & 1) - (int64_t)(grab & 2);
+        (*next)++;
+    }
+
+    return sum;
+}
+
+/**
+ * @brief Inner product of two sparse vectors of the same length.
+ *
+ * The positions are cut into blocks of BLOCK_TRITS. The trits of
+ * @p b in a block are set in a packed scratch block, the ones of
+ * @p a read from it and the written words cleared again. No step
+ * waits on the result of a compare, unlike merging the lists,
+ * so the loads of consecutive positions overlap.
+ *
+ * @see trit_similarity_array
+ *
+ * @param[in] a The first vector.
+ *
+ * @param[in] b The second vector.
+ *
+ * @return The sum of the products of the trits
+ */
+int64_t trit_sparse_dot(const trit_sparse_t *a, const trit_sparse_t *b){
+
+    trit32_t words[BLOCK_WORDS] = {0};
+    uint64_t touched[BLOCK_WORDS / 64] = {0};
+    size_t ap = 0, an = 0, bp = 0, bn = 0;
+    size_t start = 0;
+    int64_t sum = 0;
+
+    for(start = 0; start < a->length; start += BLOCK_TRITS){
+
+        bp = scatter_block(b->pos, b->pos_count, bp, start, 1, words, touched);
+        bn = scatter_block(b->neg, b->neg_count, bn, start, 3, words, touched);
+        sum += gather_block(a->pos, a->pos_count, &ap, start, words);
+        sum -= gather_block(a->neg, a->neg_count, &an, start, words);
+        clear_block(words, touched);
+    }
+
+    return sum;
+}
+
+/**
+ * @brief Inner product of a sparse vector and packed trits.
+ *
+ * Reads one trit of @p trits per nonzero trit of @p sparse.
+ *
+ * @see trit_similarity_array
+ *
+ * @param[in] sparse The sparse vector.
+ *
+ * @param[in] trits The packed trits, the length of @p sparse
+ * rounded up to whole words.
+ *
+ * @return The sum of the products of the trits
+ */
+int64_t trit_sparse_dot_packed(const trit_sparse_t *sparse, const trit32_t *trits){
+
+    int64_t sum = 0;
+    size_t index = 0;
+    trit32_t grab = 0;
+
+    // the unbalanced code 0b10 reads as 0
+    for(index = 0; index < sparse->pos_count; index++){
+
+        grab = trits[sparse->pos[index] / TRITS_PER_WORD] >> (2 * (sparse->pos[index] % TRITS_PER_WORD));
+        sum += (int64_t)(grab & 1) - (int64_t)(grab & (grab >> 1) & 1) * 2;
+    }
+    for(index = 0; index < sparse->neg_count; index++){
+
+        grab = trits[sparse->neg[index] / TRITS_PER_WORD] >> (2 * (sparse->neg[index] % TRITS_PER_WORD));
+        sum -= (int64_t)(grab & 1) - (int64_t)(grab & (grab >> 1) & 1) * 2;
+    }
+
+    return sum;
+}
+
+/**
+ * @brief Dot product of a sparse vector and float activations.
+ *
+ * The sum of the activations at the +1 positions minus the sum
+ * at the -1 positions, in 4 independent accumulators.
+ *
+ * @see trit_dot_float
+ *
+ * @param[in] sparse The sparse vector.
+ *
+ * @param[in] act The activations, one per trit.
+ *
+ * @return The dot product
+ */
+float trit_sparse_dot_float(const trit_sparse_t *sparse, const float *act){
+
+    float sums[4] = {0};
+    size_t index = 0;
+
+    for(index = 0; index + 4 <= sparse->pos_count; index += 4){
+
+        sums[0] += act[sparse->pos[index]];
+        sums[1] += act[sparse->pos[index + 1]];
+        sums[2] += act[sparse->pos[index + 2]];
+        sums[3] += act[sparse->pos[index + 3]];
+    }
+    for(; index < sparse->pos_count; index++){
+
+        sums[0] += act[sparse->pos[index]];
+    }
+
+    for(index = 0; index + 4 <= sparse->neg_count; index += 4){
+
+        sums[0] -= act[sparse->neg[index]];
+        sums[1] -= act[sparse->neg[index + 1]];
+        sums[2] -= act[sparse->neg[index + 2]];
+        sums[3] -= act[sparse->neg[index + 3]];
+    }
+    for(; index < sparse->neg_count; index++){
+
+        sums[0] -= act[sparse->neg[index]];
+    }
+
+    return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+}
+
+/**
+ * @brief Applies a trit function to every position of two
+ * sparse vectors.
+ *
+ * The table is indexed by 3 * (a + 1) + (b + 1), as in
+ * @c trit_lut2_compile. Both vectors are set in packed scratch
+ * blocks of BLOCK_TRITS and the compiled function runs on the
+ * words either of them wrote, in order, so only positions where
+ * @p a or @p b is nonzero are visited and the function must map
+ * 0 and 0 to 0. The XOR of ternary.c maps them to -1 and gives a
+ * dense result, use the packed functions for it.
+ *
+ * @param[in] a The first vector.
+ *
+ * @param[in] b The second vector, of the same length.
+ *
+ * @param[in] table The 9 results, each -1, 0 or 1.
+ *
+ * @param[out] out The result, a new vector to free with
+ * @c trit_sparse_free.
+ *
+ * @return false if the lengths differ, the table maps 0 and 0
+ * to a nonzero trit or has an entry that is not -1, 0 or 1, or
+ * the lists could not be allocated
+ */
+bool trit_sparse_map(const trit_sparse_t *a, const trit_sparse_t *b, const int8_t table[9], trit_sparse_t *out){
+
+    trit32_t a_words[BLOCK_WORDS] = {0};
+    trit32_t b_words[BLOCK_WORDS] = {0};
+    uint64_t touched[BLOCK_WORDS / 64] = {0};
+    trit_lut2_t lut;
+    size_t ap = 0, an = 0, bp = 0, bn = 0;
+    size_t capacity = trit_sparse_count(a) + trit_sparse_count(b);
+    size_t start = 0;
+    size_t word = 0;
+    size_t group = 0;
+    uint64_t bits = 0;
+    uint64_t pos = 0;
+    uint64_t neg = 0;
+    uint32_t *negs = NULL;
+
+    memset(out, 0, sizeof(*out));
+    if(a->length != b->length || table[4] != 0 || !trit_lut2_compile(&lut, table)){
+
+        return false;
+    }
+
+    // the -1 positions go to a second list that is copied behind the +1 positions at the end
+    out->indices = (uint32_t *)malloc((capacity + 2) * sizeof(uint32_t));
+    negs = (uint32_t *)malloc((capacity + 2) * sizeof(uint32_t));
+    if(out->indices == NULL || negs == NULL){
+
+        free(out->indices);
+        free(negs);
+        out->indices = NULL;
+        return false;
+    }
+    out->length = a->length;
+
+    for(start = 0; start < a->length; start += BLOCK_TRITS){
+
+        ap = scatter_block(a->pos, a->pos_count, ap, start, 1, a_words, touched);
+        an = scatter_block(a->neg, a->neg_count, an, start, 3, a_words, touched);
+        bp = scatter_block(b->pos, b->pos_count, bp, start, 1, b_words, touched);
+        bn = scatter_block(b->neg, b->neg_count, bn, start, 3, b_words, touched);
+
+        for(group = 0; group < BLOCK_WORDS / 64; group++){
+
+            for(bits = touched[group]; bits != 0; bits &= bits - 1){
+
+                word = group * 64 + __builtin_ctzll(bits);
+                pos = trit_planes(trit_lut2_trit32_t(&lut, a_words[word], b_words[word]), &neg);
+                out->pos_count += plane_positions(pos, start + word * TRITS_PER_WORD, out->indices + out->pos_count);
+                out->neg_count += plane_positions(neg, start + word * TRITS_PER_WORD, negs + out->neg_count);
+                a_words[word] = 0;
+                b_words[word] = 0;
+            }
+            touched[group] = 0;
+        }
+    }
+
+    memcpy(out->indices + out->pos_count, negs, out->neg_count * sizeof(uint32_t));
+    free(negs);
+    out->pos = out->indices;
+    out->neg = out->indices + out->pos_count;
+
+    return true;
+}
+
+/**
+ * @brief Saturating trit-wise sum of two sparse vectors.
+ *
+ * Each trit of the result is the sum of the trits of @p a and
+ * @p b clamped to -1 and 1.
+ *
+ * @see trit_sparse_map
+ *
+ * @param[in] a The first vector.
+ *
+ * @param[in] b The second vector, of the same length.
+ *
+ * @param[out] out The result, a new vector to free with
+ * @c trit_sparse_free.
+ *
+ * @return false if the lengths differ or the lists could not be
+ * allocated
+ */
+bool trit_sparse_add(const trit_sparse_t *a, const trit_sparse_t *b, trit_sparse_t *out){
+
+    static const int8_t table[9] = {-1, -1, 0, -1, 0, 1, 0, 1, 1};
+
+    return trit_sparse_map(a, b, table, out);
+}
+
+/**
+ * @brief Trit-wise product of two sparse vectors.
+ *
+ * @see trit_sparse_map
+ *
+ * @param[in] a The first vector.
+ *
+ * @param[in] b The second vector, of the same length.
+ *
+ * @param[out] out The result, a new vector to free with
+ * @c trit_sparse_free.
+ *
+ * @return false if the lengths differ or the lists could not be
+ * allocated
+ */
+bool trit_sparse_mul(const trit_sparse_t *a, const trit_sparse_t *b, trit_sparse_t *out){
+
+    static const int8_t table[9] = {1, 0, -1, 0, 0, 0, -1, 0, 1};
+
+    return trit_sparse_map(a, b, table, out);
+}
+
+/**
+ * @brief Trit-wise AND of two sparse vectors, with the meaning
+ * of @c trit_and_trit32_t.
+ *
+ * @see trit_sparse_map
+ *
+ * @param[in] a The first vector.
+ *
+ * @param[in] b The second vector, of the same length.
+ *
+ * @param[out] out The result, a new vector to free with
+ * @c trit_sparse_free.
+ *
+ * @return false if the lengths differ or the lists could not be
+ * allocated
+ */
+bool trit_sparse_and(const trit_sparse_t *a, const trit_sparse_t *b, trit_sparse_t *out){
+
+    static const int8_t table[9] = {-1, -1, -1, -1, 0, 0, -1, 0, 1};
+
+    return trit_sparse_map(a, b, table, out);
+}
+
+/**
+ * @brief Trit-wise OR of two sparse vectors, with the meaning
+ * of @c trit_or_trit32_t.
+ *
+ * @see trit_sparse_map
+ *
+ * @param[in] a The first vector.
+ *
+ * @param[in] b The second vector, of the same length.
+ *
+ * @param[out] out The result, a new vector to free with
+ * @c trit_sparse_free.
+ *
+ * @return false if the lengths differ or the lists could not be
+ * allocated
+ */
+bool trit_sparse_or(const trit_sparse_t *a, const trit_sparse_t *b, trit_sparse_t *out){
+
+    static const int8_t table[9] = {-1, -1, 1, -1, 0, 1, 1, 1, 1};
+
+    return trit_sparse_map(a, b, table, out);
+}
+
+/**
+ * @brief Negates a sparse vector in place by swapping its lists.
+ *
+ * @param[in,out] sparse The vector.
+ */
+void trit_sparse_not(trit_sparse_t *sparse){
+
+    uint32_t *list = sparse->pos;
+    size_t count = sparse->pos_count;
+
+    sparse->pos = sparse->neg;
+    sparse->pos_count = sparse->neg_count;
+    sparse->neg = list;
+    sparse->neg_count = count;
+}
+
+// HYBRID VECTOR FUNCTIONS
+
+/**
+ * @brief Decides if a vector should be stored sparse.
+ *
+ * A position takes 32 bits against 2 bits per trit packed, so
+ * at 1 nonzero trit in TRIT_SPARSE_DENSITY both forms take the
+ * same memory. The float dot product of a sparse vector is
+ * faster up to about that density too. The trit dot product
+ * wins only below about 1% and the element-wise functions
+ * below about 0.1%, as the packed ones handle 32 trits per
+ * word operation, see bench_sparse.
+ *
+ * @param[in] nonzeros The number of nonzero trits.
+ *
+ * @param[in] length The number of trits.
+ *
+ * @return true if the sparse form is smaller
+ */
+bool trit_sparse_prefer(size_t nonzeros, size_t length){
+
+    return nonzeros <= length / TRIT_SPARSE_DENSITY;
+}
+
+/**
+ * @brief Creates a vector from packed trits in the form that
+ * suits its density.
+ *
+ * @see trit_sparse_prefer
+ *
+ * @param[out] vector The vector, free it with
+ * @c trit_vector_free.
+ *
+ * @param[in] trits The packed trits, @p n rounded up to whole
+ * words.
+ *
+ * @param[in] n The number of trits, at most 2^32.
+ *
+ * @return false if @p n is too large or the vector could not be
+ * allocated
+ */
+bool trit_vector_from_packed(trit_vector_t *vector, const trit32_t *trits, size_t n){
+
+    size_t words = TRIT_ROW_WORDS(n);
+    size_t word = 0;
+    size_t nonzeros = 0;
+    size_t neg_count = 0;
+
+    memset(vector, 0, sizeof(*vector));
+    if(n > (size_t)UINT32_MAX + 1){
+
+        return false;
+    }
+
+    nonzeros = count_trits(trits, n, &neg_count);
+    nonzeros += neg_count;
+
+    vector->length = n;
+    vector->is_sparse = trit_sparse_prefer(nonzeros, n);
+    if(vector->is_sparse){
+
+        return trit_sparse_from_packed(&vector->sparse, trits, n);
+    }
+
+    vector->dense = (trit32_t *)malloc((words + 1) * sizeof(trit32_t));
+    if(vector->dense == NULL){
+
+        return false;
+    }
+    for(word = 0; word < words; word++){
+
+        vector->dense[word] = trits[word] & valid_mask(word, n);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Writes a vector as packed trits.
+ *
+ * @param[in] vector The vector.
+ *
+ * @param[out] out The packed trits, the length rounded up to
+ * whole words.
+ */
+void trit_vector_to_packed(const trit_vector_t *vector, trit32_t *out){
+
+    if(vector->is_sparse){
+
+        trit_sparse_to_packed(&vector->sparse, out);
+    }
+    else{
+
+        memcpy(out, vector->dense, TRIT_ROW_WORDS(vector->length) * sizeof(trit32_t));
+    }
+}
+
+/**
+ * @brief Frees a vector.
+ *
+ * @param[in,out] vector The vector, left empty.
+ */
+void trit_vector_free(trit_vector_t *vector){
+
+    trit_sparse_free(&vector->sparse);
+    free(vector->dense);
+    memset(vector, 0, sizeof(*vector));
+}
+
+/**
+ * @brief Inner product of two vectors of the same length.
+ *
+ * Two sparse vectors use @c trit_sparse_dot, a sparse and a packed
+ * vector read the packed one at the nonzero positions and two
+ * packed vectors use @c trit_similarity_array.
+ *
+ * @param[in] a The first vector.
+ *
+ * @param[in] b The second vector.
+ *
+ * @return The sum of the products of the trits
+ */
+int64_t trit_vector_dot(const trit_vector_t *a, const trit_vector_t *b){
+
+    if(a->is_sparse && b->is_sparse){
+
+        return trit_sparse_dot(&a->sparse, &b->sparse);
+    }
+    if(a->is_sparse){
+
+        return trit_sparse_dot_packed(&a->sparse, b->dense);
+    }
+    if(b->is_sparse){
+
+        return trit_sparse_dot_packed(&b->sparse, a->dense);
+    }
+
+    return trit_similarity_array(a->dense, b->dense, TRIT_ROW_WORDS(a->length));
+}
+
+/**
+ * @brief Dot product of a vector and float activations.
+ *
+ * @see trit_sparse_dot_float
+ * @see trit_dot_float
+ *
+ * @param[in] vector The vector.
+ *
+ * @param[in] act The activations, one per trit.
+ *
+ * @return The dot product
+ */
+float trit_vector_dot_float(const trit_vector_t *vector, const float *act){
+
+    if(vector->is_sparse){
+
+        return trit_sparse_dot_float(&vector->sparse, act);
+    }
+
+    return trit_dot_float(vector->dense, act, vector->length);
+}
@@ -0,0 +1,67 @@
+#ifndef __ternary_sparse_h__
+#define __ternary_sparse_h__
+
+#include<stddef.h>
+#include<stdint.h>
+#include"ternary.h"
+
+#define TRIT_SPARSE_DENSITY 16 /**< A vector is stored sparse if at most 1 trit in this many is nonzero */
+
+/**
+ * @brief A trit vector stored as the positions of its nonzero
+ * trits.
+ *
+ * The positions of the +1 trits and of the -1 trits are kept in
+ * two ascending lists, both in one allocation, so a vector of
+ * @c length trits with k nonzero trits takes 32 k bits instead
+ * of 2 @c length.
+ */
+typedef struct{
+
+    uint32_t *indices; /**< The allocation holding both lists */
+    uint32_t *pos;     /**< The positions of the +1 trits, ascending */
+    uint32_t *neg;     /**< The positions of the -1 trits, ascending */
+    size_t pos_count;  /**< The number of +1 trits */
+    size_t neg_count;  /**< The number of -1 trits */
+    size_t length;     /**< The number of trits, zeros included */
+} trit_sparse_t;
+
+/**
+ * @brief A trit vector stored packed or sparse, whichever suits
+ * its density.
+ */
+typedef struct{
+
+    trit_sparse_t sparse; /**< The vector if @c is_sparse */
+    trit32_t *dense;      /**< The packed vector if not @c is_sparse */
+    size_t length;        /**< The number of trits */
+    bool is_sparse;       /**< Which form is used */
+} trit_vector_t;
+
+// SPARSE FUNCTIONS
+bool trit_sparse_from_packed(trit_sparse_t *sparse, const trit32_t *trits, size_t n);
+void trit_sparse_to_packed(const trit_sparse_t *sparse, trit32_t *out);
+void trit_sparse_free(trit_sparse_t *sparse);
+int trit_sparse_get(const trit_sparse_t *sparse, size_t index);
+size_t trit_sparse_count(const trit_sparse_t *sparse);
+
+int64_t trit_sparse_dot(const trit_sparse_t *a, const trit_sparse_t *b);
+int64_t trit_sparse_dot_packed(const trit_sparse_t *sparse, const trit32_t *trits);
+float trit_sparse_dot_float(const trit_sparse_t *sparse, const float *act);
+
+bool trit_sparse_map(const trit_sparse_t *a, const trit_sparse_t *b, const int8_t table[9], trit_sparse_t *out);
+bool trit_sparse_add(const trit_sparse_t *a, const trit_sparse_t *b, trit_sparse_t *out);
+bool trit_sparse_mul(const trit_sparse_t *a, const trit_sparse_t *b, trit_sparse_t *out);
+bool trit_sparse_and(const trit_sparse_t *a, const trit_sparse_t *b, trit_sparse_t *out);
+bool trit_sparse_or(const trit_sparse_t *a, const trit_sparse_t *b, trit_sparse_t *out);
+void trit_sparse_not(trit_sparse_t *sparse);
+
+// HYBRID VECTOR FUNCTIONS
+bool trit_sparse_prefer(size_t nonzeros, size_t length);
+bool trit_vector_from_packed(trit_vector_t *vector, const trit32_t *trits, size_t n);
+void trit_vector_to_packed(const trit_vector_t *vector, trit32_t *out);
+void trit_vector_free(trit_vector_t *vector);
+int64_t trit_vector_dot(const trit_vector_t *a, const trit_vector_t *b);
+float trit_vector_dot_float(const trit_vector_t *vector, const float *act);
+
+#endif // __ternary_sparse_h__
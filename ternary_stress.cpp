@@ -0,0 +1,465 @@
+#include "ternary.h"
+#include "ternary_circuit.h"
+#include "ternary_codec.h"
+#include "ternary_dot.h"
+#include "ternary_fixed.h"
+#include "ternary_float.h"
+#include "ternary_gemm.h"
+#include "ternary_hash.h"
+#include "ternary_kleene.h"
+#include "ternary_lut.h"
+#include "ternary_metric.h"
+#include "ternary_mod.h"
+#include "ternary_quant.h"
+#include "ternary_sat.h"
+#include "ternary_sparse.h"
+#include "ternary_scan.h"
+#include "ternary_sum.h"
+#include "ternary_tcam.h"
+#include "ternary_vm.h"
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+// Calls every library function from many threads at once. Each thread
+// folds all results into a checksum which has to match the checksum of
+// a single threaded run. Build with -fsanitize=thread (make test_tsan)
+// so ThreadSanitizer also reports any shared state the functions touch.
+
+#define THREADS 16
+#define ROUNDS 2000
+
+static uint64_t mix(uint64_t hash, uint64_t value){
+
+  return (hash ^ value) * 0x100000001B3ULL;
+}
+
+// xorshift so every thread sees the same inputs without shared state
+static uint64_t next_input(uint64_t *state){
+
+  *state ^= *state << 13;
+  *state ^= *state >> 7;
+  *state ^= *state << 17;
+
+  return *state;
+}
+
+static uint64_t run_round(uint64_t *state){
+
+  uint64_t hash = 0xCBF29CE484222325ULL;
+  uint64_t input = next_input(state);
+  bool overflow = false;
+
+  uint16_t num8 = (uint16_t)(input % 3281);
+  uint32_t num16 = (uint32_t)(input % 21523361);
+  uint32_t num32 = (uint32_t)input;
+
+  trit8_t a8 = binary_to_balanced_ternary_trit8_t(num8);
+  trit8_t b8 = binary_to_balanced_ternary_trit8_t((uint16_t)((input >> 32) % 3281));
+  trit16_t a16 = binary_to_balanced_ternary_trit16_t(num16);
+  trit16_t b16 = binary_to_balanced_ternary_trit16_t((uint32_t)((input >> 20) % 21523361));
+  trit32_t a32 = binary_to_balanced_ternary_trit32_t(num32);
+  trit32_t b32 = binary_to_balanced_ternary_trit32_t((uint32_t)(input >> 32));
+
+  hash = mix(hash, binary_to_unbalanced_ternary_trit8_t((uint16_t)(input % 6561)));
+  hash = mix(hash, binary_to_unbalanced_ternary_trit16_t((uint32_t)(input % 43046721)));
+  hash = mix(hash, binary_to_unbalanced_ternary_trit32_t(num32));
+  hash = mix(hash, unbalanced_ternary_to_balanced_ternary_trit8_t(binary_to_unbalanced_ternary_trit8_t(num8)));
+  hash = mix(hash, unbalanced_ternary_to_balanced_ternary_trit16_t(binary_to_unbalanced_ternary_trit16_t(num16)));
+  hash = mix(hash, unbalanced_ternary_to_balanced_ternary_trit32_t(binary_to_unbalanced_ternary_trit32_t(num32)));
+  hash = mix(hash, unbalanced_ternary_to_binary_uint16_t(balanced_ternary_to_unbalanced_ternary_trit8_t(a8)));
+  hash = mix(hash, unbalanced_ternary_to_binary_uint32_t(balanced_ternary_to_unbalanced_ternary_trit16_t(a16)));
+  hash = mix(hash, unbalanced_ternary_to_binary_uint64_t(balanced_ternary_to_unbalanced_ternary_trit32_t(a32)));
+  hash = mix(hash, balanced_ternary_to_binary_int16_t(a8));
+  hash = mix(hash, balanced_ternary_to_binary_int32_t(a16));
+  hash = mix(hash, balanced_ternary_to_binary_int64_t(a32));
+
+  hash = mix(hash, trit_add_trit8_t(a8, b8));
+  hash = mix(hash, trit_add_trit16_t(a16, b16));
+  hash = mix(hash, trit_add_trit32_t(a32, b32));
+  hash = mix(hash, trit_add_checked_trit8_t(a8, b8, &overflow));
+  hash = mix(hash, overflow);
+  hash = mix(hash, trit_add_checked_trit16_t(a16, b16, &overflow));
+  hash = mix(hash, overflow);
+  hash = mix(hash, trit_add_checked_trit32_t(a32, b32, &overflow));
+  hash = mix(hash, overflow);
+  hash = mix(hash, trit_sub_trit8_t(a8, b8));
+  hash = mix(hash, trit_sub_trit16_t(a16, b16));
+  hash = mix(hash, trit_sub_trit32_t(a32, b32));
+  hash = mix(hash, trit_sub_checked_trit8_t(a8, b8, &overflow));
+  hash = mix(hash, overflow);
+  hash = mix(hash, trit_sub_checked_trit16_t(a16, b16, &overflow));
+  hash = mix(hash, overflow);
+  hash = mix(hash, trit_sub_checked_trit32_t(a32, b32, &overflow));
+  hash = mix(hash, overflow);
+
+  hash = mix(hash, trit_or_trit8_t(a8, b8));
+  hash = mix(hash, trit_or_trit16_t(a16, b16));
+  hash = mix(hash, trit_or_trit32_t(a32, b32));
+  hash = mix(hash, trit_xor_trit8_t(a8, b8));
+  hash = mix(hash, trit_xor_trit16_t(a16, b16));
+  hash = mix(hash, trit_xor_trit32_t(a32, b32));
+  hash = mix(hash, trit_and_trit8_t(a8, b8));
+  hash = mix(hash, trit_and_trit16_t(a16, b16));
+  hash = mix(hash, trit_and_trit32_t(a32, b32));
+  hash = mix(hash, trit_sl_trit8_t(a8, input % 9));
+  hash = mix(hash, trit_sl_trit16_t(a16, input % 17));
+  hash = mix(hash, trit_sl_trit32_t(a32, input % 33));
+  hash = mix(hash, trit_sr_trit8_t(a8, input % 9));
+  hash = mix(hash, trit_sr_trit16_t(a16, input % 17));
+  hash = mix(hash, trit_sr_trit32_t(a32, input % 33));
+  hash = mix(hash, trit_not_trit8_t(a8));
+  hash = mix(hash, trit_not_trit16_t(a16));
+  hash = mix(hash, trit_not_trit32_t(a32));
+
+  hash = mix(hash, trit_widen_trit8_t_to_trit16_t(a8));
+  hash = mix(hash, trit_widen_trit8_t_to_trit32_t(a8));
+  hash = mix(hash, trit_widen_trit16_t_to_trit32_t(a16));
+  hash = mix(hash, trit_narrow_checked_trit16_t_to_trit8_t(a16, &overflow));
+  hash = mix(hash, overflow);
+  hash = mix(hash, trit_narrow_checked_trit32_t_to_trit8_t(a32, &overflow));
+  hash = mix(hash, overflow);
+  hash = mix(hash, trit_narrow_checked_trit32_t_to_trit16_t(a32, &overflow));
+  hash = mix(hash, overflow);
+  hash = mix(hash, trit_narrow_wrap_trit16_t_to_trit8_t(a16));
+  hash = mix(hash, trit_narrow_wrap_trit32_t_to_trit8_t(a32));
+  hash = mix(hash, trit_narrow_wrap_trit32_t_to_trit16_t(a32));
+
+  trit64_t a64 = binary_to_balanced_ternary_trit64_t((__int128)(int64_t)input * ((__int128)1 << 36) + num32);
+  trit64_t b64 = binary_to_balanced_ternary_trit64_t(-((__int128)num16 << 64));
+  trit128_t a128 = binary_to_balanced_ternary_trit128_t((__int128)input << 60);
+  trit128_t b128 = trit_widen_trit64_t_to_trit128_t(b64);
+  trit128_t c128 = trit_add_checked_trit128_t(a128, b128, &overflow);
+  __uint128_t mag128 = 0, sign128 = 0;
+  uint64_t mag64 = 0, sign64 = 0;
+
+  hash = mix(hash, (uint64_t)(balanced_ternary_to_binary_int128_t(trit_add_trit64_t(a64, b64)) >> 8));
+  hash = mix(hash, (uint64_t)balanced_ternary_to_binary_int128_t(trit_sub_trit64_t(a64, b64)));
+  hash = mix(hash, (uint64_t)(trit_or_trit64_t(a64, b64) ^ trit_xor_trit64_t(a64, b64) ^ trit_and_trit64_t(a64, b64)));
+  hash = mix(hash, (uint64_t)(trit_sl_trit64_t(a64, input % 65) >> 64));
+  hash = mix(hash, (uint64_t)trit_sr_trit64_t(a64, input % 65));
+  hash = mix(hash, trit_count_trit64_t(a64, 1) + trit_hamming_trit64_t(a64, b64));
+  hash = mix(hash, (uint64_t)trit_similarity_trit64_t(a64, b64));
+  trit_unpack_trit64_t(a64, &mag64, &sign64);
+  hash = mix(hash, (uint64_t)trit_pack_trit64_t(mag64, sign64));
+  hash = mix(hash, (uint64_t)unbalanced_ternary_to_binary_uint128_t(balanced_ternary_to_unbalanced_ternary_trit64_t(trit_not_trit64_t(b64))));
+  hash = mix(hash, (uint64_t)unbalanced_ternary_to_balanced_ternary_trit64_t(binary_to_unbalanced_ternary_trit64_t((__uint128_t)input << 30)));
+  hash = mix(hash, (uint64_t)trit_narrow_wrap_trit64_t_to_trit32_t(a64));
+  hash = mix(hash, (uint64_t)balanced_ternary_to_binary_checked_int128_t(c128, &overflow));
+  hash = mix(hash, overflow);
+  hash = mix(hash, (uint64_t)trit_sub_trit128_t(a128, b128).high);
+  hash = mix(hash, (uint64_t)trit_or_trit128_t(a128, b128).low ^ (uint64_t)trit_xor_trit128_t(a128, b128).low);
+  hash = mix(hash, (uint64_t)trit_and_trit128_t(a128, b128).high);
+  hash = mix(hash, (uint64_t)trit_sl_trit128_t(a128, input % 129).high);
+  hash = mix(hash, (uint64_t)trit_sr_trit128_t(a128, input % 129).low);
+  hash = mix(hash, trit_count_trit128_t(a128, -1) + trit_hamming_trit128_t(a128, b128));
+  hash = mix(hash, (uint64_t)trit_similarity_trit128_t(a128, c128));
+  trit_unpack_trit128_t(c128, &mag128, &sign128);
+  hash = mix(hash, (uint64_t)trit_pack_trit128_t(mag128, sign128).high);
+  hash = mix(hash, (uint64_t)unbalanced_ternary_to_binary_checked_uint128_t(balanced_ternary_to_unbalanced_ternary_trit128_t(a128), &overflow));
+  hash = mix(hash, (uint64_t)unbalanced_ternary_to_balanced_ternary_trit128_t(binary_to_unbalanced_ternary_trit128_t((__uint128_t)input << 64)).high);
+  hash = mix(hash, (uint64_t)trit_narrow_checked_trit128_t_to_trit64_t(trit_not_trit128_t(c128), &overflow));
+  hash = mix(hash, overflow);
+
+  trit8_t narrow8[3] = {a8, b8, trit_not_trit8_t(a8)};
+  trit16_t narrow16[3] = {a16, b16, trit_not_trit16_t(a16)};
+  trit32_t packed[2];
+  trit_repack_trit8_t_to_trit32_t(narrow8, 3, packed);
+  hash = mix(hash, packed[0]);
+  trit_repack_trit32_t_to_trit8_t(packed, 3, narrow8);
+  hash = mix(hash, narrow8[2]);
+  trit_repack_trit16_t_to_trit32_t(narrow16, 3, packed);
+  hash = mix(hash, packed[0] ^ packed[1]);
+  trit_repack_trit32_t_to_trit16_t(packed, 3, narrow16);
+  hash = mix(hash, narrow16[2]);
+
+  uint8_t mag8 = 0, sign8 = 0;
+  uint16_t mag16 = 0, sign16 = 0;
+  uint32_t mag32 = 0, sign32 = 0;
+  trit_unpack_trit8_t(a8, &mag8, &sign8);
+  trit_unpack_trit16_t(a16, &mag16, &sign16);
+  trit_unpack_trit32_t(a32, &mag32, &sign32);
+  hash = mix(hash, trit_pack_trit8_t(mag8, sign8));
+  hash = mix(hash, trit_pack_trit16_t(mag16, sign16));
+  hash = mix(hash, trit_pack_trit32_t(mag32, sign32));
+
+  for(int8_t digit = -1; digit <= 1; digit++){
+
+    hash = mix(hash, trit_count_trit8_t(a8, digit));
+    hash = mix(hash, trit_count_trit16_t(a16, digit));
+    hash = mix(hash, trit_count_trit32_t(a32, digit));
+  }
+  hash = mix(hash, trit_hamming_trit8_t(a8, b8));
+  hash = mix(hash, trit_hamming_trit16_t(a16, b16));
+  hash = mix(hash, trit_hamming_trit32_t(a32, b32));
+  hash = mix(hash, (uint64_t)trit_similarity_trit8_t(a8, b8));
+  hash = mix(hash, (uint64_t)trit_similarity_trit16_t(a16, b16));
+  hash = mix(hash, (uint64_t)trit_similarity_trit32_t(a32, b32));
+
+  trit32_t words[4] = {a32, b32, trit_not_trit32_t(a32), trit_not_trit32_t(b32)};
+  int8_t act8[128];
+  int16_t act16[128];
+  float actf[128];
+  float y[4];
+  uint32_t distances[4];
+  int32_t similarities[4];
+
+  for(int index = 0; index < 128; index++){
+
+    act8[index] = (int8_t)(input >> (index % 56));
+    act16[index] = (int16_t)(input >> (index % 48));
+    actf[index] = (float)(int8_t)(input >> (index % 56));
+  }
+
+  hash = mix(hash, (uint64_t)trit_dot_int8_t(words, act8, 128));
+  hash = mix(hash, (uint64_t)trit_dot_int16_t(words, act16, 128));
+  hash = mix(hash, (uint64_t)trit_dot_float(words, actf, 128));
+  trit_gemv_float(words, 4, 32, actf, y, 1);
+  hash = mix(hash, (uint64_t)(y[0] + y[1] + y[2] + y[3]));
+  hash = mix(hash, trit_hamming_array(words, words + 2, 2));
+  hash = mix(hash, (uint64_t)trit_similarity_array(words, words + 2, 2));
+  trit_hamming_batch(words, words, 4, 1, distances, 1);
+  trit_similarity_batch(words, words, 4, 1, similarities, 1);
+  hash = mix(hash, distances[0] + distances[1] + distances[2] + distances[3]);
+  hash = mix(hash, (uint64_t)(similarities[0] + similarities[1] + similarities[2] + similarities[3]));
+  hash = mix(hash, trit_hamming_nearest(words, words + 1, 3, 1, NULL, 2));
+
+  trit_sum_t sum;
+  trit_sum_t other;
+  trit_sum_init(&sum);
+  trit_sum_init(&other);
+  for(int index = 0; index < 4; index++){
+
+    trit_sum_add(&sum, words[index]);
+    trit_sum_add(&other, words[3 - index]);
+  }
+  trit_sum_merge(&sum, &other);
+  hash = mix(hash, trit_sum_read_trit32_t(&sum, &overflow));
+  hash = mix(hash, overflow);
+  hash = mix(hash, (uint64_t)trit_sum_read_trit64_t(&sum, &overflow));
+  hash = mix(hash, (uint64_t)trit_sum_array(words, 4, &overflow));
+  hash = mix(hash, (uint64_t)trit_sum_reduce(words, 4, 1, &overflow));
+
+  trit32_t totals[4];
+  trit_scan_inclusive(words, totals, 4, 1, &overflow);
+  hash = mix(hash, totals[3] ^ overflow);
+  trit_scan_exclusive(words, totals, 4, 1, &overflow);
+  hash = mix(hash, totals[3] ^ overflow);
+
+  hash = mix(hash, trit_mul_trit8_t(a8, b8));
+  hash = mix(hash, trit_mul_trit16_t(a16, b16));
+  hash = mix(hash, trit_mul_checked_trit32_t(a32, b32, &overflow));
+  hash = mix(hash, overflow);
+  hash = mix(hash, (uint64_t)(trit_mul_wide_trit32_t(a32, b32) >> 64));
+
+  double reals[4];
+  trit_fix_to_double_array(words, reals, 4, 20);
+  trit_fix_from_double_array(reals, totals, 4, 20, &overflow);
+  hash = mix(hash, totals[0] ^ totals[3] ^ overflow);
+  trit_fix_mul_array(words, totals, totals, 4, 20, &overflow);
+  hash = mix(hash, totals[1] ^ overflow);
+  hash = mix(hash, trit_fix_div(a32, b32, 10, &overflow));
+  hash = mix(hash, trit_fix_rescale(a32, 10, 12, &overflow) ^ overflow);
+
+  trit_float_t floats[4];
+  trit_float_t results[4];
+  int status = 0;
+  trit_float_from_double_array(reals, floats, 4, 1, &status);
+  hash = mix(hash, status);
+  trit_float_mul_array(floats, floats + 1, results, 3, 1, &status);
+  hash = mix(hash, results[0].significand ^ results[2].exponent ^ status);
+  trit_float_add_array(floats, floats + 1, results, 3, 1, &status);
+  hash = mix(hash, results[1].significand ^ results[1].exponent ^ status);
+  trit_float_div_array(floats, floats + 1, results, 3, 1, &status);
+  hash = mix(hash, results[2].significand ^ status);
+  hash = mix(hash, trit_float_sqrt_checked(trit_float_mul_checked(floats[0], floats[0], &status), &status).significand ^ status);
+  trit_float_to_double_array(results, reals, 3, 1);
+  uint64_t bits = 0;
+  memcpy(&bits, &reals[0], sizeof(bits));
+  hash = mix(hash, bits);
+
+  uint64_t modulus = (input >> 32) * 3 + 1;
+  trit32_t m32 = binary_to_balanced_ternary_trit32_t(modulus);
+  trit32_t r32 = binary_to_balanced_ternary_trit32_t(num32 % modulus);
+  hash = mix(hash, trit_addmod_trit32_t(r32, r32, m32));
+  hash = mix(hash, trit_mulmod_trit32_t(r32, r32, m32));
+  hash = mix(hash, trit_powmod_trit32_t(r32, b32, m32));
+  hash = mix(hash, (uint64_t)trit_powmod_trit64_t(r32, b32, m32));
+
+  hash = mix(hash, trit_add_sat_trit8_t(a8, b8) ^ trit_mul_sat_trit8_t(a8, b8));
+  hash = mix(hash, trit_sub_sat_trit16_t(a16, b16) ^ trit_mul_sat_trit16_t(a16, b16));
+  hash = mix(hash, trit_mul_sat_trit32_t(a32, b32));
+  trit_add_sat_array_trit32_t(words, totals, totals, 4);
+  hash = mix(hash, totals[0] ^ totals[3]);
+  trit_sub_sat_array_trit32_t(totals, words, totals, 4);
+  hash = mix(hash, totals[1] ^ totals[2]);
+
+  int carry = 0;
+  hash = mix(hash, trit_adc_trit8_t(a8, b8, 1, &carry) + carry);
+  hash = mix(hash, trit_sbb_trit16_t(a16, b16, -1, &carry) + carry);
+  hash = mix(hash, trit_adc_trit32_t(a32, b32, carry, &carry) + carry);
+  hash = mix(hash, (uint64_t)trit_sbb_trit64_t(a64, b64, carry, &carry) + carry);
+
+  int8_t table[9];
+  for(int index = 0; index < 9; index++){
+
+    table[index] = (int8_t)((input >> (2 * index)) % 3) - 1;
+  }
+  trit_lut2_t lut;
+  trit_lut2_compile(&lut, table);
+  hash = mix(hash, trit_lut2_trit32_t(&lut, a32, b32));
+  trit_lut2_array(&lut, words, totals, totals, 4);
+  hash = mix(hash, totals[0] ^ totals[3]);
+
+  const trit32_t *columns[2] = {words, totals};
+  trit_kleene_node_t nodes[4] = {{TRIT_KLEENE_COLUMN, 0, 0}, {TRIT_KLEENE_COLUMN, 1, 0},
+                                 {TRIT_KLEENE_NOT, 1, 0}, {TRIT_KLEENE_OR, 0, 2}};
+  uint64_t selection[2];
+  hash = mix(hash, trit_kleene_eval(nodes, 3, columns, 4 * 32 - (input % 32), totals, selection));
+  hash = mix(hash, selection[0] ^ selection[1] ^ totals[2]);
+
+  trit_tcam_t tcam;
+  size_t rule = 0;
+  if(trit_tcam_init(&tcam, 64, 4)){
+
+    for(int index = 0; index < 4; index++){
+
+      trit_tcam_insert_trit32_t(&tcam, words[index], index);
+    }
+    trit_tcam_insert_trit64_t(&tcam, a64, 4);
+    hash = mix(hash, trit_tcam_lookup(&tcam, input, &rule) ? rule : 7);
+    trit_tcam_free(&tcam);
+  }
+
+  trit_gate_t gates[3] = {{TRIT_GATE_XOR, 0, 1, 2}, {TRIT_GATE_NOT, 2, 0, 3}, {TRIT_GATE_AND, 3, 0, 4}};
+  uint32_t circuit_inputs[2] = {0, 1};
+  uint32_t circuit_outputs[1] = {4};
+  trit_slice_t slices[2] = {{words[0] & ~words[1], words[1] & ~words[0]}, {a32 & ~b32, b32 & ~a32}};
+  trit_slice_t result[1];
+  uint64_t toggles[5];
+  trit_circuit_t circuit;
+  if(trit_circuit_compile(&circuit, gates, 3, 5, circuit_inputs, 2, circuit_outputs, 1)){
+
+    trit_circuit_fault(&circuit, 3, 1, input);
+    if(trit_circuit_eval(&circuit, slices, result, 1, toggles, 1)){
+
+      hash = mix(hash, result[0].pos ^ result[0].neg ^ toggles[4]);
+    }
+    trit_circuit_free(&circuit);
+  }
+
+  trit_vm_t vm;
+  if(trit_vm_init(&vm, 64)){
+
+    trit32_t code[4] = {trit_vm_encode(TRIT_VM_XOR, 2, 0, 1, 0), trit_vm_encode(TRIT_VM_MUL, 3, 2, 0, 0),
+                        trit_vm_encode(TRIT_VM_ST, 3, 4, 0, 32), trit_vm_encode(TRIT_VM_CMP, 4, 3, 1, 0)};
+    trit_vm_load(&vm, 0, code, 4);
+    vm.regs[0] = a32;
+    vm.regs[1] = b32;
+    hash = mix(hash, trit_vm_run(&vm, input % 8));
+    hash = mix(hash, vm.regs[3] ^ vm.regs[4] ^ vm.pc);
+    trit_vm_free(&vm);
+  }
+
+  float weights[40];
+  float restored[40];
+  float threshold = 0;
+  float scale = 0;
+  for(int index = 0; index < 40; index++){
+
+    weights[index] = (float)((int64_t)((input >> (index % 48)) & 0xFF) - 128);
+  }
+  trit_quant_scales_float(weights, 1, 40, 0.7f, &threshold, &scale, 1);
+  trit_quantize_float(weights, 40, threshold, totals, 1);
+  trit_dequantize_float(totals, 40, scale, restored, 1);
+  hash = mix(hash, totals[0] ^ totals[1] ^ (int64_t)restored[input % 40]);
+
+  trit_sparse_t sparse_a, sparse_b, sparse_sum;
+  if(trit_sparse_from_packed(&sparse_a, words, 4 * 32 - (input % 32))){
+
+    if(trit_sparse_from_packed(&sparse_b, totals, 4 * 32 - (input % 32))){
+
+      hash = mix(hash, trit_sparse_dot(&sparse_a, &sparse_b));
+      if(trit_sparse_add(&sparse_a, &sparse_b, &sparse_sum)){
+
+        hash = mix(hash, trit_sparse_count(&sparse_sum));
+        trit_sparse_free(&sparse_sum);
+      }
+      trit_sparse_free(&sparse_b);
+    }
+    trit_sparse_free(&sparse_a);
+  }
+
+  uint8_t encoded[64];
+  trit32_t decoded[4];
+  size_t encoded_size = trit_codec_encode(words, 4 * 32 - (input % 32), encoded, sizeof(encoded), 1);
+  if(encoded_size != 0 && trit_codec_decode(encoded, encoded_size, decoded, 4 * 32 - (input % 32), 1)){
+
+    hash = mix(hash, encoded_size ^ decoded[0] ^ decoded[3]);
+  }
+
+  hash = mix(hash, trit_hash_trit8_t(a8));
+  hash = mix(hash, trit_hash_trit16_t(a16));
+  hash = mix(hash, trit_hash_trit32_t(a32));
+  hash = mix(hash, trit_hash_array(words, 4, input));
+
+  trit_map_t map;
+  uint64_t value = 0;
+  if(trit_map_init(&map, 2)){
+
+    for(int index = 0; index < 4; index++){
+
+      trit_map_put(&map, words[index], index);
+    }
+    trit_map_remove(&map, b32);
+    hash = mix(hash, trit_map_get(&map, a32, &value) ? value : map.count);
+    trit_map_free(&map);
+  }
+
+  return hash;
+}
+
+static uint64_t run_rounds(){
+
+  uint64_t state = 0x9E3779B97F4A7C15ULL;
+  uint64_t hash = 0;
+
+  for(int round = 0; round < ROUNDS; round++){
+
+    hash = mix(hash, run_round(&state));
+  }
+
+  return hash;
+}
+
+int main(){
+
+  uint64_t expected = run_rounds();
+  std::vector<uint64_t> results(THREADS);
+  std::vector<std::thread> threads;
+
+  for(int index = 0; index < THREADS; index++){
+
+    threads.emplace_back([&results, index](){ results[index] = run_rounds(); });
+  }
+
+  for(int index = 0; index < THREADS; index++){
+
+    threads[index].join();
+  }
+
+  for(int index = 0; index < THREADS; index++){
+
+    if(results[index] != expected){
+
+      printf("thread %d: checksum %llx, expected %llx\n", index,
+             (unsigned long long)results[index], (unsigned long long)expected);
+      return 1;
+    }
+  }
+
+  printf("%d threads x %d rounds: ok\n", THREADS, ROUNDS);
+
+  return 0;
+}
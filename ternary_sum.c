@@ -0,0 +1,437 @@
+/**
+ * @file ternary_sum.c
+ *
+ * @brief File contains a carry-save accumulator for trit sums.
+ *
+ * Adding many balanced ternary values one @c trit_add_trit32_t
+ * at a time carries through every trit for every value. The
+ * accumulator here counts the +1 and -1 trits of every position
+ * in bit-sliced binary counters instead and only turns the
+ * counts back into a balanced ternary number when it is read.
+ */
+
+
+#include<stdlib.h>
+
+#include"ternary_sum.h"
+#include"ternary_thread.h"
+
+#define LOW_BITS 0x5555555555555555ULL /**< Mask of the low bit of every trit in a @c trit32_t */
+#define SUM_CAPACITY ((1U << TRIT_SUM_PLANES) - 1) /**< Values the planes hold before they are folded */
+#define REDUCE_BLOCK ((size_t)1 << 16) /**< Values per block of a threaded reduction */
+
+/**
+ * @brief Arguments of one threaded reduction shared by all threads.
+ */
+typedef struct {
+    const trit32_t *values; /**< The values to sum */
+    size_t count; /**< The number of values */
+    trit64_t *totals; /**< The sum of every block */
+    bool *overflows; /**< The overflow of every block */
+} reduce_args;
+
+/**
+ * @brief Adds one to the bit-sliced counters selected by @p bits.
+ *
+ * This is a binary increment done on every selected counter
+ * at once. Half of the increments stop at plane 0, a quarter
+ * at plane 1 and so on, so it takes two planes on average.
+ *
+ * @param[in,out] planes The counter bit planes.
+ *
+ * @param[in] bits The counters to increment.
+ */
+__attribute__((always_inline))
+static inline void count_bits(uint64_t *planes, uint64_t bits){
+
+    uint64_t carry = 0;
+    int plane = 0;
+
+    for(plane = 0; bits != 0; plane++){
+
+        carry = planes[plane] & bits;
+        planes[plane] ^= bits;
+        bits = carry;
+    }
+}
+
+/**
+ * @brief Turns the counter planes of @p sum into a balanced ternary number.
+ *
+ * Plane k is the balanced ternary word with +1 where only the
+ * +1 count has bit k set and -1 where only the -1 count has it,
+ * the value is the sum of plane k times 2^k.
+ *
+ * @param[in] sum The accumulator.
+ *
+ * @param[out] overflow Set to true if the value does not
+ * fit in 64 trits.
+ *
+ * @return The value of the planes
+ */
+static trit64_t planes_value(const trit_sum_t *sum, bool *overflow){
+
+    trit64_t result = 0;
+    trit32_t word = 0;
+    bool carry = false;
+    int plane = 0;
+
+    *overflow = false;
+
+    for(plane = TRIT_SUM_PLANES - 1; plane >= 0; plane--){
+
+        if(sum->count >> plane == 0){
+
+            continue;
+        }
+
+        word = (sum->pos[plane] ^ sum->neg[plane]) | ((sum->neg[plane] & ~sum->pos[plane]) << 1);
+
+        result = trit_add_checked_trit64_t(result, result, &carry);
+        *overflow |= carry;
+        result = trit_add_checked_trit64_t(result, trit_widen_trit32_t_to_trit64_t(word), &carry);
+        *overflow |= carry;
+    }
+
+    return result;
+}
+
+/**
+ * @brief Folds the counter planes of @p sum into its total.
+ *
+ * @param[in,out] sum The accumulator.
+ */
+static void fold_planes(trit_sum_t *sum){
+
+    bool overflow = false;
+    bool carry = false;
+    trit64_t value = planes_value(sum, &overflow);
+    int plane = 0;
+
+    sum->total = trit_add_checked_trit64_t(sum->total, value, &carry);
+    sum->overflow |= overflow || carry;
+    sum->count = 0;
+
+    for(plane = 0; plane < TRIT_SUM_PLANES; plane++){
+
+        sum->pos[plane] = 0;
+        sum->neg[plane] = 0;
+    }
+}
+
+/**
+ * @brief Adds @p value to @p sum, see @c trit_sum_add.
+ */
+__attribute__((always_inline))
+static inline void sum_add(trit_sum_t *sum, trit32_t value){
+
+    uint64_t neg = (value >> 1) & LOW_BITS;
+
+    assert((neg & ~value) == 0);
+
+    if(sum->count == SUM_CAPACITY){
+
+        fold_planes(sum);
+    }
+
+    count_bits(sum->pos, value & ~neg & LOW_BITS);
+    count_bits(sum->neg, neg);
+    sum->count++;
+}
+
+/**
+ * @brief Carry-save adder on bit planes.
+ *
+ * Adds three planes bit by bit, @p high gets the carries
+ * and @p low the sums so @p a + @p b + @p c = 2 @p high + @p low.
+ */
+#define CSA(high, low, a, b, c)                \
+    do {                                       \
+        uint64_t csa_u = (a) ^ (b);            \
+        uint64_t csa_c = (c);                  \
+        (high) = ((a) & (b)) | (csa_u & csa_c); \
+        (low) = csa_u ^ csa_c;                 \
+    } while(0)
+
+/**
+ * @brief Adds 16 bit planes to the counters in @p planes.
+ *
+ * A Harley-Seal tree of carry-save adders puts the 16 planes
+ * into counter planes 0 to 3 without branches, only the
+ * carries out of plane 3 (once per 16 values) go through
+ * @c count_bits.
+ *
+ * @param[in,out] planes The counter bit planes.
+ *
+ * @param[in] bits The 16 planes to add.
+ */
+__attribute__((always_inline))
+static inline void count_bits_16(uint64_t *planes, const uint64_t *bits){
+
+    uint64_t twos_a = 0, twos_b = 0;
+    uint64_t fours_a = 0, fours_b = 0;
+    uint64_t eights_a = 0, eights_b = 0;
+    uint64_t sixteens = 0;
+
+    CSA(twos_a, planes[0], planes[0], bits[0], bits[1]);
+    CSA(twos_b, planes[0], planes[0], bits[2], bits[3]);
+    CSA(fours_a, planes[1], planes[1], twos_a, twos_b);
+    CSA(twos_a, planes[0], planes[0], bits[4], bits[5]);
+    CSA(twos_b, planes[0], planes[0], bits[6], bits[7]);
+    CSA(fours_b, planes[1], planes[1], twos_a, twos_b);
+    CSA(eights_a, planes[2], planes[2], fours_a, fours_b);
+    CSA(twos_a, planes[0], planes[0], bits[8], bits[9]);
+    CSA(twos_b, planes[0], planes[0], bits[10], bits[11]);
+    CSA(fours_a, planes[1], planes[1], twos_a, twos_b);
+    CSA(twos_a, planes[0], planes[0], bits[12], bits[13]);
+    CSA(twos_b, planes[0], planes[0], bits[14], bits[15]);
+    CSA(fours_b, planes[1], planes[1], twos_a, twos_b);
+    CSA(eights_b, planes[2], planes[2], fours_a, fours_b);
+    CSA(sixteens, planes[3], planes[3], eights_a, eights_b);
+
+    count_bits(planes + 4, sixteens);
+}
+
+/**
+ * @brief Adds 16 values to @p sum, see @c trit_sum_add.
+ */
+__attribute__((always_inline))
+static inline void sum_add_16(trit_sum_t *sum, const trit32_t *values){
+
+    uint64_t pos[16];
+    uint64_t neg[16];
+    int index = 0;
+
+    for(index = 0; index < 16; index++){
+
+        neg[index] = (values[index] >> 1) & LOW_BITS;
+        pos[index] = values[index] & ~neg[index] & LOW_BITS;
+
+        assert((neg[index] & ~values[index]) == 0);
+    }
+
+    if(sum->count > SUM_CAPACITY - 16){
+
+        fold_planes(sum);
+    }
+
+    count_bits_16(sum->pos, pos);
+    count_bits_16(sum->neg, neg);
+    sum->count += 16;
+}
+
+/**
+ * @brief Sets @p sum to zero.
+ *
+ * @param[out] sum The accumulator.
+ */
+void trit_sum_init(trit_sum_t *sum){
+
+    int plane = 0;
+
+    for(plane = 0; plane < TRIT_SUM_PLANES; plane++){
+
+        sum->pos[plane] = 0;
+        sum->neg[plane] = 0;
+    }
+
+    sum->count = 0;
+    sum->total = 0;
+    sum->overflow = false;
+}
+
+/**
+ * @brief Adds a balanced ternary value to @p sum.
+ *
+ * The value is absorbed by incrementing the trit counters,
+ * no carry passes between trits.
+ *
+ * @warning This method asserts that @p value is in balanced ternary.
+ *
+ * @param[in,out] sum The accumulator.
+ *
+ * @param[in] value The 32 trit balanced ternary value.
+ */
+void trit_sum_add(trit_sum_t *sum, trit32_t value){
+
+    sum_add(sum, value);
+}
+
+/**
+ * @brief Adds the sum held by @p other to @p sum.
+ *
+ * @param[in,out] sum The accumulator added to.
+ *
+ * @param[in] other The accumulator added, left unchanged.
+ */
+void trit_sum_merge(trit_sum_t *sum, const trit_sum_t *other){
+
+    bool overflow = false;
+    bool carry = false;
+    trit64_t value = trit_sum_read_trit64_t(other, &overflow);
+
+    sum->total = trit_add_checked_trit64_t(sum->total, value, &carry);
+    sum->overflow |= overflow || carry;
+}
+
+/**
+ * @brief Reads the sum as a canonical @c trit64_t.
+ *
+ * @param[in] sum The accumulator, left unchanged.
+ *
+ * @param[out] overflow Set to true if the sum did not fit
+ * in 64 trits at any point, false otherwise.
+ *
+ * @return The sum of every value added, modulo 3^64
+ */
+trit64_t trit_sum_read_trit64_t(const trit_sum_t *sum, bool *overflow){
+
+    bool carry = false;
+    trit64_t result = planes_value(sum, overflow);
+
+    result = trit_add_checked_trit64_t(sum->total, result, &carry);
+    *overflow |= carry || sum->overflow;
+
+    return result;
+}
+
+/**
+ * @brief Reads the sum as a canonical @c trit32_t.
+ *
+ * @param[in] sum The accumulator, left unchanged.
+ *
+ * @param[out] overflow Set to true if the sum does not fit
+ * in 32 trits, false otherwise.
+ *
+ * @return The sum of every value added, modulo 3^32
+ */
+trit32_t trit_sum_read_trit32_t(const trit_sum_t *sum, bool *overflow){
+
+    bool narrow = false;
+    trit32_t result = trit_narrow_checked_trit64_t_to_trit32_t(trit_sum_read_trit64_t(sum, overflow), &narrow);
+
+    *overflow |= narrow;
+
+    return result;
+}
+
+/**
+ * @brief Sums an array of balanced ternary values.
+ *
+ * @warning This method asserts that the values are in balanced ternary.
+ *
+ * @param[in] values The values to sum.
+ *
+ * @param[in] count The number of values.
+ *
+ * @param[out] overflow Set to true if the sum does not fit
+ * in 64 trits, false otherwise.
+ *
+ * @return The sum of @p values
+ */
+trit64_t trit_sum_array(const trit32_t *values, size_t count, bool *overflow){
+
+    trit_sum_t sum;
+    size_t index = 0;
+
+    trit_sum_init(&sum);
+
+    for(index = 0; index + 16 <= count; index += 16){
+
+        sum_add_16(&sum, values + index);
+    }
+
+    for(; index < count; index++){
+
+        sum_add(&sum, values[index]);
+    }
+
+    return trit_sum_read_trit64_t(&sum, overflow);
+}
+
+/**
+ * @brief Sums the blocks [@p start, @p end) of a reduction.
+ *
+ * @param[in] arg The @c reduce_args of the reduction.
+ *
+ * @param[in] start The first block.
+ *
+ * @param[in] end One past the last block.
+ */
+static void reduce_range(void *arg, size_t start, size_t end){
+
+    const reduce_args *args = (const reduce_args *)arg;
+    size_t block = 0;
+    size_t first = 0;
+    size_t length = 0;
+
+    for(block = start; block < end; block++){
+
+        first = block * REDUCE_BLOCK;
+        length = args->count - first < REDUCE_BLOCK ? args->count - first : REDUCE_BLOCK;
+
+        args->totals[block] = trit_sum_array(args->values + first, length, &args->overflows[block]);
+    }
+}
+
+/**
+ * @brief Sums an array of balanced ternary values using threads.
+ *
+ * The array is cut into fixed blocks which are summed with
+ * @c trit_sum_array on the threads, the block sums are then
+ * added in order so the result does not depend on @p threads.
+ *
+ * @warning This method asserts that the values are in balanced ternary.
+ *
+ * @param[in] values The values to sum.
+ *
+ * @param[in] count The number of values.
+ *
+ * @param[in] threads The number of threads,
+ * see @c trit_thread_count.
+ *
+ * @param[out] overflow Set to true if the sum does not fit
+ * in 64 trits, false otherwise.
+ *
+ * @return The sum of @p values
+ */
+trit64_t trit_sum_reduce(const trit32_t *values, size_t count, int threads, bool *overflow){
+
+    size_t blocks = (count + REDUCE_BLOCK - 1) / REDUCE_BLOCK;
+    reduce_args args;
+    trit64_t result = 0;
+    bool carry = false;
+    size_t block = 0;
+
+    if(blocks <= 1){
+
+        return trit_sum_array(values, count, overflow);
+    }
+
+    args.values = values;
+    args.count = count;
+    args.totals = (trit64_t *)malloc(blocks * sizeof(trit64_t));
+    args.overflows = (bool *)malloc(blocks * sizeof(bool));
+
+    if(args.totals == NULL || args.overflows == NULL){
+
+        free(args.totals);
+        free(args.overflows);
+        return trit_sum_array(values, count, overflow);
+    }
+
+    trit_parallel_for(blocks, 1, threads, reduce_range, &args);
+
+    *overflow = false;
+
+    for(block = 0; block < blocks; block++){
+
+        result = trit_add_checked_trit64_t(result, args.totals[block], &carry);
+        *overflow |= carry || args.overflows[block];
+    }
+
+    free(args.totals);
+    free(args.overflows);
+
+    return result;
+}
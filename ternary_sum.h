@@ -0,0 +1,37 @@
+#ifndef __ternary_sum_h__
+#define __ternary_sum_h__
+
+#include<stddef.h>
+#include"ternary.h"
+
+#define TRIT_SUM_PLANES 16 /**< Bit planes per trit counter, a @c trit_sum_t takes 2^16 - 1 values between flushes */
+
+/**
+ * @brief Carry-save accumulator for balanced ternary values.
+ *
+ * Every trit position keeps a binary count of the +1 and the
+ * -1 trits added at it, stored as bit planes, so adding a value
+ * never carries from one trit to the next. The counts are folded
+ * into @c total once they are full and when the sum is read.
+ */
+typedef struct {
+
+    uint64_t pos[TRIT_SUM_PLANES]; /**< Bit k of the count of +1 trits, at the low bit of every trit */
+    uint64_t neg[TRIT_SUM_PLANES]; /**< Bit k of the count of -1 trits, at the low bit of every trit */
+    uint32_t count; /**< Values in the planes */
+    trit64_t total; /**< The folded part of the sum */
+    bool overflow; /**< Set once @c total did not fit in 64 trits */
+} trit_sum_t;
+
+// CARRY-SAVE SUM FUNCTIONS
+void trit_sum_init(trit_sum_t *sum);
+void trit_sum_add(trit_sum_t *sum, trit32_t value);
+void trit_sum_merge(trit_sum_t *sum, const trit_sum_t *other);
+trit64_t trit_sum_read_trit64_t(const trit_sum_t *sum, bool *overflow);
+trit32_t trit_sum_read_trit32_t(const trit_sum_t *sum, bool *overflow);
+
+// ARRAY SUM FUNCTIONS
+trit64_t trit_sum_array(const trit32_t *values, size_t count, bool *overflow);
+trit64_t trit_sum_reduce(const trit32_t *values, size_t count, int threads, bool *overflow);
+
+#endif // __ternary_sum_h__
@@ -0,0 +1,571 @@
+/**
+ * @file ternary_tcam.c
+ *
+ * @brief File contains a software ternary content-addressable memory.
+ *
+ * Rules are grouped into blocks of TRIT_TCAM_BLOCK in insertion
+ * order. For every key bit and bit value a block keeps a vector
+ * with one bit per rule, set if the rule accepts that value, so
+ * the rules of a block matching a key are the AND of one vector
+ * per key bit. Random keys rule out a whole block after a few
+ * bits, which ends the loop early.
+ *
+ * Every block also keeps the highest priority of its rules, and
+ * the blocks are kept sorted by it as rules are inserted. A
+ * lookup visits the blocks in that order and stops at the first
+ * one that cannot beat the best match found so far. Priorities
+ * are compared higher first, equal priorities go to the rule
+ * inserted first.
+ */
+
+
+#include<stdlib.h>
+#include<string.h>
+
+#include"ternary_tcam.h"
+#include"ternary_cpu.h"
+
+#define BLOCK_WORDS (TRIT_TCAM_BLOCK / 64) /**< The 64 bit words in one vector of a block */
+#define CHECK_BITS 8 /**< The key bits between checks for an empty match */
+
+/**
+ * @brief Finds the vectors of one block.
+ *
+ * @param[in] tcam The TCAM.
+ *
+ * @param[in] block The block number.
+ *
+ * @return The 2 * bits vectors of the block, accept 0 then
+ * accept 1 for bit 0 first
+ */
+static uint64_t *block_slices(const trit_tcam_t *tcam, size_t block){
+
+    return tcam->slices + block * 2 * (size_t)tcam->bits * BLOCK_WORDS;
+}
+
+/**
+ * @brief Creates an empty TCAM.
+ *
+ * @param[out] tcam The TCAM.
+ *
+ * @param[in] bits The key width, 32 or 64.
+ *
+ * @param[in] capacity The number of rules to make room for, the
+ * TCAM grows past it as needed.
+ *
+ * @return false if @p bits is not 32 or 64 or the TCAM could
+ * not be allocated
+ */
+bool trit_tcam_init(trit_tcam_t *tcam, int bits, size_t capacity){
+
+    size_t blocks = (capacity + TRIT_TCAM_BLOCK - 1) / TRIT_TCAM_BLOCK;
+
+    memset(tcam, 0, sizeof(*tcam));
+
+    if(bits != 32 && bits != 64){
+
+        return false;
+    }
+
+    blocks = blocks == 0 ? 1 : blocks;
+    tcam->bits = bits;
+    tcam->capacity = blocks * TRIT_TCAM_BLOCK;
+    tcam->slices = (uint64_t *)malloc(blocks * 2 * bits * BLOCK_WORDS * sizeof(uint64_t));
+    tcam->priorities = (int32_t *)malloc(tcam->capacity * sizeof(int32_t));
+    tcam->block_max = (int32_t *)malloc(blocks * sizeof(int32_t));
+    tcam->order = (size_t *)malloc(blocks * sizeof(size_t));
+
+    if(tcam->slices == NULL || tcam->priorities == NULL || tcam->block_max == NULL || tcam->order == NULL){
+
+        trit_tcam_free(tcam);
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Frees the memory of a TCAM.
+ *
+ * @param[in,out] tcam The TCAM, left empty.
+ */
+void trit_tcam_free(trit_tcam_t *tcam){
+
+    free(tcam->slices);
+    free(tcam->priorities);
+    free(tcam->block_max);
+    free(tcam->order);
+    memset(tcam, 0, sizeof(*tcam));
+}
+
+/**
+ * @brief Doubles the room for rules.
+ *
+ * @param[in,out] tcam The TCAM.
+ *
+ * @return false if the memory could not be allocated, the
+ * TCAM is unchanged then
+ */
+static bool grow(trit_tcam_t *tcam){
+
+    size_t blocks = 2 * tcam->capacity / TRIT_TCAM_BLOCK;
+    uint64_t *slices = (uint64_t *)realloc(tcam->slices, blocks * 2 * tcam->bits * BLOCK_WORDS * sizeof(uint64_t));
+    int32_t *priorities = NULL;
+    int32_t *block_max = NULL;
+    size_t *order = NULL;
+
+    if(slices == NULL){
+
+        return false;
+    }
+    tcam->slices = slices;
+
+    priorities = (int32_t *)realloc(tcam->priorities, blocks * TRIT_TCAM_BLOCK * sizeof(int32_t));
+    if(priorities == NULL){
+
+        return false;
+    }
+    tcam->priorities = priorities;
+
+    block_max = (int32_t *)realloc(tcam->block_max, blocks * sizeof(int32_t));
+    if(block_max == NULL){
+
+        return false;
+    }
+    tcam->block_max = block_max;
+
+    order = (size_t *)realloc(tcam->order, blocks * sizeof(size_t));
+    if(order == NULL){
+
+        return false;
+    }
+    tcam->order = order;
+    tcam->capacity = blocks * TRIT_TCAM_BLOCK;
+
+    return true;
+}
+
+/**
+ * @brief Adds a rule given as its care and value bits.
+ *
+ * @param[in,out] tcam The TCAM.
+ *
+ * @param[in] care Bit i set if key bit i matters.
+ *
+ * @param[in] value The bits the key must have where @p care is set.
+ *
+ * @param[in] priority The priority, higher wins.
+ *
+ * @return false if the memory could not be allocated
+ */
+static bool insert_rule(trit_tcam_t *tcam, uint64_t care, uint64_t value, int32_t priority){
+
+    size_t id = tcam->count;
+    size_t block = id / TRIT_TCAM_BLOCK;
+    size_t position = 0;
+    uint64_t *slices = NULL;
+    uint64_t bit = 1ULL << (id % 64);
+    size_t word = (id % TRIT_TCAM_BLOCK) / 64;
+    int index = 0;
+
+    if(id == tcam->capacity && !grow(tcam)){
+
+        return false;
+    }
+
+    slices = block_slices(tcam, block);
+
+    if(id % TRIT_TCAM_BLOCK == 0){
+
+        // a new block starts empty and last in the order
+        memset(slices, 0, 2 * tcam->bits * BLOCK_WORDS * sizeof(uint64_t));
+        tcam->block_max[block] = priority;
+        tcam->order[block] = block;
+    }
+
+    for(index = 0; index < tcam->bits; index++){
+
+        bool cares = (care >> index) & 1;
+        bool one = (value >> index) & 1;
+
+        if(!cares || !one){
+
+            slices[(2 * index) * BLOCK_WORDS + word] |= bit;
+        }
+        if(!cares || one){
+
+            slices[(2 * index + 1) * BLOCK_WORDS + word] |= bit;
+        }
+    }
+
+    tcam->priorities[id] = priority;
+    tcam->block_max[block] = priority > tcam->block_max[block] ? priority : tcam->block_max[block];
+    tcam->count++;
+
+    // move the block up past the blocks it now beats
+    for(position = 0; tcam->order[position] != block; position++){
+    }
+    while(position > 0 && tcam->block_max[tcam->order[position - 1]] < tcam->block_max[block]){
+
+        tcam->order[position] = tcam->order[position - 1];
+        position--;
+    }
+    tcam->order[position] = block;
+
+    return true;
+}
+
+/**
+ * @brief Adds a @c trit32_t rule.
+ *
+ * Trit i of @p rule is +1 if key bit i must be 1, -1 if it
+ * must be 0 and 0 if it does not matter. In a 64 bit TCAM the
+ * key bits past 31 do not matter. Ids are given out in
+ * insertion order starting at 0.
+ *
+ * @warning This method asserts that @p rule is in balanced ternary.
+ *
+ * @param[in,out] tcam The TCAM.
+ *
+ * @param[in] rule The rule.
+ *
+ * @param[in] priority The priority, the matching rule with the
+ * highest priority wins a lookup.
+ *
+ * @return false if the memory could not be allocated
+ */
+bool trit_tcam_insert_trit32_t(trit_tcam_t *tcam, trit32_t rule, int32_t priority){
+
+    uint64_t care = 0;
+    uint64_t value = 0;
+    int index = 0;
+
+    assert(((rule >> 1) & ~rule & 0x5555555555555555ULL) == 0);
+
+    for(index = 0; index < 32; index++){
+
+        uint64_t code = (rule >> (2 * index)) & 3;
+
+        care |= (uint64_t)(code != 0) << index;
+        value |= (uint64_t)(code == 1) << index;
+    }
+
+    return insert_rule(tcam, care, value, priority);
+}
+
+/**
+ * @brief Adds a @c trit64_t rule to a 64 bit TCAM.
+ *
+ * @see trit_tcam_insert_trit32_t
+ *
+ * @param[in,out] tcam The TCAM, with 64 bit keys.
+ *
+ * @param[in] rule The rule.
+ *
+ * @param[in] priority The priority, the matching rule with the
+ * highest priority wins a lookup.
+ *
+ * @return false if the memory could not be allocated
+ */
+bool trit_tcam_insert_trit64_t(trit_tcam_t *tcam, trit64_t rule, int32_t priority){
+
+    uint64_t care = 0;
+    uint64_t value = 0;
+    int index = 0;
+
+    assert(tcam->bits == 64);
+
+    for(index = 0; index < 64; index++){
+
+        uint64_t code = (uint64_t)(rule >> (2 * index)) & 3;
+
+        assert(code != 2);
+
+        care |= (uint64_t)(code != 0) << index;
+        value |= (uint64_t)(code == 1) << index;
+    }
+
+    return insert_rule(tcam, care, value, priority);
+}
+
+/**
+ * @brief Keeps the better of a match and the best so far.
+ *
+ * @param[in] tcam The TCAM.
+ *
+ * @param[in] matches The matching rules of one block, one bit each.
+ *
+ * @param[in] block The block number.
+ *
+ * @param[in,out] best The id of the best match, TRIT_TCAM_NONE if none.
+ */
+static void pick_best(const trit_tcam_t *tcam, const uint64_t *matches, size_t block, size_t *best){
+
+    size_t word = 0;
+
+    for(word = 0; word < BLOCK_WORDS; word++){
+
+        uint64_t bits = matches[word];
+
+        while(bits != 0){
+
+            size_t id = block * TRIT_TCAM_BLOCK + 64 * word + (size_t)__builtin_ctzll(bits);
+
+            // ids rise within a block, so only a higher priority replaces a match
+            if(*best == TRIT_TCAM_NONE || tcam->priorities[id] > tcam->priorities[*best]
+               || (tcam->priorities[id] == tcam->priorities[*best] && id < *best)){
+
+                *best = id;
+            }
+            bits &= bits - 1;
+        }
+    }
+}
+
+/**
+ * @brief Checks if a block can hold a better match than the best so far.
+ *
+ * @param[in] tcam The TCAM.
+ *
+ * @param[in] block The block number.
+ *
+ * @param[in] best The id of the best match, TRIT_TCAM_NONE if none.
+ *
+ * @return false if no rule of the block can replace @p best
+ */
+static bool may_beat(const trit_tcam_t *tcam, size_t block, size_t best){
+
+    if(best == TRIT_TCAM_NONE){
+
+        return true;
+    }
+
+    return tcam->block_max[block] > tcam->priorities[best]
+           || (tcam->block_max[block] == tcam->priorities[best] && block * TRIT_TCAM_BLOCK < best);
+}
+
+/**
+ * @brief Finds the best rule for one key with 64 bit words.
+ *
+ * @param[in] tcam The TCAM.
+ *
+ * @param[in] key The key.
+ *
+ * @return The id of the best matching rule, TRIT_TCAM_NONE if none
+ */
+static size_t lookup_scalar(const trit_tcam_t *tcam, uint64_t key){
+
+    size_t blocks = (tcam->count + TRIT_TCAM_BLOCK - 1) / TRIT_TCAM_BLOCK;
+    size_t best = TRIT_TCAM_NONE;
+    size_t position = 0;
+    size_t word = 0;
+    int index = 0;
+
+    for(position = 0; position < blocks; position++){
+
+        size_t block = tcam->order[position];
+        const uint64_t *slices = block_slices(tcam, block);
+        uint64_t matches[BLOCK_WORDS];
+        uint64_t any = 0;
+
+        // blocks come by block_max, so past a lower one nothing can win
+        if(!may_beat(tcam, block, best)){
+
+            if(tcam->block_max[block] < tcam->priorities[best]){
+
+                break;
+            }
+            continue;
+        }
+
+        for(word = 0; word < BLOCK_WORDS; word++){
+
+            matches[word] = ~0ULL;
+        }
+
+        for(index = 0; index < tcam->bits; index++){
+
+            const uint64_t *accept = slices + (2 * index + ((key >> index) & 1)) * BLOCK_WORDS;
+
+            any = 0;
+            for(word = 0; word < BLOCK_WORDS; word++){
+
+                matches[word] &= accept[word];
+                any |= matches[word];
+            }
+            if(any == 0){
+
+                break;
+            }
+        }
+
+        if(any != 0){
+
+            pick_best(tcam, matches, block, &best);
+        }
+    }
+
+    return best;
+}
+
+/**
+ * @brief Finds the best rule for one key.
+ *
+ * @param[in] tcam The TCAM.
+ *
+ * @param[in] key The key, bits past the TCAM width are ignored.
+ *
+ * @param[out] id The id of the matching rule with the highest
+ * priority, the first inserted of equal ones.
+ *
+ * @return false if no rule matches
+ */
+bool trit_tcam_lookup(const trit_tcam_t *tcam, uint64_t key, size_t *id){
+
+    trit_tcam_lookup_array(tcam, &key, id, 1);
+
+    return *id != TRIT_TCAM_NONE;
+}
+
+// SCALAR TCAM KERNELS
+
+/**
+ * @brief Finds the best rule for every key.
+ *
+ * @see trit_tcam_lookup
+ *
+ * @param[in] tcam The TCAM.
+ *
+ * @param[in] keys The keys.
+ *
+ * @param[out] ids The @p count ids, TRIT_TCAM_NONE where no rule matches.
+ *
+ * @param[in] count The number of keys.
+ */
+void trit_tcam_lookup_scalar(const trit_tcam_t *tcam, const uint64_t *keys, size_t *ids, size_t count){
+
+    size_t index = 0;
+
+    for(index = 0; index < count; index++){
+
+        ids[index] = lookup_scalar(tcam, keys[index]);
+    }
+}
+
+#ifdef TERNARY_X86_64
+/**
+ * @brief Finds the best rule for one key with AVX2.
+ *
+ * A block of rules is one vector, so every key bit costs one
+ * load and one AND, and the early exit is one @c vptest.
+ *
+ * @param[in] tcam The TCAM.
+ *
+ * @param[in] key The key.
+ *
+ * @return The id of the best matching rule, TRIT_TCAM_NONE if none
+ */
+__attribute__((target("avx2")))
+static size_t lookup_avx2(const trit_tcam_t *tcam, uint64_t key){
+
+    size_t blocks = (tcam->count + TRIT_TCAM_BLOCK - 1) / TRIT_TCAM_BLOCK;
+    size_t best = TRIT_TCAM_NONE;
+    size_t position = 0;
+    int index = 0;
+    int bit = 0;
+
+    for(position = 0; position < blocks; position++){
+
+        size_t block = tcam->order[position];
+        const __m256i *slices = (const __m256i *)block_slices(tcam, block);
+        __m256i matches = _mm256_set1_epi64x(-1);
+
+        // blocks come by block_max, so past a lower one nothing can win
+        if(!may_beat(tcam, block, best)){
+
+            if(tcam->block_max[block] < tcam->priorities[best]){
+
+                break;
+            }
+            continue;
+        }
+
+        for(index = 0; index < tcam->bits; index += CHECK_BITS){
+
+            for(bit = index; bit < index + CHECK_BITS; bit++){
+
+                matches = _mm256_and_si256(matches, _mm256_loadu_si256(slices + 2 * bit + ((key >> bit) & 1)));
+            }
+            if(_mm256_testz_si256(matches, matches)){
+
+                break;
+            }
+        }
+
+        if(index >= tcam->bits){
+
+            uint64_t words[BLOCK_WORDS];
+
+            _mm256_storeu_si256((__m256i *)words, matches);
+            pick_best(tcam, words, block, &best);
+        }
+    }
+
+    return best;
+}
+
+/**
+ * @brief Finds the best rule for every key with AVX2.
+ *
+ * @warning The CPU must support AVX2.
+ *
+ * @see trit_tcam_lookup_scalar
+ *
+ * @param[in] tcam The TCAM.
+ *
+ * @param[in] keys The keys.
+ *
+ * @param[out] ids The @p count ids, TRIT_TCAM_NONE where no rule matches.
+ *
+ * @param[in] count The number of keys.
+ */
+__attribute__((target("avx2")))
+void trit_tcam_lookup_avx2(const trit_tcam_t *tcam, const uint64_t *keys, size_t *ids, size_t count){
+
+    size_t index = 0;
+
+    for(index = 0; index < count; index++){
+
+        ids[index] = lookup_avx2(tcam, keys[index]);
+    }
+}
+#endif
+
+// BATCH TCAM FUNCTIONS
+
+/**
+ * @brief Finds the best rule for every key.
+ *
+ * Picks the AVX2 or scalar kernel at run time.
+ *
+ * @see trit_tcam_lookup
+ *
+ * @param[in] tcam The TCAM.
+ *
+ * @param[in] keys The keys.
+ *
+ * @param[out] ids The @p count ids, TRIT_TCAM_NONE where no rule matches.
+ *
+ * @param[in] count The number of keys.
+ */
+void trit_tcam_lookup_array(const trit_tcam_t *tcam, const uint64_t *keys, size_t *ids, size_t count){
+
+#ifdef TERNARY_X86_64
+    if(trit_cpu_avx2()){
+
+        trit_tcam_lookup_avx2(tcam, keys, ids, count);
+        return;
+    }
+#endif
+    trit_tcam_lookup_scalar(tcam, keys, ids, count);
+}
@@ -0,0 +1,49 @@
+#ifndef __ternary_tcam_h__
+#define __ternary_tcam_h__
+
+#include<stddef.h>
+#include<stdint.h>
+#include"ternary.h"
+
+#define TRIT_TCAM_BLOCK 256 /**< Rules per bit-sliced block, one AVX2 vector */
+#define TRIT_TCAM_NONE ((size_t)-1) /**< The id of a lookup that matched no rule */
+
+/**
+ * @brief A ternary content-addressable memory.
+ *
+ * Trit i of a rule is +1 if bit i of the key must be 1, -1 if
+ * it must be 0 and 0 if the bit does not matter. The rules are
+ * stored bit-sliced, for every block of TRIT_TCAM_BLOCK rules
+ * and every key bit and bit value there is one bit per rule,
+ * set if the rule accepts that value.
+ */
+typedef struct{
+
+    uint64_t *slices;    /**< 2 * bits vectors of TRIT_TCAM_BLOCK bits per block */
+    int32_t *priorities; /**< The priority of every rule, by id */
+    int32_t *block_max;  /**< The highest priority in every block */
+    size_t *order;       /**< The blocks from the highest block_max down */
+    size_t count;        /**< The number of rules */
+    size_t capacity;     /**< The rules there is room for */
+    int bits;            /**< The key width, 32 or 64 */
+} trit_tcam_t;
+
+// TCAM FUNCTIONS
+bool trit_tcam_init(trit_tcam_t *tcam, int bits, size_t capacity);
+void trit_tcam_free(trit_tcam_t *tcam);
+bool trit_tcam_insert_trit32_t(trit_tcam_t *tcam, trit32_t rule, int32_t priority);
+bool trit_tcam_insert_trit64_t(trit_tcam_t *tcam, trit64_t rule, int32_t priority);
+bool trit_tcam_lookup(const trit_tcam_t *tcam, uint64_t key, size_t *id);
+
+// BATCH TCAM FUNCTIONS
+void trit_tcam_lookup_array(const trit_tcam_t *tcam, const uint64_t *keys, size_t *ids, size_t count);
+
+// SCALAR TCAM KERNELS
+void trit_tcam_lookup_scalar(const trit_tcam_t *tcam, const uint64_t *keys, size_t *ids, size_t count);
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+// AVX2 TCAM KERNELS
+void trit_tcam_lookup_avx2(const trit_tcam_t *tcam, const uint64_t *keys, size_t *ids, size_t count);
+#endif
+
+#endif // __ternary_tcam_h__
@@ -1,8 +1,38 @@
 #include "ternary.h"
+#include "ternary_circuit.h"
+#include "ternary_codec.h"
+#include "ternary_cpu.h"
+#include "ternary_dot.h"
+#include "ternary_fixed.hpp"
+#include "ternary_float.h"
+#include "ternary_gemm.h"
+#include "ternary_hash.h"
+#include "ternary_kleene.h"
+#include "ternary_lut.h"
+#include "ternary_metric.h"
+#include "ternary_mod.h"
+#include "ternary_quant.h"
+#include "ternary_sat.h"
+#include "ternary_sparse.h"
+#include "ternary_scan.h"
+#include "ternary_sum.h"
+#include "ternary_tcam.h"
+#include "ternary_vm.h"
+#include <string.h>
 #include <deepstate/DeepState.hpp>
 
 using namespace deepstate;
 
+// converts a signed number that fits 32 trits, negating the magnitude when negative
+static trit32_t signed_trits(int64_t num){
+
+  ASSERT (num >= -926510094425920LL && num <= 926510094425920LL);
+
+  trit32_t trits = binary_to_balanced_ternary_trit32_t(num < 0 ? -num : num);
+
+  return num < 0 ? trit_not_trit32_t(trits) : trits;
+}
+
 TEST(TernaryLibrary, BalancedTransform){
 
   uint32_t binary_num = DeepState_UInt();
@@ -17,6 +47,110 @@ TEST(TernaryLibrary, BalancedTransform){
   ASSERT (binary_num == transformed);
 }
 
+// the per-trit loop that converted binary to balanced ternary before the byte tables
+static trit32_t loop_binary_to_trits(uint64_t num, int trits){
+
+  int array[33] = {};
+  trit32_t result = 0;
+
+  for(int index = 0; num > 0 && index < trits; index++){
+
+    array[index] = num % 3;
+    num /= 3;
+  }
+
+  for(int index = 0; index < trits; index++){
+
+    if(array[index] >= 2){
+
+      array[index] -= 3;
+      array[index + 1]++;
+    }
+  }
+
+  for(int index = trits - 1; index >= 0; index--){
+
+    result = (result << 2) | (array[index] == -1 ? 0b11 : array[index]);
+  }
+
+  return result;
+}
+
+// the per-trit loop that converted balanced ternary to binary before the byte tables
+static int64_t loop_trits_to_binary(trit32_t num, int trits){
+
+  int64_t result = 0;
+  int64_t power = 1;
+
+  for(int index = 0; index < trits; index++){
+
+    int grab = (num >> (index * 2)) & 0b11;
+
+    result += (grab == 0b11 ? -1 : grab) * power;
+    power *= 3;
+  }
+
+  return result;
+}
+
+// the per-trit loop that negated balanced ternary before the one-word negation
+static trit32_t loop_not(trit32_t num, int trits){
+
+  trit32_t result = 0;
+
+  for(int index = trits - 1; index >= 0; index--){
+
+    int grab = (num >> (index * 2)) & 0b11;
+
+    result = (result << 2) | (grab == 0b01 ? 0b11 : grab == 0b11 ? 0b01 : 0);
+  }
+
+  return result;
+}
+
+TEST(TernaryLibrary, ConvertTest){
+
+  // every 8 trit number and every balanced 8 trit word
+  for(uint32_t num = 0; num <= 3280; num++){
+
+    ASSERT (binary_to_balanced_ternary_trit8_t(num) == loop_binary_to_trits(num, 8));
+  }
+
+  for(uint32_t word = 0; word <= 0xFFFF; word++){
+
+    if(((word >> 1) & ~word & 0x5555) == 0){
+
+      ASSERT (balanced_ternary_to_binary_int16_t(word) == loop_trits_to_binary(word, 8));
+      ASSERT (trit_not_trit8_t(word) == loop_not(word, 8));
+    }
+  }
+
+  // 16 and 32 trits anywhere in their range, the unbalanced codes of the word cleared to 0
+  uint32_t num16 = DeepState_UInt() % 21523361;
+  uint64_t num32 = DeepState_UInt64() % 926510094425921ULL;
+  trit32_t word = DeepState_UInt64();
+
+  word &= ~(((word >> 1) & ~word & 0x5555555555555555ULL) << 1);
+
+  LOG(TRACE) << "16 trit number: " << num16;
+  LOG(TRACE) << "32 trit number: " << num32;
+  LOG(TRACE) << "Word:           " << word;
+
+  ASSERT (binary_to_balanced_ternary_trit16_t(num16) == loop_binary_to_trits(num16, 16));
+  ASSERT (binary_to_balanced_ternary_trit32_t(num32) == loop_binary_to_trits(num32, 32));
+  ASSERT (balanced_ternary_to_binary_int32_t((trit16_t)word) == loop_trits_to_binary((trit16_t)word, 16));
+  ASSERT (balanced_ternary_to_binary_int64_t(word) == loop_trits_to_binary(word, 32));
+  ASSERT (trit_not_trit16_t((trit16_t)word) == loop_not((trit16_t)word, 16));
+  ASSERT (trit_not_trit32_t(word) == loop_not(word, 32));
+
+  // the ends of each range
+  ASSERT (binary_to_balanced_ternary_trit16_t(21523360) == loop_binary_to_trits(21523360, 16));
+  ASSERT (binary_to_balanced_ternary_trit32_t(926510094425920ULL) == loop_binary_to_trits(926510094425920ULL, 32));
+  ASSERT (balanced_ternary_to_binary_int32_t(0xFFFFFFFF) == -21523360);
+  ASSERT (balanced_ternary_to_binary_int64_t(0xFFFFFFFFFFFFFFFFULL) == -926510094425920LL);
+  ASSERT (balanced_ternary_to_binary_int64_t(0x5555555555555555ULL) == 926510094425920LL);
+}
+
 TEST(TernaryLibrary, AddTest){
 
   uint32_t binary_num1 = DeepState_UInt();
@@ -57,3 +191,1739 @@ TEST(TernaryLibrary, SubtractTest){
   
   ASSERT (binary_sub == transformed_sub);
 }
+
+TEST(TernaryLibrary, PackUnpackTest){
+
+  uint32_t binary_num = DeepState_UInt();
+
+  trit32_t ternary_num = binary_to_balanced_ternary_trit32_t(binary_num);
+
+  uint32_t mag = 0;
+  uint32_t sign = 0;
+
+  trit_unpack_trit32_t(ternary_num, &mag, &sign);
+
+  trit32_t packed = trit_pack_trit32_t(mag, sign);
+
+  LOG(TRACE) << "Ternary: " << ternary_num;
+  LOG(TRACE) << "Packed:  " << packed;
+
+  ASSERT ((sign & ~mag) == 0);
+  ASSERT (packed == ternary_num);
+}
+
+TEST(TernaryLibrary, DotTest){
+
+  trit32_t weights[3] = {};
+  int8_t act8[70];
+  int16_t act16[70];
+  float actf[70];
+  int64_t expected8 = 0;
+  int64_t expected16 = 0;
+  float expectedf = 0;
+
+  for(int index = 0; index < 70; index++){
+
+    int grab = DeepState_IntInRange(-1, 1);
+
+    act8[index] = DeepState_Char();
+    act16[index] = DeepState_Short();
+    // whole activations keep every float sum exact in any order
+    actf[index] = (float)DeepState_IntInRange(-1000, 1000);
+
+    weights[index / 32] |= (trit32_t)(grab == -1 ? 0b11 : grab) << ((index % 32) * 2);
+
+    expected8 += grab * act8[index];
+    expected16 += grab * act16[index];
+    expectedf += grab * actf[index];
+  }
+
+  int64_t dot8 = trit_dot_int8_t(weights, act8, 70);
+  int64_t dot16 = trit_dot_int16_t(weights, act16, 70);
+  float dotf = trit_dot_float(weights, actf, 70);
+
+  LOG(TRACE) << "Expected int8:  " << expected8;
+  LOG(TRACE) << "Dot int8:       " << dot8;
+  LOG(TRACE) << "Expected int16: " << expected16;
+  LOG(TRACE) << "Dot int16:      " << dot16;
+  LOG(TRACE) << "Expected float: " << expectedf;
+  LOG(TRACE) << "Dot float:      " << dotf;
+
+  ASSERT (dot8 == expected8);
+  ASSERT (dot16 == expected16);
+  ASSERT (trit_dot_scalar_int8_t(weights, act8, 70) == expected8);
+  ASSERT (trit_dot_scalar_int16_t(weights, act16, 70) == expected16);
+  ASSERT (dotf == expectedf);
+  ASSERT (trit_dot_scalar_float(weights, actf, 70) == dotf);
+
+#ifdef TERNARY_X86_64
+  if(trit_cpu_avx2()){
+
+    ASSERT (trit_dot_avx2_int8_t(weights, act8, 70) == trit_dot_scalar_int8_t(weights, act8, 70));
+    ASSERT (trit_dot_avx2_int16_t(weights, act16, 70) == trit_dot_scalar_int16_t(weights, act16, 70));
+    ASSERT (trit_dot_avx2_float(weights, actf, 70) == trit_dot_scalar_float(weights, actf, 70));
+  }
+
+  if(trit_cpu_avx512()){
+
+    ASSERT (trit_dot_avx512_int8_t(weights, act8, 70) == trit_dot_scalar_int8_t(weights, act8, 70));
+    ASSERT (trit_dot_avx512_int16_t(weights, act16, 70) == trit_dot_scalar_int16_t(weights, act16, 70));
+    ASSERT (trit_dot_avx512_float(weights, actf, 70) == trit_dot_scalar_float(weights, actf, 70));
+  }
+#endif
+}
+
+TEST(TernaryLibrary, GemvTest){
+
+  trit32_t weights[5 * TRIT_ROW_WORDS(40)] = {};
+  float x[40];
+  float y[5];
+  float expected[5] = {};
+
+  for(int col = 0; col < 40; col++){
+
+    x[col] = (float)DeepState_IntInRange(-1000, 1000);
+  }
+
+  for(int row = 0; row < 5; row++){
+
+    for(int col = 0; col < 40; col++){
+
+      int grab = DeepState_IntInRange(-1, 1);
+
+      weights[row * TRIT_ROW_WORDS(40) + col / 32] |= (trit32_t)(grab == -1 ? 0b11 : grab) << ((col % 32) * 2);
+
+      expected[row] += grab * x[col];
+    }
+  }
+
+  trit_gemv_float(weights, 5, 40, x, y, 2);
+
+  for(int row = 0; row < 5; row++){
+
+    LOG(TRACE) << "Expected: " << expected[row];
+    LOG(TRACE) << "Gemv:     " << y[row];
+
+    ASSERT (y[row] == expected[row]);
+  }
+
+  // a batch of 6 over 7 rows leaves partial tiles of vectors and rows,
+  // 2153 columns span two column blocks and end in a partial word
+  const int batch_rows = 7;
+  const int batch_cols = 2153;
+  const int batch = 6;
+  uint32_t weight_seed = DeepState_UInt();
+  uint32_t x_seed = DeepState_UInt();
+  static trit32_t batch_weights[batch_rows * TRIT_ROW_WORDS(batch_cols)];
+  static float batch_x[batch * batch_cols];
+  float batch_y[batch * batch_rows];
+  float batch_expected[batch * batch_rows] = {};
+
+  memset(batch_weights, 0, sizeof(batch_weights));
+
+  for(int index = 0; index < batch * batch_cols; index++){
+
+    batch_x[index] = (float)((int)((x_seed + 7919u * (uint32_t)index) % 2001u) - 1000);
+  }
+
+  for(int row = 0; row < batch_rows; row++){
+
+    for(int col = 0; col < batch_cols; col++){
+
+      int grab = (int)((weight_seed + 31u * (uint32_t)row + 17u * (uint32_t)col + (uint32_t)(col * col)) % 3u) - 1;
+
+      batch_weights[row * TRIT_ROW_WORDS(batch_cols) + col / 32] |= (trit32_t)(grab == -1 ? 0b11 : grab) << ((col % 32) * 2);
+
+      for(int vector = 0; vector < batch; vector++){
+
+        batch_expected[vector * batch_rows + row] += grab * batch_x[vector * batch_cols + col];
+      }
+    }
+  }
+
+  trit_gemm_float(batch_weights, batch_rows, batch_cols, batch_x, batch, batch_y, 2);
+
+  for(int index = 0; index < batch * batch_rows; index++){
+
+    ASSERT (batch_y[index] == batch_expected[index]);
+  }
+}
+
+TEST(TernaryLibrary, MetricTest){
+
+  uint32_t binary_num1 = DeepState_UInt();
+  uint32_t binary_num2 = DeepState_UInt();
+
+  trit32_t ternary_num1 = binary_to_balanced_ternary_trit32_t(binary_num1);
+  trit32_t ternary_num2 = binary_to_balanced_ternary_trit32_t(binary_num2);
+
+  int counts[3] = {};
+  int hamming = 0;
+  int similarity = 0;
+
+  for(int index = 0; index < 32; index++){
+
+    int grab1 = balanced_ternary_to_binary_int64_t((ternary_num1 >> (index * 2)) & 0b11);
+    int grab2 = balanced_ternary_to_binary_int64_t((ternary_num2 >> (index * 2)) & 0b11);
+
+    counts[grab1 + 1]++;
+    hamming += grab1 != grab2;
+    similarity += grab1 * grab2;
+  }
+
+  LOG(TRACE) << "Hamming:    " << hamming;
+  LOG(TRACE) << "Similarity: " << similarity;
+
+  ASSERT (trit_count_trit32_t(ternary_num1, -1) == counts[0]);
+  ASSERT (trit_count_trit32_t(ternary_num1, 0) == counts[1]);
+  ASSERT (trit_count_trit32_t(ternary_num1, 1) == counts[2]);
+  ASSERT (trit_hamming_trit32_t(ternary_num1, ternary_num2) == hamming);
+  ASSERT (trit_similarity_trit32_t(ternary_num1, ternary_num2) == similarity);
+  ASSERT (trit_hamming_array(&ternary_num1, &ternary_num2, 1) == (uint64_t)hamming);
+  ASSERT (trit_similarity_array(&ternary_num1, &ternary_num2, 1) == similarity);
+
+  // enough fingerprints for the nearest search to split into chunks
+  static trit32_t base[9000];
+  size_t nearest = 0;
+  uint64_t nearest_distance = 64;
+  uint32_t distance = 0;
+
+  for(size_t index = 0; index < 9000; index++){
+
+    base[index] = binary_to_balanced_ternary_trit32_t(binary_num2 + (uint32_t)index * 2654435761u);
+
+    if(trit_hamming_array(&ternary_num1, &base[index], 1) < nearest_distance){
+
+      nearest = index;
+      nearest_distance = trit_hamming_array(&ternary_num1, &base[index], 1);
+    }
+  }
+
+  ASSERT (trit_hamming_nearest(&ternary_num1, base, 9000, 1, &distance, 1) == nearest);
+  ASSERT (distance == nearest_distance);
+  ASSERT (trit_hamming_nearest(&ternary_num1, base, 9000, 1, &distance, 4) == nearest);
+  ASSERT (trit_hamming_nearest(&ternary_num1, base, 0, 1, NULL, 4) == 0);
+}
+
+TEST(TernaryLibrary, CheckedAddTest){
+
+  uint32_t binary_num1 = DeepState_UInt();
+  uint32_t binary_num2 = DeepState_UInt();
+  bool overflow = true;
+
+  trit32_t ternary_num1 = binary_to_balanced_ternary_trit32_t(binary_num1);
+  trit32_t ternary_num2 = binary_to_balanced_ternary_trit32_t(binary_num2);
+
+  trit32_t ternary_add = trit_add_checked_trit32_t(ternary_num1, ternary_num2, &overflow);
+
+  int64_t transformed_add = balanced_ternary_to_binary_int64_t(ternary_add);
+
+  LOG(TRACE) << "Binary Add:      " << (int64_t)binary_num1 + binary_num2;
+  LOG(TRACE) << "Transformed Add: " << transformed_add;
+
+  ASSERT (overflow == false);
+  ASSERT ((int64_t)binary_num1 + binary_num2 == transformed_add);
+
+  // every trit +1 plus every trit +1 does not fit in 32 trits
+  trit32_t all_ones = 0x5555555555555555ULL;
+
+  trit_add_checked_trit32_t(all_ones, all_ones, &overflow);
+
+  ASSERT (overflow == true);
+}
+
+TEST(TernaryLibrary, UnbalancedRoundTripTest){
+
+  uint32_t binary_num = DeepState_UInt();
+
+  trit32_t balanced = binary_to_balanced_ternary_trit32_t(binary_num);
+  trit32_t unbalanced = binary_to_unbalanced_ternary_trit32_t(binary_num);
+
+  trit32_t to_unbalanced = balanced_ternary_to_unbalanced_ternary_trit32_t(balanced);
+  trit32_t to_balanced = unbalanced_ternary_to_balanced_ternary_trit32_t(unbalanced);
+
+  LOG(TRACE) << "Binary:     " << binary_num;
+  LOG(TRACE) << "Unbalanced: " << unbalanced_ternary_to_binary_uint64_t(to_unbalanced);
+  LOG(TRACE) << "Balanced:   " << balanced_ternary_to_binary_int64_t(to_balanced);
+
+  ASSERT (to_unbalanced == unbalanced);
+  ASSERT (to_balanced == balanced);
+}
+
+TEST(TernaryLibrary, NarrowWidenTest){
+
+  uint32_t binary_num = DeepState_UInt();
+  bool overflow = false;
+
+  trit32_t ternary_num = binary_to_balanced_ternary_trit32_t(binary_num);
+
+  trit16_t narrow = trit_narrow_checked_trit32_t_to_trit16_t(ternary_num, &overflow);
+  trit16_t wrap = trit_narrow_wrap_trit32_t_to_trit16_t(ternary_num);
+
+  // balanced 16 trits hold -21523360 to 21523360, wrapping is mod 3^16
+  int64_t expected = ((int64_t)binary_num + 21523360) % 43046721 - 21523360;
+
+  LOG(TRACE) << "Binary:  " << binary_num;
+  LOG(TRACE) << "Wrapped: " << balanced_ternary_to_binary_int32_t(wrap);
+
+  ASSERT (narrow == wrap);
+  ASSERT (overflow == (binary_num > 21523360));
+  ASSERT (balanced_ternary_to_binary_int32_t(wrap) == expected);
+  ASSERT (trit_widen_trit16_t_to_trit32_t(wrap) == (overflow ? ternary_num & 0xFFFFFFFF : ternary_num));
+
+  trit8_t values[5];
+  trit8_t unpacked[5];
+  trit32_t words[2];
+
+  for(int index = 0; index < 5; index++){
+
+    values[index] = binary_to_balanced_ternary_trit8_t((uint16_t)(DeepState_UShort() % 3281));
+  }
+
+  trit_repack_trit8_t_to_trit32_t(values, 5, words);
+  trit_repack_trit32_t_to_trit8_t(words, 5, unpacked);
+
+  for(int index = 0; index < 5; index++){
+
+    ASSERT (unpacked[index] == values[index]);
+    ASSERT (trit_narrow_wrap_trit32_t_to_trit8_t(words[index / 4] >> (16 * (index % 4))) == values[index]);
+  }
+
+  ASSERT ((words[1] >> 16) == 0);
+}
+
+TEST(TernaryLibrary, Wide64Test){
+
+  __int128 binary_num1 = (__int128)DeepState_Int64() * ((__int128)1 << 32) + DeepState_UInt();
+  __int128 binary_num2 = (__int128)DeepState_Int64() * ((__int128)1 << 32) + DeepState_UInt();
+  bool overflow = true;
+
+  trit64_t ternary_num1 = binary_to_balanced_ternary_trit64_t(binary_num1);
+  trit64_t ternary_num2 = binary_to_balanced_ternary_trit64_t(binary_num2);
+
+  trit64_t ternary_add = trit_add_checked_trit64_t(ternary_num1, ternary_num2, &overflow);
+
+  LOG(TRACE) << "Binary Add:      " << (int64_t)((binary_num1 + binary_num2) >> 32);
+  LOG(TRACE) << "Transformed Add: " << (int64_t)(balanced_ternary_to_binary_int128_t(ternary_add) >> 32);
+
+  ASSERT (overflow == false);
+  ASSERT (balanced_ternary_to_binary_int128_t(ternary_num1) == binary_num1);
+  ASSERT (balanced_ternary_to_binary_int128_t(ternary_add) == binary_num1 + binary_num2);
+  ASSERT (balanced_ternary_to_binary_int128_t(trit_not_trit64_t(ternary_num2)) == -binary_num2);
+
+  trit128_t wide_num1 = binary_to_balanced_ternary_trit128_t(binary_num1);
+  trit128_t wide_num2 = binary_to_balanced_ternary_trit128_t(binary_num2);
+
+  trit128_t wide_sub = trit_sub_checked_trit128_t(wide_num1, wide_num2, &overflow);
+
+  ASSERT (overflow == false);
+  ASSERT (balanced_ternary_to_binary_checked_int128_t(wide_sub, &overflow) == binary_num1 - binary_num2);
+  ASSERT (overflow == false);
+  ASSERT (trit_narrow_checked_trit128_t_to_trit64_t(wide_num1, &overflow) == ternary_num1);
+  ASSERT (overflow == false);
+}
+
+TEST(TernaryLibrary, SumTest){
+
+  trit32_t values[64];
+  int64_t expected = 0;
+  trit_sum_t sum;
+  bool overflow = true;
+
+  trit_sum_init(&sum);
+
+  for(int index = 0; index < 64; index++){
+
+    int64_t binary_num = DeepState_Int();
+    values[index] = signed_trits(binary_num);
+    expected += binary_num;
+    trit_sum_add(&sum, values[index]);
+  }
+
+  trit32_t result = trit_sum_read_trit32_t(&sum, &overflow);
+
+  LOG(TRACE) << "Binary Sum:      " << expected;
+  LOG(TRACE) << "Transformed Sum: " << balanced_ternary_to_binary_int64_t(result);
+
+  ASSERT (overflow == false);
+  ASSERT (balanced_ternary_to_binary_int64_t(result) == expected);
+  ASSERT (trit_sum_array(values, 64, &overflow) == result);
+
+  // more values than one block so the threaded blocks get summed
+  static trit32_t many[150000];
+  uint64_t state = DeepState_UInt64() | 1;
+
+  for(int index = 0; index < 150000; index++){
+
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    many[index] = values[state % 64];
+  }
+
+  trit64_t serial = trit_sum_array(many, 150000, &overflow);
+
+  ASSERT (overflow == false);
+  ASSERT (trit_sum_reduce(many, 150000, 4, &overflow) == serial);
+  ASSERT (overflow == false);
+}
+
+TEST(TernaryLibrary, ScanTest){
+
+  static trit32_t values[10000];
+  static trit32_t inclusive[10000];
+  static trit32_t exclusive[10000];
+  int64_t binary[64];
+  bool overflow[3] = {true, true, true};
+
+  for(int index = 0; index < 64; index++){
+
+    binary[index] = DeepState_Int();
+    values[index] = signed_trits(binary[index]);
+  }
+
+  // three blocks so the block offsets are used
+  for(int index = 64; index < 10000; index++){
+
+    values[index] = values[index % 64];
+  }
+
+  trit_scan_inclusive(values, inclusive, 10000, 2, overflow);
+  trit_scan_exclusive(values, exclusive, 10000, 2, NULL);
+
+  int64_t total = 0;
+
+  for(int index = 0; index < 10000; index++){
+
+    // check the first values and both sides of every block edge
+    bool check = index < 64 || index % TRIT_SCAN_BLOCK < 2 || index % TRIT_SCAN_BLOCK == TRIT_SCAN_BLOCK - 1;
+
+    if(check){
+
+      ASSERT (balanced_ternary_to_binary_int64_t(exclusive[index]) == total);
+    }
+
+    total += binary[index % 64];
+
+    if(check){
+
+      ASSERT (balanced_ternary_to_binary_int64_t(inclusive[index]) == total);
+    }
+  }
+
+  LOG(TRACE) << "Binary Total:      " << total;
+  LOG(TRACE) << "Transformed Total: " << balanced_ternary_to_binary_int64_t(inclusive[9999]);
+
+  ASSERT (overflow[0] == false && overflow[1] == false && overflow[2] == false);
+
+  // the first block cancels out, the rest climbs past 3^32 and wraps
+  const __int128 modulus = (__int128)1853020188851841LL;
+  int64_t big = 100000000000000LL + DeepState_UShort();
+  bool exclusive_overflow[3] = {true, true, true};
+  __int128 exact = 0;
+
+  for(int index = 0; index < 10000; index++){
+
+    values[index] = signed_trits(index < TRIT_SCAN_BLOCK && index % 2 == 1 ? -big : big);
+  }
+
+  trit_scan_inclusive(values, inclusive, 10000, 2, overflow);
+  trit_scan_exclusive(values, exclusive, 10000, 2, exclusive_overflow);
+
+  for(int index = 0; index < 10000; index++){
+
+    __int128 wrapped = 0;
+
+    if(index % 97 == 0 || index % TRIT_SCAN_BLOCK < 2){
+
+      wrapped = (exact + modulus / 2) % modulus - modulus / 2;
+      ASSERT (balanced_ternary_to_binary_int64_t(exclusive[index]) == (int64_t)wrapped);
+    }
+
+    exact += index < TRIT_SCAN_BLOCK && index % 2 == 1 ? -big : big;
+
+    if(index % 97 == 0 || index % TRIT_SCAN_BLOCK < 2){
+
+      wrapped = (exact + modulus / 2) % modulus - modulus / 2;
+      ASSERT (balanced_ternary_to_binary_int64_t(inclusive[index]) == (int64_t)wrapped);
+    }
+  }
+
+  ASSERT (overflow[0] == false && overflow[1] == true && overflow[2] == true);
+  ASSERT (exclusive_overflow[0] == false && exclusive_overflow[1] == true && exclusive_overflow[2] == true);
+}
+
+TEST(TernaryLibrary, HashTest){
+
+  trit32_t keys[64];
+  trit_map_t map;
+  uint64_t value = 0;
+
+  for(int index = 0; index < 64; index++){
+
+    int64_t binary_num = DeepState_Int();
+    keys[index] = signed_trits(binary_num);
+  }
+
+  LOG(TRACE) << "Key:  " << keys[0];
+  LOG(TRACE) << "Hash: " << trit_hash_trit32_t(keys[0]);
+
+  ASSERT (trit_hash_trit16_t((trit16_t)keys[0]) == trit_hash_trit32_t((trit16_t)keys[0]));
+
+  // the streaming hash does not depend on how the words are split
+  trit_hash_state_t state;
+  trit_hash_init(&state, 7);
+  trit_hash_update(&state, keys, 3);
+  trit_hash_update(&state, keys + 3, 50);
+  trit_hash_update(&state, keys + 53, 11);
+
+  ASSERT (trit_hash_final(&state) == trit_hash_array(keys, 64, 7));
+
+  ASSERT (trit_map_init(&map, 4));
+  for(int index = 0; index < 64; index++){
+
+    ASSERT (trit_map_put(&map, keys[index], index));
+  }
+  for(int index = 0; index < 64; index += 2){
+
+    trit_map_remove(&map, keys[index]);
+  }
+  for(int index = 0; index < 64; index++){
+
+    // a key repeated later in the array keeps the later value
+    int last = index;
+
+    for(int later = index + 1; later < 64; later++){
+
+      if(keys[later] == keys[index]){
+
+        last = later;
+      }
+    }
+
+    bool found = trit_map_get(&map, keys[index], &value);
+    bool removed = false;
+
+    for(int other = 0; other < 64; other += 2){
+
+      removed = removed || keys[other] == keys[index];
+    }
+
+    ASSERT (found == !removed);
+    ASSERT (!found || value == (uint64_t)last);
+  }
+
+  // a freed map has no slots, nothing is found and nothing is added
+  trit_map_free(&map);
+  ASSERT (!trit_map_get(&map, keys[1], &value));
+  ASSERT (!trit_map_remove(&map, keys[1]));
+  ASSERT (!trit_map_put(&map, keys[1], 1));
+  ASSERT (!trit_map_init(&map, SIZE_MAX / 2 + 1));
+}
+
+TEST(TernaryLibrary, MultiplyTest){
+
+  int32_t binary_num1 = DeepState_Int();
+  int32_t binary_num2 = DeepState_Int();
+  bool overflow = true;
+
+  trit32_t ternary_num1 = signed_trits(binary_num1);
+  trit32_t ternary_num2 = signed_trits(binary_num2);
+
+  trit64_t product = trit_mul_wide_trit32_t(ternary_num1, ternary_num2);
+  __int128 transformed = balanced_ternary_to_binary_checked_int128_t(trit_widen_trit64_t_to_trit128_t(product), &overflow);
+
+  LOG(TRACE) << "Binary Product:      " << (int64_t)binary_num1 * binary_num2;
+  LOG(TRACE) << "Transformed Product: " << (int64_t)transformed;
+
+  ASSERT (overflow == false);
+  ASSERT (transformed == (__int128)binary_num1 * binary_num2);
+
+  // 16 bit factors keep the product in 32 trits
+  trit32_t small1 = trit_sr_trit32_t(ternary_num1, 12);
+  trit32_t small2 = trit_sr_trit32_t(ternary_num2, 12);
+  trit32_t narrow = trit_mul_checked_trit32_t(small1, small2, &overflow);
+
+  ASSERT (overflow == false);
+  ASSERT (balanced_ternary_to_binary_int64_t(narrow) == balanced_ternary_to_binary_int64_t(small1) * balanced_ternary_to_binary_int64_t(small2));
+  ASSERT (trit_mul_wide_trit16_t((trit16_t)small1, (trit16_t)small2) == narrow);
+  ASSERT (trit_mul_checked_trit32_t(ternary_num1, ternary_num2, &overflow) == (trit32_t)product);
+  ASSERT (overflow == ((product >> 64) != 0));
+}
+
+TEST(TernaryLibrary, FixedTest){
+
+  // 24 bit values so the products fit in 32 trits
+  int32_t binary_num1 = DeepState_Int() >> 8;
+  int32_t binary_num2 = DeepState_Int() >> 8;
+  int frac = DeepState_IntInRange(0, 20);
+  bool overflow = true;
+  double scale = 1;
+
+  for(int index = 0; index < frac; index++){
+
+    scale *= 3;
+  }
+
+  trit32_t a = trit_fix_from_double(binary_num1 / scale, frac, &overflow);
+  ASSERT (overflow == false);
+  trit32_t b = trit_fix_from_double(binary_num2 / scale, frac, &overflow);
+  ASSERT (overflow == false);
+  ASSERT (balanced_ternary_to_binary_int64_t(a) == binary_num1);
+  ASSERT (trit_fix_to_double(a, frac) == binary_num1 / scale);
+
+  // the product rounds to the nearest value, which the balanced remainder gives exactly
+  __int128 exact = (__int128)binary_num1 * binary_num2;
+  __int128 power = (__int128)scale;
+  __int128 remainder = exact % power;
+
+  if(2 * remainder > power){
+
+    remainder -= power;
+  }
+  else if(2 * remainder < -power){
+
+    remainder += power;
+  }
+
+  trit32_t product = trit_fix_mul(a, b, frac, &overflow);
+
+  LOG(TRACE) << "Binary Product:      " << (int64_t)((exact - remainder) / power);
+  LOG(TRACE) << "Transformed Product: " << balanced_ternary_to_binary_int64_t(product);
+
+  ASSERT (overflow == false);
+  ASSERT (balanced_ternary_to_binary_int64_t(product) == (int64_t)((exact - remainder) / power));
+
+  if(binary_num2 != 0){
+
+    double quotient = trit_fix_to_double(trit_fix_div(a, b, frac, &overflow), frac);
+
+    ASSERT (overflow == false);
+    ASSERT (fabs(quotient - (double)binary_num1 / binary_num2) <= 0.5 / scale * 1.000001);
+  }
+
+  // the AVX2 and scalar array kernels agree
+  double values[7];
+  trit32_t scalar[7];
+  trit32_t vector[7];
+  double back[7];
+  bool vector_overflow = true;
+
+  for(int index = 0; index < 7; index++){
+
+    values[index] = (binary_num1 + index * (double)binary_num2) / scale / 7;
+  }
+
+  trit_fix_from_double_scalar(values, scalar, 7, frac, &overflow);
+  trit_fix_from_double_array(values, vector, 7, frac, &vector_overflow);
+  ASSERT (overflow == vector_overflow);
+  trit_fix_to_double_array(vector, back, 7, frac);
+
+  for(int index = 0; index < 7; index++){
+
+    ASSERT (scalar[index] == vector[index]);
+    ASSERT (back[index] == trit_fix_to_double(scalar[index], frac));
+  }
+
+  typedef tritfix<10, 10> fix;
+
+  fix x(13.0 / 3);
+  fix y(-20.0 / 9);
+
+  ASSERT (x * y == fix(-260.0 / 27));
+  ASSERT (x + y == fix(19.0 / 9));
+  ASSERT (x / y == fix(-39.0 / 20));
+  ASSERT (x > y && y < x && -x == fix(-13.0 / 3));
+  ASSERT ((x.rescale<12, 8>().to_double()) == 13.0 / 3);
+
+  // the checked members report overflow without touching errno
+  overflow = true;
+  fix big = fix::checked_from_double(29000.0, &overflow);
+
+  ASSERT (!overflow);
+  ASSERT (x.checked_mul(y, &overflow) == x * y && !overflow);
+  ASSERT (x.checked_sub(y, &overflow) == x - y && !overflow);
+  ASSERT (x.checked_div(y, &overflow) == x / y && !overflow);
+  ASSERT (x.checked_shift(-2, &overflow) == x.shift(-2) && !overflow);
+
+  errno = 0;
+  big.checked_add(big, &overflow);
+  ASSERT (overflow && errno == 0);
+  big.checked_mul(big, &overflow);
+  ASSERT (overflow && errno == 0);
+  big.checked_shift(1, &overflow);
+  ASSERT (overflow && errno == 0);
+  fix::checked_from_double(1e10, &overflow);
+  ASSERT (overflow && errno == 0);
+  big.checked_rescale<8, 12>(&overflow);
+  ASSERT (overflow && errno == 0);
+  x.checked_div(fix(), &overflow);
+  ASSERT (overflow && errno == 0);
+
+  // the operators keep setting errno
+  big = big + big;
+  ASSERT (errno == EOVERFLOW);
+}
+
+TEST(TernaryLibrary, FloatTest){
+
+  int32_t binary_num1 = DeepState_Int();
+  int32_t binary_num2 = DeepState_Int();
+  int16_t binary_num3 = (int16_t)DeepState_Short();
+  int shift = DeepState_IntInRange(-60, 60);
+
+  trit_float_t a = trit_float_from_double(binary_num1);
+  trit_float_t b = trit_float_from_double(binary_num2);
+  trit_float_t c = trit_float_from_double(binary_num3);
+
+  ASSERT (trit_float_to_double(a) == binary_num1);
+  ASSERT (trit_float_to_double(b) == binary_num2);
+
+  // sums of whole numbers below 3^31 and square roots of squares are exact
+  ASSERT (trit_float_to_double(trit_float_add(a, b)) == (double)binary_num1 + binary_num2);
+  ASSERT (trit_float_to_double(trit_float_sub(a, b)) == (double)binary_num1 - binary_num2);
+  ASSERT (trit_float_to_double(trit_float_sqrt(trit_float_mul(c, c))) == abs(binary_num3));
+  ASSERT (trit_float_sub(a, a).significand == 0);
+  ASSERT (trit_float_compare(a, b) == (binary_num1 > binary_num2) - (binary_num1 < binary_num2));
+
+  // other results are within half a unit in the last trit of the exact value
+  trit_float_t d = trit_float_mul(b, trit_float_from_double(powl(3, shift)));
+  trit_float_t results[4] = {trit_float_mul(a, b), trit_float_add(a, d), trit_float_div(a, b), trit_float_sqrt(a)};
+  long double exact[4] = {(long double)binary_num1 * binary_num2, binary_num1 + binary_num2 * powl(3, shift),
+                          (long double)binary_num1 / binary_num2, sqrtl(binary_num1)};
+
+  for(int index = 0; index < 4; index++){
+
+    if(binary_num1 == 0 || binary_num2 == 0 || (index == 3 && binary_num1 < 0)){
+
+      continue;
+    }
+
+    long double error = fabsl(trit_float_to_double(results[index]) - exact[index]);
+    long double unit = powl(3, trit_float_exponent(results[index]) - (TRIT_FLOAT_SIG_TRITS - 1));
+
+    LOG(TRACE) << "Operation: " << index << " Error: " << (double)(error / unit);
+
+    ASSERT (error <= unit * 0.5 + fabsl(exact[index]) * 2e-16);
+  }
+
+  // the batch path gives the same results
+  trit_float_t left[3] = {a, b, c};
+  trit_float_t right[3] = {b, c, a};
+  trit_float_t products[3];
+
+  int status = -1;
+
+  trit_float_mul_array(left, right, products, 3, 1, &status);
+  ASSERT (status == 0);
+
+  for(int index = 0; index < 3; index++){
+
+    trit_float_t product = trit_float_mul(left[index], right[index]);
+
+    ASSERT (products[index].significand == product.significand && products[index].exponent == product.exponent);
+  }
+
+  // errors come back as a status, a batch ORs them over every chunk
+  // 1e300 is about 3^629, squaring it twice gives about 3^2516
+  trit_float_t huge = trit_float_from_double_checked(1e300, &status);
+  ASSERT (status == 0);
+  huge = trit_float_mul_checked(huge, huge, &status);
+  ASSERT (status == 0);
+  huge = trit_float_mul_checked(huge, huge, &status);
+  ASSERT (status == 0 && trit_float_exponent(huge) > TRIT_FLOAT_EXP_MAX / 2);
+  trit_float_t zero = trit_float_sub_checked(a, a, &status);
+  ASSERT (status == 0);
+
+  trit_float_mul_checked(huge, huge, &status);
+  ASSERT (status == TRIT_FLOAT_RANGE);
+  trit_float_div_checked(zero, zero, &status);
+  ASSERT (status == TRIT_FLOAT_DOMAIN);
+  trit_float_sqrt_checked(trit_float_from_double(-1.0), &status);
+  ASSERT (status == TRIT_FLOAT_DOMAIN);
+  trit_float_from_double_checked(NAN, &status);
+  ASSERT (status == TRIT_FLOAT_DOMAIN);
+
+  static trit_float_t dividends[10000];
+  static trit_float_t divisors[10000];
+  static trit_float_t quotients[10000];
+
+  for(int index = 0; index < 10000; index++){
+
+    dividends[index] = trit_float_from_double(1.0);
+    divisors[index] = trit_float_from_double(3.0);
+  }
+
+  trit_float_div_array(dividends, divisors, quotients, 10000, 2, &status);
+  ASSERT (status == 0);
+
+  // 1 / 0 in the last chunk and 0 / 0 in the first
+  divisors[9999] = zero;
+  dividends[5] = zero;
+  divisors[5] = zero;
+  trit_float_div_array(dividends, divisors, quotients, 10000, 2, &status);
+  ASSERT (status == (TRIT_FLOAT_RANGE | TRIT_FLOAT_DOMAIN));
+
+  dividends[0] = huge;
+  divisors[0] = huge;
+  trit_float_mul_array(dividends, divisors, quotients, 10000, 2, &status);
+  ASSERT (status == TRIT_FLOAT_RANGE);
+}
+
+TEST(TernaryLibrary, ModTest){
+
+  // a modulus up to 2^40 that is not a multiple of 3
+  uint64_t modulus = (DeepState_UInt64() >> 24) | 2;
+  modulus += modulus % 3 == 0;
+  uint64_t binary_num1 = DeepState_UInt64() % modulus;
+  uint64_t binary_num2 = DeepState_UInt64() % modulus;
+  uint32_t exponent = DeepState_UInt();
+
+  trit32_t m = binary_to_balanced_ternary_trit32_t(modulus);
+  trit32_t a = binary_to_balanced_ternary_trit32_t(binary_num1);
+  trit32_t b = binary_to_balanced_ternary_trit32_t(binary_num2);
+
+  uint64_t expected = (uint64_t)((unsigned __int128)binary_num1 * binary_num2 % modulus);
+  uint64_t power = 1 % modulus;
+
+  for(uint64_t base = binary_num1, bits = exponent; bits; bits >>= 1){
+
+    if(bits & 1){
+
+      power = (uint64_t)((unsigned __int128)power * base % modulus);
+    }
+
+    base = (uint64_t)((unsigned __int128)base * base % modulus);
+  }
+
+  LOG(TRACE) << "Binary Product:      " << expected;
+  LOG(TRACE) << "Transformed Product: " << balanced_ternary_to_binary_int64_t(trit_mulmod_trit32_t(a, b, m));
+
+  ASSERT (balanced_ternary_to_binary_int64_t(trit_addmod_trit32_t(a, b, m)) == (int64_t)((binary_num1 + binary_num2) % modulus));
+  ASSERT (balanced_ternary_to_binary_int64_t(trit_mulmod_trit32_t(a, b, m)) == (int64_t)expected);
+  ASSERT (balanced_ternary_to_binary_int64_t(trit_powmod_trit32_t(a, binary_to_balanced_ternary_trit32_t(exponent), m)) == (int64_t)power);
+
+  // the 64 trit versions agree on the same values
+  trit64_t m64 = trit_widen_trit32_t_to_trit64_t(m);
+  trit64_t a64 = trit_widen_trit32_t_to_trit64_t(a);
+  trit64_t b64 = trit_widen_trit32_t_to_trit64_t(b);
+
+  ASSERT (trit_addmod_trit64_t(a64, b64, m64) == trit_widen_trit32_t_to_trit64_t(trit_addmod_trit32_t(a, b, m)));
+  ASSERT (trit_mulmod_trit64_t(a64, b64, m64) == binary_to_balanced_ternary_trit64_t(expected));
+  ASSERT (trit_powmod_trit64_t(a64, binary_to_balanced_ternary_trit64_t(exponent), m64) == binary_to_balanced_ternary_trit64_t(power));
+
+  trit_mont32_t mont;
+
+  ASSERT (trit_mont_init_trit32_t(&mont, m));
+  ASSERT (trit_mont_out_trit32_t(&mont, trit_mont_mul_trit32_t(&mont, trit_mont_in_trit32_t(&mont, a), trit_mont_in_trit32_t(&mont, b))) == binary_to_balanced_ternary_trit32_t(expected));
+  ASSERT (!trit_mont_init_trit32_t(&mont, binary_to_balanced_ternary_trit32_t(modulus * 3)));
+}
+
+TEST(TernaryLibrary, WrapTest){
+
+  int32_t binary_num1 = DeepState_Int();
+  int32_t binary_num2 = DeepState_Int();
+  bool overflow = false;
+
+  trit32_t a = signed_trits(binary_num1);
+  trit32_t b = signed_trits(binary_num2);
+
+  // the wrapped result is the low trits of the exact one
+  trit64_t product = trit_mul_wide_trit32_t(a, b);
+
+  LOG(TRACE) << "Binary Product:      " << (int64_t)binary_num1 * binary_num2;
+  LOG(TRACE) << "Transformed Product: " << balanced_ternary_to_binary_int64_t(trit_mul_wrap_trit32_t(a, b));
+
+  ASSERT (trit_mul_wrap_trit32_t(a, b) == (trit32_t)product);
+  ASSERT (trit_mul_wrap_trit16_t((trit16_t)a, (trit16_t)b) == (trit16_t)trit_mul_wide_trit16_t((trit16_t)a, (trit16_t)b));
+  ASSERT (trit_mul_wrap_trit8_t((trit8_t)a, (trit8_t)b) == (trit8_t)trit_mul_wide_trit8_t((trit8_t)a, (trit8_t)b));
+  ASSERT (trit_add_wrap_trit32_t(a, b) == trit_add_checked_trit32_t(a, b, &overflow));
+  ASSERT (trit_sub_wrap_trit32_t(a, b) == trit_sub_checked_trit32_t(a, b, &overflow));
+  ASSERT (trit_add_wrap_trit16_t((trit16_t)a, (trit16_t)b) == trit_add_checked_trit16_t((trit16_t)a, (trit16_t)b, &overflow));
+  ASSERT (trit_sub_wrap_trit8_t((trit8_t)a, (trit8_t)b) == trit_sub_checked_trit8_t((trit8_t)a, (trit8_t)b, &overflow));
+
+  // the top trits of a wide product make the 64 and 128 trit sums wrap
+  trit64_t wide = trit_sl_trit64_t(product, 30);
+  trit128_t square = trit_mul_wide_trit64_t(wide, wide);
+  trit128_t wide128 = trit_widen_trit64_t_to_trit128_t(wide);
+
+  ASSERT (trit_mul_wrap_trit64_t(wide, wide) == square.low);
+  ASSERT (trit_mul_wrap_trit128_t(wide128, wide128).low == square.low);
+  ASSERT (trit_mul_wrap_trit128_t(wide128, wide128).high == square.high);
+  ASSERT (trit_add_wrap_trit64_t(wide, wide) == trit_add_checked_trit64_t(wide, wide, &overflow));
+  ASSERT (trit_sub_wrap_trit64_t(wide, product) == trit_sub_checked_trit64_t(wide, product, &overflow));
+  ASSERT (trit_add_wrap_trit128_t(square, square).high == trit_add_checked_trit128_t(square, square, &overflow).high);
+  ASSERT (trit_sub_wrap_trit128_t(square, wide128).low == trit_sub_checked_trit128_t(square, wide128, &overflow).low);
+}
+
+// balanced words of the width of T from seed, every other one only uses its low half of trits
+template<typename T>
+static void sat_words(T *words, size_t count, uint64_t seed){
+
+  for(size_t index = 0; index < count; index++){
+
+    uint64_t bits = (seed + index) * 0x9E3779B97F4A7C15ULL;
+
+    bits ^= bits >> 29;
+    bits &= ~(((bits >> 1) & ~bits & 0x5555555555555555ULL) << 1);
+
+    words[index] = (T)(index % 2 ? bits & ((T)~(T)0 >> (sizeof(T) * 4)) : bits);
+  }
+
+  // all +1 and all -1 saturate whatever they meet
+  words[0] = (T)0x5555555555555555ULL;
+  words[1] = (T)0xFFFFFFFFFFFFFFFFULL;
+}
+
+// runs an array kernel and checks every value against the per-value function
+#define CHECK_SAT_KERNEL(kernel, single, a, b, out, count)       \
+  do {                                                          \
+    kernel(a, b, out, count);                                   \
+    for(size_t index = 0; index < count; index++){              \
+      ASSERT (out[index] == single(a[index], b[index]));        \
+    }                                                           \
+  } while(0)
+
+TEST(TernaryLibrary, SatTest){
+
+  int32_t binary_num1 = DeepState_Int();
+  int32_t binary_num2 = DeepState_Int();
+  bool overflow = false;
+
+  trit32_t a = signed_trits(binary_num1);
+  trit32_t b = signed_trits(binary_num2);
+
+  // a result that fits is the plain one, one that does not is all +1 or all -1
+  trit16_t a16 = (trit16_t)a;
+  trit16_t b16 = (trit16_t)b;
+  int64_t sum16 = (int64_t)balanced_ternary_to_binary_int32_t(a16) + balanced_ternary_to_binary_int32_t(b16);
+  trit16_t expected16 = sum16 > 21523360 ? 0x55555555 : sum16 < -21523360 ? 0xFFFFFFFF : trit_add_wrap_trit16_t(a16, b16);
+
+  LOG(TRACE) << "Binary Sum:      " << sum16;
+  LOG(TRACE) << "Transformed Sum: " << balanced_ternary_to_binary_int32_t(trit_add_sat_trit16_t(a16, b16));
+
+  ASSERT (trit_add_sat_trit16_t(a16, b16) == expected16);
+  ASSERT (trit_sub_sat_trit16_t(a16, trit_not_trit16_t(b16)) == expected16);
+  ASSERT (trit_add_sat_trit32_t(a, b) == trit_add_checked_trit32_t(a, b, &overflow));
+  ASSERT (trit_sub_sat_trit32_t(a, b) == trit_sub_checked_trit32_t(a, b, &overflow));
+
+  trit32_t product = trit_mul_checked_trit32_t(a, b, &overflow);
+  trit32_t clamp = (binary_num1 < 0) != (binary_num2 < 0) ? 0xFFFFFFFFFFFFFFFFULL : 0x5555555555555555ULL;
+
+  ASSERT (trit_mul_sat_trit32_t(a, b) == (overflow ? clamp : product));
+
+  trit8_t a8 = (trit8_t)a;
+  trit8_t b8 = (trit8_t)b;
+  int64_t product8 = (int64_t)balanced_ternary_to_binary_int16_t(a8) * balanced_ternary_to_binary_int16_t(b8);
+  trit8_t expected8 = product8 > 3280 ? 0x5555 : product8 < -3280 ? 0xFFFF : trit_mul_wrap_trit8_t(a8, b8);
+
+  ASSERT (trit_mul_sat_trit8_t(a8, b8) == expected8);
+
+  // the vector kernels agree with the scalar functions
+  trit32_t words[5] = {a, b, trit_add_sat_trit32_t(a, a), 0x5555555555555555ULL, 0xFFFFFFFFFFFFFFFFULL};
+  trit32_t others[5] = {b, a, 0x5555555555555555ULL, a, b};
+  trit32_t results[5];
+
+  trit_add_sat_array_trit32_t(words, others, results, 5);
+  for(int index = 0; index < 5; index++){
+
+    ASSERT (results[index] == trit_add_sat_trit32_t(words[index], others[index]));
+  }
+  trit_sub_sat_array_trit32_t(words, others, results, 5);
+  for(int index = 0; index < 5; index++){
+
+    ASSERT (results[index] == trit_sub_sat_trit32_t(words[index], others[index]));
+  }
+
+  // 37 values fill a vector of every width and leave a tail
+  const size_t count = 37;
+  trit8_t left8[count], right8[count], out8[count];
+  trit16_t left16[count], right16[count], out16[count];
+  trit32_t left32[count], right32[count], out32[count];
+
+  sat_words(left8, count, DeepState_UInt64());
+  sat_words(right8, count, DeepState_UInt64());
+  sat_words(left16, count, DeepState_UInt64());
+  sat_words(right16, count, DeepState_UInt64());
+  sat_words(left32, count, DeepState_UInt64());
+  sat_words(right32, count, DeepState_UInt64());
+
+  CHECK_SAT_KERNEL(trit_add_sat_array_trit8_t, trit_add_sat_trit8_t, left8, right8, out8, count);
+  CHECK_SAT_KERNEL(trit_add_sat_scalar_trit8_t, trit_add_sat_trit8_t, left8, right8, out8, count);
+  CHECK_SAT_KERNEL(trit_sub_sat_array_trit8_t, trit_sub_sat_trit8_t, left8, right8, out8, count);
+  CHECK_SAT_KERNEL(trit_sub_sat_scalar_trit8_t, trit_sub_sat_trit8_t, left8, right8, out8, count);
+  CHECK_SAT_KERNEL(trit_mul_sat_array_trit8_t, trit_mul_sat_trit8_t, left8, right8, out8, count);
+
+  CHECK_SAT_KERNEL(trit_add_sat_array_trit16_t, trit_add_sat_trit16_t, left16, right16, out16, count);
+  CHECK_SAT_KERNEL(trit_add_sat_scalar_trit16_t, trit_add_sat_trit16_t, left16, right16, out16, count);
+  CHECK_SAT_KERNEL(trit_sub_sat_array_trit16_t, trit_sub_sat_trit16_t, left16, right16, out16, count);
+  CHECK_SAT_KERNEL(trit_sub_sat_scalar_trit16_t, trit_sub_sat_trit16_t, left16, right16, out16, count);
+  CHECK_SAT_KERNEL(trit_mul_sat_array_trit16_t, trit_mul_sat_trit16_t, left16, right16, out16, count);
+
+  CHECK_SAT_KERNEL(trit_add_sat_array_trit32_t, trit_add_sat_trit32_t, left32, right32, out32, count);
+  CHECK_SAT_KERNEL(trit_add_sat_scalar_trit32_t, trit_add_sat_trit32_t, left32, right32, out32, count);
+  CHECK_SAT_KERNEL(trit_sub_sat_array_trit32_t, trit_sub_sat_trit32_t, left32, right32, out32, count);
+  CHECK_SAT_KERNEL(trit_sub_sat_scalar_trit32_t, trit_sub_sat_trit32_t, left32, right32, out32, count);
+  CHECK_SAT_KERNEL(trit_mul_sat_array_trit32_t, trit_mul_sat_trit32_t, left32, right32, out32, count);
+
+#ifdef TERNARY_X86_64
+  if(trit_cpu_avx2()){
+
+    CHECK_SAT_KERNEL(trit_add_sat_avx2_trit8_t, trit_add_sat_trit8_t, left8, right8, out8, count);
+    CHECK_SAT_KERNEL(trit_sub_sat_avx2_trit8_t, trit_sub_sat_trit8_t, left8, right8, out8, count);
+    CHECK_SAT_KERNEL(trit_add_sat_avx2_trit16_t, trit_add_sat_trit16_t, left16, right16, out16, count);
+    CHECK_SAT_KERNEL(trit_sub_sat_avx2_trit16_t, trit_sub_sat_trit16_t, left16, right16, out16, count);
+    CHECK_SAT_KERNEL(trit_add_sat_avx2_trit32_t, trit_add_sat_trit32_t, left32, right32, out32, count);
+    CHECK_SAT_KERNEL(trit_sub_sat_avx2_trit32_t, trit_sub_sat_trit32_t, left32, right32, out32, count);
+  }
+#endif
+}
+
+TEST(TernaryLibrary, CarryTest){
+
+  int32_t binary_num1 = DeepState_Int();
+  int32_t binary_num2 = DeepState_Int();
+  int carry_in = (int)(DeepState_UInt() % 3) - 1;
+  int carry = 0;
+  int borrow = 0;
+  bool overflow = false;
+
+  trit32_t a = signed_trits(binary_num1);
+  trit32_t b = signed_trits(binary_num2);
+
+  // the 8 trit sum and carry give back the exact binary sum
+  trit8_t sum8 = trit_adc_trit8_t((trit8_t)a, (trit8_t)b, carry_in, &carry);
+  int64_t exact8 = (int64_t)balanced_ternary_to_binary_int16_t((trit8_t)a) + balanced_ternary_to_binary_int16_t((trit8_t)b) + carry_in;
+
+  LOG(TRACE) << "Binary Sum:      " << exact8;
+  LOG(TRACE) << "Transformed Sum: " << balanced_ternary_to_binary_int16_t(sum8) + carry * 6561;
+
+  ASSERT (balanced_ternary_to_binary_int16_t(sum8) + carry * 6561 == exact8);
+
+  trit8_t diff8 = trit_sbb_trit8_t((trit8_t)a, (trit8_t)b, carry_in, &borrow);
+  exact8 = (int64_t)balanced_ternary_to_binary_int16_t((trit8_t)a) - balanced_ternary_to_binary_int16_t((trit8_t)b) - carry_in;
+
+  ASSERT (balanced_ternary_to_binary_int16_t(diff8) - borrow * 6561 == exact8);
+
+  // chained words match the wide adders
+  trit64_t wide_a = trit_mul_wide_trit32_t(a, a);
+  trit64_t wide_b = trit_mul_wide_trit32_t(b, a);
+  trit32_t low = trit_adc_trit32_t((trit32_t)wide_a, (trit32_t)wide_b, 0, &carry);
+  trit32_t high = trit_adc_trit32_t((trit32_t)(wide_a >> 64), (trit32_t)(wide_b >> 64), carry, &carry);
+  trit64_t sum64 = trit_add_checked_trit64_t(wide_a, wide_b, &overflow);
+
+  ASSERT (low == (trit32_t)sum64 && high == (trit32_t)(sum64 >> 64) && carry == 0);
+
+  low = trit_sbb_trit32_t((trit32_t)wide_a, (trit32_t)wide_b, 0, &borrow);
+  high = trit_sbb_trit32_t((trit32_t)(wide_a >> 64), (trit32_t)(wide_b >> 64), borrow, &borrow);
+  sum64 = trit_sub_checked_trit64_t(wide_a, wide_b, &overflow);
+
+  ASSERT (low == (trit32_t)sum64 && high == (trit32_t)(sum64 >> 64) && borrow == 0);
+
+  trit128_t wide128 = trit_widen_trit64_t_to_trit128_t(sum64);
+  trit128_t sum128 = trit_adc_trit128_t(wide128, wide128, carry_in, &carry);
+  trit64_t sum_low = trit_adc_trit64_t(sum64, sum64, carry_in, &carry);
+
+  ASSERT (sum128.low == sum_low);
+  ASSERT (trit_sbb_trit128_t(sum128, wide128, carry_in, &borrow).low == trit_sbb_trit64_t(sum_low, sum64, carry_in, &borrow));
+  ASSERT (trit_adc_trit16_t((trit16_t)a, (trit16_t)b, 0, &carry) == trit_add_wrap_trit16_t((trit16_t)a, (trit16_t)b));
+}
+
+TEST(TernaryLibrary, LutTest){
+
+  int32_t binary_num1 = DeepState_Int();
+  int32_t binary_num2 = DeepState_Int();
+  uint32_t function = DeepState_UInt() % 19683;
+
+  trit32_t a = signed_trits(binary_num1);
+  trit32_t b = signed_trits(binary_num2);
+
+  // the hand written gates as tables
+  const int8_t and_table[9] = {-1, -1, -1, -1, 0, 0, -1, 0, 1};
+  const int8_t or_table[9] = {-1, -1, 1, -1, 0, 1, 1, 1, 1};
+  const int8_t xor_table[9] = {-1, 0, 1, 0, -1, 0, 1, 0, -1};
+  trit_lut2_t lut;
+
+  ASSERT (trit_lut2_compile(&lut, and_table));
+  ASSERT (trit_lut2_trit32_t(&lut, a, b) == trit_and_trit32_t(a, b));
+  ASSERT (trit_lut2_compile(&lut, or_table));
+  ASSERT (trit_lut2_trit32_t(&lut, a, b) == trit_or_trit32_t(a, b));
+  ASSERT (trit_lut2_trit16_t(&lut, (trit16_t)a, (trit16_t)b) == trit_or_trit16_t((trit16_t)a, (trit16_t)b));
+  ASSERT (trit_lut2_compile(&lut, xor_table));
+  ASSERT (trit_lut2_trit32_t(&lut, a, b) == trit_xor_trit32_t(a, b));
+  ASSERT (trit_lut2_trit8_t(&lut, (trit8_t)a, (trit8_t)b) == trit_xor_trit8_t((trit8_t)a, (trit8_t)b));
+
+  // any table comes back out of its compiled form
+  int8_t table[9];
+  for(int index = 0; index < 9; index++){
+
+    table[index] = (int8_t)(function % 3) - 1;
+    function /= 3;
+  }
+
+  LOG(TRACE) << "Table: " << (int)table[0] << (int)table[1] << (int)table[2] << (int)table[3] << (int)table[4]
+             << (int)table[5] << (int)table[6] << (int)table[7] << (int)table[8];
+
+  ASSERT (trit_lut2_compile(&lut, table));
+  for(int index = 0; index < 9; index++){
+
+    ASSERT (trit_lut2_eval(&lut, index / 3 - 1, index % 3 - 1) == table[index]);
+  }
+
+  trit32_t words[5] = {a, b, trit_and_trit32_t(a, b), 0x5555555555555555ULL, 0xFFFFFFFFFFFFFFFFULL};
+  trit32_t others[5] = {b, a, 0, a, b};
+  trit32_t results[5];
+
+  trit_lut2_array(&lut, words, others, results, 5);
+  for(int index = 0; index < 5; index++){
+
+    ASSERT (results[index] == trit_lut2_trit32_t(&lut, words[index], others[index]));
+  }
+
+  table[4] = 2;
+  ASSERT (!trit_lut2_compile(&lut, table));
+}
+
+TEST(TernaryLibrary, KleeneTest){
+
+  int32_t binary_num1 = DeepState_Int();
+  int32_t binary_num2 = DeepState_Int();
+  size_t rows = 1 + DeepState_UInt() % 200;
+
+  trit32_t a = signed_trits(binary_num1);
+  trit32_t b = signed_trits(binary_num2);
+
+  // columns of up to 200 rows, with a block of FALSE to skip
+  trit32_t left[7] = {a, b, 0xFFFFFFFFFFFFFFFFULL, trit_not_trit32_t(a), 0, b, a};
+  trit32_t right[7] = {b, a, a, 0x5555555555555555ULL, a, trit_not_trit32_t(b), 0};
+  const trit32_t *columns[2] = {left, right};
+  trit_kleene_node_t nodes[5] = {{TRIT_KLEENE_COLUMN, 0, 0}, {TRIT_KLEENE_COLUMN, 1, 0},
+                                 {TRIT_KLEENE_AND, 0, 1}, {TRIT_KLEENE_IS_UNKNOWN, 1, 0}, {TRIT_KLEENE_OR, 2, 3}};
+  trit32_t out[7];
+  uint64_t selection[4];
+  size_t count = trit_kleene_eval(nodes, 4, columns, rows, out, selection);
+  size_t expected = 0;
+
+  LOG(TRACE) << "Rows:          " << rows;
+  LOG(TRACE) << "Selected Rows: " << count;
+
+  for(size_t row = 0; row < rows; row++){
+
+    // codes 00, 01 and 11 are 0, 1 and -1
+    int shift = 2 * (row % 32);
+    int x = (int)((left[row / 32] >> shift) & 3);
+    int y = (int)((right[row / 32] >> shift) & 3);
+    int got = (int)((out[row / 32] >> shift) & 3);
+    int result = 0;
+
+    x = x == 3 ? -1 : x;
+    y = y == 3 ? -1 : y;
+    got = got == 3 ? -1 : got;
+    result = y == 0 ? 1 : (x < y ? x : y);
+    expected += result == 1;
+
+    ASSERT (got == result);
+    ASSERT (((selection[row / 64] >> (row % 64)) & 1) == (uint64_t)(result == 1));
+  }
+  ASSERT (count == expected);
+
+  // the vector and scalar kernels agree
+  trit32_t scalar[7];
+  trit32_t vector[7];
+  for(int op = TRIT_KLEENE_AND; op <= TRIT_KLEENE_IS_UNKNOWN; op++){
+
+    trit_kleene_apply_scalar((trit_kleene_op_t)op, left, right, scalar, 7);
+    trit_kleene_apply((trit_kleene_op_t)op, left, right, vector, 7);
+    for(int index = 0; index < 7; index++){
+
+      ASSERT (scalar[index] == vector[index]);
+    }
+  }
+}
+
+TEST(TernaryLibrary, TcamTest){
+
+  uint32_t key = DeepState_UInt();
+  uint32_t pattern = DeepState_UInt();
+  size_t id = 0;
+  trit_tcam_t tcam;
+
+  ASSERT (trit_tcam_init(&tcam, 32, 4));
+
+  // rule i requires the low i + 1 bits of pattern, priorities rise with i
+  for(int index = 0; index < 300; index++){
+
+    int length = index % 32;
+    trit32_t rule = 0;
+
+    for(int bit = 0; bit <= length; bit++){
+
+      rule |= (trit32_t)((pattern >> bit) & 1 ? 1 : 3) << (2 * bit);
+    }
+    ASSERT (trit_tcam_insert_trit32_t(&tcam, rule, length));
+  }
+
+  // the longest prefix of pattern the key shares wins, first inserted on a tie
+  int shared = 0;
+  while(shared < 32 && ((key ^ pattern) >> shared & 1) == 0){
+
+    shared++;
+  }
+
+  LOG(TRACE) << "Shared Bits: " << shared;
+
+  if(shared == 0){
+
+    ASSERT (!trit_tcam_lookup(&tcam, key, &id));
+  }
+  else{
+
+    ASSERT (trit_tcam_lookup(&tcam, key, &id));
+    LOG(TRACE) << "Rule:        " << id;
+    ASSERT (id == (size_t)(shared - 1));
+  }
+
+  // a don't care rule matches everything but loses to the prefixes
+  ASSERT (trit_tcam_insert_trit32_t(&tcam, 0, -1));
+  ASSERT (trit_tcam_lookup(&tcam, ~pattern, &id) && id == 300);
+
+  uint64_t keys[3] = {key, pattern, ~(uint64_t)pattern};
+  size_t ids[3];
+  size_t scalar[3];
+
+  trit_tcam_lookup_array(&tcam, keys, ids, 3);
+  trit_tcam_lookup_scalar(&tcam, keys, scalar, 3);
+  ASSERT (ids[0] == scalar[0] && ids[1] == scalar[1] && ids[2] == scalar[2]);
+  ASSERT (ids[1] == 31);
+
+  trit_tcam_free(&tcam);
+  ASSERT (!trit_tcam_init(&tcam, 16, 4));
+}
+
+TEST(TernaryLibrary, CircuitTest){
+
+  // wires 0 and 1 are the inputs, the gates are listed out of order
+  trit_gate_t gates[4] = {{TRIT_GATE_OR, 3, 4, 5}, {TRIT_GATE_NOT, 2, 0, 4},
+                          {TRIT_GATE_XOR, 0, 1, 2}, {TRIT_GATE_AND, 0, 1, 3}};
+  uint32_t inputs[2] = {0, 1};
+  uint32_t outputs[2] = {5, 2};
+  trit_slice_t in[4];
+  trit_slice_t out[4];
+  trit_slice_t scalar[4];
+  uint64_t toggles[6];
+  uint64_t lanes = DeepState_UInt64();
+  trit_circuit_t circuit;
+
+  for(int index = 0; index < 4; index++){
+
+    uint64_t pos = DeepState_UInt64();
+    uint64_t neg = DeepState_UInt64();
+
+    in[index].pos = pos & ~neg;
+    in[index].neg = neg & ~pos;
+  }
+
+  ASSERT (trit_circuit_compile(&circuit, gates, 4, 6, inputs, 2, outputs, 2));
+  ASSERT (circuit.levels == 3);
+  ASSERT (trit_circuit_eval(&circuit, in, out, 2, toggles, 2));
+  ASSERT (trit_circuit_eval_scalar(&circuit, in, scalar, 2, NULL));
+
+  // trit 0 of a word gives the reference through the gate functions of ternary.h
+  uint64_t expected = 0;
+  for(int batch = 0; batch < 2; batch++){
+
+    for(int lane = 0; lane < 64; lane++){
+
+      int x = trit_slice_get(&in[2 * batch], lane);
+      int y = trit_slice_get(&in[2 * batch + 1], lane);
+      trit32_t a = x == 0 ? 0 : (x > 0 ? 1 : 3);
+      trit32_t b = y == 0 ? 0 : (y > 0 ? 1 : 3);
+      trit32_t result = trit_or_trit32_t(trit_and_trit32_t(a, b), trit_not_trit32_t(trit_xor_trit32_t(a, b))) & 3;
+      int z = result == 0 ? 0 : (result == 1 ? 1 : -1);
+
+      ASSERT (trit_slice_get(&out[2 * batch], lane) == z);
+      ASSERT (trit_slice_get(&scalar[2 * batch], lane) == z);
+      if(lane != 0 && x != trit_slice_get(&in[2 * batch], lane - 1)){
+
+        expected++;
+      }
+    }
+  }
+
+  LOG(TRACE) << "Toggles:     " << toggles[0];
+  ASSERT (toggles[0] == expected);
+
+  // stuck-at -1 on the XOR output forces the OR output to 1 where the fault applies
+  ASSERT (trit_circuit_fault(&circuit, 2, -1, lanes));
+  ASSERT (trit_circuit_eval(&circuit, in, out, 2, NULL, 1));
+  ASSERT ((out[1].neg & lanes) == lanes && (out[0].pos & lanes) == lanes);
+  ASSERT (((out[0].pos ^ scalar[0].pos) & ~lanes) == 0 && ((out[0].neg ^ scalar[0].neg) & ~lanes) == 0);
+
+  trit_circuit_clear_faults(&circuit);
+  ASSERT (trit_circuit_eval(&circuit, in, out, 2, NULL, 1));
+  ASSERT (out[0].pos == scalar[0].pos && out[0].neg == scalar[0].neg);
+  trit_circuit_free(&circuit);
+
+  // a loop and a wire with two drivers do not compile
+  gates[0].a = 5;
+  ASSERT (!trit_circuit_compile(&circuit, gates, 4, 6, inputs, 2, outputs, 2));
+  gates[0].a = 3;
+  gates[1].out = 3;
+  ASSERT (!trit_circuit_compile(&circuit, gates, 4, 6, inputs, 2, outputs, 2));
+}
+
+TEST(TernaryLibrary, VmTest){
+
+  int32_t count = DeepState_IntInRange(1, 500);
+  int32_t step = DeepState_IntInRange(-1000, 1000);
+  trit_vm_t vm;
+  uint64_t counts[TRIT_VM_OPS];
+
+  // r2 = count * step by repeated adds, the running total is also stored at tryte 400
+  trit32_t code[8] = {trit_vm_encode(TRIT_VM_LDI, 1, 0, 0, count),
+                      trit_vm_encode(TRIT_VM_LDI, 2, 0, 0, 0),
+                      trit_vm_encode(TRIT_VM_LDI, 3, 0, 0, step),
+                      trit_vm_encode(TRIT_VM_ADD, 2, 2, 3, 0),
+                      trit_vm_encode(TRIT_VM_ST, 2, 0, 0, 400),
+                      trit_vm_encode(TRIT_VM_ADDI, 1, 1, 0, -1),
+                      trit_vm_encode(TRIT_VM_JP, 0, 1, 0, 12),
+                      trit_vm_encode(TRIT_VM_HALT, 0, 0, 0, 0)};
+  trit32_t stored = 0;
+
+  ASSERT (trit_vm_init(&vm, 1024));
+  ASSERT (trit_vm_load(&vm, 0, code, 8));
+  ASSERT (trit_vm_run(&vm, 0) == TRIT_VM_HALTED);
+
+  LOG(TRACE) << "Product:     " << balanced_ternary_to_binary_int64_t(vm.regs[2]);
+  ASSERT (balanced_ternary_to_binary_int64_t(vm.regs[2]) == (int64_t)count * step);
+  ASSERT (trit_vm_read(&vm, 400, &stored) && stored == vm.regs[2]);
+  ASSERT (vm.pc == 32 && vm.steps == 4 + 4 * (uint64_t)count);
+
+  trit_vm_profile(&vm, counts);
+  ASSERT (counts[TRIT_VM_ADD] == (uint64_t)count && counts[TRIT_VM_JP] == (uint64_t)count);
+  ASSERT (vm.decoded[3].count == (uint64_t)count);
+
+  // the HALT already ran and was decoded, writing over it must take effect
+  vm.pc = 12;
+  vm.regs[1] = binary_to_balanced_ternary_trit32_t(1);
+  ASSERT (trit_vm_write(&vm, 28, trit_vm_encode(TRIT_VM_NOT, 4, 2, 0, 0)));
+  ASSERT (trit_vm_run(&vm, 5) == TRIT_VM_LIMIT);
+  ASSERT (vm.pc == 32 && vm.regs[4] == trit_not_trit32_t(vm.regs[2]));
+
+  ASSERT (trit_vm_run(&vm, 0) == TRIT_VM_HALTED);
+  ASSERT (trit_vm_write(&vm, 0, trit_vm_encode(TRIT_VM_LD, 0, 0, 0, 1022)));
+  vm.pc = 0;
+  ASSERT (trit_vm_run(&vm, 0) == TRIT_VM_BAD_ADDRESS && vm.pc == 0);
+  trit_vm_free(&vm);
+}
+
+TEST(TernaryLibrary, QuantTest){
+
+  float threshold = DeepState_IntInRange(0, 500) / 100.0f;
+  float values[45];
+  uint16_t halves[45];
+  float restored[45];
+  float thresholds[3];
+  float scales[3];
+  trit32_t trits[2];
+  trit32_t scalar[2];
+  trit32_t channels[3];
+
+  for(int index = 0; index < 45; index++){
+
+    uint32_t bits = 0;
+
+    values[index] = DeepState_IntInRange(-1000, 1000) / 100.0f;
+    memcpy(&bits, &values[index], sizeof(bits));
+    halves[index] = bits >> 16;
+  }
+
+  // +1 above the threshold, -1 below minus it, the tail of the last word stays 0
+  trit_quantize_float(values, 45, threshold, trits, 2);
+  trit_dequantize_float(trits, 45, 2.0f, restored, 2);
+  for(int index = 0; index < 45; index++){
+
+    int trit = (trits[index / 32] >> (2 * (index % 32))) & 3;
+
+    ASSERT (trit == (values[index] > threshold ? 1 : (values[index] < -threshold ? 3 : 0)));
+    ASSERT (restored[index] == (trit == 0 ? 0.0f : (trit == 1 ? 2.0f : -2.0f)));
+  }
+  ASSERT (trits[1] >> 26 == 0);
+
+  trit_quantize_scalar_float(values, 45, threshold, scalar);
+  ASSERT (trits[0] == scalar[0] && trits[1] == scalar[1]);
+  trit_quantize_bf16(halves, 45, threshold, trits, 1);
+  trit_quantize_scalar_bf16(halves, 45, threshold, scalar);
+  ASSERT (trits[0] == scalar[0] && trits[1] == scalar[1]);
+
+  // every channel of 15 values starts a new word
+  trit_quant_scales_float(values, 3, 15, 0.7f, thresholds, scales, 2);
+  trit_quantize_channels_float(values, 3, 15, thresholds, channels, 2);
+  trit_dequantize_channels_float(channels, 3, 15, scales, restored, 2);
+  for(int channel = 0; channel < 3; channel++){
+
+    LOG(TRACE) << "Scale:       " << scales[channel];
+    trit_quantize_scalar_float(values + 15 * channel, 15, thresholds[channel], scalar);
+    ASSERT (channels[channel] == scalar[0]);
+    ASSERT (scales[channel] == 0.0f || scales[channel] > thresholds[channel]);
+    for(int index = 0; index < 15; index++){
+
+      float value = values[15 * channel + index];
+
+      ASSERT (restored[15 * channel + index] == (value > thresholds[channel] || value < -thresholds[channel] ? (value < 0 ? -scales[channel] : scales[channel]) : 0.0f));
+    }
+  }
+
+  // every kernel this CPU runs agrees with the scalar one on a partial word, NaN and -0.0
+  float special[45];
+  uint16_t special_halves[45];
+  float kernel_restored[45];
+  trit32_t kernel[2];
+  trit32_t scalar_bf16[2];
+
+  memcpy(special, values, sizeof(special));
+  special[5] = NAN;
+  special[6] = -0.0f;
+  special[37] = -NAN;
+  special[44] = -0.0f;
+  for(int index = 0; index < 45; index++){
+
+    uint32_t bits = 0;
+
+    memcpy(&bits, &special[index], sizeof(bits));
+    special_halves[index] = bits >> 16;
+  }
+
+  trit_quantize_scalar_float(special, 45, threshold, scalar);
+  trit_quantize_scalar_bf16(special_halves, 45, threshold, scalar_bf16);
+  trit_dequantize_scalar_float(scalar, 45, 2.0f, restored);
+  // NaN and -0.0 are neither above the threshold nor below minus it
+  ASSERT ((scalar[0] >> 10 & 0xF) == 0 && (scalar[1] >> 10 & 3) == 0 && (scalar[1] >> 24 & 3) == 0);
+  ASSERT ((scalar_bf16[0] >> 10 & 0xF) == 0 && (scalar_bf16[1] >> 10 & 3) == 0 && (scalar_bf16[1] >> 24 & 3) == 0);
+
+#ifdef TERNARY_X86_64
+  if(trit_cpu_avx2()){
+
+    trit_quantize_avx2_float(special, 45, threshold, kernel);
+    ASSERT (kernel[0] == scalar[0] && kernel[1] == scalar[1]);
+    trit_quantize_avx2_bf16(special_halves, 45, threshold, kernel);
+    ASSERT (kernel[0] == scalar_bf16[0] && kernel[1] == scalar_bf16[1]);
+    trit_dequantize_avx2_float(scalar, 45, 2.0f, kernel_restored);
+    ASSERT (memcmp(kernel_restored, restored, sizeof(restored)) == 0);
+  }
+
+  if(trit_cpu_avx512()){
+
+    trit_quantize_avx512_float(special, 45, threshold, kernel);
+    ASSERT (kernel[0] == scalar[0] && kernel[1] == scalar[1]);
+    trit_quantize_avx512_bf16(special_halves, 45, threshold, kernel);
+    ASSERT (kernel[0] == scalar_bf16[0] && kernel[1] == scalar_bf16[1]);
+    trit_dequantize_avx512_float(scalar, 45, 2.0f, kernel_restored);
+    ASSERT (memcmp(kernel_restored, restored, sizeof(restored)) == 0);
+  }
+#endif
+
+  // an empty tensor touches nothing, even through NULL pointers
+  trit_quantize_float(NULL, 0, threshold, NULL, 2);
+  trit_quantize_bf16(NULL, 0, threshold, NULL, 1);
+  trit_dequantize_float(NULL, 0, 1.0f, NULL, 2);
+  trit_quantize_channels_float(NULL, 0, 15, thresholds, NULL, 2);
+  trit_dequantize_channels_float(NULL, 3, 0, scales, NULL, 2);
+}
+
+TEST(TernaryLibrary, SparseTest){
+
+  size_t n = DeepState_UIntInRange(1, 128);
+  trit32_t a[4];
+  trit32_t b[4];
+  trit32_t packed[4];
+  float act[128];
+  trit_sparse_t sa, sb, result;
+  trit_vector_t va, vb;
+
+  // mostly zero words without the unbalanced code, the trits past n are ignored
+  for(int word = 0; word < 4; word++){
+
+    uint64_t keep_a = DeepState_UInt64() & DeepState_UInt64() & DeepState_UInt64() & 0x5555555555555555ULL;
+    uint64_t keep_b = DeepState_UInt64() & DeepState_UInt64() & 0x5555555555555555ULL;
+
+    a[word] = (keep_a | (keep_a << 1)) & (DeepState_UInt64() | 0x5555555555555555ULL);
+    b[word] = (keep_b | (keep_b << 1)) & (DeepState_UInt64() | 0x5555555555555555ULL);
+  }
+  if(n % 32 != 0){
+
+    a[n / 32] |= ~0ULL << (2 * (n % 32)) & 0x5555555555555555ULL;
+  }
+
+  ASSERT (trit_sparse_from_packed(&sa, a, n));
+  ASSERT (trit_sparse_from_packed(&sb, b, n));
+  trit_sparse_to_packed(&sa, packed);
+
+  int64_t dot = 0;
+  float expected = 0;
+  for(size_t index = 0; index < n; index++){
+
+    int x = (int)((a[index / 32] >> (2 * (index % 32))) & 3);
+    int y = (int)((b[index / 32] >> (2 * (index % 32))) & 3);
+    x = x == 3 ? -1 : x;
+    y = y == 3 ? -1 : y;
+
+    act[index] = (float)(index % 7);
+    dot += x * y;
+    expected += x * act[index];
+    ASSERT (trit_sparse_get(&sa, index) == x);
+  }
+  for(size_t word = 0; word < (n + 31) / 32; word++){
+
+    trit32_t valid = (n - 32 * word >= 32) ? ~0ULL : (1ULL << (2 * (n - 32 * word))) - 1;
+    ASSERT (packed[word] == (a[word] & valid));
+    a[word] &= valid;
+    b[word] &= valid;
+  }
+
+  LOG(TRACE) << "Nonzeros:    " << trit_sparse_count(&sa);
+  ASSERT (trit_sparse_dot(&sa, &sb) == dot);
+  ASSERT (trit_sparse_dot_packed(&sa, b) == dot);
+  ASSERT (trit_sparse_dot_float(&sa, act) == expected);
+
+  // the element-wise functions agree with the packed ones of ternary.c
+  ASSERT (trit_sparse_and(&sa, &sb, &result));
+  trit_sparse_to_packed(&result, packed);
+  for(size_t word = 0; word < (n + 31) / 32; word++){
+
+    ASSERT (packed[word] == trit_and_trit32_t(a[word], b[word]));
+  }
+  trit_sparse_free(&result);
+  ASSERT (trit_sparse_or(&sa, &sb, &result));
+  trit_sparse_to_packed(&result, packed);
+  for(size_t word = 0; word < (n + 31) / 32; word++){
+
+    ASSERT (packed[word] == trit_or_trit32_t(a[word], b[word]));
+  }
+  trit_sparse_free(&result);
+  ASSERT (trit_sparse_add(&sa, &sb, &result));
+  for(size_t index = 0; index < n; index++){
+
+    int sum = trit_sparse_get(&sa, index) + trit_sparse_get(&sb, index);
+
+    ASSERT (trit_sparse_get(&result, index) == (sum > 1 ? 1 : sum < -1 ? -1 : sum));
+  }
+  trit_sparse_free(&result);
+  ASSERT (trit_sparse_mul(&sa, &sb, &result));
+  ASSERT ((int64_t)result.pos_count - (int64_t)result.neg_count == dot);
+  trit_sparse_free(&result);
+
+  // XOR maps 0 and 0 to -1 and is refused
+  const int8_t xor_table[9] = {-1, 0, 1, 0, -1, 0, 1, 0, -1};
+  ASSERT (!trit_sparse_map(&sa, &sb, xor_table, &result));
+
+  trit_sparse_not(&sa);
+  ASSERT (trit_sparse_dot(&sa, &sb) == -dot);
+  trit_sparse_not(&sa);
+
+  ASSERT (trit_vector_from_packed(&va, a, n));
+  ASSERT (trit_vector_from_packed(&vb, b, n));
+  ASSERT (va.is_sparse == trit_sparse_prefer(trit_sparse_count(&sa), n));
+  ASSERT (trit_vector_dot(&va, &vb) == dot);
+  ASSERT (trit_vector_dot(&vb, &va) == dot);
+  trit_vector_to_packed(&vb, packed);
+  for(size_t word = 0; word < (n + 31) / 32; word++){
+
+    ASSERT (packed[word] == b[word]);
+  }
+
+  trit_vector_free(&va);
+  trit_vector_free(&vb);
+  trit_sparse_free(&sa);
+  trit_sparse_free(&sb);
+
+  // three scratch blocks of 16384 trits and a partial one, with
+  // nonzeros on both sides of every block boundary
+  const size_t length = 3 * 16384 + 100;
+  const size_t words = (length + 31) / 32;
+  static trit32_t long_a[words];
+  static trit32_t long_b[words];
+  static trit32_t long_packed[words];
+  uint64_t seed = DeepState_UInt64();
+
+  memset(long_a, 0, sizeof(long_a));
+  memset(long_b, 0, sizeof(long_b));
+
+  for(size_t index = 0; index < 400; index++){
+
+    uint64_t bits = (seed + index) * 0x9E3779B97F4A7C15ULL;
+    size_t position = index < 24 ? 16384 * (index / 8 + 1) + index % 8 - 4 : (bits >> 20) % length;
+    size_t shift = 2 * (position % 32);
+
+    // the boundary trits go in both vectors, the rest in one of them
+    if(index < 24 || bits & 1){
+
+      long_a[position / 32] = (long_a[position / 32] & ~(3ULL << shift)) | (bits & 2 ? 3ULL : 1ULL) << shift;
+    }
+    if(index < 24 || !(bits & 1)){
+
+      long_b[position / 32] = (long_b[position / 32] & ~(3ULL << shift)) | (bits & 4 ? 3ULL : 1ULL) << shift;
+    }
+  }
+
+  ASSERT (trit_sparse_from_packed(&sa, long_a, length));
+  ASSERT (trit_sparse_from_packed(&sb, long_b, length));
+
+  dot = 0;
+  for(size_t word = 0; word < words; word++){
+
+    dot += trit_similarity_trit32_t(long_a[word], long_b[word]);
+  }
+  ASSERT (trit_sparse_dot(&sa, &sb) == dot);
+
+  ASSERT (trit_sparse_and(&sa, &sb, &result));
+  trit_sparse_to_packed(&result, long_packed);
+  for(size_t word = 0; word < words; word++){
+
+    ASSERT (long_packed[word] == trit_and_trit32_t(long_a[word], long_b[word]));
+  }
+  trit_sparse_free(&result);
+  ASSERT (trit_sparse_or(&sa, &sb, &result));
+  trit_sparse_to_packed(&result, long_packed);
+  for(size_t word = 0; word < words; word++){
+
+    ASSERT (long_packed[word] == trit_or_trit32_t(long_a[word], long_b[word]));
+  }
+  trit_sparse_free(&result);
+  ASSERT (trit_sparse_add(&sa, &sb, &result));
+  for(size_t index = 0; index < length; index++){
+
+    int sum = trit_sparse_get(&sa, index) + trit_sparse_get(&sb, index);
+
+    ASSERT (trit_sparse_get(&result, index) == (sum > 1 ? 1 : sum < -1 ? -1 : sum));
+  }
+  trit_sparse_free(&result);
+  ASSERT (trit_sparse_mul(&sa, &sb, &result));
+  ASSERT ((int64_t)result.pos_count - (int64_t)result.neg_count == dot);
+  trit_sparse_free(&result);
+
+  trit_sparse_free(&sa);
+  trit_sparse_free(&sb);
+}
+
+// appends encoded bytes to a fixed buffer
+struct CodecBytes{
+
+  uint8_t data[512];
+  size_t size;
+};
+
+static bool codec_bytes(void *context, const uint8_t *data, size_t size){
+
+  CodecBytes *bytes = (CodecBytes *)context;
+
+  if(bytes->size + size > sizeof(bytes->data)){
+
+    return false;
+  }
+  memcpy(bytes->data + bytes->size, data, size);
+  bytes->size += size;
+
+  return true;
+}
+
+// keeps the trits of the one block a short stream has
+struct CodecTrits{
+
+  trit32_t words[32];
+  size_t n;
+};
+
+static bool codec_trits(void *context, const trit32_t *trits, size_t n){
+
+  CodecTrits *out = (CodecTrits *)context;
+
+  if(out->n != 0 || n > 32 * 32){
+
+    return false;
+  }
+  memcpy(out->words, trits, (n + 31) / 32 * sizeof(trit32_t));
+  out->n = n;
+
+  return true;
+}
+
+TEST(TernaryLibrary, CodecTest){
+
+  size_t n = DeepState_UIntInRange(0, 1024);
+  size_t split = DeepState_UIntInRange(0, n);
+  trit32_t trits[32];
+  trit32_t decoded[32];
+  uint8_t base3[205];
+  uint8_t encoded[512];
+  size_t size = 0;
+  size_t count = 0;
+  CodecBytes streamed;
+  CodecTrits restored;
+  trit_codec_encoder_t encoder;
+  trit_codec_decoder_t decoder;
+
+  // mostly zeros so the rANS mode is taken, the trits past n are 0
+  for(int word = 0; word < 32; word++){
+
+    uint64_t keep = DeepState_UInt64() & DeepState_UInt64() & 0x5555555555555555ULL;
+
+    trits[word] = keep | (keep << 1 & DeepState_UInt64());
+    if(word * 32 >= (int)n){
+
+      trits[word] = 0;
+    }
+    else if(n - word * 32 < 32){
+
+      trits[word] &= (1ULL << (2 * (n - word * 32))) - 1;
+    }
+  }
+
+  trit_pack_base3(trits, n, base3);
+  ASSERT (trit_unpack_base3(base3, n, decoded));
+  ASSERT (n == 0 || memcmp(decoded, trits, (n + 31) / 32 * sizeof(trit32_t)) == 0);
+
+  ASSERT (trit_codec_bound(n) <= sizeof(encoded));
+  size = trit_codec_encode(trits, n, encoded, sizeof(encoded), 2);
+  LOG(TRACE) << "Encoded:     " << size << " bytes for " << n << " trits";
+  ASSERT (size != 0 && size <= trit_codec_bound(n));
+  ASSERT (trit_codec_trits(encoded, size, &count) && count == n);
+  ASSERT (trit_codec_decode(encoded, size, decoded, n, 2));
+  ASSERT (n == 0 || memcmp(decoded, trits, (n + 31) / 32 * sizeof(trit32_t)) == 0);
+  ASSERT (!trit_codec_decode(encoded, size, decoded, n + 1, 1));
+  ASSERT (!trit_codec_trits(encoded, size - 1, &count));
+
+  // the streaming encoder gives the same bytes for any split of the input
+  streamed.size = 0;
+  ASSERT (trit_codec_encoder_init(&encoder, codec_bytes, &streamed));
+  ASSERT (trit_codec_encoder_write(&encoder, trits, split));
+  ASSERT (trit_codec_encoder_write(&encoder, trits + split / 32, 0));
+  for(size_t index = split; index < n; index++){
+
+    trit32_t trit = (trits[index / 32] >> (2 * (index % 32))) & 3;
+
+    ASSERT (trit_codec_encoder_write(&encoder, &trit, 1));
+  }
+  ASSERT (trit_codec_encoder_finish(&encoder));
+  trit_codec_encoder_free(&encoder);
+  ASSERT (streamed.size == size && memcmp(streamed.data, encoded, size) == 0);
+
+  // and the streaming decoder takes the bytes split anywhere
+  restored.n = 0;
+  split = DeepState_UIntInRange(0, size);
+  ASSERT (trit_codec_decoder_init(&decoder, codec_trits, &restored));
+  ASSERT (trit_codec_decoder_write(&decoder, encoded, split));
+  ASSERT (trit_codec_decoder_write(&decoder, encoded + split, size - split));
+  ASSERT (trit_codec_decoder_finish(&decoder));
+  ASSERT (!trit_codec_decoder_write(&decoder, encoded, 1));
+  trit_codec_decoder_free(&decoder);
+  ASSERT (restored.n == n);
+  ASSERT (n == 0 || memcmp(restored.words, trits, (n + 31) / 32 * sizeof(trit32_t)) == 0);
+
+  // a flipped bit is caught or decodes to some trits, never out of bounds
+  encoded[DeepState_UIntInRange(0, size - 1)] ^= 1 << DeepState_UIntInRange(0, 7);
+  if(trit_codec_trits(encoded, size, &count) && count <= 32 * 32){
+
+    trit_codec_decode(encoded, size, decoded, count, 1);
+  }
+}
@@ -0,0 +1,156 @@
+/**
+ * @file ternary_thread.c
+ *
+ * @brief File contains the thread helpers used by the array kernels.
+ *
+ * This file contains a small fork/join helper which splits
+ * an index range into contiguous chunks and runs a callback
+ * on each chunk from its own pthread. No state is kept
+ * between calls.
+ */
+
+
+#include<pthread.h>
+#include<stdbool.h>
+#include<stdlib.h>
+#include<unistd.h>
+
+#include"ternary_thread.h"
+
+/**
+ * @brief One chunk of a @c trit_parallel_for call.
+ */
+typedef struct {
+    trit_range_fn fn; /**< The callback to run */
+    void *arg; /**< The argument passed to @c fn */
+    size_t start; /**< First index of the chunk */
+    size_t end; /**< One past the last index of the chunk */
+} range_task;
+
+/**
+ * @brief pthread entry point running one @c range_task.
+ *
+ * @param[in] task The @c range_task to run.
+ *
+ * @return Always NULL
+ */
+static void *run_range_task(void *task){
+
+    range_task *range = (range_task *)task;
+
+    range->fn(range->arg, range->start, range->end);
+
+    return NULL;
+}
+
+/**
+ * @brief Resolves the number of threads to use.
+ *
+ * @param[in] threads The requested number of threads,
+ * 0 or less means one per online CPU.
+ *
+ * @return The number of threads, at least 1
+ */
+int trit_thread_count(int threads){
+
+    long online = 0;
+
+    if(threads > 0){
+
+        return threads;
+    }
+
+    online = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return online > 0 ? (int)online : 1;
+}
+
+/**
+ * @brief Runs @p fn over [0, @p n) split between threads.
+ *
+ * The range is cut into at most @p threads contiguous chunks
+ * whose sizes are multiples of @p grain (except the last).
+ * The calling thread runs the first chunk and waits for the
+ * others. If a thread can not be started its chunk is run
+ * by the calling thread instead.
+ *
+ * @param[in] n The size of the range.
+ *
+ * @param[in] grain Chunk sizes are rounded up to a multiple of this.
+ *
+ * @param[in] threads The number of threads,
+ * see @c trit_thread_count.
+ *
+ * @param[in] fn The callback run on every chunk.
+ *
+ * @param[in] arg The argument passed to @p fn.
+ */
+void trit_parallel_for(size_t n, size_t grain, int threads, trit_range_fn fn, void *arg){
+
+    size_t count = (size_t)trit_thread_count(threads);
+    size_t chunk = 0;
+    size_t index = 0;
+    range_task *tasks = NULL;
+    pthread_t *ids = NULL;
+    bool *started = NULL;
+
+    if(grain == 0){
+
+        grain = 1;
+    }
+
+    chunk = (n + count - 1) / count;
+    chunk = (chunk + grain - 1) / grain * grain;
+
+    if(count == 1 || chunk >= n){
+
+        fn(arg, 0, n);
+        return;
+    }
+
+    count = (n + chunk - 1) / chunk;
+
+    tasks = (range_task *)malloc(count * sizeof(range_task));
+    ids = (pthread_t *)malloc(count * sizeof(pthread_t));
+    started = (bool *)calloc(count, sizeof(bool));
+
+    if(tasks == NULL || ids == NULL || started == NULL){
+
+        free(tasks);
+        free(ids);
+        free(started);
+        fn(arg, 0, n);
+        return;
+    }
+
+    for(index = 0; index < count; index++){
+
+        tasks[index].fn = fn;
+        tasks[index].arg = arg;
+        tasks[index].start = index * chunk;
+        tasks[index].end = index * chunk + chunk < n ? index * chunk + chunk : n;
+
+        if(index != 0){
+
+            started[index] = pthread_create(&ids[index], NULL, run_range_task, &tasks[index]) == 0;
+        }
+    }
+
+    run_range_task(&tasks[0]);
+
+    for(index = 1; index < count; index++){
+
+        if(started[index]){
+
+            pthread_join(ids[index], NULL);
+        }
+        else{
+
+            run_range_task(&tasks[index]);
+        }
+    }
+
+    free(tasks);
+    free(ids);
+    free(started);
+}
@@ -0,0 +1,13 @@
+#ifndef __ternary_thread_h__
+#define __ternary_thread_h__
+
+#include<stddef.h>
+
+// callback run on the range [start, end) by one thread
+typedef void (*trit_range_fn)(void *arg, size_t start, size_t end);
+
+// THREADING FUNCTIONS
+int trit_thread_count(int threads);
+void trit_parallel_for(size_t n, size_t grain, int threads, trit_range_fn fn, void *arg);
+
+#endif // __ternary_thread_h__
@@ -0,0 +1,639 @@
+/**
+ * @file ternary_vm.c
+ *
+ * @brief File contains a balanced ternary virtual machine.
+ *
+ * The machine is Setun-like: memory is a packed array of trytes
+ * (@c trit8_t), the registers are @c trit32_t and arithmetic
+ * wraps mod 3^32 with the wrap functions of ternary.c. The trit
+ * logic instructions use inline mask forms, the ternary.c ones
+ * walk the word a trit at a time.
+ *
+ * Every instruction is decoded once, the first time it runs,
+ * into a table with one entry per instruction slot, so the
+ * loop only reads the table. A store into code resets the
+ * entries it overlaps and they are decoded again when reached.
+ * The loop dispatches with computed goto where the compiler
+ * has it, every handler ends with its own indirect jump which
+ * the branch predictor learns separately, and with a switch
+ * otherwise. Each entry also counts the times it ran, which is
+ * the instruction level profile.
+ */
+
+
+#include<assert.h>
+#include<stdlib.h>
+#include<string.h>
+
+#include"ternary_vm.h"
+
+#if defined(__GNUC__) || defined(__clang__)
+#define COMPUTED_GOTO 1 /**< Dispatch with labels as values */
+#endif
+
+#define NOT_DECODED TRIT_VM_OPS /**< The op of an entry not decoded yet */
+#define BAD_OP (TRIT_VM_OPS + 1) /**< The op of an entry holding an invalid instruction */
+#define NO_TARGET INT64_MAX /**< The jump target of an unaligned or negative address */
+#define LOW_BITS 0x5555555555555555ULL /**< The low bit of every trit */
+
+/**
+ * @brief The mask form of @c trit_and_trit32_t.
+ *
+ * @param[in] a The first balanced ternary word.
+ *
+ * @param[in] b The second balanced ternary word.
+ *
+ * @return 1 where both trits are 1, -1 where either is -1, otherwise 0
+ */
+static inline trit32_t and_word(trit32_t a, trit32_t b){
+
+    uint64_t neg = ((a | b) >> 1) & LOW_BITS;
+    uint64_t pos = a & b & ~((a | b) >> 1) & LOW_BITS;
+
+    return pos | neg | (neg << 1);
+}
+
+/**
+ * @brief The mask form of @c trit_or_trit32_t.
+ *
+ * @param[in] a The first balanced ternary word.
+ *
+ * @param[in] b The second balanced ternary word.
+ *
+ * @return 0 where both trits are 0, 1 where either is 1, otherwise -1
+ */
+static inline trit32_t or_word(trit32_t a, trit32_t b){
+
+    uint64_t pos = ((a & ~(a >> 1)) | (b & ~(b >> 1))) & LOW_BITS;
+    uint64_t neg = (a | b) & LOW_BITS & ~pos;
+
+    return pos | neg | (neg << 1);
+}
+
+/**
+ * @brief The mask form of @c trit_xor_trit32_t.
+ *
+ * @param[in] a The first balanced ternary word.
+ *
+ * @param[in] b The second balanced ternary word.
+ *
+ * @return -1 where the trits are equal, 1 where they are
+ * 1 and -1, otherwise 0
+ */
+static inline trit32_t xor_word(trit32_t a, trit32_t b){
+
+    uint64_t diff = a ^ b;
+    uint64_t neg = LOW_BITS & ~(diff | (diff >> 1));
+    uint64_t pos = a & b & diff >> 1 & LOW_BITS;
+
+    return pos | neg | (neg << 1);
+}
+
+/**
+ * @brief Negates a balanced ternary word, see @c trit_not_trit32_t.
+ *
+ * @param[in] num The balanced ternary word.
+ *
+ * @return The negation of @p num
+ */
+static inline trit32_t not_word(trit32_t num){
+
+    return num ^ ((num & LOW_BITS) << 1);
+}
+
+/**
+ * @brief Converts a small binary number to balanced ternary.
+ *
+ * @param[in] value The number, at most (3^32 - 1) / 2 either way.
+ *
+ * @return The trits of @p value
+ */
+static trit32_t value_word(int64_t value){
+
+    return value < 0 ? not_word(binary_to_balanced_ternary_trit32_t((uint64_t)-value)) :
+                       binary_to_balanced_ternary_trit32_t((uint64_t)value);
+}
+
+/**
+ * @brief Finds the sign of a balanced ternary number.
+ *
+ * The sign of a number is the sign of its highest nonzero trit.
+ *
+ * @param[in] num The balanced ternary number.
+ *
+ * @return -1, 0 or 1
+ */
+static inline int sign_word(trit32_t num){
+
+    int top = 0;
+
+    if(num == 0){
+
+        return 0;
+    }
+
+    top = (63 - __builtin_clzll(num)) & ~1;
+
+    return (num >> (top + 1)) & 1 ? -1 : 1;
+}
+
+/**
+ * @brief Compares two balanced ternary numbers.
+ *
+ * The highest trit where they differ decides.
+ *
+ * @param[in] a The first number.
+ *
+ * @param[in] b The second number.
+ *
+ * @return -1, 0 or 1 as @p a is below, equal to or above @p b
+ */
+static inline int compare_words(trit32_t a, trit32_t b){
+
+    uint64_t diff = a ^ b;
+    int top = 0;
+
+    if(diff == 0){
+
+        return 0;
+    }
+
+    top = (63 - __builtin_clzll(diff)) & ~1;
+
+    return sign_word((a >> top) & 3) - sign_word((b >> top) & 3) < 0 ? -1 : 1;
+}
+
+/**
+ * @brief Creates a VM with zeroed registers and memory.
+ *
+ * @param[out] vm The VM.
+ *
+ * @param[in] trytes The size of memory, rounded up to a
+ * multiple of 4.
+ *
+ * @return false if the memory could not be allocated
+ */
+bool trit_vm_init(trit_vm_t *vm, size_t trytes){
+
+    size_t index = 0;
+
+    memset(vm, 0, sizeof(*vm));
+
+    vm->trytes = (trytes + 3) / 4 * 4;
+    vm->memory = (trit8_t *)calloc(vm->trytes + 4, sizeof(trit8_t));
+    vm->decoded = (trit_vm_decoded_t *)calloc(vm->trytes / 4 + 1, sizeof(trit_vm_decoded_t));
+
+    if(vm->memory == NULL || vm->decoded == NULL){
+
+        trit_vm_free(vm);
+        return false;
+    }
+
+    for(index = 0; index < vm->trytes / 4; index++){
+
+        vm->decoded[index].op = NOT_DECODED;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Frees the memory of a VM.
+ *
+ * @param[in,out] vm The VM, left empty.
+ */
+void trit_vm_free(trit_vm_t *vm){
+
+    free(vm->memory);
+    free(vm->decoded);
+    memset(vm, 0, sizeof(*vm));
+}
+
+/**
+ * @brief Encodes one instruction.
+ *
+ * @warning This method asserts that the registers are 0 to 8
+ * and that @p imm is within TRIT_VM_IMM_MAX either way.
+ *
+ * @param[in] op The instruction.
+ *
+ * @param[in] rd The register rd.
+ *
+ * @param[in] ra The register ra.
+ *
+ * @param[in] rb The register rb.
+ *
+ * @param[in] imm The immediate, an address for loads, stores
+ * and jumps.
+ *
+ * @return The instruction word
+ */
+trit32_t trit_vm_encode(trit_vm_op_t op, int rd, int ra, int rb, int64_t imm){
+
+    assert(rd >= 0 && rd < TRIT_VM_REGISTERS && ra >= 0 && ra < TRIT_VM_REGISTERS && rb >= 0 && rb < TRIT_VM_REGISTERS);
+    assert(imm >= -TRIT_VM_IMM_MAX && imm <= TRIT_VM_IMM_MAX && "Immediate too big for 22 trits");
+
+    return value_word((int64_t)op) | value_word(rd - 4) << 8 | value_word(ra - 4) << 12 |
+           value_word(rb - 4) << 16 | value_word(imm) << 20;
+}
+
+/**
+ * @brief Decodes the instruction in one slot.
+ *
+ * @param[in,out] vm The VM.
+ *
+ * @param[in] slot The instruction number, the address over 4.
+ */
+static void decode(trit_vm_t *vm, size_t slot){
+
+    trit_vm_decoded_t *entry = &vm->decoded[slot];
+    trit32_t word = 0;
+    int64_t op = 0;
+
+    trit_vm_read(vm, 4 * slot, &word);
+
+    op = balanced_ternary_to_binary_int64_t(word & 0xFF);
+    entry->op = op < 0 || op >= TRIT_VM_OPS ? BAD_OP : (uint8_t)op;
+    entry->rd = (uint8_t)(balanced_ternary_to_binary_int64_t((word >> 8) & 0xF) + 4);
+    entry->ra = (uint8_t)(balanced_ternary_to_binary_int64_t((word >> 12) & 0xF) + 4);
+    entry->rb = (uint8_t)(balanced_ternary_to_binary_int64_t((word >> 16) & 0xF) + 4);
+    entry->trits = word >> 20;
+    entry->imm = balanced_ternary_to_binary_int64_t(entry->trits);
+
+    if(op >= TRIT_VM_JMP && op <= TRIT_VM_CALL){
+
+        entry->imm = entry->imm < 0 || entry->imm % 4 != 0 ? NO_TARGET : entry->imm / 4;
+    }
+}
+
+/**
+ * @brief Resets the entries of the instructions over some trytes.
+ *
+ * @param[in,out] vm The VM.
+ *
+ * @param[in] address The first tryte written.
+ *
+ * @param[in] count The number of trytes written, at most 4.
+ */
+static inline void invalidate(trit_vm_t *vm, size_t address, size_t count){
+
+    vm->decoded[address / 4].op = NOT_DECODED;
+    vm->decoded[(address + count - 1) / 4].op = NOT_DECODED;
+}
+
+/**
+ * @brief Reads a word from memory.
+ *
+ * @param[in] vm The VM.
+ *
+ * @param[in] address The tryte address of the low tryte.
+ *
+ * @param[out] word The word, the 4 trytes from @p address.
+ *
+ * @return false if the word is not inside memory
+ */
+bool trit_vm_read(const trit_vm_t *vm, size_t address, trit32_t *word){
+
+    if(address > vm->trytes || vm->trytes - address < 4){
+
+        return false;
+    }
+
+    *word = (trit32_t)vm->memory[address] | (trit32_t)vm->memory[address + 1] << 16 |
+            (trit32_t)vm->memory[address + 2] << 32 | (trit32_t)vm->memory[address + 3] << 48;
+
+    return true;
+}
+
+/**
+ * @brief Writes a word to memory.
+ *
+ * @param[in,out] vm The VM.
+ *
+ * @param[in] address The tryte address of the low tryte.
+ *
+ * @param[in] word The word.
+ *
+ * @return false if the word is not inside memory
+ */
+bool trit_vm_write(trit_vm_t *vm, size_t address, trit32_t word){
+
+    if(address > vm->trytes || vm->trytes - address < 4){
+
+        return false;
+    }
+
+    vm->memory[address] = (trit8_t)word;
+    vm->memory[address + 1] = (trit8_t)(word >> 16);
+    vm->memory[address + 2] = (trit8_t)(word >> 32);
+    vm->memory[address + 3] = (trit8_t)(word >> 48);
+    invalidate(vm, address, 4);
+
+    return true;
+}
+
+/**
+ * @brief Writes a program to memory.
+ *
+ * @param[in,out] vm The VM.
+ *
+ * @param[in] address The tryte address of the first instruction.
+ *
+ * @param[in] code The instructions, see @c trit_vm_encode.
+ *
+ * @param[in] count The number of instructions.
+ *
+ * @return false if the program does not fit, memory is
+ * unchanged then
+ */
+bool trit_vm_load(trit_vm_t *vm, size_t address, const trit32_t *code, size_t count){
+
+    size_t index = 0;
+
+    if(address > vm->trytes || (vm->trytes - address) / 4 < count){
+
+        return false;
+    }
+
+    for(index = 0; index < count; index++){
+
+        trit_vm_write(vm, address + 4 * index, code[index]);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Finds the memory address of a load or store.
+ *
+ * @param[in] vm The VM.
+ *
+ * @param[in] base The base register value.
+ *
+ * @param[in] offset The immediate.
+ *
+ * @param[in] size The trytes accessed.
+ *
+ * @param[out] address The tryte address.
+ *
+ * @return false if the access is not inside memory
+ */
+static inline bool effective_address(const trit_vm_t *vm, trit32_t base, int64_t offset, size_t size, size_t *address){
+
+    int64_t value = (base == 0 ? 0 : balanced_ternary_to_binary_int64_t(base)) + offset;
+
+    *address = (size_t)value;
+
+    return value >= 0 && (uint64_t)value <= vm->trytes - size;
+}
+
+/**
+ * @brief Runs the VM from @c vm->pc.
+ *
+ * @param[in,out] vm The VM.
+ *
+ * @param[in] limit The most instructions to run, 0 for no limit.
+ *
+ * @return Why the VM stopped, @c vm->pc is the address of the
+ * next instruction or of the one that failed
+ */
+trit_vm_status_t trit_vm_run(trit_vm_t *vm, uint64_t limit){
+
+    trit32_t *regs = vm->regs;
+    trit_vm_decoded_t *decoded = vm->decoded;
+    trit_vm_decoded_t *entry = NULL;
+    trit_vm_status_t status = TRIT_VM_HALTED;
+    size_t slots = vm->trytes / 4;
+    size_t pc = vm->pc / 4;
+    size_t address = 0;
+    uint64_t steps = 0;
+    uint64_t stop = limit == 0 ? UINT64_MAX : limit;
+
+#ifdef COMPUTED_GOTO
+    static const void *labels[TRIT_VM_OPS + 2] = {
+
+        &&op_halt, &&op_ldi, &&op_mov, &&op_add, &&op_sub, &&op_mul, &&op_addi, &&op_and, &&op_or, &&op_xor,
+        &&op_not, &&op_shl, &&op_shr, &&op_cmp, &&op_ld, &&op_st, &&op_ldt, &&op_stt, &&op_jmp, &&op_jz,
+        &&op_jp, &&op_jn, &&op_call, &&op_jr, &&op_decode, &&op_bad
+    };
+#define CASE(op, name) name:
+#define NEXT() do{ if(pc >= slots || steps == stop) goto fetch; entry = &decoded[pc++]; entry->count++; steps++; goto *labels[entry->op]; }while(0)
+#define REDISPATCH() goto *labels[entry->op]
+#else
+#define CASE(op, name) case op:
+#define NEXT() goto fetch
+#define REDISPATCH() goto dispatch
+#endif
+
+    if(vm->pc % 4 != 0){
+
+        return TRIT_VM_BAD_ADDRESS;
+    }
+
+fetch:
+    if(pc >= slots){
+
+        status = TRIT_VM_BAD_ADDRESS;
+        goto done;
+    }
+    if(steps == stop){
+
+        status = TRIT_VM_LIMIT;
+        goto done;
+    }
+    entry = &decoded[pc];
+    entry->count++;
+    steps++;
+    pc++;
+
+#ifdef COMPUTED_GOTO
+    goto *labels[entry->op];
+#else
+dispatch:
+    switch(entry->op){
+#endif
+
+    CASE(TRIT_VM_HALT, op_halt)
+        status = TRIT_VM_HALTED;
+        goto done;
+
+    CASE(TRIT_VM_LDI, op_ldi)
+        regs[entry->rd] = entry->trits;
+        NEXT();
+
+    CASE(TRIT_VM_MOV, op_mov)
+        regs[entry->rd] = regs[entry->ra];
+        NEXT();
+
+    CASE(TRIT_VM_ADD, op_add)
+        regs[entry->rd] = trit_add_wrap_trit32_t(regs[entry->ra], regs[entry->rb]);
+        NEXT();
+
+    CASE(TRIT_VM_SUB, op_sub)
+        regs[entry->rd] = trit_sub_wrap_trit32_t(regs[entry->ra], regs[entry->rb]);
+        NEXT();
+
+    CASE(TRIT_VM_MUL, op_mul)
+        regs[entry->rd] = trit_mul_wrap_trit32_t(regs[entry->ra], regs[entry->rb]);
+        NEXT();
+
+    CASE(TRIT_VM_ADDI, op_addi)
+        regs[entry->rd] = trit_add_wrap_trit32_t(regs[entry->ra], entry->trits);
+        NEXT();
+
+    CASE(TRIT_VM_AND, op_and)
+        regs[entry->rd] = and_word(regs[entry->ra], regs[entry->rb]);
+        NEXT();
+
+    CASE(TRIT_VM_OR, op_or)
+        regs[entry->rd] = or_word(regs[entry->ra], regs[entry->rb]);
+        NEXT();
+
+    CASE(TRIT_VM_XOR, op_xor)
+        regs[entry->rd] = xor_word(regs[entry->ra], regs[entry->rb]);
+        NEXT();
+
+    CASE(TRIT_VM_NOT, op_not)
+        regs[entry->rd] = not_word(regs[entry->ra]);
+        NEXT();
+
+    CASE(TRIT_VM_SHL, op_shl)
+        regs[entry->rd] = entry->imm <= 0 ? regs[entry->ra] : (entry->imm >= 32 ? 0 : regs[entry->ra] << (2 * entry->imm));
+        NEXT();
+
+    CASE(TRIT_VM_SHR, op_shr)
+        regs[entry->rd] = entry->imm <= 0 ? regs[entry->ra] : (entry->imm >= 32 ? 0 : regs[entry->ra] >> (2 * entry->imm));
+        NEXT();
+
+    CASE(TRIT_VM_CMP, op_cmp)
+        regs[entry->rd] = value_word(compare_words(regs[entry->ra], regs[entry->rb]));
+        NEXT();
+
+    CASE(TRIT_VM_LD, op_ld)
+        if(!effective_address(vm, regs[entry->ra], entry->imm, 4, &address)){
+
+            status = TRIT_VM_BAD_ADDRESS;
+            pc--;
+            goto done;
+        }
+        trit_vm_read(vm, address, &regs[entry->rd]);
+        NEXT();
+
+    CASE(TRIT_VM_ST, op_st)
+        if(!effective_address(vm, regs[entry->ra], entry->imm, 4, &address)){
+
+            status = TRIT_VM_BAD_ADDRESS;
+            pc--;
+            goto done;
+        }
+        trit_vm_write(vm, address, regs[entry->rd]);
+        NEXT();
+
+    CASE(TRIT_VM_LDT, op_ldt)
+        if(!effective_address(vm, regs[entry->ra], entry->imm, 1, &address)){
+
+            status = TRIT_VM_BAD_ADDRESS;
+            pc--;
+            goto done;
+        }
+        regs[entry->rd] = vm->memory[address];
+        NEXT();
+
+    CASE(TRIT_VM_STT, op_stt)
+        if(!effective_address(vm, regs[entry->ra], entry->imm, 1, &address)){
+
+            status = TRIT_VM_BAD_ADDRESS;
+            pc--;
+            goto done;
+        }
+        vm->memory[address] = (trit8_t)regs[entry->rd];
+        invalidate(vm, address, 1);
+        NEXT();
+
+    CASE(TRIT_VM_JMP, op_jmp)
+        pc = (size_t)entry->imm;
+        NEXT();
+
+    CASE(TRIT_VM_JZ, op_jz)
+        pc = regs[entry->ra] == 0 ? (size_t)entry->imm : pc;
+        NEXT();
+
+    CASE(TRIT_VM_JP, op_jp)
+        pc = sign_word(regs[entry->ra]) > 0 ? (size_t)entry->imm : pc;
+        NEXT();
+
+    CASE(TRIT_VM_JN, op_jn)
+        pc = sign_word(regs[entry->ra]) < 0 ? (size_t)entry->imm : pc;
+        NEXT();
+
+    CASE(TRIT_VM_CALL, op_call)
+        regs[entry->rd] = value_word((int64_t)(4 * pc));
+        pc = (size_t)entry->imm;
+        NEXT();
+
+    CASE(TRIT_VM_JR, op_jr)
+        effective_address(vm, regs[entry->ra], 0, 0, &address);
+        pc = address % 4 == 0 && address <= vm->trytes ? address / 4 : SIZE_MAX;
+        NEXT();
+
+    CASE(NOT_DECODED, op_decode)
+        decode(vm, pc - 1);
+        REDISPATCH();
+
+    CASE(BAD_OP, op_bad)
+        status = TRIT_VM_BAD_OPCODE;
+        pc--;
+        goto done;
+
+#ifndef COMPUTED_GOTO
+    }
+#endif
+
+done:
+    vm->pc = pc == SIZE_MAX || pc > slots ? vm->trytes : 4 * pc;
+    vm->steps += steps;
+
+    return status;
+
+#undef CASE
+#undef NEXT
+#undef REDISPATCH
+}
+
+/**
+ * @brief Adds up the profile by instruction.
+ *
+ * @param[in] vm The VM.
+ *
+ * @param[out] counts The times every instruction ran, counted
+ * from the slots that currently hold it.
+ */
+void trit_vm_profile(const trit_vm_t *vm, uint64_t counts[TRIT_VM_OPS]){
+
+    size_t index = 0;
+
+    memset(counts, 0, TRIT_VM_OPS * sizeof(uint64_t));
+
+    for(index = 0; index < vm->trytes / 4; index++){
+
+        if(vm->decoded[index].op < TRIT_VM_OPS){
+
+            counts[vm->decoded[index].op] += vm->decoded[index].count;
+        }
+    }
+}
+
+/**
+ * @brief Zeroes the count of every instruction slot.
+ *
+ * @param[in,out] vm The VM.
+ */
+void trit_vm_clear_profile(trit_vm_t *vm){
+
+    size_t index = 0;
+
+    for(index = 0; index < vm->trytes / 4; index++){
+
+        vm->decoded[index].count = 0;
+    }
+}
@@ -0,0 +1,102 @@
+#ifndef __ternary_vm_h__
+#define __ternary_vm_h__
+
+#include<stddef.h>
+#include<stdint.h>
+#include"ternary.h"
+
+#define TRIT_VM_REGISTERS 9 /**< The registers, one per value of a 2 trit field */
+#define TRIT_VM_IMM_MAX 15690529804LL /**< The largest immediate, (3^22 - 1) / 2 */
+
+/**
+ * @brief The instructions of the VM.
+ *
+ * An instruction is one @c trit32_t, 4 trytes: the opcode in
+ * trits 0-3, rd, ra and rb in trits 4-5, 6-7 and 8-9 and a
+ * balanced immediate in trits 10-31. A register field holds
+ * the register number minus 4. Addresses count trytes and
+ * jump targets must be multiples of 4. Zeroed memory reads
+ * as HALT.
+ */
+typedef enum{
+
+    TRIT_VM_HALT, /**< Stops the VM */
+    TRIT_VM_LDI,  /**< rd = imm */
+    TRIT_VM_MOV,  /**< rd = ra */
+    TRIT_VM_ADD,  /**< rd = ra + rb, mod 3^32 */
+    TRIT_VM_SUB,  /**< rd = ra - rb, mod 3^32 */
+    TRIT_VM_MUL,  /**< rd = ra * rb, mod 3^32 */
+    TRIT_VM_ADDI, /**< rd = ra + imm, mod 3^32 */
+    TRIT_VM_AND,  /**< rd = ra AND rb, trit by trit */
+    TRIT_VM_OR,   /**< rd = ra OR rb, trit by trit */
+    TRIT_VM_XOR,  /**< rd = ra XOR rb, trit by trit */
+    TRIT_VM_NOT,  /**< rd = -ra */
+    TRIT_VM_SHL,  /**< rd = ra times 3^imm, mod 3^32 */
+    TRIT_VM_SHR,  /**< rd = ra divided by 3^imm, rounded to nearest */
+    TRIT_VM_CMP,  /**< rd = -1, 0 or 1 as ra is below, equal to or above rb */
+    TRIT_VM_LD,   /**< rd = the word at tryte ra + imm */
+    TRIT_VM_ST,   /**< the word at tryte ra + imm = rd */
+    TRIT_VM_LDT,  /**< rd = the tryte at ra + imm */
+    TRIT_VM_STT,  /**< the tryte at ra + imm = the low 8 trits of rd */
+    TRIT_VM_JMP,  /**< jump to imm */
+    TRIT_VM_JZ,   /**< jump to imm if ra is 0 */
+    TRIT_VM_JP,   /**< jump to imm if ra is above 0 */
+    TRIT_VM_JN,   /**< jump to imm if ra is below 0 */
+    TRIT_VM_CALL, /**< rd = the next address, jump to imm */
+    TRIT_VM_JR,   /**< jump to ra */
+    TRIT_VM_OPS   /**< The number of instructions */
+} trit_vm_op_t;
+
+/**
+ * @brief Why @c trit_vm_run returned.
+ */
+typedef enum{
+
+    TRIT_VM_HALTED,      /**< A HALT ran, pc is the address after it */
+    TRIT_VM_LIMIT,       /**< The step limit was reached */
+    TRIT_VM_BAD_OPCODE,  /**< pc holds an invalid instruction */
+    TRIT_VM_BAD_ADDRESS  /**< pc or a memory access is outside memory or a jump is unaligned */
+} trit_vm_status_t;
+
+/**
+ * @brief One pre-decoded instruction.
+ *
+ * Filled in the first time the instruction runs and reset when
+ * a store writes one of its trytes.
+ */
+typedef struct{
+
+    uint8_t op;      /**< The instruction, TRIT_VM_OPS if not decoded yet */
+    uint8_t rd;      /**< The register rd */
+    uint8_t ra;      /**< The register ra */
+    uint8_t rb;      /**< The register rb */
+    int64_t imm;     /**< The immediate, a jump target as an instruction number */
+    trit32_t trits;  /**< The immediate as trits */
+    uint64_t count;  /**< The times the instruction ran */
+} trit_vm_decoded_t;
+
+/**
+ * @brief A balanced ternary virtual machine.
+ */
+typedef struct{
+
+    trit32_t regs[TRIT_VM_REGISTERS]; /**< The registers */
+    trit8_t *memory;                  /**< The trytes of memory */
+    trit_vm_decoded_t *decoded;       /**< One entry per 4 trytes */
+    size_t trytes;                    /**< The size of memory, a multiple of 4 */
+    size_t pc;                        /**< The address of the next instruction */
+    uint64_t steps;                   /**< The instructions run */
+} trit_vm_t;
+
+// VM FUNCTIONS
+bool trit_vm_init(trit_vm_t *vm, size_t trytes);
+void trit_vm_free(trit_vm_t *vm);
+trit32_t trit_vm_encode(trit_vm_op_t op, int rd, int ra, int rb, int64_t imm);
+bool trit_vm_read(const trit_vm_t *vm, size_t address, trit32_t *word);
+bool trit_vm_write(trit_vm_t *vm, size_t address, trit32_t word);
+bool trit_vm_load(trit_vm_t *vm, size_t address, const trit32_t *code, size_t count);
+trit_vm_status_t trit_vm_run(trit_vm_t *vm, uint64_t limit);
+void trit_vm_profile(const trit_vm_t *vm, uint64_t counts[TRIT_VM_OPS]);
+void trit_vm_clear_profile(trit_vm_t *vm);
+
+#endif // __ternary_vm_h__